@@ -0,0 +1,46 @@
+#=============================================================================
+# Copyright 2024 Stanford University, NVIDIA Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#=============================================================================
+
+# This module produces the "LZ4::LZ4" link target which carries with it all the
+# necessary interface properties.  If the LZ4_ROOT_DIR CMake or LZ4 environment
+# variable are present then they are used to guide the search
+#
+if(NOT LZ4_FOUND AND NOT TARGET LZ4::LZ4)
+  if(NOT LZ4_ROOT_DIR AND DEFINED ENV{LZ4})
+    set(LZ4_ROOT_DIR $ENV{LZ4})
+  endif()
+  if(LZ4_ROOT_DIR)
+    set(LZ4_ROOT_DIR ${LZ4_ROOT_DIR} CACHE STRING "Root directory for LZ4")
+    set(_LZ4_FIND_OPTS HINTS ${LZ4_ROOT_DIR} PATH_SUFFIXES include lib lib64)
+  endif()
+
+  find_path(LZ4_INCLUDE_DIR lz4.h ${_LZ4_FIND_OPTS})
+  find_library(LZ4_LIBRARY lz4 ${_LZ4_FIND_OPTS})
+
+  include(FindPackageHandleStandardArgs)
+  find_package_handle_standard_args(LZ4
+    FOUND_VAR LZ4_FOUND
+    REQUIRED_VARS LZ4_INCLUDE_DIR LZ4_LIBRARY
+  )
+endif()
+
+if(LZ4_FOUND AND NOT TARGET LZ4::LZ4)
+  add_library(LZ4::LZ4 UNKNOWN IMPORTED)
+  set_target_properties(LZ4::LZ4 PROPERTIES
+    IMPORTED_LOCATION ${LZ4_LIBRARY}
+    INTERFACE_INCLUDE_DIRECTORIES ${LZ4_INCLUDE_DIR}
+  )
+endif()
@@ -63,6 +63,16 @@
 #ifdef __ARM_NEON
 #include "arm_neon.h"
 #endif
+// The bulk kernels behind DispatchTLBitMask are compiled for several x86
+// instruction sets with function-level target attributes and picked with
+// __builtin_cpu_supports at run time, independent of the -m flags
+#if defined(__x86_64__) && defined(__GNUC__)
+#define BITMASK_DISPATCH_X86
+#include <immintrin.h>
+#if defined(__clang__) || (__GNUC__ >= 8)
+#define BITMASK_DISPATCH_VPOPCNT
+#endif
+#endif
 #ifndef BITMASK_MAX_ALIGNMENT
 #define BITMASK_MAX_ALIGNMENT   (2*sizeof(void *))
 #endif
@@ -205,6 +215,44 @@
         const T *const ptr;
       };
 #endif
+#ifdef __AVX512F__
+      template<bool READ_ONLY, typename T = uint64_t>
+      class AVX512View {
+      public:
+        inline AVX512View(T *base, unsigned index) 
+          : ptr(base + ((sizeof(__m512i)/sizeof(T))*index)) { }
+      public:
+        inline operator __m512i(void) const {
+          __m512i result;
+          memcpy(&result, ptr, sizeof(result));
+          return result;
+        }
+      public:
+        inline void operator=(const __m512i &value) {
+          memcpy(ptr, &value, sizeof(value));
+        }
+        template<bool WHOCARES>
+        inline void operator=(const AVX512View<WHOCARES> &rhs) {
+          memcpy(ptr, rhs.ptr, sizeof(__m512i));
+        }
+      public:
+        T *const ptr;
+      };
+      template<typename T>
+      class AVX512View<true,T> {
+      public:
+        inline AVX512View(const T *base, unsigned index) 
+          : ptr(base + ((sizeof(__m512i)/sizeof(T))*index)) { }
+      public:
+        inline operator __m512i(void) const {
+          __m512i result;
+          memcpy(&result, ptr, sizeof(result));
+          return result;
+        }
+      public:
+        const T *const ptr;
+      };
+#endif
 #ifdef __ALTIVEC__
       template<bool READ_ONLY, typename T = uint64_t>
       class PPCView {
@@ -327,6 +375,12 @@
         inline AVXView<true,ELEMENT_TYPE> avx_view(unsigned index) const
           { return AVXView<true,ELEMENT_TYPE>(bit_vector, index); }
 #endif
+#ifdef __AVX512F__
+        inline AVX512View<false,ELEMENT_TYPE> avx512_view(unsigned index)
+          { return AVX512View<false,ELEMENT_TYPE>(bit_vector, index); }
+        inline AVX512View<true,ELEMENT_TYPE> avx512_view(unsigned index) const
+          { return AVX512View<true,ELEMENT_TYPE>(bit_vector, index); }
+#endif
 #ifdef __ALTIVEC__
         inline PPCView<false,ELEMENT_TYPE> ppc_view(unsigned index)
           { return PPCView<false,ELEMENT_TYPE>(bit_vector, index); }
@@ -349,6 +403,44 @@
         // Mask to get the lower bits for indexing assuming a 64-bit base type
         static constexpr unsigned MASK = ELEMENT_SIZE - 1;
       };
+
+      // Kernels for bulk operations on arrays of 64-bit words. These back
+      // the DispatchTLBitMask: each kernel is compiled several times with
+      // function-level target attributes and the best version for the
+      // processor we are actually running on is picked the first time the
+      // table is requested, so a binary built for the baseline ISA can
+      // still use AVX2 or AVX-512 where they are available. The binary
+      // kernels allow the destination to alias either source and return
+      // the bitwise-or of all the words that they wrote so that two-level
+      // masks get their summary for free.
+      struct BitKernels {
+        const char *name;
+        uint64_t (*bit_or)(uint64_t *dst, const uint64_t *lhs,
+                           const uint64_t *rhs, unsigned words);
+        uint64_t (*bit_and)(uint64_t *dst, const uint64_t *lhs,
+                            const uint64_t *rhs, unsigned words);
+        uint64_t (*bit_xor)(uint64_t *dst, const uint64_t *lhs,
+                            const uint64_t *rhs, unsigned words);
+        // dst = lhs & ~rhs
+        uint64_t (*bit_andnot)(uint64_t *dst, const uint64_t *lhs,
+                               const uint64_t *rhs, unsigned words);
+        uint64_t (*bit_not)(uint64_t *dst, const uint64_t *src,
+                            unsigned words);
+        bool (*disjoint)(const uint64_t *lhs, const uint64_t *rhs,
+                         unsigned words);
+        unsigned (*pop_count)(const uint64_t *src, unsigned words);
+      };
+      enum BitKernelISA {
+        GENERIC_BIT_KERNELS,
+        AVX2_BIT_KERNELS,
+        AVX512_BIT_KERNELS,
+        AVX512_VPOPCNT_BIT_KERNELS,
+        NUM_BIT_KERNEL_ISAS,
+      };
+      // Returns NULL if this build or this processor can't run that version
+      inline const BitKernels* find_bit_kernels(BitKernelISA isa);
+      // The best version for this processor, chosen once per process
+      inline const BitKernels& bit_kernels(void);
     };
 
     /////////////////////////////////////////////////////////////
@@ -905,6 +997,191 @@
     };
 #endif // __AVX__
 
+#ifdef __AVX512F__
+    /////////////////////////////////////////////////////////////
+    // AVX-512 Bit Mask  
+    /////////////////////////////////////////////////////////////
+    template<unsigned int MAX>
+    class alignas(64) AVX512BitMask 
+      : public BitMaskHelp::Heapify<AVX512BitMask<MAX> > {
+    public:
+      static constexpr unsigned ELEMENT_SIZE =
+        BitMaskHelp::BitVector<MAX>::ELEMENT_SIZE;
+      static constexpr unsigned BIT_ELMTS = MAX/ELEMENT_SIZE;
+      static constexpr unsigned AVX512_ELMTS = MAX/512;
+      static constexpr unsigned MAXSIZE = MAX;
+    public:
+      explicit AVX512BitMask(uint64_t init = 0);
+      AVX512BitMask(const AVX512BitMask &rhs);
+      ~AVX512BitMask(void);
+    public:
+      inline void set_bit(unsigned bit);
+      inline void unset_bit(unsigned bit);
+      inline void assign_bit(unsigned bit, bool val);
+      inline bool is_set(unsigned bit) const;
+      inline int find_first_set(void) const;
+      inline int find_next_set(unsigned start) const;
+      inline int find_index(unsigned bit) const;
+      inline int get_index(unsigned index) const;
+      inline bool empty(void) const;
+      inline void clear(void);
+    public:
+      inline size_t size(void) const { return pop_count(); }
+      inline bool contains(unsigned bit) const { return is_set(bit); }
+      inline void add(unsigned bit) { set_bit(bit); }
+      inline void insert(unsigned bit) { set_bit(bit); }
+      inline void remove(unsigned bit) { unset_bit(bit); }
+    public:
+      inline bool operator==(const AVX512BitMask &rhs) const;
+      inline bool operator<(const AVX512BitMask &rhs) const;
+      inline bool operator!=(const AVX512BitMask &rhs) const;
+    public:
+      inline BitMaskHelp::AVX512View<true> 
+        operator()(const unsigned &idx) const;
+      inline BitMaskHelp::AVX512View<false>
+        operator()(const unsigned &idx);
+      inline const uint64_t& operator[](const unsigned &idx) const;
+      inline uint64_t& operator[](const unsigned &idx);
+      inline AVX512BitMask& operator=(const AVX512BitMask &rhs);
+    public:
+      inline AVX512BitMask operator~(void) const;
+      inline AVX512BitMask operator|(const AVX512BitMask &rhs) const;
+      inline AVX512BitMask operator&(const AVX512BitMask &rhs) const;
+      inline AVX512BitMask operator^(const AVX512BitMask &rhs) const;
+    public:
+      inline AVX512BitMask& operator|=(const AVX512BitMask &rhs);
+      inline AVX512BitMask& operator&=(const AVX512BitMask &rhs);
+      inline AVX512BitMask& operator^=(const AVX512BitMask &rhs);
+    public:
+      // Use * for disjointness testing
+      inline bool operator*(const AVX512BitMask &rhs) const;
+      // Set difference
+      inline AVX512BitMask operator-(const AVX512BitMask &rhs) const;
+      inline AVX512BitMask& operator-=(const AVX512BitMask &rhs);
+      // Test to see if everything is zeros
+      inline bool operator!(void) const;
+    public:
+      inline AVX512BitMask operator<<(unsigned shift) const;
+      inline AVX512BitMask operator>>(unsigned shift) const;
+    public:
+      inline AVX512BitMask& operator<<=(unsigned shift);
+      inline AVX512BitMask& operator>>=(unsigned shift);
+    public:
+      inline uint64_t get_hash_key(void) const;
+      inline const uint64_t* base(void) const;
+      template<typename ST>
+      inline void serialize(ST &rez) const;
+      template<typename DT>
+      inline void deserialize(DT &derez);
+      // The functor class must have an 'apply' method that
+      // takes one unsigned argument. This method will map
+      // the functor over all the entries in the mask.
+      template<typename FUNCTOR>
+      inline void map(FUNCTOR &functor) const;
+    public:
+      // Allocates memory that becomes owned by the caller
+      inline char* to_string(void) const;
+    public:
+      inline unsigned pop_count(void) const;
+      static inline unsigned pop_count(const AVX512BitMask<MAX> &mask);
+    protected:
+      BitMaskHelp::BitVector<MAX> bits; 
+    };
+    
+    /////////////////////////////////////////////////////////////
+    // AVX-512 Two-Level Bit Mask  
+    /////////////////////////////////////////////////////////////
+    template<unsigned int MAX>
+    class alignas(64) AVX512TLBitMask
+      : public BitMaskHelp::Heapify<AVX512TLBitMask<MAX> > {
+    public:
+      static constexpr unsigned ELEMENT_SIZE =
+        BitMaskHelp::BitVector<MAX>::ELEMENT_SIZE;
+      static constexpr unsigned BIT_ELMTS = MAX/ELEMENT_SIZE;
+      static constexpr unsigned AVX512_ELMTS = MAX/512;
+      static constexpr unsigned MAXSIZE = MAX;
+    public:
+      explicit AVX512TLBitMask(uint64_t init = 0);
+      AVX512TLBitMask(const AVX512TLBitMask &rhs);
+      ~AVX512TLBitMask(void);
+    public:
+      inline void set_bit(unsigned bit);
+      inline void unset_bit(unsigned bit);
+      inline void assign_bit(unsigned bit, bool val);
+      inline bool is_set(unsigned bit) const;
+      inline int find_first_set(void) const;
+      inline int find_next_set(unsigned start) const;
+      inline int find_index(unsigned bit) const;
+      inline int get_index(unsigned index) const;
+      inline bool empty(void) const;
+      inline void clear(void);
+    public:
+      inline size_t size(void) const { return pop_count(); }
+      inline bool contains(unsigned bit) const { return is_set(bit); }
+      inline void add(unsigned bit) { set_bit(bit); }
+      inline void insert(unsigned bit) { set_bit(bit); }
+      inline void remove(unsigned bit) { unset_bit(bit); }
+    public:
+      inline bool operator==(const AVX512TLBitMask &rhs) const;
+      inline bool operator<(const AVX512TLBitMask &rhs) const;
+      inline bool operator!=(const AVX512TLBitMask &rhs) const;
+    public:
+      inline BitMaskHelp::AVX512View<true> 
+        operator()(const unsigned &idx) const;
+      inline BitMaskHelp::AVX512View<false>
+        operator()(const unsigned &idx);
+      inline const uint64_t& operator[](const unsigned &idx) const;
+      inline uint64_t& operator[](const unsigned &idx);
+      inline AVX512TLBitMask& operator=(const AVX512TLBitMask &rhs);
+    public:
+      inline AVX512TLBitMask operator~(void) const;
+      inline AVX512TLBitMask operator|(const AVX512TLBitMask &rhs) const;
+      inline AVX512TLBitMask operator&(const AVX512TLBitMask &rhs) const;
+      inline AVX512TLBitMask operator^(const AVX512TLBitMask &rhs) const;
+    public:
+      inline AVX512TLBitMask& operator|=(const AVX512TLBitMask &rhs);
+      inline AVX512TLBitMask& operator&=(const AVX512TLBitMask &rhs);
+      inline AVX512TLBitMask& operator^=(const AVX512TLBitMask &rhs);
+    public:
+      // Use * for disjointness testing
+      inline bool operator*(const AVX512TLBitMask &rhs) const;
+      // Set difference
+      inline AVX512TLBitMask operator-(const AVX512TLBitMask &rhs) const;
+      inline AVX512TLBitMask& operator-=(const AVX512TLBitMask &rhs);
+      // Test to see if everything is zeros
+      inline bool operator!(void) const;
+    public:
+      inline AVX512TLBitMask operator<<(unsigned shift) const;
+      inline AVX512TLBitMask operator>>(unsigned shift) const;
+    public:
+      inline AVX512TLBitMask& operator<<=(unsigned shift);
+      inline AVX512TLBitMask& operator>>=(unsigned shift);
+    public:
+      inline uint64_t get_hash_key(void) const;
+      inline const uint64_t* base(void) const;
+      template<typename ST>
+      inline void serialize(ST &rez) const;
+      template<typename DT>
+      inline void deserialize(DT &derez);
+      // The functor class must have an 'apply' method that
+      // takes one unsigned argument. This method will map
+      // the functor over all the entries in the mask.
+      template<typename FUNCTOR>
+      inline void map(FUNCTOR &functor) const;
+    public:
+      // Allocates memory that becomes owned by the caller
+      inline char* to_string(void) const;
+    public:
+      inline unsigned pop_count(void) const;
+      static inline unsigned pop_count(const AVX512TLBitMask<MAX> &mask);
+      static inline uint64_t extract_mask(__m512i value);
+      static inline uint64_t extract_mask(__m256d value);
+    protected:
+      BitMaskHelp::BitVector<MAX> bits;
+      uint64_t sum_mask; 
+    };
+#endif // __AVX512F__
+
 #ifdef __ALTIVEC__
     /////////////////////////////////////////////////////////////
     // PPC Bit Mask  
@@ -1273,6 +1550,101 @@
     };
 #endif // __ARM_NEON
 
+    /////////////////////////////////////////////////////////////
+    // Dispatched Two-Level Bit Mask
+    /////////////////////////////////////////////////////////////
+    /*
+     * A two-level bit mask whose bulk operations go through the
+     * BitMaskHelp::bit_kernels table instead of being compiled
+     * for one instruction set. Use it when the binary has to run
+     * on more machines than the ones it was built for, e.g. for
+     * distribution packages built for the baseline ISA, and the
+     * masks are big enough that an indirect call per operation
+     * is cheap compared to the operation itself.
+     */
+    template<unsigned int MAX>
+    class alignas(64) DispatchTLBitMask
+      : public BitMaskHelp::Heapify<DispatchTLBitMask<MAX> > {
+    public:
+      static constexpr unsigned ELEMENT_SIZE =
+        BitMaskHelp::BitVector<MAX>::ELEMENT_SIZE;
+      static constexpr unsigned BIT_ELMTS = MAX/ELEMENT_SIZE;
+      static constexpr unsigned MAXSIZE = MAX;
+    public:
+      explicit DispatchTLBitMask(uint64_t init = 0);
+      DispatchTLBitMask(const DispatchTLBitMask &rhs);
+      ~DispatchTLBitMask(void);
+    public:
+      inline void set_bit(unsigned bit);
+      inline void unset_bit(unsigned bit);
+      inline void assign_bit(unsigned bit, bool val);
+      inline bool is_set(unsigned bit) const;
+      inline int find_first_set(void) const;
+      inline int find_next_set(unsigned start) const;
+      inline int find_index(unsigned bit) const;
+      inline int get_index(unsigned index) const;
+      inline bool empty(void) const;
+      inline void clear(void);
+    public:
+      inline size_t size(void) const { return pop_count(); }
+      inline bool contains(unsigned bit) const { return is_set(bit); }
+      inline void add(unsigned bit) { set_bit(bit); }
+      inline void insert(unsigned bit) { set_bit(bit); }
+      inline void remove(unsigned bit) { unset_bit(bit); }
+    public:
+      inline bool operator==(const DispatchTLBitMask &rhs) const;
+      inline bool operator<(const DispatchTLBitMask &rhs) const;
+      inline bool operator!=(const DispatchTLBitMask &rhs) const;
+    public:
+      inline const uint64_t& operator[](const unsigned &idx) const;
+      inline uint64_t& operator[](const unsigned &idx);
+      inline DispatchTLBitMask& operator=(const DispatchTLBitMask &rhs);
+    public:
+      inline DispatchTLBitMask operator~(void) const;
+      inline DispatchTLBitMask operator|(const DispatchTLBitMask &rhs) const;
+      inline DispatchTLBitMask operator&(const DispatchTLBitMask &rhs) const;
+      inline DispatchTLBitMask operator^(const DispatchTLBitMask &rhs) const;
+    public:
+      inline DispatchTLBitMask& operator|=(const DispatchTLBitMask &rhs);
+      inline DispatchTLBitMask& operator&=(const DispatchTLBitMask &rhs);
+      inline DispatchTLBitMask& operator^=(const DispatchTLBitMask &rhs);
+    public:
+      // Use * for disjointness testing
+      inline bool operator*(const DispatchTLBitMask &rhs) const;
+      // Set difference
+      inline DispatchTLBitMask operator-(const DispatchTLBitMask &rhs) const;
+      inline DispatchTLBitMask& operator-=(const DispatchTLBitMask &rhs);
+      // Test to see if everything is zeros
+      inline bool operator!(void) const;
+    public:
+      inline DispatchTLBitMask operator<<(unsigned shift) const;
+      inline DispatchTLBitMask operator>>(unsigned shift) const;
+    public:
+      inline DispatchTLBitMask& operator<<=(unsigned shift);
+      inline DispatchTLBitMask& operator>>=(unsigned shift);
+    public:
+      inline uint64_t get_hash_key(void) const;
+      inline const uint64_t* base(void) const;
+      template<typename ST>
+      inline void serialize(ST &rez) const;
+      template<typename DT>
+      inline void deserialize(DT &derez);
+      // The functor class must have an 'apply' method that
+      // takes one unsigned argument. This method will map
+      // the functor over all the entries in the mask.
+      template<typename FUNCTOR>
+      inline void map(FUNCTOR &functor) const;
+    public:
+      // Allocates memory that becomes owned by the caller
+      inline char* to_string(void) const;
+    public:
+      inline unsigned pop_count(void) const;
+      static inline unsigned pop_count(const DispatchTLBitMask<MAX> &mask);
+    protected:
+      BitMaskHelp::BitVector<MAX> bits;
+      uint64_t sum_mask; 
+    };
+
     template<typename DT, unsigned BLOAT=1, bool BIDIR=true>
     class CompoundBitMask {
     public:
@@ -1400,40 +1772,498 @@
       return result;
     }
 
-    /**
-     * A helper class for determining alignment of types
-     */
-    template<typename T>
-    class AlignmentTrait {
-    public:
-      struct AlignmentFinder {
-        char a;
-        T b;
-      };
-      enum { AlignmentOf = sizeof(AlignmentFinder) - sizeof(T) };
-    };
+#if defined(__AVX512F__) || defined(BITMASK_DISPATCH_X86)
+    // Horizontal reductions for the AVX-512 masks and kernels. These avoid
+    // _mm512_reduce_*_epi64 and VPANDNQ (we use VPTERNLOG 0x30 = A & ~B
+    // instead) because their definitions in some versions of GCC trip
+    // -Wuninitialized which breaks -Werror builds.
 
     //--------------------------------------------------------------------------
-    template<size_t SIZE, size_t ALIGNMENT, bool BYTES>
-    inline void* alloc_aligned(size_t cnt)
+#ifndef __AVX512F__
+    __attribute__((target("avx512f")))
+#endif
+    inline uint64_t avx512_reduce_or(__m512i value)
     //--------------------------------------------------------------------------
     {
-      static_assert((SIZE % ALIGNMENT) == 0);
-      size_t alloc_size = cnt;
-      if (!BYTES)
-        alloc_size *= SIZE;
-      void *result = NULL;
-      if (ALIGNMENT > BITMASK_MAX_ALIGNMENT)
-      {
-#if defined(DEBUG_LEGION) || defined(DEBUG_REALM)
-        assert((alloc_size % ALIGNMENT) == 0);
+      // The zero-masked extracts are the ones without the problem
+      const __m256i half = _mm256_or_si256(
+          _mm512_maskz_extracti64x4_epi64(0xF, value, 0),
+          _mm512_maskz_extracti64x4_epi64(0xF, value, 1));
+      const __m128i quarter = _mm_or_si128(_mm256_castsi256_si128(half),
+          _mm256_extracti128_si256(half, 1));
+      return (_mm_cvtsi128_si64(quarter) | _mm_extract_epi64(quarter, 1));
+    }
+
+    //--------------------------------------------------------------------------
+#ifndef __AVX512F__
+    __attribute__((target("avx512f")))
 #endif
-#if (defined(DEBUG_LEGION) || defined(DEBUG_REALM)) && !defined(NDEBUG)
-        int error = 
-#else
-#ifdef __GNUC__
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wunused-result"
+    inline uint64_t avx512_reduce_add(__m512i value)
+    //--------------------------------------------------------------------------
+    {
+      // The zero-masked extracts are the ones without the problem
+      const __m256i half = _mm256_add_epi64(
+          _mm512_maskz_extracti64x4_epi64(0xF, value, 0),
+          _mm512_maskz_extracti64x4_epi64(0xF, value, 1));
+      const __m128i quarter = _mm_add_epi64(_mm256_castsi256_si128(half),
+          _mm256_extracti128_si256(half, 1));
+      return (_mm_cvtsi128_si64(quarter) + _mm_extract_epi64(quarter, 1));
+    }
+#endif
+
+    enum BitKernelOp {
+      BIT_OR_KERNEL,
+      BIT_AND_KERNEL,
+      BIT_XOR_KERNEL,
+      BIT_ANDNOT_KERNEL,
+    };
+
+    //--------------------------------------------------------------------------
+    template<BitKernelOp OP>
+    inline uint64_t generic_kernel_op(uint64_t lhs, uint64_t rhs)
+    //--------------------------------------------------------------------------
+    {
+      switch (OP)
+      {
+        case BIT_OR_KERNEL:
+          return (lhs | rhs);
+        case BIT_AND_KERNEL:
+          return (lhs & rhs);
+        case BIT_XOR_KERNEL:
+          return (lhs ^ rhs);
+        case BIT_ANDNOT_KERNEL:
+          return (lhs & ~rhs);
+      }
+      return 0;
+    }
+
+    //--------------------------------------------------------------------------
+    template<BitKernelOp OP>
+    inline uint64_t generic_binary_kernel(uint64_t *dst, const uint64_t *lhs,
+                                          const uint64_t *rhs, unsigned words)
+    //--------------------------------------------------------------------------
+    {
+      uint64_t sum = 0;
+      for (unsigned idx = 0; idx < words; idx++)
+      {
+        const uint64_t value = generic_kernel_op<OP>(lhs[idx], rhs[idx]);
+        dst[idx] = value;
+        sum |= value;
+      }
+      return sum;
+    }
+
+    //--------------------------------------------------------------------------
+    inline uint64_t generic_not_kernel(uint64_t *dst, const uint64_t *src,
+                                       unsigned words)
+    //--------------------------------------------------------------------------
+    {
+      uint64_t sum = 0;
+      for (unsigned idx = 0; idx < words; idx++)
+      {
+        dst[idx] = ~src[idx];
+        sum |= dst[idx];
+      }
+      return sum;
+    }
+
+    //--------------------------------------------------------------------------
+    inline bool generic_disjoint_kernel(const uint64_t *lhs,
+                                        const uint64_t *rhs, unsigned words)
+    //--------------------------------------------------------------------------
+    {
+      for (unsigned idx = 0; idx < words; idx++)
+        if (lhs[idx] & rhs[idx])
+          return false;
+      return true;
+    }
+
+    //--------------------------------------------------------------------------
+    inline unsigned generic_pop_count_kernel(const uint64_t *src,
+                                             unsigned words)
+    //--------------------------------------------------------------------------
+    {
+      unsigned result = 0;
+      for (unsigned idx = 0; idx < words; idx++)
+        result += __builtin_popcountll(src[idx]);
+      return result;
+    }
+
+#ifdef BITMASK_DISPATCH_X86
+    // Everything below is compiled for a specific ISA with target attributes
+    // so that the rest of the translation unit can stay at the baseline ISA
+
+    //--------------------------------------------------------------------------
+    __attribute__((target("popcnt")))
+    inline unsigned popcnt_pop_count_kernel(const uint64_t *src,
+                                            unsigned words)
+    //--------------------------------------------------------------------------
+    {
+      // Same as the generic kernel but without the libgcc call that
+      // __builtin_popcountll turns into when POPCNT isn't enabled
+      unsigned result = 0;
+      for (unsigned idx = 0; idx < words; idx++)
+        result += __builtin_popcountll(src[idx]);
+      return result;
+    }
+
+    //--------------------------------------------------------------------------
+    template<BitKernelOp OP>
+    __attribute__((target("avx2")))
+    inline __m256i avx2_kernel_op(__m256i lhs, __m256i rhs)
+    //--------------------------------------------------------------------------
+    {
+      switch (OP)
+      {
+        case BIT_OR_KERNEL:
+          return _mm256_or_si256(lhs, rhs);
+        case BIT_AND_KERNEL:
+          return _mm256_and_si256(lhs, rhs);
+        case BIT_XOR_KERNEL:
+          return _mm256_xor_si256(lhs, rhs);
+        case BIT_ANDNOT_KERNEL:
+          return _mm256_andnot_si256(rhs, lhs);
+      }
+      return _mm256_setzero_si256();
+    }
+
+    //--------------------------------------------------------------------------
+    __attribute__((target("avx2")))
+    inline uint64_t avx2_reduce_or(__m256i value)
+    //--------------------------------------------------------------------------
+    {
+      __m128i half = _mm_or_si128(_mm256_castsi256_si128(value),
+                                  _mm256_extracti128_si256(value, 1));
+      half = _mm_or_si128(half, _mm_unpackhi_epi64(half, half));
+      return _mm_cvtsi128_si64(half);
+    }
+
+    //--------------------------------------------------------------------------
+    template<BitKernelOp OP>
+    __attribute__((target("avx2")))
+    inline uint64_t avx2_binary_kernel(uint64_t *dst, const uint64_t *lhs,
+                                       const uint64_t *rhs, unsigned words)
+    //--------------------------------------------------------------------------
+    {
+      __m256i sum = _mm256_setzero_si256();
+      unsigned idx = 0;
+      for ( ; (idx + 4) <= words; idx += 4)
+      {
+        const __m256i value = avx2_kernel_op<OP>(
+            _mm256_loadu_si256((const __m256i*)(lhs + idx)),
+            _mm256_loadu_si256((const __m256i*)(rhs + idx)));
+        _mm256_storeu_si256((__m256i*)(dst + idx), value);
+        sum = _mm256_or_si256(sum, value);
+      }
+      uint64_t result = avx2_reduce_or(sum);
+      for ( ; idx < words; idx++)
+      {
+        dst[idx] = generic_kernel_op<OP>(lhs[idx], rhs[idx]);
+        result |= dst[idx];
+      }
+      return result;
+    }
+
+    //--------------------------------------------------------------------------
+    __attribute__((target("avx2")))
+    inline uint64_t avx2_not_kernel(uint64_t *dst, const uint64_t *src,
+                                    unsigned words)
+    //--------------------------------------------------------------------------
+    {
+      const __m256i ones = _mm256_set1_epi64x(-1);
+      __m256i sum = _mm256_setzero_si256();
+      unsigned idx = 0;
+      for ( ; (idx + 4) <= words; idx += 4)
+      {
+        const __m256i value = _mm256_xor_si256(ones,
+            _mm256_loadu_si256((const __m256i*)(src + idx)));
+        _mm256_storeu_si256((__m256i*)(dst + idx), value);
+        sum = _mm256_or_si256(sum, value);
+      }
+      uint64_t result = avx2_reduce_or(sum);
+      for ( ; idx < words; idx++)
+      {
+        dst[idx] = ~src[idx];
+        result |= dst[idx];
+      }
+      return result;
+    }
+
+    //--------------------------------------------------------------------------
+    __attribute__((target("avx2")))
+    inline bool avx2_disjoint_kernel(const uint64_t *lhs, const uint64_t *rhs,
+                                     unsigned words)
+    //--------------------------------------------------------------------------
+    {
+      unsigned idx = 0;
+      for ( ; (idx + 4) <= words; idx += 4)
+      {
+        if (!_mm256_testz_si256(
+              _mm256_loadu_si256((const __m256i*)(lhs + idx)),
+              _mm256_loadu_si256((const __m256i*)(rhs + idx))))
+          return false;
+      }
+      for ( ; idx < words; idx++)
+        if (lhs[idx] & rhs[idx])
+          return false;
+      return true;
+    }
+
+    // The AVX-512 kernels use masked loads and stores for the tail so there
+    // is no scalar clean-up loop, and fold the summary into a single VPTERNLOG
+    // per vector. With A as the running summary and B and C the two
+    // operands the summary truth tables are:
+    //   0xFE = A | B | C     0xF8 = A | (B & C)
+    //   0xF6 = A | (B ^ C)   0xF4 = A | (B & ~C)   0xF3 = A | ~B
+
+    //--------------------------------------------------------------------------
+    inline __mmask8 avx512_tail_mask(unsigned remaining)
+    //--------------------------------------------------------------------------
+    {
+      return (remaining >= 8) ? __mmask8(0xFF) : __mmask8((1 << remaining) - 1);
+    }
+
+    //--------------------------------------------------------------------------
+    template<BitKernelOp OP>
+    __attribute__((target("avx512f")))
+    inline __m512i avx512_kernel_op(__m512i lhs, __m512i rhs)
+    //--------------------------------------------------------------------------
+    {
+      switch (OP)
+      {
+        case BIT_OR_KERNEL:
+          return _mm512_or_si512(lhs, rhs);
+        case BIT_AND_KERNEL:
+          return _mm512_and_si512(lhs, rhs);
+        case BIT_XOR_KERNEL:
+          return _mm512_xor_si512(lhs, rhs);
+        case BIT_ANDNOT_KERNEL:
+          return _mm512_ternarylogic_epi64(lhs, rhs, rhs, 0x30);
+      }
+      return _mm512_setzero_si512();
+    }
+
+    //--------------------------------------------------------------------------
+    template<BitKernelOp OP>
+    __attribute__((target("avx512f")))
+    inline uint64_t avx512_binary_kernel(uint64_t *dst, const uint64_t *lhs,
+                                         const uint64_t *rhs, unsigned words)
+    //--------------------------------------------------------------------------
+    {
+      constexpr int SUMMARY = (OP == BIT_OR_KERNEL) ? 0xFE :
+                              (OP == BIT_AND_KERNEL) ? 0xF8 :
+                              (OP == BIT_XOR_KERNEL) ? 0xF6 : 0xF4;
+      __m512i sum = _mm512_setzero_si512();
+      for (unsigned idx = 0; idx < words; idx += 8)
+      {
+        // Masked-off lanes load as zero which all the operations
+        // keep as zero so they never show up in the summary
+        const __mmask8 mask = avx512_tail_mask(words - idx);
+        const __m512i left = _mm512_maskz_loadu_epi64(mask, lhs + idx);
+        const __m512i right = _mm512_maskz_loadu_epi64(mask, rhs + idx);
+        _mm512_mask_storeu_epi64(dst + idx, mask,
+                                 avx512_kernel_op<OP>(left, right));
+        sum = _mm512_ternarylogic_epi64(sum, left, right, SUMMARY);
+      }
+      return avx512_reduce_or(sum);
+    }
+
+    //--------------------------------------------------------------------------
+    __attribute__((target("avx512f")))
+    inline uint64_t avx512_not_kernel(uint64_t *dst, const uint64_t *src,
+                                      unsigned words)
+    //--------------------------------------------------------------------------
+    {
+      __m512i sum = _mm512_setzero_si512();
+      for (unsigned idx = 0; idx < words; idx += 8)
+      {
+        const __mmask8 mask = avx512_tail_mask(words - idx);
+        const __m512i value = _mm512_maskz_loadu_epi64(mask, src + idx);
+        _mm512_mask_storeu_epi64(dst + idx, mask,
+            _mm512_ternarylogic_epi64(value, value, value, 0x55));
+        // Negation turns the masked-off lanes into ones so only
+        // update the summary with the lanes that are really there
+        sum = _mm512_mask_ternarylogic_epi64(sum, mask, value, value, 0xF3);
+      }
+      return avx512_reduce_or(sum);
+    }
+
+    //--------------------------------------------------------------------------
+    __attribute__((target("avx512f")))
+    inline bool avx512_disjoint_kernel(const uint64_t *lhs,
+                                       const uint64_t *rhs, unsigned words)
+    //--------------------------------------------------------------------------
+    {
+      for (unsigned idx = 0; idx < words; idx += 8)
+      {
+        const __mmask8 mask = avx512_tail_mask(words - idx);
+        if (_mm512_mask_test_epi64_mask(mask,
+              _mm512_maskz_loadu_epi64(mask, lhs + idx),
+              _mm512_maskz_loadu_epi64(mask, rhs + idx)))
+          return false;
+      }
+      return true;
+    }
+
+#ifdef BITMASK_DISPATCH_VPOPCNT
+    //--------------------------------------------------------------------------
+    __attribute__((target("avx512f,avx512vpopcntdq")))
+    inline unsigned avx512_pop_count_kernel(const uint64_t *src,
+                                            unsigned words)
+    //--------------------------------------------------------------------------
+    {
+      __m512i counts = _mm512_setzero_si512();
+      for (unsigned idx = 0; idx < words; idx += 8)
+      {
+        const __mmask8 mask = avx512_tail_mask(words - idx);
+        counts = _mm512_add_epi64(counts,
+            _mm512_popcnt_epi64(_mm512_maskz_loadu_epi64(mask, src + idx)));
+      }
+      return avx512_reduce_add(counts);
+    }
+#endif
+#endif // BITMASK_DISPATCH_X86
+
+    //--------------------------------------------------------------------------
+    inline const BitKernels* find_bit_kernels(BitKernelISA isa)
+    //--------------------------------------------------------------------------
+    {
+      switch (isa)
+      {
+        case GENERIC_BIT_KERNELS:
+          {
+            static const BitKernels generic_kernels = {
+              "generic",
+              generic_binary_kernel<BIT_OR_KERNEL>,
+              generic_binary_kernel<BIT_AND_KERNEL>,
+              generic_binary_kernel<BIT_XOR_KERNEL>,
+              generic_binary_kernel<BIT_ANDNOT_KERNEL>,
+              generic_not_kernel,
+              generic_disjoint_kernel,
+              generic_pop_count_kernel,
+            };
+            return &generic_kernels;
+          }
+#ifdef BITMASK_DISPATCH_X86
+        case AVX2_BIT_KERNELS:
+          {
+            static const BitKernels avx2_kernels = {
+              "avx2",
+              avx2_binary_kernel<BIT_OR_KERNEL>,
+              avx2_binary_kernel<BIT_AND_KERNEL>,
+              avx2_binary_kernel<BIT_XOR_KERNEL>,
+              avx2_binary_kernel<BIT_ANDNOT_KERNEL>,
+              avx2_not_kernel,
+              avx2_disjoint_kernel,
+              popcnt_pop_count_kernel,
+            };
+            __builtin_cpu_init();
+            if (!__builtin_cpu_supports("avx2") ||
+                !__builtin_cpu_supports("popcnt"))
+              return NULL;
+            return &avx2_kernels;
+          }
+        case AVX512_BIT_KERNELS:
+          {
+            static const BitKernels avx512_kernels = {
+              "avx512",
+              avx512_binary_kernel<BIT_OR_KERNEL>,
+              avx512_binary_kernel<BIT_AND_KERNEL>,
+              avx512_binary_kernel<BIT_XOR_KERNEL>,
+              avx512_binary_kernel<BIT_ANDNOT_KERNEL>,
+              avx512_not_kernel,
+              avx512_disjoint_kernel,
+              popcnt_pop_count_kernel,
+            };
+            __builtin_cpu_init();
+            if (!__builtin_cpu_supports("avx512f") ||
+                !__builtin_cpu_supports("popcnt"))
+              return NULL;
+            return &avx512_kernels;
+          }
+#ifdef BITMASK_DISPATCH_VPOPCNT
+        case AVX512_VPOPCNT_BIT_KERNELS:
+          {
+            static const BitKernels avx512_vpopcnt_kernels = {
+              "avx512+vpopcntdq",
+              avx512_binary_kernel<BIT_OR_KERNEL>,
+              avx512_binary_kernel<BIT_AND_KERNEL>,
+              avx512_binary_kernel<BIT_XOR_KERNEL>,
+              avx512_binary_kernel<BIT_ANDNOT_KERNEL>,
+              avx512_not_kernel,
+              avx512_disjoint_kernel,
+              avx512_pop_count_kernel,
+            };
+            __builtin_cpu_init();
+            if (!__builtin_cpu_supports("avx512f") ||
+                !__builtin_cpu_supports("avx512vpopcntdq"))
+              return NULL;
+            return &avx512_vpopcnt_kernels;
+          }
+#endif
+#endif // BITMASK_DISPATCH_X86
+        default:
+          break;
+      }
+      return NULL;
+    }
+
+    //--------------------------------------------------------------------------
+    inline const BitKernels& select_bit_kernels(void)
+    //--------------------------------------------------------------------------
+    {
+      for (int isa = NUM_BIT_KERNEL_ISAS-1; isa > GENERIC_BIT_KERNELS; isa--)
+      {
+        const BitKernels *kernels = find_bit_kernels(BitKernelISA(isa));
+        if (kernels != NULL)
+          return *kernels;
+      }
+      return *find_bit_kernels(GENERIC_BIT_KERNELS);
+    }
+
+    //--------------------------------------------------------------------------
+    inline const BitKernels& bit_kernels(void)
+    //--------------------------------------------------------------------------
+    {
+      // Only look at the processor once and then stick with that choice
+      static const BitKernels &kernels = select_bit_kernels();
+      return kernels;
+    }
+
+    /**
+     * A helper class for determining alignment of types
+     */
+    template<typename T>
+    class AlignmentTrait {
+    public:
+      struct AlignmentFinder {
+        char a;
+        T b;
+      };
+      enum { AlignmentOf = sizeof(AlignmentFinder) - sizeof(T) };
+    };
+
+    //--------------------------------------------------------------------------
+    template<size_t SIZE, size_t ALIGNMENT, bool BYTES>
+    inline void* alloc_aligned(size_t cnt)
+    //--------------------------------------------------------------------------
+    {
+      static_assert((SIZE % ALIGNMENT) == 0);
+      size_t alloc_size = cnt;
+      if (!BYTES)
+        alloc_size *= SIZE;
+      void *result = NULL;
+      if (ALIGNMENT > BITMASK_MAX_ALIGNMENT)
+      {
+#if defined(DEBUG_LEGION) || defined(DEBUG_REALM)
+        assert((alloc_size % ALIGNMENT) == 0);
+#endif
+#if (defined(DEBUG_LEGION) || defined(DEBUG_REALM)) && !defined(NDEBUG)
+        int error = 
+#else
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-result"
 #endif
 #ifdef __clang__
 #pragma clang diagnostic push
@@ -6101,13 +6931,13 @@
     }
 #endif // __AVX__
 
-#ifdef __ALTIVEC__
+#ifdef __AVX512F__
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    PPCBitMask<MAX>::PPCBitMask(uint64_t init /*= 0*/)
+    AVX512BitMask<MAX>::AVX512BitMask(uint64_t init /*= 0*/)
     //-------------------------------------------------------------------------
     {
-      static_assert((MAX % 128) == 0);
+      static_assert((MAX % 512) == 0);
       for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
       {
         bits.bit_vector[idx] = init;
@@ -6116,26 +6946,26 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    PPCBitMask<MAX>::PPCBitMask(const PPCBitMask &rhs)
+    AVX512BitMask<MAX>::AVX512BitMask(const AVX512BitMask &rhs)
     //-------------------------------------------------------------------------
     {
-      static_assert((MAX % 128) == 0);
-      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+      static_assert((MAX % 512) == 0);
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        bits.ppc_view(idx) = rhs(idx);
+        bits.avx512_view(idx) = rhs(idx);
       }
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    PPCBitMask<MAX>::~PPCBitMask(void)
+    AVX512BitMask<MAX>::~AVX512BitMask(void)
     //-------------------------------------------------------------------------
     {
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline void PPCBitMask<MAX>::set_bit(unsigned bit)
+    inline void AVX512BitMask<MAX>::set_bit(unsigned bit)
     //-------------------------------------------------------------------------
     {
 #ifdef DEBUG_LEGION
@@ -6147,7 +6977,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline void PPCBitMask<MAX>::unset_bit(unsigned bit)
+    inline void AVX512BitMask<MAX>::unset_bit(unsigned bit)
     //-------------------------------------------------------------------------
     {
 #ifdef DEBUG_LEGION
@@ -6159,7 +6989,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline void PPCBitMask<MAX>::assign_bit(unsigned bit, bool val)
+    inline void AVX512BitMask<MAX>::assign_bit(unsigned bit, bool val)
     //-------------------------------------------------------------------------
     {
       if (val)
@@ -6170,7 +7000,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool PPCBitMask<MAX>::is_set(unsigned bit) const
+    inline bool AVX512BitMask<MAX>::is_set(unsigned bit) const
     //-------------------------------------------------------------------------
     {
 #ifdef DEBUG_LEGION
@@ -6182,7 +7012,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline int PPCBitMask<MAX>::find_first_set(void) const
+    inline int AVX512BitMask<MAX>::find_first_set(void) const
     //-------------------------------------------------------------------------
     {
       for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
@@ -6203,7 +7033,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline int PPCBitMask<MAX>::find_index(unsigned bit) const
+    inline int AVX512BitMask<MAX>::find_index(unsigned bit) const
     //-------------------------------------------------------------------------
     {
       unsigned element = bit >> bits.SHIFT; 
@@ -6228,7 +7058,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline int PPCBitMask<MAX>::get_index(unsigned index) const
+    inline int AVX512BitMask<MAX>::get_index(unsigned index) const
     //-------------------------------------------------------------------------
     {
       int offset = 0;
@@ -6255,7 +7085,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline int PPCBitMask<MAX>::find_next_set(unsigned start) const
+    inline int AVX512BitMask<MAX>::find_next_set(unsigned start) const
     //-------------------------------------------------------------------------
     {
       int idx = start / ELEMENT_SIZE; // truncate
@@ -6288,37 +7118,36 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline void PPCBitMask<MAX>::clear(void)
+    inline void AVX512BitMask<MAX>::clear(void)
     //-------------------------------------------------------------------------
     {
-      const __vector unsigned long long zero_vec = vec_splats(0ULL);
-      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        bits.ppc_view(idx) = zero_vec;
+        bits.avx512_view(idx) = _mm512_setzero_si512();
       }
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline BitMaskHelp::PPCView<true>
-                     PPCBitMask<MAX>::operator()(const unsigned int &idx) const
+    inline BitMaskHelp::AVX512View<true>
+                  AVX512BitMask<MAX>::operator()(const unsigned int &idx) const
     //-------------------------------------------------------------------------
     {
-      return bits.ppc_view(idx);
+      return bits.avx512_view(idx);
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline BitMaskHelp::PPCView<false>
-                           PPCBitMask<MAX>::operator()(const unsigned int &idx)
+    inline BitMaskHelp::AVX512View<false>
+                        AVX512BitMask<MAX>::operator()(const unsigned int &idx)
     //-------------------------------------------------------------------------
     {
-      return bits.ppc_view(idx);
+      return bits.avx512_view(idx);
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline const uint64_t& PPCBitMask<MAX>::operator[](
+    inline const uint64_t& AVX512BitMask<MAX>::operator[](
                                                  const unsigned int &idx) const
     //-------------------------------------------------------------------------
     {
@@ -6327,7 +7156,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline uint64_t& PPCBitMask<MAX>::operator[](const unsigned int &idx) 
+    inline uint64_t& AVX512BitMask<MAX>::operator[](const unsigned int &idx) 
     //-------------------------------------------------------------------------
     {
       return bits.bit_vector[idx]; 
@@ -6335,12 +7164,12 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool PPCBitMask<MAX>::operator==(const PPCBitMask &rhs) const
+    inline bool AVX512BitMask<MAX>::operator==(const AVX512BitMask &rhs) const
     //-------------------------------------------------------------------------
     {
-      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-	if (bits.bit_vector[idx] != rhs[idx])
+        if (_mm512_cmpneq_epi64_mask(bits.avx512_view(idx), rhs(idx)))
           return false;
       }
       return true;
@@ -6348,15 +7177,15 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool PPCBitMask<MAX>::operator<(const PPCBitMask &rhs) const
+    inline bool AVX512BitMask<MAX>::operator<(const AVX512BitMask &rhs) const
     //-------------------------------------------------------------------------
     {
       // Only be less than if the bits are a subset of the rhs bits
       for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
       {
-        if (bits.ppc_view(idx) < rhs[idx])
+        if (bits.bit_vector[idx] < rhs[idx])
           return true;
-        else if (bits.bits_vector[idx] > rhs[idx])
+        else if (bits.bit_vector[idx] > rhs[idx])
           return false;
       }
       // Otherwise they are equal so false
@@ -6365,7 +7194,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool PPCBitMask<MAX>::operator!=(const PPCBitMask &rhs) const
+    inline bool AVX512BitMask<MAX>::operator!=(const AVX512BitMask &rhs) const
     //-------------------------------------------------------------------------
     {
       return !(*this == rhs);
@@ -6373,128 +7202,125 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCBitMask<MAX>& PPCBitMask<MAX>::operator=(const PPCBitMask &rhs)
+    inline AVX512BitMask<MAX>& AVX512BitMask<MAX>::operator=(
+                                                      const AVX512BitMask &rhs)
     //-------------------------------------------------------------------------
     {
-      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        bits.ppc_view(idx) = rhs(idx);
+        bits.avx512_view(idx) = rhs(idx);
       }
       return *this;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCBitMask<MAX> PPCBitMask<MAX>::operator~(void) const
+    inline AVX512BitMask<MAX> AVX512BitMask<MAX>::operator~(void) const
     //-------------------------------------------------------------------------
     {
-      PPCBitMask<MAX> result;
-      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+      AVX512BitMask<MAX> result;
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        __vector unsigned long long rhs = bits.ppc_view(idx);
-        result(idx) = ~rhs;
+        // Truth table 0x55 is ~C, so no all-ones constant is needed
+        const __m512i value = bits.avx512_view(idx);
+        result(idx) = _mm512_ternarylogic_epi64(value, value, value, 0x55);
       }
       return result;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCBitMask<MAX> PPCBitMask<MAX>::operator|(
-                                                   const PPCBitMask &rhs) const
+    inline AVX512BitMask<MAX> AVX512BitMask<MAX>::operator|(
+                                                const AVX512BitMask &rhs) const
     //-------------------------------------------------------------------------
     {
-      PPCBitMask<MAX> result;
-      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+      AVX512BitMask<MAX> result;
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        __vector unsigned long long rhs1 = bits.ppc_view(idx);
-        __vector unsigned long long rhs2 = rhs(idx);
-        result(idx) = vec_or(rhs1, rhs2);
+        result(idx) = _mm512_or_si512(bits.avx512_view(idx), rhs(idx));
       }
       return result;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCBitMask<MAX> PPCBitMask<MAX>::operator&(
-                                                   const PPCBitMask &rhs) const
+    inline AVX512BitMask<MAX> AVX512BitMask<MAX>::operator&(
+                                                const AVX512BitMask &rhs) const
     //-------------------------------------------------------------------------
     {
-      PPCBitMask<MAX> result;
-      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+      AVX512BitMask<MAX> result;
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        __vector unsigned long long rhs1 = bits.ppc_view(idx);
-        __vector unsigned long long rhs2 = rhs(idx);
-        result(idx) = vec_and(rhs1, rhs2);
+        result(idx) = _mm512_and_si512(bits.avx512_view(idx), rhs(idx));
       }
       return result;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCBitMask<MAX> PPCBitMask<MAX>::operator^(
-                                                   const PPCBitMask &rhs) const
+    inline AVX512BitMask<MAX> AVX512BitMask<MAX>::operator^(
+                                                const AVX512BitMask &rhs) const
     //-------------------------------------------------------------------------
     {
-      PPCBitMask<MAX> result;
-      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+      AVX512BitMask<MAX> result;
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        __vector unsigned long long rhs1 = bits.ppc_view(idx);
-        __vector unsigned long long rhs2 = rhs(idx);
-        result(idx) = vec_xor(rhs1, rhs2);
+        result(idx) = _mm512_xor_si512(bits.avx512_view(idx), rhs(idx));
       }
       return result;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCBitMask<MAX>& PPCBitMask<MAX>::operator|=(const PPCBitMask &rhs) 
+    inline AVX512BitMask<MAX>& AVX512BitMask<MAX>::operator|=(
+                                                      const AVX512BitMask &rhs)
     //-------------------------------------------------------------------------
     {
-      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        __vector unsigned long long rhs1 = bits.ppc_view(idx);
-        __vector unsigned long long rhs2 = rhs(idx);
-        bits.ppc_view(idx) = vec_or(rhs1, rhs2);
+        bits.avx512_view(idx) =
+          _mm512_or_si512(bits.avx512_view(idx), rhs(idx));
       }
       return *this;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCBitMask<MAX>& PPCBitMask<MAX>::operator&=(const PPCBitMask &rhs)
+    inline AVX512BitMask<MAX>& AVX512BitMask<MAX>::operator&=(
+                                                      const AVX512BitMask &rhs)
     //-------------------------------------------------------------------------
     {
-      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        __vector unsigned long long rhs1 = bits.ppc_view(idx);
-        __vector unsigned long long rhs2 = rhs(idx);
-        bits.ppc_view(idx) = vec_and(rhs1, rhs2);
+        bits.avx512_view(idx) =
+          _mm512_and_si512(bits.avx512_view(idx), rhs(idx));
       }
       return *this;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCBitMask<MAX>& PPCBitMask<MAX>::operator^=(const PPCBitMask &rhs)
+    inline AVX512BitMask<MAX>& AVX512BitMask<MAX>::operator^=(
+                                                      const AVX512BitMask &rhs)
     //-------------------------------------------------------------------------
     {
-      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        __vector unsigned long long rhs1 = bits.ppc_view(idx);
-        __vector unsigned long long rhs2 = rhs(idx);
-        bits.ppc_view(idx) = vec_xor(rhs1, rhs2);
+        bits.avx512_view(idx) =
+          _mm512_xor_si512(bits.avx512_view(idx), rhs(idx));
       }
       return *this;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool PPCBitMask<MAX>::operator*(const PPCBitMask &rhs) const
+    inline bool AVX512BitMask<MAX>::operator*(const AVX512BitMask &rhs) const
     //-------------------------------------------------------------------------
     {
-      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      // VPTESTMQ does the and and the test for zero in one instruction
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        if (bits.bit_vector[idx] & rhs[idx])
+        if (_mm512_test_epi64_mask(bits.avx512_view(idx), rhs(idx)))
           return false;
       }
       return true;
@@ -6502,42 +7328,46 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCBitMask<MAX> PPCBitMask<MAX>::operator-(
-                                                   const PPCBitMask &rhs) const
+    inline AVX512BitMask<MAX> AVX512BitMask<MAX>::operator-(
+                                                const AVX512BitMask &rhs) const
     //-------------------------------------------------------------------------
     {
-      PPCBitMask<MAX> result;
-      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+      AVX512BitMask<MAX> result;
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        __vector unsigned long long rhs1 = bits.ppc_view(idx);
-        __vector unsigned long long rhs2 = rhs(idx);
-        result(idx) = vec_and(rhs1, ~rhs2);
+        // Truth table 0x30 is A & ~B
+        const __m512i value = bits.avx512_view(idx);
+        const __m512i mask = rhs(idx);
+        result(idx) = _mm512_ternarylogic_epi64(value, mask, mask, 0x30);
       }
       return result;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCBitMask<MAX>& PPCBitMask<MAX>::operator-=(const PPCBitMask &rhs)
+    inline AVX512BitMask<MAX>& AVX512BitMask<MAX>::operator-=(
+                                                      const AVX512BitMask &rhs)
     //-------------------------------------------------------------------------
     {
-      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        __vector unsigned long long rhs1 = bits.ppc_view(idx);
-        __vector unsigned long long rhs2 = rhs(idx);
-        bits.ppc_view(idx) = vec_and(rhs1, ~rhs2);
+        const __m512i value = bits.avx512_view(idx);
+        const __m512i mask = rhs(idx);
+        bits.avx512_view(idx) =
+          _mm512_ternarylogic_epi64(value, mask, mask, 0x30);
       }
       return *this;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool PPCBitMask<MAX>::empty(void) const
+    inline bool AVX512BitMask<MAX>::empty(void) const
     //-------------------------------------------------------------------------
     {
-      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        if (bits.bit_vector[idx] != 0)
+        const __m512i value = bits.avx512_view(idx);
+        if (_mm512_test_epi64_mask(value, value))
           return false;
       }
       return true;
@@ -6545,7 +7375,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool PPCBitMask<MAX>::operator!(void) const
+    inline bool AVX512BitMask<MAX>::operator!(void) const
     //-------------------------------------------------------------------------
     {
       return empty();
@@ -6553,13 +7383,14 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCBitMask<MAX> PPCBitMask<MAX>::operator<<(unsigned shift) const
+    inline AVX512BitMask<MAX> AVX512BitMask<MAX>::operator<<(
+                                                          unsigned shift) const
     //-------------------------------------------------------------------------
     {
       // Find the range
       unsigned range = shift >> 6;
       unsigned local = shift & 0x3F;
-      PPCBitMask<MAX> result;
+      AVX512BitMask<MAX> result;
       if (!local)
       {
         // Fast case where we just have to move the individual words
@@ -6591,12 +7422,13 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCBitMask<MAX> PPCBitMask<MAX>::operator>>(unsigned shift) const
+    inline AVX512BitMask<MAX> AVX512BitMask<MAX>::operator>>(
+                                                          unsigned shift) const
     //-------------------------------------------------------------------------
     {
       unsigned range = shift >> 6;
       unsigned local = shift & 0x3F;
-      PPCBitMask<MAX> result;
+      AVX512BitMask<MAX> result;
       if (!local)
       {
         // Fast case where we just have to move individual words
@@ -6628,7 +7460,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCBitMask<MAX>& PPCBitMask<MAX>::operator<<=(unsigned shift)
+    inline AVX512BitMask<MAX>& AVX512BitMask<MAX>::operator<<=(unsigned shift)
     //-------------------------------------------------------------------------
     {
       // Find the range
@@ -6665,7 +7497,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCBitMask<MAX>& PPCBitMask<MAX>::operator>>=(unsigned shift)
+    inline AVX512BitMask<MAX>& AVX512BitMask<MAX>::operator>>=(unsigned shift)
     //-------------------------------------------------------------------------
     {
       unsigned range = shift >> 6;
@@ -6702,7 +7534,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline uint64_t PPCBitMask<MAX>::get_hash_key(void) const
+    inline uint64_t AVX512BitMask<MAX>::get_hash_key(void) const
     //-------------------------------------------------------------------------
     {
       uint64_t result = 0;
@@ -6715,7 +7547,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline const uint64_t* PPCBitMask<MAX>::base(void) const
+    inline const uint64_t* AVX512BitMask<MAX>::base(void) const
     //-------------------------------------------------------------------------
     {
       return bits.bit_vector;
@@ -6723,7 +7555,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX> template<typename ST>
-    inline void PPCBitMask<MAX>::serialize(ST &rez) const
+    inline void AVX512BitMask<MAX>::serialize(ST &rez) const
     //-------------------------------------------------------------------------
     {
       rez.serialize(bits.bit_vector, (MAX/8));
@@ -6731,7 +7563,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX> template<typename DT>
-    inline void PPCBitMask<MAX>::deserialize(DT &derez)
+    inline void AVX512BitMask<MAX>::deserialize(DT &derez)
     //-------------------------------------------------------------------------
     {
       derez.deserialize(bits.bit_vector, (MAX/8));
@@ -6739,7 +7571,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX> template<typename FUNCTOR>
-    inline void PPCBitMask<MAX>::map(FUNCTOR &functor) const
+    inline void AVX512BitMask<MAX>::map(FUNCTOR &functor) const
     //-------------------------------------------------------------------------
     {
       for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
@@ -6756,7 +7588,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline char* PPCBitMask<MAX>::to_string(void) const
+    inline char* AVX512BitMask<MAX>::to_string(void) const
     //-------------------------------------------------------------------------
     {
       return BitMaskHelp::to_string(bits.bit_vector, MAX);
@@ -6764,15 +7596,27 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline unsigned PPCBitMask<MAX>::pop_count(void) const
+    inline unsigned AVX512BitMask<MAX>::pop_count(void) const
     //-------------------------------------------------------------------------
     {
       unsigned result = 0;
 #ifndef VALGRIND
+#ifdef __AVX512VPOPCNTDQ__
+      // VPOPCNTQ counts all eight words at once so we only do one
+      // horizontal reduction at the end
+      __m512i counts = _mm512_setzero_si512();
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
+      {
+        counts = _mm512_add_epi64(counts,
+                    _mm512_popcnt_epi64(bits.avx512_view(idx)));
+      }
+      result = BitMaskHelp::avx512_reduce_add(counts);
+#else
       for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
       {
         result += __builtin_popcountll(bits.bit_vector[idx]);
       }
+#endif
 #else
       for (unsigned idx = 0; idx < MAX; idx++)
       {
@@ -6785,33 +7629,20 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    /*static*/ inline unsigned PPCBitMask<MAX>::pop_count(
-                                                   const PPCBitMask<MAX> &mask)
+    /*static*/ inline unsigned AVX512BitMask<MAX>::pop_count(
+                                                const AVX512BitMask<MAX> &mask)
     //-------------------------------------------------------------------------
     {
-      unsigned result = 0;
-#ifndef VALGRIND
-      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
-      {
-        result += __builtin_popcountll(mask[idx]);
-      }
-#else
-      for (unsigned idx = 0; idx < MAX; idx++)
-      {
-        if (mask.is_set(idx))
-          result++;
-      }
-#endif
-      return result;
+      return mask.pop_count();
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    PPCTLBitMask<MAX>::PPCTLBitMask(uint64_t init /*= 0*/)
+    AVX512TLBitMask<MAX>::AVX512TLBitMask(uint64_t init /*= 0*/)
       : sum_mask(init)
     //-------------------------------------------------------------------------
     {
-      static_assert((MAX % 128) == 0);
+      static_assert((MAX % 512) == 0);
       for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
       {
         bits.bit_vector[idx] = init;
@@ -6820,27 +7651,27 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    PPCTLBitMask<MAX>::PPCTLBitMask(const PPCTLBitMask &rhs)
+    AVX512TLBitMask<MAX>::AVX512TLBitMask(const AVX512TLBitMask &rhs)
       : sum_mask(rhs.sum_mask)
     //-------------------------------------------------------------------------
     {
-      static_assert((MAX % 128) == 0);
-      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+      static_assert((MAX % 512) == 0);
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        bits.ppc_view(idx) = rhs(idx);
+        bits.avx512_view(idx) = rhs(idx);
       }
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    PPCTLBitMask<MAX>::~PPCTLBitMask(void)
+    AVX512TLBitMask<MAX>::~AVX512TLBitMask(void)
     //-------------------------------------------------------------------------
     {
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline void PPCTLBitMask<MAX>::set_bit(unsigned bit)
+    inline void AVX512TLBitMask<MAX>::set_bit(unsigned bit)
     //-------------------------------------------------------------------------
     {
 #ifdef DEBUG_LEGION
@@ -6854,7 +7685,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline void PPCTLBitMask<MAX>::unset_bit(unsigned bit)
+    inline void AVX512TLBitMask<MAX>::unset_bit(unsigned bit)
     //-------------------------------------------------------------------------
     {
 #ifdef DEBUG_LEGION
@@ -6872,7 +7703,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline void PPCTLBitMask<MAX>::assign_bit(unsigned bit, bool val)
+    inline void AVX512TLBitMask<MAX>::assign_bit(unsigned bit, bool val)
     //-------------------------------------------------------------------------
     {
       if (val)
@@ -6883,7 +7714,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool PPCTLBitMask<MAX>::is_set(unsigned bit) const
+    inline bool AVX512TLBitMask<MAX>::is_set(unsigned bit) const
     //-------------------------------------------------------------------------
     {
 #ifdef DEBUG_LEGION
@@ -6895,7 +7726,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline int PPCTLBitMask<MAX>::find_first_set(void) const
+    inline int AVX512TLBitMask<MAX>::find_first_set(void) const
     //-------------------------------------------------------------------------
     {
       for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
@@ -6906,7 +7737,7 @@
           {
             if (bits.bit_vector[idx] & (1UL << j))
             {
-              return (idx*ELEMENT_SIZE + j);
+              return (idx*ELEMENT_SIZE+ j);
             }
           }
         }
@@ -6916,7 +7747,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline int PPCTLBitMask<MAX>::find_index(unsigned bit) const
+    inline int AVX512TLBitMask<MAX>::find_index(unsigned bit) const
     //-------------------------------------------------------------------------
     {
       unsigned element = bit >> bits.SHIFT; 
@@ -6941,7 +7772,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline int PPCTLBitMask<MAX>::get_index(unsigned index) const
+    inline int AVX512TLBitMask<MAX>::get_index(unsigned index) const
     //-------------------------------------------------------------------------
     {
       int offset = 0;
@@ -6968,7 +7799,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline int PPCTLBitMask<MAX>::find_next_set(unsigned start) const
+    inline int AVX512TLBitMask<MAX>::find_next_set(unsigned start) const
     //-------------------------------------------------------------------------
     {
       int idx = start / ELEMENT_SIZE; // truncate
@@ -7001,38 +7832,37 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline void PPCTLBitMask<MAX>::clear(void)
+    inline void AVX512TLBitMask<MAX>::clear(void)
     //-------------------------------------------------------------------------
     {
-      const __vector unsigned long long zero_vec = vec_splats(0ULL);
-      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        bits.ppc_view(idx) = zero_vec; 
+        bits.avx512_view(idx) = _mm512_setzero_si512();
       }
       sum_mask = 0;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline BitMaskHelp::PPCView<true>
-                   PPCTLBitMask<MAX>::operator()(const unsigned int &idx) const
+    inline BitMaskHelp::AVX512View<true>
+                AVX512TLBitMask<MAX>::operator()(const unsigned int &idx) const
     //-------------------------------------------------------------------------
     {
-      return bits.ppc_view(idx);
+      return bits.avx512_view(idx);
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline BitMaskHelp::PPCView<false>
-                         PPCTLBitMask<MAX>::operator()(const unsigned int &idx)
+    inline BitMaskHelp::AVX512View<false>
+                      AVX512TLBitMask<MAX>::operator()(const unsigned int &idx)
     //-------------------------------------------------------------------------
     {
-      return bits.ppc_view(idx);
+      return bits.avx512_view(idx);
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline const uint64_t& PPCTLBitMask<MAX>::operator[](
+    inline const uint64_t& AVX512TLBitMask<MAX>::operator[](
                                                  const unsigned int &idx) const
     //-------------------------------------------------------------------------
     {
@@ -7041,7 +7871,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline uint64_t& PPCTLBitMask<MAX>::operator[](const unsigned int &idx) 
+    inline uint64_t& AVX512TLBitMask<MAX>::operator[](const unsigned int &idx) 
     //-------------------------------------------------------------------------
     {
       return bits.bit_vector[idx]; 
@@ -7049,14 +7879,15 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool PPCTLBitMask<MAX>::operator==(const PPCTLBitMask &rhs) const
+    inline bool AVX512TLBitMask<MAX>::operator==(
+                                              const AVX512TLBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
       if (sum_mask != rhs.sum_mask)
         return false;
-      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-	if (bits.bit_vector[idx] != rhs[idx])
+        if (_mm512_cmpneq_epi64_mask(bits.avx512_view(idx), rhs(idx)))
           return false;
       }
       return true;
@@ -7064,7 +7895,8 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool PPCTLBitMask<MAX>::operator<(const PPCTLBitMask &rhs) const
+    inline bool AVX512TLBitMask<MAX>::operator<(
+                                              const AVX512TLBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
       // Only be less than if the bits are a subset of the rhs bits
@@ -7081,7 +7913,8 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool PPCTLBitMask<MAX>::operator!=(const PPCTLBitMask &rhs) const
+    inline bool AVX512TLBitMask<MAX>::operator!=(
+                                              const AVX512TLBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
       return !(*this == rhs);
@@ -7089,92 +7922,95 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCTLBitMask<MAX>& PPCTLBitMask<MAX>::operator=(
-                                                       const PPCTLBitMask &rhs)
+    inline AVX512TLBitMask<MAX>& AVX512TLBitMask<MAX>::operator=(
+                                                    const AVX512TLBitMask &rhs)
     //-------------------------------------------------------------------------
     {
       sum_mask = rhs.sum_mask;
-      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        bits.ppc_view(idx) = rhs(idx);
+        bits.avx512_view(idx) = rhs(idx);
       }
       return *this;
     }
 
+    // The two-level operations below fold the summary update into the
+    // operation itself with VPTERNLOG. With A as the running summary and
+    // B and C as the two operands the truth tables are:
+    //   0xF8 = A | (B & C)   0xF6 = A | (B ^ C)
+    //   0xF4 = A | (B & ~C)  0xF3 = A | ~B
+    // so the summary does not have to wait for the result to be computed.
+    // Set difference itself is 0x30 = A & ~B on the two operands.
+
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCTLBitMask<MAX> PPCTLBitMask<MAX>::operator~(void) const
+    inline AVX512TLBitMask<MAX> AVX512TLBitMask<MAX>::operator~(void) const
     //-------------------------------------------------------------------------
     {
-      PPCTLBitMask<MAX> result;
-      __vector unsigned long long result_mask = vec_splats(0ULL);
-      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+      AVX512TLBitMask<MAX> result;
+      __m512i temp_sum = _mm512_setzero_si512();
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        __vector unsigned long long rhs = bits.ppc_view(idx);
-        __vector unsigned long long lhs = ~rhs;
-        result(idx) = lhs;
-        result_mask = vec_or(result_mask, lhs);
+        const __m512i value = bits.avx512_view(idx);
+        result(idx) = _mm512_ternarylogic_epi64(value, value, value, 0x55);
+        temp_sum = _mm512_ternarylogic_epi64(temp_sum, value, value, 0xF3);
       }
-      result.sum_mask = extract_mask(result_mask);
+      result.sum_mask = extract_mask(temp_sum);
       return result;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCTLBitMask<MAX> PPCTLBitMask<MAX>::operator|(
-                                                 const PPCTLBitMask &rhs) const
+    inline AVX512TLBitMask<MAX> AVX512TLBitMask<MAX>::operator|(
+                                              const AVX512TLBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
-      PPCTLBitMask<MAX> result;
+      AVX512TLBitMask<MAX> result;
       result.sum_mask = sum_mask | rhs.sum_mask;
-      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        __vector unsigned long long rhs1 = bits.ppc_view(idx);
-        __vector unsigned long long rhs2 = rhs(idx);
-        result(idx) = vec_or(rhs1, rhs2);
+        result(idx) = _mm512_or_si512(bits.avx512_view(idx), rhs(idx));
       }
       return result;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCTLBitMask<MAX> PPCTLBitMask<MAX>::operator&(
-                                                 const PPCTLBitMask &rhs) const
+    inline AVX512TLBitMask<MAX> AVX512TLBitMask<MAX>::operator&(
+                                              const AVX512TLBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
-      PPCTLBitMask<MAX> result;
+      AVX512TLBitMask<MAX> result;
       // If they are independent then we are done
       if (sum_mask & rhs.sum_mask)
       {
-        __vector unsigned long long temp_sum = vec_splats(0ULL);
-        for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+        __m512i temp_sum = _mm512_setzero_si512();
+        for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
         {
-          __vector unsigned long long rhs1 = bits.ppc_view(idx);
-          __vector unsigned long long rhs2 = rhs(idx);
-          __vector unsigned long long lhs = vec_and(rhs1, rhs2);
-          result(idx) = lhs;
-          temp_sum = vec_or(temp_sum, lhs);
+          const __m512i left = bits.avx512_view(idx);
+          const __m512i right = rhs(idx);
+          result(idx) = _mm512_and_si512(left, right);
+          temp_sum = _mm512_ternarylogic_epi64(temp_sum, left, right, 0xF8);
         }
-        result.sum_mask = extract_mask(temp_sum); 
+        result.sum_mask = extract_mask(temp_sum);
       }
       return result;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCTLBitMask<MAX> PPCTLBitMask<MAX>::operator^(
-                                                 const PPCTLBitMask &rhs) const
+    inline AVX512TLBitMask<MAX> AVX512TLBitMask<MAX>::operator^(
+                                              const AVX512TLBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
-      PPCTLBitMask<MAX> result;
-      __vector unsigned long long temp_sum = vec_splats(0ULL);
-      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+      AVX512TLBitMask<MAX> result;
+      __m512i temp_sum = _mm512_setzero_si512();
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        __vector unsigned long long rhs1 = bits.ppc_view(idx);
-        __vector unsigned long long rhs2 = rhs(idx);
-        __vector unsigned long long lhs = vec_xor(rhs1, rhs2);
-        result(idx) = lhs;
-        temp_sum = vec_or(temp_sum, lhs);
+        const __m512i left = bits.avx512_view(idx);
+        const __m512i right = rhs(idx);
+        result(idx) = _mm512_xor_si512(left, right);
+        temp_sum = _mm512_ternarylogic_epi64(temp_sum, left, right, 0xF6);
       }
       result.sum_mask = extract_mask(temp_sum);
       return result;
@@ -7182,63 +8018,59 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCTLBitMask<MAX>& PPCTLBitMask<MAX>::operator|=(
-                                                       const PPCTLBitMask &rhs)
+    inline AVX512TLBitMask<MAX>& AVX512TLBitMask<MAX>::operator|=(
+                                                    const AVX512TLBitMask &rhs)
     //-------------------------------------------------------------------------
     {
       sum_mask |= rhs.sum_mask;
-      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        __vector unsigned long long rhs1 = bits.ppc_view(idx);
-        __vector unsigned long long rhs2 = rhs(idx);
-        bits.ppc_view(idx) = vec_or(rhs1, rhs2);
+        bits.avx512_view(idx) =
+          _mm512_or_si512(bits.avx512_view(idx), rhs(idx));
       }
       return *this;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCTLBitMask<MAX>& PPCTLBitMask<MAX>::operator&=(
-                                                       const PPCTLBitMask &rhs)
+    inline AVX512TLBitMask<MAX>& AVX512TLBitMask<MAX>::operator&=(
+                                                    const AVX512TLBitMask &rhs)
     //-------------------------------------------------------------------------
     {
       if (sum_mask & rhs.sum_mask)
       {
-        __vector unsigned long long temp_sum = vec_splats(0ULL);
-        for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+        __m512i temp_sum = _mm512_setzero_si512();
+        for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
         {
-          __vector unsigned long long rhs1 = bits.ppc_view(idx);
-          __vector unsigned long long rhs2 = rhs(idx);
-          __vector unsigned long long lhs = vec_and(rhs1, rhs2);
-          bits.ppc_view(idx) = lhs;
-          temp_sum = vec_or(temp_sum, lhs);
+          const __m512i left = bits.avx512_view(idx);
+          const __m512i right = rhs(idx);
+          bits.avx512_view(idx) = _mm512_and_si512(left, right);
+          temp_sum = _mm512_ternarylogic_epi64(temp_sum, left, right, 0xF8);
         }
-        sum_mask = extract_mask(temp_sum); 
+        sum_mask = extract_mask(temp_sum);
       }
       else
       {
         sum_mask = 0;
-	const __vector unsigned long long zero_vec = vec_splats(0ULL);
-        for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
-          bits.ppc_view(idx) = zero_vec;
+        for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
+          bits.avx512_view(idx) = _mm512_setzero_si512();
       }
       return *this;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCTLBitMask<MAX>& PPCTLBitMask<MAX>::operator^=(
-                                                       const PPCTLBitMask &rhs)
+    inline AVX512TLBitMask<MAX>& AVX512TLBitMask<MAX>::operator^=(
+                                                    const AVX512TLBitMask &rhs)
     //-------------------------------------------------------------------------
     {
-      __vector unsigned long long temp_sum = vec_splats(0ULL);
-      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+      __m512i temp_sum = _mm512_setzero_si512();
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        __vector unsigned long long rhs1 = bits.ppc_view(idx);
-        __vector unsigned long long rhs2 = rhs(idx);
-        __vector unsigned long long lhs = vec_xor(rhs1, rhs2);
-        bits.ppc_view(idx) = lhs;
-        temp_sum = vec_or(temp_sum, lhs);
+        const __m512i left = bits.avx512_view(idx);
+        const __m512i right = rhs(idx);
+        bits.avx512_view(idx) = _mm512_xor_si512(left, right);
+        temp_sum = _mm512_ternarylogic_epi64(temp_sum, left, right, 0xF6);
       }
       sum_mask = extract_mask(temp_sum);
       return *this;
@@ -7246,14 +8078,15 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool PPCTLBitMask<MAX>::operator*(const PPCTLBitMask &rhs) const
+    inline bool AVX512TLBitMask<MAX>::operator*(
+                                              const AVX512TLBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
       if (sum_mask & rhs.sum_mask)
       {
-        for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+        for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
         {
-          if (bits.bit_vector[idx] & rhs[idx])
+          if (_mm512_test_epi64_mask(bits.avx512_view(idx), rhs(idx)))
             return false;
         }
       }
@@ -7262,19 +8095,18 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCTLBitMask<MAX> PPCTLBitMask<MAX>::operator-(
-                                                 const PPCTLBitMask &rhs) const
+    inline AVX512TLBitMask<MAX> AVX512TLBitMask<MAX>::operator-(
+                                              const AVX512TLBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
-      PPCTLBitMask<MAX> result;
-      __vector unsigned long long temp_sum = vec_splats(0ULL);
-      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+      AVX512TLBitMask<MAX> result;
+      __m512i temp_sum = _mm512_setzero_si512();
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        __vector unsigned long long rhs1 = bits.ppc_view(idx);
-        __vector unsigned long long rhs2 = rhs(idx);
-        __vector unsigned long long lhs = vec_and(rhs1, ~rhs2);
-        result(idx) = lhs;
-        temp_sum = vec_or(temp_sum, lhs);
+        const __m512i left = bits.avx512_view(idx);
+        const __m512i right = rhs(idx);
+        result(idx) = _mm512_ternarylogic_epi64(left, right, right, 0x30);
+        temp_sum = _mm512_ternarylogic_epi64(temp_sum, left, right, 0xF4);
       }
       result.sum_mask = extract_mask(temp_sum);
       return result;
@@ -7282,18 +8114,18 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCTLBitMask<MAX>& PPCTLBitMask<MAX>::operator-=(
-                                                       const PPCTLBitMask &rhs)
+    inline AVX512TLBitMask<MAX>& AVX512TLBitMask<MAX>::operator-=(
+                                                    const AVX512TLBitMask &rhs)
     //-------------------------------------------------------------------------
     {
-      __vector unsigned long long temp_sum = vec_splats(0ULL);
-      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+      __m512i temp_sum = _mm512_setzero_si512();
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
       {
-        __vector unsigned long long rhs1 = bits.ppc_view(idx);
-        __vector unsigned long long rhs2 = rhs(idx);
-        __vector unsigned long long lhs = vec_and(rhs1, ~rhs2);
-        bits.ppc_view(idx) = lhs;
-        temp_sum = vec_or(temp_sum, lhs);
+        const __m512i left = bits.avx512_view(idx);
+        const __m512i right = rhs(idx);
+        bits.avx512_view(idx) =
+          _mm512_ternarylogic_epi64(left, right, right, 0x30);
+        temp_sum = _mm512_ternarylogic_epi64(temp_sum, left, right, 0xF4);
       }
       sum_mask = extract_mask(temp_sum);
       return *this;
@@ -7301,7 +8133,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool PPCTLBitMask<MAX>::empty(void) const
+    inline bool AVX512TLBitMask<MAX>::empty(void) const
     //-------------------------------------------------------------------------
     {
       // A great reason to have a summary mask
@@ -7310,7 +8142,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool PPCTLBitMask<MAX>::operator!(void) const
+    inline bool AVX512TLBitMask<MAX>::operator!(void) const
     //-------------------------------------------------------------------------
     {
       return empty();
@@ -7318,14 +8150,14 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCTLBitMask<MAX> PPCTLBitMask<MAX>::operator<<(
+    inline AVX512TLBitMask<MAX> AVX512TLBitMask<MAX>::operator<<(
                                                           unsigned shift) const
     //-------------------------------------------------------------------------
     {
       // Find the range
       unsigned range = shift >> 6;
       unsigned local = shift & 0x3F;
-      PPCTLBitMask<MAX> result;
+      AVX512TLBitMask<MAX> result;
       if (!local)
       {
         // Fast case where we just have to move the individual words
@@ -7360,13 +8192,13 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCTLBitMask<MAX> PPCTLBitMask<MAX>::operator>>(
+    inline AVX512TLBitMask<MAX> AVX512TLBitMask<MAX>::operator>>(
                                                           unsigned shift) const
     //-------------------------------------------------------------------------
     {
       unsigned range = shift >> 6;
       unsigned local = shift & 0x3F;
-      PPCTLBitMask<MAX> result;
+      AVX512TLBitMask<MAX> result;
       if (!local)
       {
         // Fast case where we just have to move individual words
@@ -7401,7 +8233,8 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCTLBitMask<MAX>& PPCTLBitMask<MAX>::operator<<=(unsigned shift)
+    inline AVX512TLBitMask<MAX>& AVX512TLBitMask<MAX>::operator<<=(
+                                                                unsigned shift)
     //-------------------------------------------------------------------------
     {
       // Find the range
@@ -7442,7 +8275,8 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline PPCTLBitMask<MAX>& PPCTLBitMask<MAX>::operator>>=(unsigned shift)
+    inline AVX512TLBitMask<MAX>& AVX512TLBitMask<MAX>::operator>>=(
+                                                                unsigned shift)
     //-------------------------------------------------------------------------
     {
       unsigned range = shift >> 6;
@@ -7483,7 +8317,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline uint64_t PPCTLBitMask<MAX>::get_hash_key(void) const
+    inline uint64_t AVX512TLBitMask<MAX>::get_hash_key(void) const
     //-------------------------------------------------------------------------
     {
       return sum_mask;
@@ -7491,7 +8325,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline const uint64_t* PPCTLBitMask<MAX>::base(void) const
+    inline const uint64_t* AVX512TLBitMask<MAX>::base(void) const
     //-------------------------------------------------------------------------
     {
       return bits.bit_vector;
@@ -7499,7 +8333,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX> template<typename ST>
-    inline void PPCTLBitMask<MAX>::serialize(ST &rez) const
+    inline void AVX512TLBitMask<MAX>::serialize(ST &rez) const
     //-------------------------------------------------------------------------
     {
       rez.serialize(sum_mask);
@@ -7508,7 +8342,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX> template<typename DT>
-    inline void PPCTLBitMask<MAX>::deserialize(DT &derez)
+    inline void AVX512TLBitMask<MAX>::deserialize(DT &derez)
     //-------------------------------------------------------------------------
     {
       derez.deserialize(sum_mask);
@@ -7517,7 +8351,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX> template<typename FUNCTOR>
-    inline void PPCTLBitMask<MAX>::map(FUNCTOR &functor) const
+    inline void AVX512TLBitMask<MAX>::map(FUNCTOR &functor) const
     //-------------------------------------------------------------------------
     {
       for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
@@ -7534,7 +8368,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline char* PPCTLBitMask<MAX>::to_string(void) const
+    inline char* AVX512TLBitMask<MAX>::to_string(void) const
     //-------------------------------------------------------------------------
     {
       return BitMaskHelp::to_string(bits.bit_vector, MAX);
@@ -7542,17 +8376,29 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline unsigned PPCTLBitMask<MAX>::pop_count(void) const
+    inline unsigned AVX512TLBitMask<MAX>::pop_count(void) const
     //-------------------------------------------------------------------------
     {
       if (!sum_mask)
         return 0;
       unsigned result = 0;
 #ifndef VALGRIND
+#ifdef __AVX512VPOPCNTDQ__
+      // VPOPCNTQ counts all eight words at once so we only do one
+      // horizontal reduction at the end
+      __m512i counts = _mm512_setzero_si512();
+      for (unsigned idx = 0; idx < AVX512_ELMTS; idx++)
+      {
+        counts = _mm512_add_epi64(counts,
+                    _mm512_popcnt_epi64(bits.avx512_view(idx)));
+      }
+      result = BitMaskHelp::avx512_reduce_add(counts);
+#else
       for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
       {
         result += __builtin_popcountll(bits.bit_vector[idx]);
       }
+#endif
 #else
       for (unsigned idx = 0; idx < MAX; idx++)
       {
@@ -7565,42 +8411,26 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    /*static*/ inline unsigned PPCTLBitMask<MAX>::pop_count(
-                                                 const PPCTLBitMask<MAX> &mask)
+    /*static*/ inline unsigned AVX512TLBitMask<MAX>::pop_count(
+                                              const AVX512TLBitMask<MAX> &mask)
     //-------------------------------------------------------------------------
     {
-      unsigned result = 0;
-#ifndef VALGRIND
-      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
-      {
-        result += __builtin_popcountll(mask[idx]);
-      }
-#else
-      for (unsigned idx = 0; idx < MAX; idx++)
-      {
-        if (mask.is_set(idx))
-          result++;
-      }
-#endif
-      return result;
+      return mask.pop_count();
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    /*static*/ inline uint64_t PPCTLBitMask<MAX>::extract_mask(
-                                             __vector unsigned long long value)
+    /*static*/ inline uint64_t AVX512TLBitMask<MAX>::extract_mask(__m512i value)
     //-------------------------------------------------------------------------
     {
-      uint64_t left = value[0];
-      uint64_t right = value[1];
-      return (left | right);
+      return BitMaskHelp::avx512_reduce_or(value);
     }
-#endif // __ALTIVEC__
+#endif // __AVX512F__
 
-#ifdef __ARM_NEON
+#ifdef __ALTIVEC__
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    NeonBitMask<MAX>::NeonBitMask(uint64_t init /*= 0*/)
+    PPCBitMask<MAX>::PPCBitMask(uint64_t init /*= 0*/)
     //-------------------------------------------------------------------------
     {
       static_assert((MAX % 128) == 0);
@@ -7612,26 +8442,26 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    NeonBitMask<MAX>::NeonBitMask(const NeonBitMask &rhs)
+    PPCBitMask<MAX>::PPCBitMask(const PPCBitMask &rhs)
     //-------------------------------------------------------------------------
     {
       static_assert((MAX % 128) == 0);
-      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
       {
-        bits.neon_view(idx) = rhs(idx);
+        bits.ppc_view(idx) = rhs(idx);
       }
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    NeonBitMask<MAX>::~NeonBitMask(void)
+    PPCBitMask<MAX>::~PPCBitMask(void)
     //-------------------------------------------------------------------------
     {
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline void NeonBitMask<MAX>::set_bit(unsigned bit)
+    inline void PPCBitMask<MAX>::set_bit(unsigned bit)
     //-------------------------------------------------------------------------
     {
 #ifdef DEBUG_LEGION
@@ -7643,7 +8473,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline void NeonBitMask<MAX>::unset_bit(unsigned bit)
+    inline void PPCBitMask<MAX>::unset_bit(unsigned bit)
     //-------------------------------------------------------------------------
     {
 #ifdef DEBUG_LEGION
@@ -7655,7 +8485,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline void NeonBitMask<MAX>::assign_bit(unsigned bit, bool val)
+    inline void PPCBitMask<MAX>::assign_bit(unsigned bit, bool val)
     //-------------------------------------------------------------------------
     {
       if (val)
@@ -7666,7 +8496,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool NeonBitMask<MAX>::is_set(unsigned bit) const
+    inline bool PPCBitMask<MAX>::is_set(unsigned bit) const
     //-------------------------------------------------------------------------
     {
 #ifdef DEBUG_LEGION
@@ -7678,7 +8508,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline int NeonBitMask<MAX>::find_first_set(void) const
+    inline int PPCBitMask<MAX>::find_first_set(void) const
     //-------------------------------------------------------------------------
     {
       for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
@@ -7699,7 +8529,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline int NeonBitMask<MAX>::find_index(unsigned bit) const
+    inline int PPCBitMask<MAX>::find_index(unsigned bit) const
     //-------------------------------------------------------------------------
     {
       unsigned element = bit >> bits.SHIFT; 
@@ -7724,7 +8554,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline int NeonBitMask<MAX>::get_index(unsigned index) const
+    inline int PPCBitMask<MAX>::get_index(unsigned index) const
     //-------------------------------------------------------------------------
     {
       int offset = 0;
@@ -7751,7 +8581,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline int NeonBitMask<MAX>::find_next_set(unsigned start) const
+    inline int PPCBitMask<MAX>::find_next_set(unsigned start) const
     //-------------------------------------------------------------------------
     {
       int idx = start / ELEMENT_SIZE; // truncate
@@ -7784,37 +8614,37 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline void NeonBitMask<MAX>::clear(void)
+    inline void PPCBitMask<MAX>::clear(void)
     //-------------------------------------------------------------------------
     {
-      const uint32x4_t zero_vec = vdupq_n_u32(0);
-      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      const __vector unsigned long long zero_vec = vec_splats(0ULL);
+      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
       {
-        bits.neon_view(idx) = zero_vec;
+        bits.ppc_view(idx) = zero_vec;
       }
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline BitMaskHelp::NeonView<true>
-                    NeonBitMask<MAX>::operator()(const unsigned int &idx) const
+    inline BitMaskHelp::PPCView<true>
+                     PPCBitMask<MAX>::operator()(const unsigned int &idx) const
     //-------------------------------------------------------------------------
     {
-      return bits.neon_view(idx);
+      return bits.ppc_view(idx);
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline BitMaskHelp::NeonView<false>
-                          NeonBitMask<MAX>::operator()(const unsigned int &idx)
+    inline BitMaskHelp::PPCView<false>
+                           PPCBitMask<MAX>::operator()(const unsigned int &idx)
     //-------------------------------------------------------------------------
     {
-      return bits.neon_view(idx);
+      return bits.ppc_view(idx);
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline const uint64_t& NeonBitMask<MAX>::operator[](
+    inline const uint64_t& PPCBitMask<MAX>::operator[](
                                                  const unsigned int &idx) const
     //-------------------------------------------------------------------------
     {
@@ -7823,7 +8653,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline uint64_t& NeonBitMask<MAX>::operator[](const unsigned int &idx) 
+    inline uint64_t& PPCBitMask<MAX>::operator[](const unsigned int &idx) 
     //-------------------------------------------------------------------------
     {
       return bits.bit_vector[idx]; 
@@ -7831,7 +8661,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool NeonBitMask<MAX>::operator==(const NeonBitMask &rhs) const
+    inline bool PPCBitMask<MAX>::operator==(const PPCBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
       for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
@@ -7844,13 +8674,13 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool NeonBitMask<MAX>::operator<(const NeonBitMask &rhs) const
+    inline bool PPCBitMask<MAX>::operator<(const PPCBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
       // Only be less than if the bits are a subset of the rhs bits
       for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
       {
-        if (bits.neon_view(idx) < rhs[idx])
+        if (bits.ppc_view(idx) < rhs[idx])
           return true;
         else if (bits.bits_vector[idx] > rhs[idx])
           return false;
@@ -7861,7 +8691,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool NeonBitMask<MAX>::operator!=(const NeonBitMask &rhs) const
+    inline bool PPCBitMask<MAX>::operator!=(const PPCBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
       return !(*this == rhs);
@@ -7869,127 +8699,123 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonBitMask<MAX>& NeonBitMask<MAX>::operator=(
-                                                        const NeonBitMask &rhs)
+    inline PPCBitMask<MAX>& PPCBitMask<MAX>::operator=(const PPCBitMask &rhs)
     //-------------------------------------------------------------------------
     {
-      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
       {
-        bits.neon_view(idx) = rhs(idx);
+        bits.ppc_view(idx) = rhs(idx);
       }
       return *this;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonBitMask<MAX> NeonBitMask<MAX>::operator~(void) const
+    inline PPCBitMask<MAX> PPCBitMask<MAX>::operator~(void) const
     //-------------------------------------------------------------------------
     {
-      NeonBitMask<MAX> result;
-      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      PPCBitMask<MAX> result;
+      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
       {
-        uint32x4_t rhs = bits.neon_view(idx);
-        result(idx) = vmvnq_u32(rhs);
+        __vector unsigned long long rhs = bits.ppc_view(idx);
+        result(idx) = ~rhs;
       }
       return result;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonBitMask<MAX> NeonBitMask<MAX>::operator|(
-                                                  const NeonBitMask &rhs) const
+    inline PPCBitMask<MAX> PPCBitMask<MAX>::operator|(
+                                                   const PPCBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
-      NeonBitMask<MAX> result;
-      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      PPCBitMask<MAX> result;
+      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
       {
-        uint32x4_t rhs1 = bits.neon_view(idx);
-        uint32x4_t rhs2 = rhs(idx);
-        result(idx) = vorrq_u32(rhs1, rhs2);
+        __vector unsigned long long rhs1 = bits.ppc_view(idx);
+        __vector unsigned long long rhs2 = rhs(idx);
+        result(idx) = vec_or(rhs1, rhs2);
       }
       return result;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonBitMask<MAX> NeonBitMask<MAX>::operator&(
-                                                  const NeonBitMask &rhs) const
+    inline PPCBitMask<MAX> PPCBitMask<MAX>::operator&(
+                                                   const PPCBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
-      NeonBitMask<MAX> result;
-      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      PPCBitMask<MAX> result;
+      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
       {
-        uint32x4_t rhs1 = bits.neon_view(idx);
-        uint32x4_t rhs2 = rhs(idx);
-        result(idx) = vandq_u32(rhs1, rhs2);
+        __vector unsigned long long rhs1 = bits.ppc_view(idx);
+        __vector unsigned long long rhs2 = rhs(idx);
+        result(idx) = vec_and(rhs1, rhs2);
       }
       return result;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonBitMask<MAX> NeonBitMask<MAX>::operator^(
-                                                  const NeonBitMask &rhs) const
+    inline PPCBitMask<MAX> PPCBitMask<MAX>::operator^(
+                                                   const PPCBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
-      NeonBitMask<MAX> result;
-      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      PPCBitMask<MAX> result;
+      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
       {
-        uint32x4_t rhs1 = bits.neon_view(idx);
-        uint32x4_t rhs2 = rhs(idx);
-        result(idx) = veorq_u32(rhs1, rhs2);
+        __vector unsigned long long rhs1 = bits.ppc_view(idx);
+        __vector unsigned long long rhs2 = rhs(idx);
+        result(idx) = vec_xor(rhs1, rhs2);
       }
       return result;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonBitMask<MAX>& NeonBitMask<MAX>::operator|=(
-                                                        const NeonBitMask &rhs) 
+    inline PPCBitMask<MAX>& PPCBitMask<MAX>::operator|=(const PPCBitMask &rhs) 
     //-------------------------------------------------------------------------
     {
-      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
       {
-        uint32x4_t rhs1 = bits.neon_view(idx);
-        uint32x4_t rhs2 = rhs(idx);
-        bits.neon_view(idx) = vorrq_u32(rhs1, rhs2);
+        __vector unsigned long long rhs1 = bits.ppc_view(idx);
+        __vector unsigned long long rhs2 = rhs(idx);
+        bits.ppc_view(idx) = vec_or(rhs1, rhs2);
       }
       return *this;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonBitMask<MAX>& NeonBitMask<MAX>::operator&=(
-                                                        const NeonBitMask &rhs)
+    inline PPCBitMask<MAX>& PPCBitMask<MAX>::operator&=(const PPCBitMask &rhs)
     //-------------------------------------------------------------------------
     {
-      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
       {
-        uint32x4_t rhs1 = bits.neon_view(idx);
-        uint32x4_t rhs2 = rhs(idx);
-        bits.neon_view(idx) = vandq_u32(rhs1, rhs2);
+        __vector unsigned long long rhs1 = bits.ppc_view(idx);
+        __vector unsigned long long rhs2 = rhs(idx);
+        bits.ppc_view(idx) = vec_and(rhs1, rhs2);
       }
       return *this;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonBitMask<MAX>& NeonBitMask<MAX>::operator^=(
-                                                        const NeonBitMask &rhs)
+    inline PPCBitMask<MAX>& PPCBitMask<MAX>::operator^=(const PPCBitMask &rhs)
     //-------------------------------------------------------------------------
     {
-      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
       {
-        uint32x4_t rhs1 = bits.neon_view(idx);
-        uint32x4_t rhs2 = rhs(idx);
-        bits.neon_view(idx) = veorq_u32(rhs1, rhs2);
+        __vector unsigned long long rhs1 = bits.ppc_view(idx);
+        __vector unsigned long long rhs2 = rhs(idx);
+        bits.ppc_view(idx) = vec_xor(rhs1, rhs2);
       }
       return *this;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool NeonBitMask<MAX>::operator*(const NeonBitMask &rhs) const
+    inline bool PPCBitMask<MAX>::operator*(const PPCBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
       for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
@@ -8002,38 +8828,37 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonBitMask<MAX> NeonBitMask<MAX>::operator-(
-                                                  const NeonBitMask &rhs) const
+    inline PPCBitMask<MAX> PPCBitMask<MAX>::operator-(
+                                                   const PPCBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
-      NeonBitMask<MAX> result;
-      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      PPCBitMask<MAX> result;
+      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
       {
-        uint32x4_t rhs1 = bits.neon_view(idx);
-        uint32x4_t rhs2 = rhs(idx);
-        result(idx) = vandq_u32(rhs1, vmvnq_u32(rhs2));
+        __vector unsigned long long rhs1 = bits.ppc_view(idx);
+        __vector unsigned long long rhs2 = rhs(idx);
+        result(idx) = vec_and(rhs1, ~rhs2);
       }
       return result;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonBitMask<MAX>& NeonBitMask<MAX>::operator-=(
-                                                        const NeonBitMask &rhs)
+    inline PPCBitMask<MAX>& PPCBitMask<MAX>::operator-=(const PPCBitMask &rhs)
     //-------------------------------------------------------------------------
     {
-      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
       {
-        uint32x4_t rhs1 = bits.neon_view(idx);
-        uint32x4_t rhs2 = rhs(idx);
-        bits.neon_view(idx) = vandq_u32(rhs1, ~rhs2);
+        __vector unsigned long long rhs1 = bits.ppc_view(idx);
+        __vector unsigned long long rhs2 = rhs(idx);
+        bits.ppc_view(idx) = vec_and(rhs1, ~rhs2);
       }
       return *this;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool NeonBitMask<MAX>::empty(void) const
+    inline bool PPCBitMask<MAX>::empty(void) const
     //-------------------------------------------------------------------------
     {
       for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
@@ -8046,7 +8871,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool NeonBitMask<MAX>::operator!(void) const
+    inline bool PPCBitMask<MAX>::operator!(void) const
     //-------------------------------------------------------------------------
     {
       return empty();
@@ -8054,13 +8879,13 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonBitMask<MAX> NeonBitMask<MAX>::operator<<(unsigned shift) const
+    inline PPCBitMask<MAX> PPCBitMask<MAX>::operator<<(unsigned shift) const
     //-------------------------------------------------------------------------
     {
       // Find the range
       unsigned range = shift >> 6;
       unsigned local = shift & 0x3F;
-      NeonBitMask<MAX> result;
+      PPCBitMask<MAX> result;
       if (!local)
       {
         // Fast case where we just have to move the individual words
@@ -8092,12 +8917,12 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonBitMask<MAX> NeonBitMask<MAX>::operator>>(unsigned shift) const
+    inline PPCBitMask<MAX> PPCBitMask<MAX>::operator>>(unsigned shift) const
     //-------------------------------------------------------------------------
     {
       unsigned range = shift >> 6;
       unsigned local = shift & 0x3F;
-      NeonBitMask<MAX> result;
+      PPCBitMask<MAX> result;
       if (!local)
       {
         // Fast case where we just have to move individual words
@@ -8129,7 +8954,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonBitMask<MAX>& NeonBitMask<MAX>::operator<<=(unsigned shift)
+    inline PPCBitMask<MAX>& PPCBitMask<MAX>::operator<<=(unsigned shift)
     //-------------------------------------------------------------------------
     {
       // Find the range
@@ -8166,7 +8991,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonBitMask<MAX>& NeonBitMask<MAX>::operator>>=(unsigned shift)
+    inline PPCBitMask<MAX>& PPCBitMask<MAX>::operator>>=(unsigned shift)
     //-------------------------------------------------------------------------
     {
       unsigned range = shift >> 6;
@@ -8203,7 +9028,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline uint64_t NeonBitMask<MAX>::get_hash_key(void) const
+    inline uint64_t PPCBitMask<MAX>::get_hash_key(void) const
     //-------------------------------------------------------------------------
     {
       uint64_t result = 0;
@@ -8216,7 +9041,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline const uint64_t* NeonBitMask<MAX>::base(void) const
+    inline const uint64_t* PPCBitMask<MAX>::base(void) const
     //-------------------------------------------------------------------------
     {
       return bits.bit_vector;
@@ -8224,7 +9049,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX> template<typename ST>
-    inline void NeonBitMask<MAX>::serialize(ST &rez) const
+    inline void PPCBitMask<MAX>::serialize(ST &rez) const
     //-------------------------------------------------------------------------
     {
       rez.serialize(bits.bit_vector, (MAX/8));
@@ -8232,7 +9057,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX> template<typename DT>
-    inline void NeonBitMask<MAX>::deserialize(DT &derez)
+    inline void PPCBitMask<MAX>::deserialize(DT &derez)
     //-------------------------------------------------------------------------
     {
       derez.deserialize(bits.bit_vector, (MAX/8));
@@ -8240,7 +9065,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX> template<typename FUNCTOR>
-    inline void NeonBitMask<MAX>::map(FUNCTOR &functor) const
+    inline void PPCBitMask<MAX>::map(FUNCTOR &functor) const
     //-------------------------------------------------------------------------
     {
       for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
@@ -8257,7 +9082,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline char* NeonBitMask<MAX>::to_string(void) const
+    inline char* PPCBitMask<MAX>::to_string(void) const
     //-------------------------------------------------------------------------
     {
       return BitMaskHelp::to_string(bits.bit_vector, MAX);
@@ -8265,7 +9090,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline unsigned NeonBitMask<MAX>::pop_count(void) const
+    inline unsigned PPCBitMask<MAX>::pop_count(void) const
     //-------------------------------------------------------------------------
     {
       unsigned result = 0;
@@ -8286,8 +9111,8 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    /*static*/ inline unsigned NeonBitMask<MAX>::pop_count(
-                                                  const NeonBitMask<MAX> &mask)
+    /*static*/ inline unsigned PPCBitMask<MAX>::pop_count(
+                                                   const PPCBitMask<MAX> &mask)
     //-------------------------------------------------------------------------
     {
       unsigned result = 0;
@@ -8308,7 +9133,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    NeonTLBitMask<MAX>::NeonTLBitMask(uint64_t init /*= 0*/)
+    PPCTLBitMask<MAX>::PPCTLBitMask(uint64_t init /*= 0*/)
       : sum_mask(init)
     //-------------------------------------------------------------------------
     {
@@ -8321,27 +9146,27 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    NeonTLBitMask<MAX>::NeonTLBitMask(const NeonTLBitMask &rhs)
+    PPCTLBitMask<MAX>::PPCTLBitMask(const PPCTLBitMask &rhs)
       : sum_mask(rhs.sum_mask)
     //-------------------------------------------------------------------------
     {
       static_assert((MAX % 128) == 0);
-      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
       {
-        bits.neon_view(idx) = rhs(idx);
+        bits.ppc_view(idx) = rhs(idx);
       }
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    NeonTLBitMask<MAX>::~NeonTLBitMask(void)
+    PPCTLBitMask<MAX>::~PPCTLBitMask(void)
     //-------------------------------------------------------------------------
     {
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline void NeonTLBitMask<MAX>::set_bit(unsigned bit)
+    inline void PPCTLBitMask<MAX>::set_bit(unsigned bit)
     //-------------------------------------------------------------------------
     {
 #ifdef DEBUG_LEGION
@@ -8355,7 +9180,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline void NeonTLBitMask<MAX>::unset_bit(unsigned bit)
+    inline void PPCTLBitMask<MAX>::unset_bit(unsigned bit)
     //-------------------------------------------------------------------------
     {
 #ifdef DEBUG_LEGION
@@ -8373,7 +9198,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline void NeonTLBitMask<MAX>::assign_bit(unsigned bit, bool val)
+    inline void PPCTLBitMask<MAX>::assign_bit(unsigned bit, bool val)
     //-------------------------------------------------------------------------
     {
       if (val)
@@ -8384,7 +9209,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool NeonTLBitMask<MAX>::is_set(unsigned bit) const
+    inline bool PPCTLBitMask<MAX>::is_set(unsigned bit) const
     //-------------------------------------------------------------------------
     {
 #ifdef DEBUG_LEGION
@@ -8396,7 +9221,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline int NeonTLBitMask<MAX>::find_first_set(void) const
+    inline int PPCTLBitMask<MAX>::find_first_set(void) const
     //-------------------------------------------------------------------------
     {
       for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
@@ -8417,7 +9242,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline int NeonTLBitMask<MAX>::find_index(unsigned bit) const
+    inline int PPCTLBitMask<MAX>::find_index(unsigned bit) const
     //-------------------------------------------------------------------------
     {
       unsigned element = bit >> bits.SHIFT; 
@@ -8442,7 +9267,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline int NeonTLBitMask<MAX>::get_index(unsigned index) const
+    inline int PPCTLBitMask<MAX>::get_index(unsigned index) const
     //-------------------------------------------------------------------------
     {
       int offset = 0;
@@ -8469,7 +9294,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline int NeonTLBitMask<MAX>::find_next_set(unsigned start) const
+    inline int PPCTLBitMask<MAX>::find_next_set(unsigned start) const
     //-------------------------------------------------------------------------
     {
       int idx = start / ELEMENT_SIZE; // truncate
@@ -8502,38 +9327,38 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline void NeonTLBitMask<MAX>::clear(void)
+    inline void PPCTLBitMask<MAX>::clear(void)
     //-------------------------------------------------------------------------
     {
-      const uint32x4_t zero_vec = vdupq_n_u32(0);
-      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      const __vector unsigned long long zero_vec = vec_splats(0ULL);
+      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
       {
-        bits.neon_view(idx) = zero_vec; 
+        bits.ppc_view(idx) = zero_vec; 
       }
       sum_mask = 0;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline BitMaskHelp::NeonView<true>
-                  NeonTLBitMask<MAX>::operator()(const unsigned int &idx) const
+    inline BitMaskHelp::PPCView<true>
+                   PPCTLBitMask<MAX>::operator()(const unsigned int &idx) const
     //-------------------------------------------------------------------------
     {
-      return bits.neon_view(idx);
+      return bits.ppc_view(idx);
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline BitMaskHelp::NeonView<false>
-                        NeonTLBitMask<MAX>::operator()(const unsigned int &idx)
+    inline BitMaskHelp::PPCView<false>
+                         PPCTLBitMask<MAX>::operator()(const unsigned int &idx)
     //-------------------------------------------------------------------------
     {
-      return bits.neon_view(idx);
+      return bits.ppc_view(idx);
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline const uint64_t& NeonTLBitMask<MAX>::operator[](
+    inline const uint64_t& PPCTLBitMask<MAX>::operator[](
                                                  const unsigned int &idx) const
     //-------------------------------------------------------------------------
     {
@@ -8542,7 +9367,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline uint64_t& NeonTLBitMask<MAX>::operator[](const unsigned int &idx) 
+    inline uint64_t& PPCTLBitMask<MAX>::operator[](const unsigned int &idx) 
     //-------------------------------------------------------------------------
     {
       return bits.bit_vector[idx]; 
@@ -8550,7 +9375,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool NeonTLBitMask<MAX>::operator==(const NeonTLBitMask &rhs) const
+    inline bool PPCTLBitMask<MAX>::operator==(const PPCTLBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
       if (sum_mask != rhs.sum_mask)
@@ -8565,7 +9390,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool NeonTLBitMask<MAX>::operator<(const NeonTLBitMask &rhs) const
+    inline bool PPCTLBitMask<MAX>::operator<(const PPCTLBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
       // Only be less than if the bits are a subset of the rhs bits
@@ -8582,7 +9407,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool NeonTLBitMask<MAX>::operator!=(const NeonTLBitMask &rhs) const
+    inline bool PPCTLBitMask<MAX>::operator!=(const PPCTLBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
       return !(*this == rhs);
@@ -8590,31 +9415,31 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonTLBitMask<MAX>& NeonTLBitMask<MAX>::operator=(
-                                                      const NeonTLBitMask &rhs)
+    inline PPCTLBitMask<MAX>& PPCTLBitMask<MAX>::operator=(
+                                                       const PPCTLBitMask &rhs)
     //-------------------------------------------------------------------------
     {
       sum_mask = rhs.sum_mask;
-      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
       {
-        bits.neon_view(idx) = rhs(idx);
+        bits.ppc_view(idx) = rhs(idx);
       }
       return *this;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonTLBitMask<MAX> NeonTLBitMask<MAX>::operator~(void) const
+    inline PPCTLBitMask<MAX> PPCTLBitMask<MAX>::operator~(void) const
     //-------------------------------------------------------------------------
     {
-      NeonTLBitMask<MAX> result;
-      uint32x4_t result_mask = vdupq_n_u32(0);
-      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      PPCTLBitMask<MAX> result;
+      __vector unsigned long long result_mask = vec_splats(0ULL);
+      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
       {
-        uint32x4_t rhs = bits.neon_view(idx);
-        uint32x4_t lhs = vmvnq_u32(rhs);
+        __vector unsigned long long rhs = bits.ppc_view(idx);
+        __vector unsigned long long lhs = ~rhs;
         result(idx) = lhs;
-        result_mask = vorrq_u32(result_mask, lhs);
+        result_mask = vec_or(result_mask, lhs);
       }
       result.sum_mask = extract_mask(result_mask);
       return result;
@@ -8622,39 +9447,39 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonTLBitMask<MAX> NeonTLBitMask<MAX>::operator|(
-                                                const NeonTLBitMask &rhs) const
+    inline PPCTLBitMask<MAX> PPCTLBitMask<MAX>::operator|(
+                                                 const PPCTLBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
-      NeonTLBitMask<MAX> result;
+      PPCTLBitMask<MAX> result;
       result.sum_mask = sum_mask | rhs.sum_mask;
-      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
       {
-        uint32x4_t rhs1 = bits.neon_view(idx);
-        uint32x4_t rhs2 = rhs(idx);
-        result(idx) = vorrq_u32(rhs1, rhs2);
+        __vector unsigned long long rhs1 = bits.ppc_view(idx);
+        __vector unsigned long long rhs2 = rhs(idx);
+        result(idx) = vec_or(rhs1, rhs2);
       }
       return result;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonTLBitMask<MAX> NeonTLBitMask<MAX>::operator&(
-                                                const NeonTLBitMask &rhs) const
+    inline PPCTLBitMask<MAX> PPCTLBitMask<MAX>::operator&(
+                                                 const PPCTLBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
-      NeonTLBitMask<MAX> result;
+      PPCTLBitMask<MAX> result;
       // If they are independent then we are done
       if (sum_mask & rhs.sum_mask)
       {
-        uint32x4_t temp_sum = vdupq_n_u32(0);
-        for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+        __vector unsigned long long temp_sum = vec_splats(0ULL);
+        for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
         {
-          uint32x4_t rhs1 = bits.neon_view(idx);
-          uint32x4_t rhs2 = rhs(idx);
-          uint32x4_t lhs = vandq_u32(rhs1, rhs2);
+          __vector unsigned long long rhs1 = bits.ppc_view(idx);
+          __vector unsigned long long rhs2 = rhs(idx);
+          __vector unsigned long long lhs = vec_and(rhs1, rhs2);
           result(idx) = lhs;
-          temp_sum = vorrq_u32(temp_sum, lhs);
+          temp_sum = vec_or(temp_sum, lhs);
         }
         result.sum_mask = extract_mask(temp_sum); 
       }
@@ -8663,19 +9488,19 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonTLBitMask<MAX> NeonTLBitMask<MAX>::operator^(
-                                                const NeonTLBitMask &rhs) const
+    inline PPCTLBitMask<MAX> PPCTLBitMask<MAX>::operator^(
+                                                 const PPCTLBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
-      NeonTLBitMask<MAX> result;
-      uint32x4_t temp_sum = vdupq_n_u32(0);
-      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      PPCTLBitMask<MAX> result;
+      __vector unsigned long long temp_sum = vec_splats(0ULL);
+      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
       {
-        uint32x4_t rhs1 = bits.neon_view(idx);
-        uint32x4_t rhs2 = rhs(idx);
-        uint32x4_t lhs = veorq_u32(rhs1, rhs2);
+        __vector unsigned long long rhs1 = bits.ppc_view(idx);
+        __vector unsigned long long rhs2 = rhs(idx);
+        __vector unsigned long long lhs = vec_xor(rhs1, rhs2);
         result(idx) = lhs;
-        temp_sum = vorrq_u32(temp_sum, lhs);
+        temp_sum = vec_or(temp_sum, lhs);
       }
       result.sum_mask = extract_mask(temp_sum);
       return result;
@@ -8683,63 +9508,63 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonTLBitMask<MAX>& NeonTLBitMask<MAX>::operator|=(
-                                                      const NeonTLBitMask &rhs)
+    inline PPCTLBitMask<MAX>& PPCTLBitMask<MAX>::operator|=(
+                                                       const PPCTLBitMask &rhs)
     //-------------------------------------------------------------------------
     {
       sum_mask |= rhs.sum_mask;
-      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
       {
-        uint32x4_t rhs1 = bits.neon_view(idx);
-        uint32x4_t rhs2 = rhs(idx);
-        bits.neon_view(idx) = vorrq_u32(rhs1, rhs2);
+        __vector unsigned long long rhs1 = bits.ppc_view(idx);
+        __vector unsigned long long rhs2 = rhs(idx);
+        bits.ppc_view(idx) = vec_or(rhs1, rhs2);
       }
       return *this;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonTLBitMask<MAX>& NeonTLBitMask<MAX>::operator&=(
-                                                      const NeonTLBitMask &rhs)
+    inline PPCTLBitMask<MAX>& PPCTLBitMask<MAX>::operator&=(
+                                                       const PPCTLBitMask &rhs)
     //-------------------------------------------------------------------------
     {
       if (sum_mask & rhs.sum_mask)
       {
-        uint32x4_t temp_sum = vdupq_n_u32(0);
-        for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+        __vector unsigned long long temp_sum = vec_splats(0ULL);
+        for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
         {
-          uint32x4_t rhs1 = bits.neon_view(idx);
-          uint32x4_t rhs2 = rhs(idx);
-          uint32x4_t lhs = vandq_u32(rhs1, rhs2);
-          bits.neon_view(idx) = lhs;
-          temp_sum = vorrq_u32(temp_sum, lhs);
+          __vector unsigned long long rhs1 = bits.ppc_view(idx);
+          __vector unsigned long long rhs2 = rhs(idx);
+          __vector unsigned long long lhs = vec_and(rhs1, rhs2);
+          bits.ppc_view(idx) = lhs;
+          temp_sum = vec_or(temp_sum, lhs);
         }
         sum_mask = extract_mask(temp_sum); 
       }
       else
       {
         sum_mask = 0;
-        const uint32x4_t zero_vec = vdupq_n_u32(0);
-        for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
-          bits.neon_view(idx) = zero_vec;
+	const __vector unsigned long long zero_vec = vec_splats(0ULL);
+        for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
+          bits.ppc_view(idx) = zero_vec;
       }
       return *this;
     }
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonTLBitMask<MAX>& NeonTLBitMask<MAX>::operator^=(
-                                                      const NeonTLBitMask &rhs)
+    inline PPCTLBitMask<MAX>& PPCTLBitMask<MAX>::operator^=(
+                                                       const PPCTLBitMask &rhs)
     //-------------------------------------------------------------------------
     {
-      uint32x4_t temp_sum = vdupq_n_u32(0);
-      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      __vector unsigned long long temp_sum = vec_splats(0ULL);
+      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
       {
-        uint32x4_t rhs1 = bits.neon_view(idx);
-        uint32x4_t rhs2 = rhs(idx);
-        uint32x4_t lhs = veorq_u32(rhs1, rhs2);
-        bits.neon_view(idx) = lhs;
-        temp_sum = vorrq_u32(temp_sum, lhs);
+        __vector unsigned long long rhs1 = bits.ppc_view(idx);
+        __vector unsigned long long rhs2 = rhs(idx);
+        __vector unsigned long long lhs = vec_xor(rhs1, rhs2);
+        bits.ppc_view(idx) = lhs;
+        temp_sum = vec_or(temp_sum, lhs);
       }
       sum_mask = extract_mask(temp_sum);
       return *this;
@@ -8747,7 +9572,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool NeonTLBitMask<MAX>::operator*(const NeonTLBitMask &rhs) const
+    inline bool PPCTLBitMask<MAX>::operator*(const PPCTLBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
       if (sum_mask & rhs.sum_mask)
@@ -8763,19 +9588,19 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonTLBitMask<MAX> NeonTLBitMask<MAX>::operator-(
-                                                const NeonTLBitMask &rhs) const
+    inline PPCTLBitMask<MAX> PPCTLBitMask<MAX>::operator-(
+                                                 const PPCTLBitMask &rhs) const
     //-------------------------------------------------------------------------
     {
-      NeonTLBitMask<MAX> result;
-      uint32x4_t temp_sum = vdupq_n_u32(0);
-      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      PPCTLBitMask<MAX> result;
+      __vector unsigned long long temp_sum = vec_splats(0ULL);
+      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
       {
-        uint32x4_t rhs1 = bits.neon_view(idx);
-        uint32x4_t rhs2 = rhs(idx);
-        uint32x4_t lhs = vandq_u32(rhs1, vmvnq_u32(rhs2));
+        __vector unsigned long long rhs1 = bits.ppc_view(idx);
+        __vector unsigned long long rhs2 = rhs(idx);
+        __vector unsigned long long lhs = vec_and(rhs1, ~rhs2);
         result(idx) = lhs;
-        temp_sum = vorrq_u32(temp_sum, lhs);
+        temp_sum = vec_or(temp_sum, lhs);
       }
       result.sum_mask = extract_mask(temp_sum);
       return result;
@@ -8783,18 +9608,18 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonTLBitMask<MAX>& NeonTLBitMask<MAX>::operator-=(
-                                                      const NeonTLBitMask &rhs)
+    inline PPCTLBitMask<MAX>& PPCTLBitMask<MAX>::operator-=(
+                                                       const PPCTLBitMask &rhs)
     //-------------------------------------------------------------------------
     {
-      uint32x4_t temp_sum = vdupq_n_u32(0);
-      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      __vector unsigned long long temp_sum = vec_splats(0ULL);
+      for (unsigned idx = 0; idx < PPC_ELMTS; idx++)
       {
-        uint32x4_t rhs1 = bits.neon_view(idx);
-        uint32x4_t rhs2 = rhs(idx);
-        uint32x4_t lhs = vandq_u32(rhs1, vmvnq_u32(rhs2));
-        bits.neon_view(idx) = lhs;
-        temp_sum = vorrq_u32(temp_sum, lhs);
+        __vector unsigned long long rhs1 = bits.ppc_view(idx);
+        __vector unsigned long long rhs2 = rhs(idx);
+        __vector unsigned long long lhs = vec_and(rhs1, ~rhs2);
+        bits.ppc_view(idx) = lhs;
+        temp_sum = vec_or(temp_sum, lhs);
       }
       sum_mask = extract_mask(temp_sum);
       return *this;
@@ -8802,7 +9627,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool NeonTLBitMask<MAX>::empty(void) const
+    inline bool PPCTLBitMask<MAX>::empty(void) const
     //-------------------------------------------------------------------------
     {
       // A great reason to have a summary mask
@@ -8811,7 +9636,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline bool NeonTLBitMask<MAX>::operator!(void) const
+    inline bool PPCTLBitMask<MAX>::operator!(void) const
     //-------------------------------------------------------------------------
     {
       return empty();
@@ -8819,14 +9644,14 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonTLBitMask<MAX> NeonTLBitMask<MAX>::operator<<(
+    inline PPCTLBitMask<MAX> PPCTLBitMask<MAX>::operator<<(
                                                           unsigned shift) const
     //-------------------------------------------------------------------------
     {
       // Find the range
       unsigned range = shift >> 6;
       unsigned local = shift & 0x3F;
-      NeonTLBitMask<MAX> result;
+      PPCTLBitMask<MAX> result;
       if (!local)
       {
         // Fast case where we just have to move the individual words
@@ -8861,13 +9686,13 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonTLBitMask<MAX> NeonTLBitMask<MAX>::operator>>(
+    inline PPCTLBitMask<MAX> PPCTLBitMask<MAX>::operator>>(
                                                           unsigned shift) const
     //-------------------------------------------------------------------------
     {
       unsigned range = shift >> 6;
       unsigned local = shift & 0x3F;
-      NeonTLBitMask<MAX> result;
+      PPCTLBitMask<MAX> result;
       if (!local)
       {
         // Fast case where we just have to move individual words
@@ -8902,7 +9727,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonTLBitMask<MAX>& NeonTLBitMask<MAX>::operator<<=(unsigned shift)
+    inline PPCTLBitMask<MAX>& PPCTLBitMask<MAX>::operator<<=(unsigned shift)
     //-------------------------------------------------------------------------
     {
       // Find the range
@@ -8943,7 +9768,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline NeonTLBitMask<MAX>& NeonTLBitMask<MAX>::operator>>=(unsigned shift)
+    inline PPCTLBitMask<MAX>& PPCTLBitMask<MAX>::operator>>=(unsigned shift)
     //-------------------------------------------------------------------------
     {
       unsigned range = shift >> 6;
@@ -8984,7 +9809,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline uint64_t NeonTLBitMask<MAX>::get_hash_key(void) const
+    inline uint64_t PPCTLBitMask<MAX>::get_hash_key(void) const
     //-------------------------------------------------------------------------
     {
       return sum_mask;
@@ -8992,7 +9817,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline const uint64_t* NeonTLBitMask<MAX>::base(void) const
+    inline const uint64_t* PPCTLBitMask<MAX>::base(void) const
     //-------------------------------------------------------------------------
     {
       return bits.bit_vector;
@@ -9000,7 +9825,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX> template<typename ST>
-    inline void NeonTLBitMask<MAX>::serialize(ST &rez) const
+    inline void PPCTLBitMask<MAX>::serialize(ST &rez) const
     //-------------------------------------------------------------------------
     {
       rez.serialize(sum_mask);
@@ -9009,7 +9834,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX> template<typename DT>
-    inline void NeonTLBitMask<MAX>::deserialize(DT &derez)
+    inline void PPCTLBitMask<MAX>::deserialize(DT &derez)
     //-------------------------------------------------------------------------
     {
       derez.deserialize(sum_mask);
@@ -9018,7 +9843,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX> template<typename FUNCTOR>
-    inline void NeonTLBitMask<MAX>::map(FUNCTOR &functor) const
+    inline void PPCTLBitMask<MAX>::map(FUNCTOR &functor) const
     //-------------------------------------------------------------------------
     {
       for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
@@ -9035,7 +9860,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline char* NeonTLBitMask<MAX>::to_string(void) const
+    inline char* PPCTLBitMask<MAX>::to_string(void) const
     //-------------------------------------------------------------------------
     {
       return BitMaskHelp::to_string(bits.bit_vector, MAX);
@@ -9043,7 +9868,7 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    inline unsigned NeonTLBitMask<MAX>::pop_count(void) const
+    inline unsigned PPCTLBitMask<MAX>::pop_count(void) const
     //-------------------------------------------------------------------------
     {
       if (!sum_mask)
@@ -9066,8 +9891,8 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    /*static*/ inline unsigned NeonTLBitMask<MAX>::pop_count(
-                                                const NeonTLBitMask<MAX> &mask)
+    /*static*/ inline unsigned PPCTLBitMask<MAX>::pop_count(
+                                                 const PPCTLBitMask<MAX> &mask)
     //-------------------------------------------------------------------------
     {
       unsigned result = 0;
@@ -9088,19 +9913,2203 @@
 
     //-------------------------------------------------------------------------
     template<unsigned int MAX>
-    /*static*/ inline uint64_t NeonTLBitMask<MAX>::extract_mask(
-                                                              uint32x4_t value)
+    /*static*/ inline uint64_t PPCTLBitMask<MAX>::extract_mask(
+                                             __vector unsigned long long value)
     //-------------------------------------------------------------------------
     {
-      uint64_t zero = vgetq_lane_u32(value, 0);
-      uint64_t one = vgetq_lane_u32(value, 1);
-      uint64_t two = vgetq_lane_u32(value, 2);
-      uint64_t three = vgetq_lane_u32(value, 3);
-      one <<= 32;
-      three <<= 32;
-      return (zero | one | two | three);
+      uint64_t left = value[0];
+      uint64_t right = value[1];
+      return (left | right);
+    }
+#endif // __ALTIVEC__
+
+#ifdef __ARM_NEON
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    NeonBitMask<MAX>::NeonBitMask(uint64_t init /*= 0*/)
+    //-------------------------------------------------------------------------
+    {
+      static_assert((MAX % 128) == 0);
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        bits.bit_vector[idx] = init;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    NeonBitMask<MAX>::NeonBitMask(const NeonBitMask &rhs)
+    //-------------------------------------------------------------------------
+    {
+      static_assert((MAX % 128) == 0);
+      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      {
+        bits.neon_view(idx) = rhs(idx);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    NeonBitMask<MAX>::~NeonBitMask(void)
+    //-------------------------------------------------------------------------
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline void NeonBitMask<MAX>::set_bit(unsigned bit)
+    //-------------------------------------------------------------------------
+    {
+#ifdef DEBUG_LEGION
+      assert(bit < MAX);
+#endif
+      unsigned idx = bit >> 6;
+      bits.bit_vector[idx] |= (1UL << (bit & 0x3F));
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline void NeonBitMask<MAX>::unset_bit(unsigned bit)
+    //-------------------------------------------------------------------------
+    {
+#ifdef DEBUG_LEGION
+      assert(bit < MAX);
+#endif
+      unsigned idx = bit >> 6;
+      bits.bit_vector[idx] &= ~(1UL << (bit & 0x3F));
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline void NeonBitMask<MAX>::assign_bit(unsigned bit, bool val)
+    //-------------------------------------------------------------------------
+    {
+      if (val)
+        set_bit(bit);
+      else
+        unset_bit(bit);
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline bool NeonBitMask<MAX>::is_set(unsigned bit) const
+    //-------------------------------------------------------------------------
+    {
+#ifdef DEBUG_LEGION
+      assert(bit < MAX);
+#endif
+      unsigned idx = bit >> 6;
+      return (bits.bit_vector[idx] & (1UL << (bit & 0x3F)));
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline int NeonBitMask<MAX>::find_first_set(void) const
+    //-------------------------------------------------------------------------
+    {
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        if (bits.bit_vector[idx])
+        {
+          for (unsigned j = 0; j < ELEMENT_SIZE; j++)
+          {
+            if (bits.bit_vector[idx] & (1UL << j))
+            {
+              return (idx*ELEMENT_SIZE + j);
+            }
+          }
+        }
+      }
+      return -1;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline int NeonBitMask<MAX>::find_index(unsigned bit) const
+    //-------------------------------------------------------------------------
+    {
+      unsigned element = bit >> bits.SHIFT; 
+      unsigned offset = bit & bits.MASK;
+      if (bits.bit_vector[element] & (1ULL << offset))
+      {
+        int index = 0;
+        for (unsigned idx = 0; idx < element; idx++)
+          index += __builtin_popcountll(bits.bit_vector[idx]);
+        // Handle dumb c++ shift overflow
+        if (offset == 0)
+          return index;
+        // Just count the bits up to but not including the actual
+        // bit we're looking for since indexes are zero-base
+        index += __builtin_popcountll(
+            bits.bit_vector[element] << (ELEMENT_SIZE - offset));
+        return index;
+      }
+      else // It's not set otherwise so we couldn't find an index
+        return -1;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline int NeonBitMask<MAX>::get_index(unsigned index) const
+    //-------------------------------------------------------------------------
+    {
+      int offset = 0;
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        unsigned local = __builtin_popcountll(bits.bit_vector[idx]);
+        if (index < local)
+        {
+          for (unsigned j = 0; j < ELEMENT_SIZE; j++)
+          {
+            if (bits.bit_vector[idx] & (1ULL << j))
+            {
+              if (index == 0)
+                return (offset + j);
+              index--;
+            }
+          }
+        }
+        index -= local;
+        offset += ELEMENT_SIZE;
+      }
+      return -1;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline int NeonBitMask<MAX>::find_next_set(unsigned start) const
+    //-------------------------------------------------------------------------
+    {
+      int idx = start / ELEMENT_SIZE; // truncate
+      int offset = idx * ELEMENT_SIZE; 
+      int j = start % ELEMENT_SIZE;
+      if (j > 0) // if we are already in the middle of element search it
+      {
+        for ( ; j < int(ELEMENT_SIZE); j++)
+        {
+          if (bits.bit_vector[idx] & (1ULL << j))
+            return (offset + j);
+        }
+        idx++;
+        offset += ELEMENT_SIZE;
+      }
+      for ( ; idx < int(BIT_ELMTS); idx++)
+      {
+        if (bits.bit_vector[idx] > 0) // if it has any valid entries, find next
+        {
+          for (j = 0; j < int(ELEMENT_SIZE); j++)
+          {
+            if (bits.bit_vector[idx] & (1ULL << j))
+              return (offset + j);
+          }
+        }
+        offset += ELEMENT_SIZE;
+      }
+      return -1;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline void NeonBitMask<MAX>::clear(void)
+    //-------------------------------------------------------------------------
+    {
+      const uint32x4_t zero_vec = vdupq_n_u32(0);
+      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      {
+        bits.neon_view(idx) = zero_vec;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline BitMaskHelp::NeonView<true>
+                    NeonBitMask<MAX>::operator()(const unsigned int &idx) const
+    //-------------------------------------------------------------------------
+    {
+      return bits.neon_view(idx);
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline BitMaskHelp::NeonView<false>
+                          NeonBitMask<MAX>::operator()(const unsigned int &idx)
+    //-------------------------------------------------------------------------
+    {
+      return bits.neon_view(idx);
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline const uint64_t& NeonBitMask<MAX>::operator[](
+                                                 const unsigned int &idx) const
+    //-------------------------------------------------------------------------
+    {
+      return bits.bit_vector[idx];
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline uint64_t& NeonBitMask<MAX>::operator[](const unsigned int &idx) 
+    //-------------------------------------------------------------------------
+    {
+      return bits.bit_vector[idx]; 
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline bool NeonBitMask<MAX>::operator==(const NeonBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+	if (bits.bit_vector[idx] != rhs[idx])
+          return false;
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline bool NeonBitMask<MAX>::operator<(const NeonBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      // Only be less than if the bits are a subset of the rhs bits
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        if (bits.neon_view(idx) < rhs[idx])
+          return true;
+        else if (bits.bits_vector[idx] > rhs[idx])
+          return false;
+      }
+      // Otherwise they are equal so false
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline bool NeonBitMask<MAX>::operator!=(const NeonBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      return !(*this == rhs);
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonBitMask<MAX>& NeonBitMask<MAX>::operator=(
+                                                        const NeonBitMask &rhs)
+    //-------------------------------------------------------------------------
+    {
+      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      {
+        bits.neon_view(idx) = rhs(idx);
+      }
+      return *this;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonBitMask<MAX> NeonBitMask<MAX>::operator~(void) const
+    //-------------------------------------------------------------------------
+    {
+      NeonBitMask<MAX> result;
+      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      {
+        uint32x4_t rhs = bits.neon_view(idx);
+        result(idx) = vmvnq_u32(rhs);
+      }
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonBitMask<MAX> NeonBitMask<MAX>::operator|(
+                                                  const NeonBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      NeonBitMask<MAX> result;
+      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      {
+        uint32x4_t rhs1 = bits.neon_view(idx);
+        uint32x4_t rhs2 = rhs(idx);
+        result(idx) = vorrq_u32(rhs1, rhs2);
+      }
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonBitMask<MAX> NeonBitMask<MAX>::operator&(
+                                                  const NeonBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      NeonBitMask<MAX> result;
+      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      {
+        uint32x4_t rhs1 = bits.neon_view(idx);
+        uint32x4_t rhs2 = rhs(idx);
+        result(idx) = vandq_u32(rhs1, rhs2);
+      }
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonBitMask<MAX> NeonBitMask<MAX>::operator^(
+                                                  const NeonBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      NeonBitMask<MAX> result;
+      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      {
+        uint32x4_t rhs1 = bits.neon_view(idx);
+        uint32x4_t rhs2 = rhs(idx);
+        result(idx) = veorq_u32(rhs1, rhs2);
+      }
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonBitMask<MAX>& NeonBitMask<MAX>::operator|=(
+                                                        const NeonBitMask &rhs) 
+    //-------------------------------------------------------------------------
+    {
+      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      {
+        uint32x4_t rhs1 = bits.neon_view(idx);
+        uint32x4_t rhs2 = rhs(idx);
+        bits.neon_view(idx) = vorrq_u32(rhs1, rhs2);
+      }
+      return *this;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonBitMask<MAX>& NeonBitMask<MAX>::operator&=(
+                                                        const NeonBitMask &rhs)
+    //-------------------------------------------------------------------------
+    {
+      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      {
+        uint32x4_t rhs1 = bits.neon_view(idx);
+        uint32x4_t rhs2 = rhs(idx);
+        bits.neon_view(idx) = vandq_u32(rhs1, rhs2);
+      }
+      return *this;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonBitMask<MAX>& NeonBitMask<MAX>::operator^=(
+                                                        const NeonBitMask &rhs)
+    //-------------------------------------------------------------------------
+    {
+      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      {
+        uint32x4_t rhs1 = bits.neon_view(idx);
+        uint32x4_t rhs2 = rhs(idx);
+        bits.neon_view(idx) = veorq_u32(rhs1, rhs2);
+      }
+      return *this;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline bool NeonBitMask<MAX>::operator*(const NeonBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        if (bits.bit_vector[idx] & rhs[idx])
+          return false;
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonBitMask<MAX> NeonBitMask<MAX>::operator-(
+                                                  const NeonBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      NeonBitMask<MAX> result;
+      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      {
+        uint32x4_t rhs1 = bits.neon_view(idx);
+        uint32x4_t rhs2 = rhs(idx);
+        result(idx) = vandq_u32(rhs1, vmvnq_u32(rhs2));
+      }
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonBitMask<MAX>& NeonBitMask<MAX>::operator-=(
+                                                        const NeonBitMask &rhs)
+    //-------------------------------------------------------------------------
+    {
+      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      {
+        uint32x4_t rhs1 = bits.neon_view(idx);
+        uint32x4_t rhs2 = rhs(idx);
+        bits.neon_view(idx) = vandq_u32(rhs1, ~rhs2);
+      }
+      return *this;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline bool NeonBitMask<MAX>::empty(void) const
+    //-------------------------------------------------------------------------
+    {
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        if (bits.bit_vector[idx] != 0)
+          return false;
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline bool NeonBitMask<MAX>::operator!(void) const
+    //-------------------------------------------------------------------------
+    {
+      return empty();
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonBitMask<MAX> NeonBitMask<MAX>::operator<<(unsigned shift) const
+    //-------------------------------------------------------------------------
+    {
+      // Find the range
+      unsigned range = shift >> 6;
+      unsigned local = shift & 0x3F;
+      NeonBitMask<MAX> result;
+      if (!local)
+      {
+        // Fast case where we just have to move the individual words
+        for (int idx = (BIT_ELMTS-1); idx >= int(range); idx--)
+        {
+          result[idx] = bits.bit_vector[idx-range]; 
+        }
+        // fill in everything else with zeros
+        for (unsigned idx = 0; idx < range; idx++)
+          result[idx] = 0;
+      }
+      else
+      {
+        // Slow case with merging words
+        for (int idx = (BIT_ELMTS-1); idx > int(range); idx--)
+        {
+          uint64_t left = bits.bit_vector[idx-range] << local;
+          uint64_t right = bits.bit_vector[idx-(range+1)] >> ((1 << 6) - local);
+          result[idx] = left | right;
+        }
+        // Handle the last case
+        result[range] = bits.bit_vector[0] << local; 
+        // Fill in everything else with zeros
+        for (unsigned idx = 0; idx < range; idx++)
+          result[idx] = 0;
+      }
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonBitMask<MAX> NeonBitMask<MAX>::operator>>(unsigned shift) const
+    //-------------------------------------------------------------------------
+    {
+      unsigned range = shift >> 6;
+      unsigned local = shift & 0x3F;
+      NeonBitMask<MAX> result;
+      if (!local)
+      {
+        // Fast case where we just have to move individual words
+        for (unsigned idx = 0; idx < (BIT_ELMTS-range); idx++)
+        {
+          result[idx] = bits.bit_vector[idx+range];
+        }
+        // Fill in everything else with zeros
+        for (unsigned idx = (BIT_ELMTS-range); idx < (BIT_ELMTS); idx++)
+          result[idx] = 0;
+      }
+      else
+      {
+        // Slow case with merging words
+        for (unsigned idx = 0; idx < (BIT_ELMTS-(range+1)); idx++)
+        {
+          uint64_t right = bits.bit_vector[idx+range] >> local;
+          uint64_t left = bits.bit_vector[idx+range+1] << ((1 << 6) - local);
+          result[idx] = left | right;
+        }
+        // Handle the last case
+        result[BIT_ELMTS-(range+1)] = bits.bit_vector[BIT_ELMTS-1] >> local;
+        // Fill in everything else with zeros
+        for (unsigned idx = (BIT_ELMTS-range); idx < BIT_ELMTS; idx++)
+          result[idx] = 0;
+      }
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonBitMask<MAX>& NeonBitMask<MAX>::operator<<=(unsigned shift)
+    //-------------------------------------------------------------------------
+    {
+      // Find the range
+      unsigned range = shift >> 6;
+      unsigned local = shift & 0x3F;
+      if (!local)
+      {
+        // Fast case where we just have to move the individual words
+        for (int idx = (BIT_ELMTS-1); idx >= int(range); idx--)
+        {
+          bits.bit_vector[idx] = bits.bit_vector[idx-range]; 
+        }
+        // fill in everything else with zeros
+        for (unsigned idx = 0; idx < range; idx++)
+          bits.bit_vector[idx] = 0;
+      }
+      else
+      {
+        // Slow case with merging words
+        for (int idx = (BIT_ELMTS-1); idx > int(range); idx--)
+        {
+          uint64_t left = bits.bit_vector[idx-range] << local;
+          uint64_t right = bits.bit_vector[idx-(range+1)] >> ((1 << 6) - local);
+          bits.bit_vector[idx] = left | right;
+        }
+        // Handle the last case
+        bits.bit_vector[range] = bits.bit_vector[0] << local; 
+        // Fill in everything else with zeros
+        for (unsigned idx = 0; idx < range; idx++)
+          bits.bit_vector[idx] = 0;
+      }
+      return *this;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonBitMask<MAX>& NeonBitMask<MAX>::operator>>=(unsigned shift)
+    //-------------------------------------------------------------------------
+    {
+      unsigned range = shift >> 6;
+      unsigned local = shift & 0x3F;
+      if (!local)
+      {
+        // Fast case where we just have to move individual words
+        for (unsigned idx = 0; idx < (BIT_ELMTS-range); idx++)
+        {
+          bits.bit_vector[idx] = bits.bit_vector[idx+range];
+        }
+        // Fill in everything else with zeros
+        for (unsigned idx = (BIT_ELMTS-range); idx < (BIT_ELMTS); idx++)
+          bits.bit_vector[idx] = 0;
+      }
+      else
+      {
+        // Slow case with merging words
+        for (unsigned idx = 0; idx < (BIT_ELMTS-(range+1)); idx++)
+        {
+          uint64_t right = bits.bit_vector[idx+range] >> local;
+          uint64_t left = bits.bit_vector[idx+range+1] << ((1 << 6) - local);
+          bits.bit_vector[idx] = left | right;
+        }
+        // Handle the last case
+        bits.bit_vector[BIT_ELMTS-(range+1)] = 
+                                      bits.bit_vector[BIT_ELMTS-1] >> local;
+        // Fill in everything else with zeros
+        for (unsigned idx = (BIT_ELMTS-range); idx < BIT_ELMTS; idx++)
+          bits.bit_vector[idx] = 0;
+      }
+      return *this;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline uint64_t NeonBitMask<MAX>::get_hash_key(void) const
+    //-------------------------------------------------------------------------
+    {
+      uint64_t result = 0;
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        result |= bits.bit_vector[idx];
+      }
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline const uint64_t* NeonBitMask<MAX>::base(void) const
+    //-------------------------------------------------------------------------
+    {
+      return bits.bit_vector;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX> template<typename ST>
+    inline void NeonBitMask<MAX>::serialize(ST &rez) const
+    //-------------------------------------------------------------------------
+    {
+      rez.serialize(bits.bit_vector, (MAX/8));
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX> template<typename DT>
+    inline void NeonBitMask<MAX>::deserialize(DT &derez)
+    //-------------------------------------------------------------------------
+    {
+      derez.deserialize(bits.bit_vector, (MAX/8));
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX> template<typename FUNCTOR>
+    inline void NeonBitMask<MAX>::map(FUNCTOR &functor) const
+    //-------------------------------------------------------------------------
+    {
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        if (bits.bit_vector[idx])
+        {
+          unsigned value = idx * ELEMENT_SIZE;
+          for (unsigned i = 0; i < ELEMENT_SIZE; i++, value++)
+            if (bits.bit_vector[idx] & (1ULL << i))
+              functor.apply(value);
+        }
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline char* NeonBitMask<MAX>::to_string(void) const
+    //-------------------------------------------------------------------------
+    {
+      return BitMaskHelp::to_string(bits.bit_vector, MAX);
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline unsigned NeonBitMask<MAX>::pop_count(void) const
+    //-------------------------------------------------------------------------
+    {
+      unsigned result = 0;
+#ifndef VALGRIND
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        result += __builtin_popcountll(bits.bit_vector[idx]);
+      }
+#else
+      for (unsigned idx = 0; idx < MAX; idx++)
+      {
+        if (is_set(idx))
+          result++;
+      }
+#endif
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    /*static*/ inline unsigned NeonBitMask<MAX>::pop_count(
+                                                  const NeonBitMask<MAX> &mask)
+    //-------------------------------------------------------------------------
+    {
+      unsigned result = 0;
+#ifndef VALGRIND
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        result += __builtin_popcountll(mask[idx]);
+      }
+#else
+      for (unsigned idx = 0; idx < MAX; idx++)
+      {
+        if (mask.is_set(idx))
+          result++;
+      }
+#endif
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    NeonTLBitMask<MAX>::NeonTLBitMask(uint64_t init /*= 0*/)
+      : sum_mask(init)
+    //-------------------------------------------------------------------------
+    {
+      static_assert((MAX % 128) == 0);
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        bits.bit_vector[idx] = init;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    NeonTLBitMask<MAX>::NeonTLBitMask(const NeonTLBitMask &rhs)
+      : sum_mask(rhs.sum_mask)
+    //-------------------------------------------------------------------------
+    {
+      static_assert((MAX % 128) == 0);
+      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      {
+        bits.neon_view(idx) = rhs(idx);
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    NeonTLBitMask<MAX>::~NeonTLBitMask(void)
+    //-------------------------------------------------------------------------
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline void NeonTLBitMask<MAX>::set_bit(unsigned bit)
+    //-------------------------------------------------------------------------
+    {
+#ifdef DEBUG_LEGION
+      assert(bit < MAX);
+#endif
+      unsigned idx = bit >> 6;
+      const uint64_t set_mask = (1UL << (bit & 0x3F));
+      bits.bit_vector[idx] |= set_mask;
+      sum_mask |= set_mask;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline void NeonTLBitMask<MAX>::unset_bit(unsigned bit)
+    //-------------------------------------------------------------------------
+    {
+#ifdef DEBUG_LEGION
+      assert(bit < MAX);
+#endif
+      unsigned idx = bit >> 6;
+      const uint64_t set_mask = (1UL << (bit & 0x3F));
+      const uint64_t unset_mask = ~set_mask;
+      bits.bit_vector[idx] &= unset_mask;
+      // Unset the summary mask and then reset if necessary
+      sum_mask &= unset_mask;
+      for (unsigned i = 0; i < BIT_ELMTS; i++)
+        sum_mask |= bits.bit_vector[i];
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline void NeonTLBitMask<MAX>::assign_bit(unsigned bit, bool val)
+    //-------------------------------------------------------------------------
+    {
+      if (val)
+        set_bit(bit);
+      else
+        unset_bit(bit);
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline bool NeonTLBitMask<MAX>::is_set(unsigned bit) const
+    //-------------------------------------------------------------------------
+    {
+#ifdef DEBUG_LEGION
+      assert(bit < MAX);
+#endif
+      unsigned idx = bit >> 6;
+      return (bits.bit_vector[idx] & (1UL << (bit & 0x3F)));
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline int NeonTLBitMask<MAX>::find_first_set(void) const
+    //-------------------------------------------------------------------------
+    {
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        if (bits.bit_vector[idx])
+        {
+          for (unsigned j = 0; j < ELEMENT_SIZE; j++)
+          {
+            if (bits.bit_vector[idx] & (1UL << j))
+            {
+              return (idx*ELEMENT_SIZE + j);
+            }
+          }
+        }
+      }
+      return -1;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline int NeonTLBitMask<MAX>::find_index(unsigned bit) const
+    //-------------------------------------------------------------------------
+    {
+      unsigned element = bit >> bits.SHIFT; 
+      unsigned offset = bit & bits.MASK;
+      if (bits.bit_vector[element] & (1ULL << offset))
+      {
+        int index = 0;
+        for (unsigned idx = 0; idx < element; idx++)
+          index += __builtin_popcountll(bits.bit_vector[idx]);
+        // Handle dumb c++ shift overflow
+        if (offset == 0)
+          return index;
+        // Just count the bits up to but not including the actual
+        // bit we're looking for since indexes are zero-base
+        index += __builtin_popcountll(
+            bits.bit_vector[element] << (ELEMENT_SIZE - offset));
+        return index;
+      }
+      else // It's not set otherwise so we couldn't find an index
+        return -1;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline int NeonTLBitMask<MAX>::get_index(unsigned index) const
+    //-------------------------------------------------------------------------
+    {
+      int offset = 0;
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        unsigned local = __builtin_popcountll(bits.bit_vector[idx]);
+        if (index < local)
+        {
+          for (unsigned j = 0; j < ELEMENT_SIZE; j++)
+          {
+            if (bits.bit_vector[idx] & (1ULL << j))
+            {
+              if (index == 0)
+                return (offset + j);
+              index--;
+            }
+          }
+        }
+        index -= local;
+        offset += ELEMENT_SIZE;
+      }
+      return -1;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline int NeonTLBitMask<MAX>::find_next_set(unsigned start) const
+    //-------------------------------------------------------------------------
+    {
+      int idx = start / ELEMENT_SIZE; // truncate
+      int offset = idx * ELEMENT_SIZE; 
+      int j = start % ELEMENT_SIZE;
+      if (j > 0) // if we are already in the middle of element search it
+      {
+        for ( ; j < int(ELEMENT_SIZE); j++)
+        {
+          if (bits.bit_vector[idx] & (1ULL << j))
+            return (offset + j);
+        }
+        idx++;
+        offset += ELEMENT_SIZE;
+      }
+      for ( ; idx < int(BIT_ELMTS); idx++)
+      {
+        if (bits.bit_vector[idx] > 0) // if it has any valid entries, find next
+        {
+          for (j = 0; j < int(ELEMENT_SIZE); j++)
+          {
+            if (bits.bit_vector[idx] & (1ULL << j))
+              return (offset + j);
+          }
+        }
+        offset += ELEMENT_SIZE;
+      }
+      return -1;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline void NeonTLBitMask<MAX>::clear(void)
+    //-------------------------------------------------------------------------
+    {
+      const uint32x4_t zero_vec = vdupq_n_u32(0);
+      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      {
+        bits.neon_view(idx) = zero_vec; 
+      }
+      sum_mask = 0;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline BitMaskHelp::NeonView<true>
+                  NeonTLBitMask<MAX>::operator()(const unsigned int &idx) const
+    //-------------------------------------------------------------------------
+    {
+      return bits.neon_view(idx);
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline BitMaskHelp::NeonView<false>
+                        NeonTLBitMask<MAX>::operator()(const unsigned int &idx)
+    //-------------------------------------------------------------------------
+    {
+      return bits.neon_view(idx);
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline const uint64_t& NeonTLBitMask<MAX>::operator[](
+                                                 const unsigned int &idx) const
+    //-------------------------------------------------------------------------
+    {
+      return bits.bit_vector[idx];
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline uint64_t& NeonTLBitMask<MAX>::operator[](const unsigned int &idx) 
+    //-------------------------------------------------------------------------
+    {
+      return bits.bit_vector[idx]; 
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline bool NeonTLBitMask<MAX>::operator==(const NeonTLBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      if (sum_mask != rhs.sum_mask)
+        return false;
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+	if (bits.bit_vector[idx] != rhs[idx])
+          return false;
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline bool NeonTLBitMask<MAX>::operator<(const NeonTLBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      // Only be less than if the bits are a subset of the rhs bits
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        if (bits.bit_vector[idx] < rhs[idx])
+          return true;
+        else if (bits.bit_vector[idx] > rhs[idx])
+          return false;
+      }
+      // Otherwise they are equal so false
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline bool NeonTLBitMask<MAX>::operator!=(const NeonTLBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      return !(*this == rhs);
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonTLBitMask<MAX>& NeonTLBitMask<MAX>::operator=(
+                                                      const NeonTLBitMask &rhs)
+    //-------------------------------------------------------------------------
+    {
+      sum_mask = rhs.sum_mask;
+      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      {
+        bits.neon_view(idx) = rhs(idx);
+      }
+      return *this;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonTLBitMask<MAX> NeonTLBitMask<MAX>::operator~(void) const
+    //-------------------------------------------------------------------------
+    {
+      NeonTLBitMask<MAX> result;
+      uint32x4_t result_mask = vdupq_n_u32(0);
+      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      {
+        uint32x4_t rhs = bits.neon_view(idx);
+        uint32x4_t lhs = vmvnq_u32(rhs);
+        result(idx) = lhs;
+        result_mask = vorrq_u32(result_mask, lhs);
+      }
+      result.sum_mask = extract_mask(result_mask);
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonTLBitMask<MAX> NeonTLBitMask<MAX>::operator|(
+                                                const NeonTLBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      NeonTLBitMask<MAX> result;
+      result.sum_mask = sum_mask | rhs.sum_mask;
+      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      {
+        uint32x4_t rhs1 = bits.neon_view(idx);
+        uint32x4_t rhs2 = rhs(idx);
+        result(idx) = vorrq_u32(rhs1, rhs2);
+      }
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonTLBitMask<MAX> NeonTLBitMask<MAX>::operator&(
+                                                const NeonTLBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      NeonTLBitMask<MAX> result;
+      // If they are independent then we are done
+      if (sum_mask & rhs.sum_mask)
+      {
+        uint32x4_t temp_sum = vdupq_n_u32(0);
+        for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+        {
+          uint32x4_t rhs1 = bits.neon_view(idx);
+          uint32x4_t rhs2 = rhs(idx);
+          uint32x4_t lhs = vandq_u32(rhs1, rhs2);
+          result(idx) = lhs;
+          temp_sum = vorrq_u32(temp_sum, lhs);
+        }
+        result.sum_mask = extract_mask(temp_sum); 
+      }
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonTLBitMask<MAX> NeonTLBitMask<MAX>::operator^(
+                                                const NeonTLBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      NeonTLBitMask<MAX> result;
+      uint32x4_t temp_sum = vdupq_n_u32(0);
+      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      {
+        uint32x4_t rhs1 = bits.neon_view(idx);
+        uint32x4_t rhs2 = rhs(idx);
+        uint32x4_t lhs = veorq_u32(rhs1, rhs2);
+        result(idx) = lhs;
+        temp_sum = vorrq_u32(temp_sum, lhs);
+      }
+      result.sum_mask = extract_mask(temp_sum);
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonTLBitMask<MAX>& NeonTLBitMask<MAX>::operator|=(
+                                                      const NeonTLBitMask &rhs)
+    //-------------------------------------------------------------------------
+    {
+      sum_mask |= rhs.sum_mask;
+      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      {
+        uint32x4_t rhs1 = bits.neon_view(idx);
+        uint32x4_t rhs2 = rhs(idx);
+        bits.neon_view(idx) = vorrq_u32(rhs1, rhs2);
+      }
+      return *this;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonTLBitMask<MAX>& NeonTLBitMask<MAX>::operator&=(
+                                                      const NeonTLBitMask &rhs)
+    //-------------------------------------------------------------------------
+    {
+      if (sum_mask & rhs.sum_mask)
+      {
+        uint32x4_t temp_sum = vdupq_n_u32(0);
+        for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+        {
+          uint32x4_t rhs1 = bits.neon_view(idx);
+          uint32x4_t rhs2 = rhs(idx);
+          uint32x4_t lhs = vandq_u32(rhs1, rhs2);
+          bits.neon_view(idx) = lhs;
+          temp_sum = vorrq_u32(temp_sum, lhs);
+        }
+        sum_mask = extract_mask(temp_sum); 
+      }
+      else
+      {
+        sum_mask = 0;
+        const uint32x4_t zero_vec = vdupq_n_u32(0);
+        for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+          bits.neon_view(idx) = zero_vec;
+      }
+      return *this;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonTLBitMask<MAX>& NeonTLBitMask<MAX>::operator^=(
+                                                      const NeonTLBitMask &rhs)
+    //-------------------------------------------------------------------------
+    {
+      uint32x4_t temp_sum = vdupq_n_u32(0);
+      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      {
+        uint32x4_t rhs1 = bits.neon_view(idx);
+        uint32x4_t rhs2 = rhs(idx);
+        uint32x4_t lhs = veorq_u32(rhs1, rhs2);
+        bits.neon_view(idx) = lhs;
+        temp_sum = vorrq_u32(temp_sum, lhs);
+      }
+      sum_mask = extract_mask(temp_sum);
+      return *this;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline bool NeonTLBitMask<MAX>::operator*(const NeonTLBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      if (sum_mask & rhs.sum_mask)
+      {
+        for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+        {
+          if (bits.bit_vector[idx] & rhs[idx])
+            return false;
+        }
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonTLBitMask<MAX> NeonTLBitMask<MAX>::operator-(
+                                                const NeonTLBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      NeonTLBitMask<MAX> result;
+      uint32x4_t temp_sum = vdupq_n_u32(0);
+      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      {
+        uint32x4_t rhs1 = bits.neon_view(idx);
+        uint32x4_t rhs2 = rhs(idx);
+        uint32x4_t lhs = vandq_u32(rhs1, vmvnq_u32(rhs2));
+        result(idx) = lhs;
+        temp_sum = vorrq_u32(temp_sum, lhs);
+      }
+      result.sum_mask = extract_mask(temp_sum);
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonTLBitMask<MAX>& NeonTLBitMask<MAX>::operator-=(
+                                                      const NeonTLBitMask &rhs)
+    //-------------------------------------------------------------------------
+    {
+      uint32x4_t temp_sum = vdupq_n_u32(0);
+      for (unsigned idx = 0; idx < NEON_ELMTS; idx++)
+      {
+        uint32x4_t rhs1 = bits.neon_view(idx);
+        uint32x4_t rhs2 = rhs(idx);
+        uint32x4_t lhs = vandq_u32(rhs1, vmvnq_u32(rhs2));
+        bits.neon_view(idx) = lhs;
+        temp_sum = vorrq_u32(temp_sum, lhs);
+      }
+      sum_mask = extract_mask(temp_sum);
+      return *this;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline bool NeonTLBitMask<MAX>::empty(void) const
+    //-------------------------------------------------------------------------
+    {
+      // A great reason to have a summary mask
+      return (sum_mask == 0);
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline bool NeonTLBitMask<MAX>::operator!(void) const
+    //-------------------------------------------------------------------------
+    {
+      return empty();
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonTLBitMask<MAX> NeonTLBitMask<MAX>::operator<<(
+                                                          unsigned shift) const
+    //-------------------------------------------------------------------------
+    {
+      // Find the range
+      unsigned range = shift >> 6;
+      unsigned local = shift & 0x3F;
+      NeonTLBitMask<MAX> result;
+      if (!local)
+      {
+        // Fast case where we just have to move the individual words
+        for (int idx = (BIT_ELMTS-1); idx >= int(range); idx--)
+        {
+          result[idx] = bits.bit_vector[idx-range]; 
+          result.sum_mask |= result[idx];
+        }
+        // fill in everything else with zeros
+        for (unsigned idx = 0; idx < range; idx++)
+          result[idx] = 0;
+      }
+      else
+      {
+        // Slow case with merging words
+        for (int idx = (BIT_ELMTS-1); idx > int(range); idx--)
+        {
+          uint64_t left = bits.bit_vector[idx-range] << local;
+          uint64_t right = bits.bit_vector[idx-(range+1)] >> ((1 << 6) - local);
+          result[idx] = left | right;
+          result.sum_mask |= result[idx];
+        }
+        // Handle the last case
+        result[range] = bits.bit_vector[0] << local; 
+        result.sum_mask |= result[range];
+        // Fill in everything else with zeros
+        for (unsigned idx = 0; idx < range; idx++)
+          result[idx] = 0;
+      }
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonTLBitMask<MAX> NeonTLBitMask<MAX>::operator>>(
+                                                          unsigned shift) const
+    //-------------------------------------------------------------------------
+    {
+      unsigned range = shift >> 6;
+      unsigned local = shift & 0x3F;
+      NeonTLBitMask<MAX> result;
+      if (!local)
+      {
+        // Fast case where we just have to move individual words
+        for (unsigned idx = 0; idx < (BIT_ELMTS-range); idx++)
+        {
+          result[idx] = bits.bit_vector[idx+range];
+          result.sum_mask |= result[idx];
+        }
+        // Fill in everything else with zeros
+        for (unsigned idx = (BIT_ELMTS-range); idx < (BIT_ELMTS); idx++)
+          result[idx] = 0;
+      }
+      else
+      {
+        // Slow case with merging words
+        for (unsigned idx = 0; idx < (BIT_ELMTS-(range+1)); idx++)
+        {
+          uint64_t right = bits.bit_vector[idx+range] >> local;
+          uint64_t left = bits.bit_vector[idx+range+1] << ((1 << 6) - local);
+          result[idx] = left | right;
+          result.sum_mask |= result[idx];
+        }
+        // Handle the last case
+        result[BIT_ELMTS-(range+1)] = bits.bit_vector[BIT_ELMTS-1] >> local;
+        result.sum_mask |= result[BIT_ELMTS-(range+1)];
+        // Fill in everything else with zeros
+        for (unsigned idx = (BIT_ELMTS-range); idx < BIT_ELMTS; idx++)
+          result[idx] = 0;
+      }
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonTLBitMask<MAX>& NeonTLBitMask<MAX>::operator<<=(unsigned shift)
+    //-------------------------------------------------------------------------
+    {
+      // Find the range
+      unsigned range = shift >> 6;
+      unsigned local = shift & 0x3F;
+      sum_mask = 0;
+      if (!local)
+      {
+        // Fast case where we just have to move the individual words
+        for (int idx = (BIT_ELMTS-1); idx >= int(range); idx--)
+        {
+          bits.bit_vector[idx] = bits.bit_vector[idx-range]; 
+          sum_mask |= bits.bit_vector[idx];
+        }
+        // fill in everything else with zeros
+        for (unsigned idx = 0; idx < range; idx++)
+          bits.bit_vector[idx] = 0;
+      }
+      else
+      {
+        // Slow case with merging words
+        for (int idx = (BIT_ELMTS-1); idx > int(range); idx--)
+        {
+          uint64_t left = bits.bit_vector[idx-range] << local;
+          uint64_t right = bits.bit_vector[idx-(range+1)] >> ((1 << 6) - local);
+          bits.bit_vector[idx] = left | right;
+          sum_mask |= bits.bit_vector[idx];
+        }
+        // Handle the last case
+        bits.bit_vector[range] = bits.bit_vector[0] << local; 
+        sum_mask |= bits.bit_vector[range];
+        // Fill in everything else with zeros
+        for (unsigned idx = 0; idx < range; idx++)
+          bits.bit_vector[idx] = 0;
+      }
+      return *this;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline NeonTLBitMask<MAX>& NeonTLBitMask<MAX>::operator>>=(unsigned shift)
+    //-------------------------------------------------------------------------
+    {
+      unsigned range = shift >> 6;
+      unsigned local = shift & 0x3F;
+      sum_mask = 0;
+      if (!local)
+      {
+        // Fast case where we just have to move individual words
+        for (unsigned idx = 0; idx < (BIT_ELMTS-range); idx++)
+        {
+          bits.bit_vector[idx] = bits.bit_vector[idx+range];
+          sum_mask |= bits.bit_vector[idx];
+        }
+        // Fill in everything else with zeros
+        for (unsigned idx = (BIT_ELMTS-range); idx < (BIT_ELMTS); idx++)
+          bits.bit_vector[idx] = 0;
+      }
+      else
+      {
+        // Slow case with merging words
+        for (unsigned idx = 0; idx < (BIT_ELMTS-(range+1)); idx++)
+        {
+          uint64_t right = bits.bit_vector[idx+range] >> local;
+          uint64_t left = bits.bit_vector[idx+range+1] << ((1 << 6) - local);
+          bits.bit_vector[idx] = left | right;
+          sum_mask |= bits.bit_vector[idx];
+        }
+        // Handle the last case
+        bits.bit_vector[BIT_ELMTS-(range+1)] = 
+                                        bits.bit_vector[BIT_ELMTS-1] >> local;
+        sum_mask |= bits.bit_vector[BIT_ELMTS-(range+1)];
+        // Fill in everything else with zeros
+        for (unsigned idx = (BIT_ELMTS-range); idx < BIT_ELMTS; idx++)
+          bits.bit_vector[idx] = 0;
+      }
+      return *this;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline uint64_t NeonTLBitMask<MAX>::get_hash_key(void) const
+    //-------------------------------------------------------------------------
+    {
+      return sum_mask;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline const uint64_t* NeonTLBitMask<MAX>::base(void) const
+    //-------------------------------------------------------------------------
+    {
+      return bits.bit_vector;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX> template<typename ST>
+    inline void NeonTLBitMask<MAX>::serialize(ST &rez) const
+    //-------------------------------------------------------------------------
+    {
+      rez.serialize(sum_mask);
+      rez.serialize(bits.bit_vector, (MAX/8));
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX> template<typename DT>
+    inline void NeonTLBitMask<MAX>::deserialize(DT &derez)
+    //-------------------------------------------------------------------------
+    {
+      derez.deserialize(sum_mask);
+      derez.deserialize(bits.bit_vector, (MAX/8));
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX> template<typename FUNCTOR>
+    inline void NeonTLBitMask<MAX>::map(FUNCTOR &functor) const
+    //-------------------------------------------------------------------------
+    {
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        if (bits.bit_vector[idx])
+        {
+          unsigned value = idx * ELEMENT_SIZE;
+          for (unsigned i = 0; i < ELEMENT_SIZE; i++, value++)
+            if (bits.bit_vector[idx] & (1ULL << i))
+              functor.apply(value);
+        }
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline char* NeonTLBitMask<MAX>::to_string(void) const
+    //-------------------------------------------------------------------------
+    {
+      return BitMaskHelp::to_string(bits.bit_vector, MAX);
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline unsigned NeonTLBitMask<MAX>::pop_count(void) const
+    //-------------------------------------------------------------------------
+    {
+      if (!sum_mask)
+        return 0;
+      unsigned result = 0;
+#ifndef VALGRIND
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        result += __builtin_popcountll(bits.bit_vector[idx]);
+      }
+#else
+      for (unsigned idx = 0; idx < MAX; idx++)
+      {
+        if (is_set(idx))
+          result++;
+      }
+#endif
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    /*static*/ inline unsigned NeonTLBitMask<MAX>::pop_count(
+                                                const NeonTLBitMask<MAX> &mask)
+    //-------------------------------------------------------------------------
+    {
+      unsigned result = 0;
+#ifndef VALGRIND
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        result += __builtin_popcountll(mask[idx]);
+      }
+#else
+      for (unsigned idx = 0; idx < MAX; idx++)
+      {
+        if (mask.is_set(idx))
+          result++;
+      }
+#endif
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    /*static*/ inline uint64_t NeonTLBitMask<MAX>::extract_mask(
+                                                              uint32x4_t value)
+    //-------------------------------------------------------------------------
+    {
+      uint64_t zero = vgetq_lane_u32(value, 0);
+      uint64_t one = vgetq_lane_u32(value, 1);
+      uint64_t two = vgetq_lane_u32(value, 2);
+      uint64_t three = vgetq_lane_u32(value, 3);
+      one <<= 32;
+      three <<= 32;
+      return (zero | one | two | three);
+    }
+#endif // __ARM_NEON
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    DispatchTLBitMask<MAX>::DispatchTLBitMask(uint64_t init /*= 0*/)
+      : sum_mask(init)
+    //-------------------------------------------------------------------------
+    {
+      static_assert((MAX % 64) == 0);
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        bits.bit_vector[idx] = init;
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    DispatchTLBitMask<MAX>::DispatchTLBitMask(const DispatchTLBitMask &rhs)
+      : sum_mask(rhs.sum_mask)
+    //-------------------------------------------------------------------------
+    {
+      static_assert((MAX % 64) == 0);
+      memcpy(bits.bit_vector, rhs.bits.bit_vector, sizeof(bits.bit_vector));
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    DispatchTLBitMask<MAX>::~DispatchTLBitMask(void)
+    //-------------------------------------------------------------------------
+    {
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline void DispatchTLBitMask<MAX>::set_bit(unsigned bit)
+    //-------------------------------------------------------------------------
+    {
+#ifdef DEBUG_LEGION
+      assert(bit < MAX);
+#endif
+      unsigned idx = bit >> 6;
+      const uint64_t set_mask = (1UL << (bit & 0x3F));
+      bits.bit_vector[idx] |= set_mask;
+      sum_mask |= set_mask;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline void DispatchTLBitMask<MAX>::unset_bit(unsigned bit)
+    //-------------------------------------------------------------------------
+    {
+#ifdef DEBUG_LEGION
+      assert(bit < MAX);
+#endif
+      unsigned idx = bit >> 6;
+      const uint64_t set_mask = (1UL << (bit & 0x3F));
+      const uint64_t unset_mask = ~set_mask;
+      bits.bit_vector[idx] &= unset_mask;
+      // Unset the summary mask and then reset if necessary
+      sum_mask &= unset_mask;
+      for (unsigned i = 0; i < BIT_ELMTS; i++)
+        sum_mask |= bits.bit_vector[i];
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline void DispatchTLBitMask<MAX>::assign_bit(unsigned bit, bool val)
+    //-------------------------------------------------------------------------
+    {
+      if (val)
+        set_bit(bit);
+      else
+        unset_bit(bit);
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline bool DispatchTLBitMask<MAX>::is_set(unsigned bit) const
+    //-------------------------------------------------------------------------
+    {
+#ifdef DEBUG_LEGION
+      assert(bit < MAX);
+#endif
+      unsigned idx = bit >> 6;
+      return (bits.bit_vector[idx] & (1UL << (bit & 0x3F)));
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline int DispatchTLBitMask<MAX>::find_first_set(void) const
+    //-------------------------------------------------------------------------
+    {
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        if (bits.bit_vector[idx])
+        {
+          for (unsigned j = 0; j < ELEMENT_SIZE; j++)
+          {
+            if (bits.bit_vector[idx] & (1UL << j))
+            {
+              return (idx*ELEMENT_SIZE+ j);
+            }
+          }
+        }
+      }
+      return -1;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline int DispatchTLBitMask<MAX>::find_index(unsigned bit) const
+    //-------------------------------------------------------------------------
+    {
+      unsigned element = bit >> bits.SHIFT; 
+      unsigned offset = bit & bits.MASK;
+      if (bits.bit_vector[element] & (1ULL << offset))
+      {
+        int index = 0;
+        for (unsigned idx = 0; idx < element; idx++)
+          index += __builtin_popcountll(bits.bit_vector[idx]);
+        // Handle dumb c++ shift overflow
+        if (offset == 0)
+          return index;
+        // Just count the bits up to but not including the actual
+        // bit we're looking for since indexes are zero-base
+        index += __builtin_popcountll(
+            bits.bit_vector[element] << (ELEMENT_SIZE - offset));
+        return index;
+      }
+      else // It's not set otherwise so we couldn't find an index
+        return -1;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline int DispatchTLBitMask<MAX>::get_index(unsigned index) const
+    //-------------------------------------------------------------------------
+    {
+      int offset = 0;
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        unsigned local = __builtin_popcountll(bits.bit_vector[idx]);
+        if (index < local)
+        {
+          for (unsigned j = 0; j < ELEMENT_SIZE; j++)
+          {
+            if (bits.bit_vector[idx] & (1ULL << j))
+            {
+              if (index == 0)
+                return (offset + j);
+              index--;
+            }
+          }
+        }
+        index -= local;
+        offset += ELEMENT_SIZE;
+      }
+      return -1;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline int DispatchTLBitMask<MAX>::find_next_set(unsigned start) const
+    //-------------------------------------------------------------------------
+    {
+      int idx = start / ELEMENT_SIZE; // truncate
+      int offset = idx * ELEMENT_SIZE; 
+      int j = start % ELEMENT_SIZE;
+      if (j > 0) // if we are already in the middle of element search it
+      {
+        for ( ; j < int(ELEMENT_SIZE); j++)
+        {
+          if (bits.bit_vector[idx] & (1ULL << j))
+            return (offset + j);
+        }
+        idx++;
+        offset += ELEMENT_SIZE;
+      }
+      for ( ; idx < int(BIT_ELMTS); idx++)
+      {
+        if (bits.bit_vector[idx] > 0) // if it has any valid entries, find next
+        {
+          for (j = 0; j < int(ELEMENT_SIZE); j++)
+          {
+            if (bits.bit_vector[idx] & (1ULL << j))
+              return (offset + j);
+          }
+        }
+        offset += ELEMENT_SIZE;
+      }
+      return -1;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline void DispatchTLBitMask<MAX>::clear(void)
+    //-------------------------------------------------------------------------
+    {
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        bits.bit_vector[idx] = 0;
+      }
+      sum_mask = 0;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline const uint64_t& DispatchTLBitMask<MAX>::operator[](
+                                                 const unsigned int &idx) const
+    //-------------------------------------------------------------------------
+    {
+      return bits.bit_vector[idx];
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline uint64_t& DispatchTLBitMask<MAX>::operator[](
+                                                       const unsigned int &idx)
+    //-------------------------------------------------------------------------
+    {
+      return bits.bit_vector[idx]; 
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline bool DispatchTLBitMask<MAX>::operator==(
+                                            const DispatchTLBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      if (sum_mask != rhs.sum_mask)
+        return false;
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        if (bits.bit_vector[idx] != rhs[idx])
+          return false;
+      }
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline bool DispatchTLBitMask<MAX>::operator<(
+                                            const DispatchTLBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      // Only be less than if the bits are a subset of the rhs bits
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        if (bits.bit_vector[idx] < rhs[idx])
+          return true;
+        else if (bits.bit_vector[idx] > rhs[idx])
+          return false;
+      }
+      // Otherwise they are equal so false
+      return false;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline bool DispatchTLBitMask<MAX>::operator!=(
+                                            const DispatchTLBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      return !(*this == rhs);
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline DispatchTLBitMask<MAX>& DispatchTLBitMask<MAX>::operator=(
+                                                  const DispatchTLBitMask &rhs)
+    //-------------------------------------------------------------------------
+    {
+      sum_mask = rhs.sum_mask;
+      memcpy(bits.bit_vector, rhs.bits.bit_vector, sizeof(bits.bit_vector));
+      return *this;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline DispatchTLBitMask<MAX> DispatchTLBitMask<MAX>::operator~(void) const
+    //-------------------------------------------------------------------------
+    {
+      DispatchTLBitMask<MAX> result;
+      result.sum_mask = BitMaskHelp::bit_kernels().bit_not(
+          result.bits.bit_vector, bits.bit_vector, BIT_ELMTS);
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline DispatchTLBitMask<MAX> DispatchTLBitMask<MAX>::operator|(
+                                            const DispatchTLBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      DispatchTLBitMask<MAX> result;
+      result.sum_mask = BitMaskHelp::bit_kernels().bit_or(
+          result.bits.bit_vector, bits.bit_vector, rhs.bits.bit_vector,
+          BIT_ELMTS);
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline DispatchTLBitMask<MAX> DispatchTLBitMask<MAX>::operator&(
+                                            const DispatchTLBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      DispatchTLBitMask<MAX> result;
+      // If they are independent then we are done
+      if (sum_mask & rhs.sum_mask)
+        result.sum_mask = BitMaskHelp::bit_kernels().bit_and(
+            result.bits.bit_vector, bits.bit_vector, rhs.bits.bit_vector,
+            BIT_ELMTS);
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline DispatchTLBitMask<MAX> DispatchTLBitMask<MAX>::operator^(
+                                            const DispatchTLBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      DispatchTLBitMask<MAX> result;
+      result.sum_mask = BitMaskHelp::bit_kernels().bit_xor(
+          result.bits.bit_vector, bits.bit_vector, rhs.bits.bit_vector,
+          BIT_ELMTS);
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline DispatchTLBitMask<MAX>& DispatchTLBitMask<MAX>::operator|=(
+                                                  const DispatchTLBitMask &rhs)
+    //-------------------------------------------------------------------------
+    {
+      // Nothing to do if the right-hand side is empty
+      if (rhs.sum_mask)
+        sum_mask = BitMaskHelp::bit_kernels().bit_or(bits.bit_vector,
+            bits.bit_vector, rhs.bits.bit_vector, BIT_ELMTS);
+      return *this;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline DispatchTLBitMask<MAX>& DispatchTLBitMask<MAX>::operator&=(
+                                                  const DispatchTLBitMask &rhs)
+    //-------------------------------------------------------------------------
+    {
+      if (sum_mask & rhs.sum_mask)
+        sum_mask = BitMaskHelp::bit_kernels().bit_and(bits.bit_vector,
+            bits.bit_vector, rhs.bits.bit_vector, BIT_ELMTS);
+      else if (sum_mask)
+        clear();
+      return *this;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline DispatchTLBitMask<MAX>& DispatchTLBitMask<MAX>::operator^=(
+                                                  const DispatchTLBitMask &rhs)
+    //-------------------------------------------------------------------------
+    {
+      if (rhs.sum_mask)
+        sum_mask = BitMaskHelp::bit_kernels().bit_xor(bits.bit_vector,
+            bits.bit_vector, rhs.bits.bit_vector, BIT_ELMTS);
+      return *this;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline bool DispatchTLBitMask<MAX>::operator*(
+                                            const DispatchTLBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      if (sum_mask & rhs.sum_mask)
+        return BitMaskHelp::bit_kernels().disjoint(bits.bit_vector,
+                                      rhs.bits.bit_vector, BIT_ELMTS);
+      return true;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline DispatchTLBitMask<MAX> DispatchTLBitMask<MAX>::operator-(
+                                            const DispatchTLBitMask &rhs) const
+    //-------------------------------------------------------------------------
+    {
+      if (!(sum_mask & rhs.sum_mask))
+        return *this;
+      DispatchTLBitMask<MAX> result;
+      result.sum_mask = BitMaskHelp::bit_kernels().bit_andnot(
+          result.bits.bit_vector, bits.bit_vector, rhs.bits.bit_vector,
+          BIT_ELMTS);
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline DispatchTLBitMask<MAX>& DispatchTLBitMask<MAX>::operator-=(
+                                                  const DispatchTLBitMask &rhs)
+    //-------------------------------------------------------------------------
+    {
+      if (sum_mask & rhs.sum_mask)
+        sum_mask = BitMaskHelp::bit_kernels().bit_andnot(bits.bit_vector,
+            bits.bit_vector, rhs.bits.bit_vector, BIT_ELMTS);
+      return *this;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline bool DispatchTLBitMask<MAX>::empty(void) const
+    //-------------------------------------------------------------------------
+    {
+      // A great reason to have a summary mask
+      return (sum_mask == 0);
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline bool DispatchTLBitMask<MAX>::operator!(void) const
+    //-------------------------------------------------------------------------
+    {
+      return empty();
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline DispatchTLBitMask<MAX> DispatchTLBitMask<MAX>::operator<<(
+                                                          unsigned shift) const
+    //-------------------------------------------------------------------------
+    {
+      // Find the range
+      unsigned range = shift >> 6;
+      unsigned local = shift & 0x3F;
+      DispatchTLBitMask<MAX> result;
+      if (!local)
+      {
+        // Fast case where we just have to move the individual words
+        for (int idx = (BIT_ELMTS-1); idx >= int(range); idx--)
+        {
+          result[idx] = bits.bit_vector[idx-range]; 
+          result.sum_mask |= result[idx];
+        }
+        // fill in everything else with zeros
+        for (unsigned idx = 0; idx < range; idx++)
+          result[idx] = 0;
+      }
+      else
+      {
+        // Slow case with merging words
+        for (int idx = (BIT_ELMTS-1); idx > int(range); idx--)
+        {
+          uint64_t left = bits.bit_vector[idx-range] << local;
+          uint64_t right = bits.bit_vector[idx-(range+1)] >> ((1 << 6) - local);
+          result[idx] = left | right;
+          result.sum_mask |= result[idx];
+        }
+        // Handle the last case
+        result[range] = bits.bit_vector[0] << local; 
+        result.sum_mask |= result[range];
+        // Fill in everything else with zeros
+        for (unsigned idx = 0; idx < range; idx++)
+          result[idx] = 0;
+      }
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline DispatchTLBitMask<MAX> DispatchTLBitMask<MAX>::operator>>(
+                                                          unsigned shift) const
+    //-------------------------------------------------------------------------
+    {
+      unsigned range = shift >> 6;
+      unsigned local = shift & 0x3F;
+      DispatchTLBitMask<MAX> result;
+      if (!local)
+      {
+        // Fast case where we just have to move individual words
+        for (unsigned idx = 0; idx < (BIT_ELMTS-range); idx++)
+        {
+          result[idx] = bits.bit_vector[idx+range];
+          result.sum_mask |= result[idx];
+        }
+        // Fill in everything else with zeros
+        for (unsigned idx = (BIT_ELMTS-range); idx < (BIT_ELMTS); idx++)
+          result[idx] = 0;
+      }
+      else
+      {
+        // Slow case with merging words, a single word has nothing to merge
+        if constexpr (BIT_ELMTS > 1)
+        {
+          for (unsigned idx = 0; idx < (BIT_ELMTS-(range+1)); idx++)
+          {
+            uint64_t right = bits.bit_vector[idx+range] >> local;
+            uint64_t left = bits.bit_vector[idx+range+1] << ((1 << 6) - local);
+            result[idx] = left | right;
+            result.sum_mask |= result[idx];
+          }
+        }
+        // Handle the last case
+        result[BIT_ELMTS-(range+1)] = bits.bit_vector[BIT_ELMTS-1] >> local;
+        result.sum_mask |= result[BIT_ELMTS-(range+1)];
+        // Fill in everything else with zeros
+        for (unsigned idx = (BIT_ELMTS-range); idx < BIT_ELMTS; idx++)
+          result[idx] = 0;
+      }
+      return result;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline DispatchTLBitMask<MAX>& DispatchTLBitMask<MAX>::operator<<=(
+                                                                unsigned shift)
+    //-------------------------------------------------------------------------
+    {
+      // Find the range
+      unsigned range = shift >> 6;
+      unsigned local = shift & 0x3F;
+      sum_mask = 0;
+      if (!local)
+      {
+        // Fast case where we just have to move the individual words
+        for (int idx = (BIT_ELMTS-1); idx >= int(range); idx--)
+        {
+          bits.bit_vector[idx] = bits.bit_vector[idx-range]; 
+          sum_mask |= bits.bit_vector[idx];
+        }
+        // fill in everything else with zeros
+        for (unsigned idx = 0; idx < range; idx++)
+          bits.bit_vector[idx] = 0;
+      }
+      else
+      {
+        // Slow case with merging words
+        for (int idx = (BIT_ELMTS-1); idx > int(range); idx--)
+        {
+          uint64_t left = bits.bit_vector[idx-range] << local;
+          uint64_t right = bits.bit_vector[idx-(range+1)] >> ((1 << 6) - local);
+          bits.bit_vector[idx] = left | right;
+          sum_mask |= bits.bit_vector[idx];
+        }
+        // Handle the last case
+        bits.bit_vector[range] = bits.bit_vector[0] << local; 
+        sum_mask |= bits.bit_vector[range];
+        // Fill in everything else with zeros
+        for (unsigned idx = 0; idx < range; idx++)
+          bits.bit_vector[idx] = 0;
+      }
+      return *this;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline DispatchTLBitMask<MAX>& DispatchTLBitMask<MAX>::operator>>=(
+                                                                unsigned shift)
+    //-------------------------------------------------------------------------
+    {
+      unsigned range = shift >> 6;
+      unsigned local = shift & 0x3F;
+      sum_mask = 0;
+      if (!local)
+      {
+        // Fast case where we just have to move individual words
+        for (unsigned idx = 0; idx < (BIT_ELMTS-range); idx++)
+        {
+          bits.bit_vector[idx] = bits.bit_vector[idx+range];
+          sum_mask |= bits.bit_vector[idx];
+        }
+        // Fill in everything else with zeros
+        for (unsigned idx = (BIT_ELMTS-range); idx < (BIT_ELMTS); idx++)
+          bits.bit_vector[idx] = 0;
+      }
+      else
+      {
+        // Slow case with merging words, a single word has nothing to merge
+        if constexpr (BIT_ELMTS > 1)
+        {
+          for (unsigned idx = 0; idx < (BIT_ELMTS-(range+1)); idx++)
+          {
+            uint64_t right = bits.bit_vector[idx+range] >> local;
+            uint64_t left = bits.bit_vector[idx+range+1] << ((1 << 6) - local);
+            bits.bit_vector[idx] = left | right;
+            sum_mask |= bits.bit_vector[idx];
+          }
+        }
+        // Handle the last case
+        bits.bit_vector[BIT_ELMTS-(range+1)] = 
+                                        bits.bit_vector[BIT_ELMTS-1] >> local;
+        sum_mask |= bits.bit_vector[BIT_ELMTS-(range+1)];
+        // Fill in everything else with zeros
+        for (unsigned idx = (BIT_ELMTS-range); idx < BIT_ELMTS; idx++)
+          bits.bit_vector[idx] = 0;
+      }
+      return *this;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline uint64_t DispatchTLBitMask<MAX>::get_hash_key(void) const
+    //-------------------------------------------------------------------------
+    {
+      return sum_mask;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline const uint64_t* DispatchTLBitMask<MAX>::base(void) const
+    //-------------------------------------------------------------------------
+    {
+      return bits.bit_vector;
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX> template<typename ST>
+    inline void DispatchTLBitMask<MAX>::serialize(ST &rez) const
+    //-------------------------------------------------------------------------
+    {
+      rez.serialize(sum_mask);
+      rez.serialize(bits.bit_vector, (MAX/8));
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX> template<typename DT>
+    inline void DispatchTLBitMask<MAX>::deserialize(DT &derez)
+    //-------------------------------------------------------------------------
+    {
+      derez.deserialize(sum_mask);
+      derez.deserialize(bits.bit_vector, (MAX/8));
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX> template<typename FUNCTOR>
+    inline void DispatchTLBitMask<MAX>::map(FUNCTOR &functor) const
+    //-------------------------------------------------------------------------
+    {
+      for (unsigned idx = 0; idx < BIT_ELMTS; idx++)
+      {
+        if (bits.bit_vector[idx])
+        {
+          unsigned value = idx * ELEMENT_SIZE;
+          for (unsigned i = 0; i < ELEMENT_SIZE; i++, value++)
+            if (bits.bit_vector[idx] & (1ULL << i))
+              functor.apply(value);
+        }
+      }
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline char* DispatchTLBitMask<MAX>::to_string(void) const
+    //-------------------------------------------------------------------------
+    {
+      return BitMaskHelp::to_string(bits.bit_vector, MAX);
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline unsigned DispatchTLBitMask<MAX>::pop_count(void) const
+    //-------------------------------------------------------------------------
+    {
+      if (!sum_mask)
+        return 0;
+#ifndef VALGRIND
+      return BitMaskHelp::bit_kernels().pop_count(bits.bit_vector, BIT_ELMTS);
+#else
+      unsigned result = 0;
+      for (unsigned idx = 0; idx < MAX; idx++)
+      {
+        if (is_set(idx))
+          result++;
+      }
+      return result;
+#endif
+    }
+
+    //-------------------------------------------------------------------------
+    template<unsigned int MAX>
+    /*static*/ inline unsigned DispatchTLBitMask<MAX>::pop_count(
+                                            const DispatchTLBitMask<MAX> &mask)
+    //-------------------------------------------------------------------------
+    {
+      return mask.pop_count();
     }
-#endif // __ARM_NEON
 
     //-------------------------------------------------------------------------
     template<typename DT, unsigned BLOAT, bool BIDIR>
@@ -12079,6 +12079,7 @@ namespace Legion {
       context->add_nested_gc_ref(did);
       set_expr->add_nested_expression_reference(did);
       next_deferral_precondition.store(0);
+      version.store(0);
       if (replicate_logical_owner)
       {
         // If we've been told to replicate the logical owner space knowledge
@@ -12389,6 +12390,8 @@ namespace Legion {
       // Should only be here if we're the owner
       assert(is_logical_owner());
 #endif
+      if (!analysis.immutable)
+        version.fetch_add(1);
       bool check_migration = false;
       if (!partial_invalidations.empty()) 
       {
@@ -14374,6 +14377,7 @@ namespace Legion {
       {
         if (!(mask * partial_invalidations.get_valid_mask()))
         {
+          version.fetch_add(1);
           // Remove any partial invalidations with overlapping fields
           std::vector<IndexSpaceExpression*> to_delete;
           for (FieldMaskSet<IndexSpaceExpression>::iterator it =
@@ -19691,7 +19695,10 @@ namespace Legion {
 #endif
       // If we are the owner then we know this update is stale so ignore it
       if (!is_logical_owner())
+      {
         logical_owner_space = new_logical_owner;
+        version.fetch_add(1);
+      }
     }
 
     //--------------------------------------------------------------------------
@@ -19710,6 +19717,7 @@ namespace Legion {
         // If we make it here then we can finally mark ourselves the owner
         AutoLock eq(eq_lock);
         logical_owner_space = local_space;
+        version.fetch_add(1);
         if (replicated_owner_state != NULL)
         {
 #ifdef DEBUG_LEGION
@@ -20301,6 +20309,7 @@ namespace Legion {
        const bool expr_covers, const FieldMask &mask, bool record_invalidations)
     //--------------------------------------------------------------------------
     {
+      version.fetch_add(1);
       filter_valid_instances(expr, expr_covers, mask); 
       filter_reduction_instances(expr, expr_covers, mask); 
       filter_initialized_data(expr, expr_covers, mask);
@@ -20943,6 +20952,7 @@ namespace Legion {
                     false/*needs lock*/, forward_to_owner, unpack_references);
         return;
       }
+      version.fetch_add(1);
       if (!is_logical_owner() && forward_to_owner)
       {
         const RtUserEvent done_event = Runtime::create_rt_user_event();
@@ -3331,6 +3331,8 @@ namespace Legion {
       // Must be called while holding the lock
       inline bool is_logical_owner(void) const
         { return (local_space == logical_owner_space); }
+      // Changes any time the state of the set is mutated on this node
+      inline uint64_t get_version(void) const { return version.load(); }
     public:
       // From distributed collectable
       virtual void notify_invalid(void) { assert(false); }
@@ -3803,6 +3805,10 @@ namespace Legion {
       FieldMaskSet<CopyFillGuard>                       reduction_fill_guards;
       // An event to order to deferral tasks
       std::atomic<Realm::Event::id_t>                next_deferral_precondition;
+      // Version stamp that is bumped whenever the physical state of the
+      // set changes or the logical owner moves so that clients like trace
+      // condition sets can tell when they need to re-test the state
+      std::atomic<uint64_t>                             version;
     protected:
       // This node is the node which contains the valid state data
       AddressSpaceID                                    logical_owner_space;
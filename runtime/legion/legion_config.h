@@ -157,6 +157,13 @@
 #endif
 #endif
 
+// Future values up to this many bytes are stored directly inside of the
+// runtime's future instance objects instead of in a separate allocation
+// and are carried along by value in the messages that name the future
+#ifndef LEGION_MAX_INLINE_FUTURE_SIZE
+#define LEGION_MAX_INLINE_FUTURE_SIZE 64
+#endif
+
 #ifndef MAX_FIELDS // For backwards compatibility
 #ifndef LEGION_MAX_FIELDS
 #define LEGION_MAX_FIELDS         256 // must be a power of 2
@@ -167,6 +174,13 @@
 #endif
 #endif
 
+// With LEGION_SPARSE_FIELD_MASKS, the number of set fields a field mask can
+// hold inline (in units of pointer-sized words) before it switches to a
+// dense bit mask
+#ifndef LEGION_SPARSE_FIELD_MASK_BLOAT
+#define LEGION_SPARSE_FIELD_MASK_BLOAT 2
+#endif
+
 // Some default values
 
 // The maximum number of nodes to be run on
@@ -354,6 +368,35 @@
 #define LEGION_DEFAULT_MAX_REPLAY_PARALLELISM  (DEFAULT_MAX_REPLAY_PARALLELISM)
 #endif
 #endif
+// Number of point tasks that a slice creates at a time when it is
+// mapping and launching its points, zero creates them all up front.
+// Batching is off by default for now, enable it with -lg:point_batch
+#ifndef LEGION_DEFAULT_POINT_TASK_BATCH
+#define LEGION_DEFAULT_POINT_TASK_BATCH        0
+#endif
+// Maximum number of launch spaces and upper bounds for which a functional
+// projection functor will remember its results before starting over
+#ifndef LEGION_MAX_PROJECTION_CACHE_ENTRIES
+#define LEGION_MAX_PROJECTION_CACHE_ENTRIES    1024
+#endif
+// Maximum number of instructions grouped into a single schedulable
+// chunk when replaying templates with work stealing
+#ifndef LEGION_REPLAY_CHUNK_SIZE
+#define LEGION_REPLAY_CHUNK_SIZE               32
+#endif
+// Number of operations remembered when searching the operation
+// stream of a context for repeated sequences to trace automatically
+#ifndef LEGION_DEFAULT_AUTO_TRACE_WINDOW
+#define LEGION_DEFAULT_AUTO_TRACE_WINDOW       1024
+#endif
+// Minimum number of operations in an automatically detected trace
+#ifndef LEGION_DEFAULT_AUTO_TRACE_MIN_LENGTH
+#define LEGION_DEFAULT_AUTO_TRACE_MIN_LENGTH   5
+#endif
+// Maximum number of automatically detected traces in a context
+#ifndef LEGION_DEFAULT_AUTO_TRACE_MAX_TRACES
+#define LEGION_DEFAULT_AUTO_TRACE_MAX_TRACES   32
+#endif
 // The maximum size of active messages sent by the runtime in bytes
 // Note this value was picked based on making a tradeoff between
 // latency and bandwidth numbers on both Cray and Infiniband
@@ -367,6 +410,11 @@
 #define LEGION_DEFAULT_MAX_MESSAGE_SIZE        (DEFAULT_MAX_MESSAGE_SIZE)
 #endif
 #endif
+// Batches of messages on virtual channels with compression enabled
+// (see -lg:compress) are only compressed if they are at least this large
+#ifndef LEGION_DEFAULT_COMPRESSION_THRESHOLD
+#define LEGION_DEFAULT_COMPRESSION_THRESHOLD    4096
+#endif
 // Number of events to place in each GC epoch
 // Large counts improve efficiency but add latency to
 // garbage collection.  Smaller count reduce efficiency
@@ -452,6 +500,12 @@
 #define LEGION_NEW_TEMPLATE_WARNING_COUNT   8
 #endif
 
+// Number of new templates an automatically detected trace may 
+// record without any replays before the runtime stops using it
+#ifndef LEGION_AUTO_TRACE_RETIRE_COUNT
+#define LEGION_AUTO_TRACE_RETIRE_COUNT      4
+#endif
+
 // Initial offset for library IDs
 // Controls how many IDs are available for dynamic use
 #ifndef LEGION_INITIAL_LIBRARY_ID_OFFSET
@@ -1318,6 +1372,7 @@ typedef enum legion_error_t {
   ERROR_ILLEGAL_CONCURRENT_EXECUTION = 626,
   ERROR_MISSING_FILL_VALUE = 627,
   ERROR_ILLEGAL_CONCURRENT_TASK_BARRIER = 628,
+  ERROR_INVALID_SPY_FILE = 629,
 
 
   LEGION_WARNING_FUTURE_NONLEAF = 1000,
@@ -1414,6 +1469,8 @@ typedef enum legion_error_t {
   LEGION_FATAL_COLLECTIVE_PARTIAL_FIELD_OVERLAP = 2018,
   LEGION_FATAL_MORTON_TILING_FAILURE = 2019,
   LEGION_FATAL_NO_CRITICAL_PATH_DYNAMIC_COLLECTIVES = 2020,
+  LEGION_FATAL_COMPRESSION_FAILURE = 2021,
+  LEGION_FATAL_UNSUPPORTED_SPY_FORMAT = 2022,
   
 }  legion_error_t;
 
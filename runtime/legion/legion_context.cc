@@ -174,6 +174,8 @@ namespace Legion {
               true/*own allocation*/, resource.clone(), 
               FutureInstance::free_host_memory, executing_processor);
         }
+        else if (size <= LEGION_MAX_INLINE_FUTURE_SIZE)
+          instance = new FutureInstance(value, size);
         else
           instance = copy_to_future_inst(value, size);
       }
@@ -1290,7 +1292,7 @@ namespace Legion {
         deferred_mapped_comp_queue(CompletionQueue::NO_QUEUE),
         deferred_completion_comp_queue(CompletionQueue::NO_QUEUE),
         deferred_commit_comp_queue(CompletionQueue::NO_QUEUE),
-        current_trace(NULL), previous_trace(NULL),
+        current_trace(NULL), previous_trace(NULL), auto_tracer(NULL),
         physical_trace_replay_status(0),
         outstanding_subtasks(0), pending_subtasks(0), pending_frames(0),
         currently_active_context(false), outstanding_commit_task(false),
@@ -1298,7 +1300,7 @@ namespace Legion {
         current_mapping_fence_index(0), 
         current_execution_fence_event(exec_fence),
         current_execution_fence_index(0), last_implicit_creation(NULL),
-        last_implicit_creation_gen(0)
+        last_implicit_creation_gen(0), analyzing_in_parallel(false)
     //--------------------------------------------------------------------------
     {
       // Set some of the default values for a context
@@ -1315,6 +1317,9 @@ namespace Legion {
       context_configuration.max_templates_per_trace =
         LEGION_DEFAULT_MAX_TEMPLATES_PER_TRACE;
       context_configuration.mutable_priority = false;
+      if (runtime->auto_tracing && !runtime->no_tracing &&
+          !runtime->program_order_execution)
+        auto_tracer = new AutomaticTracer(this);
       // If we have an owner, clone our local fields from its context
       // and also compute the coordinates for this context in the task tree
       if (owner != NULL)
@@ -1351,6 +1356,8 @@ namespace Legion {
 #endif
       // At this point we can free our region tree context
       runtime->free_region_tree_context(tree_context);
+      if (auto_tracer != NULL)
+        delete auto_tracer;
       if (enqueue_task_comp_queue.exists())
         enqueue_task_comp_queue.destroy();
       if (distribute_task_comp_queue.exists())
@@ -8321,6 +8328,12 @@ namespace Legion {
         bool unordered, bool outermost)
     //--------------------------------------------------------------------------
     {
+      // See if the automatic tracer wants to buffer this operation while
+      // it determines whether it is part of a repeated sequence
+      if ((auto_tracer != NULL) && !unordered && outermost &&
+          (current_trace == NULL) && !auto_tracer->is_flushing() &&
+          auto_tracer->record_operation(op, dependences))
+        return true;
       LgPriority priority = LG_THROUGHPUT_WORK_PRIORITY; 
       // If this is ordered, we need to record this in the reorder buffer
       // and determine if we need to perform a window wait or not
@@ -8416,7 +8429,10 @@ namespace Legion {
         // Insert any unordered operations now as long as we aren't
         // doing program order execution, if we're doing program order
         // execution then we'll do that after running this operation
-        if (!commit_event.exists())
+        // We also hold them back while the automatic tracer is issuing
+        // operations that it buffered since they might come later
+        if (!commit_event.exists() &&
+            ((auto_tracer == NULL) || !auto_tracer->is_flushing()))
           insert_unordered_ops(d_lock);
       }
       if (issue_task)
@@ -8472,9 +8488,18 @@ namespace Legion {
           launch_next_op = dependence_queue.front();
       }
       // Perform our operations
-      for (std::vector<Operation*>::const_iterator it = 
-            to_perform.begin(); it != to_perform.end(); it++)
-        (*it)->execute_dependence_analysis();
+      bool parallel = runtime->parallel_logical_analysis &&
+        (to_perform.size() > 1) && (get_replication_id() == 0);
+#ifdef LEGION_SPY
+      // Legion Spy records all the operations since the last fence
+      parallel = false;
+#endif
+      if (parallel)
+        perform_parallel_dependence_analysis(to_perform);
+      else
+        for (std::vector<Operation*>::const_iterator it = 
+              to_perform.begin(); it != to_perform.end(); it++)
+          (*it)->execute_dependence_analysis();
       // Then launch the next task if needed
       if (launch_next_op != NULL)
       {
@@ -8485,6 +8510,108 @@ namespace Legion {
       }
     }
 
+    //--------------------------------------------------------------------------
+    void InnerContext::perform_parallel_dependence_analysis(
+                                     const std::vector<Operation*> &operations)
+    //--------------------------------------------------------------------------
+    {
+      unsigned index = 0;
+      while (index < operations.size())
+      {
+        // Operations that can't tell us which region trees they traverse
+        // get analyzed by themselves in program order
+        std::set<RegionTreeID> trees;
+        if (!operations[index]->record_analysis_trees(trees))
+        {
+          operations[index++]->execute_dependence_analysis();
+          continue;
+        }
+        // Sort the run of operations that do know their region trees into
+        // lanes of operations that share region trees, an operation that
+        // spans several lanes joins them together into one lane so that
+        // every region tree still sees its operations in program order
+        std::vector<std::vector<Operation*> > lanes;
+        std::map<RegionTreeID,unsigned> tree_lanes;
+        do
+        {
+          // Operations without any regions all share the same lane
+          if (trees.empty())
+            trees.insert(0);
+          unsigned lane = lanes.size();
+          for (std::set<RegionTreeID>::const_iterator it =
+                trees.begin(); it != trees.end(); it++)
+          {
+            std::map<RegionTreeID,unsigned>::const_iterator finder =
+              tree_lanes.find(*it);
+            if ((finder != tree_lanes.end()) && (finder->second < lane))
+              lane = finder->second;
+          }
+          if (lane == lanes.size())
+            lanes.resize(lane + 1);
+          for (std::set<RegionTreeID>::const_iterator it =
+                trees.begin(); it != trees.end(); it++)
+          {
+            std::map<RegionTreeID,unsigned>::const_iterator finder =
+              tree_lanes.find(*it);
+            if (finder == tree_lanes.end())
+            {
+              tree_lanes[*it] = lane;
+              continue;
+            }
+            const unsigned other = finder->second;
+            if (other == lane)
+              continue;
+            // Join the other lane into this one, the two lanes have no
+            // region trees in common so their operations can go in any
+            // order with respect to each other
+            lanes[lane].insert(lanes[lane].end(), 
+                lanes[other].begin(), lanes[other].end());
+            lanes[other].clear();
+            for (std::map<RegionTreeID,unsigned>::iterator tit =
+                  tree_lanes.begin(); tit != tree_lanes.end(); tit++)
+              if (tit->second == other)
+                tit->second = lane;
+          }
+          lanes[lane].push_back(operations[index++]);
+          trees.clear();
+        } while ((index < operations.size()) &&
+            operations[index]->record_analysis_trees(trees));
+        // Launch all but the first lane on other utility processors and
+        // then perform the first lane here before joining them all back up
+        std::vector<Operation*> *local = NULL;
+        std::vector<RtEvent> lanes_done;
+        for (std::vector<std::vector<Operation*> >::iterator it =
+              lanes.begin(); it != lanes.end(); it++)
+        {
+          if (it->empty())
+            continue;
+          if (local == NULL)
+          {
+            local = &(*it);
+            continue;
+          }
+          if (lanes_done.empty())
+            analyzing_in_parallel = true;
+          const RtUserEvent done = Runtime::create_rt_user_event();
+          ParallelDependenceArgs args(it->front(),
+              new std::vector<Operation*>(), done);
+          args.operations->swap(*it);
+          runtime->issue_runtime_meta_task(args, LG_THROUGHPUT_WORK_PRIORITY);
+          lanes_done.push_back(done);
+        }
+        for (std::vector<Operation*>::const_iterator it =
+              local->begin(); it != local->end(); it++)
+          (*it)->execute_dependence_analysis();
+        if (!lanes_done.empty())
+        {
+          const RtEvent wait_on = Runtime::merge_events(lanes_done);
+          if (wait_on.exists() && !wait_on.has_triggered())
+            wait_on.wait();
+          analyzing_in_parallel = false;
+        }
+      }
+    }
+
     //--------------------------------------------------------------------------
     template<typename T, typename ARGS, bool HAS_BOUND>
     void InnerContext::add_to_queue(QueueEntry<T> entry, LocalLock &lock,
@@ -9732,7 +9859,7 @@ namespace Legion {
                                 last_implicit_creation_gen);
 #else
         if (op->register_dependence(last_implicit_creation,
-                                    last_implicit_creation_gen))
+              last_implicit_creation_gen) && !analyzing_in_parallel)
           last_implicit_creation = NULL;
 #endif
       }
@@ -9763,7 +9890,7 @@ namespace Legion {
             current_mapping_fence_gen);
 #else
         if (op->register_dependence(current_mapping_fence, 
-              current_mapping_fence_gen))
+              current_mapping_fence_gen) && !analyzing_in_parallel)
           current_mapping_fence = NULL;
 #endif
       }
@@ -9959,6 +10086,20 @@ namespace Legion {
       log_run.debug("Beginning a trace in task %s (ID %lld)",
                     get_task_name(), get_unique_id());
 #endif
+      // Issue any operations buffered by the automatic tracer first
+      if (auto_tracer != NULL)
+        auto_tracer->flush();
+      begin_trace_internal(tid, logical_only, static_trace, trees,
+                           deprecated, provenance);
+    }
+
+    //--------------------------------------------------------------------------
+    void InnerContext::begin_trace_internal(TraceID tid, bool logical_only,
+        bool static_trace, const std::set<RegionTreeID> *trees,
+        bool deprecated, Provenance *provenance)
+    //--------------------------------------------------------------------------
+    {
+      if (runtime->no_physical_tracing) logical_only = true;
       // No need to hold the lock here, this is only ever called
       // by the one thread that is running the task.
       if (current_trace != NULL)
@@ -10057,6 +10198,14 @@ namespace Legion {
       log_run.debug("Ending a trace in task %s (ID %lld)",
                     get_task_name(), get_unique_id());
 #endif
+      end_trace_internal(tid, deprecated, provenance);
+    }
+
+    //--------------------------------------------------------------------------
+    void InnerContext::end_trace_internal(TraceID tid, bool deprecated,
+                                          Provenance *provenance)
+    //--------------------------------------------------------------------------
+    {
       if (current_trace == NULL)
         REPORT_LEGION_ERROR(ERROR_UMATCHED_END_TRACE,
           "Unmatched end trace for ID %d in task %s "
@@ -10084,6 +10233,10 @@ namespace Legion {
     void InnerContext::record_blocking_call(uint64_t blocking_index)
     //--------------------------------------------------------------------------
     {
+      // Any operations that the automatic tracer has buffered must be
+      // issued before we block since we might be waiting on them
+      if ((auto_tracer != NULL) && (implicit_context == this))
+        auto_tracer->flush();
       // It's only a blocking call if the wait occurs from an operation 
       // inside the trace so we can eliminate any waits from futures that
       // were produced before the trace or in the case of inline mappings
@@ -10105,6 +10258,14 @@ namespace Legion {
       }
     }
 
+    //--------------------------------------------------------------------------
+    void InnerContext::progress_automatic_trace(void)
+    //--------------------------------------------------------------------------
+    {
+      if (auto_tracer != NULL)
+        auto_tracer->flush();
+    }
+
     //--------------------------------------------------------------------------
     void InnerContext::wait_on_future(FutureImpl *future, RtEvent ready)
     //--------------------------------------------------------------------------
@@ -11766,6 +11927,9 @@ namespace Legion {
       }
       else // implicit task
         realm_done_event = effects;
+      // Issue any operations still buffered by the automatic tracer
+      if (auto_tracer != NULL)
+        auto_tracer->flush();
       // Check to see if we have any unordered operations that we need to inject
       // This has to be done before we do any deletions to make sure that all
       // these unordered operations are actually issued before deletions
@@ -12008,6 +12172,20 @@ namespace Legion {
       dargs->context->process_dependence_stage();
     }
 
+    //--------------------------------------------------------------------------
+    /*static*/ void InnerContext::handle_parallel_dependence_stage(
+                                                               const void *args)
+    //--------------------------------------------------------------------------
+    {
+      const ParallelDependenceArgs *pargs = 
+        (const ParallelDependenceArgs*)args;
+      for (std::vector<Operation*>::const_iterator it =
+            pargs->operations->begin(); it != pargs->operations->end(); it++)
+        (*it)->execute_dependence_analysis();
+      delete pargs->operations;
+      Runtime::trigger_event(pargs->done_event);
+    }
+
     //--------------------------------------------------------------------------
     /*static*/ void InnerContext::handle_ready_queue(const void *args)
     //--------------------------------------------------------------------------
@@ -12518,6 +12696,16 @@ namespace Legion {
           shard_collective_radix, shard_collective_log_radix,
           shard_collective_stages, shard_collective_participating_shards,
           shard_collective_last_radix);
+      // The automatic tracer holds operations back until something flushes
+      // it, but an application polling futures for readiness does so at
+      // different times on each shard so the shards could not agree on
+      // when to flush. Rather than let a poll loop spin forever waiting
+      // on a buffered operation, don't buffer operations in shards.
+      if (auto_tracer != NULL)
+      {
+        delete auto_tracer;
+        auto_tracer = NULL;
+      }
     }
 
     //--------------------------------------------------------------------------
@@ -19697,11 +19885,24 @@ namespace Legion {
           break;
       }
       if (runtime->no_tracing) return;
-      if (runtime->no_physical_tracing) logical_only = true;
 #ifdef DEBUG_LEGION
       log_run.debug("Beginning a trace in task %s (ID %lld)",
                     get_task_name(), get_unique_id());
 #endif
+      // Issue any operations buffered by the automatic tracer first
+      if (auto_tracer != NULL)
+        auto_tracer->flush();
+      begin_trace_internal(tid, logical_only, static_trace, trees,
+                           deprecated, provenance);
+    }
+
+    //--------------------------------------------------------------------------
+    void ReplicateContext::begin_trace_internal(TraceID tid, bool logical_only,
+                        bool static_trace, const std::set<RegionTreeID> *trees,
+                        bool deprecated, Provenance *provenance)
+    //--------------------------------------------------------------------------
+    {
+      if (runtime->no_physical_tracing) logical_only = true;
       // No need to hold the lock here, this is only ever called
       // by the one thread that is running the task.
       if (current_trace != NULL)
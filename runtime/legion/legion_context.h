@@ -512,6 +512,7 @@ namespace Legion {
       virtual void record_blocking_call(uint64_t future_coordinate) = 0;
       virtual void wait_on_future(FutureImpl *future, RtEvent ready) = 0;
       virtual void wait_on_future_map(FutureMapImpl *map, RtEvent ready) = 0;
+      virtual void progress_automatic_trace(void) { }
     public:
       // Override by RemoteTask and TopLevelTask
       virtual InnerContext* find_top_context(InnerContext *previous = NULL) = 0;
@@ -754,6 +755,19 @@ namespace Legion {
       public:
         InnerContext *const context;
       }; 
+      struct ParallelDependenceArgs : 
+        public LgTaskArgs<ParallelDependenceArgs> {
+      public:
+        static const LgTaskID TASK_ID = LG_PARALLEL_DEPENDENCE_ID;
+      public:
+        ParallelDependenceArgs(Operation *op, std::vector<Operation*> *ops,
+                               RtUserEvent done)
+          : LgTaskArgs<ParallelDependenceArgs>(op->get_unique_op_id()),
+            operations(ops), done_event(done) { }
+      public:
+        std::vector<Operation*> *const operations;
+        const RtUserEvent done_event;
+      };
       struct TriggerReadyArgs : public LgTaskArgs<TriggerReadyArgs> {
       public:
         static const LgTaskID TASK_ID = LG_TRIGGER_READY_ID;
@@ -1562,6 +1576,8 @@ namespace Legion {
           bool unordered = false, bool outermost = true);
       virtual FenceOp* initialize_trace_completion(Provenance *prov);
       void process_dependence_stage(void);
+      void perform_parallel_dependence_analysis(
+                                  const std::vector<Operation*> &operations);
     public:
       template<typename T, typename ARGS, bool HAS_BOUNDS>
       void add_to_queue(QueueEntry<T> entry, LocalLock &lock,
@@ -1641,6 +1657,14 @@ namespace Legion {
       virtual void record_blocking_call(uint64_t future_coordinate);
       virtual void wait_on_future(FutureImpl *future, RtEvent ready);
       virtual void wait_on_future_map(FutureMapImpl *map, RtEvent ready);
+      virtual void progress_automatic_trace(void);
+    protected:
+      friend class AutomaticTracer;
+      virtual void begin_trace_internal(TraceID tid, bool logical_only,
+          bool static_trace, const std::set<RegionTreeID> *managed, bool dep,
+          Provenance *provenance);
+      void end_trace_internal(TraceID tid, bool deprecated,
+                              Provenance *provenance);
     public:
       void increment_outstanding(void);
       void decrement_outstanding(void);
@@ -1783,6 +1807,7 @@ namespace Legion {
     public:
       static void handle_prepipeline_stage(const void *args);
       static void handle_dependence_stage(const void *args);
+      static void handle_parallel_dependence_stage(const void *args);
       static void handle_ready_queue(const void *args);
       static void handle_enqueue_task_queue(const void *args);
       static void handle_distribute_task_queue(const void *args);
@@ -1985,6 +2010,8 @@ namespace Legion {
       LogicalTrace *current_trace;
       LogicalTrace *previous_trace;
       uint64_t current_trace_blocking_index;
+      // Only valid if automatic tracing is enabled
+      AutomaticTracer *auto_tracer;
       // ID is either 0 for not replaying, 1 for replaying not idempotent, 
       // 2 for replaying idempotent or the event id for signaling that 
       // the status isn't ready 
@@ -2023,6 +2050,10 @@ namespace Legion {
       // is a general operation class
       Operation *last_implicit_creation;
       GenerationID last_implicit_creation_gen;
+      // Set while the dependence stage is analyzing operations on 
+      // disjoint region trees in parallel so that we don't prune
+      // the fence and implicit creation operations above
+      bool analyzing_in_parallel;
     protected:
       // For managing changing task priorities
       TaskPriority current_priority;
@@ -2911,6 +2942,11 @@ namespace Legion {
                              Provenance *provenance);
       virtual void wait_on_future(FutureImpl *future, RtEvent ready);
       virtual void wait_on_future_map(FutureMapImpl *map, RtEvent ready);
+    protected:
+      virtual void begin_trace_internal(TraceID tid, bool logical_only,
+          bool static_trace, const std::set<RegionTreeID> *managed, bool dep,
+          Provenance *provenance);
+    public:
       virtual void end_task(const void *res, size_t res_size, bool owned,
                       PhysicalInstance inst, FutureFunctor *callback_future,
                       const Realm::ExternalInstanceResource *resource,
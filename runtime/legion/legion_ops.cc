@@ -1352,6 +1352,21 @@ namespace Legion {
       return LogicalAnalysis::NO_OUTPUT_OFFSET;
     }
 
+    //--------------------------------------------------------------------------
+    bool Operation::record_requirement_trees(
+                                        std::set<RegionTreeID> &trees) const
+    //--------------------------------------------------------------------------
+    {
+      // Must epoch and traced operations depend on state that is shared
+      // across all the operations in the context
+      if ((must_epoch != NULL) || (trace != NULL))
+        return false;
+      const size_t num_regions = get_region_count();
+      for (unsigned idx = 0; idx < num_regions; idx++)
+        trees.insert(get_requirement(idx).parent.get_tree_id());
+      return true;
+    }
+
     //--------------------------------------------------------------------------
     Mappable* Operation::get_mappable(void)
     //--------------------------------------------------------------------------
@@ -1689,6 +1704,14 @@ namespace Legion {
       // Nothing to do in the base case
     }
 
+    //--------------------------------------------------------------------------
+    bool Operation::record_analysis_trees(std::set<RegionTreeID> &trees) const
+    //--------------------------------------------------------------------------
+    {
+      // By default we don't know what our analysis touches
+      return false;
+    }
+
     //--------------------------------------------------------------------------
     void Operation::trigger_ready(void)
     //--------------------------------------------------------------------------
@@ -6524,6 +6547,16 @@ namespace Legion {
       req_vector_reduce_restore(dst_requirements, changed_idxs);
     }
 
+    //--------------------------------------------------------------------------
+    bool CopyOp::record_analysis_trees(std::set<RegionTreeID> &trees) const
+    //--------------------------------------------------------------------------
+    {
+      // Phase barrier analysis has to be done in program order
+      if (!wait_barriers.empty() || !arrive_barriers.empty())
+        return false;
+      return record_requirement_trees(trees);
+    }
+
     //--------------------------------------------------------------------------
     void CopyOp::perform_base_dependence_analysis(bool permit_projection)
     //--------------------------------------------------------------------------
@@ -13698,9 +13731,7 @@ namespace Legion {
 #ifdef DEBUG_LEGION
         assert(!ready.exists());
 #endif
-        FutureInstance *result = 
-          FutureInstance::create_local(&value, sizeof(value), false/*own*/);
-        future.impl->set_result(ApEvent::NO_AP_EVENT, result);
+        future.impl->set_local(&value, sizeof(value));
       }
       else
         predicate.impl->set_predicate(
@@ -18111,6 +18142,16 @@ namespace Legion {
       analyze_region_requirements();
     }
 
+    //--------------------------------------------------------------------------
+    bool FillOp::record_analysis_trees(std::set<RegionTreeID> &trees) const
+    //--------------------------------------------------------------------------
+    {
+      // Phase barrier analysis has to be done in program order
+      if (!wait_barriers.empty() || !arrive_barriers.empty())
+        return false;
+      return record_requirement_trees(trees);
+    }
+
     //--------------------------------------------------------------------------
     void FillOp::perform_base_dependence_analysis(void)
     //--------------------------------------------------------------------------
@@ -390,6 +390,7 @@ namespace Legion {
         IndexSpaceNode *launch_space = nullptr,
         ShardingFunction *func = nullptr,
         IndexSpace shard_space = IndexSpace::NO_SPACE);
+      bool record_requirement_trees(std::set<RegionTreeID> &trees) const;
     public:
       inline GenerationID get_generation(void) const { return gen; }
       RtEvent get_mapped_event(void);
@@ -465,6 +466,10 @@ namespace Legion {
       virtual void trigger_prepipeline_stage(void);
       // The function to call for depence analysis
       virtual void trigger_dependence_analysis(void);
+      // Record the region trees traversed by our dependence analysis,
+      // return false if we have to be analyzed in program order with
+      // respect to all other operations in the context
+      virtual bool record_analysis_trees(std::set<RegionTreeID> &trees) const;
       // The function to call when the operation has all its
       // mapping depenedences satisfied
       // In general put this on the ready queue so the runtime
@@ -1415,6 +1420,7 @@ namespace Legion {
       virtual bool has_prepipeline_stage(void) const { return true; }
       virtual void trigger_prepipeline_stage(void);
       virtual void trigger_dependence_analysis(void);
+      virtual bool record_analysis_trees(std::set<RegionTreeID> &trees) const;
       virtual void trigger_ready(void);
       virtual void trigger_mapping(void);
       virtual void trigger_complete(ApEvent complete);
@@ -3640,6 +3646,7 @@ namespace Legion {
       virtual bool has_prepipeline_stage(void) const { return true; }
       virtual void trigger_prepipeline_stage(void);
       virtual void trigger_dependence_analysis(void);
+      virtual bool record_analysis_trees(std::set<RegionTreeID> &trees) const;
       virtual void trigger_ready(void);
       virtual void trigger_mapping(void);
       virtual void trigger_complete(ApEvent effects_done);
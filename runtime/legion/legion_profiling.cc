@@ -1514,6 +1514,40 @@ namespace Legion {
       owner->update_footprint(sizeof(ApplicationCallInfo), this);
     }
 
+    //--------------------------------------------------------------------------
+    void LegionProfInstance::record_trace_replay(TraceID tid, long long start,
+                    long long stop, long long critical_path, unsigned chunks,
+                    unsigned steals)
+    //--------------------------------------------------------------------------
+    {
+      Processor current = Processor::get_executing_processor();
+      if (!current.exists())
+      {
+        // Ignore replays that happen from outside threads
+        if (implicit_context->owner_task == NULL)
+          return;
+        // Implicit top-level task case where we're not actually running
+        // on a Realm processor so we need to get the proxy processor
+        // for the context instead
+        current = implicit_context->get_executing_processor();
+      }
+      process_proc_desc(current);
+      // Replays are not filtered by the call threshold since the critical
+      // path statistics are interesting even for short replays
+      trace_replay_infos.emplace_back(TraceReplayInfo());
+      TraceReplayInfo &info = trace_replay_infos.back();
+      info.kind = PHYSICAL_TRACE_REPLAY_CALL;
+      info.trace_id = tid;
+      info.start = start;
+      info.stop = stop;
+      info.critical_path = critical_path;
+      info.chunks = chunks;
+      info.steals = steals;
+      info.proc_id = current.id;
+      info.finish_event = implicit_fevent;
+      owner->update_footprint(sizeof(TraceReplayInfo), this);
+    }
+
     //--------------------------------------------------------------------------
     void LegionProfInstance::record_event_wait(LgEvent event,
                                                Realm::Backtrace &bt)
@@ -1746,6 +1780,11 @@ namespace Legion {
       {
         serializer->serialize(*it);
       }
+      for (std::deque<TraceReplayInfo>::const_iterator it =
+            trace_replay_infos.begin(); it != trace_replay_infos.end(); it++)
+      {
+        serializer->serialize(*it);
+      }
       for (std::deque<EventWaitInfo>::const_iterator it =
             event_wait_infos.begin(); it !=
             event_wait_infos.end(); it++)
@@ -2134,6 +2173,16 @@ namespace Legion {
         if (t_curr >= t_stop)
           return diff;
       }
+      while (!trace_replay_infos.empty())
+      {
+        TraceReplayInfo &front = trace_replay_infos.front();
+        serializer->serialize(front);
+        diff += sizeof(front);
+        trace_replay_infos.pop_front();
+        const long long t_curr = Realm::Clock::current_time_in_microseconds();
+        if (t_curr >= t_stop)
+          return diff;
+      }
       while (!event_wait_infos.empty())
       {
         EventWaitInfo &info = event_wait_infos.front();
@@ -2600,6 +2649,7 @@ namespace Legion {
       info.critical = critical;
       Realm::ProfilingRequest &req = requests.add_request(target_proc,
                 LG_LEGION_PROFILING_ID, &info, sizeof(info), LG_MIN_PRIORITY);
+      req.allow_batching();
       req.add_measurement<
                 Realm::ProfilingMeasurements::OperationTimeline>();
       req.add_measurement<
@@ -2628,6 +2678,7 @@ namespace Legion {
       info.critical = critical;
       Realm::ProfilingRequest &req = requests.add_request(target_proc,
                 LG_LEGION_PROFILING_ID, &info, sizeof(info), LG_MIN_PRIORITY);
+      req.allow_batching();
       req.add_measurement<
                 Realm::ProfilingMeasurements::OperationTimeline>();
       req.add_measurement<
@@ -2657,6 +2708,7 @@ namespace Legion {
       info.extra.spawn_time = Realm::Clock::current_time_in_nanoseconds();
       Realm::ProfilingRequest &req = requests.add_request(remote_target,
                 LG_LEGION_PROFILING_ID, &info, sizeof(info), LG_MIN_PRIORITY);
+      req.allow_batching();
       req.add_measurement<
                 Realm::ProfilingMeasurements::OperationTimeline>();
       req.add_measurement<
@@ -2688,6 +2740,7 @@ namespace Legion {
       info.extra.closure = closure;
       Realm::ProfilingRequest &req = requests.add_request(target_proc,
                 LG_LEGION_PROFILING_ID, &info, sizeof(info), LG_MIN_PRIORITY);
+      req.allow_batching();
       req.add_measurement<
                 Realm::ProfilingMeasurements::OperationTimeline>();
       req.add_measurement<
@@ -2718,6 +2771,7 @@ namespace Legion {
       info.extra.closure = closure;
       Realm::ProfilingRequest &req = requests.add_request(target_proc,
                 LG_LEGION_PROFILING_ID, &info, sizeof(info), LG_MIN_PRIORITY);
+      req.allow_batching();
       req.add_measurement<
                 Realm::ProfilingMeasurements::OperationTimeline>();
       req.add_measurement<
@@ -2745,6 +2799,7 @@ namespace Legion {
       // right away - the Timeline doesn't come until we delete the instance
       Realm::ProfilingRequest &req = requests.add_request(target_proc,
                  LG_LEGION_PROFILING_ID, &info, sizeof(info), LG_MIN_PRIORITY);
+      req.allow_batching();
       req.add_measurement<
                  Realm::ProfilingMeasurements::InstanceMemoryUsage>();
       req.add_measurement<
@@ -2781,6 +2836,7 @@ namespace Legion {
       Realm::ProfilingRequest &req = requests.add_request((target_proc.exists())
                         ? target_proc : Processor::get_executing_processor(),
                         LG_LEGION_PROFILING_ID, &info, sizeof(info));
+      req.allow_batching();
       req.add_measurement<
                   Realm::ProfilingMeasurements::OperationTimeline>();
       req.add_measurement<
@@ -2803,6 +2859,7 @@ namespace Legion {
       info.critical = critical;
       Realm::ProfilingRequest &req = requests.add_request(target_proc,
                 LG_LEGION_PROFILING_ID, &info, sizeof(info), LG_MIN_PRIORITY);
+      req.allow_batching();
       req.add_measurement<
                 Realm::ProfilingMeasurements::OperationTimeline>();
       req.add_measurement<
@@ -2828,6 +2885,7 @@ namespace Legion {
       info.critical = critical;
       Realm::ProfilingRequest &req = requests.add_request(target_proc,
                 LG_LEGION_PROFILING_ID, &info, sizeof(info), LG_MIN_PRIORITY);
+      req.allow_batching();
       req.add_measurement<
                 Realm::ProfilingMeasurements::OperationTimeline>();
       req.add_measurement<
@@ -2859,6 +2917,7 @@ namespace Legion {
       info.extra.closure = closure;
       Realm::ProfilingRequest &req = requests.add_request(target_proc,
                 LG_LEGION_PROFILING_ID, &info, sizeof(info), LG_MIN_PRIORITY);
+      req.allow_batching();
       req.add_measurement<
                 Realm::ProfilingMeasurements::OperationTimeline>();
       req.add_measurement<
@@ -2889,6 +2948,7 @@ namespace Legion {
       info.extra.closure = closure;
       Realm::ProfilingRequest &req = requests.add_request(target_proc,
                 LG_LEGION_PROFILING_ID, &info, sizeof(info), LG_MIN_PRIORITY);
+      req.allow_batching();
       req.add_measurement<
                 Realm::ProfilingMeasurements::OperationTimeline>();
       req.add_measurement<
@@ -2916,6 +2976,7 @@ namespace Legion {
       // right away - the Timeline doesn't come until we delete the instance
       Realm::ProfilingRequest &req = requests.add_request(target_proc,
                  LG_LEGION_PROFILING_ID, &info, sizeof(info), LG_MIN_PRIORITY);
+      req.allow_batching();
       req.add_measurement<
                  Realm::ProfilingMeasurements::InstanceMemoryUsage>();
       req.add_measurement<
@@ -2940,6 +3001,7 @@ namespace Legion {
       info.critical = critical;
       Realm::ProfilingRequest &req = requests.add_request(target_proc,
                   LG_LEGION_PROFILING_ID, &info, sizeof(info), LG_MIN_PRIORITY);
+      req.allow_batching();
       req.add_measurement<
                   Realm::ProfilingMeasurements::OperationTimeline>();
       req.add_measurement<
@@ -2996,6 +3058,7 @@ namespace Legion {
       Realm::ProfilingRequestSet requests;
       Realm::ProfilingRequest &req = requests.add_request(target_proc,
           LG_LEGION_PROFILING_ID, &info, sizeof(info), LG_LOW_PRIORITY);
+      req.allow_batching();
       req.add_measurement<Realm::ProfilingMeasurements::OperationStatus>();
       // Launch a no-op task with low priority just to get a profiling
       // response back once the barrier has triggered. This will also
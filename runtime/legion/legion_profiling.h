@@ -500,6 +500,17 @@ namespace Legion {
         ProcID proc_id;
         LgEvent finish_event;
       }; 
+      struct TraceReplayInfo {
+      public:
+        RuntimeCallKind kind;
+        TraceID trace_id;
+        timestamp_t start, stop;
+        // Length of the longest chain of dependent chunks in the replay
+        timestamp_t critical_path;
+        unsigned chunks, steals;
+        ProcID proc_id;
+        LgEvent finish_event;
+      };
       struct EventWaitInfo {
       public:
         ProcID proc_id;
@@ -686,6 +697,9 @@ namespace Legion {
                                timestamp_t stop);
       void record_application_range(ProvenanceID pid,
                                     timestamp_t start, timestamp_t stop);
+      void record_trace_replay(TraceID tid, timestamp_t start,
+          timestamp_t stop, timestamp_t critical_path, unsigned chunks,
+          unsigned steals);
       void record_event_wait(LgEvent event, Realm::Backtrace &bt);
     public:
       void record_proftask(Processor p, UniqueID op_id, timestamp_t start,
@@ -727,6 +741,7 @@ namespace Legion {
       std::deque<MapperCallInfo> mapper_call_infos;
       std::deque<RuntimeCallInfo> runtime_call_infos;
       std::deque<ApplicationCallInfo> application_call_infos;
+      std::deque<TraceReplayInfo> trace_replay_infos;
       std::deque<EventWaitInfo> event_wait_infos;
       std::deque<EventMergerInfo> event_merger_infos;
       std::deque<EventTriggerInfo> event_trigger_infos;
@@ -494,6 +494,19 @@ namespace Legion {
          << "fevent:unsigned long long:" << sizeof(LgEvent)
          << "}" << std::endl;
 
+      ss << "TraceReplayInfo {"
+         << "id:" << TRACE_REPLAY_INFO_ID                      << delim
+         << "kind:RuntimeCallKind:" << sizeof(RuntimeCallKind) << delim
+         << "trace_id:TraceID:"     << sizeof(TraceID)         << delim
+         << "start:timestamp_t:"    << sizeof(timestamp_t)     << delim
+         << "stop:timestamp_t:"     << sizeof(timestamp_t)     << delim
+         << "critical_path:timestamp_t:" << sizeof(timestamp_t) << delim
+         << "chunks:unsigned:"      << sizeof(unsigned)        << delim
+         << "steals:unsigned:"      << sizeof(unsigned)        << delim
+         << "proc_id:ProcID:"       << sizeof(ProcID)          << delim
+         << "fevent:unsigned long long:" << sizeof(LgEvent)
+         << "}" << std::endl;
+
       ss << "BacktraceDesc {"
          << "id:" << BACKTRACE_DESC_ID                                       << delim
          << "backtrace_id:unsigned long long:" << sizeof(unsigned long long) << delim
@@ -1352,6 +1365,33 @@ namespace Legion {
                 sizeof(application_call_info.finish_event));
     }
 
+    //--------------------------------------------------------------------------
+    void LegionProfBinarySerializer::serialize(
+                   const LegionProfInstance::TraceReplayInfo& trace_replay_info)
+    //--------------------------------------------------------------------------
+    {
+      int ID = TRACE_REPLAY_INFO_ID;
+      lp_fwrite(f, (char*)&ID, sizeof(ID));
+      lp_fwrite(f, (char*)&(trace_replay_info.kind),
+                sizeof(trace_replay_info.kind));
+      lp_fwrite(f, (char*)&(trace_replay_info.trace_id),
+                sizeof(trace_replay_info.trace_id));
+      lp_fwrite(f, (char*)&(trace_replay_info.start),
+                sizeof(trace_replay_info.start));
+      lp_fwrite(f, (char*)&(trace_replay_info.stop),
+                sizeof(trace_replay_info.stop));
+      lp_fwrite(f, (char*)&(trace_replay_info.critical_path),
+                sizeof(trace_replay_info.critical_path));
+      lp_fwrite(f, (char*)&(trace_replay_info.chunks),
+                sizeof(trace_replay_info.chunks));
+      lp_fwrite(f, (char*)&(trace_replay_info.steals),
+                sizeof(trace_replay_info.steals));
+      lp_fwrite(f, (char*)&(trace_replay_info.proc_id),
+                sizeof(trace_replay_info.proc_id));
+      lp_fwrite(f, (char*)&(trace_replay_info.finish_event),
+                sizeof(trace_replay_info.finish_event));
+    }
+
     //--------------------------------------------------------------------------
     void LegionProfBinarySerializer::serialize(
                                       const LegionProfDesc::ProcDesc& proc_desc)
@@ -2337,6 +2377,20 @@ namespace Legion {
                      application_call_info.finish_event.id);
     }
 
+    //--------------------------------------------------------------------------
+    void LegionProfASCIISerializer::serialize(
+                   const LegionProfInstance::TraceReplayInfo& trace_replay_info)
+    //--------------------------------------------------------------------------
+    {
+      log_prof.print("Prof Trace Replay Info %u %u " IDFMT
+                     " %llu %llu %llu %u %u " IDFMT, trace_replay_info.kind,
+                     trace_replay_info.trace_id,
+                     trace_replay_info.proc_id, trace_replay_info.start,
+                     trace_replay_info.stop, trace_replay_info.critical_path,
+                     trace_replay_info.chunks, trace_replay_info.steals,
+                     trace_replay_info.finish_event.id);
+    }
+
     //--------------------------------------------------------------------------
     void LegionProfASCIISerializer::serialize(
                                  const LegionProfDesc::ProcDesc &proc_desc)
@@ -95,6 +95,7 @@ namespace Legion {
       virtual void serialize(const LegionProfInstance::MapperCallInfo&) = 0;
       virtual void serialize(const LegionProfInstance::RuntimeCallInfo&) = 0;
       virtual void serialize(const LegionProfInstance::ApplicationCallInfo&) = 0;
+      virtual void serialize(const LegionProfInstance::TraceReplayInfo&) = 0;
       virtual void serialize(const LegionProfInstance::GPUTaskInfo&) = 0;
       virtual void serialize(const LegionProfInstance::CopyInstInfo&,
                              const LegionProfInstance::CopyInfo&) = 0;
@@ -172,6 +173,7 @@ namespace Legion {
       void serialize(const LegionProfInstance::MapperCallInfo&);
       void serialize(const LegionProfInstance::RuntimeCallInfo&);
       void serialize(const LegionProfInstance::ApplicationCallInfo&);
+      void serialize(const LegionProfInstance::TraceReplayInfo&);
       void serialize(const LegionProfInstance::GPUTaskInfo&);
       void serialize(const LegionProfInstance::CopyInstInfo&,
                      const LegionProfInstance::CopyInfo&);
@@ -225,6 +227,7 @@ namespace Legion {
         MAPPER_CALL_INFO_ID,
         RUNTIME_CALL_INFO_ID,
         APPLICATION_CALL_INFO_ID,
+        TRACE_REPLAY_INFO_ID,
         IMPLICIT_TASK_INFO_ID,
         GPU_TASK_INFO_ID,
         PROC_MEM_DESC_ID,
@@ -317,6 +320,7 @@ namespace Legion {
       void serialize(const LegionProfInstance::MapperCallInfo&);
       void serialize(const LegionProfInstance::RuntimeCallInfo&);
       void serialize(const LegionProfInstance::ApplicationCallInfo&);
+      void serialize(const LegionProfInstance::TraceReplayInfo&);
       void serialize(const LegionProfInstance::GPUTaskInfo&);
       void serialize(const LegionProfInstance::CopyInstInfo&,
                      const LegionProfInstance::CopyInfo&);
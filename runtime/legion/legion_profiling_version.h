@@ -1 +1 @@
-1007
+1008
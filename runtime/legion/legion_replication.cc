@@ -9347,7 +9347,7 @@ namespace Legion {
         remote_constituents((mapping == NULL) ? 0 : 
             mapping->count_children(owner_space, local_space)),
         top_level_task(top), isomorphic_points(iso), control_replicated(cr),
-        address_spaces(NULL), local_startup_complete(0),
+        address_spaces(NULL), shard_hierarchy(NULL), local_startup_complete(0),
         remote_startup_complete(0), local_mapping_complete(0),
         remote_mapping_complete(0), trigger_local_complete(0),
         trigger_remote_complete(0), trigger_local_commit(0),
@@ -9404,6 +9404,8 @@ namespace Legion {
         callback_barrier.destroy_barrier();
       if ((address_spaces != NULL) && address_spaces->remove_reference())
         delete address_spaces;
+      if (shard_hierarchy != NULL)
+        delete shard_hierarchy;
 #ifdef DEBUG_LEGION
       assert(created_equivalence_sets.empty());
 #endif
@@ -9563,14 +9565,61 @@ namespace Legion {
       address_spaces->resize(shard_mapping.size());
       for (unsigned idx = 0; idx < shard_mapping.size(); idx++)
         (*address_spaces)[idx] = shard_mapping[idx].address_space();
-      // Also initialize the collective parameters
-      // We just need the collective radix, but use the existing routine
-      int collective_radix = runtime->legion_collective_radix;
-      int collective_log_radix, collective_stages;
-      int participating_spaces, collective_last_radix;
-      configure_collective_settings(shard_mapping.size(),runtime->address_space,
-          collective_radix, collective_log_radix, collective_stages,
-          participating_spaces, collective_last_radix);
+      compute_shard_hierarchy();
+    }
+
+    //--------------------------------------------------------------------------
+    void ShardManager::compute_shard_hierarchy(void)
+    //--------------------------------------------------------------------------
+    {
+#ifdef DEBUG_LEGION
+      assert(shard_hierarchy == NULL);
+#endif
+      if (runtime->flat_shard_collectives || (total_shards <= 2))
+        return;
+      // The lowest shard on each address space is the leader for it
+      std::map<AddressSpaceID,ShardID> space_leaders;
+      for (ShardID shard = 0; shard < total_shards; shard++)
+        space_leaders.insert(
+            std::make_pair((*address_spaces)[shard], shard));
+      // If all the shards are on one address space or each shard has its
+      // own address space then there is no point in having a hierarchy
+      if ((space_leaders.size() == 1) || 
+          (space_leaders.size() == total_shards))
+        return;
+      shard_hierarchy = new ShardHierarchy();
+      shard_hierarchy->leaders.reserve(space_leaders.size());
+      for (std::map<AddressSpaceID,ShardID>::const_iterator it =
+            space_leaders.begin(); it != space_leaders.end(); it++)
+        shard_hierarchy->leaders.push_back(it->second);
+      std::sort(shard_hierarchy->leaders.begin(), 
+                shard_hierarchy->leaders.end());
+      shard_hierarchy->radix = runtime->legion_collective_radix;
+      configure_collective_settings(shard_hierarchy->leaders.size(),
+          0/*local index*/, shard_hierarchy->radix, shard_hierarchy->log_radix,
+          shard_hierarchy->stages, shard_hierarchy->participating_leaders,
+          shard_hierarchy->last_radix);
+      // Shards go through the leader for their address space and 
+      // leaders that didn't make it into the butterfly go through one
+      // that did so each address space only sends one message to
+      // another address space before the butterfly starts
+      shard_hierarchy->parents.resize(total_shards);
+      for (ShardID shard = 0; shard < total_shards; shard++)
+      {
+        ShardID parent = space_leaders[(*address_spaces)[shard]];
+        if (parent == shard)
+        {
+          const unsigned leader_index = std::distance(
+              shard_hierarchy->leaders.begin(), std::lower_bound(
+                shard_hierarchy->leaders.begin(), 
+                shard_hierarchy->leaders.end(), shard));
+          parent = shard_hierarchy->leaders[
+            leader_index % shard_hierarchy->participating_leaders];
+        }
+        shard_hierarchy->parents[shard] = parent;
+        if (parent != shard)
+          shard_hierarchy->children[parent].push_back(shard);
+      }
     }
 
     //--------------------------------------------------------------------------
@@ -12761,13 +12810,15 @@ namespace Legion {
             ctx->get_shard_collective_participating_shards()),
         shard_collective_last_radix(ctx->get_shard_collective_last_radix()),
         participating(local_index < shard_collective_participating_shards),
-        reorder_stages(NULL), pending_send_ready_stages(0)
+        remainder_target(local_shard), reorder_stages(NULL),
+        pending_send_ready_stages(0), pending_remainder_arrivals(0),
+        forwarding(false)
 #ifdef DEBUG_LEGION
         , done_triggered(false)
 #endif
     //--------------------------------------------------------------------------
     { 
-      initialize_collective(); 
+      initialize_collective(true/*hierarchical*/); 
     }
 
     //--------------------------------------------------------------------------
@@ -12783,13 +12834,15 @@ namespace Legion {
             ctx->get_shard_collective_participating_shards()),
         shard_collective_last_radix(ctx->get_shard_collective_last_radix()),
         participating(local_index < shard_collective_participating_shards),
-        reorder_stages(NULL), pending_send_ready_stages(0)
+        remainder_target(local_shard), reorder_stages(NULL),
+        pending_send_ready_stages(0), pending_remainder_arrivals(0),
+        forwarding(false)
 #ifdef DEBUG_LEGION
         , done_triggered(false)
 #endif
     //--------------------------------------------------------------------------
     {
-      initialize_collective();
+      initialize_collective(true/*hierarchical*/);
     }
 
     //--------------------------------------------------------------------------
@@ -12799,7 +12852,9 @@ namespace Legion {
         const std::vector<ShardID> &parts)
       : ShardCollective(ctx, id), participants(&parts),
         total_shards(parts.size()),
-        reorder_stages(NULL), pending_send_ready_stages(0)
+        remainder_target(local_shard), reorder_stages(NULL),
+        pending_send_ready_stages(0), pending_remainder_arrivals(0),
+        forwarding(false)
 #ifdef DEBUG_LEGION
         , done_triggered(false)
 #endif
@@ -12821,19 +12876,70 @@ namespace Legion {
           shard_collective_radix, shard_collective_log_radix,
           shard_collective_stages, shard_collective_participating_shards,
           shard_collective_last_radix);
-      initialize_collective();
+      initialize_collective(false/*hierarchical*/);
     }
 
     //--------------------------------------------------------------------------
     template<bool INORDER>
-    void AllGatherCollective<INORDER>::initialize_collective(void)
+    void AllGatherCollective<INORDER>::initialize_collective(bool hierarchical)
     //--------------------------------------------------------------------------
     {
       if (total_shards > 1)
       {
+        const ShardHierarchy *hierarchy = 
+          hierarchical ? manager->get_shard_hierarchy() : NULL;
+        if (hierarchy != NULL)
+        {
+          // Only the leaders are in the butterfly, everyone else
+          // goes through the leader for their address space
+          participants = &hierarchy->leaders;
+          shard_collective_radix = hierarchy->radix;
+          shard_collective_log_radix = hierarchy->log_radix;
+          shard_collective_stages = hierarchy->stages;
+          shard_collective_participating_shards = 
+            hierarchy->participating_leaders;
+          shard_collective_last_radix = hierarchy->last_radix;
+          const ShardID parent = hierarchy->parents[local_shard];
+          participating = (parent == local_shard);
+          std::map<ShardID,std::vector<ShardID> >::const_iterator finder =
+            hierarchy->children.find(local_shard);
+          if (finder != hierarchy->children.end())
+            remainder_shards = finder->second;
+          if (participating)
+            local_index = std::distance(hierarchy->leaders.begin(),
+                std::lower_bound(hierarchy->leaders.begin(),
+                  hierarchy->leaders.end(), local_shard));
+          else
+          {
+            remainder_target = parent;
+            // Leaders outside the butterfly gather the values from 
+            // their address space before sending them on
+            if (!remainder_shards.empty())
+            {
+              participating = true;
+              forwarding = true;
+            }
+          }
+        }
+        else if (participating)
+        {
+          // At most one non-participating shard goes through us
+          if ((local_index + shard_collective_participating_shards) <
+              int(total_shards))
+            remainder_shards.push_back((participants == NULL) ?
+              (local_shard + shard_collective_participating_shards) :
+              participants->at(local_index + 
+                shard_collective_participating_shards));
+        }
+        else
+          remainder_target = (participants == NULL) ?
+            (local_shard % shard_collective_participating_shards) :
+            participants->at(local_index % 
+              shard_collective_participating_shards);
+        pending_remainder_arrivals = remainder_shards.size();
         // We already have our contributions for each stage so
         // we can set the inditial participants to 1
-        if (participating)
+        if (participating && !forwarding)
         {
 #ifdef DEBUG_LEGION
           assert(shard_collective_stages > 0);
@@ -12888,26 +12994,22 @@ namespace Legion {
 #endif
         return;
       }
+      // If we are waiting for values from remainder shards then the
+      // last of them to arrive will start or forward the collective
+      if (!remainder_shards.empty())
+        return;
       // See if we are a participating shard or not
       if (participating)
       {
-        // We are a participating shard 
-        // See if we are waiting for an initial notification
-        // if not we can just send our message now
-        if ((int(total_shards) == 
-              shard_collective_participating_shards) || 
-            (local_index >= (int(total_shards) -
-              shard_collective_participating_shards)))
-        {
-          const bool all_stages_done = initiate_collective();
-          if (all_stages_done)
-            complete_exchange();
-        }
+        // We are a participating shard so we can send our message now
+        const bool all_stages_done = initiate_collective();
+        if (all_stages_done)
+          complete_exchange();
       }
       else
       {
         // We are not a participating shard
-        // so we just have to send notification to one shard
+        // so we just have to send our value to one shard
         send_remainder_stage();
       }
     }
@@ -12947,8 +13049,30 @@ namespace Legion {
       {
         if (!participating)
           all_stages_done = true;
-        else // we can now initiate the collective
-          all_stages_done = initiate_collective(); 
+        else
+        {
+          bool last_arrival;
+          {
+            AutoLock c_lock(collective_lock);
+#ifdef DEBUG_LEGION
+            assert(pending_remainder_arrivals > 0);
+#endif
+            last_arrival = (--pending_remainder_arrivals == 0);
+            // Once we forward our combined value the next value we
+            // get is the final result which should be overwritten
+            if (last_arrival && forwarding)
+              participating = false;
+          }
+          // Once we've seen all the remainder shards we can initiate
+          // or forward the combined value to our remainder target
+          if (last_arrival)
+          {
+            if (forwarding)
+              send_remainder_stage();
+            else
+              all_stages_done = initiate_collective(); 
+          }
+        }
       }
       else
         all_stages_done = send_ready_stages();
@@ -13021,29 +13145,37 @@ namespace Legion {
     void AllGatherCollective<INORDER>::send_remainder_stage(void)
     //--------------------------------------------------------------------------
     {
+      // Send our value to the shard that we go through
+#ifdef DEBUG_LEGION
+      assert(!participating);
+      assert(remainder_target != local_shard);
+      assert(remainder_target < manager->total_shards);
+#endif
+      Serializer rez;
+      construct_message(remainder_target, -1/*stage*/, rez);
+      manager->send_collective_message(get_message_kind(), 
+                                       remainder_target, rez);
+    }
+
+    //--------------------------------------------------------------------------
+    template<bool INORDER>
+    void AllGatherCollective<INORDER>::send_remainder_results(void)
+    //--------------------------------------------------------------------------
+    {
+      // Send the final result back to all the shards that went through us
+#ifdef DEBUG_LEGION
+      assert(!remainder_shards.empty());
+#endif
       const MessageKind message = get_message_kind();
-      if (participating)
+      for (std::vector<ShardID>::const_iterator it =
+            remainder_shards.begin(); it != remainder_shards.end(); it++)
       {
-        // Send back to the shards that are not participating
-        ShardID target = (participants == NULL) ?
-          (local_shard + shard_collective_participating_shards) :
-          participants->at(local_index + shard_collective_participating_shards);
 #ifdef DEBUG_LEGION
-        assert(target < manager->total_shards);
+        assert((*it) < manager->total_shards);
 #endif
         Serializer rez;
-        construct_message(target, -1/*stage*/, rez);
-        manager->send_collective_message(message, target, rez);
-      }
-      else
-      {
-        // Send to a node that is participating
-        ShardID target = (participants == NULL) ?
-          local_shard % shard_collective_participating_shards :
-          participants->at(local_index % shard_collective_participating_shards);
-        Serializer rez;
-        construct_message(target, -1/*stage*/, rez);
-        manager->send_collective_message(message, target, rez);
+        construct_message(*it, -1/*stage*/, rez);
+        manager->send_collective_message(message, *it, rez);
       }
     }
 
@@ -13239,11 +13371,9 @@ namespace Legion {
         }
         reorder_stages->erase(remaining);
       }
-      // See if we have to send a message back to a non-participating shard 
-      if ((int(total_shards) > shard_collective_participating_shards)
-          && (local_index < int(total_shards -
-                                     shard_collective_participating_shards)))
-        send_remainder_stage();
+      // See if we have to send messages back to non-participating shards
+      if (!remainder_shards.empty())
+        send_remainder_results();
       // Pull this onto the stack in case post_complete_exchange ends up
       // deleting the object
       const RtUserEvent to_trigger = done_event;
@@ -13303,6 +13433,23 @@ namespace Legion {
                                                      Serializer &rez, int stage)
     //--------------------------------------------------------------------------
     {
+      // Leaders outside the butterfly only ever pack stage -1, first to
+      // forward the values from their address space combined with their
+      // own and then to send the final result back to that address space
+      if ((stage == -1) && (current_stage == -1) && 
+          !pending_reductions.empty())
+      {
+        std::map<int,std::map<ShardID,PendingReduction> >::iterator next =
+          pending_reductions.begin();
+#ifdef DEBUG_LEGION
+        assert(next->first == -1);
+#endif
+        if (target == remainder_target)
+          instance_ready = perform_reductions(next->second);
+        else
+          copy_final_result(next->second);
+        pending_reductions.erase(next);
+      }
       // The first time we pack a stage we merge any values that we had
       // unpacked earlier as they are needed for sending this stage for
       // the first time.
@@ -13465,18 +13612,7 @@ namespace Legion {
         std::map<int,std::map<ShardID,PendingReduction> >::iterator last =
           pending_reductions.begin();
         if (last->first == -1)
-        {
-          // Copy-in last stage which includes our value so we just overwrite
-#ifdef DEBUG_LEGION
-          assert(last->second.size() == 1);
-#endif
-          PendingReduction &pending = last->second.begin()->second;
-          instance_ready = instance->copy_from(pending.instance, op, 
-             Runtime::merge_events(NULL, instance_ready, pending.precondition));
-          if (pending.postcondition.exists())
-            Runtime::trigger_event(NULL, pending.postcondition, instance_ready);
-          delete pending.instance;
-        }
+          copy_final_result(last->second);
         else
           instance_ready = perform_reductions(last->second);
         pending_reductions.erase(last);
@@ -13556,6 +13692,12 @@ namespace Legion {
       assert(instance->is_meta_visible);
       assert(instance->size <= LEGION_MAX_RETURN_SIZE);
 #endif
+      // Small values can be reduced directly in the inline buffer
+      if (instance->size <= LEGION_MAX_INLINE_FUTURE_SIZE)
+      {
+        shadow_instance = new FutureInstance(NULL/*value*/, instance->size);
+        return;
+      }
       // We're past the mapping stage of the pipeline at this point so
       // it is too late to be making instances the normal way through
       // eager allocation, so we need to just call malloc and make an
@@ -13580,6 +13722,23 @@ namespace Legion {
 #endif
     }
     
+    //--------------------------------------------------------------------------
+    void FutureAllReduceCollective::copy_final_result(
+                            const std::map<ShardID,PendingReduction> &result)
+    //--------------------------------------------------------------------------
+    {
+      // Copy-in last stage which includes our value so we just overwrite
+#ifdef DEBUG_LEGION
+      assert(result.size() == 1);
+#endif
+      const PendingReduction &pending = result.begin()->second;
+      instance_ready = instance->copy_from(pending.instance, op, 
+         Runtime::merge_events(NULL, instance_ready, pending.precondition));
+      if (pending.postcondition.exists())
+        Runtime::trigger_event(NULL, pending.postcondition, instance_ready);
+      delete pending.instance;
+    }
+
     //--------------------------------------------------------------------------
     ApEvent FutureAllReduceCollective::perform_reductions(
                    const std::map<ShardID,PendingReduction> &pending_reductions)
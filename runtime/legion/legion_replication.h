@@ -235,17 +235,19 @@ namespace Legion {
       virtual void elide_collective(void);
       inline RtEvent get_done_event(void) const { return done_event; }
     protected:
-      void initialize_collective(void);
+      void initialize_collective(bool hierarchical);
       void construct_message(ShardID target, int stage, Serializer &rez);
       bool initiate_collective(void);
       void send_remainder_stage(void);
+      void send_remainder_results(void);
       bool send_ready_stages(const int start_stage=1);
       void unpack_stage(int stage, Deserializer &derez);
       void complete_exchange(void);
       virtual RtEvent post_complete_exchange(void) 
         { return RtEvent::NO_RT_EVENT; }
     protected:
-      const std::vector<ShardID> *const participants; // can be NULL
+      // The shards in the butterfly by index, can be NULL
+      const std::vector<ShardID> *participants;
       const size_t total_shards;
       int local_index;
       int shard_collective_radix;
@@ -254,6 +256,12 @@ namespace Legion {
       int shard_collective_participating_shards;
       int shard_collective_last_radix;
       bool participating; 
+      // The non-participating shards that send us their values
+      // and get the final result back from us
+      std::vector<ShardID> remainder_shards;
+      // For non-participating shards this is the shard that we send
+      // our value to and that sends the final result back to us
+      ShardID remainder_target;
     private:
       RtUserEvent done_event;
       std::vector<int> stage_notifications;
@@ -263,6 +271,13 @@ namespace Legion {
       // trigger the done event, only the last one of these
       // will get to do the trigger to avoid any races
       unsigned pending_send_ready_stages;
+      // Values still to arrive from remainder shards before we can start
+      unsigned pending_remainder_arrivals;
+      // Leaders outside the butterfly combine the values of their
+      // remainder shards and forward them on to their remainder target
+      // as a single message, they stay participating until then so that
+      // the values they receive are merged instead of overwritten
+      bool forwarding;
 #ifdef DEBUG_LEGION
       bool done_triggered;
 #endif
@@ -303,6 +318,7 @@ namespace Legion {
       RtEvent async_reduce(FutureInstance *instance, ApEvent &ready_event);
     protected:
       ApEvent perform_reductions(const std::map<ShardID,PendingReduction> &red);
+      void copy_final_result(const std::map<ShardID,PendingReduction> &result);
       void create_shadow_instance(void);
     public:
       Operation *const op;
@@ -3256,6 +3272,37 @@ namespace Legion {
       std::vector<AddressSpaceID> address_spaces;
     }; 
 
+    /**
+     * \struct ShardHierarchy
+     * The two-level layout that all-gather collectives over all the
+     * shards of a shard manager use when some address spaces host more
+     * than one shard. The lowest shard on each address space is the
+     * leader for its space and only leaders take part in the butterfly
+     * exchange over the network. All other shards send their values to 
+     * the leader of their address space and get the final result back
+     * from it. Leaders that do not fit in the butterfly combine the
+     * values from their address space and forward them to a butterfly
+     * leader in a single message.
+     */
+    struct ShardHierarchy {
+    public:
+      // Leader shards in sorted order, only the first 
+      // participating_leaders of them are in the butterfly
+      std::vector<ShardID> leaders;
+      // The shard that each shard sends its value to, which is
+      // the leader of its address space for non-leader shards, a
+      // butterfly leader for the leaders outside the butterfly, and
+      // itself for the butterfly leaders
+      std::vector<ShardID> parents;
+      // The shards that send their values to each shard
+      std::map<ShardID,std::vector<ShardID> > children;
+      int radix;
+      int log_radix;
+      int stages;
+      int participating_leaders;
+      int last_radix;
+    };
+
     /**
      * \class ShardManager
      * This is a class that manages the execution of one or
@@ -3304,6 +3351,8 @@ namespace Legion {
         { return *collective_mapping; }
       inline AddressSpaceID get_shard_space(ShardID sid) const
         { return (*address_spaces)[sid]; }    
+      inline const ShardHierarchy* get_shard_hierarchy(void) const
+        { return shard_hierarchy; }
       inline bool is_first_local_shard(ShardTask *task) const
         { return (local_shards[0] == task); }
       inline ReplicateContext* find_local_context(void) const
@@ -3334,6 +3383,7 @@ namespace Legion {
                                TopLevelContext *top_context);
       void pack_shard_manager(Serializer &rez) const;
       void set_shard_mapping(std::vector<Processor> &shard_mapping);
+      void compute_shard_hierarchy(void);
       ShardTask* create_shard(ShardID id, Processor target,
           VariantID variant, InnerContext *parent_ctx, SingleTask *source);
       ShardTask* create_shard(ShardID id, Processor target,
@@ -3540,6 +3590,8 @@ namespace Legion {
       // Inheritted from Mapper::SelectShardingFunctorInput
       // std::vector<Processor>        shard_mapping;
       ShardMapping*                    address_spaces;
+      // NULL when all-gathers should use a flat butterfly
+      ShardHierarchy*                  shard_hierarchy;
       std::vector<ShardTask*>          local_shards;
     protected:
       // There are five kinds of signals that come back from 
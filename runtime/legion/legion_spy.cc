@@ -21,6 +21,178 @@
 
 namespace Legion {
   namespace Internal {
+    namespace LegionSpy {
+
+      BinarySpyStream *binary_spy = NULL;
+
+      //------------------------------------------------------------------------
+      void close_binary_spy(void)
+      //------------------------------------------------------------------------
+      {
+        // Nothing can still be logging once Realm has shut down so it is
+        // safe to flush every thread's buffer and close the file
+        if (binary_spy == NULL)
+          return;
+        delete binary_spy;
+        binary_spy = NULL;
+      }
+
+      //------------------------------------------------------------------------
+      BinarySpyStream::BinarySpyStream(const std::string &filename,
+                                       AddressSpaceID node)
+        : file(fopen(filename.c_str(), "wb")), next_format_id(1)
+      //------------------------------------------------------------------------
+      {
+        if (file == NULL)
+          REPORT_LEGION_ERROR(ERROR_INVALID_SPY_FILE,
+              "Unable to open Legion Spy logfile %s for writing!",
+              filename.c_str())
+        // The preamble is a line of text so the file type is easy to see
+        fprintf(file, "FileType: BinaryLegionSpy v: 1.0 node: %u\n", node);
+      }
+
+      //------------------------------------------------------------------------
+      BinarySpyStream::~BinarySpyStream(void)
+      //------------------------------------------------------------------------
+      {
+        flush();
+        for (std::vector<ThreadBuffer*>::const_iterator it =
+              buffers.begin(); it != buffers.end(); it++)
+          delete (*it);
+        for (std::map<const char*,Format*>::const_iterator it =
+              formats.begin(); it != formats.end(); it++)
+          delete it->second;
+        fclose(file);
+      }
+
+      //------------------------------------------------------------------------
+      void BinarySpyStream::flush(void)
+      //------------------------------------------------------------------------
+      {
+        AutoLock s_lock(stream_lock);
+        for (std::vector<ThreadBuffer*>::const_iterator it =
+              buffers.begin(); it != buffers.end(); it++)
+        {
+          if ((*it)->data.empty())
+            continue;
+          fwrite(&(*it)->data.front(), 1, (*it)->data.size(), file);
+          (*it)->data.clear();
+        }
+        fflush(file);
+      }
+
+      //------------------------------------------------------------------------
+      /*static*/ void BinarySpyStream::parse_format(const char *fmt,
+                                             std::vector<ArgumentKind> &kinds)
+      //------------------------------------------------------------------------
+      {
+        for (const char *p = fmt; *p != '\0'; p++)
+        {
+          if (*p != '%')
+            continue;
+          p++;
+          if (*p == '%')
+            continue;
+          // Skip over flags, width, precision, and length modifiers
+          while ((*p != '\0') && 
+                 (strchr("-+ #0123456789.hlLqjzt", *p) != NULL))
+            p++;
+          switch (*p)
+          {
+            case 'd':
+            case 'i':
+              {
+                kinds.push_back(SIGNED_ARGUMENT);
+                break;
+              }
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o':
+            case 'c':
+            case 'p':
+              {
+                kinds.push_back(UNSIGNED_ARGUMENT);
+                break;
+              }
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+              {
+                kinds.push_back(DOUBLE_ARGUMENT);
+                break;
+              }
+            case 's':
+              {
+                kinds.push_back(STRING_ARGUMENT);
+                break;
+              }
+            default:
+              // Unsupported conversions (e.g. '*' widths) would leave us
+              // with the wrong number of arguments for every record
+              REPORT_LEGION_FATAL(LEGION_FATAL_UNSUPPORTED_SPY_FORMAT,
+                  "Unsupported conversion '%c' in Legion Spy format \"%s\" "
+                  "for the binary Legion Spy logfile", *p, fmt)
+          }
+        }
+      }
+
+      //------------------------------------------------------------------------
+      BinarySpyStream::ThreadBuffer* BinarySpyStream::get_thread_buffer(void)
+      //------------------------------------------------------------------------
+      {
+        static thread_local ThreadBuffer *local_buffer = NULL;
+        if (local_buffer != NULL)
+          return local_buffer;
+        local_buffer = new ThreadBuffer;
+        local_buffer->data.reserve(BUFFER_SIZE + 256);
+        AutoLock s_lock(stream_lock);
+        buffers.push_back(local_buffer);
+        return local_buffer;
+      }
+
+      //------------------------------------------------------------------------
+      const BinarySpyStream::Format* BinarySpyStream::register_format(
+                                        ThreadBuffer *buffer, const char *fmt)
+      //------------------------------------------------------------------------
+      {
+        AutoLock s_lock(stream_lock);
+        std::map<const char*,Format*>::const_iterator finder = 
+          formats.find(fmt);
+        if (finder == formats.end())
+        {
+          Format *format = new Format;
+          format->id = next_format_id++;
+          parse_format(fmt, format->kinds);
+          // Write the definition straight to the file while holding the
+          // lock so that it precedes any records that use it no matter
+          // which thread's buffer they end up in
+          ThreadBuffer definition;
+          encode_varint(&definition, DEFINITION_TAG);
+          encode_varint(&definition, format->id);
+          const size_t length = strlen(fmt);
+          encode_varint(&definition, length);
+          fwrite(&definition.data.front(), 1, definition.data.size(), file);
+          fwrite(fmt, 1, length, file);
+          finder = formats.insert(std::make_pair(fmt, format)).first;
+        }
+        buffer->formats[fmt] = finder->second;
+        return finder->second;
+      }
+
+      //------------------------------------------------------------------------
+      void BinarySpyStream::write_buffer(ThreadBuffer *buffer)
+      //------------------------------------------------------------------------
+      {
+        AutoLock s_lock(stream_lock);
+        fwrite(&buffer->data.front(), 1, buffer->data.size(), file);
+        buffer->data.clear();
+      }
+
+    }; // namespace LegionSpy
 
     //--------------------------------------------------------------------------
     TreeStateLogger::TreeStateLogger(void)
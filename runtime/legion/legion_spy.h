@@ -35,51 +35,223 @@ namespace Legion {
 
       extern Realm::Logger log_spy;
 
+      /**
+       * \class BinarySpyStream
+       * This is an alternative to the text output of Legion Spy that
+       * writes a compact binary record stream (see -lg:spy_logfile).
+       * The first time a format string is seen it is assigned an ID and
+       * its definition is written to the file. After that each record is
+       * just the varint-encoded ID followed by its arguments, encoded
+       * based on the conversions in the format string: zig-zag varints 
+       * for signed integers, varints for unsigned integers, raw doubles,
+       * and length-prefixed strings. Each thread encodes into its own 
+       * buffer which is only written to the file when it fills up. The
+       * stream can be read with tools/legion_spy_reader.h and turned
+       * back into text for legion_spy.py with tools/legion_spy_convert.
+       */
+      class BinarySpyStream {
+      public:
+        enum ArgumentKind {
+          SIGNED_ARGUMENT,
+          UNSIGNED_ARGUMENT,
+          DOUBLE_ARGUMENT,
+          STRING_ARGUMENT,
+        };
+        struct Format {
+        public:
+          uint64_t id;
+          std::vector<ArgumentKind> kinds;
+        };
+        struct ThreadBuffer {
+        public:
+          std::unordered_map<const char*,const Format*> formats;
+          std::vector<uint8_t> data;
+        };
+        static constexpr size_t BUFFER_SIZE = 1 << 16;
+        static constexpr uint64_t DEFINITION_TAG = 0;
+      public:
+        BinarySpyStream(const std::string &filename, AddressSpaceID node);
+        BinarySpyStream(const BinarySpyStream &rhs) = delete;
+        ~BinarySpyStream(void);
+      public:
+        BinarySpyStream& operator=(const BinarySpyStream &rhs) = delete;
+      public:
+        template<typename... Args>
+        inline void record(const char *fmt, Args... args);
+        // Only safe to call once nothing else is logging
+        void flush(void);
+      public:
+        static void parse_format(const char *fmt,
+                                 std::vector<ArgumentKind> &kinds);
+      protected:
+        ThreadBuffer* get_thread_buffer(void);
+        const Format* register_format(ThreadBuffer *buffer, const char *fmt);
+        void write_buffer(ThreadBuffer *buffer);
+        static inline void encode_varint(ThreadBuffer *buffer, uint64_t value);
+        template<typename T>
+        static inline void encode_argument(ThreadBuffer *buffer,
+                                           ArgumentKind kind, T value);
+      protected:
+        FILE *const file;
+        mutable LocalLock stream_lock;
+        std::map<const char*,Format*> formats;
+        std::vector<ThreadBuffer*> buffers;
+        uint64_t next_format_id;
+      };
+
+      extern BinarySpyStream *binary_spy;
+      // Writes out and closes the binary stream once Realm has shut down
+      void close_binary_spy(void);
+
+      //------------------------------------------------------------------------
+      /*static*/ inline void BinarySpyStream::encode_varint(
+                                        ThreadBuffer *buffer, uint64_t value)
+      //------------------------------------------------------------------------
+      {
+        while (value >= 0x80)
+        {
+          buffer->data.push_back(uint8_t(value) | 0x80);
+          value >>= 7;
+        }
+        buffer->data.push_back(uint8_t(value));
+      }
+
+      //------------------------------------------------------------------------
+      template<typename T>
+      /*static*/ inline void BinarySpyStream::encode_argument(
+                        ThreadBuffer *buffer, ArgumentKind kind, T value)
+      //------------------------------------------------------------------------
+      {
+        if constexpr (std::is_convertible<T,const char*>::value)
+        {
+#ifdef DEBUG_LEGION
+          assert(kind == STRING_ARGUMENT);
+#endif
+          const char *str = (value == NULL) ? "(null)" : value;
+          const size_t length = strlen(str);
+          encode_varint(buffer, length);
+          buffer->data.insert(buffer->data.end(), str, str + length);
+        }
+        else if constexpr (std::is_floating_point<T>::value)
+        {
+#ifdef DEBUG_LEGION
+          assert(kind == DOUBLE_ARGUMENT);
+#endif
+          const double converted = value;
+          const uint8_t *bytes = reinterpret_cast<const uint8_t*>(&converted);
+          buffer->data.insert(buffer->data.end(), bytes, 
+                              bytes + sizeof(converted));
+        }
+        else if constexpr (std::is_pointer<T>::value)
+          encode_varint(buffer, uint64_t(uintptr_t(value)));
+        else
+        {
+          if (kind == SIGNED_ARGUMENT)
+          {
+            // Zig-zag encode so small negative numbers stay small
+            const int64_t converted = int64_t(value);
+            encode_varint(buffer, (uint64_t(converted) << 1) ^ 
+                                  uint64_t(converted >> 63));
+          }
+          else
+            encode_varint(buffer, uint64_t(value));
+        }
+      }
+
+      //------------------------------------------------------------------------
+      template<typename... Args>
+      inline void BinarySpyStream::record(const char *fmt, Args... args)
+      //------------------------------------------------------------------------
+      {
+        ThreadBuffer *buffer = get_thread_buffer();
+        const Format *format = NULL;
+        std::unordered_map<const char*,const Format*>::const_iterator finder =
+          buffer->formats.find(fmt);
+        if (finder == buffer->formats.end())
+          format = register_format(buffer, fmt);
+        else
+          format = finder->second;
+#ifdef DEBUG_LEGION
+        assert(format->kinds.size() == sizeof...(args));
+#endif
+        encode_varint(buffer, format->id);
+        [[maybe_unused]] unsigned index = 0;
+        (encode_argument(buffer, format->kinds[index++], args), ...);
+        if (buffer->data.size() >= BUFFER_SIZE)
+          write_buffer(buffer);
+      }
+
+      // All Legion Spy logging goes through here so that it can be
+      // redirected to the binary stream if one has been requested
+      template<typename... Args>
+      static inline void spy_record(const char *fmt, Args... args)
+      {
+        if (binary_spy != NULL)
+          binary_spy->record(fmt, args...);
+        else if constexpr (sizeof...(args) == 0)
+          log_spy.print("%s", fmt);
+        else
+          log_spy.print(fmt, args...);
+      }
+
+      // Never called, only here so the compiler checks the arguments 
+      // against the format string like it does for the logger calls
+      REALM_ATTR_PRINTF_FORMAT(
+          static inline void spy_check_format(const char *fmt, ...), 1, 2);
+      static inline void spy_check_format(const char *fmt, ...) { }
+
+#define LEGION_SPY_PRINT(fmt, ...)                              \
+      do {                                                      \
+        if (false)                                              \
+          spy_check_format(fmt, ##__VA_ARGS__);                 \
+        spy_record(fmt, ##__VA_ARGS__);                         \
+      } while (false)
+
       // One time logger calls to record what gets logged
       static inline void log_legion_spy_config(void)
       {
 #ifdef LEGION_SPY
-        log_spy.print("Legion Spy Detailed Logging");
+        LEGION_SPY_PRINT("Legion Spy Detailed Logging");
 #else
-        log_spy.print("Legion Spy Logging");
+        LEGION_SPY_PRINT("Legion Spy Logging");
 #endif
       }
 
       // Logger calls for the machine architecture
       static inline void log_processor_kind(unsigned kind, const char *name)
       {
-        log_spy.print("Processor Kind %d %s", kind, name);
+        LEGION_SPY_PRINT("Processor Kind %d %s", kind, name);
       }
 
       static inline void log_memory_kind(unsigned kind, const char *name)
       {
-        log_spy.print("Memory Kind %d %s", kind, name);
+        LEGION_SPY_PRINT("Memory Kind %d %s", kind, name);
       }
 
       static inline void log_processor(IDType unique_id, unsigned kind)
       {
-        log_spy.print("Processor " IDFMT " %u", 
+        LEGION_SPY_PRINT("Processor " IDFMT " %u", 
 		      unique_id, kind);
       }
 
       static inline void log_memory(IDType unique_id, size_t capacity,
           unsigned kind)
       {
-        log_spy.print("Memory " IDFMT " %zu %u", 
+        LEGION_SPY_PRINT("Memory " IDFMT " %zu %u", 
 		      unique_id, capacity, kind);
       }
 
       static inline void log_proc_mem_affinity(IDType proc_id, 
             IDType mem_id, unsigned bandwidth, unsigned latency)
       {
-        log_spy.print("Processor Memory " IDFMT " " IDFMT " %u %u", 
+        LEGION_SPY_PRINT("Processor Memory " IDFMT " " IDFMT " %u %u", 
 		      proc_id, mem_id, bandwidth, latency);
       }
 
       static inline void log_mem_mem_affinity(IDType mem1, 
           IDType mem2, unsigned bandwidth, unsigned latency)
       {
-        log_spy.print("Memory Memory " IDFMT " " IDFMT " %u %u", 
+        LEGION_SPY_PRINT("Memory Memory " IDFMT " " IDFMT " %u %u", 
 		      mem1, mem2, bandwidth, latency);
       }
 
@@ -88,14 +260,14 @@ namespace Legion {
                                              AddressSpaceID owner,
                                              const char *provenance)
       {
-        log_spy.print("Index Space " IDFMT " %u %s", unique_id,
+        LEGION_SPY_PRINT("Index Space " IDFMT " %u %s", unique_id,
             owner, (provenance == NULL) ? "" : provenance);
       }
 
       static inline void log_index_space_name(IDType unique_id,
                                               const char* name)
       {
-        log_spy.print("Index Space Name " IDFMT " %s",
+        LEGION_SPY_PRINT("Index Space Name " IDFMT " %s",
 		      unique_id, name);
       }
 
@@ -104,7 +276,7 @@ namespace Legion {
                 LegionColor point, AddressSpaceID owner, const char *provenance)
       {
         // Convert ints from -1,0,1 to 0,1,2
-        log_spy.print("Index Partition " IDFMT " " IDFMT " %d %d %lld %u %s",
+        LEGION_SPY_PRINT("Index Partition " IDFMT " " IDFMT " %d %d %lld %u %s",
 		      parent_id, unique_id, disjoint+1, complete+1, point,
                       owner, (provenance == NULL) ? "" : provenance); 
       }
@@ -112,7 +284,7 @@ namespace Legion {
       static inline void log_index_partition_name(IDType unique_id,
                                                   const char* name)
       {
-        log_spy.print("Index Partition Name " IDFMT " %s",
+        LEGION_SPY_PRINT("Index Partition Name " IDFMT " %s",
 		      unique_id, name);
       }
 
@@ -120,29 +292,29 @@ namespace Legion {
           IDType unique_id, AddressSpaceID owner, const DomainPoint &point)
       {
 #if LEGION_MAX_DIM == 1
-        log_spy.print("Index Subspace " IDFMT " " IDFMT " %u %u %lld",
+        LEGION_SPY_PRINT("Index Subspace " IDFMT " " IDFMT " %u %u %lld",
 		      parent_id, unique_id, owner, point.dim,
                       (long long )point.point_data[0]);
 #elif LEGION_MAX_DIM == 2
-        log_spy.print("Index Subspace " IDFMT " " IDFMT " %u %u %lld %lld",
+        LEGION_SPY_PRINT("Index Subspace " IDFMT " " IDFMT " %u %u %lld %lld",
 		      parent_id, unique_id, owner, point.dim,
                       (long long)point.point_data[0],
                       (point.dim < 2) ? 0 : (long long)point.point_data[1]);
 #elif LEGION_MAX_DIM == 3
-        log_spy.print("Index Subspace " IDFMT " " IDFMT " %u %u %lld %lld %lld",
+        LEGION_SPY_PRINT("Index Subspace " IDFMT " " IDFMT " %u %u %lld %lld %lld",
 		      parent_id, unique_id, owner, point.dim,
                       (long long)point.point_data[0],
                       (point.dim < 2) ? 0 : (long long)point.point_data[1],
                       (point.dim < 3) ? 0 : (long long)point.point_data[2]);
 #elif LEGION_MAX_DIM == 4
-        log_spy.print("Index Subspace " IDFMT " " IDFMT " %u %u %lld %lld %lld "
+        LEGION_SPY_PRINT("Index Subspace " IDFMT " " IDFMT " %u %u %lld %lld %lld "
                       "%lld", parent_id, unique_id, owner, point.dim,
                       (long long)point.point_data[0],
                       (point.dim < 2) ? 0 : (long long)point.point_data[1],
                       (point.dim < 3) ? 0 : (long long)point.point_data[2],
                       (point.dim < 4) ? 0 : (long long)point.point_data[3]);
 #elif LEGION_MAX_DIM == 5
-        log_spy.print("Index Subspace " IDFMT " " IDFMT " %u %u %lld %lld %lld "
+        LEGION_SPY_PRINT("Index Subspace " IDFMT " " IDFMT " %u %u %lld %lld %lld "
                       "%lld %lld", parent_id, unique_id, owner, point.dim,
                       (long long)point.point_data[0],
                       (point.dim < 2) ? 0 : (long long)point.point_data[1],
@@ -150,7 +322,7 @@ namespace Legion {
                       (point.dim < 4) ? 0 : (long long)point.point_data[3],
                       (point.dim < 5) ? 0 : (long long)point.point_data[4]);
 #elif LEGION_MAX_DIM == 6
-        log_spy.print("Index Subspace " IDFMT " " IDFMT " %u %u %lld %lld %lld "
+        LEGION_SPY_PRINT("Index Subspace " IDFMT " " IDFMT " %u %u %lld %lld %lld "
                       "%lld %lld %lld", parent_id, unique_id, owner, point.dim,
                       (long long)point.point_data[0],
                       (point.dim < 2) ? 0 : (long long)point.point_data[1],
@@ -159,7 +331,7 @@ namespace Legion {
                       (point.dim < 5) ? 0 : (long long)point.point_data[4],
                       (point.dim < 6) ? 0 : (long long)point.point_data[5]);
 #elif LEGION_MAX_DIM == 7
-        log_spy.print("Index Subspace " IDFMT " " IDFMT " %u %u %lld %lld %lld "
+        LEGION_SPY_PRINT("Index Subspace " IDFMT " " IDFMT " %u %u %lld %lld %lld "
                       "%lld %lld %lld %lld", parent_id, unique_id, owner, point.dim,
                       (long long)point.point_data[0],
                       (point.dim < 2) ? 0 : (long long)point.point_data[1],
@@ -169,7 +341,7 @@ namespace Legion {
                       (point.dim < 6) ? 0 : (long long)point.point_data[5],
                       (point.dim < 7) ? 0 : (long long)point.point_data[6]);
 #elif LEGION_MAX_DIM == 8
-        log_spy.print("Index Subspace " IDFMT " " IDFMT " %u %u %lld %lld %lld "
+        LEGION_SPY_PRINT("Index Subspace " IDFMT " " IDFMT " %u %u %lld %lld %lld "
                       "%lld %lld %lld %lld %lld", 
                       parent_id, unique_id, owner, point.dim,
                       (long long)point.point_data[0],
@@ -181,7 +353,7 @@ namespace Legion {
                       (point.dim < 7) ? 0 : (long long)point.point_data[6],
                       (point.dim < 8) ? 0 : (long long)point.point_data[7]);
 #elif LEGION_MAX_DIM == 9
-        log_spy.print("Index Subspace " IDFMT " " IDFMT " %u %u %lld %lld %lld "
+        LEGION_SPY_PRINT("Index Subspace " IDFMT " " IDFMT " %u %u %lld %lld %lld "
                       "%lld %lld %lld %lld %lld %lld", 
                       parent_id, unique_id, owner, point.dim,
                       (long long)point.point_data[0],
@@ -202,14 +374,14 @@ namespace Legion {
                                          AddressSpaceID owner,
                                          const char *provenance)
       {
-        log_spy.print("Field Space %u %u %s", unique_id, 
+        LEGION_SPY_PRINT("Field Space %u %u %s", unique_id, 
             owner, (provenance == NULL) ? "" : provenance);
       }
 
       static inline void log_field_space_name(unsigned unique_id,
                                               const char* name)
       {
-        log_spy.print("Field Space Name %u %s",
+        LEGION_SPY_PRINT("Field Space Name %u %s",
 		      unique_id, name);
       }
 
@@ -217,7 +389,7 @@ namespace Legion {
                                 unsigned field_id, size_t size,
                                 const char *provenance)
       {
-        log_spy.print("Field Creation %u %u %ld %s", 
+        LEGION_SPY_PRINT("Field Creation %u %u %ld %s", 
 		      unique_id, field_id, long(size),
                       (provenance == NULL) ? "" : provenance);
       }
@@ -226,7 +398,7 @@ namespace Legion {
                                         unsigned field_id,
                                         const char* name)
       {
-        log_spy.print("Field Name %u %u %s",
+        LEGION_SPY_PRINT("Field Name %u %u %s",
 		      unique_id, field_id, name);
       }
 
@@ -234,7 +406,7 @@ namespace Legion {
                       unsigned field_space, unsigned tree_id,
                       AddressSpaceID owner, const char *provenance)
       {
-        log_spy.print("Region " IDFMT " %u %u %u %s", 
+        LEGION_SPY_PRINT("Region " IDFMT " %u %u %u %s", 
 		      index_space, field_space, tree_id, owner,
                       (provenance == NULL) ? "" : provenance);
       }
@@ -243,7 +415,7 @@ namespace Legion {
                       unsigned field_space, unsigned tree_id,
                       const char* name)
       {
-        log_spy.print("Logical Region Name " IDFMT " %u %u %s", 
+        LEGION_SPY_PRINT("Logical Region Name " IDFMT " %u %u %s", 
 		      index_space, field_space, tree_id, name);
       }
 
@@ -251,7 +423,7 @@ namespace Legion {
                       unsigned field_space, unsigned tree_id,
                       const char* name)
       {
-        log_spy.print("Logical Partition Name " IDFMT " %u %u %s", 
+        LEGION_SPY_PRINT("Logical Partition Name " IDFMT " %u %u %s", 
 		      index_partition, field_space, tree_id, name);
       }
 
@@ -263,32 +435,32 @@ namespace Legion {
         static_assert(DIM <= LEGION_MAX_DIM, 
                       "DIM exceeds LEGION_MAX_DIM");
 #if LEGION_MAX_DIM == 1
-        log_spy.print("Index Space Point " IDFMT " %d %lld", handle,
+        LEGION_SPY_PRINT("Index Space Point " IDFMT " %d %lld", handle,
                       DIM, (long long)(point[0])); 
 #elif LEGION_MAX_DIM == 2
-        log_spy.print("Index Space Point " IDFMT " %d %lld %lld", handle,
+        LEGION_SPY_PRINT("Index Space Point " IDFMT " %d %lld %lld", handle,
                       DIM, (long long)(point[0]), 
                       (long long)((DIM < 2) ? 0 : point[1]));
 #elif LEGION_MAX_DIM == 3
-        log_spy.print("Index Space Point " IDFMT " %d %lld %lld %lld", handle,
+        LEGION_SPY_PRINT("Index Space Point " IDFMT " %d %lld %lld %lld", handle,
                       DIM, (long long)(point[0]), 
                       (long long)((DIM < 2) ? 0 : point[1]),
                       (long long)((DIM < 3) ? 0 : point[2]));
 #elif LEGION_MAX_DIM == 4
-        log_spy.print("Index Space Point " IDFMT " %d %lld %lld %lld %lld", 
+        LEGION_SPY_PRINT("Index Space Point " IDFMT " %d %lld %lld %lld %lld", 
                       handle, DIM, (long long)(point[0]), 
                       (long long)((DIM < 2) ? 0 : point[1]),
                       (long long)((DIM < 3) ? 0 : point[2]),
                       (long long)((DIM < 4) ? 0 : point[3]));
 #elif LEGION_MAX_DIM == 5
-        log_spy.print("Index Space Point " IDFMT " %d %lld %lld %lld %lld %lld", 
+        LEGION_SPY_PRINT("Index Space Point " IDFMT " %d %lld %lld %lld %lld %lld", 
                       handle, DIM, (long long)(point[0]), 
                       (long long)((DIM < 2) ? 0 : point[1]),
                       (long long)((DIM < 3) ? 0 : point[2]),
                       (long long)((DIM < 4) ? 0 : point[3]),
                       (long long)((DIM < 5) ? 0 : point[4]));
 #elif LEGION_MAX_DIM == 6
-        log_spy.print("Index Space Point " IDFMT " %d %lld %lld %lld %lld %lld "
+        LEGION_SPY_PRINT("Index Space Point " IDFMT " %d %lld %lld %lld %lld %lld "
                       "%lld", handle, DIM, (long long)(point[0]), 
                       (long long)((DIM < 2) ? 0 : point[1]),
                       (long long)((DIM < 3) ? 0 : point[2]),
@@ -296,7 +468,7 @@ namespace Legion {
                       (long long)((DIM < 5) ? 0 : point[4]),
                       (long long)((DIM < 6) ? 0 : point[5]));
 #elif LEGION_MAX_DIM == 7
-        log_spy.print("Index Space Point " IDFMT " %d %lld %lld %lld %lld %lld "
+        LEGION_SPY_PRINT("Index Space Point " IDFMT " %d %lld %lld %lld %lld %lld "
                       "%lld %lld", handle, DIM, (long long)(point[0]), 
                       (long long)((DIM < 2) ? 0 : point[1]),
                       (long long)((DIM < 3) ? 0 : point[2]),
@@ -305,7 +477,7 @@ namespace Legion {
                       (long long)((DIM < 6) ? 0 : point[5]),
                       (long long)((DIM < 7) ? 0 : point[6]));
 #elif LEGION_MAX_DIM == 8
-        log_spy.print("Index Space Point " IDFMT " %d %lld %lld %lld %lld %lld "
+        LEGION_SPY_PRINT("Index Space Point " IDFMT " %d %lld %lld %lld %lld %lld "
                       "%lld %lld %lld", handle, DIM, (long long)(point[0]), 
                       (long long)((DIM < 2) ? 0 : point[1]),
                       (long long)((DIM < 3) ? 0 : point[2]),
@@ -315,7 +487,7 @@ namespace Legion {
                       (long long)((DIM < 7) ? 0 : point[6]),
                       (long long)((DIM < 8) ? 0 : point[7]));
 #elif LEGION_MAX_DIM == 9
-        log_spy.print("Index Space Point " IDFMT " %d %lld %lld %lld %lld %lld "
+        LEGION_SPY_PRINT("Index Space Point " IDFMT " %d %lld %lld %lld %lld %lld "
                       "%lld %lld %lld %lld", handle, DIM, (long long)(point[0]), 
                       (long long)((DIM < 2) ? 0 : point[1]),
                       (long long)((DIM < 3) ? 0 : point[2]),
@@ -337,17 +509,17 @@ namespace Legion {
         static_assert(DIM <= LEGION_MAX_DIM,
                       "DIM exceeds LEGION_MAX_DIM");
 #if LEGION_MAX_DIM == 1
-        log_spy.print("Index Space Rect " IDFMT " %d "
+        LEGION_SPY_PRINT("Index Space Rect " IDFMT " %d "
                       "%lld %lld", handle, DIM, 
                       (long long)(rect.lo[0]), (long long)(rect.hi[0])); 
 #elif LEGION_MAX_DIM == 2
-        log_spy.print("Index Space Rect " IDFMT " %d "
+        LEGION_SPY_PRINT("Index Space Rect " IDFMT " %d "
                       "%lld %lld %lld %lld", handle, DIM, 
                       (long long)(rect.lo[0]), (long long)(rect.hi[0]), 
                       (long long)((DIM < 2) ? 0 : rect.lo[1]), 
                       (long long)((DIM < 2) ? 0 : rect.hi[1])); 
 #elif LEGION_MAX_DIM == 3
-        log_spy.print("Index Space Rect " IDFMT " %d "
+        LEGION_SPY_PRINT("Index Space Rect " IDFMT " %d "
                       "%lld %lld %lld %lld %lld %lld", handle, DIM, 
                       (long long)(rect.lo[0]), (long long)(rect.hi[0]), 
                       (long long)((DIM < 2) ? 0 : rect.lo[1]), 
@@ -355,7 +527,7 @@ namespace Legion {
                       (long long)((DIM < 3) ? 0 : rect.lo[2]), 
                       (long long)((DIM < 3) ? 0 : rect.hi[2]));
 #elif LEGION_MAX_DIM == 4
-        log_spy.print("Index Space Rect " IDFMT " %d "
+        LEGION_SPY_PRINT("Index Space Rect " IDFMT " %d "
                       "%lld %lld %lld %lld %lld %lld %lld %lld", handle, DIM,
                       (long long)(rect.lo[0]), (long long)(rect.hi[0]), 
                       (long long)((DIM < 2) ? 0 : rect.lo[1]), 
@@ -365,7 +537,7 @@ namespace Legion {
                       (long long)((DIM < 4) ? 0 : rect.lo[3]),
                       (long long)((DIM < 4) ? 0 : rect.hi[3]));
 #elif LEGION_MAX_DIM == 5
-        log_spy.print("Index Space Rect " IDFMT " %d "
+        LEGION_SPY_PRINT("Index Space Rect " IDFMT " %d "
                       "%lld %lld %lld %lld %lld %lld %lld %lld %lld %lld", 
                       handle, DIM,
                       (long long)(rect.lo[0]), (long long)(rect.hi[0]), 
@@ -378,7 +550,7 @@ namespace Legion {
                       (long long)((DIM < 5) ? 0 : rect.lo[4]),
                       (long long)((DIM < 5) ? 0 : rect.hi[4]));
 #elif LEGION_MAX_DIM == 6
-        log_spy.print("Index Space Rect " IDFMT " %d "
+        LEGION_SPY_PRINT("Index Space Rect " IDFMT " %d "
                       "%lld %lld %lld %lld %lld %lld %lld %lld %lld %lld "
                       "%lld %lld", handle, DIM,
                       (long long)(rect.lo[0]), (long long)(rect.hi[0]), 
@@ -393,7 +565,7 @@ namespace Legion {
                       (long long)((DIM < 6) ? 0 : rect.lo[5]),
                       (long long)((DIM < 6) ? 0 : rect.hi[5]));
 #elif LEGION_MAX_DIM == 7
-        log_spy.print("Index Space Rect " IDFMT " %d "
+        LEGION_SPY_PRINT("Index Space Rect " IDFMT " %d "
                       "%lld %lld %lld %lld %lld %lld %lld %lld %lld %lld "
                       "%lld %lld %lld %lld", handle, DIM,
                       (long long)(rect.lo[0]), (long long)(rect.hi[0]), 
@@ -410,7 +582,7 @@ namespace Legion {
                       (long long)((DIM < 7) ? 0 : rect.lo[6]),
                       (long long)((DIM < 7) ? 0 : rect.hi[6]));
 #elif LEGION_MAX_DIM == 8
-        log_spy.print("Index Space Rect " IDFMT " %d "
+        LEGION_SPY_PRINT("Index Space Rect " IDFMT " %d "
                       "%lld %lld %lld %lld %lld %lld %lld %lld %lld %lld "
                       "%lld %lld %lld %lld %lld %lld", handle, DIM,
                       (long long)(rect.lo[0]), (long long)(rect.hi[0]), 
@@ -429,7 +601,7 @@ namespace Legion {
                       (long long)((DIM < 8) ? 0 : rect.lo[7]),
                       (long long)((DIM < 8) ? 0 : rect.hi[7]));
 #elif LEGION_MAX_DIM == 9
-        log_spy.print("Index Space Rect " IDFMT " %d "
+        LEGION_SPY_PRINT("Index Space Rect " IDFMT " %d "
                       "%lld %lld %lld %lld %lld %lld %lld %lld %lld %lld "
                       "%lld %lld %lld %lld %lld %lld %lld %lld", handle, DIM,
                       (long long)(rect.lo[0]), (long long)(rect.hi[0]), 
@@ -456,14 +628,14 @@ namespace Legion {
 
       static inline void log_empty_index_space(IDType handle)
       {
-        log_spy.print("Empty Index Space " IDFMT "", handle);
+        LEGION_SPY_PRINT("Empty Index Space " IDFMT "", handle);
       } 
 
       // Index space expression computations
       static inline void log_index_space_expr(IDType unique_id,
                                               IndexSpaceExprID expr_id)
       {
-        log_spy.print("Index Space Expression " IDFMT " %lld", 
+        LEGION_SPY_PRINT("Index Space Expression " IDFMT " %lld", 
                       unique_id, expr_id);
       }
 
@@ -483,7 +655,7 @@ namespace Legion {
           else
             snprintf(result, max_chars, "%lld", sources[idx]);
         }
-        log_spy.print("Index Space Union %lld %zd %s", result_id, 
+        LEGION_SPY_PRINT("Index Space Union %lld %zd %s", result_id, 
                       sources.size(), result);
         free(result);
       }
@@ -504,7 +676,7 @@ namespace Legion {
           else
             snprintf(result, max_chars, " %lld", sources[idx]);
         }
-        log_spy.print("Index Space Intersection %lld %zd %s", res_id, 
+        LEGION_SPY_PRINT("Index Space Intersection %lld %zd %s", res_id, 
                       sources.size(), result);
         free(result);
       }
@@ -512,21 +684,21 @@ namespace Legion {
       static inline void log_index_space_difference(IndexSpaceExprID result_id,
                                   IndexSpaceExprID left, IndexSpaceExprID right)
       {
-        log_spy.print("Index Space Difference %lld %lld %lld", 
+        LEGION_SPY_PRINT("Index Space Difference %lld %lld %lld", 
                       result_id, left, right);
       }
 
       // Logger calls for operations 
       static inline void log_task_name(TaskID task_id, const char *name)
       {
-        log_spy.print("Task ID Name %d %s", task_id, name);
+        LEGION_SPY_PRINT("Task ID Name %d %s", task_id, name);
       }
 
       static inline void log_task_variant(TaskID task_id, unsigned variant_id,
                                           bool inner, bool leaf, 
                                           bool idempotent, const char *name)
       {
-        log_spy.print("Task Variant %d %d %d %d %d %s", task_id, variant_id,
+        LEGION_SPY_PRINT("Task Variant %d %d %d %d %d %s", task_id, variant_id,
                                                inner, leaf, idempotent, name);
       }
 
@@ -535,7 +707,7 @@ namespace Legion {
                                             UniqueID unique_id,
                                             const char *name)
       {
-        log_spy.print("Top Task %u %llu %llu %s", 
+        LEGION_SPY_PRINT("Top Task %u %llu %llu %s", 
 		      task_id, parent_ctx_uid, unique_id, name);
       }
 
@@ -544,7 +716,7 @@ namespace Legion {
                                              Processor::TaskFuncID task_id,
                                              const char *name)
       {
-        log_spy.print("Individual Task %llu %u %llu %s", 
+        LEGION_SPY_PRINT("Individual Task %llu %u %llu %s", 
 		      context, task_id, unique_id, name);
       }
 
@@ -553,58 +725,58 @@ namespace Legion {
                                         Processor::TaskFuncID task_id,
                                         const char *name)
       {
-        log_spy.print("Index Task %llu %u %llu %s",
+        LEGION_SPY_PRINT("Index Task %llu %u %llu %s",
 		      context, task_id, unique_id, name);
       }
 
       static inline void log_inline_task(UniqueID unique_id)
       {
-        log_spy.print("Inline Task %llu", unique_id);
+        LEGION_SPY_PRINT("Inline Task %llu", unique_id);
       }
 
       static inline void log_mapping_operation(UniqueID context,
                                                UniqueID unique_id)
       {
-        log_spy.print("Mapping Operation %llu %llu", context, unique_id);
+        LEGION_SPY_PRINT("Mapping Operation %llu %llu", context, unique_id);
       }
 
       static inline void log_fill_operation(UniqueID context,
                                             UniqueID unique_id)
       {
-        log_spy.print("Fill Operation %llu %llu", context, unique_id);
+        LEGION_SPY_PRINT("Fill Operation %llu %llu", context, unique_id);
       }
 
       static inline void log_discard_operation(UniqueID context,
                                                UniqueID unique_id)
       {
-        log_spy.print("Discard Operation %llu %llu", context, unique_id);
+        LEGION_SPY_PRINT("Discard Operation %llu %llu", context, unique_id);
       }
 
       static inline void log_close_operation(UniqueID context,
                                              UniqueID unique_id,
                                              bool is_intermediate_close_op)
       {
-        log_spy.print("Close Operation %llu %llu %u",
+        LEGION_SPY_PRINT("Close Operation %llu %llu %u",
           context, unique_id, is_intermediate_close_op ? 1 : 0);
       }
 
       static inline void log_refinement_operation(UniqueID context,
                                                   UniqueID unique_id)
       {
-        log_spy.print("Refinement Operation %llu %llu", context, unique_id);
+        LEGION_SPY_PRINT("Refinement Operation %llu %llu", context, unique_id);
       }
 
       static inline void log_reset_operation(UniqueID context,
                                              UniqueID unique_id)
       {
-        log_spy.print("Reset Operation %llu %llu", context, unique_id);
+        LEGION_SPY_PRINT("Reset Operation %llu %llu", context, unique_id);
       }
 
       static inline void log_internal_op_creator(UniqueID internal_op_id,
                                                  UniqueID creator_op_id,
                                                  int idx)
       {
-        log_spy.print("Internal Operation Creator %llu %llu %d",
+        LEGION_SPY_PRINT("Internal Operation Creator %llu %llu %d",
 		      internal_op_id, creator_op_id, idx);
       }
 
@@ -612,7 +784,7 @@ namespace Legion {
                                              UniqueID unique_id,
                                              bool execution)
       {
-        log_spy.print("Fence Operation %llu %llu %d",
+        LEGION_SPY_PRINT("Fence Operation %llu %llu %d",
 		      context, unique_id, execution ? 1 : 0);
       }
 
@@ -622,7 +794,7 @@ namespace Legion {
                                             bool couple_src_indirect,
                                             bool couple_dst_indirect)
       {
-        log_spy.print("Copy Operation %llu %llu %u %d %d",
+        LEGION_SPY_PRINT("Copy Operation %llu %llu %u %d %d",
 		      context, unique_id, copy_kind,
                       couple_src_indirect ? 1 : 0,
                       couple_dst_indirect ? 1 : 0);
@@ -631,26 +803,26 @@ namespace Legion {
       static inline void log_acquire_operation(UniqueID context,
                                                UniqueID unique_id)
       {
-        log_spy.print("Acquire Operation %llu %llu", context, unique_id);
+        LEGION_SPY_PRINT("Acquire Operation %llu %llu", context, unique_id);
       }
 
       static inline void log_release_operation(UniqueID context,
                                                UniqueID unique_id)
       {
-        log_spy.print("Release Operation %llu %llu", context, unique_id);
+        LEGION_SPY_PRINT("Release Operation %llu %llu", context, unique_id);
       }
 
       static inline void log_creation_operation(UniqueID context,
                                                 UniqueID creation)
       {
-        log_spy.print("Creation Operation %llu %llu", context, creation);
+        LEGION_SPY_PRINT("Creation Operation %llu %llu", context, creation);
       }
 
       static inline void log_deletion_operation(UniqueID context,
                                                 UniqueID deletion,
                                                 bool unordered)
       {
-        log_spy.print("Deletion Operation %llu %llu %u",
+        LEGION_SPY_PRINT("Deletion Operation %llu %llu %u",
 		      context, deletion, unordered ? 1 : 0);
       }
 
@@ -658,7 +830,7 @@ namespace Legion {
                                               UniqueID attach,
                                               bool restricted)
       {
-        log_spy.print("Attach Operation %llu %llu %u", 
+        LEGION_SPY_PRINT("Attach Operation %llu %llu %u", 
                       context, attach, restricted ? 1 : 0);
       }
 
@@ -666,50 +838,50 @@ namespace Legion {
                                               UniqueID detach,
                                               bool unordered)
       {
-        log_spy.print("Detach Operation %llu %llu %u",
+        LEGION_SPY_PRINT("Detach Operation %llu %llu %u",
                       context, detach, unordered ? 1 : 0);
       }
 
       static inline void log_dynamic_collective(UniqueID context, 
                                                 UniqueID collective)
       {
-        log_spy.print("Dynamic Collective %llu %llu", context, collective);
+        LEGION_SPY_PRINT("Dynamic Collective %llu %llu", context, collective);
       }
 
       static inline void log_timing_operation(UniqueID context,
                                               UniqueID timing)
       {
-        log_spy.print("Timing Operation %llu %llu", context, timing);
+        LEGION_SPY_PRINT("Timing Operation %llu %llu", context, timing);
       }
 
       static inline void log_tunable_operation(UniqueID context,
                                                UniqueID tunable)
       {
-        log_spy.print("Tunable Operation %llu %llu", context, tunable);
+        LEGION_SPY_PRINT("Tunable Operation %llu %llu", context, tunable);
       }
 
       static inline void log_all_reduce_operation(UniqueID context, 
                                                   UniqueID reduce)
       {
-        log_spy.print("All Reduce Operation %llu %llu", context, reduce);
+        LEGION_SPY_PRINT("All Reduce Operation %llu %llu", context, reduce);
       }
 
       static inline void log_predicate_operation(UniqueID context, 
                                                  UniqueID pred_op)
       {
-        log_spy.print("Predicate Operation %llu %llu", context, pred_op);
+        LEGION_SPY_PRINT("Predicate Operation %llu %llu", context, pred_op);
       }
 
       static inline void log_must_epoch_operation(UniqueID context,
                                                   UniqueID must_op)
       {
-        log_spy.print("Must Epoch Operation %llu %llu", context, must_op);
+        LEGION_SPY_PRINT("Must Epoch Operation %llu %llu", context, must_op);
       }
 
       static inline void log_summary_op_creator(UniqueID internal_op_id,
                                                 UniqueID creator_op_id)
       {
-        log_spy.print("Summary Operation Creator %llu %llu",
+        LEGION_SPY_PRINT("Summary Operation Creator %llu %llu",
 		      internal_op_id, creator_op_id);
       }
 
@@ -718,14 +890,14 @@ namespace Legion {
                                                            IDType pid,
                                                            int kind)
       {
-        log_spy.print("Dependent Partition Operation %llu %llu " IDFMT " %d",
+        LEGION_SPY_PRINT("Dependent Partition Operation %llu %llu " IDFMT " %d",
                       context, unique_id, pid, kind);
       }
 
       static inline void log_pending_partition_operation(UniqueID context,
                                                          UniqueID unique_id)
       {
-        log_spy.print("Pending Partition Operation %llu %llu",
+        LEGION_SPY_PRINT("Pending Partition Operation %llu %llu",
 		      context, unique_id);
       }
 
@@ -733,47 +905,47 @@ namespace Legion {
                                                       IDType pid,
                                                       int kind)
       {
-        log_spy.print("Pending Partition Target %llu " IDFMT " %d", unique_id,
+        LEGION_SPY_PRINT("Pending Partition Target %llu " IDFMT " %d", unique_id,
 		      pid, kind);
       }
 
       static inline void log_index_slice(UniqueID index_id, UniqueID slice_id)
       {
-        log_spy.print("Index Slice %llu %llu", index_id, slice_id);
+        LEGION_SPY_PRINT("Index Slice %llu %llu", index_id, slice_id);
       }
 
       static inline void log_slice_slice(UniqueID slice_one, UniqueID slice_two)
       {
-        log_spy.print("Slice Slice %llu %llu", slice_one, slice_two);
+        LEGION_SPY_PRINT("Slice Slice %llu %llu", slice_one, slice_two);
       }
 
       static inline void log_slice_point(UniqueID slice_id, UniqueID point_id,
                                          const DomainPoint &point)
       {
 #if LEGION_MAX_DIM == 1
-        log_spy.print("Slice Point %llu %llu %u %lld", 
+        LEGION_SPY_PRINT("Slice Point %llu %llu %u %lld", 
 		      slice_id, point_id, point.dim, 
                       (long long)point.point_data[0]);
 #elif LEGION_MAX_DIM == 2
-        log_spy.print("Slice Point %llu %llu %u %lld %lld", 
+        LEGION_SPY_PRINT("Slice Point %llu %llu %u %lld %lld", 
 		      slice_id, point_id, point.dim, 
                       (long long)point.point_data[0],
 		      (point.dim < 2) ? 0 : (long long)point.point_data[1]);
 #elif LEGION_MAX_DIM == 3
-        log_spy.print("Slice Point %llu %llu %u %lld %lld %lld", 
+        LEGION_SPY_PRINT("Slice Point %llu %llu %u %lld %lld %lld", 
 		      slice_id, point_id, point.dim, 
                       (long long)point.point_data[0],
 		      (point.dim < 2) ? 0 : (long long)point.point_data[1],
                       (point.dim < 3) ? 0 : (long long)point.point_data[2]);
 #elif LEGION_MAX_DIM == 4
-        log_spy.print("Slice Point %llu %llu %u %lld %lld %lld %lld", 
+        LEGION_SPY_PRINT("Slice Point %llu %llu %u %lld %lld %lld %lld", 
 		      slice_id, point_id, point.dim, 
                       (long long)point.point_data[0],
 		      (point.dim < 2) ? 0 : (long long)point.point_data[1], 
                       (point.dim < 3) ? 0 : (long long)point.point_data[2],
                       (point.dim < 4) ? 0 : (long long)point.point_data[3]);
 #elif LEGION_MAX_DIM == 5
-        log_spy.print("Slice Point %llu %llu %u %lld %lld %lld %lld %lld", 
+        LEGION_SPY_PRINT("Slice Point %llu %llu %u %lld %lld %lld %lld %lld", 
 		      slice_id, point_id, point.dim, 
                       (long long)point.point_data[0],
 		      (point.dim < 2) ? 0 : (long long)point.point_data[1], 
@@ -781,7 +953,7 @@ namespace Legion {
                       (point.dim < 4) ? 0 : (long long)point.point_data[3],
                       (point.dim < 5) ? 0 : (long long)point.point_data[4]);
 #elif LEGION_MAX_DIM == 6
-        log_spy.print("Slice Point %llu %llu %u %lld %lld %lld %lld %lld %lld",
+        LEGION_SPY_PRINT("Slice Point %llu %llu %u %lld %lld %lld %lld %lld %lld",
 		      slice_id, point_id, point.dim, 
                       (long long)point.point_data[0],
 		      (point.dim < 2) ? 0 : (long long)point.point_data[1], 
@@ -790,7 +962,7 @@ namespace Legion {
                       (point.dim < 5) ? 0 : (long long)point.point_data[4],
                       (point.dim < 6) ? 0 : (long long)point.point_data[5]);
 #elif LEGION_MAX_DIM == 7
-        log_spy.print("Slice Point %llu %llu %u %lld %lld %lld %lld %lld %lld "
+        LEGION_SPY_PRINT("Slice Point %llu %llu %u %lld %lld %lld %lld %lld %lld "
                       "%lld", slice_id, point_id, point.dim, 
                       (long long)point.point_data[0],
 		      (point.dim < 2) ? 0 : (long long)point.point_data[1], 
@@ -800,7 +972,7 @@ namespace Legion {
                       (point.dim < 6) ? 0 : (long long)point.point_data[5],
                       (point.dim < 7) ? 0 : (long long)point.point_data[6]);
 #elif LEGION_MAX_DIM == 8
-        log_spy.print("Slice Point %llu %llu %u %lld %lld %lld %lld %lld %lld "
+        LEGION_SPY_PRINT("Slice Point %llu %llu %u %lld %lld %lld %lld %lld %lld "
                       "%lld %lld", slice_id, point_id, point.dim, 
                       (long long)point.point_data[0],
 		      (point.dim < 2) ? 0 : (long long)point.point_data[1], 
@@ -811,7 +983,7 @@ namespace Legion {
                       (point.dim < 7) ? 0 : (long long)point.point_data[6],
                       (point.dim < 8) ? 0 : (long long)point.point_data[7]);
 #elif LEGION_MAX_DIM == 9
-        log_spy.print("Slice Point %llu %llu %u %lld %lld %lld %lld %lld %lld "
+        LEGION_SPY_PRINT("Slice Point %llu %llu %u %lld %lld %lld %lld %lld %lld "
                       "%lld %lld %lld", slice_id, point_id, point.dim, 
                       (long long)point.point_data[0],
 		      (point.dim < 2) ? 0 : (long long)point.point_data[1], 
@@ -829,36 +1001,36 @@ namespace Legion {
 
       static inline void log_point_point(UniqueID p1, UniqueID p2)
       {
-        log_spy.print("Point Point %llu %llu", p1, p2);
+        LEGION_SPY_PRINT("Point Point %llu %llu", p1, p2);
       }
 
       static inline void log_index_point(UniqueID index_id, UniqueID point_id,
                                          const DomainPoint &point)
       {
 #if LEGION_MAX_DIM == 1
-        log_spy.print("Index Point %llu %llu %u %lld", 
+        LEGION_SPY_PRINT("Index Point %llu %llu %u %lld", 
                       index_id, point_id, point.dim, 
                       (long long)point.point_data[0]);
 #elif LEGION_MAX_DIM == 2
-        log_spy.print("Index Point %llu %llu %u %lld %lld", 
+        LEGION_SPY_PRINT("Index Point %llu %llu %u %lld %lld", 
                       index_id, point_id, point.dim, 
                       (long long)point.point_data[0],
                       (point.dim < 2) ? 0 : (long long)point.point_data[1]);
 #elif LEGION_MAX_DIM == 3
-        log_spy.print("Index Point %llu %llu %u %lld %lld %lld", 
+        LEGION_SPY_PRINT("Index Point %llu %llu %u %lld %lld %lld", 
                       index_id, point_id, point.dim, 
                       (long long)point.point_data[0],
                       (point.dim < 2) ? 0 : (long long)point.point_data[1], 
                       (point.dim < 3) ? 0 : (long long)point.point_data[2]);
 #elif LEGION_MAX_DIM == 4
-        log_spy.print("Index Point %llu %llu %u %lld %lld %lld %lld",
+        LEGION_SPY_PRINT("Index Point %llu %llu %u %lld %lld %lld %lld",
                       index_id, point_id, point.dim, 
                       (long long)point.point_data[0],
                       (point.dim < 2) ? 0 : (long long)point.point_data[1], 
                       (point.dim < 3) ? 0 : (long long)point.point_data[2],
                       (point.dim < 4) ? 0 : (long long)point.point_data[3]);
 #elif LEGION_MAX_DIM == 5
-        log_spy.print("Index Point %llu %llu %u %lld %lld %lld %lld %lld",
+        LEGION_SPY_PRINT("Index Point %llu %llu %u %lld %lld %lld %lld %lld",
                       index_id, point_id, point.dim, 
                       (long long)point.point_data[0],
                       (point.dim < 2) ? 0 : (long long)point.point_data[1], 
@@ -866,7 +1038,7 @@ namespace Legion {
                       (point.dim < 4) ? 0 : (long long)point.point_data[3],
                       (point.dim < 5) ? 0 : (long long)point.point_data[4]);
 #elif LEGION_MAX_DIM == 6
-        log_spy.print("Index Point %llu %llu %u %lld %lld %lld %lld %lld %lld",
+        LEGION_SPY_PRINT("Index Point %llu %llu %u %lld %lld %lld %lld %lld %lld",
                       index_id, point_id, point.dim, 
                       (long long)point.point_data[0],
                       (point.dim < 2) ? 0 : (long long)point.point_data[1], 
@@ -875,7 +1047,7 @@ namespace Legion {
                       (point.dim < 5) ? 0 : (long long)point.point_data[4],
                       (point.dim < 6) ? 0 : (long long)point.point_data[5]);
 #elif LEGION_MAX_DIM == 7
-        log_spy.print("Index Point %llu %llu %u %lld %lld %lld %lld %lld %lld "
+        LEGION_SPY_PRINT("Index Point %llu %llu %u %lld %lld %lld %lld %lld %lld "
                       "%lld", index_id, point_id, point.dim, 
                       (long long)point.point_data[0],
                       (point.dim < 2) ? 0 : (long long)point.point_data[1], 
@@ -885,7 +1057,7 @@ namespace Legion {
                       (point.dim < 6) ? 0 : (long long)point.point_data[5],
                       (point.dim < 7) ? 0 : (long long)point.point_data[6]);
 #elif LEGION_MAX_DIM == 8
-        log_spy.print("Index Point %llu %llu %u %lld %lld %lld %lld %lld %lld "
+        LEGION_SPY_PRINT("Index Point %llu %llu %u %lld %lld %lld %lld %lld %lld "
                       "%lld %lld", index_id, point_id, point.dim, 
                       (long long)point.point_data[0],
                       (point.dim < 2) ? 0 : (long long)point.point_data[1], 
@@ -896,7 +1068,7 @@ namespace Legion {
                       (point.dim < 7) ? 0 : (long long)point.point_data[6],
                       (point.dim < 8) ? 0 : (long long)point.point_data[7]);
 #elif LEGION_MAX_DIM == 9
-        log_spy.print("Index Point %llu %llu %u %lld %lld %lld %lld %lld %lld "
+        LEGION_SPY_PRINT("Index Point %llu %llu %u %lld %lld %lld %lld %lld %lld "
                       "%lld %lld %lld", index_id, point_id, point.dim, 
                       (long long)point.point_data[0],
                       (point.dim < 2) ? 0 : (long long)point.point_data[1], 
@@ -915,48 +1087,48 @@ namespace Legion {
       static inline void log_replication(UniqueID uid, DistributedID repl_id,
                                          bool control_replicated)
       {
-        log_spy.print("Replicate Task %llu %llu %d", uid, repl_id,
+        LEGION_SPY_PRINT("Replicate Task %llu %llu %d", uid, repl_id,
                                     (control_replicated ? 1 : 0));
       }
 
       static inline void log_shard(DistributedID repl_id, 
                                    ShardID sid, UniqueID uid)
       {
-        log_spy.print("Replicate Shard %llu %d %llu", repl_id, sid, uid);
+        LEGION_SPY_PRINT("Replicate Shard %llu %d %llu", repl_id, sid, uid);
       }
 
       static inline void log_owner_shard(UniqueID uid, ShardID sid)
       {
-        log_spy.print("Owner Shard %llu %d", uid, sid);
+        LEGION_SPY_PRINT("Owner Shard %llu %d", uid, sid);
       }
 
       static inline void log_intra_space_dependence(UniqueID point_id,
                                                     const DomainPoint &point)
       {
 #if LEGION_MAX_DIM == 1
-        log_spy.print("Intra Space Dependence %llu %u %lld", 
+        LEGION_SPY_PRINT("Intra Space Dependence %llu %u %lld", 
 		      point_id, point.dim, 
                       (long long)point.point_data[0]);
 #elif LEGION_MAX_DIM == 2
-        log_spy.print("Intra Space Dependence %llu %u %lld %lld", 
+        LEGION_SPY_PRINT("Intra Space Dependence %llu %u %lld %lld", 
 		      point_id, point.dim, 
                       (long long)point.point_data[0],
 		      (point.dim < 2) ? 0 : (long long)point.point_data[1]);
 #elif LEGION_MAX_DIM == 3
-        log_spy.print("Intra Space Dependence %llu %u %lld %lld %lld", 
+        LEGION_SPY_PRINT("Intra Space Dependence %llu %u %lld %lld %lld", 
 		      point_id, point.dim, 
                       (long long)point.point_data[0],
 		      (point.dim < 2) ? 0 : (long long)point.point_data[1], 
                       (point.dim < 3) ? 0 : (long long)point.point_data[2]);
 #elif LEGION_MAX_DIM == 4
-        log_spy.print("Intra Space Dependence %llu %u %lld %lld %lld %lld", 
+        LEGION_SPY_PRINT("Intra Space Dependence %llu %u %lld %lld %lld %lld", 
 		      point_id, point.dim, 
                       (long long)point.point_data[0],
 		      (point.dim < 2) ? 0 : (long long)point.point_data[1], 
                       (point.dim < 3) ? 0 : (long long)point.point_data[2],
                       (point.dim < 4) ? 0 : (long long)point.point_data[3]);
 #elif LEGION_MAX_DIM == 5
-        log_spy.print("Intra Space Dependence %llu %u %lld %lld %lld %lld %lld", 
+        LEGION_SPY_PRINT("Intra Space Dependence %llu %u %lld %lld %lld %lld %lld", 
 		      point_id, point.dim, 
                       (long long)point.point_data[0],
 		      (point.dim < 2) ? 0 : (long long)point.point_data[1], 
@@ -964,7 +1136,7 @@ namespace Legion {
                       (point.dim < 4) ? 0 : (long long)point.point_data[3],
                       (point.dim < 5) ? 0 : (long long)point.point_data[4]);
 #elif LEGION_MAX_DIM == 6
-        log_spy.print("Intra Space Dependence %llu %u %lld %lld %lld %lld %lld %lld",
+        LEGION_SPY_PRINT("Intra Space Dependence %llu %u %lld %lld %lld %lld %lld %lld",
 		      point_id, point.dim, 
                       (long long)point.point_data[0],
 		      (point.dim < 2) ? 0 : (long long)point.point_data[1], 
@@ -973,7 +1145,7 @@ namespace Legion {
                       (point.dim < 5) ? 0 : (long long)point.point_data[4],
                       (point.dim < 6) ? 0 : (long long)point.point_data[5]);
 #elif LEGION_MAX_DIM == 7
-        log_spy.print("Intra Space Dependence %llu %u %lld %lld %lld %lld %lld %lld "
+        LEGION_SPY_PRINT("Intra Space Dependence %llu %u %lld %lld %lld %lld %lld %lld "
                       "%lld", point_id, point.dim, 
                       (long long)point.point_data[0],
 		      (point.dim < 2) ? 0 : (long long)point.point_data[1], 
@@ -983,7 +1155,7 @@ namespace Legion {
                       (point.dim < 6) ? 0 : (long long)point.point_data[5],
                       (point.dim < 7) ? 0 : (long long)point.point_data[6]);
 #elif LEGION_MAX_DIM == 8
-        log_spy.print("Intra Space Dependence %llu %u %lld %lld %lld %lld %lld %lld "
+        LEGION_SPY_PRINT("Intra Space Dependence %llu %u %lld %lld %lld %lld %lld %lld "
                       "%lld %lld", point_id, point.dim, 
                       (long long)point.point_data[0],
 		      (point.dim < 2) ? 0 : (long long)point.point_data[1], 
@@ -994,7 +1166,7 @@ namespace Legion {
                       (point.dim < 7) ? 0 : (long long)point.point_data[6],
                       (point.dim < 8) ? 0 : (long long)point.point_data[7]);
 #elif LEGION_MAX_DIM == 9
-        log_spy.print("Intra Space Dependence %llu %u %lld %lld %lld %lld %lld %lld "
+        LEGION_SPY_PRINT("Intra Space Dependence %llu %u %lld %lld %lld %lld %lld %lld "
                       "%lld %lld %lld", point_id, point.dim, 
                       (long long)point.point_data[0],
 		      (point.dim < 2) ? 0 : (long long)point.point_data[1], 
@@ -1013,19 +1185,19 @@ namespace Legion {
       static inline void log_operation_provenance(UniqueID unique_id,
                                                   const char *provenance)
       {
-        log_spy.print("Operation Provenance %llu %s", unique_id, provenance);
+        LEGION_SPY_PRINT("Operation Provenance %llu %s", unique_id, provenance);
       }
 
       static inline void log_child_operation_index(UniqueID parent_id, 
                                        size_t index, UniqueID child_id)
       {
-        log_spy.print("Operation Index %llu %zd %llu",
+        LEGION_SPY_PRINT("Operation Index %llu %zd %llu",
             parent_id, index, child_id);
       }
 
       static inline void log_predicated_false_op(UniqueID unique_id)
       {
-        log_spy.print("Predicate False %lld", unique_id);
+        LEGION_SPY_PRINT("Predicate False %lld", unique_id);
       }
 
       // Logger calls for mapping dependence analysis 
@@ -1034,7 +1206,7 @@ namespace Legion {
           unsigned field_component, unsigned tree_id, unsigned privilege, 
           unsigned coherence, unsigned redop, IDType parent_index)
       {
-        log_spy.print("Logical Requirement %llu %u %u " IDFMT " %u %u "
+        LEGION_SPY_PRINT("Logical Requirement %llu %u %u " IDFMT " %u %u "
 		      "%u %u %u " IDFMT, unique_id, index, region, 
                       index_component, field_component, tree_id,
 		      privilege, coherence, redop, parent_index);
@@ -1046,7 +1218,7 @@ namespace Legion {
         for (std::set<unsigned>::const_iterator it = logical_fields.begin();
               it != logical_fields.end(); it++)
         {
-          log_spy.print("Logical Requirement Field %llu %u %u", 
+          LEGION_SPY_PRINT("Logical Requirement Field %llu %u %u", 
 			unique_id, index, *it);
         }
       }
@@ -1057,7 +1229,7 @@ namespace Legion {
         for (std::vector<FieldID>::const_iterator it = logical_fields.begin();
               it != logical_fields.end(); it++)
         {
-          log_spy.print("Logical Requirement Field %llu %u %u", 
+          LEGION_SPY_PRINT("Logical Requirement Field %llu %u %u", 
 			unique_id, index, *it);
         }
       }
@@ -1066,14 +1238,14 @@ namespace Legion {
                                                  unsigned depth,
                                                  bool invertible)
       {
-        log_spy.print("Projection Function %u %u %d", pid, depth, 
+        LEGION_SPY_PRINT("Projection Function %u %u %d", pid, depth, 
                       invertible ? 1 : 0);
       }
 
       static inline void log_requirement_projection(UniqueID unique_id,
                                       unsigned index, ProjectionID pid)
       {
-        log_spy.print("Logical Requirement Projection %llu %u %u", 
+        LEGION_SPY_PRINT("Logical Requirement Projection %llu %u %u", 
                       unique_id, index, pid);
       }
 
@@ -1083,6 +1255,21 @@ namespace Legion {
       {
         static_assert(DIM <= LEGION_MAX_DIM,
                       "DIM exceeds LEGION_MAX DIM");
+        if (binary_spy != NULL)
+        {
+          // Same text as below, just recorded as a single string
+          std::stringstream ss;
+          ss << "Index Launch Rect " << unique_id << " " << DIM;
+          for (int d = 0; d < LEGION_MAX_DIM; d++)
+          {
+            if (d < DIM)
+              ss << " " << rect.lo[d] << " " << rect.hi[d];
+            else
+              ss << " 0 0";
+          }
+          binary_spy->record("%s", ss.str().c_str());
+          return;
+        }
 #if LEGION_MAX_DIM == 1
         log_spy.print() << "Index Launch Rect " << unique_id << " "
                         << DIM << " " << rect.lo[0] << " " << rect.hi[0];
@@ -1193,29 +1380,29 @@ namespace Legion {
                                              const DomainPoint &point)
       {
 #if LEGION_MAX_DIM == 1
-        log_spy.print("Future Creation %llu %llu %u %lld",
+        LEGION_SPY_PRINT("Future Creation %llu %llu %u %lld",
                       creator_id, future_did, point.dim,
                       (long long)point.point_data[0]); 
 #elif LEGION_MAX_DIM == 2
-        log_spy.print("Future Creation %llu %llu %u %lld %lld",
+        LEGION_SPY_PRINT("Future Creation %llu %llu %u %lld %lld",
                       creator_id, future_did, point.dim,
                                         (long long)point.point_data[0], 
                       (point.dim > 1) ? (long long)point.point_data[1] : 0);
 #elif LEGION_MAX_DIM == 3
-        log_spy.print("Future Creation %llu %llu %u %lld %lld %lld",
+        LEGION_SPY_PRINT("Future Creation %llu %llu %u %lld %lld %lld",
                       creator_id, future_did, point.dim,
                                         (long long)point.point_data[0], 
                       (point.dim > 1) ? (long long)point.point_data[1] : 0,
                       (point.dim > 2) ? (long long)point.point_data[2] : 0);
 #elif LEGION_MAX_DIM == 4
-        log_spy.print("Future Creation %llu %llu %u %lld %lld %lld %lld",
+        LEGION_SPY_PRINT("Future Creation %llu %llu %u %lld %lld %lld %lld",
                       creator_id, future_did, point.dim,
                                         (long long)point.point_data[0], 
                       (point.dim > 1) ? (long long)point.point_data[1] : 0,
                       (point.dim > 2) ? (long long)point.point_data[2] : 0,
                       (point.dim > 3) ? (long long)point.point_data[3] : 0);
 #elif LEGION_MAX_DIM == 5
-        log_spy.print("Future Creation %llu %llu %u %lld %lld %lld %lld "
+        LEGION_SPY_PRINT("Future Creation %llu %llu %u %lld %lld %lld %lld "
                       "%lld", creator_id, future_did, point.dim,
                                         (long long)point.point_data[0], 
                       (point.dim > 1) ? (long long)point.point_data[1] : 0,
@@ -1223,7 +1410,7 @@ namespace Legion {
                       (point.dim > 3) ? (long long)point.point_data[3] : 0,
                       (point.dim > 4) ? (long long)point.point_data[4] : 0);
 #elif LEGION_MAX_DIM == 6
-        log_spy.print("Future Creation %llu %llu %u %lld %lld %lld %lld "
+        LEGION_SPY_PRINT("Future Creation %llu %llu %u %lld %lld %lld %lld "
                       "%lld %lld", creator_id, future_did, point.dim,
                                         (long long)point.point_data[0], 
                       (point.dim > 1) ? (long long)point.point_data[1] : 0,
@@ -1232,7 +1419,7 @@ namespace Legion {
                       (point.dim > 4) ? (long long)point.point_data[4] : 0,
                       (point.dim > 5) ? (long long)point.point_data[5] : 0);
 #elif LEGION_MAX_DIM == 7
-        log_spy.print("Future Creation %llu %llu %u %lld %lld %lld %lld "
+        LEGION_SPY_PRINT("Future Creation %llu %llu %u %lld %lld %lld %lld "
                       "%lld %lld %lld", creator_id, future_did, point.dim,
                                         (long long)point.point_data[0], 
                       (point.dim > 1) ? (long long)point.point_data[1] : 0,
@@ -1242,7 +1429,7 @@ namespace Legion {
                       (point.dim > 5) ? (long long)point.point_data[5] : 0,
                       (point.dim > 6) ? (long long)point.point_data[6] : 0);
 #elif LEGION_MAX_DIM == 8
-        log_spy.print("Future Creation %llu %llu %u %lld %lld %lld %lld "
+        LEGION_SPY_PRINT("Future Creation %llu %llu %u %lld %lld %lld %lld "
                       "%lld %lld %lld %lld", creator_id, future_did,
                        point.dim,       (long long)point.point_data[0], 
                       (point.dim > 1) ? (long long)point.point_data[1] : 0,
@@ -1253,7 +1440,7 @@ namespace Legion {
                       (point.dim > 6) ? (long long)point.point_data[6] : 0,
                       (point.dim > 7) ? (long long)point.point_data[7] : 0);
 #elif LEGION_MAX_DIM == 9
-        log_spy.print("Future Creation %llu %llu %u %lld %lld %lld %lld "
+        LEGION_SPY_PRINT("Future Creation %llu %llu %u %lld %lld %lld %lld "
                       "%lld %lld %lld %lld %lld", creator_id, future_did,
                        point.dim,       (long long)point.point_data[0], 
                       (point.dim > 1) ? (long long)point.point_data[1] : 0,
@@ -1272,13 +1459,13 @@ namespace Legion {
       static inline void log_future_use(UniqueID user_id,
                                         DistributedID future_did)
       {
-        log_spy.print("Future Usage %llu %llu", user_id, future_did);
+        LEGION_SPY_PRINT("Future Usage %llu %llu", user_id, future_did);
       }
 
       static inline void log_predicate_use(UniqueID pred_id,
                                            UniqueID previous_predicate)
       {
-        log_spy.print("Predicate Use %llu %llu", pred_id, previous_predicate);
+        LEGION_SPY_PRINT("Predicate Use %llu %llu", pred_id, previous_predicate);
       }
 
       // Logger call for physical instances
@@ -1289,7 +1476,7 @@ namespace Legion {
                                                RegionTreeID tid,
                                                ReductionOpID redop)
       {
-        log_spy.print("Physical Instance " IDFMT " " IDFMT " " IDFMT 
+        LEGION_SPY_PRINT("Physical Instance " IDFMT " " IDFMT " " IDFMT 
                       " %d %lld %d %d", inst_event.id, inst_id, mem_id, redop, 
                       expr_id, handle.get_id(), tid);
       }
@@ -1297,21 +1484,21 @@ namespace Legion {
       static inline void log_physical_instance_field(LgEvent inst_event,
                                                      FieldID field_id)
       {
-        log_spy.print("Physical Instance Field " IDFMT " %d", 
+        LEGION_SPY_PRINT("Physical Instance Field " IDFMT " %d", 
                       inst_event.id, field_id);
       }
 
       static inline void log_physical_instance_creator(LgEvent inst_event, 
                                            UniqueID creator_id, IDType proc_id)
       {
-        log_spy.print("Physical Instance Creator " IDFMT " %lld " IDFMT "",
+        LEGION_SPY_PRINT("Physical Instance Creator " IDFMT " %lld " IDFMT "",
                       inst_event.id, creator_id, proc_id);
       }
 
       static inline void log_physical_instance_creation_region(
                                       LgEvent inst_event, LogicalRegion handle)
       {
-        log_spy.print("Physical Instance Creation Region " IDFMT " %d %d %d",
+        LEGION_SPY_PRINT("Physical Instance Creation Region " IDFMT " %d %d %d",
                       inst_event.id, handle.get_index_space().get_id(), 
                       handle.get_field_space().get_id(), handle.get_tree_id());
       }
@@ -1319,107 +1506,107 @@ namespace Legion {
       static inline void log_instance_specialized_constraint(LgEvent inst_event,
                                   SpecializedKind kind, ReductionOpID redop)
       {
-        log_spy.print("Instance Specialized Constraint " IDFMT " %d %d",
+        LEGION_SPY_PRINT("Instance Specialized Constraint " IDFMT " %d %d",
                       inst_event.id, kind, redop);
       }
 
       static inline void log_instance_memory_constraint(LgEvent inst_event,
                                                      Memory::Kind kind)
       {
-        log_spy.print("Instance Memory Constraint " IDFMT " %d", 
+        LEGION_SPY_PRINT("Instance Memory Constraint " IDFMT " %d", 
                       inst_event.id, kind);
       }
 
       static inline void log_instance_field_constraint(LgEvent inst_event,
                       bool contiguous, bool inorder, size_t num_fields)
       {
-        log_spy.print("Instance Field Constraint " IDFMT " %d %d %zd",
+        LEGION_SPY_PRINT("Instance Field Constraint " IDFMT " %d %d %zd",
             inst_event.id, (contiguous ? 1 : 0), (inorder ? 1 : 0), num_fields);
       }
 
       static inline void log_instance_field_constraint_field(LgEvent inst_event,
                                                              FieldID fid)
       {
-        log_spy.print("Instance Field Constraint Field " IDFMT " %d",
+        LEGION_SPY_PRINT("Instance Field Constraint Field " IDFMT " %d",
                       inst_event.id, fid);
       }
 
       static inline void log_instance_ordering_constraint(LgEvent inst_event,
                                   bool contiguous, size_t num_dimensions)
       {
-        log_spy.print("Instance Ordering Constraint " IDFMT " %d %zd",
+        LEGION_SPY_PRINT("Instance Ordering Constraint " IDFMT " %d %zd",
                       inst_event.id, (contiguous ? 1 : 0), num_dimensions);
       }
 
       static inline void log_instance_ordering_constraint_dimension(
                                     LgEvent inst_event, DimensionKind dim)
       {
-        log_spy.print("Instance Ordering Constraint Dimension " IDFMT " %d",
+        LEGION_SPY_PRINT("Instance Ordering Constraint Dimension " IDFMT " %d",
                       inst_event.id, dim);
       }
 
       static inline void log_instance_tiling_constraint(LgEvent inst_event,
                               DimensionKind dim, size_t value, bool tiles)
       {
-        log_spy.print("Instance Splitting Constraint " IDFMT " %d %zd %d",
+        LEGION_SPY_PRINT("Instance Splitting Constraint " IDFMT " %d %zd %d",
                       inst_event.id, dim, value, (tiles ? 1 : 0));
       }
 
       static inline void log_instance_dimension_constraint(LgEvent inst_event,
                         DimensionKind dim, EqualityKind eqk, size_t value)
       {
-        log_spy.print("Instance Dimension Constraint " IDFMT " %d %d %zd",
+        LEGION_SPY_PRINT("Instance Dimension Constraint " IDFMT " %d %d %zd",
                       inst_event.id, dim, eqk, value);
       }
 
       static inline void log_instance_alignment_constraint(LgEvent inst_event,
                           FieldID fid, EqualityKind eqk, size_t alignment)
       {
-        log_spy.print("Instance Alignment Constraint " IDFMT " %d %d %zd",
+        LEGION_SPY_PRINT("Instance Alignment Constraint " IDFMT " %d %d %zd",
                       inst_event.id, fid, eqk, alignment);
       }
 
       static inline void log_instance_offset_constraint(LgEvent inst_event,
                                       FieldID fid, long offset)
       {
-        log_spy.print("Instance Offset Constraint " IDFMT " %d %ld",
+        LEGION_SPY_PRINT("Instance Offset Constraint " IDFMT " %d %ld",
                       inst_event.id, fid, offset);
       }
 
       // Logger calls for mapping decisions
       static inline void log_variant_decision(UniqueID unique_id, unsigned vid)
       {
-        log_spy.print("Variant Decision %llu %u", unique_id, vid);
+        LEGION_SPY_PRINT("Variant Decision %llu %u", unique_id, vid);
       }
 
       static inline void log_mapping_decision(UniqueID unique_id, 
                                 unsigned index, FieldID fid, LgEvent inst_event)
       {
-        log_spy.print("Mapping Decision %llu %d %d " IDFMT "", unique_id,
+        LEGION_SPY_PRINT("Mapping Decision %llu %d %d " IDFMT "", unique_id,
 		      index, fid, inst_event.id);
       }
 
       static inline void log_post_mapping_decision(UniqueID unique_id, 
                                 unsigned index, FieldID fid, LgEvent inst_event)
       {
-        log_spy.print("Post Mapping Decision %llu %d %d " IDFMT "", unique_id,
+        LEGION_SPY_PRINT("Post Mapping Decision %llu %d %d " IDFMT "", unique_id,
 		      index, fid, inst_event.id);
       }
 
       static inline void log_task_priority(UniqueID unique_id, 
                                            TaskPriority priority)
       {
-        log_spy.print("Task Priority %llu %d", unique_id, priority);
+        LEGION_SPY_PRINT("Task Priority %llu %d", unique_id, priority);
       }
 
       static inline void log_task_processor(UniqueID unique_id, IDType proc_id)
       {
-        log_spy.print("Task Processor %llu " IDFMT "", unique_id, proc_id);
+        LEGION_SPY_PRINT("Task Processor %llu " IDFMT "", unique_id, proc_id);
       }
 
       static inline void log_task_premapping(UniqueID unique_id, unsigned index)
       {
-        log_spy.print("Task Premapping %llu %d", unique_id, index);
+        LEGION_SPY_PRINT("Task Premapping %llu %d", unique_id, index);
       }
 
       static inline char to_ascii(unsigned value)
@@ -1458,7 +1645,7 @@ namespace Legion {
           }
         }
         buffer[byte_index] = '\0';
-        log_spy.print("Task Tunable %llu %d %zd %s\n", 
+        LEGION_SPY_PRINT("Task Tunable %llu %d %zd %s\n", 
                       unique_id, index, num_bytes, buffer);
         free(buffer);
       }
@@ -1466,21 +1653,21 @@ namespace Legion {
       static inline void log_phase_barrier_arrival(UniqueID unique_id,
                                                    ApBarrier barrier)
       {
-        log_spy.print("Phase Barrier Arrive %llu " IDFMT "",
+        LEGION_SPY_PRINT("Phase Barrier Arrive %llu " IDFMT "",
                       unique_id, barrier.id);
       }
 
       static inline void log_phase_barrier_wait(UniqueID unique_id,
                                                 ApEvent previous)
       {
-        log_spy.print("Phase Barrier Wait %llu " IDFMT "",
+        LEGION_SPY_PRINT("Phase Barrier Wait %llu " IDFMT "",
                       unique_id, previous.id);
       }
 
       static inline void log_collective_rendezvous(UniqueID unique_id,
                   unsigned requirement_index, unsigned analysis_index)
       {
-        log_spy.print("Collective Rendezvous %llu %u %u", unique_id, 
+        LEGION_SPY_PRINT("Collective Rendezvous %llu %u %u", unique_id, 
                                   requirement_index, analysis_index);
       }
 
@@ -1496,7 +1683,7 @@ namespace Legion {
                 UniqueID prev_id, unsigned prev_idx, UniqueID next_id, 
                 unsigned next_idx, unsigned dep_type)
       {
-        log_spy.print("Mapping Dependence %llu %llu %u %llu %u %d", 
+        LEGION_SPY_PRINT("Mapping Dependence %llu %llu %u %llu %u %d", 
 		      context, prev_id, prev_idx,
 		      next_id, next_idx, dep_type);
       }
@@ -1505,47 +1692,47 @@ namespace Legion {
       static inline void log_event_dependence(LgEvent one, LgEvent two)
       {
         if (one != two)
-          log_spy.print("Event Event " IDFMT " " IDFMT, 
+          LEGION_SPY_PRINT("Event Event " IDFMT " " IDFMT, 
 			one.id, two.id);
       }
 
       static inline void log_reservation_acquire(Reservation r, 
                                                  LgEvent pre, LgEvent post)
       {
-        log_spy.print("Reservation " IDFMT " " IDFMT " " IDFMT,
+        LEGION_SPY_PRINT("Reservation " IDFMT " " IDFMT " " IDFMT,
                       r.id, pre.id, post.id);
       }
 
       static inline void log_ap_user_event(ApUserEvent event)
       {
-        log_spy.print("Ap User Event " IDFMT " %llu", 
+        LEGION_SPY_PRINT("Ap User Event " IDFMT " %llu", 
                       event.id, implicit_provenance);
       }
 
       static inline void log_rt_user_event(RtUserEvent event)
       {
-        log_spy.print("Rt User Event " IDFMT " %llu", 
+        LEGION_SPY_PRINT("Rt User Event " IDFMT " %llu", 
                       event.id, implicit_provenance);
       }
 
       static inline void log_pred_event(PredEvent event)
       {
-        log_spy.print("Pred Event " IDFMT, event.id);
+        LEGION_SPY_PRINT("Pred Event " IDFMT, event.id);
       }
 
       static inline void log_ap_user_event_trigger(ApUserEvent event)
       {
-        log_spy.print("Ap User Event Trigger " IDFMT, event.id);
+        LEGION_SPY_PRINT("Ap User Event Trigger " IDFMT, event.id);
       }
 
       static inline void log_rt_user_event_trigger(RtUserEvent event)
       {
-        log_spy.print("Rt User Event Trigger " IDFMT, event.id);
+        LEGION_SPY_PRINT("Rt User Event Trigger " IDFMT, event.id);
       }
 
       static inline void log_pred_event_trigger(PredEvent event)
       {
-        log_spy.print("Pred Event Trigger " IDFMT, event.id);
+        LEGION_SPY_PRINT("Pred Event Trigger " IDFMT, event.id);
       }
 
       // We use this call as a special guard call to know when 
@@ -1555,7 +1742,7 @@ namespace Legion {
       static inline void log_operation_events(UniqueID uid,
                                               LgEvent pre, LgEvent post)
       {
-        log_spy.print("Operation Events %llu " IDFMT " " IDFMT,
+        LEGION_SPY_PRINT("Operation Events %llu " IDFMT " " IDFMT,
 		      uid, pre.id, post.id);
       }
 
@@ -1566,7 +1753,7 @@ namespace Legion {
                                          LgEvent pre, LgEvent post,
                                          CollectiveKind collective)
       {
-        log_spy.print("Copy Events %llu %lld %d %d " IDFMT " " IDFMT " %d",
+        LEGION_SPY_PRINT("Copy Events %llu %lld %d %d " IDFMT " " IDFMT " %d",
                       op_unique_id, expr_id, src_tree_id,
                       dst_tree_id, pre.id, post.id, collective);
       }
@@ -1575,7 +1762,7 @@ namespace Legion {
                                         LgEvent src_event, FieldID dst_fid,
                                         LgEvent dst_event, ReductionOpID redop)
       {
-        log_spy.print("Copy Field " IDFMT " %d " IDFMT " %d " IDFMT " %d",
+        LEGION_SPY_PRINT("Copy Field " IDFMT " %d " IDFMT " %d " IDFMT " %d",
                   post.id, src_fid, src_event.id, dst_fid, dst_event.id, redop);
       }
 
@@ -1584,7 +1771,7 @@ namespace Legion {
                                              unsigned indirection_id,
                                              LgEvent pre, LgEvent post)
       {
-        log_spy.print("Indirect Events %llu %lld %d " IDFMT " " IDFMT,
+        LEGION_SPY_PRINT("Indirect Events %llu %lld %d " IDFMT " " IDFMT,
               op_unique_id, expr_id, indirection_id, pre.id, post.id);
       }
 
@@ -1593,7 +1780,7 @@ namespace Legion {
                                         FieldID dst_fid, LgEvent dst_event, 
                                         int dst_indirect, ReductionOpID redop)
       {
-        log_spy.print("Indirect Field " IDFMT " %d " IDFMT " %d %d " IDFMT
+        LEGION_SPY_PRINT("Indirect Field " IDFMT " %d " IDFMT " %d %d " IDFMT
                        " %d %d", post.id, src_fid, src_event.id, src_indirect,
                        dst_fid, dst_event.id, dst_indirect, redop);
       }
@@ -1601,14 +1788,14 @@ namespace Legion {
       static inline void log_indirect_instance(unsigned indirection_id,
                         unsigned index, LgEvent inst_event, FieldID fid)
       {
-        log_spy.print("Indirect Instance %u %u " IDFMT " %d",
+        LEGION_SPY_PRINT("Indirect Instance %u %u " IDFMT " %d",
                       indirection_id, index, inst_event.id, fid);
       }
 
       static inline void log_indirect_group(unsigned indirection_id,
                         unsigned index, LgEvent inst_event, IDType index_space)
       {
-        log_spy.print("Indirect Group %u %u " IDFMT " %llu",
+        LEGION_SPY_PRINT("Indirect Group %u %u " IDFMT " %llu",
           indirection_id, index, inst_event.id, index_space);
       }
 
@@ -1620,7 +1807,7 @@ namespace Legion {
                                          UniqueID fill_unique_id,
                                          CollectiveKind collective)
       {
-        log_spy.print("Fill Events %llu %lld %d %d " IDFMT " " IDFMT " %llu %d",
+        LEGION_SPY_PRINT("Fill Events %llu %lld %d %d " IDFMT " " IDFMT " %llu %d",
 		      op_unique_id, expr_id, handle.get_id(), tree_id,
 		      pre.id, post.id, fill_unique_id, collective);
       }
@@ -1628,7 +1815,7 @@ namespace Legion {
       static inline void log_fill_field(LgEvent post, 
                                         FieldID fid, LgEvent dst_event)
       {
-        log_spy.print("Fill Field " IDFMT " %d " IDFMT, 
+        LEGION_SPY_PRINT("Fill Field " IDFMT " %d " IDFMT, 
                       post.id, fid, dst_event.id);
       }
 
@@ -1642,7 +1829,7 @@ namespace Legion {
         // which of course breaks Legion Spy's way of logging deppart
         // operations uniquely as their completion event
         assert(pre != post);
-        log_spy.print("Deppart Events %llu %lld " IDFMT " " IDFMT " %d",
+        LEGION_SPY_PRINT("Deppart Events %llu %lld " IDFMT " " IDFMT " %d",
                       op_unique_id, expr_id, pre.id, post.id, op_kind);
       }
 
@@ -1652,7 +1839,7 @@ namespace Legion {
       // incomplete because a job crashes in the middle of a run
       static inline void log_replay_operation(UniqueID op_unique_id)
       {
-        log_spy.print("Replay Operation %llu", op_unique_id);
+        LEGION_SPY_PRINT("Replay Operation %llu", op_unique_id);
       } 
 
       // Logging for equivalence set creation
@@ -1661,14 +1848,14 @@ namespace Legion {
                                              RegionTreeID tid,
                                              UniqueID creator_uid)
       {
-        log_spy.print("Equivalence Set %llx %lld %d %llu",
+        LEGION_SPY_PRINT("Equivalence Set %llx %lld %d %llu",
             did, expr_id, tid, creator_uid);
       }
 
       static inline void log_equivalence_set_use(DistributedID did,
                                                  UniqueID uid, unsigned index)
       {
-        log_spy.print("Equivalence Use %llx %llu %d", did, uid, index);
+        LEGION_SPY_PRINT("Equivalence Use %llx %llu %d", did, uid, index);
       }
 #endif
     }; // namespace LegionSpy
@@ -6132,6 +6132,19 @@ namespace Legion {
       analyze_region_requirements();
     }
 
+    //--------------------------------------------------------------------------
+    bool IndividualTask::record_analysis_trees(
+                                        std::set<RegionTreeID> &trees) const
+    //--------------------------------------------------------------------------
+    {
+      // Phase barrier analysis has to be done in program order and we
+      // conservatively keep tasks with output regions in program order
+      if (!wait_barriers.empty() || !arrive_barriers.empty() ||
+          !output_regions.empty())
+        return false;
+      return record_requirement_trees(trees);
+    }
+
     //--------------------------------------------------------------------------
     void IndividualTask::perform_base_dependence_analysis(void)
     //--------------------------------------------------------------------------
@@ -7292,7 +7305,7 @@ namespace Legion {
       // operation, instead we just tell our slice that we are commited
       // In the deactivation of the slice task is when we will actually
       // have our commit call done
-      slice_owner->record_point_committed(commit_precondition);
+      slice_owner->record_point_committed(this, commit_precondition);
     }
 
     //--------------------------------------------------------------------------
@@ -9155,6 +9168,18 @@ namespace Legion {
       analyze_region_requirements(launch_space);
     }
 
+    //--------------------------------------------------------------------------
+    bool IndexTask::record_analysis_trees(std::set<RegionTreeID> &trees) const
+    //--------------------------------------------------------------------------
+    {
+      // Phase barrier analysis has to be done in program order and we
+      // conservatively keep tasks with output regions in program order
+      if (!wait_barriers.empty() || !arrive_barriers.empty() ||
+          !output_regions.empty())
+        return false;
+      return record_requirement_trees(trees);
+    }
+
     //--------------------------------------------------------------------------
     void IndexTask::create_output_regions(
                std::vector<OutputRequirement> &outputs, IndexSpace launch_space)
@@ -11006,6 +11031,7 @@ namespace Legion {
       num_unmapped_points = 0;
       num_uncompleted_points.store(0);
       num_uncommitted_points = 0;
+      batched_points = 0;
       index_owner = NULL;
       remote_unique_id = get_unique_id();
       origin_mapped = false;
@@ -11032,7 +11058,9 @@ namespace Legion {
           (*it)->commit_operation(true/*deactivate*/);
       }
       points.clear(); 
+      batched_points = 0;
 #ifdef DEBUG_LEGION
+      batched_requirements.clear();
       assert(local_regions.empty());
       assert(local_fields.empty());
 #endif
@@ -11205,37 +11233,46 @@ namespace Legion {
     //--------------------------------------------------------------------------
     {
       DETAILED_PROFILER(runtime, SLICE_MAP_AND_LAUNCH_CALL);
-      // First enumerate all of our points if we haven't already done so
-      if (points.empty())
-        enumerate_points(false/*inlining*/);
       // Mark that this task is no longer stealable.  Once we start
       // executing things onto a specific processor slices cannot move.
       stealable = false;
+      // First enumerate all of our points if we haven't already done so
+      if (points.empty())
+      {
+        // See if we can make the points in batches as we launch them
+        if (enumerate_and_launch_points())
+          return;
+        enumerate_points(false/*inlining*/);
+      }
 #ifdef DEBUG_LEGION
       assert(!points.empty());
 #endif
       const size_t num_points = points.size();
       for (unsigned idx = 0; idx < num_points; idx++)
-      {
-        PointTask *point = points[idx];
-        // See if we're going to replicate this point task
-        // Note you can do this inline here because if we do replicate
-        // the point task then all the shards will map in parallel
-        if (point->is_replicable() && point->replicate_task())
-          continue;
-        // Now that we support collective instance creation, we need to 
-        // enable all the point tasks to be mapping in parallel with
-        // each other in case they need to synchronize to create 
-        // collective instances
-        const RtEvent point_mapped = concurrent_task ?
-          point->defer_perform_mapping(RtEvent::NO_RT_EVENT,
-              NULL/*must epoch*/, NULL/*defer args*/, 0/*invocation count*/) :
-          point->perform_mapping();
-        if (point_mapped.exists() && !point_mapped.has_triggered())
-          point->defer_launch_task(point_mapped);
-        else
-          point->launch_task();
-      }
+        map_and_launch_point(points[idx]);
+    }
+
+    //--------------------------------------------------------------------------
+    void SliceTask::map_and_launch_point(PointTask *point)
+    //--------------------------------------------------------------------------
+    {
+      // See if we're going to replicate this point task
+      // Note you can do this inline here because if we do replicate
+      // the point task then all the shards will map in parallel
+      if (point->is_replicable() && point->replicate_task())
+        return;
+      // Now that we support collective instance creation, we need to 
+      // enable all the point tasks to be mapping in parallel with
+      // each other in case they need to synchronize to create 
+      // collective instances
+      const RtEvent point_mapped = concurrent_task ?
+        point->defer_perform_mapping(RtEvent::NO_RT_EVENT,
+            NULL/*must epoch*/, NULL/*defer args*/, 0/*invocation count*/) :
+        point->perform_mapping();
+      if (point_mapped.exists() && !point_mapped.has_triggered())
+        point->defer_launch_task(point_mapped);
+      else
+        point->launch_task();
     }
 
     //--------------------------------------------------------------------------
@@ -11712,6 +11749,89 @@ namespace Legion {
       return num_points;
     } 
 
+    //--------------------------------------------------------------------------
+    bool SliceTask::enumerate_and_launch_points(void)
+    //--------------------------------------------------------------------------
+    {
+      DETAILED_PROFILER(runtime, SLICE_ENUMERATE_POINTS_CALL);
+      // For large slices we make the point tasks in batches right before
+      // we map and launch them so we don't have to materialize all of 
+      // them before the first one can start running. We can only do 
+      // this when nothing needs to see all the points in the slice 
+      // before they start mapping: forward progress tasks need their 
+      // points to map together and output regions count the points.
+      // The points are not kept in the slice, each one is retired as
+      // soon as it commits so only the uncommitted points stay live.
+      const size_t batch_size = runtime->point_task_batch;
+      if ((batch_size == 0) || is_forward_progress_task() || 
+          !output_regions.empty() || (must_epoch != NULL) || 
+          is_replaying() || is_origin_mapped())
+        return false;
+      std::vector<ProjectionFunction*> functions(logical_regions.size(),NULL);
+      for (unsigned idx = 0; idx < logical_regions.size(); idx++)
+      {
+        const RegionRequirement &req = logical_regions[idx];
+        if (req.handle_type != LEGION_SINGULAR_PROJECTION)
+          functions[idx] = runtime->find_projection_function(req.projection);
+      }
+      Domain internal_domain;
+      runtime->forest->find_domain(internal_space, internal_domain);
+      const size_t num_points = internal_domain.get_volume();
+#ifdef DEBUG_LEGION
+      assert(num_points > 0);
+#endif
+      if (num_points <= batch_size)
+        return false;
+      // Record all the points before launching any of them so the slice
+      // cannot look mapped or complete while we are still making points
+      batched_points = num_points;
+      num_unmapped_points = num_points;
+      num_uncompleted_points.store(num_points);
+      num_uncommitted_points = num_points;
+      std::vector<PointTask*> batch;
+      batch.reserve(batch_size);
+      Domain::DomainPointIterator itr(internal_domain);
+      while (itr)
+      {
+        batch.clear();
+        for ( ; itr && (batch.size() < batch_size); itr++)
+          batch.push_back(clone_as_point_task(itr.p, false/*inline*/));
+        for (unsigned idx = 0; idx < functions.size(); idx++)
+          if (functions[idx] != NULL)
+            functions[idx]->project_points(logical_regions[idx], idx,
+                                           runtime, index_domain, batch);
+        for (std::vector<PointTask*>::const_iterator it =
+              batch.begin(); it != batch.end(); it++)
+          (*it)->complete_point_projection();
+#ifdef DEBUG_LEGION
+        for (std::vector<PointTask*>::const_iterator it =
+              batch.begin(); it != batch.end(); it++)
+        {
+          std::vector<LogicalRegion> &reqs =
+            batched_requirements[(*it)->index_point];
+          reqs.resize(regions.size());
+          for (unsigned idx = 0; idx < regions.size(); idx++)
+            reqs[idx] = (*it)->regions[idx].region;
+        }
+#endif
+        // The slice can be deactivated as soon as the last point is 
+        // launched so only touch local state after this
+        for (std::vector<PointTask*>::const_iterator it =
+              batch.begin(); it != batch.end(); it++)
+          map_and_launch_point(*it);
+      }
+      return true;
+    }
+
+    //--------------------------------------------------------------------------
+    size_t SliceTask::get_total_points(void) const
+    //--------------------------------------------------------------------------
+    {
+      if (batched_points > 0)
+        return batched_points;
+      return points.size();
+    }
+
     //--------------------------------------------------------------------------
     void SliceTask::set_predicate_false_result(const DomainPoint &point)
     //--------------------------------------------------------------------------
@@ -11764,7 +11884,7 @@ namespace Legion {
         assert(reduction_instance == NULL);
         assert(serdez_redop_state == NULL);
 #endif
-        index_owner->return_slice_complete(points.size(), effects,
+        index_owner->return_slice_complete(get_total_points(), effects,
                                         reduction_metadata, reduction_metasize);
         // No longer own the buffer so clear it
         reduction_metadata = NULL;
@@ -11790,7 +11910,8 @@ namespace Legion {
       {
         // created and deleted privilege information already passed back
         // futures already sent back
-        index_owner->return_slice_commit(points.size(), commit_precondition);
+        index_owner->return_slice_commit(get_total_points(), 
+                                         commit_precondition);
       }
       commit_operation(true/*deactivate*/, commit_precondition);
     } 
@@ -11847,9 +11968,14 @@ namespace Legion {
     }
 
     //--------------------------------------------------------------------------
-    void SliceTask::record_point_committed(RtEvent commit_precondition)
+    void SliceTask::record_point_committed(PointTask *point,
+                                           RtEvent commit_precondition)
     //--------------------------------------------------------------------------
     {
+      // Points made in batches are not in the points vector so retire
+      // them now instead of holding onto them until the slice commits
+      if (batched_points > 0)
+        point->commit_operation(true/*deactivate*/, commit_precondition);
       bool needs_trigger = false;
       {
         AutoLock o_lock(op_lock);
@@ -12239,7 +12365,8 @@ namespace Legion {
 #ifdef DEBUG_LEGION
         // In debug mode, get all our point region requirements and
         // then pass them back to the index space task
-        std::map<DomainPoint,std::vector<LogicalRegion> > local_requirements;
+        std::map<DomainPoint,std::vector<LogicalRegion> > local_requirements =
+          batched_requirements;
         for (std::vector<PointTask*>::const_iterator it = 
               points.begin(); it != points.end(); it++)
         {
@@ -12251,7 +12378,8 @@ namespace Legion {
         }
         index_owner->check_point_requirements(local_requirements);
 #endif
-        index_owner->return_slice_mapped(points.size(), applied_condition); 
+        index_owner->return_slice_mapped(get_total_points(), 
+                                         applied_condition); 
       }
       complete_mapping(applied_condition);
     }
@@ -12272,7 +12400,7 @@ namespace Legion {
     {
       rez.serialize(index_owner);
       RezCheck z(rez);
-      rez.serialize(points.size());
+      rez.serialize(get_total_points());
       rez.serialize(applied_condition);
 #ifdef DEBUG_LEGION
       if (!is_origin_mapped())
@@ -12284,6 +12412,14 @@ namespace Legion {
           for (unsigned idx = 0; idx < regions.size(); idx++)
             rez.serialize((*it)->regions[idx].region);
         }
+        for (std::map<DomainPoint,std::vector<LogicalRegion> >::const_iterator
+              it = batched_requirements.begin(); 
+              it != batched_requirements.end(); it++)
+        {
+          rez.serialize(it->first);
+          for (unsigned idx = 0; idx < regions.size(); idx++)
+            rez.serialize(it->second[idx]);
+        }
       }
 #endif
     }
@@ -12294,7 +12430,7 @@ namespace Legion {
     {
       rez.serialize(index_owner);
       RezCheck z(rez);
-      rez.serialize<size_t>(points.size());
+      rez.serialize<size_t>(get_total_points());
       rez.serialize(slice_effects);
       // Now pack up the future results
       if (redop > 0)
@@ -12305,7 +12441,7 @@ namespace Legion {
           assert(reduction_instance == NULL);
           // Might have no temporary futures if this task was predicated
           // and the predicate resolved to false
-          assert((temporary_futures.size() == points.size()) || 
+          assert((temporary_futures.size() == get_total_points()) || 
               temporary_futures.empty());
           assert(reduction_fold_effects.empty());
 #endif
@@ -12372,7 +12508,7 @@ namespace Legion {
     {
       rez.serialize(index_owner);
       RezCheck z(rez);
-      rez.serialize(points.size());
+      rez.serialize(get_total_points());
       rez.serialize(applied_condition);
       // Serialize the privilege state
       pack_resources_return(rez, context_index);
@@ -12565,7 +12701,7 @@ namespace Legion {
 #ifdef DEBUG_LEGION
       assert(is_remote());
 #endif
-      return points.size();
+      return get_total_points();
     }
 
     //--------------------------------------------------------------------------
@@ -12631,7 +12767,7 @@ namespace Legion {
         RezCheck z(rez);
         rez.serialize(index_owner);
         rez.serialize(index);
-        rez.serialize<size_t>(points.size());
+        rez.serialize<size_t>(get_total_points());
         rez.serialize<size_t>(to_perform.size());
         for (LegionMap<LogicalRegion,RegionVersioning>::const_iterator pit =
               to_perform.begin(); pit != to_perform.end(); pit++)
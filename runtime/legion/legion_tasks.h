@@ -787,6 +787,7 @@ namespace Legion {
       virtual bool has_prepipeline_stage(void) const { return true; }
       virtual void trigger_prepipeline_stage(void);
       virtual void trigger_dependence_analysis(void);
+      virtual bool record_analysis_trees(std::set<RegionTreeID> &trees) const;
       virtual void trigger_ready(void);
       virtual void report_interfering_requirements(unsigned idx1,unsigned idx2); 
       // Virtual method for creating the future for this task so that
@@ -1219,6 +1220,7 @@ namespace Legion {
       virtual bool has_prepipeline_stage(void) const { return true; }
       virtual void trigger_prepipeline_stage(void);
       virtual void trigger_dependence_analysis(void);
+      virtual bool record_analysis_trees(std::set<RegionTreeID> &trees) const;
       virtual void report_interfering_requirements(unsigned idx1,unsigned idx2);
     public:
       virtual void trigger_ready(void);
@@ -1409,6 +1411,8 @@ namespace Legion {
       PointTask* clone_as_point_task(const DomainPoint &point,
                                      bool inline_task);
       size_t enumerate_points(bool inline_task);
+      bool enumerate_and_launch_points(void);
+      void map_and_launch_point(PointTask *point);
       void set_predicate_false_result(const DomainPoint &point);
     public:
       void check_target_processors(void) const;
@@ -1421,8 +1425,9 @@ namespace Legion {
                              std::set<RtEvent> &preconditions);
       void record_point_mapped(RtEvent child_mapped);
       void record_point_complete(ApEvent child_effects);
-      void record_point_committed(RtEvent commit_precondition =
-                                  RtEvent::NO_RT_EVENT);
+      void record_point_committed(PointTask *point, 
+                                  RtEvent commit_precondition);
+      size_t get_total_points(void) const;
     public:
       void handle_future_size(size_t future_size, const DomainPoint &p,
                               std::set<RtEvent> &applied_conditions);
@@ -1511,6 +1516,12 @@ namespace Legion {
       friend class PointTask;
       friend class ReplMustEpochOp;
       std::vector<PointTask*> points;
+      // Number of points made in batches by enumerate_and_launch_points,
+      // those points are not kept in the points vector
+      size_t batched_points;
+#ifdef DEBUG_LEGION
+      std::map<DomainPoint,std::vector<LogicalRegion> > batched_requirements;
+#endif
     protected:
       unsigned num_unmapped_points;
       std::atomic<unsigned> num_uncompleted_points;
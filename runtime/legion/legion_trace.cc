@@ -201,36 +201,7 @@ namespace Legion {
             hasher.hash(task_id);
           }
           const unsigned num_regions = op->get_region_count();
-          for (unsigned idx = 0; idx < num_regions; idx++)
-          {
-            const RegionRequirement &req = op->get_requirement(idx);
-            hasher.hash(req.parent);
-            hasher.hash(req.handle_type);
-            if (req.handle_type == LEGION_PARTITION_PROJECTION)
-              hasher.hash(req.partition);
-            else
-              hasher.hash(req.region);
-            for (std::set<FieldID>::const_iterator it =
-                  req.privilege_fields.begin(); it != 
-                  req.privilege_fields.end(); it++)
-              hasher.hash(*it);
-            for (std::vector<FieldID>::const_iterator it =
-                  req.instance_fields.begin(); it != 
-                  req.instance_fields.end(); it++)
-              hasher.hash(*it);
-            hasher.hash(req.privilege);
-            hasher.hash(req.prop);
-            hasher.hash(req.redop);
-            hasher.hash(req.tag);
-            hasher.hash(req.flags);
-            if (req.handle_type != LEGION_SINGULAR_PROJECTION)
-              hasher.hash(req.projection);
-            size_t projection_size = 0;
-            const void *projection_args = 
-              req.get_projection_args(&projection_size);
-            if (projection_size > 0)
-              hasher.hash(projection_args, projection_size);
-          }
+          hash_requirements(op, hasher);
           uint64_t hash[2];
           hasher.finalize(hash);
           if (fixed)
@@ -318,6 +289,44 @@ namespace Legion {
       return true;
     }
 
+    //--------------------------------------------------------------------------
+    /*static*/ void LogicalTrace::hash_requirements(Operation *op,
+                                                    Murmur3Hasher &hasher)
+    //--------------------------------------------------------------------------
+    {
+      const unsigned num_regions = op->get_region_count();
+      for (unsigned idx = 0; idx < num_regions; idx++)
+      {
+        const RegionRequirement &req = op->get_requirement(idx);
+        hasher.hash(req.parent);
+        hasher.hash(req.handle_type);
+        if (req.handle_type == LEGION_PARTITION_PROJECTION)
+          hasher.hash(req.partition);
+        else
+          hasher.hash(req.region);
+        for (std::set<FieldID>::const_iterator it =
+              req.privilege_fields.begin(); it != 
+              req.privilege_fields.end(); it++)
+          hasher.hash(*it);
+        for (std::vector<FieldID>::const_iterator it =
+              req.instance_fields.begin(); it != 
+              req.instance_fields.end(); it++)
+          hasher.hash(*it);
+        hasher.hash(req.privilege);
+        hasher.hash(req.prop);
+        hasher.hash(req.redop);
+        hasher.hash(req.tag);
+        hasher.hash(req.flags);
+        if (req.handle_type != LEGION_SINGULAR_PROJECTION)
+          hasher.hash(req.projection);
+        size_t projection_size = 0;
+        const void *projection_args = 
+          req.get_projection_args(&projection_size);
+        if (projection_size > 0)
+          hasher.hash(projection_args, projection_size);
+      }
+    }
+
     //--------------------------------------------------------------------------
     void LogicalTrace::check_operation_count(void)
     //--------------------------------------------------------------------------
@@ -884,6 +893,312 @@ namespace Legion {
       }
     }
 
+    /////////////////////////////////////////////////////////////
+    // AutomaticTracer 
+    /////////////////////////////////////////////////////////////
+
+    //--------------------------------------------------------------------------
+    AutomaticTracer::AutomaticTracer(InnerContext *ctx)
+      : context(ctx), window(std::max(ctx->runtime->auto_trace_window, 2U)),
+        min_length(std::max(ctx->runtime->auto_trace_min_length, 1U)),
+        max_traces(ctx->runtime->auto_trace_max_traces), observed(0),
+        period(0), run_length(0), flushing(false)
+    //--------------------------------------------------------------------------
+    {
+    }
+
+    //--------------------------------------------------------------------------
+    AutomaticTracer::~AutomaticTracer(void)
+    //--------------------------------------------------------------------------
+    {
+#ifdef DEBUG_LEGION
+      assert(pending.empty());
+#endif
+      for (std::vector<Candidate*>::const_iterator it =
+            candidates.begin(); it != candidates.end(); it++)
+        delete (*it);
+    }
+
+    //--------------------------------------------------------------------------
+    bool AutomaticTracer::record_operation(Operation *op,
+                                     const std::vector<StaticDependence> *deps)
+    //--------------------------------------------------------------------------
+    {
+#ifdef DEBUG_LEGION
+      assert(!flushing);
+#endif
+      uint64_t hash = 0;
+      if ((deps != NULL) || !compute_hash(op, hash))
+      {
+        // Operations that we cannot trace break any repetition so
+        // issue everything that we have buffered ahead of them
+        flush();
+        reset_detection();
+        return false;
+      }
+      observe(hash);
+      if (pending.empty())
+        return start_match(op, hash);
+      // Filter down the candidates that still match
+      const size_t index = pending.size();
+      unsigned next = 0;
+      for (unsigned idx = 0; idx < live.size(); idx++)
+        if (live[idx]->hashes[index] == hash)
+          live[next++] = live[idx];
+      live.resize(next);
+      if (live.empty())
+      {
+        // The prefix no longer matches anything so issue the buffered
+        // operations without a trace and see if this operation is the
+        // start of a new match
+        issue_pending();
+        return start_match(op, hash);
+      }
+      pending.emplace_back(std::make_pair(op, hash));
+      for (std::vector<Candidate*>::const_iterator it =
+            live.begin(); it != live.end(); it++)
+      {
+        if ((*it)->hashes.size() != pending.size())
+          continue;
+        issue_trace(*it);
+        break;
+      }
+      return true;
+    }
+
+    //--------------------------------------------------------------------------
+    void AutomaticTracer::flush(void)
+    //--------------------------------------------------------------------------
+    {
+      if (!pending.empty() && !flushing)
+        issue_pending();
+    }
+
+    //--------------------------------------------------------------------------
+    /*static*/ bool AutomaticTracer::compute_hash(Operation *op, 
+                                                  uint64_t &result)
+    //--------------------------------------------------------------------------
+    {
+      // Only the kinds of operations that can be memoized are candidates
+      // for automatic tracing and then only if they have no outputs
+      // that the application might need to observe before they run
+      const Mappable *mappable = NULL;
+      const Operation::OpKind kind = op->get_operation_kind();
+      switch (kind)
+      {
+        case Operation::TASK_OP_KIND:
+          {
+            const Task *task = op->get_mappable()->as_task();
+            if (!task->output_regions.empty())
+              return false;
+            mappable = task;
+            break;
+          }
+        case Operation::COPY_OP_KIND:
+        case Operation::FILL_OP_KIND:
+          {
+            mappable = op->get_mappable();
+            break;
+          }
+        default:
+          return false;
+      }
+      if (op->get_memoizable() == NULL)
+        return false;
+      Murmur3Hasher hasher;
+      hasher.hash(kind);
+      switch (kind)
+      {
+        case Operation::TASK_OP_KIND:
+          {
+            const Task *task = mappable->as_task();
+            hasher.hash(task->task_id);
+            hasher.hash(task->is_index_space);
+            hasher.hash<Domain,false>(task->index_domain);
+            break;
+          }
+        case Operation::COPY_OP_KIND:
+          {
+            hasher.hash<Domain,false>(mappable->as_copy()->index_domain);
+            break;
+          }
+        case Operation::FILL_OP_KIND:
+          {
+            hasher.hash<Domain,false>(mappable->as_fill()->index_domain);
+            break;
+          }
+        default:
+          assert(false);
+      }
+      LogicalTrace::hash_requirements(op, hasher);
+      uint64_t hash[2];
+      hasher.finalize(hash);
+      result = hash[0] ^ hash[1];
+      return true;
+    }
+
+    //--------------------------------------------------------------------------
+    void AutomaticTracer::observe(uint64_t hash)
+    //--------------------------------------------------------------------------
+    {
+      if (history.empty())
+        history.resize(window);
+      // See if this operation continues the repetition we are tracking
+      // or if we need to start tracking a new one from its last occurrence
+      if ((period > 0) && (history[(observed - period) % window] == hash))
+        run_length++;
+      else
+      {
+        period = 0;
+        run_length = 0;
+        std::unordered_map<uint64_t,uint64_t>::const_iterator finder =
+          last_seen.find(hash);
+        // Repetitions can only be found if they fit in the window twice
+        if ((finder != last_seen.end()) && 
+            ((observed - finder->second) <= (window / 2)))
+        {
+          period = observed - finder->second;
+          run_length = 1;
+        }
+      }
+      history[observed % window] = hash;
+      last_seen[hash] = observed++;
+      // Prune stale entries so the memory stays proportional to the window
+      if (last_seen.size() > (2 * window))
+      {
+        for (std::unordered_map<uint64_t,uint64_t>::iterator it =
+              last_seen.begin(); it != last_seen.end(); /*nothing*/)
+        {
+          if ((observed - it->second) > window)
+            it = last_seen.erase(it);
+          else
+            it++;
+        }
+      }
+      // Once the last period operations have repeated the period before
+      // them we have found a new candidate starting at the next operation
+      if ((period < min_length) || (run_length < period))
+        return;
+      const uint64_t length = period;
+      reset_detection();
+      if (candidates.size() >= max_traces)
+        return;
+      std::vector<uint64_t> hashes(length);
+      Murmur3Hasher hasher;
+      for (uint64_t idx = 0; idx < length; idx++)
+      {
+        hashes[idx] = history[(observed - length + idx) % window];
+        hasher.hash(hashes[idx]);
+      }
+      uint64_t signature[2];
+      hasher.finalize(signature);
+      if (!signatures.insert(signature[0] ^ signature[1]).second)
+        return;
+      const TraceID tid = context->generate_dynamic_trace_id();
+      Candidate *candidate = new Candidate(tid, std::move(hashes));
+      candidates.push_back(candidate);
+      starts[candidate->hashes.front()].push_back(candidate);
+      log_tracing.info("Detected repeated sequence of %zd operations in "
+          "task %s (UID %lld) which will be traced automatically as trace %d",
+          candidate->hashes.size(), context->get_task_name(),
+          context->get_unique_id(), tid);
+    }
+
+    //--------------------------------------------------------------------------
+    void AutomaticTracer::reset_detection(void)
+    //--------------------------------------------------------------------------
+    {
+      period = 0;
+      run_length = 0;
+    }
+
+    //--------------------------------------------------------------------------
+    bool AutomaticTracer::start_match(Operation *op, uint64_t hash)
+    //--------------------------------------------------------------------------
+    {
+#ifdef DEBUG_LEGION
+      assert(pending.empty());
+      assert(live.empty());
+#endif
+      std::unordered_map<uint64_t,std::vector<Candidate*> >::const_iterator
+        finder = starts.find(hash);
+      if (finder == starts.end())
+        return false;
+      for (std::vector<Candidate*>::const_iterator it =
+            finder->second.begin(); it != finder->second.end(); it++)
+        if (!(*it)->retired)
+          live.push_back(*it);
+      if (live.empty())
+        return false;
+      pending.emplace_back(std::make_pair(op, hash));
+      for (std::vector<Candidate*>::const_iterator it =
+            live.begin(); it != live.end(); it++)
+      {
+        if ((*it)->hashes.size() != 1)
+          continue;
+        issue_trace(*it);
+        break;
+      }
+      return true;
+    }
+
+    //--------------------------------------------------------------------------
+    void AutomaticTracer::issue_pending(void)
+    //--------------------------------------------------------------------------
+    {
+      flushing = true;
+      for (std::vector<std::pair<Operation*,uint64_t> >::const_iterator it =
+            pending.begin(); it != pending.end(); it++)
+        context->add_to_dependence_queue(it->first);
+      flushing = false;
+      pending.clear();
+      live.clear();
+      // Unordered operations are held back while we issue the buffered 
+      // operations since they might have been launched after them
+      AutoLock d_lock(context->dependence_lock);
+      context->insert_unordered_ops(d_lock);
+    }
+
+    //--------------------------------------------------------------------------
+    void AutomaticTracer::issue_trace(Candidate *candidate)
+    //--------------------------------------------------------------------------
+    {
+      flushing = true;
+      context->begin_trace_internal(candidate->tid, false/*logical only*/,
+          false/*static*/, NULL/*trees*/, false/*deprecated*/, NULL/*prov*/);
+      if (candidate->trace == NULL)
+        candidate->trace = context->current_trace;
+#ifdef DEBUG_LEGION
+      assert(candidate->trace == context->current_trace);
+#endif
+      for (std::vector<std::pair<Operation*,uint64_t> >::const_iterator it =
+            pending.begin(); it != pending.end(); it++)
+        context->add_to_dependence_queue(it->first);
+      context->end_trace_internal(candidate->tid, false/*deprecated*/,
+                                  NULL/*provenance*/);
+      flushing = false;
+      pending.clear();
+      live.clear();
+      {
+        AutoLock d_lock(context->dependence_lock);
+        context->insert_unordered_ops(d_lock);
+      }
+      candidate->replays++;
+      // If the physical trace keeps failing to find a template whose
+      // preconditions are satisfied then stop using this candidate and
+      // fall back to issuing these operations without a trace
+      if (candidate->trace->has_physical_trace() &&
+          (candidate->trace->get_physical_trace()->get_failed_replay_count() 
+            >= LEGION_AUTO_TRACE_RETIRE_COUNT))
+      {
+        candidate->retired = true;
+        log_tracing.info("Retiring automatic trace %d in task %s (UID %lld) "
+            "after %u executions because its templates are not being "
+            "replayed", candidate->tid, context->get_task_name(), 
+            context->get_unique_id(), candidate->replays);
+      }
+    }
+
     /////////////////////////////////////////////////////////////
     // TraceOp 
     /////////////////////////////////////////////////////////////
@@ -4096,6 +4411,8 @@ namespace Legion {
         // before we know when it is safe to remove our references
         to_remove.swap(equivalence_sets);
         to_cancel.swap(current_subscriptions);
+        verified_versions.clear();
+        postcondition_versions.clear();
       }
       cancel_subscriptions(owner->trace->runtime, to_cancel);
       for (FieldMaskSet<EquivalenceSet>::const_iterator it =
@@ -4123,6 +4440,41 @@ namespace Legion {
     }
 #endif
 
+    //--------------------------------------------------------------------------
+    bool TraceConditionSet::is_unchanged(EquivalenceSet *set, bool precondition)
+    //--------------------------------------------------------------------------
+    {
+      // We can only trust the version of the set if we are the owner
+      // since that is where all the updates to the set are performed
+      if (!set->is_logical_owner())
+        return false;
+      const uint64_t version = set->get_version();
+      pending_versions[set->did] = version;
+      std::map<DistributedID,uint64_t>::const_iterator finder =
+        verified_versions.find(set->did);
+      if ((finder != verified_versions.end()) && (finder->second == version))
+        return true;
+      // Only the preconditions are satisfied by our own postconditions
+      if (!precondition)
+        return false;
+      finder = postcondition_versions.find(set->did);
+      return ((finder != postcondition_versions.end()) && 
+              (finder->second == version));
+    }
+
+    //--------------------------------------------------------------------------
+    void TraceConditionSet::commit_versions(bool success)
+    //--------------------------------------------------------------------------
+    {
+      if (success)
+      {
+        // Everything we looked at is now verified at its current version
+        verified_versions.swap(pending_versions);
+        postcondition_versions.clear();
+      }
+      pending_versions.clear();
+    }
+
     //--------------------------------------------------------------------------
     void TraceConditionSet::dump_conditions(void) const
     //--------------------------------------------------------------------------
@@ -4153,12 +4505,17 @@ namespace Legion {
             op, index, condition_expr, views);
       analysis.invalid->add_reference();
       std::set<RtEvent> deferral_events;
+#ifdef DEBUG_LEGION
+      assert(pending_versions.empty());
+#endif
       for (FieldMaskSet<EquivalenceSet>::const_iterator it =
             equivalence_sets.begin(); it != equivalence_sets.end(); it++)
       {
         const FieldMask overlap = views.get_valid_mask() & it->second;
         if (!overlap)
           continue;
+        if (is_unchanged(it->first, true/*preconditions*/))
+          continue;
         analysis.invalid->analyze(it->first, overlap, 
             deferral_events, applied_events);
       }
@@ -4181,6 +4538,7 @@ namespace Legion {
       assert(analysis.invalid != NULL);
 #endif
       const bool result = !analysis.invalid->has_invalid();
+      commit_versions(result);
       if (analysis.invalid->remove_reference())
         delete analysis.invalid;
 #ifdef DEBUG_LEGION
@@ -4207,12 +4565,17 @@ namespace Legion {
           condition_expr, views);
       analysis.antivalid->add_reference();
       std::set<RtEvent> deferral_events;
+#ifdef DEBUG_LEGION
+      assert(pending_versions.empty());
+#endif
       for (FieldMaskSet<EquivalenceSet>::const_iterator it =
             equivalence_sets.begin(); it != equivalence_sets.end(); it++)
       {
         const FieldMask overlap = views.get_valid_mask() & it->second;
         if (!overlap)
           continue;
+        if (is_unchanged(it->first, false/*preconditions*/))
+          continue;
         analysis.antivalid->analyze(it->first, overlap, 
             deferral_events, applied_events);
       }
@@ -4235,6 +4598,7 @@ namespace Legion {
       assert(analysis.antivalid != NULL);
 #endif
       const bool result = !analysis.antivalid->has_antivalid();
+      commit_versions(result);
       if (analysis.antivalid->remove_reference())
         delete analysis.antivalid;
 #ifdef DEBUG_LEGION
@@ -4270,6 +4634,11 @@ namespace Legion {
         const FieldMask overlap = views.get_valid_mask() & it->second;
         if (!overlap)
           continue;
+        // If we are the owner then the overwrite will bump the version
+        // exactly once and leave the set satisfying these conditions
+        if (is_shared() && it->first->is_logical_owner())
+          postcondition_versions[it->first->did] = 
+            it->first->get_version() + 1;
         analysis->analyze(it->first, overlap, deferral_events,applied_events);
       }
       const RtEvent traversal_done = deferral_events.empty() ?
@@ -4336,7 +4705,11 @@ namespace Legion {
       : trace(t), total_replays(1), replayable(REPLAYABLE), 
         idempotency(IDEMPOTENT), fence_completion_id(0),
         has_virtual_mapping(false), has_no_consensus(false), last_fence(NULL),
-        remaining_replays(0), total_logical(0)
+        remaining_replays(0), total_logical(0), chunk_preconditions(NULL),
+        chunk_paths(NULL), replay_queues(NULL), active_replay_workers(0),
+        next_replay_worker(0), replay_critical_path(0), replay_steals(0),
+        replay_start_time(0),
+        replay_chunks_valid(false)
     //--------------------------------------------------------------------------
     {
       events.push_back(fence_event);
@@ -4385,6 +4758,12 @@ namespace Legion {
       TransitiveReductionState *state = finished_transitive_reduction.load();
       if (state != NULL)
         delete state;
+      if (chunk_preconditions != NULL)
+        delete [] chunk_preconditions;
+      if (chunk_paths != NULL)
+        delete [] chunk_paths;
+      if (replay_queues != NULL)
+        delete [] replay_queues;
       for (std::map<DistributedID,IndividualView*>::const_iterator it =
             recorded_views.begin(); it != recorded_views.end(); it++)
         if (it->second->remove_base_gc_ref(TRACE_REF))
@@ -4737,6 +5116,161 @@ namespace Legion {
       }
     }
 
+    //--------------------------------------------------------------------------
+    void PhysicalTemplate::execute_chunks(unsigned worker_idx,
+                                          bool recurrent_replay)
+    //--------------------------------------------------------------------------
+    {
+      const bool profile = (trace->runtime->profiler != NULL);
+      unsigned chunk_idx;
+      while (find_ready_chunk(worker_idx, chunk_idx))
+      {
+        const ReplayChunk &chunk = replay_chunks[chunk_idx];
+        const long long start = profile ? 
+          Realm::Clock::current_time_in_nanoseconds() : 0;
+        std::vector<Instruction*> &instructions = slices[chunk.slice];
+        for (unsigned idx = chunk.first; idx < chunk.last; idx++)
+          instructions[idx]->execute(events, user_events, operations,
+                                     recurrent_replay);
+        long long path = 0;
+        if (profile)
+        {
+          // Length of the longest chain of chunks ending with this one
+          path = chunk_paths[chunk_idx].load() + 
+            (Realm::Clock::current_time_in_nanoseconds() - start);
+          long long current = replay_critical_path.load();
+          while ((current < path) && 
+              !replay_critical_path.compare_exchange_weak(current, path)) { }
+        }
+        unsigned newly_ready = 0;
+        for (std::vector<unsigned>::const_iterator it =
+              chunk.successors.begin(); it != chunk.successors.end(); it++)
+        {
+          if (profile)
+          {
+            long long current = chunk_paths[*it].load();
+            while ((current < path) &&
+                !chunk_paths[*it].compare_exchange_weak(current, path)) { }
+          }
+          if (chunk_preconditions[*it].fetch_sub(1) == 1)
+          {
+            AutoLock q_lock(replay_queues[worker_idx].lock);
+            replay_queues[worker_idx].ready.push_back(*it);
+            newly_ready++;
+          }
+        }
+        // If we exposed more chunks than we can run ourselves then see
+        // if we can wake up some idle workers to come and steal them
+        const unsigned max_workers = slices.size();
+        while (newly_ready > 1)
+        {
+          unsigned active = active_replay_workers.load();
+          if (active >= max_workers)
+            break;
+          if (!active_replay_workers.compare_exchange_weak(active, active+1))
+            continue;
+          // Add a reference for the new worker, we still hold one
+          // ourselves so the replay can't finish before it starts
+          remaining_replays.fetch_add(1);
+          launch_replay_worker(next_replay_worker.fetch_add(1) % max_workers,
+                               recurrent_replay, RtEvent::NO_RT_EVENT);
+          newly_ready--;
+        }
+#ifdef DEBUG_LEGION
+        const unsigned remaining =
+#endif
+        remaining_replays.fetch_sub(1);
+#ifdef DEBUG_LEGION
+        // This worker still holds a reference
+        assert(remaining > 1);
+#endif
+      }
+      // No more work for us to do so remove ourselves from the active set
+      // and then drop our reference on the replay, this must be the last
+      // thing that we do with the template unless we finish the replay
+      active_replay_workers.fetch_sub(1);
+      const unsigned remaining = remaining_replays.fetch_sub(1);
+#ifdef DEBUG_LEGION
+      assert(remaining > 0);
+#endif
+      if (remaining == 1)
+      {
+        if (profile)
+          report_replay_profiling(Realm::Clock::current_time_in_nanoseconds(),
+                                  replay_critical_path.load());
+        AutoLock tpl_lock(template_lock);
+        if (replay_postcondition.exists())
+          Runtime::trigger_event(replay_postcondition);
+      }
+    }
+
+    //--------------------------------------------------------------------------
+    void PhysicalTemplate::report_replay_profiling(long long stop,
+                                                   long long critical_path)
+    //--------------------------------------------------------------------------
+    {
+      const unsigned steals = replay_steals.load();
+      if (implicit_profiler != NULL)
+        implicit_profiler->record_trace_replay(
+            trace->logical_trace->get_trace_id(),
+            replay_start_time, stop, critical_path, replay_chunks.size(),
+            steals);
+      log_tracing.info("Replay of template %p with %zu chunks took %lld ns "
+          "with a measured critical path of %lld ns and %u steals", this,
+          replay_chunks.size(), stop - replay_start_time, critical_path,
+          steals);
+    }
+
+    //--------------------------------------------------------------------------
+    bool PhysicalTemplate::find_ready_chunk(unsigned worker_idx,
+                                            unsigned &chunk_idx)
+    //--------------------------------------------------------------------------
+    {
+      // Check our own queue first and take the most recently readied
+      // chunk since its inputs are most likely to still be in cache
+      {
+        ReplayQueue &queue = replay_queues[worker_idx];
+        AutoLock q_lock(queue.lock);
+        if (!queue.ready.empty())
+        {
+          chunk_idx = queue.ready.back();
+          queue.ready.pop_back();
+          return true;
+        }
+      }
+      // Otherwise try to steal the oldest chunk from another worker
+      for (unsigned offset = 1; offset < slices.size(); offset++)
+      {
+        ReplayQueue &queue = replay_queues[(worker_idx+offset) % slices.size()];
+        AutoLock q_lock(queue.lock);
+        if (!queue.ready.empty())
+        {
+          chunk_idx = queue.ready.front();
+          queue.ready.pop_front();
+          replay_steals.fetch_add(1);
+          return true;
+        }
+      }
+      return false;
+    }
+
+    //--------------------------------------------------------------------------
+    void PhysicalTemplate::launch_replay_worker(unsigned worker_idx,
+                                 bool recurrent_replay, RtEvent precondition)
+    //--------------------------------------------------------------------------
+    {
+      Runtime *runtime = trace->runtime;
+      const std::vector<Processor> &replay_targets =
+        trace->get_replay_targets();
+      ReplayChunksArgs args(this, worker_idx, recurrent_replay);
+      if (runtime->replay_on_cpus)
+        runtime->issue_application_processor_task(args, LG_LOW_PRIORITY,
+          replay_targets[worker_idx % replay_targets.size()], precondition);
+      else
+        runtime->issue_runtime_meta_task(args, LG_THROUGHPUT_WORK_PRIORITY,
+          precondition, replay_targets[worker_idx % replay_targets.size()]);
+    }
+
     //--------------------------------------------------------------------------
     ReplayableStatus PhysicalTemplate::finalize(CompleteOp *op,
                                                 bool has_blocking_call)
@@ -6454,6 +6988,8 @@ namespace Legion {
         // We also need to rerun the propagate copies analysis to
         // remove any mergers which contain only a single input
         propagate_copies(NULL/*don't need the gen out*/);
+        // The slices changed so any chunk graph needs to be rebuilt
+        replay_chunks_valid = false;
         if (trace->runtime->dump_physical_traces)
           dump_template();
       }
@@ -6897,6 +7433,231 @@ namespace Legion {
       }
     }
 
+    //--------------------------------------------------------------------------
+    unsigned PhysicalTemplate::find_replay_dependences(Instruction *inst,
+                                     std::vector<unsigned> &reads) const
+    //--------------------------------------------------------------------------
+    {
+      switch (inst->get_kind())
+      {
+        case REPLAY_MAPPING:
+          return inst->as_replay_mapping()->lhs;
+        case CREATE_AP_USER_EVENT:
+          return inst->as_create_ap_user_event()->lhs;
+        case TRIGGER_EVENT:
+          {
+            // Triggering reads the user event made by the creation
+            TriggerEvent *trigger = inst->as_trigger_event();
+            reads.push_back(trigger->lhs);
+            reads.push_back(trigger->rhs);
+            return -1U;
+          }
+        case MERGE_EVENT:
+          {
+            MergeEvent *merge = inst->as_merge_event();
+            reads.insert(reads.end(), merge->rhs.begin(), merge->rhs.end());
+            return merge->lhs;
+          }
+        case ISSUE_COPY:
+          {
+            IssueCopy *copy = inst->as_issue_copy();
+            reads.push_back(copy->precondition_idx);
+            return copy->lhs;
+          }
+        case ISSUE_FILL:
+          {
+            IssueFill *fill = inst->as_issue_fill();
+            reads.push_back(fill->precondition_idx);
+            return fill->lhs;
+          }
+        case ISSUE_ACROSS:
+          {
+            IssueAcross *across = inst->as_issue_across();
+            reads.push_back(across->copy_precondition);
+            reads.push_back(across->collective_precondition);
+            reads.push_back(across->src_indirect_precondition);
+            reads.push_back(across->dst_indirect_precondition);
+            return across->lhs;
+          }
+        case SET_OP_SYNC_EVENT:
+          return inst->as_set_op_sync_event()->lhs;
+        case ASSIGN_FENCE_COMPLETION:
+          return inst->as_assignment_fence_completion()->lhs;
+        case COMPLETE_REPLAY:
+          {
+            reads.push_back(inst->as_complete_replay()->complete);
+            return -1U;
+          }
+        case BARRIER_ARRIVAL:
+          {
+            BarrierArrival *arrival = inst->as_barrier_arrival();
+            reads.push_back(arrival->rhs);
+            return arrival->lhs;
+          }
+        case BARRIER_ADVANCE:
+          return inst->as_barrier_advance()->lhs;
+        default:
+          assert(false);
+      }
+      return -1U;
+    }
+
+    //--------------------------------------------------------------------------
+    void PhysicalTemplate::prepare_replay_chunks(void)
+    //--------------------------------------------------------------------------
+    {
+      // Cut each slice into chunks of consecutive instructions and record
+      // the dependences between chunks of the same slice. Dependences 
+      // between slices are already handled by the crossing events so 
+      // chunks from different slices can always run in parallel.
+      replay_chunks.clear();
+      std::vector<std::set<unsigned> > chunk_preds;
+      std::vector<unsigned> reads;
+      for (unsigned sidx = 0; sidx < slices.size(); sidx++)
+      {
+        const std::vector<Instruction*> &instructions = slices[sidx];
+        // Complete replays are pushed to the end of each slice and have
+        // to stay behind all the other instructions in the slice
+        unsigned tail = instructions.size();
+        while ((tail > 0) && 
+            (instructions[tail-1]->get_kind() == COMPLETE_REPLAY))
+          tail--;
+        const unsigned first_chunk = replay_chunks.size();
+        std::map<unsigned,unsigned> event_chunks;
+        std::map<TraceLocalID,unsigned> owner_chunks;
+        for (unsigned first = 0; first < tail; 
+              first += LEGION_REPLAY_CHUNK_SIZE)
+        {
+          const unsigned chunk_idx = replay_chunks.size();
+          replay_chunks.resize(chunk_idx + 1);
+          chunk_preds.resize(chunk_idx + 1);
+          ReplayChunk &chunk = replay_chunks.back();
+          chunk.slice = sidx;
+          chunk.first = first;
+          chunk.last = std::min(first + LEGION_REPLAY_CHUNK_SIZE, tail);
+          for (unsigned idx = chunk.first; idx < chunk.last; idx++)
+          {
+            Instruction *inst = instructions[idx];
+            reads.clear();
+            const unsigned lhs = find_replay_dependences(inst, reads);
+            for (std::vector<unsigned>::const_iterator it =
+                  reads.begin(); it != reads.end(); it++)
+            {
+              // Events not generated in this slice are either assigned
+              // before the replay starts or are crossing events
+              std::map<unsigned,unsigned>::const_iterator finder =
+                event_chunks.find(*it);
+              if ((finder != event_chunks.end()) && 
+                  (finder->second != chunk_idx))
+                chunk_preds[chunk_idx].insert(finder->second);
+            }
+            // Instructions for the same operation stay in program order
+            std::map<TraceLocalID,unsigned>::iterator finder =
+              owner_chunks.find(inst->owner);
+            if (finder != owner_chunks.end())
+            {
+              if (finder->second != chunk_idx)
+                chunk_preds[chunk_idx].insert(finder->second);
+              finder->second = chunk_idx;
+            }
+            else
+              owner_chunks[inst->owner] = chunk_idx;
+            if (lhs != -1U)
+              event_chunks[lhs] = chunk_idx;
+          }
+        }
+        if (tail < instructions.size())
+        {
+          const unsigned chunk_idx = replay_chunks.size();
+          replay_chunks.resize(chunk_idx + 1);
+          chunk_preds.resize(chunk_idx + 1);
+          ReplayChunk &chunk = replay_chunks.back();
+          chunk.slice = sidx;
+          chunk.first = tail;
+          chunk.last = instructions.size();
+          for (unsigned idx = first_chunk; idx < chunk_idx; idx++)
+            chunk_preds[chunk_idx].insert(idx);
+        }
+      }
+      // Fill in the successors and compute the critical path through 
+      // the graph in instructions, chunks are already in topological order
+      std::vector<unsigned> path_lengths(replay_chunks.size(), 0);
+      unsigned critical_path = 0, total_instructions = 0;
+      for (unsigned idx = 0; idx < replay_chunks.size(); idx++)
+      {
+        ReplayChunk &chunk = replay_chunks[idx];
+        chunk.preconditions = chunk_preds[idx].size();
+        for (std::set<unsigned>::const_iterator it =
+              chunk_preds[idx].begin(); it != chunk_preds[idx].end(); it++)
+        {
+#ifdef DEBUG_LEGION
+          assert(*it < idx);
+#endif
+          replay_chunks[*it].successors.push_back(idx);
+          path_lengths[idx] = std::max(path_lengths[idx], path_lengths[*it]);
+        }
+        const unsigned size = chunk.last - chunk.first;
+        path_lengths[idx] += size;
+        total_instructions += size;
+        critical_path = std::max(critical_path, path_lengths[idx]);
+      }
+      log_tracing.info("Replay graph for template %p has %zd chunks with "
+          "%d instructions and a critical path of %d instructions", this,
+          replay_chunks.size(), total_instructions, critical_path);
+      if (chunk_preconditions != NULL)
+        delete [] chunk_preconditions;
+      if (chunk_paths != NULL)
+        delete [] chunk_paths;
+      chunk_preconditions = replay_chunks.empty() ? NULL :
+        new std::atomic<unsigned>[replay_chunks.size()];
+      chunk_paths = replay_chunks.empty() ? NULL :
+        new std::atomic<long long>[replay_chunks.size()];
+      if (replay_queues == NULL)
+        replay_queues = new ReplayQueue[slices.size()];
+      replay_chunks_valid = true;
+    }
+
+    //--------------------------------------------------------------------------
+    void PhysicalTemplate::initialize_replay_chunks(void)
+    //--------------------------------------------------------------------------
+    {
+      if (!replay_chunks_valid)
+        prepare_replay_chunks();
+#ifdef DEBUG_LEGION
+      assert(active_replay_workers.load() == 0);
+      for (unsigned idx = 0; idx < slices.size(); idx++)
+        assert(replay_queues[idx].ready.empty());
+#endif
+      // Seed each slice's queue with its ready chunks and count one
+      // reference for each chunk and for each worker that we'll launch
+      unsigned initial_workers = 0;
+      for (unsigned idx = 0; idx < replay_chunks.size(); idx++)
+      {
+        const ReplayChunk &chunk = replay_chunks[idx];
+        chunk_preconditions[idx].store(chunk.preconditions);
+        chunk_paths[idx].store(0);
+        if (chunk.preconditions == 0)
+        {
+          std::deque<unsigned> &ready = replay_queues[chunk.slice].ready;
+          if (ready.empty())
+            initial_workers++;
+          ready.push_back(idx);
+        }
+      }
+      active_replay_workers.store(initial_workers);
+      next_replay_worker.store(0);
+      replay_critical_path.store(0);
+      replay_steals.store(0);
+      remaining_replays.store(replay_chunks.size() + initial_workers);
+      // An empty template launches no workers so none of them will be
+      // around to report the replay, do it here instead
+      if (replay_chunks.empty() && (trace->runtime->profiler != NULL))
+      {
+        replay_start_time = Realm::Clock::current_time_in_nanoseconds();
+        report_replay_profiling(replay_start_time, 0/*critical path*/);
+      }
+    }
+
     //--------------------------------------------------------------------------
     void PhysicalTemplate::dump_template(void) const
     //--------------------------------------------------------------------------
@@ -7839,10 +8600,13 @@ namespace Legion {
       }
       else
         replay_precondition = RtEvent::NO_RT_EVENT;
-      remaining_replays.store(slices.size());
       total_logical.store(0);
       // Check to see if we have a finished transitive reduction result
       check_finalize_transitive_reduction();
+      if (trace->runtime->replay_stealing)
+        initialize_replay_chunks();
+      else
+        remaining_replays.store(slices.size());
 
       if (recurrent)
       {
@@ -7876,6 +8640,18 @@ namespace Legion {
       Runtime *runtime = trace->runtime;
       const std::vector<Processor> &replay_targets = 
         trace->get_replay_targets();
+      if (runtime->replay_stealing)
+      {
+        // Start one worker for each queue with ready chunks, the
+        // workers will steal and spawn more workers as needed
+        if (runtime->profiler != NULL)
+          replay_start_time = Realm::Clock::current_time_in_nanoseconds();
+        for (unsigned idx = 0; idx < slices.size(); ++idx)
+          if (!replay_queues[idx].ready.empty())
+            launch_replay_worker(idx, trace->is_recurrent(),
+                                 replay_precondition);
+        return;
+      }
 #ifdef DEBUG_LEGION
       assert(remaining_replays.load() == slices.size());
 #endif
@@ -8012,6 +8788,14 @@ namespace Legion {
       pargs->tpl->execute_slice(pargs->slice_index, pargs->recurrent_replay);
     }
 
+    //--------------------------------------------------------------------------
+    /*static*/ void PhysicalTemplate::handle_replay_chunks(const void *args)
+    //--------------------------------------------------------------------------
+    {
+      const ReplayChunksArgs *rargs = (const ReplayChunksArgs*)args;
+      rargs->tpl->execute_chunks(rargs->worker_index, rargs->recurrent_replay);
+    }
+
     //--------------------------------------------------------------------------
     /*static*/ void PhysicalTemplate::handle_transitive_reduction(
                                                                const void *args)
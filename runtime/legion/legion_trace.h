@@ -142,6 +142,7 @@ namespace Legion {
     public:
       bool initialize_op_tracing(Operation *op,
                      const std::vector<StaticDependence> *dependences = NULL);
+      static void hash_requirements(Operation *op, Murmur3Hasher &hasher);
       void check_operation_count(void);
       bool skip_analysis(RegionTreeID tid) const;
       size_t register_operation(Operation *op, GenerationID gen);
@@ -227,6 +228,83 @@ namespace Legion {
 #endif
     };
 
+    /**
+     * \class AutomaticTracer
+     * The automatic tracer watches the stream of operations that an
+     * application launches in an inner context and looks for sequences
+     * of operations that repeat back-to-back. Once a sequence has been
+     * observed to repeat it becomes a candidate trace. Later operations
+     * that match the prefix of a candidate are buffered by the tracer
+     * and only issued once we know whether they match the whole
+     * candidate. If they do they are issued inside of a dynamically
+     * generated trace so they can be captured and replayed without
+     * any annotations from the application. If they do not match, or
+     * if the application performs a blocking call, then the buffered
+     * operations are issued without a trace. The amount of history 
+     * and the number of candidate traces are both bounded.
+     */
+    class AutomaticTracer {
+    public:
+      struct Candidate {
+      public:
+        Candidate(TraceID t, std::vector<uint64_t> &&h)
+          : tid(t), hashes(h), trace(NULL), replays(0), retired(false) { }
+      public:
+        const TraceID tid;
+        const std::vector<uint64_t> hashes;
+        LogicalTrace *trace;
+        unsigned replays;
+        bool retired;
+      };
+    public:
+      AutomaticTracer(InnerContext *ctx);
+      AutomaticTracer(const AutomaticTracer &rhs) = delete;
+      ~AutomaticTracer(void);
+    public:
+      AutomaticTracer& operator=(const AutomaticTracer &rhs) = delete;
+    public:
+      inline bool is_flushing(void) const { return flushing; }
+      inline bool has_pending_operations(void) const 
+        { return !pending.empty(); }
+      // Returns true if the tracer took ownership of issuing the operation
+      bool record_operation(Operation *op,
+                            const std::vector<StaticDependence> *deps);
+      // Issue any buffered operations without a trace
+      void flush(void);
+    protected:
+      static bool compute_hash(Operation *op, uint64_t &hash);
+      void observe(uint64_t hash);
+      void reset_detection(void);
+      bool start_match(Operation *op, uint64_t hash);
+      void issue_pending(void);
+      void issue_trace(Candidate *candidate);
+    public:
+      InnerContext *const context;
+      const size_t window;
+      const size_t min_length;
+      const size_t max_traces;
+    protected:
+      // Ring buffer of the hashes of the most recent operations
+      std::vector<uint64_t> history;
+      uint64_t observed;
+      // Most recent position in the history of each hash
+      std::unordered_map<uint64_t,uint64_t> last_seen;
+      // Period of the repetition that we are currently tracking
+      // and how many operations in a row have matched it
+      uint64_t period;
+      uint64_t run_length;
+    protected:
+      std::vector<Candidate*> candidates;
+      std::unordered_map<uint64_t,std::vector<Candidate*> > starts;
+      std::unordered_set<uint64_t> signatures;
+    protected:
+      // Operations buffered while matching candidates
+      std::vector<std::pair<Operation*,uint64_t> > pending;
+      // Candidates still consistent with the pending operations
+      std::vector<Candidate*> live;
+      bool flushing;
+    };
+
     class TraceOp : public FenceOp {
     public:
       TraceOp(Runtime *rt);
@@ -507,6 +585,9 @@ namespace Legion {
       inline bool is_replaying(void) const { return !recording; }
       inline bool is_recurrent(void) const { return recurrent; }
       size_t get_expected_operation_count(void) const;
+      // Number of recordings since a template was last replayed
+      inline unsigned get_failed_replay_count(void) const
+        { return nonreplayable_count.load() + new_template_count.load(); }
     public:
       void record_parent_req_fields(unsigned index, const FieldMask &mask);
       void find_condition_sets(std::map<EquivalenceSet*,unsigned> &sets) const;
@@ -545,8 +626,8 @@ namespace Legion {
       LegionMap<unsigned,FieldMask> parent_req_fields;
       std::vector<PhysicalTemplate*> templates;
       PhysicalTemplate* current_template;
-      unsigned nonreplayable_count;
-      unsigned new_template_count; 
+      std::atomic<unsigned> nonreplayable_count;
+      std::atomic<unsigned> new_template_count;
     private:
       std::vector<Processor> replay_targets;
       bool recording;
@@ -693,6 +774,9 @@ namespace Legion {
       bool check_anticonditions(void);
       void apply_postconditions(FenceOp *op, unsigned index,
                                 std::set<RtEvent> &applied_events);
+    protected:
+      bool is_unchanged(EquivalenceSet *set, bool precondition);
+      void commit_versions(bool success);
     public:
       PhysicalTemplate *const owner;
       IndexSpaceExpression *const condition_expr;
@@ -706,6 +790,15 @@ namespace Legion {
         InvalidInstAnalysis *invalid;
         AntivalidInstAnalysis *antivalid;
       } analysis;
+      // Versions of the local equivalence sets the last time they were
+      // found to satisfy this condition set so that we can skip testing
+      // them again if they have not changed since then
+      std::map<DistributedID,uint64_t> verified_versions;
+      // Versions we expect equivalence sets to have once the overwrite from
+      // applying these conditions as postconditions has been performed
+      std::map<DistributedID,uint64_t> postcondition_versions;
+      // Versions observed during the current test to commit on success
+      std::map<DistributedID,uint64_t> pending_versions;
       bool shared;
     };
 
@@ -732,6 +825,18 @@ namespace Legion {
         const unsigned slice_index;
         const bool recurrent_replay;
       }; 
+      struct ReplayChunksArgs : public LgTaskArgs<ReplayChunksArgs> {
+      public:
+        static const LgTaskID TASK_ID = LG_REPLAY_CHUNKS_TASK_ID;
+      public:
+        ReplayChunksArgs(PhysicalTemplate *t, unsigned wi, bool recurrent)
+          : LgTaskArgs<ReplayChunksArgs>(implicit_provenance),
+            tpl(t), worker_index(wi), recurrent_replay(recurrent) { }
+      public:
+        PhysicalTemplate *const tpl;
+        const unsigned worker_index;
+        const bool recurrent_replay;
+      };
       struct DeleteTemplateArgs : public LgTaskArgs<DeleteTemplateArgs> {
       public:
         static const LgTaskID TASK_ID = LG_DELETE_TEMPLATE_TASK_ID;
@@ -742,6 +847,21 @@ namespace Legion {
         PhysicalTemplate *const tpl;
       };
     private:
+      // A chunk is a contiguous run of instructions from one slice that
+      // can be executed by any replay worker once all the chunks that
+      // produce its inputs have been executed
+      struct ReplayChunk {
+      public:
+        unsigned slice;
+        unsigned first, last;
+        unsigned preconditions;
+        std::vector<unsigned> successors;
+      };
+      struct ReplayQueue {
+      public:
+        LocalLock lock;
+        std::deque<unsigned> ready;
+      };
       struct CachedPremapping
       {
         std::vector<Memory>     future_locations;
@@ -873,6 +993,14 @@ namespace Legion {
       void eliminate_dead_code(std::vector<unsigned> &gen);
       void prepare_parallel_replay(const std::vector<unsigned> &gen);
       void push_complete_replays(void);
+      void prepare_replay_chunks(void);
+      void initialize_replay_chunks(void);
+      void launch_replay_worker(unsigned worker_idx, bool recurrent_replay,
+                                RtEvent precondition);
+      bool find_ready_chunk(unsigned worker_idx, unsigned &chunk_idx);
+      void report_replay_profiling(long long stop, long long critical_path);
+      unsigned find_replay_dependences(Instruction *inst,
+                                       std::vector<unsigned> &reads) const;
     protected:
       virtual void sync_compute_frontiers(CompleteOp *op,
                           const std::vector<RtEvent> &frontier_events);
@@ -905,6 +1033,7 @@ namespace Legion {
       bool can_start_replay(void);
       void register_operation(MemoizableOp *op);
       void execute_slice(unsigned slice_idx, bool recurrent_replay);
+      void execute_chunks(unsigned worker_idx, bool recurrent_replay);
     public:
       void dump_template(void) const;
       virtual void dump_sharded_template(void) const { }
@@ -1087,6 +1216,7 @@ namespace Legion {
                                    std::set<RtEvent> &applied_events);
     public:
       static void handle_replay_slice(const void *args);
+      static void handle_replay_chunks(const void *args);
       static void handle_transitive_reduction(const void *args);
       static void handle_delete_template(const void *args);
     protected:
@@ -1177,6 +1307,18 @@ namespace Legion {
       std::vector<Instruction*>               instructions;
       std::vector<std::vector<Instruction*> > slices;
       std::vector<std::vector<TraceLocalID> > slice_tasks;
+    protected:
+      // Dependence graph of chunks for replaying with work stealing
+      std::vector<ReplayChunk>                replay_chunks;
+      std::atomic<unsigned>                   *chunk_preconditions;
+      std::atomic<long long>                  *chunk_paths;
+      ReplayQueue                             *replay_queues;
+      std::atomic<unsigned>                   active_replay_workers;
+      std::atomic<unsigned>                   next_replay_worker;
+      std::atomic<long long>                  replay_critical_path;
+      std::atomic<unsigned>                   replay_steals;
+      long long                               replay_start_time;
+      bool                                    replay_chunks_valid;
     protected:
       std::map<unsigned/*event*/,unsigned/*consumers*/> crossing_events;
       // Frontiers of a template are a set of users whose events must
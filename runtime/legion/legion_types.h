@@ -109,6 +109,11 @@ template<unsigned int MAX> class SSETLBitMask;
 template<unsigned int MAX> class AVXBitMask;
 template<unsigned int MAX> class AVXTLBitMask;
 #endif
+#ifdef __AVX512F__
+template<unsigned int MAX> class AVX512BitMask;
+template<unsigned int MAX> class AVX512TLBitMask;
+#endif
+template<unsigned int MAX> class DispatchTLBitMask;
 #ifdef __ALTIVEC__
 template<unsigned int MAX> class PPCBitMask;
 template<unsigned int MAX> class PPCTLBitMask;
@@ -380,6 +385,7 @@ namespace Legion {
       LG_DEFERRED_COMMIT_ID,
       LG_PRE_PIPELINE_ID,
       LG_TRIGGER_DEPENDENCE_ID,
+      LG_PARALLEL_DEPENDENCE_ID,
       LG_DEFERRED_MAPPED_ID,
       LG_TRIGGER_OP_ID,
       LG_TRIGGER_TASK_ID,
@@ -425,6 +431,7 @@ namespace Legion {
       LG_DEFER_COMPOSITE_COPY_TASK_ID,
       LG_TIGHTEN_INDEX_SPACE_TASK_ID,
       LG_REPLAY_SLICE_TASK_ID,
+      LG_REPLAY_CHUNKS_TASK_ID,
       LG_TRANSITIVE_REDUCTION_TASK_ID,
       LG_DELETE_TEMPLATE_TASK_ID,
       LG_DEFER_MAKE_OWNER_TASK_ID,
@@ -490,6 +497,7 @@ namespace Legion {
         "Deferred Commit",                                        \
         "Prepipeline Stage",                                      \
         "Logical Dependence Analysis",                            \
+        "Parallel Logical Dependence Analysis",                   \
         "Deferred Mapped",                                        \
         "Trigger Operation Mapping",                              \
         "Trigger Task Mapping",                                   \
@@ -535,6 +543,7 @@ namespace Legion {
         "Defer Composite Copy",                                   \
         "Tighten Index Space",                                    \
         "Replay Physical Trace",                                  \
+        "Replay Physical Trace Chunks",                           \
         "Template Transitive Reduction",                          \
         "Delete Physical Template",                               \
         "Defer Equivalence Set Make Owner",                       \
@@ -1665,6 +1674,7 @@ namespace Legion {
       PHYSICAL_TRACE_EXECUTE_CALL,
       PHYSICAL_TRACE_PRECONDITION_CHECK_CALL,
       PHYSICAL_TRACE_OPTIMIZE_CALL,
+      PHYSICAL_TRACE_REPLAY_CALL,
       LAST_RUNTIME_CALL_KIND, // This one must be last
     };
 
@@ -1892,6 +1902,7 @@ namespace Legion {
       "Physical Trace Execute",                                       \
       "Physical Trace Precondition Check",                            \
       "Physical Trace Optimize",                                      \
+      "Physical Trace Replay",                                        \
     };
 
     enum SemanticInfoKind {
@@ -2052,6 +2063,7 @@ namespace Legion {
     class LegionHandshakeImpl;
     class ProcessorManager;
     class MemoryManager;
+    class MessageStatistics;
     class VirtualChannel;
     class MessageManager;
     class ShutdownManager;
@@ -2145,6 +2157,7 @@ namespace Legion {
 
     // legion_trace.h
     class LogicalTrace;
+    class AutomaticTracer;
     class TraceBeginOp;
     class TraceRecurrentOp;
     class TraceCompleteOp;
@@ -2690,58 +2703,88 @@ namespace Legion {
 #define LEGION_FIELD_MASK_FIELD_MASK          0x3F
 #define LEGION_FIELD_MASK_FIELD_ALL_ONES      0xFFFFFFFFFFFFFFFF
 
-#if defined(__AVX__)
+#if defined(LEGION_DISPATCH_FIELD_MASKS) && (LEGION_MAX_FIELDS > 128)
+    // Portable builds pick the widest vector instructions the machine
+    // supports when the runtime starts instead of at compile time
+    typedef DispatchTLBitMask<LEGION_MAX_FIELDS> DenseFieldMask;
+#elif defined(__AVX512F__)
 #if (LEGION_MAX_FIELDS > 256)
-    typedef AVXTLBitMask<LEGION_MAX_FIELDS> FieldMask;
+    typedef AVX512TLBitMask<LEGION_MAX_FIELDS> DenseFieldMask;
 #elif (LEGION_MAX_FIELDS > 128)
-    typedef AVXBitMask<LEGION_MAX_FIELDS> FieldMask;
+    typedef AVXBitMask<LEGION_MAX_FIELDS> DenseFieldMask;
 #elif (LEGION_MAX_FIELDS > 64)
-    typedef SSEBitMask<LEGION_MAX_FIELDS> FieldMask;
+    typedef SSEBitMask<LEGION_MAX_FIELDS> DenseFieldMask;
 #else
     typedef BitMask<LEGION_FIELD_MASK_FIELD_TYPE,LEGION_MAX_FIELDS,
                     LEGION_FIELD_MASK_FIELD_SHIFT,
-                    LEGION_FIELD_MASK_FIELD_MASK> FieldMask;
+                    LEGION_FIELD_MASK_FIELD_MASK> DenseFieldMask;
+#endif
+#elif defined(__AVX__)
+#if (LEGION_MAX_FIELDS > 256)
+    typedef AVXTLBitMask<LEGION_MAX_FIELDS> DenseFieldMask;
+#elif (LEGION_MAX_FIELDS > 128)
+    typedef AVXBitMask<LEGION_MAX_FIELDS> DenseFieldMask;
+#elif (LEGION_MAX_FIELDS > 64)
+    typedef SSEBitMask<LEGION_MAX_FIELDS> DenseFieldMask;
+#else
+    typedef BitMask<LEGION_FIELD_MASK_FIELD_TYPE,LEGION_MAX_FIELDS,
+                    LEGION_FIELD_MASK_FIELD_SHIFT,
+                    LEGION_FIELD_MASK_FIELD_MASK> DenseFieldMask;
 #endif
 #elif defined(__SSE2__)
 #if (LEGION_MAX_FIELDS > 128)
-    typedef SSETLBitMask<LEGION_MAX_FIELDS> FieldMask;
+    typedef SSETLBitMask<LEGION_MAX_FIELDS> DenseFieldMask;
 #elif (LEGION_MAX_FIELDS > 64)
-    typedef SSEBitMask<LEGION_MAX_FIELDS> FieldMask;
+    typedef SSEBitMask<LEGION_MAX_FIELDS> DenseFieldMask;
 #else
     typedef BitMask<LEGION_FIELD_MASK_FIELD_TYPE,LEGION_MAX_FIELDS,
                     LEGION_FIELD_MASK_FIELD_SHIFT,
-                    LEGION_FIELD_MASK_FIELD_MASK> FieldMask;
+                    LEGION_FIELD_MASK_FIELD_MASK> DenseFieldMask;
 #endif
 #elif defined(__ALTIVEC__)
 #if (LEGION_MAX_FIELDS > 128)
-    typedef PPCTLBitMask<LEGION_MAX_FIELDS> FieldMask;
+    typedef PPCTLBitMask<LEGION_MAX_FIELDS> DenseFieldMask;
 #elif (LEGION_MAX_FIELDS > 64)
-    typedef PPCBitMask<LEGION_MAX_FIELDS> FieldMask;
+    typedef PPCBitMask<LEGION_MAX_FIELDS> DenseFieldMask;
 #else
     typedef BitMask<LEGION_FIELD_MASK_FIELD_TYPE,LEGION_MAX_FIELDS,
                     LEGION_FIELD_MASK_FIELD_SHIFT,
-                    LEGION_FIELD_MASK_FIELD_MASK> FieldMask;
+                    LEGION_FIELD_MASK_FIELD_MASK> DenseFieldMask;
 #endif
 #elif defined(__ARM_NEON)
 #if (LEGION_MAX_FIELDS > 128)
-    typedef NeonTLBitMask<LEGION_MAX_FIELDS> FieldMask;
+    typedef NeonTLBitMask<LEGION_MAX_FIELDS> DenseFieldMask;
 #elif (LEGION_MAX_FIELDS > 64)
-    typedef NeonBitMask<LEGION_MAX_FIELDS> FieldMask;
+    typedef NeonBitMask<LEGION_MAX_FIELDS> DenseFieldMask;
 #else
     typedef BitMask<LEGION_FIELD_MASK_FIELD_TYPE,LEGION_MAX_FIELDS,
                     LEGION_FIELD_MASK_FIELD_SHIFT,
-                    LEGION_FIELD_MASK_FIELD_MASK> FieldMask;
+                    LEGION_FIELD_MASK_FIELD_MASK> DenseFieldMask;
 #endif
 #else
 #if (LEGION_MAX_FIELDS > 64)
     typedef TLBitMask<LEGION_FIELD_MASK_FIELD_TYPE,LEGION_MAX_FIELDS,
                       LEGION_FIELD_MASK_FIELD_SHIFT,
-                      LEGION_FIELD_MASK_FIELD_MASK> FieldMask;
+                      LEGION_FIELD_MASK_FIELD_MASK> DenseFieldMask;
 #else
     typedef BitMask<LEGION_FIELD_MASK_FIELD_TYPE,LEGION_MAX_FIELDS,
                     LEGION_FIELD_MASK_FIELD_SHIFT,
-                    LEGION_FIELD_MASK_FIELD_MASK> FieldMask;
+                    LEGION_FIELD_MASK_FIELD_MASK> DenseFieldMask;
 #endif
+#endif
+#ifdef LEGION_SPARSE_FIELD_MASKS
+    // Sparse field masks keep the indices of a few set fields inline and
+    // only switch to a heap-allocated dense SIMD mask once more fields than
+    // that are set, so a mask costs a couple of words instead of
+    // LEGION_MAX_FIELDS bits and applications with thousands of fields
+    // don't pay for them in every analysis structure. This is experimental:
+    // the mask is still bounded by LEGION_MAX_FIELDS at compile time (it is
+    // not a runtime-sized mask) and its memory and analysis time have not
+    // been measured against the dense masks on real applications yet.
+    typedef CompoundBitMask<DenseFieldMask,
+            LEGION_SPARSE_FIELD_MASK_BLOAT,true/*bidir*/> FieldMask;
+#else
+    typedef DenseFieldMask FieldMask;
 #endif
     typedef BitPermutation<FieldMask,LEGION_FIELD_LOG2> FieldPermutation;
     typedef Fraction<unsigned long> InstFrac;
@@ -107,6 +107,14 @@ namespace Legion {
       template<unsigned int MAX>
       inline void serialize(const AVXTLBitMask<MAX> &mask);
 #endif
+#ifdef __AVX512F__
+      template<unsigned int MAX>
+      inline void serialize(const AVX512BitMask<MAX> &mask);
+      template<unsigned int MAX>
+      inline void serialize(const AVX512TLBitMask<MAX> &mask);
+#endif
+      template<unsigned int MAX>
+      inline void serialize(const DispatchTLBitMask<MAX> &mask);
 #ifdef __ALTIVEC__
       template<unsigned int MAX>
       inline void serialize(const PPCBitMask<MAX> &mask);
@@ -197,6 +205,14 @@ namespace Legion {
       template<unsigned int MAX>
       inline void deserialize(AVXTLBitMask<MAX> &mask);
 #endif
+#ifdef __AVX512F__
+      template<unsigned int MAX>
+      inline void deserialize(AVX512BitMask<MAX> &mask);
+      template<unsigned int MAX>
+      inline void deserialize(AVX512TLBitMask<MAX> &mask);
+#endif
+      template<unsigned int MAX>
+      inline void deserialize(DispatchTLBitMask<MAX> &mask);
 #ifdef __ALTIVEC__
       template<unsigned int MAX>
       inline void deserialize(PPCBitMask<MAX> &mask);
@@ -904,6 +920,32 @@ namespace Legion {
     }
 #endif
 
+#ifdef __AVX512F__
+    //--------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline void Serializer::serialize(const AVX512BitMask<MAX> &mask)
+    //--------------------------------------------------------------------------
+    {
+      mask.serialize(*this);
+    }
+
+    //--------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline void Serializer::serialize(const AVX512TLBitMask<MAX> &mask)
+    //--------------------------------------------------------------------------
+    {
+      mask.serialize(*this);
+    }
+#endif
+
+    //--------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline void Serializer::serialize(const DispatchTLBitMask<MAX> &mask)
+    //--------------------------------------------------------------------------
+    {
+      mask.serialize(*this);
+    }
+
 #ifdef __ALTIVEC__
     //--------------------------------------------------------------------------
     template<unsigned int MAX>
@@ -1168,6 +1210,32 @@ namespace Legion {
     }
 #endif
 
+#ifdef __AVX512F__
+    //--------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline void Deserializer::deserialize(AVX512BitMask<MAX> &mask)
+    //--------------------------------------------------------------------------
+    {
+      mask.deserialize(*this);
+    }
+
+    //--------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline void Deserializer::deserialize(AVX512TLBitMask<MAX> &mask)
+    //--------------------------------------------------------------------------
+    {
+      mask.deserialize(*this);
+    }
+#endif
+
+    //--------------------------------------------------------------------------
+    template<unsigned int MAX>
+    inline void Deserializer::deserialize(DispatchTLBitMask<MAX> &mask)
+    //--------------------------------------------------------------------------
+    {
+      mask.deserialize(*this);
+    }
+
 #ifdef __ALTIVEC__
     //--------------------------------------------------------------------------
     template<unsigned int MAX>
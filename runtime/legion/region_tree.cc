@@ -5511,6 +5511,24 @@ namespace Legion {
       assert(expressions.size() >= 2);
       assert(expressions.size() <= MAX_EXPRESSION_FANOUT);
 #endif
+      // Check the hash-consing table first since it avoids the trie locks
+      IndexSpaceExpression *result = find_hashed_operation(
+          IndexSpaceOperation::UNION_OP_KIND, expressions);
+      if (result != NULL)
+        return result;
+      // Fall back to the trie which resolves any races to create it
+      result = find_or_create_union(expressions, creator);
+      record_hashed_operation(IndexSpaceOperation::UNION_OP_KIND,
+                              expressions, result);
+      return result;
+    }
+
+    //--------------------------------------------------------------------------
+    IndexSpaceExpression* RegionTreeForest::find_or_create_union(
+                          const std::vector<IndexSpaceExpression*> &expressions,
+                          OperationCreator *creator)
+    //--------------------------------------------------------------------------
+    {
       IndexSpaceExpression *first = expressions[0];
       const IndexSpaceExprID key = first->expr_id;
       // See if we can find it in read-only mode
@@ -5781,6 +5799,24 @@ namespace Legion {
       assert(expressions.size() >= 2);
       assert(expressions.size() <= MAX_EXPRESSION_FANOUT);
 #endif
+      // Check the hash-consing table first since it avoids the trie locks
+      IndexSpaceExpression *result = find_hashed_operation(
+          IndexSpaceOperation::INTERSECT_OP_KIND, expressions);
+      if (result != NULL)
+        return result;
+      // Fall back to the trie which resolves any races to create it
+      result = find_or_create_intersection(expressions, creator);
+      record_hashed_operation(IndexSpaceOperation::INTERSECT_OP_KIND,
+                              expressions, result);
+      return result;
+    }
+
+    //--------------------------------------------------------------------------
+    IndexSpaceExpression* RegionTreeForest::find_or_create_intersection(
+                          const std::vector<IndexSpaceExpression*> &expressions,
+                          OperationCreator *creator)
+    //--------------------------------------------------------------------------
+    {
       IndexSpaceExpression *first = expressions[0];
       const IndexSpaceExprID key = first->expr_id;
       // See if we can find it in read-only mode
@@ -5873,9 +5909,13 @@ namespace Legion {
       std::vector<IndexSpaceExpression*> expressions(2);
       expressions[0] = lhs->get_canonical_expression(this);
       expressions[1] = rhs->get_canonical_expression(this);
+      // Check the hash-consing table first since it avoids the trie locks
+      IndexSpaceExpression *result = find_hashed_operation(
+          IndexSpaceOperation::DIFFERENCE_OP_KIND, expressions);
+      if (result != NULL)
+        return result;
       const IndexSpaceExprID key = expressions[0]->expr_id;
       // See if we can find it in read-only mode
-      IndexSpaceExpression *result = NULL;
       {
         AutoLock l_lock(lookup_is_op_lock,1,false/*exclusive*/);
         std::map<IndexSpaceExprID,ExpressionTrieNode*>::const_iterator 
@@ -5948,6 +5988,8 @@ namespace Legion {
           result = node->find_or_create_operation(expressions, *creator);
         }
       }
+      record_hashed_operation(IndexSpaceOperation::DIFFERENCE_OP_KIND,
+                              expressions, result);
       return result;
     }
 
@@ -5988,6 +6030,131 @@ namespace Legion {
         canonical_expressions.erase(key);
     }
 
+    //--------------------------------------------------------------------------
+    /*static*/ uint64_t RegionTreeForest::hash_operation(unsigned kind,
+                          const std::vector<IndexSpaceExpression*> &exprs)
+    //--------------------------------------------------------------------------
+    {
+      Murmur3Hasher hasher;
+      hasher.hash(kind);
+      for (std::vector<IndexSpaceExpression*>::const_iterator it =
+            exprs.begin(); it != exprs.end(); it++)
+        hasher.hash((*it)->expr_id);
+      uint64_t hash[2];
+      hasher.finalize(hash);
+      return hash[0] ^ hash[1];
+    }
+
+    //--------------------------------------------------------------------------
+    IndexSpaceExpression* RegionTreeForest::find_hashed_operation(unsigned kind,
+                          const std::vector<IndexSpaceExpression*> &exprs)
+    //--------------------------------------------------------------------------
+    {
+      const uint64_t hash = hash_operation(kind, exprs);
+      HashedOperationStripe &stripe = 
+        hashed_operations[hash % HASHED_OPERATION_STRIPES];
+      // Holding the stripe lock in read-only mode prevents the operation
+      // from being removed (and therefore deleted) while we try to add
+      // our reference to it
+      AutoLock s_lock(stripe.stripe_lock,1,false/*exclusive*/);
+      std::pair<std::unordered_multimap<uint64_t,HashedOperation>::
+        const_iterator,std::unordered_multimap<uint64_t,HashedOperation>::
+          const_iterator> range = stripe.operations.equal_range(hash);
+      for (std::unordered_multimap<uint64_t,HashedOperation>::const_iterator
+            it = range.first; it != range.second; it++)
+      {
+        const HashedOperation &entry = it->second;
+        if ((entry.kind != kind) || (entry.operands.size() != exprs.size()))
+          continue;
+        bool match = true;
+        for (unsigned idx = 0; idx < exprs.size(); idx++)
+        {
+          if (entry.operands[idx] == exprs[idx]->expr_id)
+            continue;
+          match = false;
+          break;
+        }
+        if (!match)
+          continue;
+        // If it is being deleted then fall back to the trie which
+        // will take care of resolving the race to make a new one
+        if (entry.operation->try_add_live_reference())
+          return entry.operation;
+        return NULL;
+      }
+      return NULL;
+    }
+
+    //--------------------------------------------------------------------------
+    void RegionTreeForest::record_hashed_operation(unsigned kind,
+                               const std::vector<IndexSpaceExpression*> &exprs,
+                               IndexSpaceExpression *op)
+    //--------------------------------------------------------------------------
+    {
+      // The caller must be holding a live reference on the operation 
+      // so it cannot be removed from the table before we record it
+      const uint64_t hash = hash_operation(kind, exprs);
+      HashedOperationStripe &stripe = 
+        hashed_operations[hash % HASHED_OPERATION_STRIPES];
+      AutoLock s_lock(stripe.stripe_lock);
+      std::pair<std::unordered_multimap<uint64_t,HashedOperation>::iterator,
+        std::unordered_multimap<uint64_t,HashedOperation>::iterator> range =
+          stripe.operations.equal_range(hash);
+      for (std::unordered_multimap<uint64_t,HashedOperation>::iterator it =
+            range.first; it != range.second; it++)
+      {
+        HashedOperation &entry = it->second;
+        if ((entry.kind != kind) || (entry.operands.size() != exprs.size()))
+          continue;
+        bool match = true;
+        for (unsigned idx = 0; idx < exprs.size(); idx++)
+        {
+          if (entry.operands[idx] == exprs[idx]->expr_id)
+            continue;
+          match = false;
+          break;
+        }
+        if (!match)
+          continue;
+        // Either someone beat us to it or the entry is for an operation
+        // that is in the process of being deleted so replace it
+        entry.operation = op;
+        return;
+      }
+      HashedOperation &entry = stripe.operations.insert(
+          std::make_pair(hash, HashedOperation()))->second;
+      entry.kind = kind;
+      entry.operands.resize(exprs.size());
+      for (unsigned idx = 0; idx < exprs.size(); idx++)
+        entry.operands[idx] = exprs[idx]->expr_id;
+      entry.operation = op;
+    }
+
+    //--------------------------------------------------------------------------
+    void RegionTreeForest::remove_hashed_operation(unsigned kind,
+                               const std::vector<IndexSpaceExpression*> &exprs,
+                               IndexSpaceExpression *op)
+    //--------------------------------------------------------------------------
+    {
+      const uint64_t hash = hash_operation(kind, exprs);
+      HashedOperationStripe &stripe = 
+        hashed_operations[hash % HASHED_OPERATION_STRIPES];
+      AutoLock s_lock(stripe.stripe_lock);
+      std::pair<std::unordered_multimap<uint64_t,HashedOperation>::iterator,
+        std::unordered_multimap<uint64_t,HashedOperation>::iterator> range =
+          stripe.operations.equal_range(hash);
+      for (std::unordered_multimap<uint64_t,HashedOperation>::iterator it =
+            range.first; it != range.second; it++)
+      {
+        // Only remove the entry if it still names this operation, it
+        // might already have been replaced by a newer one for the same key
+        if (it->second.operation != op)
+          continue;
+        stripe.operations.erase(it);
+        return;
+      }
+    }
+
     //--------------------------------------------------------------------------
     void RegionTreeForest::remove_union_operation(IndexSpaceOperation *op,
                                 const std::vector<IndexSpaceExpression*> &exprs)
@@ -5997,6 +6164,7 @@ namespace Legion {
       assert(op->op_kind == IndexSpaceOperation::UNION_OP_KIND);
 #endif
       const IndexSpaceExprID key = exprs[0]->expr_id;
+      remove_hashed_operation(IndexSpaceOperation::UNION_OP_KIND, exprs, op);
       AutoLock l_lock(lookup_is_op_lock);
       std::map<IndexSpaceExprID,ExpressionTrieNode*>::iterator 
         finder = union_ops.find(key);
@@ -6019,6 +6187,8 @@ namespace Legion {
       assert(op->op_kind == IndexSpaceOperation::INTERSECT_OP_KIND);
 #endif
       const IndexSpaceExprID key(exprs[0]->expr_id);
+      remove_hashed_operation(IndexSpaceOperation::INTERSECT_OP_KIND, 
+                              exprs, op);
       AutoLock l_lock(lookup_is_op_lock);
       std::map<IndexSpaceExprID,ExpressionTrieNode*>::iterator 
         finder = intersection_ops.find(key);
@@ -6044,6 +6214,8 @@ namespace Legion {
       std::vector<IndexSpaceExpression*> exprs(2);
       exprs[0] = lhs;
       exprs[1] = rhs;
+      remove_hashed_operation(IndexSpaceOperation::DIFFERENCE_OP_KIND, 
+                              exprs, op);
       AutoLock l_lock(lookup_is_op_lock);
       std::map<IndexSpaceExprID,ExpressionTrieNode*>::iterator 
         finder = difference_ops.find(key);
@@ -9167,6 +9339,9 @@ namespace Legion {
     void IndexPartNode::notify_local(void)
     //--------------------------------------------------------------------------
     {
+      // Projection functors can name this partition by color so any
+      // results they have memoized for this tree may no longer be valid
+      context->runtime->invalidate_projection_caches(handle.get_tree_id());
       parent->remove_child(color);  
       for (std::map<LegionColor,IndexSpaceNode*>::const_iterator it =
             color_map.begin(); it != color_map.end(); it++)
@@ -894,6 +894,12 @@ namespace Legion {
     public:
       void remove_canonical_expression(IndexSpaceExpression *expr, size_t vol);
     private:
+      IndexSpaceExpression* find_or_create_union(
+                               const std::vector<IndexSpaceExpression*> &exprs,
+                               OperationCreator *creator);
+      IndexSpaceExpression* find_or_create_intersection(
+                               const std::vector<IndexSpaceExpression*> &exprs,
+                               OperationCreator *creator);
       static inline bool compare_expressions(IndexSpaceExpression *one,
                                              IndexSpaceExpression *two);
       struct CompareExpressions {
@@ -902,6 +908,18 @@ namespace Legion {
                                IndexSpaceExpression *two) const
         { return compare_expressions(one, two); }
       };
+    private:
+      // Hash-consing table that sits in front of the expression tries
+      static uint64_t hash_operation(unsigned kind,
+                            const std::vector<IndexSpaceExpression*> &exprs);
+      IndexSpaceExpression* find_hashed_operation(unsigned kind,
+                            const std::vector<IndexSpaceExpression*> &exprs);
+      void record_hashed_operation(unsigned kind,
+                            const std::vector<IndexSpaceExpression*> &exprs,
+                            IndexSpaceExpression *op);
+      void remove_hashed_operation(unsigned kind,
+                            const std::vector<IndexSpaceExpression*> &exprs,
+                            IndexSpaceExpression *op);
     public:
       // Methods for removing index space expression when they are done
       void remove_union_operation(IndexSpaceOperation *expr, 
@@ -956,6 +974,24 @@ namespace Legion {
       std::map<IndexSpaceExprID/*first*/,ExpressionTrieNode*> union_ops;
       std::map<IndexSpaceExprID/*first*/,ExpressionTrieNode*> intersection_ops;
       std::map<IndexSpaceExprID/*lhs*/,ExpressionTrieNode*> difference_ops;
+      // Hash-consed index space operations keyed by the kind of the 
+      // operation and the IDs of its operands. Lookups only take the
+      // lock for one stripe in read-only mode so they do not contend
+      // with each other on lookup_is_op_lock or the trie node locks.
+      // The tries above remain the authority for creating operations.
+      struct HashedOperation {
+      public:
+        unsigned kind;
+        std::vector<IndexSpaceExprID> operands;
+        IndexSpaceExpression *operation;
+      };
+      struct HashedOperationStripe {
+      public:
+        mutable LocalLock stripe_lock;
+        std::unordered_multimap<uint64_t,HashedOperation> operations;
+      };
+      static constexpr unsigned HASHED_OPERATION_STRIPES = 64;
+      HashedOperationStripe hashed_operations[HASHED_OPERATION_STRIPES];
       // Remote expressions
       std::map<IndexSpaceExprID,IndexSpaceExpression*> remote_expressions;
       std::map<IndexSpaceExprID,RtEvent> pending_remote_expressions;
@@ -3389,7 +3425,10 @@ namespace Legion {
      * \class EqKDSparse
      * In the case of index spaces with sparsity maps, this class helps
      * deal with the tracking of splitting planes for the rectangles until
-     * we get down to a single rectangle and can move to EqKDNodes
+     * we get down to a single rectangle and can move to EqKDNodes.
+     * The splitting planes for all the rectangles are computed in bulk
+     * when the tree is made and stored in a flat array with sibling 
+     * nodes next to each other so lookups walk contiguous memory.
      */
     template<int DIM, typename T>
     class EqKDSparse : public EqKDTreeT<DIM,T> {
@@ -3457,7 +3496,27 @@ namespace Legion {
           std::map<EquivalenceSet*,unsigned> &current_sets,
           LegionMap<ShardID,FieldMask> &remote_shards, ShardID local_shard);
     protected:
+      struct SparseNode {
+      public:
+        Rect<DIM,T> bounds;
+        // Index of the first child in either 'nodes' or 'children'
+        unsigned offset;
+        unsigned count;
+        bool leaves;
+      };
+      void build_node(unsigned index, const Rect<DIM,T> &bound,
+                      const std::vector<Rect<DIM,T> > &rects);
+      void add_leaves(unsigned index, const std::vector<Rect<DIM,T> > &rects);
+      void find_overlapping_children(const Rect<DIM,T> &rect,
+          std::vector<std::pair<EqKDTreeT<DIM,T>*,Rect<DIM,T> > > &overlaps)
+        const;
+    protected:
+      // Splitting planes for the tree with the root at index zero
+      std::vector<SparseNode> nodes;
+      // The leaves of the tree and a copy of their bounds so we don't
+      // need to dereference a leaf just to test it for overlap
       std::vector<EqKDTreeT<DIM,T>*> children;
+      std::vector<Rect<DIM,T> > child_bounds;
     };
 
     /**
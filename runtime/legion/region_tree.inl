@@ -8834,17 +8834,26 @@ namespace Legion {
       : EqKDTreeT<DIM,T>(bound)
     //--------------------------------------------------------------------------
     {
+      // Build the whole tree of splitting planes in one pass rather than
+      // making a separate heap object for each level of the tree
+      children.reserve(rects.size());
+      child_bounds.reserve(rects.size());
+      nodes.resize(1);
+      build_node(0/*root*/, bound, rects);
+    }
+
+    //--------------------------------------------------------------------------
+    template<int DIM, typename T>
+    void EqKDSparse<DIM,T>::build_node(unsigned index, 
+                                       const Rect<DIM,T> &bound,
+                                       const std::vector<Rect<DIM,T> > &rects)
+    //--------------------------------------------------------------------------
+    {
+      nodes[index].bounds = bound;
       if (rects.size() <= LEGION_MAX_BVH_FANOUT)
       {
         // Base case of a small enough number of children
-        children.reserve(rects.size());
-        for (typename std::vector<Rect<DIM,T> >::const_iterator it =
-              rects.begin(); it != rects.end(); it++)
-        {
-          EqKDNode<DIM,T> *child = new EqKDNode<DIM,T>(*it);
-          child->add_reference();
-          children.push_back(child);
-        }
+        add_leaves(index, rects);
         return;
       }
       // Unlike some of our other KDNode implementations, we know that all of
@@ -8857,14 +8866,16 @@ namespace Legion {
       // See if we had at least one good refinement
       if (success)
       {
-        EqKDSparse<DIM,T> *left = 
-          new EqKDSparse<DIM,T>(best_left_bounds, best_left_set); 
-        left->add_reference();
-        children.push_back(left);
-        EqKDSparse<DIM,T> *right =
-          new EqKDSparse<DIM,T>(best_right_bounds, best_right_set);
-        right->add_reference();
-        children.push_back(right);
+        // Allocate both children next to each other before recursing so
+        // that siblings are adjacent in memory (note this can resize the
+        // vector so don't hold any references into it across the calls)
+        const unsigned left = nodes.size();
+        nodes.resize(left + 2);
+        nodes[index].offset = left;
+        nodes[index].count = 2;
+        nodes[index].leaves = false;
+        build_node(left, best_left_bounds, best_left_set);
+        build_node(left + 1, best_right_bounds, best_right_set);
       }
       else
       {
@@ -8874,13 +8885,57 @@ namespace Legion {
             "the Legion developers' mailing list.", DIM, rects.size())
         // If we make it here then we couldn't find a splitting plane to refine
         // anymore so just record all the subrects as our rects
-        children.reserve(rects.size());
-        for (typename std::vector<Rect<DIM,T> >::const_iterator it =
-              rects.begin(); it != rects.end(); it++)
+        add_leaves(index, rects);
+      }
+    }
+
+    //--------------------------------------------------------------------------
+    template<int DIM, typename T>
+    void EqKDSparse<DIM,T>::add_leaves(unsigned index,
+                                       const std::vector<Rect<DIM,T> > &rects)
+    //--------------------------------------------------------------------------
+    {
+      nodes[index].offset = children.size();
+      nodes[index].count = rects.size();
+      nodes[index].leaves = true;
+      for (typename std::vector<Rect<DIM,T> >::const_iterator it =
+            rects.begin(); it != rects.end(); it++)
+      {
+        EqKDNode<DIM,T> *child = new EqKDNode<DIM,T>(*it);
+        child->add_reference();
+        children.push_back(child);
+        child_bounds.push_back(*it);
+      }
+    }
+
+    //--------------------------------------------------------------------------
+    template<int DIM, typename T>
+    void EqKDSparse<DIM,T>::find_overlapping_children(const Rect<DIM,T> &rect,
+        std::vector<std::pair<EqKDTreeT<DIM,T>*,Rect<DIM,T> > > &overlaps) const
+    //--------------------------------------------------------------------------
+    {
+      std::vector<unsigned> to_traverse(1, 0/*root*/);
+      while (!to_traverse.empty())
+      {
+        const SparseNode &node = nodes[to_traverse.back()];
+        to_traverse.pop_back();
+        if (node.leaves)
+        {
+          for (unsigned idx = node.offset; idx < (node.offset+node.count); idx++)
+          {
+            const Rect<DIM,T> overlap = rect.intersection(child_bounds[idx]);
+            if (!overlap.empty())
+              overlaps.push_back(std::make_pair(children[idx], overlap));
+          }
+        }
+        else
         {
-          EqKDNode<DIM,T> *child = new EqKDNode<DIM,T>(*it);
-          child->add_reference();
-          children.push_back(child);
+          // Push in reverse order so we still visit the left child first 
+          // which keeps the traversal order deterministic across shards
+          for (unsigned idx = node.offset + node.count; 
+                idx > node.offset; idx--)
+            if (rect.overlaps(nodes[idx-1].bounds))
+              to_traverse.push_back(idx-1);
         }
       }
     }
@@ -8903,13 +8958,11 @@ namespace Legion {
                    ShardID local_shard, bool current)
     //--------------------------------------------------------------------------
     {
-      for (typename std::vector<EqKDTreeT<DIM,T>*>::const_iterator it =
-            children.begin(); it != children.end(); it++)
-      {
-        const Rect<DIM,T> overlap = rect.intersection((*it)->bounds);
-        if (!overlap.empty())
-          (*it)->initialize_set(set, overlap, mask, local_shard, current);
-      }
+      std::vector<std::pair<EqKDTreeT<DIM,T>*,Rect<DIM,T> > > overlaps;
+      find_overlapping_children(rect, overlaps);
+      for (typename std::vector<std::pair<EqKDTreeT<DIM,T>*,Rect<DIM,T> > >::
+            const_iterator it = overlaps.begin(); it != overlaps.end(); it++)
+        it->first->initialize_set(set, it->second, mask, local_shard, current);
     }
 
     //--------------------------------------------------------------------------
@@ -8929,16 +8982,14 @@ namespace Legion {
         ShardID local_shard)
     //--------------------------------------------------------------------------
     {
-      for (typename std::vector<EqKDTreeT<DIM,T>*>::const_iterator it =
-            children.begin(); it != children.end(); it++)
-      {
-        const Rect<DIM,T> overlap = rect.intersection((*it)->bounds);
-        if (!overlap.empty())
-          (*it)->compute_equivalence_sets(overlap, mask, trackers,
-              tracker_spaces, new_tracker_references, eq_sets, pending_sets,
-              subscriptions, to_create, creation_rects, creation_srcs,
-              remote_shard_rects, local_shard);
-      }
+      std::vector<std::pair<EqKDTreeT<DIM,T>*,Rect<DIM,T> > > overlaps;
+      find_overlapping_children(rect, overlaps);
+      for (typename std::vector<std::pair<EqKDTreeT<DIM,T>*,Rect<DIM,T> > >::
+            const_iterator it = overlaps.begin(); it != overlaps.end(); it++)
+        it->first->compute_equivalence_sets(it->second, mask, trackers,
+            tracker_spaces, new_tracker_references, eq_sets, pending_sets,
+            subscriptions, to_create, creation_rects, creation_srcs,
+            remote_shard_rects, local_shard);
     }
 
     //--------------------------------------------------------------------------
@@ -8964,15 +9015,13 @@ namespace Legion {
     //--------------------------------------------------------------------------
     {
       unsigned new_subs = 0;
-      for (typename std::vector<EqKDTreeT<DIM,T>*>::const_iterator it =
-            children.begin(); it != children.end(); it++)
-      {
-        const Rect<DIM,T> overlap = rect.intersection((*it)->bounds);
-        if (!overlap.empty())
-          new_subs += (*it)->record_output_equivalence_set(set, overlap, mask,
-              tracker, tracker_space, subscriptions, remote_shard_rects, 
-              local_shard);
-      }
+      std::vector<std::pair<EqKDTreeT<DIM,T>*,Rect<DIM,T> > > overlaps;
+      find_overlapping_children(rect, overlaps);
+      for (typename std::vector<std::pair<EqKDTreeT<DIM,T>*,Rect<DIM,T> > >::
+            const_iterator it = overlaps.begin(); it != overlaps.end(); it++)
+        new_subs += it->first->record_output_equivalence_set(set, it->second,
+            mask, tracker, tracker_space, subscriptions, remote_shard_rects,
+            local_shard);
       return new_subs;
     }
 
@@ -9010,14 +9059,12 @@ namespace Legion {
                                             FieldMask *parent_all_previous)
     //--------------------------------------------------------------------------
     {
-      for (typename std::vector<EqKDTreeT<DIM,T>*>::const_iterator it =
-            children.begin(); it != children.end(); it++)
-      {
-        const Rect<DIM,T> overlap = rect.intersection((*it)->bounds);
-        if (!overlap.empty())
-          (*it)->invalidate_tree(overlap, mask, runtime, invalidated,
-              move_to_previous, parent_all_previous);
-      }
+      std::vector<std::pair<EqKDTreeT<DIM,T>*,Rect<DIM,T> > > overlaps;
+      find_overlapping_children(rect, overlaps);
+      for (typename std::vector<std::pair<EqKDTreeT<DIM,T>*,Rect<DIM,T> > >::
+            const_iterator it = overlaps.begin(); it != overlaps.end(); it++)
+        it->first->invalidate_tree(it->second, mask, runtime, invalidated,
+            move_to_previous, parent_all_previous);
     }
 
     //--------------------------------------------------------------------------
@@ -9053,15 +9100,12 @@ namespace Legion {
 #ifdef DEBUG_LEGION
       assert(this->bounds.contains(rect));
 #endif
-      for (typename std::vector<EqKDTreeT<DIM,T>*>::const_iterator it =
-            children.begin(); it != children.end(); it++)
-      {
-        const Rect<DIM,T> overlap = (*it)->bounds.intersection(rect);
-        if (overlap.empty())
-          continue;
-        (*it)->find_trace_local_sets(overlap, mask, req_index, local_shard,
-                                     current_sets);
-      }
+      std::vector<std::pair<EqKDTreeT<DIM,T>*,Rect<DIM,T> > > overlaps;
+      find_overlapping_children(rect, overlaps);
+      for (typename std::vector<std::pair<EqKDTreeT<DIM,T>*,Rect<DIM,T> > >::
+            const_iterator it = overlaps.begin(); it != overlaps.end(); it++)
+        it->first->find_trace_local_sets(it->second, mask, req_index, 
+                                         local_shard, current_sets);
     }
 
     //--------------------------------------------------------------------------
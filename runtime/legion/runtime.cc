@@ -42,6 +42,9 @@
 #include <sys/resource.h>
 #endif
 #include <sys/mman.h> // needed for munlock but should be removed
+#ifdef LEGION_USE_LZ4
+#include <lz4.h>
+#endif
 #ifdef LEGION_USE_CUDA
 #include <cuda.h>
 #ifdef LEGION_MALLOC_INSTANCES
@@ -1007,7 +1010,13 @@ namespace Legion {
         return true;
       // This is not fully accurate since we might still need to wait across
       // the shards for control replication but it is close enough
-      return producer_op->get_commit_event(op_gen).has_triggered();
+      if (producer_op->get_commit_event(op_gen).has_triggered())
+        return true;
+      // Make sure the producer is not being held back by automatic tracing
+      // since the application could be polling for it without blocking
+      if ((context != NULL) && (implicit_context == context))
+        context->progress_automatic_trace();
+      return false;
     }
 
     //--------------------------------------------------------------------------
@@ -1854,8 +1863,15 @@ namespace Legion {
     void FutureImpl::set_local(const void *value, size_t size, bool own)
     //--------------------------------------------------------------------------
     {
-      FutureInstance *instance = (size == 0) ? NULL :
-        FutureInstance::create_local(value, size, own);
+      FutureInstance *instance = NULL;
+      if (size > LEGION_MAX_INLINE_FUTURE_SIZE)
+        instance = FutureInstance::create_local(value, size, own);
+      else if (size > 0)
+      {
+        instance = new FutureInstance(value, size);
+        if (own)
+          free(const_cast<void*>(value));
+      }
       set_result(ApEvent::NO_AP_EVENT, instance);
     }
 
@@ -2600,6 +2616,88 @@ namespace Legion {
         provenance->serialize(rez);
       else
         Provenance::serialize_null(rez);
+      // Small values that are already known here travel along with the
+      // future so that the target node does not need to subscribe for them.
+      // We never do this for the owner since it must always be told of the
+      // result by the node that set it.
+      if ((target != owner_space) && (target != local_space) &&
+          !empty.load() && (callback_functor == NULL))
+      {
+        AutoLock f_lock(future_lock,1,false/*exclusive*/);
+        if (pack_inline_result(rez))
+          return;
+      }
+      rez.serialize<bool>(false); // inline result
+    }
+
+    //--------------------------------------------------------------------------
+    bool FutureImpl::pack_inline_result(Serializer &rez)
+    //--------------------------------------------------------------------------
+    {
+      if (empty.load() || (metasize > 0) ||
+          (future_size > LEGION_MAX_INLINE_FUTURE_SIZE))
+        return false;
+      const void *value = NULL;
+      if (future_size > 0)
+      {
+        if (!local_visible_memory.exists())
+          return false;
+        std::map<Memory,FutureInstanceTracker>::const_iterator finder =
+          instances.find(local_visible_memory);
+        if (finder == instances.end())
+          return false;
+        // Only send the value if it is safe to read it right now
+        bool poisoned = false;
+        if (finder->second.ready_event.exists() &&
+            (!finder->second.ready_event.has_triggered_faultaware(poisoned) ||
+             poisoned))
+          return false;
+        value = finder->second.instance->get_data();
+      }
+      rez.serialize<bool>(true); // inline result
+      rez.serialize(future_size);
+      rez.serialize(result_set_space);
+      rez.serialize(future_complete);
+      if (future_size > 0)
+        rez.serialize(value, future_size);
+      return true;
+    }
+
+    //--------------------------------------------------------------------------
+    void FutureImpl::unpack_inline_result(Deserializer &derez)
+    //--------------------------------------------------------------------------
+    {
+      size_t size;
+      derez.deserialize(size);
+      AddressSpaceID set_space;
+      derez.deserialize(set_space);
+      ApEvent complete;
+      derez.deserialize(complete);
+      const void *value = derez.get_current_pointer();
+      derez.advance_pointer(size);
+      AutoLock f_lock(future_lock);
+      // If we already have the result or have already asked for it then
+      // the normal subscription path is responsible for setting it
+      if (!empty.load() || future_size_set || subscription_event.exists() ||
+          future_complete.exists() || !pending_instances.empty() ||
+          !remote_instance_allocations.empty() || (callback_functor != NULL))
+        return;
+#ifdef DEBUG_LEGION
+      assert(instances.empty());
+      assert(metadata == NULL);
+#endif
+      if (size > 0)
+      {
+        FutureInstance *instance = new FutureInstance(value, size);
+        instances.emplace(std::make_pair(instance->memory,
+              FutureInstanceTracker(instance, ApEvent::NO_AP_EVENT)));
+        local_visible_memory = instance->memory;
+      }
+      future_size = size;
+      future_size_set = true;
+      result_set_space = set_space;
+      future_complete = complete;
+      empty.store(false);
     }
 
     //--------------------------------------------------------------------------
@@ -2638,6 +2736,10 @@ namespace Legion {
                                             op, op_gen, op_uid, op_depth,
                                             collective_mapping));
       result.impl->unpack_global_ref();
+      bool inline_result;
+      derez.deserialize<bool>(inline_result);
+      if (inline_result)
+        result.impl->unpack_inline_result(derez);
       if ((collective_mapping != NULL) && 
           collective_mapping->remove_reference())
         delete collective_mapping;
@@ -3204,7 +3306,7 @@ namespace Legion {
               s, false/*read only*/)), freefunc(inst.exists() || !p.exists() ? 
               NULL : free_host_memory), freeproc(p),
         eager_allocation(eager), external_allocation(external),
-        is_meta_visible(check_meta_visible(memory)),
+        is_meta_visible(check_meta_visible(memory)), inline_allocation(false),
         own_allocation(own), data(d), instance(inst), use_event(use),
         unique_event(unique), own_instance(own && inst.exists())
     //--------------------------------------------------------------------------
@@ -3222,6 +3324,25 @@ namespace Legion {
 #endif
     }
 
+    //--------------------------------------------------------------------------
+    FutureInstance::FutureInstance(const void *value, size_t s)
+      : size(s), memory(implicit_runtime->runtime_system_memory),
+        resource(new Realm::ExternalMemoryResource(
+              reinterpret_cast<uintptr_t>(inline_buffer), s, false/*read only*/)),
+        freefunc(NULL), freeproc(Processor::NO_PROC), eager_allocation(false),
+        external_allocation(true), is_meta_visible(true),
+        inline_allocation(true), own_allocation(false), data(inline_buffer),
+        instance(PhysicalInstance::NO_INST), own_instance(false)
+    //--------------------------------------------------------------------------
+    {
+#ifdef DEBUG_LEGION
+      assert(size > 0);
+      assert(size <= LEGION_MAX_INLINE_FUTURE_SIZE);
+#endif
+      if (value != NULL)
+        memcpy(inline_buffer, value, size);
+    }
+
     //--------------------------------------------------------------------------
     FutureInstance::FutureInstance(const void *d, size_t s, bool own,
                           const Realm::ExternalInstanceResource *allocation,
@@ -3232,7 +3353,7 @@ namespace Legion {
           inst.get_location() : allocation->suggested_memory()),
         resource(allocation), freefunc(func), freeproc(proc),
         eager_allocation(false), external_allocation(true),
-        is_meta_visible(check_meta_visible(memory)), 
+        is_meta_visible(check_meta_visible(memory)), inline_allocation(false),
         own_allocation(own), data(d), instance(inst), use_event(use),
         unique_event(unique), own_instance(own && inst.exists())
     //--------------------------------------------------------------------------
@@ -3724,7 +3845,8 @@ namespace Legion {
     bool FutureInstance::defer_deletion(ApEvent precondition)
     //--------------------------------------------------------------------------
     {
-      if (own_allocation)
+      // Inline data goes away with this object so defer the whole deletion
+      if (own_allocation || inline_allocation)
       {
         if (precondition.exists() && 
             !precondition.has_triggered_faultignorant())
@@ -3762,6 +3884,25 @@ namespace Legion {
         bool pack_ownership, bool allow_value)
     //--------------------------------------------------------------------------
     {
+      if (inline_allocation && pack_ownership)
+      {
+        // Inline data lives inside this object so its allocation can never
+        // be handed off. Wait for the bytes to be ready and then either
+        // pass them by value or move them into a heap allocation that the
+        // destination can take ownership of instead.
+        if (ready_event.exists() && !ready_event.has_triggered_faultignorant())
+          ready_event.wait_faultignorant();
+        if (!allow_value || (size > LEGION_MAX_RETURN_SIZE))
+        {
+          FutureInstance *copy = 
+            create_local(inline_buffer, size, false/*own*/);
+          copy->pack_instance(rez, ApEvent::NO_AP_EVENT,
+              true/*pack ownership*/, false/*allow by value*/);
+          delete copy;
+          return false;
+        }
+        ready_event = ApEvent::NO_AP_EVENT;
+      }
       rez.serialize(size);
       // Check to see if we can just pass this future instance by value
       if (allow_value && is_meta_visible && (size <= LEGION_MAX_RETURN_SIZE) &&
@@ -3795,6 +3936,7 @@ namespace Legion {
 #ifdef DEBUG_LEGION
           assert(own_instance);
           assert(own_allocation);
+          assert(!inline_allocation);
 #endif
           rez.serialize<bool>(true); // own the allocation on the destination
           own_allocation = false;
@@ -3832,6 +3974,13 @@ namespace Legion {
       derez.deserialize<bool>(pass_by_value);
       if (pass_by_value)
       {
+        if (size <= LEGION_MAX_INLINE_FUTURE_SIZE)
+        {
+          FutureInstance *result =
+            new FutureInstance(derez.get_current_pointer(), size);
+          derez.advance_pointer(size);
+          return result;
+        }
         void *data = malloc(size);
         derez.deserialize(data, size);
         return new FutureInstance(data, size, false/*eager*/, true/*external*/);
@@ -11672,6 +11821,66 @@ namespace Legion {
     }
 #endif
 
+    /////////////////////////////////////////////////////////////
+    // Message Statistics 
+    /////////////////////////////////////////////////////////////
+
+    //--------------------------------------------------------------------------
+    MessageStatistics::MessageStatistics(void)
+    //--------------------------------------------------------------------------
+    {
+      for (unsigned idx = 0; idx < LAST_SEND_KIND; idx++)
+      {
+        message_counts[idx].store(0);
+        message_bytes[idx].store(0);
+      }
+      for (unsigned idx = 0; idx < MAX_NUM_VIRTUAL_CHANNELS; idx++)
+      {
+        channel_packaged_bytes[idx].store(0);
+        channel_sent_bytes[idx].store(0);
+      }
+    }
+
+    //--------------------------------------------------------------------------
+    void MessageStatistics::report(AddressSpaceID local_space) const
+    //--------------------------------------------------------------------------
+    {
+      LG_MESSAGE_DESCRIPTIONS(message_names);
+      // Sort the message kinds so the ones with the most bytes come first
+      std::vector<std::pair<uint64_t,unsigned> > kinds;
+      uint64_t total_bytes = 0;
+      for (unsigned idx = 0; idx < LAST_SEND_KIND; idx++)
+      {
+        const uint64_t bytes = message_bytes[idx].load();
+        if (bytes == 0)
+          continue;
+        kinds.emplace_back(std::make_pair(bytes, idx));
+        total_bytes += bytes;
+      }
+      if (kinds.empty())
+        return;
+      std::sort(kinds.begin(), kinds.end(), 
+                std::greater<std::pair<uint64_t,unsigned> >());
+      log_run.print("Message statistics for node %d: %lld bytes in total",
+                    local_space, (long long)total_bytes);
+      for (std::vector<std::pair<uint64_t,unsigned> >::const_iterator it =
+            kinds.begin(); it != kinds.end(); it++)
+        log_run.print("  %-48s %12lld messages %14lld bytes (%5.1f%%)",
+            message_names[it->second],
+            (long long)message_counts[it->second].load(),
+            (long long)it->first, 100.0 * it->first / total_bytes);
+      for (unsigned idx = 0; idx < MAX_NUM_VIRTUAL_CHANNELS; idx++)
+      {
+        const uint64_t packaged = channel_packaged_bytes[idx].load();
+        if (packaged == 0)
+          continue;
+        const uint64_t sent = channel_sent_bytes[idx].load();
+        log_run.print("  virtual channel %2d: %14lld bytes packaged "
+            "%14lld bytes sent (ratio %.2f)", idx, (long long)packaged,
+            (long long)sent, double(packaged) / double(sent));
+      }
+    }
+
     /////////////////////////////////////////////////////////////
     // Virtual Channel 
     /////////////////////////////////////////////////////////////
@@ -11679,28 +11888,25 @@ namespace Legion {
     //--------------------------------------------------------------------------
     VirtualChannel::VirtualChannel(VirtualChannelKind kind, 
         AddressSpaceID local_address_space, size_t max_message_size, 
-        bool profile_outgoing)
+        bool profile_outgoing, size_t compression, MessageStatistics *stats)
       : sending_buffer((uint8_t*)malloc(max_message_size)), 
-        sending_buffer_size(max_message_size), 
+        sending_buffer_size(max_message_size), channel_kind(kind),
         ordered_channel((kind != DEFAULT_VIRTUAL_CHANNEL) &&
                         (kind != THROUGHPUT_VIRTUAL_CHANNEL)), 
         profile_outgoing_messages(profile_outgoing),
+        compression_threshold(compression), statistics(stats),
         request_priority((kind == THROUGHPUT_VIRTUAL_CHANNEL) ?
             LG_THROUGHPUT_MESSAGE_PRIORITY : (kind == UPDATE_VIRTUAL_CHANNEL) ?
             LG_LATENCY_DEFERRED_PRIORITY : LG_LATENCY_MESSAGE_PRIORITY),
         response_priority((kind == THROUGHPUT_VIRTUAL_CHANNEL) ?
             LG_THROUGHPUT_RESPONSE_PRIORITY : (kind == UPDATE_VIRTUAL_CHANNEL) ?
             LG_LATENCY_MESSAGE_PRIORITY : LG_LATENCY_RESPONSE_PRIORITY),
-        partial_messages(0), observed_recent(true)
+        observed_recent(true)
     //--------------------------------------------------------------------------
     //
     {
-      receiving_buffer_size = max_message_size;
-      receiving_buffer = (uint8_t*)legion_malloc(MESSAGE_BUFFER_ALLOC,
-                                              receiving_buffer_size);
 #ifdef DEBUG_LEGION
       assert(sending_buffer != NULL);
-      assert(receiving_buffer != NULL);
 #endif
       // Use a dummy implicit provenance at the front for the message
       // to comply with the requirements of the meta-task handler which
@@ -11724,24 +11930,17 @@ namespace Legion {
       sending_index += sizeof(local_address_space);
       memcpy(sending_buffer+sending_index, &kind, sizeof(kind));
       sending_index += sizeof(kind);
-      header = FULL_MESSAGE;
-      sending_index += sizeof(header);
       packaged_messages = 0;
       sending_index += sizeof(packaged_messages);
       last_message_event = RtEvent::NO_RT_EVENT;
-      partial_message_id = 0;
-      partial_assembly = NULL;
-      partial = false;
-      // Set up the receiving buffer
-      received_messages = 0;
-      receiving_index = 0;
     }
 
     //--------------------------------------------------------------------------
     VirtualChannel::VirtualChannel(const VirtualChannel &rhs)
       : sending_buffer(NULL), sending_buffer_size(0), 
-        ordered_channel(false), profile_outgoing_messages(false),
-        request_priority(rhs.request_priority),
+        channel_kind(rhs.channel_kind), ordered_channel(false),
+        profile_outgoing_messages(false), compression_threshold(0),
+        statistics(NULL), request_priority(rhs.request_priority),
         response_priority(rhs.response_priority)
     //--------------------------------------------------------------------------
     {
@@ -11754,11 +11953,19 @@ namespace Legion {
     //--------------------------------------------------------------------------
     {
       free(sending_buffer);
-      free(receiving_buffer);
-      receiving_buffer = NULL;
-      receiving_buffer_size = 0;
-      if (partial_assembly != NULL)
-        delete partial_assembly;
+    }
+
+    //--------------------------------------------------------------------------
+    static inline size_t virtual_channel_prefix_size(void)
+    //--------------------------------------------------------------------------
+    {
+      // The bytes at the front of every message that identify it as a
+      // message meta-task from this node on this virtual channel
+      return sizeof(UniqueID) + sizeof(LgTaskID) +
+#ifdef DEBUG_LEGION_CALLERS
+        sizeof(LgTaskID) +
+#endif
+        sizeof(AddressSpaceID) + sizeof(VirtualChannelKind);
     }
 
     //--------------------------------------------------------------------------
@@ -11773,124 +11980,317 @@ namespace Legion {
 #endif
       // First check to see if the message fits in the current buffer    
       // including the overhead for the message: kind and size
-      size_t buffer_size = rez.get_used_bytes();
-      const uint8_t *buffer = (const uint8_t*)rez.get_buffer();
+      const size_t buffer_size = rez.get_used_bytes();
       const size_t header_size = 
 #ifdef DEBUG_LEGION_CALLERS
         sizeof(LgTaskID) +
 #endif
         sizeof(k) + sizeof(implicit_provenance) + sizeof(buffer_size);
-      // Need to hold the lock when manipulating the buffer
-      AutoLock c_lock(channel_lock);
-      if ((sending_index+header_size+buffer_size) > sending_buffer_size)
-      {
-        // Make sure we can at least get the meta-data into the buffer
-        // Since there is no partial data we can fake the flush
-        if ((sending_buffer_size - sending_index) <= header_size)
-          send_message(true/*complete*/, runtime, target, k,
-                       response, flush_precondition);
-        // Now can package up the meta data
-        packaged_messages++;
-        memcpy(sending_buffer+sending_index, &k, sizeof(k));
-        sending_index += sizeof(k);
-        memcpy(sending_buffer+sending_index, &implicit_provenance,
-            sizeof(implicit_provenance));
-        sending_index += sizeof(implicit_provenance);
-#ifdef DEBUG_LEGION_CALLERS
-        memcpy(sending_buffer+sending_index, &implicit_task_kind,
-            sizeof(implicit_task_kind));
-        sending_index += sizeof(implicit_task_kind);
-#endif
-        memcpy(sending_buffer+sending_index, &buffer_size, sizeof(buffer_size));
-        sending_index += sizeof(buffer_size);
-        while (buffer_size > 0)
-        {
-          unsigned remaining = sending_buffer_size - sending_index;
-          if (remaining == 0)
-            send_message(false/*complete*/, runtime, target, k,
-                         response, flush_precondition);
-          remaining = sending_buffer_size - sending_index;
-#ifdef DEBUG_LEGION
-          assert(remaining > 0); // should be space after the send
-#endif
-          // Figure out how much to copy into the buffer
-          unsigned to_copy = (remaining < buffer_size) ? 
-                                            remaining : buffer_size;
-          memcpy(sending_buffer+sending_index,buffer,to_copy);
-          buffer_size -= to_copy;
-          buffer += to_copy;
-          sending_index += to_copy;
-        } 
+      const size_t empty_index = 
+        virtual_channel_prefix_size() + sizeof(packaged_messages);
+      if (statistics != NULL)
+        statistics->record_message(k, buffer_size);
+      // Batches that need compressing are handed out of the lock so that
+      // other senders on this channel do not have to wait behind LZ4
+      std::vector<PendingCompression> pending;
+      {
+        // Need to hold the lock when manipulating the buffer
+        AutoLock c_lock(channel_lock);
+        if ((empty_index+header_size+buffer_size) > sending_buffer_size)
+        {
+          // This message would not fit even in an empty buffer so rather
+          // than copying it into the buffer in pieces and having the other
+          // side reassemble it, copy it once into a staging buffer of its
+          // own and send it by itself. Flush anything already packaged
+          // first so that we maintain the ordering of messages on this
+          // channel.
+          if (packaged_messages > 0)
+            send_message(runtime, target, k, response,
+                         flush_precondition, &pending);
+          send_direct_message(rez, k, target, response,
+                              flush_precondition, pending);
+        }
+        else
+        {
+          if ((sending_index+header_size+buffer_size) > sending_buffer_size)
+            send_message(runtime, target, k, response,
+                         flush_precondition, &pending);
+          packaged_messages++;
+          // Package up the kind and the size first
+          sending_index += pack_message_header(sending_buffer+sending_index,
+                                               k, buffer_size);
+          // Then copy over the buffer
+          memcpy(sending_buffer+sending_index, rez.get_buffer(), buffer_size);
+          sending_index += buffer_size;
+          if (flush)
+            send_message(runtime, target, k, response,
+                         flush_precondition, &pending);
+        }
       }
-      else
-      {
-        packaged_messages++;
-        // Package up the kind and the size first
-        memcpy(sending_buffer+sending_index, &k, sizeof(k));
-        sending_index += sizeof(k);
-        memcpy(sending_buffer+sending_index, &implicit_provenance, 
-            sizeof(implicit_provenance));
-        sending_index += sizeof(implicit_provenance);
+      for (std::vector<PendingCompression>::iterator it =
+            pending.begin(); it != pending.end(); it++)
+        compress_and_spawn(*it);
+    }
+
+    //--------------------------------------------------------------------------
+    /*static*/ size_t VirtualChannel::pack_message_header(uint8_t *buffer,
+                                      MessageKind kind, size_t message_size)
+    //--------------------------------------------------------------------------
+    {
+      size_t index = 0;
+      memcpy(buffer+index, &kind, sizeof(kind));
+      index += sizeof(kind);
+      memcpy(buffer+index, &implicit_provenance, sizeof(implicit_provenance));
+      index += sizeof(implicit_provenance);
 #ifdef DEBUG_LEGION_CALLERS
-        memcpy(sending_buffer+sending_index, &implicit_task_kind,
-            sizeof(implicit_task_kind));
-        sending_index += sizeof(implicit_task_kind);
+      memcpy(buffer+index, &implicit_task_kind, sizeof(implicit_task_kind));
+      index += sizeof(implicit_task_kind);
 #endif
-        memcpy(sending_buffer+sending_index, &buffer_size, sizeof(buffer_size));
-        sending_index += sizeof(buffer_size);
-        // Then copy over the buffer
-        memcpy(sending_buffer+sending_index,buffer,buffer_size); 
-        sending_index += buffer_size;
+      memcpy(buffer+index, &message_size, sizeof(message_size));
+      index += sizeof(message_size);
+      return index;
+    }
+
+    //--------------------------------------------------------------------------
+    void VirtualChannel::send_message(Runtime *runtime, Processor target,
+                                      MessageKind kind, bool response,
+                                      RtEvent send_precondition,
+                                      std::vector<PendingCompression> *pending)
+    //--------------------------------------------------------------------------
+    {
+      // Lock held from caller
+      // Save the number of messages into the buffer
+      const size_t base_size = virtual_channel_prefix_size();
+      memcpy(sending_buffer + base_size, &packaged_messages,
+            sizeof(packaged_messages));
+      if ((pending != NULL) && should_compress(sending_index))
+      {
+        // Hand the packed buffer off to be compressed once the caller
+        // releases the lock and start a fresh one with the same prefix
+        uint8_t *packed = sending_buffer;
+        sending_buffer = (uint8_t*)malloc(sending_buffer_size);
+#ifdef DEBUG_LEGION
+        assert(sending_buffer != NULL);
+#endif
+        memcpy(sending_buffer, packed, base_size);
+        defer_compression(packed, sending_index, kind, target, response,
+                          send_precondition, *pending);
       }
-      if (flush)
-        send_message(true/*complete*/, runtime, target, k, 
-                     response, flush_precondition);
+      else
+        spawn_message(sending_buffer, sending_index, kind, target,
+                      response, send_precondition);
+      // Reset the state of the buffer
+      sending_index = base_size + sizeof(packaged_messages);
+      packaged_messages = 0;
     }
 
     //--------------------------------------------------------------------------
-    void VirtualChannel::send_message(bool complete, Runtime *runtime,
-                                      Processor target, MessageKind kind,
-                                      bool response, RtEvent send_precondition)
+    void VirtualChannel::send_direct_message(Serializer &rez, MessageKind kind,
+                                             Processor target, bool response,
+                                             RtEvent send_precondition,
+                                    std::vector<PendingCompression> &pending)
     //--------------------------------------------------------------------------
     {
-      // See if we need to switch the header file
-      // and update the state of partial
-      bool first_partial = false;
-      if (!complete)
+      // Lock held from caller
+      // The message goes out as a batch of one message so the receiver
+      // can deserialize it in place just like any other batch. Realm
+      // copies the task arguments before spawn returns so the serializer
+      // keeps ownership of its buffer and this staging buffer only has
+      // to live until then.
+      const size_t base_size = virtual_channel_prefix_size();
+      const size_t message_size = rez.get_used_bytes();
+      const size_t total_size = base_size + sizeof(unsigned) +
+        sizeof(kind) + sizeof(implicit_provenance) +
+#ifdef DEBUG_LEGION_CALLERS
+        sizeof(LgTaskID) +
+#endif
+        sizeof(message_size) + message_size;
+      uint8_t *buffer = (uint8_t*)malloc(total_size);
+#ifdef DEBUG_LEGION
+      assert(buffer != NULL);
+#endif
+      // The prefix is the same for every message on this channel
+      memcpy(buffer, sending_buffer, base_size);
+      size_t index = base_size;
+      const unsigned num_messages = 1;
+      memcpy(buffer+index, &num_messages, sizeof(num_messages));
+      index += sizeof(num_messages);
+      index += pack_message_header(buffer+index, kind, message_size);
+      memcpy(buffer+index, rez.get_buffer(), message_size);
+      index += message_size;
+#ifdef DEBUG_LEGION
+      assert(index == total_size);
+#endif
+      if (should_compress(total_size))
+        // The staging buffer is handed off with the pending compression
+        defer_compression(buffer, total_size, kind, target, response,
+                          send_precondition, pending);
+      else
       {
-        header = PARTIAL_MESSAGE;
-        // If this is an unordered virtual channel, then embed our partial
-        // message id in the high-order bits
-        if (!ordered_channel)
-          header = (MessageHeader)
-            (((unsigned)header) | (partial_message_id << 2));
-        if (!partial)
-        {
-          partial = true;
-          first_partial = true;
-        }
+        spawn_message(buffer, total_size, kind, target,
+                      response, send_precondition);
+        free(buffer);
       }
-      else if (partial)
+    }
+
+    //--------------------------------------------------------------------------
+    RtEvent VirtualChannel::order_message(RtEvent send_precondition) const
+    //--------------------------------------------------------------------------
+    {
+      // Lock held from caller
+      return ordered_channel ?
+        (send_precondition.exists() ? 
+          Runtime::merge_events(send_precondition, last_message_event) :
+          last_message_event) : send_precondition;
+    }
+
+    //--------------------------------------------------------------------------
+    void VirtualChannel::record_message(RtEvent sent)
+    //--------------------------------------------------------------------------
+    {
+      // Lock held from caller
+      last_message_event = sent;
+      if (!ordered_channel)
       {
-        header = FINAL_MESSAGE;
-        // If this is an unordered virtual channel, then embed our partial
-        // message id in the high-order bits
-        if (!ordered_channel)
-          // Also increment the partial message id for the next message
-          // This can overflow safely since it's an unsigned integer
-          header = (MessageHeader)
-            (((unsigned)header) | (partial_message_id++ << 2));
-        partial = false;
+        unordered_events.insert(last_message_event);
+        if (unordered_events.size() >= MAX_UNORDERED_EVENTS)
+          filter_unordered_events();
       }
-      // Save the header and the number of messages into the buffer
-      const size_t base_size = sizeof(UniqueID) + sizeof(LgTaskID) +
-#ifdef DEBUG_LEGION_CALLERS
-        sizeof(LgTaskID) +
+    }
+
+    //--------------------------------------------------------------------------
+    void VirtualChannel::spawn_message(const void *args, size_t arglen,
+                                       MessageKind kind, Processor target,
+                                       bool response, RtEvent send_precondition)
+    //--------------------------------------------------------------------------
+    {
+      // Lock held from caller
+#ifdef LEGION_USE_LZ4
+      // Only shutdown flushes get here with a batch that wants compressing
+      uint8_t *compressed = NULL;
+      if (should_compress(arglen))
+        compressed = compress_message(args, arglen);
+      else if (statistics != NULL)
+        statistics->record_send(channel_kind, arglen, arglen);
+#else
+      if (statistics != NULL)
+        statistics->record_send(channel_kind, arglen, arglen);
 #endif
-        sizeof(AddressSpaceID) + sizeof(VirtualChannelKind);
-      memcpy(sending_buffer + base_size, &header, sizeof(header));
-      memcpy(sending_buffer + base_size + sizeof(header), &packaged_messages,
-            sizeof(packaged_messages));
+      const RtEvent precondition = order_message(send_precondition);
+      record_message(issue_message(args, arglen, kind, target,
+                                   response, precondition));
+#ifdef LEGION_USE_LZ4
+      // Realm has copied the arguments so we can free this now
+      if (compressed != NULL)
+        free(compressed);
+#endif
+    }
+
+    //--------------------------------------------------------------------------
+    void VirtualChannel::defer_compression(uint8_t *buffer, size_t size,
+                                    MessageKind kind, Processor target,
+                                    bool response, RtEvent send_precondition,
+                                    std::vector<PendingCompression> &pending)
+    //--------------------------------------------------------------------------
+    {
+      // Lock held from caller
+      // Reserve this message's place in the channel order now with an
+      // event that will trigger once it has actually been spawned
+      PendingCompression next;
+      next.buffer = buffer;
+      next.size = size;
+      next.kind = kind;
+      next.target = target;
+      next.response = response;
+      next.precondition = order_message(send_precondition);
+      next.spawned = Runtime::create_rt_user_event();
+      record_message(next.spawned);
+      pending.push_back(next);
+    }
+
+    //--------------------------------------------------------------------------
+    void VirtualChannel::compress_and_spawn(PendingCompression &pending)
+    //--------------------------------------------------------------------------
+    {
+      // No lock needed, the buffer belongs to us and the order on the
+      // channel was already decided when the compression was deferred
+      const void *args = pending.buffer;
+      size_t arglen = pending.size;
+#ifdef LEGION_USE_LZ4
+      uint8_t *compressed = compress_message(args, arglen);
+#endif
+      Runtime::trigger_event(pending.spawned, issue_message(args, arglen,
+            pending.kind, pending.target, pending.response,
+            pending.precondition));
+#ifdef LEGION_USE_LZ4
+      if (compressed != NULL)
+        free(compressed);
+#endif
+      free(pending.buffer);
+    }
+
+    //--------------------------------------------------------------------------
+    uint8_t* VirtualChannel::compress_message(const void *&args,
+                                              size_t &arglen) const
+    //--------------------------------------------------------------------------
+    {
+#ifdef LEGION_USE_LZ4
+      // Compress everything after the prefix and the message count,
+      // but only keep it if it actually got smaller
+      const size_t header_size = 
+        virtual_channel_prefix_size() + sizeof(unsigned);
+      const size_t raw_size = arglen - header_size;
+      const int bound = LZ4_compressBound(raw_size);
+      uint8_t *compressed = 
+        (uint8_t*)malloc(header_size + sizeof(raw_size) + bound);
+      const int compressed_size = LZ4_compress_default(
+          (const char*)args + header_size,
+          (char*)compressed + header_size + sizeof(raw_size),
+          raw_size, bound);
+      if ((compressed_size > 0) &&
+          ((compressed_size + sizeof(raw_size)) < raw_size))
+      {
+        memcpy(compressed, args, header_size);
+        unsigned num_messages;
+        memcpy(&num_messages, compressed + header_size - sizeof(unsigned),
+               sizeof(num_messages));
+        num_messages |= COMPRESSED_MESSAGES;
+        memcpy(compressed + header_size - sizeof(unsigned), &num_messages,
+               sizeof(num_messages));
+        memcpy(compressed + header_size, &raw_size, sizeof(raw_size));
+        if (statistics != NULL)
+          statistics->record_send(channel_kind, arglen,
+              header_size + sizeof(raw_size) + compressed_size);
+        args = compressed;
+        arglen = header_size + sizeof(raw_size) + compressed_size;
+        return compressed;
+      }
+      free(compressed);
+#endif
+      if (statistics != NULL)
+        statistics->record_send(channel_kind, arglen, arglen);
+      return NULL;
+    }
+
+    //--------------------------------------------------------------------------
+    bool VirtualChannel::should_compress(size_t arglen) const
+    //--------------------------------------------------------------------------
+    {
+#ifdef LEGION_USE_LZ4
+      return (compression_threshold > 0) && (arglen >= compression_threshold) &&
+        ((arglen - virtual_channel_prefix_size() - sizeof(unsigned)) <=
+         LZ4_MAX_INPUT_SIZE);
+#else
+      return false;
+#endif
+    }
+
+    //--------------------------------------------------------------------------
+    RtEvent VirtualChannel::issue_message(const void *args, size_t arglen,
+                                       MessageKind kind, Processor target,
+                                       bool response, RtEvent precondition)
+    //--------------------------------------------------------------------------
+    {
       // Send the message directly there, don't go through the
       // runtime interface to avoid being counted, still include
       // a profiling request though if necessary in order to 
@@ -11898,57 +12298,26 @@ namespace Legion {
       if (profile_outgoing_messages)
       {
         Realm::ProfilingRequestSet requests;
-        const RtEvent precondition = (ordered_channel || 
-               ((header != FULL_MESSAGE) && !first_partial)) ?
-                (send_precondition.exists() ? 
-                  Runtime::merge_events(send_precondition, last_message_event) :
-                  last_message_event) : send_precondition;
         LegionProfiler::add_message_request(
             requests, kind, target, precondition);
-        last_message_event = RtEvent(target.spawn(
+        return RtEvent(target.spawn(
 #ifdef LEGION_SEPARATE_META_TASKS
               LG_TASK_ID + LG_MESSAGE_ID + kind,
 #else
               LG_TASK_ID, 
 #endif
-              sending_buffer, sending_index, requests, precondition,
+              args, arglen, requests, precondition,
               response ? response_priority : request_priority));
-        if (!ordered_channel && (header != PARTIAL_MESSAGE))
-        {
-          unordered_events.insert(last_message_event);
-          if (unordered_events.size() >= MAX_UNORDERED_EVENTS)
-            filter_unordered_events();
-        }
       }
       else
-      {
-        last_message_event = RtEvent(target.spawn(
+        return RtEvent(target.spawn(
 #ifdef LEGION_SEPARATE_META_TASKS
                 LG_TASK_ID + LG_MESSAGE_ID + kind,
 #else
                 LG_TASK_ID, 
 #endif
-                sending_buffer, sending_index, 
-                (ordered_channel || 
-                 ((header != FULL_MESSAGE) && !first_partial)) ?
-                  (send_precondition.exists() ? 
-                   Runtime::merge_events(send_precondition,last_message_event) :
-                   last_message_event) : send_precondition, 
+                args, arglen, precondition,
                 response ? response_priority : request_priority));
-        if (!ordered_channel && (header != PARTIAL_MESSAGE))
-        {
-          unordered_events.insert(last_message_event);
-          if (unordered_events.size() >= MAX_UNORDERED_EVENTS)
-            filter_unordered_events();
-        }
-      }
-      // Reset the state of the buffer
-      sending_index = base_size + sizeof(header) + sizeof(unsigned);
-      if (partial)
-        header = PARTIAL_MESSAGE;
-      else
-        header = FULL_MESSAGE;
-      packaged_messages = 0;
     }
 
     //--------------------------------------------------------------------------
@@ -11994,7 +12363,7 @@ namespace Legion {
           shutdown_manager->record_recent_message();
           // If this is the profiling channel then flush the messages
           if (profiling_virtual_channel)
-            send_message(true/*complete*/, implicit_runtime, target,
+            send_message(implicit_runtime, target,
                 SEND_PROFILER_EVENT_TRIGGER, false/*response*/,
                 RtEvent::NO_RT_EVENT);
         }
@@ -12047,7 +12416,7 @@ namespace Legion {
           shutdown_manager->record_recent_message(); 
           // If this is the profiling channel then flush the messages
           if (profiling_virtual_channel && (packaged_messages > 0))
-            send_message(true/*complete*/, implicit_runtime, target,
+            send_message(implicit_runtime, target,
                 SEND_PROFILER_EVENT_TRIGGER, false/*response*/,
                 RtEvent::NO_RT_EVENT);
         }
@@ -12097,113 +12466,40 @@ namespace Legion {
                          Runtime *runtime, AddressSpaceID remote_address_space)
     //--------------------------------------------------------------------------
     {
-      // Strip off our header and the number of messages, the 
-      // processor part was already stipped off by the Legion runtime
+      // Strip off the number of messages, the processor part was 
+      // already stipped off by the Legion runtime, and then handle
+      // the messages directly out of the task arguments
       const uint8_t *buffer = (const uint8_t*)args;
-      MessageHeader head; 
-      memcpy(&head, buffer, sizeof(head));
-      buffer += sizeof(head);
-      arglen -= sizeof(head);
       unsigned num_messages;
       memcpy(&num_messages, buffer, sizeof(num_messages));
       buffer += sizeof(num_messages);
       arglen -= sizeof(num_messages);
-      unsigned incoming_message_id = 0;
-      if (!ordered_channel)
-      {
-        incoming_message_id = ((unsigned)head) >> 2; 
-        head = (MessageHeader)(((unsigned)head) & 0x3);
-      }
-      switch (head)
-      {
-        case FULL_MESSAGE:
-          {
-            // Can handle these messages directly
-            handle_messages(num_messages, runtime, 
-                            remote_address_space, buffer, arglen);
-            break;
-          }
-        case PARTIAL_MESSAGE:
-          {
-            // Save these messages onto the receiving buffer
-            // but do not handle them
-            if (!ordered_channel)
-            {
-              AutoLock c_lock(channel_lock);
-              if (partial_assembly == NULL)
-                partial_assembly = new std::map<unsigned,PartialMessage>();
-              PartialMessage &message = 
-                (*partial_assembly)[incoming_message_id];
-              // Allocate the buffer on the first pass
-              if (message.buffer == NULL)
-              {
-                // Same as max message size
-                message.size = sending_buffer_size;
-                message.buffer = 
-                  (uint8_t*)legion_malloc(MESSAGE_BUFFER_ALLOC, message.size);
-              }
-              buffer_messages(num_messages, buffer, arglen,
-                              message.buffer, message.size,
-                              message.index, message.messages, message.total);
-            }
-            else
-              // Ordered channels don't need the lock
-              buffer_messages(num_messages, buffer, arglen, receiving_buffer, 
-                              receiving_buffer_size, receiving_index, 
-                              received_messages, partial_messages);
-            break;
-          }
-        case FINAL_MESSAGE:
-          {
-            // Save the remaining messages onto the receiving
-            // buffer, then handle them and reset the state.
-            uint8_t *final_buffer = NULL;
-            size_t final_index = 0;
-            unsigned final_messages = 0;
-            bool free_buffer = false;
-            if (!ordered_channel)
-            {
-              AutoLock c_lock(channel_lock);
-#ifdef DEBUG_LEGION
-              assert(partial_assembly != NULL);
-#endif
-              std::map<unsigned,PartialMessage>::iterator finder = 
-                partial_assembly->find(incoming_message_id);
-#ifdef DEBUG_LEGION
-              assert(finder != partial_assembly->end());
-              assert(finder->second.buffer != NULL);
+      if (num_messages & COMPRESSED_MESSAGES)
+      {
+#ifdef LEGION_USE_LZ4
+        num_messages &= ~COMPRESSED_MESSAGES;
+        size_t raw_size;
+        memcpy(&raw_size, buffer, sizeof(raw_size));
+        buffer += sizeof(raw_size);
+        arglen -= sizeof(raw_size);
+        char *raw = (char*)malloc(raw_size);
+        const int decompressed = LZ4_decompress_safe((const char*)buffer,
+                                                     raw, arglen, raw_size);
+        if ((decompressed < 0) || (size_t(decompressed) != raw_size))
+          REPORT_LEGION_FATAL(LEGION_FATAL_COMPRESSION_FAILURE,
+              "Failed to decompress a %zu byte batch of messages on "
+              "virtual channel %d from node %d", raw_size, channel_kind,
+              remote_address_space)
+        handle_messages(num_messages, runtime, remote_address_space,
+                        (const uint8_t*)raw, raw_size);
+        free(raw);
+#else
+        assert(false); // only nodes built with LZ4 compress messages
 #endif
-              buffer_messages(num_messages, buffer, arglen,
-                              finder->second.buffer, finder->second.size,
-                              finder->second.index, finder->second.messages,
-                              finder->second.total);
-              final_index = finder->second.index;
-              final_buffer = finder->second.buffer;
-              final_messages = finder->second.messages;
-              free_buffer = true;
-              partial_assembly->erase(finder);
-            }
-            else
-            {
-              buffer_messages(num_messages, buffer, arglen, receiving_buffer,
-                              receiving_buffer_size, receiving_index, 
-                              received_messages, partial_messages);
-              final_index = receiving_index;
-              final_buffer = receiving_buffer;
-              final_messages = received_messages;
-              receiving_index = 0;
-              received_messages = 0;
-              partial_messages = 0;
-            }
-            handle_messages(final_messages, runtime, remote_address_space,
-                                final_buffer, final_index);
-            if (free_buffer)
-              free(final_buffer);
-            break;
-          }
-        default:
-          assert(false); // should never get here
       }
+      else
+        handle_messages(num_messages, runtime, remote_address_space,
+                        buffer, arglen);
     }
 
     //--------------------------------------------------------------------------
@@ -13810,43 +14106,6 @@ namespace Legion {
 #endif
     }
 
-    //--------------------------------------------------------------------------
-    /*static*/ void VirtualChannel::buffer_messages(unsigned num_messages,
-                                         const void *args, size_t arglen,
-                                         uint8_t *&receiving_buffer,
-                                         size_t &receiving_buffer_size,
-                                         size_t &receiving_index,
-                                         unsigned &received_messages,
-                                         unsigned &partial_messages)
-    //--------------------------------------------------------------------------
-    {
-      received_messages += num_messages;
-      partial_messages += 1; // up the number of partial messages received
-      // Check to see if it fits
-      if (receiving_buffer_size < (receiving_index+arglen))
-      {
-        // Figure out what the new size should be
-        // Keep doubling until it's larger
-        size_t new_buffer_size = receiving_buffer_size;
-        while (new_buffer_size < (receiving_index+arglen))
-          new_buffer_size *= 2;
-#ifdef DEBUG_LEGION
-        assert(new_buffer_size != 0); // would cause deallocation
-#endif
-        // Now realloc the memory
-        void *new_ptr = legion_realloc(MESSAGE_BUFFER_ALLOC, receiving_buffer,
-                                       receiving_buffer_size, new_buffer_size);
-        receiving_buffer_size = new_buffer_size;
-#ifdef DEBUG_LEGION
-        assert(new_ptr != NULL);
-#endif
-        receiving_buffer = (uint8_t*)new_ptr;
-      }
-      // Copy the data in
-      memcpy(receiving_buffer+receiving_index,args,arglen);
-      receiving_index += arglen;
-    }
-
     /////////////////////////////////////////////////////////////
     // Message Manager 
     /////////////////////////////////////////////////////////////
@@ -13868,8 +14127,12 @@ namespace Legion {
       for (unsigned idx = 0; idx < MAX_NUM_VIRTUAL_CHANNELS; idx++)
       {
         VirtualChannelKind vc = (VirtualChannelKind)idx;
+        const size_t compression_threshold = 
+          (runtime->compress_channels & (1U << idx)) ?
+            runtime->compression_threshold : 0;
         new (channels+idx) VirtualChannel(vc, rt->address_space,
-            max_message_size, has_profiler);
+            max_message_size, has_profiler, compression_threshold,
+            runtime->message_stats);
       }
     }
 
@@ -16605,6 +16868,40 @@ namespace Legion {
       Mappable *mappable = is_functional ? NULL : op->get_mappable();
       size_t arglen = 0;
       const void *args = req.get_projection_args(&arglen);
+      // Functional projection functors without arguments always produce
+      // the same regions for the same upper bound and launch space so we
+      // can memoize them and skip calling the functor on later launches
+      const bool cacheable = is_functional && (args == NULL) &&
+        !op->runtime->disable_projection_cache;
+      ProjectionKey key;
+      std::vector<LogicalRegion> regions;
+      if (cacheable)
+      {
+        if (root->is_region())
+          key.region = root->as_region_node()->handle;
+        else
+          key.partition = root->as_partition_node()->handle;
+        key.launch_space = launch_space->handle;
+        key.local_space = local_space;
+        bool cached = false;
+        {
+          AutoLock c_lock(cache_lock,1,false/*exclusive*/);
+          std::map<ProjectionKey,std::vector<LogicalRegion> >::const_iterator
+            finder = cached_results.find(key);
+          if (finder != cached_results.end())
+          {
+            regions = finder->second;
+            cached = true;
+          }
+        }
+        if (cached)
+        {
+          for (std::vector<LogicalRegion>::const_iterator it =
+                regions.begin(); it != regions.end(); it++)
+            add_to_projection_tree(*it, root, forest, node_map, local_shard);
+          return result;
+        }
+      }
       if (root->is_region())
       {
         RegionNode *region = root->as_region_node();
@@ -16632,6 +16929,8 @@ namespace Legion {
                                          result, op->runtime);
           if (!result.exists())
             continue;
+          if (cacheable)
+            regions.push_back(result);
           add_to_projection_tree(result, root, forest, node_map, local_shard);
         }
       }
@@ -16662,12 +16961,46 @@ namespace Legion {
                                             result, op->runtime);
           if (!result.exists())
             continue;
+          if (cacheable)
+            regions.push_back(result);
           add_to_projection_tree(result, root, forest, node_map, local_shard);
         }
       }
+      if (cacheable)
+      {
+        AutoLock c_lock(cache_lock);
+        // Bound the size of the cache by starting over when it fills up
+        if (cached_results.size() >= LEGION_MAX_PROJECTION_CACHE_ENTRIES)
+          cached_results.clear();
+        cached_results[key].swap(regions);
+      }
       return result;
     }
 
+    //--------------------------------------------------------------------------
+    void ProjectionFunction::invalidate_cached_results(IndexTreeID tree)
+    //--------------------------------------------------------------------------
+    {
+      AutoLock c_lock(cache_lock);
+      // Functors only walk down from their upper bound so only results
+      // whose upper bound lives in the same index space tree are stale
+      for (std::map<ProjectionKey,std::vector<LogicalRegion> >::iterator it =
+            cached_results.begin(); it != cached_results.end(); /*nothing*/)
+      {
+        const IndexTreeID key_tree = it->first.region.exists() ?
+          it->first.region.get_index_space().get_tree_id() :
+          it->first.partition.get_index_partition().get_tree_id();
+        if (key_tree == tree)
+        {
+          std::map<ProjectionKey,std::vector<LogicalRegion> >::iterator
+            to_delete = it++;
+          cached_results.erase(to_delete);
+        }
+        else
+          it++;
+      }
+    }
+
     //--------------------------------------------------------------------------
     /*static*/ void ProjectionFunction::add_to_projection_tree(LogicalRegion r,
                             RegionTreeNode *root, RegionTreeForest *context,
@@ -16986,11 +17319,17 @@ namespace Legion {
         eager_alloc_percentage(config.eager_alloc_percentage),
         eager_alloc_percentage_overrides(config.eager_alloc_percentage_overrides),
         max_message_size(config.max_message_size),
+        compress_channels(config.compress_channels),
+        compression_threshold(config.compression_threshold),
         gc_epoch_size(config.gc_epoch_size),
         max_control_replication_contexts(
                       config.max_control_replication_contexts),
         max_local_fields(config.max_local_fields),
         max_replay_parallelism(config.max_replay_parallelism),
+        point_task_batch(config.point_task_batch),
+        auto_trace_window(config.auto_trace_window),
+        auto_trace_min_length(config.auto_trace_min_length),
+        auto_trace_max_traces(config.auto_trace_max_traces),
         safe_control_replication(config.safe_control_replication),
         program_order_execution(config.program_order_execution),
         dump_physical_traces(config.dump_physical_traces),
@@ -17000,6 +17339,7 @@ namespace Legion {
         no_fence_elision(config.no_fence_elision),
         no_transitive_reduction(config.no_transitive_reduction),
         replay_on_cpus(config.replay_on_cpus),
+        replay_stealing(config.replay_stealing),
         verify_partitions(config.verify_partitions),
         runtime_warnings(config.runtime_warnings),
         warnings_backtrace(config.warnings_backtrace),
@@ -17016,7 +17356,10 @@ namespace Legion {
         unsafe_mapper(!config.safe_mapper),
 #endif
         safe_tracing(config.safe_tracing),
+        auto_tracing(config.auto_tracing),
         disable_independence_tests(config.disable_independence_tests),
+        disable_projection_cache(config.disable_projection_cache),
+        parallel_logical_analysis(config.parallel_logical_analysis),
         legion_spy_enabled(config.legion_spy_enabled),
         supply_default_mapper(default_mapper),
         enable_test_mapper(config.enable_test_mapper),
@@ -17030,7 +17373,9 @@ namespace Legion {
 #endif
         check_privileges(config.check_privileges),
         dump_free_ranges(config.dump_free_ranges),
+        message_stats(config.message_stats ? new MessageStatistics() : NULL),
         legion_collective_radix(config.legion_collective_radix),
+        flat_shard_collectives(config.flat_shard_collectives),
         mpi_rank_table((mpi_rank >= 0) ? new MPIRankTable(this) : NULL),
         prepared_for_shutdown(false), total_outstanding_tasks(0), 
         outstanding_top_level_tasks(initialize_outstanding_top_level_tasks(
@@ -17201,10 +17546,16 @@ namespace Legion {
         initial_meta_task_vector_width(rhs.initial_meta_task_vector_width),
         eager_alloc_percentage(rhs.eager_alloc_percentage),
         max_message_size(rhs.max_message_size),
+        compress_channels(rhs.compress_channels),
+        compression_threshold(rhs.compression_threshold),
         gc_epoch_size(rhs.gc_epoch_size), 
         max_control_replication_contexts(rhs.max_control_replication_contexts),
         max_local_fields(rhs.max_local_fields),
         max_replay_parallelism(rhs.max_replay_parallelism),
+        point_task_batch(rhs.point_task_batch),
+        auto_trace_window(rhs.auto_trace_window),
+        auto_trace_min_length(rhs.auto_trace_min_length),
+        auto_trace_max_traces(rhs.auto_trace_max_traces),
         safe_control_replication(rhs.safe_control_replication),
         program_order_execution(rhs.program_order_execution),
         dump_physical_traces(rhs.dump_physical_traces),
@@ -17214,6 +17565,7 @@ namespace Legion {
         no_fence_elision(rhs.no_fence_elision),
         no_transitive_reduction(rhs.no_transitive_reduction),
         replay_on_cpus(rhs.replay_on_cpus),
+        replay_stealing(rhs.replay_stealing),
         verify_partitions(rhs.verify_partitions),
         runtime_warnings(rhs.runtime_warnings),
         warnings_backtrace(rhs.warnings_backtrace),
@@ -17226,7 +17578,10 @@ namespace Legion {
         unsafe_launch(rhs.unsafe_launch),
         unsafe_mapper(rhs.unsafe_mapper),
         safe_tracing(rhs.safe_tracing),
+        auto_tracing(rhs.auto_tracing),
         disable_independence_tests(rhs.disable_independence_tests),
+        disable_projection_cache(rhs.disable_projection_cache),
+        parallel_logical_analysis(rhs.parallel_logical_analysis),
         legion_spy_enabled(rhs.legion_spy_enabled),
         supply_default_mapper(rhs.supply_default_mapper),
         enable_test_mapper(rhs.enable_test_mapper),
@@ -17239,8 +17594,9 @@ namespace Legion {
         physical_logging_only(rhs.physical_logging_only),
 #endif
         check_privileges(rhs.check_privileges),
-        dump_free_ranges(rhs.dump_free_ranges),
+        dump_free_ranges(rhs.dump_free_ranges), message_stats(NULL),
         legion_collective_radix(rhs.legion_collective_radix),
+        flat_shard_collectives(rhs.flat_shard_collectives),
         mpi_rank_table(NULL), local_procs(rhs.local_procs), 
         local_utils(rhs.local_utils), proc_spaces(rhs.proc_spaces)
     //--------------------------------------------------------------------------
@@ -17268,6 +17624,8 @@ namespace Legion {
           message_managers[idx].store(NULL);
         }
       } 
+      if (message_stats != NULL)
+        delete message_stats;
       // Free any input arguments
       if (input_args.argc > 0)
       {
@@ -18211,6 +18569,8 @@ namespace Legion {
         it->second->finalize();
       if (profiler != NULL)
         profiler->finalize();
+      if (message_stats != NULL)
+        message_stats->report(address_space);
     }
     
     //--------------------------------------------------------------------------
@@ -20468,6 +20828,18 @@ namespace Legion {
 #endif
     }
 
+    //--------------------------------------------------------------------------
+    void Runtime::invalidate_projection_caches(IndexTreeID tree)
+    //--------------------------------------------------------------------------
+    {
+      if (disable_projection_cache)
+        return;
+      AutoLock p_lock(projection_lock,1,false/*exclusive*/);
+      for (std::map<ProjectionID,ProjectionFunction*>::const_iterator it =
+            projection_functions.begin(); it != projection_functions.end(); it++)
+        it->second->invalidate_cached_results(tree);
+    }
+
     //--------------------------------------------------------------------------
     void Runtime::attach_semantic_information(TaskID task_id, SemanticTag tag,
            const void *buffer, size_t size, bool is_mutable, bool send_to_owner)
@@ -30416,7 +30788,27 @@ namespace Legion {
         perform_slow_config_checks(config);
       // Configure legion spy if necessary
       if (config.legion_spy_enabled)
+      {
+        if (!config.spy_logfile.empty())
+        {
+          const AddressSpaceID local_space = 
+            Machine::ProcessorQuery(Machine::get_machine())
+              .local_address_space().first().address_space();
+          // Replace any % in the file name with the node id
+          std::string filename(config.spy_logfile);
+          const size_t pct = filename.find_first_of('%', 0);
+          if (pct != std::string::npos)
+          {
+            std::stringstream ss;
+            ss << filename.substr(0, pct) << local_space <<
+                  filename.substr(pct + 1);
+            filename = ss.str();
+          }
+          LegionSpy::binary_spy = 
+            new LegionSpy::BinarySpyStream(filename, local_space);
+        }
         LegionSpy::log_legion_spy_config();
+      }
       // Construct our runtime objects 
       std::set<Processor> local_procs;
       std::map<Processor,Runtime*> processor_mapping;
@@ -30525,7 +30917,9 @@ namespace Legion {
       // this node is ready to shutdown when everything is done
       the_runtime->decrement_outstanding_top_level_tasks();
       // Wait for Realm shutdown to be complete
-      return realm.wait_for_shutdown();
+      const int result = realm.wait_for_shutdown();
+      LegionSpy::close_binary_spy();
+      return result;
     }
 
     //--------------------------------------------------------------------------
@@ -30622,6 +31016,13 @@ namespace Legion {
         .add_option_bool("-lg:unsafe_mapper",config.unsafe_mapper,!filter)
         .add_option_bool("-lg:safe_mapper",config.safe_mapper,!filter)
         .add_option_bool("-lg:safe_tracing", config.safe_tracing, !filter)
+        .add_option_bool("-lg:auto_trace", config.auto_tracing, !filter)
+        .add_option_int("-lg:auto_trace_window",
+                        config.auto_trace_window, !filter)
+        .add_option_int("-lg:auto_trace_min",
+                        config.auto_trace_min_length, !filter)
+        .add_option_int("-lg:auto_trace_max",
+                        config.auto_trace_max_traces, !filter)
         .add_option_int("-lg:safe_ctrlrepl",
                          config.safe_control_replication, !filter)
         .add_option_bool("-lg:inorder",config.program_order_execution,!filter)
@@ -30638,6 +31039,8 @@ namespace Legion {
                          config.no_transitive_reduction, !filter)
         .add_option_bool("-lg:replay_on_cpus",
                          config.replay_on_cpus, !filter)
+        .add_option_bool("-lg:replay_stealing",
+                         config.replay_stealing, !filter)
         .add_option_bool("-lg:disjointness",
                          config.verify_partitions, !filter)
         .add_option_bool("-lg:partcheck",
@@ -30658,16 +31061,28 @@ namespace Legion {
         .add_option_bool("-lg:dump_free_ranges",
                          config.dump_free_ranges, !filter)
         .add_option_int("-lg:message",config.max_message_size, !filter)
+        .add_option_int("-lg:compress", config.compress_channels, !filter)
+        .add_option_int("-lg:compress_threshold",
+                        config.compression_threshold, !filter)
+        .add_option_bool("-lg:message_stats", config.message_stats, !filter)
+        .add_option_bool("-lg:flat_collectives", 
+                         config.flat_shard_collectives, !filter)
         .add_option_int("-lg:epoch", config.gc_epoch_size, !filter)
         .add_option_int("-lg:local", config.max_local_fields, !filter)
         .add_option_int("-lg:parallel_replay", 
                         config.max_replay_parallelism, !filter)
+        .add_option_int("-lg:point_batch", config.point_task_batch, !filter)
         .add_option_bool("-lg:no_dyn",config.disable_independence_tests,!filter)
+        .add_option_bool("-lg:no_projection_cache",
+                         config.disable_projection_cache, !filter)
+        .add_option_bool("-lg:parallel_analysis",
+                         config.parallel_logical_analysis, !filter)
         .add_option_bool("-lg:spy",config.legion_spy_enabled, !filter)
         .add_option_bool("-lg:test",config.enable_test_mapper, !filter)
         .add_option_int("-lg:delay", config.delay_start, !filter)
         .add_option_string("-lg:replay", config.replay_file, !filter)
         .add_option_string("-lg:ldb", config.ldb_file, !filter)
+        .add_option_string("-lg:spy_logfile", config.spy_logfile, !filter)
 #ifdef DEBUG_LEGION
         .add_option_bool("-lg:tree",config.logging_region_tree_state, !filter)
         .add_option_bool("-lg:verbose",config.verbose_logging, !filter)
@@ -30712,6 +31127,7 @@ namespace Legion {
         .add_option_int("-hl:delay", config.delay_start, !filter)
         .add_option_string("-hl:replay", config.replay_file, !filter)
         .add_option_string("-hl:ldb", config.ldb_file, !filter)
+        .add_option_string("-hl:spy_logfile", config.spy_logfile, !filter)
 #ifdef DEBUG_LEGION
         .add_option_bool("-hl:tree",config.logging_region_tree_state,!filter)
         .add_option_bool("-hl:verbose",config.verbose_logging,!filter)
@@ -30768,6 +31184,13 @@ namespace Legion {
             "Illegal max local fields value %d which is larger than the "
             "value of LEGION_MAX_FIELDS (%d).", config.max_local_fields,
             LEGION_MAX_FIELDS)
+#ifndef LEGION_USE_LZ4
+      if (config.compress_channels != 0)
+        REPORT_LEGION_ERROR(ERROR_LEGION_CONFIGURATION,
+            "Message compression was requested with -lg:compress but "
+            "Legion was not built with LZ4 support. Please rebuild with "
+            "USE_LZ4=1 or -DLegion_USE_LZ4=ON.")
+#endif
       const Realm::Logger::LoggingLevel compile_time_min_level =
             Realm::Logger::REALM_LOGGING_MIN_LEVEL;
       if (config.legion_spy_enabled && 
@@ -31678,7 +32101,9 @@ namespace Legion {
       // we need to remove our reference to allow shutdown to proceed
       if (!background_wait.exchange(true))
         the_runtime->decrement_outstanding_top_level_tasks();
-      return RealmRuntime::get_runtime().wait_for_shutdown();
+      const int result = RealmRuntime::get_runtime().wait_for_shutdown();
+      LegionSpy::close_binary_spy();
+      return result;
     }
 
     //--------------------------------------------------------------------------
@@ -32499,6 +32924,11 @@ namespace Legion {
             InnerContext::handle_dependence_stage(args);
             break;
           }
+        case LG_PARALLEL_DEPENDENCE_ID:
+          {
+            InnerContext::handle_parallel_dependence_stage(args);
+            break;
+          }
         case LG_DEFERRED_MAPPED_ID:
           {
             InnerContext::handle_deferred_mapped_queue(args);
@@ -32768,6 +33198,11 @@ namespace Legion {
             PhysicalTemplate::handle_replay_slice(args);
             break;
           }
+        case LG_REPLAY_CHUNKS_TASK_ID:
+          {
+            PhysicalTemplate::handle_replay_chunks(args);
+            break;
+          }
         case LG_TRANSITIVE_REDUCTION_TASK_ID:
           {
             PhysicalTemplate::handle_transitive_reduction(args);
@@ -32981,44 +33416,57 @@ namespace Legion {
           implicit_profiler = 
             runtime->profiler->find_or_create_profiling_instance();
       }
-      Realm::ProfilingResponse response(args, arglen);
-      const ProfilingResponseBase *base = 
-        static_cast<const ProfilingResponseBase*>(response.user_data());
-      LgEvent fevent;
-      if (base->handler == NULL)
+      // The profiler's own requests allow Realm to batch their responses
+      // so we may be handed several of them at once here
+      const Realm::ProfilingResponseBatch batch(args, arglen);
+      for (unsigned idx = 0; idx < batch.size(); idx++)
       {
-        // This is the remote message case
+        const void *data = batch.response_data(idx);
+        const size_t size = batch.response_size(idx);
+        Realm::ProfilingResponse response(data, size);
+        const ProfilingResponseBase *base = 
+          static_cast<const ProfilingResponseBase*>(response.user_data());
+        LgEvent fevent;
+        if (base->handler == NULL)
+        {
+          // This is the remote message case
 #ifdef DEBUG_LEGION
-        assert(runtime->profiler != NULL);
+          assert(runtime->profiler != NULL);
 #endif
-        const long long t_start = Realm::Clock::current_time_in_nanoseconds();
-        // Check to see if should report this profiling
-        if (runtime->profiler->handle_profiling_response(response, args,
-                                                         arglen, fevent))
-        {
-          const long long t_stop = Realm::Clock::current_time_in_nanoseconds();
-          const LgEvent finish_event(Processor::get_current_finish_event());
-          implicit_profiler->process_proc_desc(p);
-          implicit_profiler->record_proftask(p, base->op_id, t_start, t_stop,
-              fevent, finish_event, base->completion);
+          const long long t_start = 
+            Realm::Clock::current_time_in_nanoseconds();
+          // Check to see if should report this profiling
+          if (runtime->profiler->handle_profiling_response(response, data,
+                                                           size, fevent))
+          {
+            const long long t_stop = 
+              Realm::Clock::current_time_in_nanoseconds();
+            const LgEvent finish_event(Processor::get_current_finish_event());
+            implicit_profiler->process_proc_desc(p);
+            implicit_profiler->record_proftask(p, base->op_id, t_start,
+                t_stop, fevent, finish_event, base->completion);
+          }
         }
-      }
-      else if (runtime->profiler != NULL)
-      {
-        const long long t_start = Realm::Clock::current_time_in_nanoseconds();
-        // Check to see if should report this profiling
-        if (base->handler->handle_profiling_response(response, args, arglen, 
-                                                     fevent))
+        else if (runtime->profiler != NULL)
         {
-          const long long t_stop = Realm::Clock::current_time_in_nanoseconds();
-          const LgEvent finish_event(Processor::get_current_finish_event());
-          implicit_profiler->process_proc_desc(p);
-          implicit_profiler->record_proftask(p, base->op_id, t_start, t_stop,
-              fevent, finish_event, base->completion);
+          const long long t_start = 
+            Realm::Clock::current_time_in_nanoseconds();
+          // Check to see if should report this profiling
+          if (base->handler->handle_profiling_response(response, data, size,
+                                                       fevent))
+          {
+            const long long t_stop = 
+              Realm::Clock::current_time_in_nanoseconds();
+            const LgEvent finish_event(Processor::get_current_finish_event());
+            implicit_profiler->process_proc_desc(p);
+            implicit_profiler->record_proftask(p, base->op_id, t_start,
+                t_stop, fevent, finish_event, base->completion);
+          }
         }
+        else
+          base->handler->handle_profiling_response(response, data, size,
+                                                   fevent);
       }
-      else
-        base->handler->handle_profiling_response(response, args, arglen,fevent);
     }
 
     //--------------------------------------------------------------------------
@@ -33152,6 +33600,11 @@ namespace Legion {
             PhysicalTemplate::handle_replay_slice(args);
             break;
           }
+        case LG_REPLAY_CHUNKS_TASK_ID:
+          {
+            PhysicalTemplate::handle_replay_chunks(args);
+            break;
+          }
         case LG_FREE_EXTERNAL_TASK_ID:
           {
             FutureInstance::handle_free_external(args);
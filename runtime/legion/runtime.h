@@ -408,6 +408,8 @@ namespace Legion {
       void set_local(const void *value, size_t size, bool own = false);
       // This will save the value of the future locally
       void unpack_future_result(Deserializer &derez);
+      // This will save a small value that was sent along with the future
+      void unpack_inline_result(Deserializer &derez);
       void save_metadata(const void *meta, size_t size);
       // Reset the future in case we need to restart the
       // computation for resiliency reasons
@@ -446,6 +448,7 @@ namespace Legion {
       void perform_broadcast(void);
       // must be holding lock
       void pack_future_result(Serializer &rez, AddressSpaceID target);
+      bool pack_inline_result(Serializer &rez); // must be holding lock
     public:
       RtEvent record_future_registered(void);
       static void handle_future_result(Deserializer &derez, Runtime *rt);
@@ -576,6 +579,9 @@ namespace Legion {
                      LgEvent unique_event = LgEvent::NO_LG_EVENT,
                      PhysicalInstance inst = PhysicalInstance::NO_INST,
                      RtEvent use_event = RtEvent::NO_RT_EVENT);
+      // Store a small value in the buffer inside of the future instance,
+      // the value can be NULL if the buffer will be written later
+      FutureInstance(const void *value, size_t size);
       FutureInstance(const FutureInstance &rhs) = delete;
       ~FutureInstance(void);
     public:
@@ -628,6 +634,8 @@ namespace Legion {
       const bool eager_allocation;
       const bool external_allocation;
       const bool is_meta_visible;
+      // Whether the data lives in the inline buffer of this object
+      const bool inline_allocation;
     protected:
       bool own_allocation;
       std::atomic<const void*> data;
@@ -643,6 +651,8 @@ namespace Legion {
       // We can own the instance without owning the allocation in the case
       // of external allocations that we don't own but make an instance later
       bool own_instance;
+      // Storage for values no bigger than LEGION_MAX_INLINE_FUTURE_SIZE
+      alignas(16) char inline_buffer[LEGION_MAX_INLINE_FUTURE_SIZE];
     };
 
     /**
@@ -1808,6 +1818,40 @@ namespace Legion {
       };
     }; 
 
+    /**
+     * \class MessageStatistics
+     * Counts of the messages and bytes sent from this node for each
+     * kind of message, along with how many bytes each virtual channel
+     * actually put on the wire after compression. Reported at shutdown
+     * when running with -lg:message_stats.
+     */
+    class MessageStatistics {
+    public:
+      MessageStatistics(void);
+      MessageStatistics(const MessageStatistics &rhs) = delete;
+      MessageStatistics& operator=(const MessageStatistics &rhs) = delete;
+    public:
+      inline void record_message(MessageKind kind, size_t bytes)
+      {
+        message_counts[kind].fetch_add(1, std::memory_order_relaxed);
+        message_bytes[kind].fetch_add(bytes, std::memory_order_relaxed);
+      }
+      inline void record_send(VirtualChannelKind channel, 
+                              size_t packaged_bytes, size_t sent_bytes)
+      {
+        channel_packaged_bytes[channel].fetch_add(packaged_bytes,
+                                                  std::memory_order_relaxed);
+        channel_sent_bytes[channel].fetch_add(sent_bytes,
+                                              std::memory_order_relaxed);
+      }
+      void report(AddressSpaceID local_space) const;
+    private:
+      std::atomic<uint64_t> message_counts[LAST_SEND_KIND];
+      std::atomic<uint64_t> message_bytes[LAST_SEND_KIND];
+      std::atomic<uint64_t> channel_packaged_bytes[MAX_NUM_VIRTUAL_CHANNELS];
+      std::atomic<uint64_t> channel_sent_bytes[MAX_NUM_VIRTUAL_CHANNELS];
+    };
+
     /**
      * \class VirtualChannel
      * This class provides the basic support for sending and receiving
@@ -1815,29 +1859,13 @@ namespace Legion {
      */
     class VirtualChannel {
     public:
-      // Implement a three-state state-machine for sending
-      // messages.  Either fully self-contained messages
-      // or chains of partial messages followed by a final
-      // message.
-      enum MessageHeader {
-        FULL_MESSAGE = 0x1,
-        PARTIAL_MESSAGE = 0x2,
-        FINAL_MESSAGE = 0x3,
-      };
-      struct PartialMessage {
-      public:
-        PartialMessage(void)
-          : buffer(NULL), size(0), index(0), messages(0), total(0) { }
-      public:
-        uint8_t *buffer;
-        size_t size;
-        size_t index;
-        unsigned messages;
-        unsigned total;
-      };
+      // Set in the message count of a batch whose messages have been
+      // compressed, in which case the uncompressed size follows the count
+      static const unsigned COMPRESSED_MESSAGES = 0x80000000;
     public:
       VirtualChannel(VirtualChannelKind kind,AddressSpaceID local_address_space,
-               size_t max_message_size, bool profile);
+               size_t max_message_size, bool profile,
+               size_t compression_threshold, MessageStatistics *statistics);
       VirtualChannel(const VirtualChannel &rhs);
       ~VirtualChannel(void);
     public:
@@ -1852,51 +1880,67 @@ namespace Legion {
       void confirm_shutdown(ShutdownManager *shutdown_manager, bool phase_one,
           Processor target, bool profiling_virtual_channel);
     private:
-      void send_message(bool complete, Runtime *runtime, Processor target, 
+      // A packed batch that will be compressed and spawned after
+      // the channel lock is released
+      struct PendingCompression {
+      public:
+        uint8_t *buffer;
+        size_t size;
+        MessageKind kind;
+        Processor target;
+        bool response;
+        RtEvent precondition;
+        RtUserEvent spawned;
+      };
+    private:
+      void send_message(Runtime *runtime, Processor target, 
                         MessageKind kind, bool response,
-                        RtEvent send_precondition);
+                        RtEvent send_precondition,
+                        std::vector<PendingCompression> *pending = NULL);
+      void send_direct_message(Serializer &rez, MessageKind kind,
+                               Processor target, bool response,
+                               RtEvent send_precondition,
+                               std::vector<PendingCompression> &pending);
+      void spawn_message(const void *args, size_t arglen, MessageKind kind,
+                         Processor target, bool response,
+                         RtEvent send_precondition);
+      void defer_compression(uint8_t *buffer, size_t size, MessageKind kind,
+                         Processor target, bool response,
+                         RtEvent send_precondition,
+                         std::vector<PendingCompression> &pending);
+      void compress_and_spawn(PendingCompression &pending);
+      uint8_t* compress_message(const void *&args, size_t &arglen) const;
+      bool should_compress(size_t arglen) const;
+      RtEvent order_message(RtEvent send_precondition) const;
+      void record_message(RtEvent sent);
+      RtEvent issue_message(const void *args, size_t arglen, MessageKind kind,
+                            Processor target, bool response,
+                            RtEvent precondition);
+      static size_t pack_message_header(uint8_t *buffer, MessageKind kind,
+                                        size_t message_size);
       void handle_messages(unsigned num_messages, Runtime *runtime, 
                            AddressSpaceID remote_address_space,
                            const uint8_t *args, size_t arglen) const;
-      static void buffer_messages(unsigned num_messages,
-                                  const void *args, size_t arglen,
-                                  uint8_t *&receiving_buffer,
-                                  size_t &receiving_buffer_size,
-                                  size_t &receiving_index,
-                                  unsigned &received_messages,
-                                  unsigned &partial_messages);
       void filter_unordered_events(void);
     private:
       mutable LocalLock channel_lock;
-      uint8_t *const sending_buffer;
+      uint8_t *sending_buffer;
       unsigned sending_index;
       const size_t sending_buffer_size;
       RtEvent last_message_event;
-      MessageHeader header;
       unsigned packaged_messages;
-      // For unordered channels so we can group partial
-      // messages from remote nodes
-      unsigned partial_message_id;
-      bool partial;
     private:
+      const VirtualChannelKind channel_kind;
       const bool ordered_channel;
       const bool profile_outgoing_messages;
+      // Batches at least this large get compressed (zero means never)
+      const size_t compression_threshold;
+      MessageStatistics *const statistics;
       const LgPriority request_priority;
       const LgPriority response_priority;
       static const unsigned MAX_UNORDERED_EVENTS = 32;
       std::set<RtEvent> unordered_events;
     private:
-      // State for receiving messages
-      // No lock for receiving messages since we know
-      // that they are ordered for ordered virtual
-      // channels, for un-ordered virtual channels then
-      // we know that we do need the lock
-      uint8_t *receiving_buffer;
-      size_t receiving_buffer_size;
-      size_t receiving_index;
-      unsigned received_messages;
-      unsigned partial_messages;
-      std::map<unsigned/*message id*/,PartialMessage> *partial_assembly;
       mutable bool observed_recent;
     }; 
 
@@ -1907,16 +1951,14 @@ namespace Legion {
      * The manager also abstracts some of the details of sending these
      * messages.  Messages can be accumulated together in bulk messages
      * for performance reason.  The runtime can also place an upper
-     * bound on the size of the data communicated between runtimes in
-     * an active message, which the message manager then uses to
-     * break down larger messages into smaller active messages.
+     * bound on the size of the buffer used for accumulating messages;
+     * any message larger than that bound is copied once into a staging
+     * buffer sized for it and sent by itself instead of being split up.
      *
      * On the receiving side, the message manager unpacks the messages
      * that have been sent and then call the appropriate runtime
-     * methods for handling the messages.  In cases where larger
-     * messages were broken down into smaller messages, then message
-     * manager waits until it has received all the active messages
-     * before handling the message.
+     * methods for handling the messages, deserializing them in place
+     * from the active message payload.
      */
     class MessageManager { 
     public:
@@ -2316,6 +2358,42 @@ namespace Legion {
      * A class for wrapping projection functors
      */
     class ProjectionFunction { 
+    public:
+      // Key for memoizing the regions that a functional projection
+      // functor produces for a given upper bound and launch space
+      struct ProjectionKey {
+      public:
+        ProjectionKey(void)
+          : region(LogicalRegion::NO_REGION), 
+            partition(LogicalPartition::NO_PART),
+            launch_space(IndexSpace::NO_SPACE), 
+            local_space(IndexSpace::NO_SPACE) { }
+        ProjectionKey(LogicalRegion r, LogicalPartition p,
+                      IndexSpace launch, IndexSpace local)
+          : region(r), partition(p), launch_space(launch), 
+            local_space(local) { }
+      public:
+        inline bool operator<(const ProjectionKey &rhs) const
+        {
+          if (region < rhs.region)
+            return true;
+          if (rhs.region < region)
+            return false;
+          if (partition < rhs.partition)
+            return true;
+          if (rhs.partition < partition)
+            return false;
+          if (launch_space < rhs.launch_space)
+            return true;
+          if (launch_space > rhs.launch_space)
+            return false;
+          return local_space < rhs.local_space;
+        }
+      public:
+        LogicalRegion region;
+        LogicalPartition partition;
+        IndexSpace launch_space, local_space;
+      };
     public:
       ProjectionFunction(ProjectionID pid, ProjectionFunctor *functor);
       ProjectionFunction(const ProjectionFunction &rhs);
@@ -2374,6 +2452,7 @@ namespace Legion {
                   RegionTreeNode *root, RegionTreeForest *context, 
                   std::map<RegionTreeNode*,ProjectionNode*> &node_map,
                   ShardID owner_shard);
+      void invalidate_cached_results(IndexTreeID tree);
     public:
       const unsigned depth; 
       const bool is_exclusive;
@@ -2383,6 +2462,8 @@ namespace Legion {
       ProjectionFunctor *const functor;
     protected:
       mutable LocalLock projection_reservation;  
+      mutable LocalLock cache_lock;
+      std::map<ProjectionKey,std::vector<LogicalRegion> > cached_results;
     }; 
 
     /**
@@ -2505,11 +2586,17 @@ namespace Legion {
             eager_alloc_percentage(LEGION_DEFAULT_EAGER_ALLOC_PERCENTAGE),
             eager_alloc_percentage_overrides({}),
             max_message_size(LEGION_DEFAULT_MAX_MESSAGE_SIZE),
+            compress_channels(0),
+            compression_threshold(LEGION_DEFAULT_COMPRESSION_THRESHOLD),
             gc_epoch_size(LEGION_DEFAULT_GC_EPOCH_SIZE),
             max_control_replication_contexts(
                         LEGION_DEFAULT_MAX_CONTROL_REPLICATION_CONTEXTS),
             max_local_fields(LEGION_DEFAULT_LOCAL_FIELDS),
             max_replay_parallelism(LEGION_DEFAULT_MAX_REPLAY_PARALLELISM),
+            point_task_batch(LEGION_DEFAULT_POINT_TASK_BATCH),
+            auto_trace_window(LEGION_DEFAULT_AUTO_TRACE_WINDOW),
+            auto_trace_min_length(LEGION_DEFAULT_AUTO_TRACE_MIN_LENGTH),
+            auto_trace_max_traces(LEGION_DEFAULT_AUTO_TRACE_MAX_TRACES),
             safe_control_replication(0),
             program_order_execution(false),
             dump_physical_traces(false),
@@ -2519,6 +2606,7 @@ namespace Legion {
             no_fence_elision(false),
             no_transitive_reduction(false),
             replay_on_cpus(false),
+            replay_stealing(false),
             verify_partitions(false),
             runtime_warnings(false),
             warnings_backtrace(false),
@@ -2532,7 +2620,10 @@ namespace Legion {
             unsafe_mapper(false),
             safe_mapper(false),
             safe_tracing(false),
+            auto_tracing(false),
             disable_independence_tests(false),
+            disable_projection_cache(false),
+            parallel_logical_analysis(false),
 #ifdef LEGION_SPY
             legion_spy_enabled(true),
 #else
@@ -2550,6 +2641,8 @@ namespace Legion {
             check_privileges(false),
 #endif
             dump_free_ranges(false),
+            message_stats(false),
+            flat_shard_collectives(false),
             num_profiling_nodes(0),
             serializer_type("binary"),
             prof_footprint_threshold(128 << 20),
@@ -2568,10 +2661,16 @@ namespace Legion {
         unsigned eager_alloc_percentage;
         std::map<Realm::Memory::Kind, unsigned> eager_alloc_percentage_overrides;
         unsigned max_message_size;
+        unsigned compress_channels; // mask of VirtualChannelKinds
+        unsigned compression_threshold;
         unsigned gc_epoch_size;
         unsigned max_control_replication_contexts;
         unsigned max_local_fields;
         unsigned max_replay_parallelism;
+        unsigned point_task_batch;
+        unsigned auto_trace_window;
+        unsigned auto_trace_min_length;
+        unsigned auto_trace_max_traces;
         unsigned safe_control_replication;
       public:
         bool program_order_execution;
@@ -2582,6 +2681,7 @@ namespace Legion {
         bool no_fence_elision;
         bool no_transitive_reduction;
         bool replay_on_cpus;
+        bool replay_stealing;
         bool verify_partitions;
         bool runtime_warnings;
         bool warnings_backtrace;
@@ -2595,11 +2695,15 @@ namespace Legion {
         bool unsafe_mapper;
         bool safe_mapper;
         bool safe_tracing;
+        bool auto_tracing;
         bool disable_independence_tests;
+        bool disable_projection_cache;
+        bool parallel_logical_analysis;
         bool legion_spy_enabled;
         bool enable_test_mapper;
         std::string replay_file;
         std::string ldb_file;
+        std::string spy_logfile;
         bool slow_config_ok;
 #ifdef DEBUG_LEGION
         bool logging_region_tree_state;
@@ -2609,6 +2713,8 @@ namespace Legion {
 #endif
         bool check_privileges;
         bool dump_free_ranges;
+        bool message_stats;
+        bool flat_shard_collectives;
       public:
         unsigned num_profiling_nodes;
         std::string serializer_type;
@@ -2697,10 +2803,16 @@ namespace Legion {
       const unsigned eager_alloc_percentage;
       const std::map<Realm::Memory::Kind, unsigned> eager_alloc_percentage_overrides;
       const unsigned max_message_size;
+      const unsigned compress_channels;
+      const unsigned compression_threshold;
       const unsigned gc_epoch_size;
       const unsigned max_control_replication_contexts;
       const unsigned max_local_fields;
       const unsigned max_replay_parallelism;
+      const unsigned point_task_batch;
+      const unsigned auto_trace_window;
+      const unsigned auto_trace_min_length;
+      const unsigned auto_trace_max_traces;
       const unsigned safe_control_replication;
     public:
       const bool program_order_execution;
@@ -2711,6 +2823,7 @@ namespace Legion {
       const bool no_fence_elision;
       const bool no_transitive_reduction;
       const bool replay_on_cpus;
+      const bool replay_stealing;
       const bool verify_partitions;
       const bool runtime_warnings;
       const bool warnings_backtrace;
@@ -2723,7 +2836,10 @@ namespace Legion {
       const bool unsafe_launch;
       const bool unsafe_mapper;
       const bool safe_tracing;
+      const bool auto_tracing;
       const bool disable_independence_tests;
+      const bool disable_projection_cache;
+      const bool parallel_logical_analysis;
       const bool legion_spy_enabled;
       const bool supply_default_mapper;
       const bool enable_test_mapper;
@@ -2737,8 +2853,12 @@ namespace Legion {
 #endif
       const bool check_privileges;
       const bool dump_free_ranges;
+      // Only non-NULL when running with -lg:message_stats
+      MessageStatistics *const message_stats;
     public:
       const int legion_collective_radix;
+      // Don't route shard all-gathers through a leader on each node
+      const bool flat_shard_collectives;
       MPIRankTable *const mpi_rank_table;
     public:
       void register_static_variants(void);
@@ -2988,6 +3108,7 @@ namespace Legion {
                                                    bool can_fail = false);
       static ProjectionFunctor* get_projection_functor(ProjectionID pid);
       void unregister_projection_functor(ProjectionID pid);
+      void invalidate_projection_caches(IndexTreeID tree);
     public:
       ShardingID generate_dynamic_sharding_id(bool check_context = true);
       ShardingID generate_library_sharding_ids(const char *name, size_t count);
@@ -21,10 +21,34 @@
 #include "realm/lists.h"
 #include "realm/mutex.h"
 
+#include <cstddef>
 #include <memory>
 
 namespace Realm {
 
+// Counts of the trips the caching allocators make to the system allocator.
+// Once a workload reaches steady state, BLOCK_ALLOCS and OVERSIZE_ALLOCS
+// should stop growing - everything else is recycled through thread-local
+// blocks.
+class CachingAllocatorStats {
+public:
+  enum Counter {
+    BLOCK_ALLOCS,    // new blocks from the system allocator
+    BLOCK_REUSES,    // emptied blocks taken back off a free block list
+    OVERSIZE_ALLOCS, // objects too large for any size class
+    NUM_COUNTERS
+  };
+
+  static void increment(Counter c) { counters()[c].fetch_add(1); }
+  static size_t get(Counter c) { return counters()[c].load(); }
+
+protected:
+  static atomic<size_t> *counters() {
+    static atomic<size_t> values[NUM_COUNTERS];
+    return values;
+  }
+};
+
 template <typename T, size_t N> class CachingAllocator {
 public:
   typedef T value_type;
@@ -143,11 +167,15 @@ private:
   static typename Block::BlockList free_blocks;
 
   // When a thread exits, we want to make sure it's current block is marked for
-  // reclaimation rather than deleted
+  // reclaimation rather than deleted.  A block marked for reclaimation counts
+  // down to -BLOCK_SIZE as its chunks are freed, so the count of a block with
+  // 'n' outstanding chunks becomes n - BLOCK_SIZE (the same state that a full
+  // block is put in by alloc_obj)
   static void release_block(Block *blk) {
     ssize_t old_num = blk->num_alloced_chunks.load();
     while (old_num > 0 &&
-           !blk->num_alloced_chunks.compare_exchange_weak(old_num, -old_num))
+           !blk->num_alloced_chunks.compare_exchange_weak(
+               old_num, old_num - ssize_t(BLOCK_SIZE)))
       ;
     // Delete the block if there aren't any outstanding references
     if (old_num == 0) {
@@ -171,7 +199,9 @@ public:
       Block *newblk = free_blocks.pop_front();
       if (newblk == nullptr) {
         newblk = new (std::nothrow) Block;
-      }
+        CachingAllocatorStats::increment(CachingAllocatorStats::BLOCK_ALLOCS);
+      } else
+        CachingAllocatorStats::increment(CachingAllocatorStats::BLOCK_REUSES);
       if (newblk != nullptr) {
         obj = newblk->alloc_obj();
         assert((obj != nullptr) && "Newly acquired block can't allocate!");
@@ -197,6 +227,62 @@ template <typename T, size_t N>
 typename CachingAllocator<T, N>::Block::BlockList
     CachingAllocator<T, N>::free_blocks;
 
+// Front end for class hierarchies whose objects differ in size (e.g. the
+// subclasses of EventWaiter or XferDes).  A class-specific operator new and
+// sized operator delete forward here, and each object is placed in the
+// smallest size class that fits it.  Objects bigger than the largest size
+// class come from the system allocator.  As long as the base class has a
+// virtual destructor, the size given to free_obj matches the one given to
+// alloc_obj.
+class SizeClassCachingAllocator {
+public:
+  enum { MAX_SIZE = 2048 };
+
+  static void *alloc_obj(size_t size) {
+    switch (size_class(size)) {
+    case 0: return Alloc<64>::alloc_obj();
+    case 1: return Alloc<128>::alloc_obj();
+    case 2: return Alloc<256>::alloc_obj();
+    case 3: return Alloc<512>::alloc_obj();
+    case 4: return Alloc<1024>::alloc_obj();
+    case 5: return Alloc<2048>::alloc_obj();
+    default:
+      CachingAllocatorStats::increment(CachingAllocatorStats::OVERSIZE_ALLOCS);
+      return ::operator new(size);
+    }
+  }
+
+  static void free_obj(void *p, size_t size) {
+    switch (size_class(size)) {
+    case 0: Alloc<64>::free_obj(p); break;
+    case 1: Alloc<128>::free_obj(p); break;
+    case 2: Alloc<256>::free_obj(p); break;
+    case 3: Alloc<512>::free_obj(p); break;
+    case 4: Alloc<1024>::free_obj(p); break;
+    case 5: Alloc<2048>::free_obj(p); break;
+    default: ::operator delete(p);
+    }
+  }
+
+protected:
+  template <size_t S> struct Storage {
+    alignas(std::max_align_t) char data[S];
+  };
+
+  // aim for blocks of about 64KB, but at least 16 objects each
+  template <size_t S>
+  using Alloc = CachingAllocator<Storage<S>, ((S < 4096) ? (65536 / S) : 16)>;
+
+  static int size_class(size_t size) {
+    if (size > MAX_SIZE)
+      return -1;
+    int c = 0;
+    while (size > (size_t(64) << c))
+      c++;
+    return c;
+  }
+};
+
 } // namespace Realm
 
 #endif // ifndef REALM_CACHING_ALLOCATOR_H
@@ -20,6 +20,7 @@
 #include "realm/logging.h"
 #include "realm/threads.h"
 #include "realm/profiling.h"
+#include "realm/caching_allocator.h"
 
 namespace Realm {
 
@@ -523,6 +524,30 @@ namespace Realm {
   }
 
 
+  ////////////////////////////////////////////////////////////////////////
+  //
+  // class EventWaiter
+  //
+
+  /*static*/ void *EventWaiter::operator new(size_t size)
+  {
+#if REALM_USE_CACHING_ALLOCATOR
+    return SizeClassCachingAllocator::alloc_obj(size);
+#else
+    return ::operator new(size);
+#endif
+  }
+
+  /*static*/ void EventWaiter::operator delete(void *ptr, size_t size)
+  {
+#if REALM_USE_CACHING_ALLOCATOR
+    SizeClassCachingAllocator::free_obj(ptr, size);
+#else
+    ::operator delete(ptr);
+#endif
+  }
+
+
   ////////////////////////////////////////////////////////////////////////
   //
   // class EventTriggerNotifier
@@ -685,11 +710,13 @@ namespace Realm {
 	    assert(0);
 	  } else if((gen + 1) == id.event_generation()) {
 	    // current generation
+	    impl->drain_current_waiters(gen + 1);
 	    waiters_head = impl->current_local_waiters.head.next;
 	  } else {
-	    std::map<EventImpl::gen_t, EventWaiter::EventWaiterList>::const_iterator it = impl->future_local_waiters.find(id.event_generation());
-	    if(it != impl->future_local_waiters.end())
-	      waiters_head = it->second.head.next;
+	    EventWaiter::EventWaiterList *l = impl->find_future_waiters(id.event_generation(),
+									false);
+	    if(l)
+	      waiters_head = l->head.next;
 	  }
 	}
       } else if(id.is_barrier()) {
@@ -968,6 +995,7 @@ namespace Realm {
     , gen_subscribed(0)
     , num_poisoned_generations(0)
     , merger(this)
+    , pending_current_waiters(uint64_t(1) << PENDING_TAG_SHIFT)
     , current_trigger_op(nullptr)
     , has_external_waiters(false)
     , external_waiter_condvar(external_waiter_mutex)
@@ -982,19 +1010,29 @@ namespace Realm {
   {
 #ifdef DEBUG_REALM
     AutoLock<> a(mutex);
+    drain_current_waiters(generation.load() + 1);
     if(!current_local_waiters.empty() ||
-       !future_local_waiters.empty() ||
+       has_future_waiters() ||
        has_external_waiters ||
        !remote_waiters.empty()) {
       log_event.fatal() << "Event " << me << " destroyed with"
 			<< (current_local_waiters.empty() ? "" : " current local waiters")
-			<< (future_local_waiters.empty() ? "" : " current future waiters")
+			<< (has_future_waiters() ? " current future waiters" : "")
 			<< (has_external_waiters ? " external waiters" : "")
 			<< (remote_waiters.empty() ? "" : " remote waiters");
       while(!current_local_waiters.empty()) {
 	EventWaiter *ew = current_local_waiters.pop_front();
 	log_event.fatal() << "  waiting on " << make_event(generation.load() + 1) << ": " << ew;
       }
+      for(gen_t g = generation.load() + 2;
+	  g <= generation.load() + 1 + FUTURE_WAITER_RING_SIZE;
+	  g++) {
+	EventWaiter::EventWaiterList& l = future_waiter_ring[g % FUTURE_WAITER_RING_SIZE];
+	while(!l.empty()) {
+	  EventWaiter *ew = l.pop_front();
+	  log_event.fatal() << "  waiting on " << make_event(g) << ": " << ew;
+	}
+      }
       for(std::map<gen_t, EventWaiter::EventWaiterList>::iterator it = future_local_waiters.begin();
 	  it != future_local_waiters.end();
 	  ++it) {
@@ -1019,6 +1057,7 @@ namespace Realm {
     num_poisoned_generations.store(0);
     poisoned_generations = 0;
     has_local_triggers = false;
+    pending_current_waiters.store(uint64_t(1) << PENDING_TAG_SHIFT);
   }
 
 
@@ -1221,6 +1260,13 @@ namespace Realm {
       // no early check here as the caller will generally have tried has_triggered()
       //  before allocating its EventWaiter object
 
+      // fast path: on the owner, a waiter for the current generation goes on
+      //  the lock-free stack that trigger() drains
+      if((owner == Network::my_node_id) &&
+	 (needed_gen == (generation.load_acquire() + 1)) &&
+	 push_current_waiter(needed_gen, waiter))
+	return true;
+
       bool trigger_now = false;
       bool trigger_poisoned = false;
 
@@ -1255,7 +1301,7 @@ namespace Realm {
 	    } else {
 	      // no, put it in an appropriate future waiter list - only allowed for non-owners
 	      assert(owner != Network::my_node_id);
-	      future_local_waiters[needed_gen].push_back(waiter);
+	      find_future_waiters(needed_gen, true)->push_back(waiter);
 	    }
 
 	    // do we need to subscribe to this event?
@@ -1300,16 +1346,131 @@ namespace Realm {
 
       // case 3: it'd better be in a waiter list
       if(needed_gen == (generation.load() + 1)) {
+	drain_current_waiters(needed_gen);
 	bool ok = current_local_waiters.erase(waiter) > 0;
 	assert(ok);
 	return true;
       } else {
-	bool ok = future_local_waiters[needed_gen].erase(waiter) > 0;
+	EventWaiter::EventWaiterList *l = find_future_waiters(needed_gen, false);
+	bool ok = l && (l->erase(waiter) > 0);
 	assert(ok);
 	return true;
       }
     }
 
+    bool GenEventImpl::has_future_waiters(void) const
+    {
+      for(int i = 0; i < FUTURE_WAITER_RING_SIZE; i++)
+	if(!future_waiter_ring[i].empty())
+	  return true;
+      return !future_local_waiters.empty();
+    }
+
+    EventWaiter::EventWaiterList *GenEventImpl::find_future_waiters(gen_t gen,
+								     bool create)
+    {
+      gen_t cur_gen = generation.load();
+      assert(gen > (cur_gen + 1));
+      // the next few generations map directly onto the ring
+      if(gen <= (cur_gen + 1 + FUTURE_WAITER_RING_SIZE))
+	return &future_waiter_ring[gen % FUTURE_WAITER_RING_SIZE];
+
+      if(create)
+	return &future_local_waiters[gen];
+      std::map<gen_t, EventWaiter::EventWaiterList>::iterator it = future_local_waiters.find(gen);
+      return ((it != future_local_waiters.end()) ? &(it->second) : 0);
+    }
+
+    void GenEventImpl::take_future_waiters(gen_t gen,
+					   EventWaiter::EventWaiterList& to_wake)
+    {
+      gen_t cur_gen = generation.load();
+      if(gen <= (cur_gen + 1 + FUTURE_WAITER_RING_SIZE)) {
+	to_wake.swap(future_waiter_ring[gen % FUTURE_WAITER_RING_SIZE]);
+      } else {
+	std::map<gen_t, EventWaiter::EventWaiterList>::iterator it = future_local_waiters.find(gen);
+	if(it != future_local_waiters.end()) {
+	  to_wake.swap(it->second);
+	  future_local_waiters.erase(it);
+	}
+      }
+    }
+
+    void GenEventImpl::advance_future_waiters(gen_t new_gen,
+					      std::map<gen_t, EventWaiter::EventWaiterList> *to_wake)
+    {
+      gen_t old_gen = generation.load();
+      assert(new_gen > old_gen);
+      assert(current_local_waiters.empty());
+      gen_t old_window_end = old_gen + 1 + FUTURE_WAITER_RING_SIZE;
+
+      // ring entries at or below the new generation have triggered, and the
+      //  one right after it becomes the current list - everything else in
+      //  the old window stays in its slot
+      for(gen_t g = old_gen + 2; (g <= old_window_end) && (g <= (new_gen + 1)); g++) {
+	EventWaiter::EventWaiterList& l = future_waiter_ring[g % FUTURE_WAITER_RING_SIZE];
+	if(l.empty()) continue;
+	if(g <= new_gen) {
+	  assert(to_wake != 0);
+	  (*to_wake)[g].swap(l);
+	} else
+	  current_local_waiters.swap(l);
+      }
+
+      // spilled generations that are now inside the window move into the
+      //  ring (whose slots were all emptied above)
+      while(!future_local_waiters.empty()) {
+	std::map<gen_t, EventWaiter::EventWaiterList>::iterator it = future_local_waiters.begin();
+	gen_t g = it->first;
+	if(g > (new_gen + 1 + FUTURE_WAITER_RING_SIZE))
+	  break;
+	if(g <= new_gen) {
+	  assert(to_wake != 0);
+	  (*to_wake)[g].swap(it->second);
+	} else if(g == (new_gen + 1))
+	  current_local_waiters.swap(it->second);
+	else
+	  future_waiter_ring[g % FUTURE_WAITER_RING_SIZE].swap(it->second);
+	future_local_waiters.erase(it);
+      }
+    }
+
+    bool GenEventImpl::push_current_waiter(gen_t needed_gen, EventWaiter *waiter)
+    {
+      const uint64_t ptr_mask = (uint64_t(1) << PENDING_TAG_SHIFT) - 1;
+      uint64_t wbits = reinterpret_cast<uintptr_t>(waiter);
+      if((wbits & ~ptr_mask) != 0)
+	return false;  // pointer doesn't fit - take the locked path
+      uint64_t tag = uint64_t(needed_gen) << PENDING_TAG_SHIFT;
+
+      uint64_t cur = pending_current_waiters.load_acquire();
+      do {
+	// a tag mismatch means the generation has moved on (or is about to)
+	if((cur & ~ptr_mask) != tag)
+	  return false;
+	waiter->ew_list_link.next = reinterpret_cast<EventWaiter *>(cur & ptr_mask);
+      } while(!pending_current_waiters.compare_exchange_weak(cur, tag | wbits));
+      return true;
+    }
+
+    void GenEventImpl::drain_current_waiters(gen_t next_gen)
+    {
+      const uint64_t ptr_mask = (uint64_t(1) << PENDING_TAG_SHIFT) - 1;
+      uint64_t old = pending_current_waiters.exchange(uint64_t(next_gen) << PENDING_TAG_SHIFT);
+      EventWaiter *ew = reinterpret_cast<EventWaiter *>(old & ptr_mask);
+      if(!ew) return;
+
+      // the stack is newest-first - reverse it to keep waiters in order
+      EventWaiter::EventWaiterList drained;
+      while(ew) {
+	EventWaiter *next = ew->ew_list_link.next;
+	ew->ew_list_link.next = 0;
+	drained.push_front(ew);
+	ew = next;
+      }
+      current_local_waiters.absorb_append(drained);
+    }
+
     inline bool GenEventImpl::is_generation_poisoned(gen_t gen) const
     {
       // common case: no poisoned generations
@@ -1484,21 +1645,9 @@ namespace Realm {
       if(!current_local_waiters.empty())
 	to_wake[generation.load() + 1].swap(current_local_waiters);
 
-      // now any future waiters up to and including the triggered gen
-      if(!future_local_waiters.empty()) {
-	std::map<gen_t, EventWaiter::EventWaiterList>::iterator it = future_local_waiters.begin();
-	while((it != future_local_waiters.end()) && (it->first <= current_gen)) {
-	  to_wake[it->first].swap(it->second);
-	  future_local_waiters.erase(it);
-	  it = future_local_waiters.begin();
-	}
-
-	// and see if there's a future list that's now current
-	if((it != future_local_waiters.end()) && (it->first == (current_gen + 1))) {
-	  current_local_waiters.swap(it->second);
-	  future_local_waiters.erase(it);
-	}
-      }
+      // now any future waiters up to and including the triggered gen, and
+      //  see if there's a future list that's now current
+      advance_future_waiters(current_gen, &to_wake);
 
       // next, clear out any local triggers that have been ack'd
       if(has_local_triggers) {
@@ -1766,8 +1915,9 @@ namespace Realm {
 	  // must always be the next generation
 	  assert(gen_triggered == (generation.load() + 1));
 
+	  drain_current_waiters(gen_triggered + 1);
 	  to_wake.swap(current_local_waiters);
-	  assert(future_local_waiters.empty()); // no future waiters here
+	  assert(!has_future_waiters()); // no future waiters here
 
 	  to_update.swap(remote_waiters);
 	  update_gen = gen_triggered;
@@ -1860,14 +2010,7 @@ namespace Realm {
 	    // yes, so we have complete information and can update the state directly
 	    to_wake.swap(current_local_waiters);
 	    // any future waiters?
-	    if(!future_local_waiters.empty()) {
-	      std::map<gen_t, EventWaiter::EventWaiterList>::iterator it = future_local_waiters.begin();
-	      log_event.debug() << "future waiters non-empty: first=" << it->first << " (= " << (gen_triggered + 1) << "?)";
-	      if(it->first == (gen_triggered + 1)) {
-		current_local_waiters.swap(it->second);
-		future_local_waiters.erase(it);
-	      }
-	    }
+	    advance_future_waiters(gen_triggered, 0);
 	    // if this event was poisoned, record it in the local triggers since we only
 	    //  update the official poison list on owner update messages
 	    if(poisoned) {
@@ -1890,11 +2033,7 @@ namespace Realm {
 	      //  future waiter list to see who we can wake, and update the local trigger
 	      //  list
 
-	      std::map<gen_t, EventWaiter::EventWaiterList>::iterator it = future_local_waiters.find(gen_triggered);
-	      if(it != future_local_waiters.end()) {
-		to_wake.swap(it->second);
-		future_local_waiters.erase(it);
-	      }
+	      take_future_waiters(gen_triggered, to_wake);
 
 	      local_triggers[gen_triggered] = poisoned;
 	      has_local_triggers = true;
@@ -57,6 +57,12 @@ namespace Realm {
     class EventWaiter {
     public:
       virtual ~EventWaiter(void) {}
+
+      // waiters are allocated and freed at a high rate on many threads, so
+      //  they come from thread-local caching allocator blocks
+      static void *operator new(size_t size);
+      static void operator delete(void *ptr, size_t size);
+
       virtual void event_triggered(bool poisoned, TimeLimit work_until) = 0;
       virtual void print(std::ostream& os) const = 0;
       virtual Event get_finish_event(void) const = 0;
@@ -260,12 +266,37 @@ namespace Realm {
       Operation *current_trigger_op;
 
       // local waiters are tracked by generation - an easily-accessed list is used
-      //  for the "current" generation, whereas a map-by-generation-id is used for
-      //  "future" generations (i.e. ones ahead of what we've heard about if we're
-      //  not the owner)
+      //  for the "current" generation, whereas "future" generations (i.e. ones
+      //  ahead of what we've heard about if we're not the owner) use a small
+      //  ring indexed by generation for the next few generations and a
+      //  map-by-generation-id for anything further out
+      static const int FUTURE_WAITER_RING_SIZE = 4;
       EventWaiter::EventWaiterList current_local_waiters;
+      EventWaiter::EventWaiterList future_waiter_ring[FUTURE_WAITER_RING_SIZE];
       std::map<gen_t, EventWaiter::EventWaiterList> future_local_waiters;
 
+      // helpers for future waiters - mutex must be held
+      bool has_future_waiters(void) const;
+      EventWaiter::EventWaiterList *find_future_waiters(gen_t gen, bool create);
+      void take_future_waiters(gen_t gen, EventWaiter::EventWaiterList& to_wake);
+      // moves future waiters for generations up to 'new_gen' into 'to_wake' and
+      //  makes 'new_gen'+1 the current generation's list - call before
+      //  'generation' itself is updated
+      void advance_future_waiters(gen_t new_gen,
+                                  std::map<gen_t, EventWaiter::EventWaiterList> *to_wake);
+
+      // on the owner node, waiters for the current generation can be added
+      //  without taking the mutex by pushing them onto this stack - the top
+      //  bits hold the low bits of the generation the stack belongs to and
+      //  the rest is the most recently pushed waiter (linked through
+      //  ew_list_link) - the mutex holder moves the stack onto
+      //  current_local_waiters and retags it when the generation advances
+      static const unsigned PENDING_TAG_SHIFT = 48;
+      atomic<uint64_t> pending_current_waiters;
+
+      bool push_current_waiter(gen_t needed_gen, EventWaiter *waiter);
+      void drain_current_waiters(gen_t next_gen); // mutex must be held
+
       // external waiters on this node are notifies via a condition variable
       bool has_external_waiters;
       // use kernel mutex for timedwait functionality
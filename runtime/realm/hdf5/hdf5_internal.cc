@@ -17,6 +17,7 @@
 
 #include "realm/hdf5/hdf5_access.h"
 #include "realm/logging.h"
+#include "realm/utils.h"
 
 namespace Realm {
 
@@ -49,6 +50,7 @@ namespace Realm {
     void HDF5Memory::get_bytes(ID::IDType inst_id, const DomainPoint& dp, int fid, void *dst, size_t size)
     {
       assert(0);
+      AutoLock<> al(library_mutex);
       HDFMetadata *metadata = hdf_metadata[inst_id];
       // use index to compute position in space
       assert(size == H5Tget_size(metadata->datatype_ids[fid]));
@@ -75,6 +77,7 @@ namespace Realm {
     void HDF5Memory::put_bytes(ID::IDType inst_id, const DomainPoint& dp, int fid, const void *src, size_t size)
     {
       assert(0);
+      AutoLock<> al(library_mutex);
       HDFMetadata *metadata = hdf_metadata[inst_id];
       // use index to compute position in space
       assert(size == H5Tget_size(hdf_metadata[inst_id]->datatype_ids[fid]));
@@ -218,10 +221,159 @@ namespace Realm {
       return d;
     }
 
+    ////////////////////////////////////////////////////////////////////////
+    //
+    // class HDF5Request
+
+    void HDF5Request::execute()
+    {
+      {
+        AutoLock<> al(library_mutex);
+
+        hid_t mem_space_id, file_space_id;
+        CHECK_HDF5( mem_space_id = H5Screate_simple(extent.size(),
+                                                    extent.data(), 0) );
+        CHECK_HDF5( file_space_id = H5Scopy(dataspace_id) );
+        CHECK_HDF5( H5Sselect_hyperslab(file_space_id, H5S_SELECT_SET,
+                                        offset.data(), 0,
+                                        extent.data(), 0) );
+
+        if(xd->kind == XFER_HDF5_READ)
+          CHECK_HDF5( H5Dread(dataset_id, datatype_id,
+                              mem_space_id, file_space_id,
+                              H5P_DEFAULT, mem_base) );
+        else
+          CHECK_HDF5( H5Dwrite(dataset_id, datatype_id,
+                               mem_space_id, file_space_id,
+                               H5P_DEFAULT, mem_base) );
+
+        CHECK_HDF5( H5Sclose(mem_space_id) );
+        CHECK_HDF5( H5Sclose(file_space_id) );
+      }
+
+      xd->notify_request_read_done(this);
+      xd->notify_request_write_done(this);
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////
+    //
+    // class HDF5IOWorker
+
+    HDF5IOWorker::HDF5IOWorker(void)
+      : condvar(mutex)
+      , shutdown_requested(false)
+      , core_rsrv(0)
+    {}
+
+    HDF5IOWorker::~HDF5IOWorker(void)
+    {
+      // shutdown should have already been called
+      assert(worker_threads.empty());
+    }
+
+    void HDF5IOWorker::start_threads(CoreReservationSet& crs, int num_threads)
+    {
+      core_rsrv = new CoreReservation("hdf5 io threads", crs,
+                                      CoreReservationParameters());
+
+      ThreadLaunchParameters tlp;
+      for(int i = 0; i < num_threads; i++) {
+        Thread *t = Thread::create_kernel_thread<HDF5IOWorker,
+                                                 &HDF5IOWorker::thread_main>(this,
+                                                                             tlp,
+                                                                             *core_rsrv,
+                                                                             0);
+        worker_threads.push_back(t);
+      }
+    }
+
+    void HDF5IOWorker::shutdown_threads(void)
+    {
+      {
+        AutoLock<> al(mutex);
+        shutdown_requested = true;
+        condvar.broadcast();
+      }
+
+      for(size_t i = 0; i < worker_threads.size(); i++) {
+        worker_threads[i]->join();
+        delete worker_threads[i];
+      }
+      worker_threads.clear();
+
+      delete core_rsrv;
+      core_rsrv = 0;
+    }
+
+    void HDF5IOWorker::enqueue_request(HDF5Request *req)
+    {
+      AutoLock<> al(mutex);
+      pending.push_back(req);
+      condvar.signal();
+    }
+
+    void HDF5IOWorker::thread_main(void)
+    {
+      while(true) {
+        HDF5Request *req;
+        {
+          AutoLock<> al(mutex);
+          while(pending.empty() && !shutdown_requested)
+            condvar.wait();
+          // requests are all done by the time we're asked to shut down
+          if(pending.empty())
+            break;
+          req = pending.front();
+          pending.pop_front();
+        }
+
+        req->execute();
+      }
+    }
+
+
     ////////////////////////////////////////////////////////////////////////
     //
     // class HDF5XferDes
 
+    // attempts to grow the hyperslab in 'cur' to also cover 'next' - this
+    //  is possible when 'next' continues 'cur' in the outermost dimension in
+    //  which either is non-trivial, so that the combined hyperslab is still
+    //  a single box whose (C-order) traversal visits 'cur' and then 'next'
+    // returns the dimension that was grown, or -1 if they can't be combined
+    static int append_hyperslab(AddressInfoHDF5& cur,
+                                const AddressInfoHDF5& next)
+    {
+      if((cur.filename != next.filename) || (cur.dsetname != next.dsetname))
+        return -1;
+
+      int grow_dim = -1;
+      int hdf5_dims = cur.offset.size();
+      for(int i = 0; i < hdf5_dims; i++) {
+        if(cur.offset[i] == next.offset[i]) {
+          if(cur.extent[i] != next.extent[i])
+            return -1;
+        } else {
+          // exactly one dimension may differ, and only by continuing 'cur'
+          if((grow_dim >= 0) ||
+             (next.offset[i] != (cur.offset[i] + cur.extent[i])))
+            return -1;
+          grow_dim = i;
+        }
+      }
+      if(grow_dim < 0)
+        return -1;
+
+      // all outer dimensions must be trivial
+      for(int i = 0; i < grow_dim; i++)
+        if(cur.extent[i] != 1)
+          return -1;
+
+      cur.extent[grow_dim] += next.extent[grow_dim];
+      return grow_dim;
+    }
+
       HDF5XferDes::HDF5XferDes(uintptr_t _dma_op, Channel *_channel,
 			       NodeID _launch_node, XferDesID _guid,
 			       const std::vector<XferDesPortInfo>& inputs_info,
@@ -231,7 +383,7 @@ namespace Realm {
 	: XferDes(_dma_op, _channel, _launch_node, _guid,
 		  inputs_info, outputs_info,
 		  _priority, _fill_data, _fill_size)
-	, req_in_use(false)
+	, free_req_mask((1U << NUM_REQUESTS) - 1)
       {
 	if((inputs_info.size() >= 1) &&
 	   (input_ports[0].mem->kind == MemoryImpl::MKIND_HDF)) {
@@ -243,30 +395,37 @@ namespace Realm {
 	  assert(0 && "neither source nor dest of HDFXferDes is hdf5!?");
 	}
 
-	hdf5_req.xd = this;
+	for(int i = 0; i < NUM_REQUESTS; i++)
+	  hdf5_reqs[i].xd = this;
       }
 
       bool HDF5XferDes::request_available()
       {
-	return !req_in_use;
+	return (free_req_mask.load() != 0);
       }
 
       Request* HDF5XferDes::dequeue_request()
       {
-	assert(!req_in_use);
-	req_in_use = true;
-	hdf5_req.is_read_done = false;
-	hdf5_req.is_write_done = false;
+	// only the thread generating requests takes them off the free mask,
+	//  so the bit we pick can't be stolen
+	unsigned mask = free_req_mask.load();
+	assert(mask != 0);
+	int idx = ctz(mask);
+	free_req_mask.fetch_and(~(1U << idx));
+	HDF5Request *req = &hdf5_reqs[idx];
+	req->is_read_done = false;
+	req->is_write_done = false;
 	// HDF5Request is handled by another thread, so must hold a reference
 	add_reference();
-        return &hdf5_req;
+        return req;
       }
 
       void HDF5XferDes::enqueue_request(Request* req)
       {
-	assert(req_in_use);
-	assert(req == &hdf5_req);
-	req_in_use = false;
+	int idx = static_cast<HDF5Request *>(req) - hdf5_reqs;
+	assert((idx >= 0) && (idx < NUM_REQUESTS));
+	assert((free_req_mask.load() & (1U << idx)) == 0);
+	free_req_mask.fetch_or(1U << idx);
         // update progress counter if iteration isn't completed yet - it might
         //  have been waiting for another request object
         if(!iteration_completed.load())
@@ -385,6 +544,50 @@ namespace Realm {
 	    }
 	  }
 
+	  // we'll open datasets on the first touch in this transfer
+	  HDF5Dataset *dset = find_dataset(hdf5_info);
+
+	  // coalesce following steps into the same request as long as they
+	  //  continue both the hyperslab and the memory range - once the
+	  //  hyperslab ends on a chunk boundary, stop unless there's room for
+	  //  another whole chunk
+	  while(hdf5_bytes < max_bytes) {
+	    if(hdf5_iter->done() || mem_iter->done())
+	      break;
+
+	    AddressInfoHDF5 next_info;
+	    size_t next_bytes = hdf5_iter->step_custom(max_bytes - hdf5_bytes,
+						       next_info,
+						       true /*tentative*/);
+	    if(next_bytes == 0)
+	      break;
+	    TransferIterator::AddressInfo next_mem_info;
+	    size_t next_mem_bytes = mem_iter->step(next_bytes, next_mem_info, 0,
+						   true /*tentative*/);
+	    int grow_dim = -1;
+	    if((next_mem_bytes == next_bytes) &&
+	       (next_mem_info.base_offset == (mem_info.base_offset + hdf5_bytes)))
+	      grow_dim = append_hyperslab(hdf5_info, next_info);
+	    if(grow_dim < 0) {
+	      hdf5_iter->cancel_step();
+	      if(next_mem_bytes > 0)
+		mem_iter->cancel_step();
+	      break;
+	    }
+	    hdf5_iter->confirm_step();
+	    mem_iter->confirm_step();
+	    hdf5_bytes += next_bytes;
+
+	    hsize_t chunk = dset->chunk_size[grow_dim];
+	    if(chunk > 0) {
+	      hsize_t end = hdf5_info.offset[grow_dim] + hdf5_info.extent[grow_dim];
+	      size_t slice_bytes = hdf5_bytes / hdf5_info.extent[grow_dim];
+	      if(((end % chunk) == 0) &&
+		 ((max_bytes - hdf5_bytes) < (slice_bytes * chunk)))
+		break;
+	    }
+	  }
+
 	  HDF5Request* new_req = (HDF5Request *)(dequeue_request());
 	  new_req->src_port_idx = in_port_idx;
 	  new_req->dst_port_idx = out_port_idx;
@@ -392,34 +595,12 @@ namespace Realm {
 	  new_req->mem_base = ((kind == XFER_HDF5_READ) ?
 			         out_port->mem :
 			         in_port->mem)->get_direct_ptr(mem_info.base_offset,
-							       mem_info.bytes_per_chunk);
-	  // we'll open datasets on the first touch in this transfer
-	  // (TODO: pre-open at instance attach time, but in thread-safe way)
-	  HDF5Dataset *dset;
-	  {
-            DatasetMapKey key = { hdf5_info.filename, hdf5_info.dsetname };
-            DatasetMap::const_iterator it = datasets.find(key);
-	    if(it != datasets.end()) {
-	      dset = it->second;
-	    } else {
-	      dset = HDF5Dataset::open(hdf5_info.filename->c_str(),
-				       hdf5_info.dsetname->c_str(),
-				       (kind == XFER_HDF5_READ));
-	      assert(dset != 0);
-	      assert(hdf5_info.extent.size() == size_t(dset->ndims));
-	      datasets[key] = dset;
-	    }
-	  }
-
+							       hdf5_bytes);
 	  new_req->dataset_id = dset->dset_id;
 	  new_req->datatype_id = dset->dtype_id;
-
-	  std::vector<hsize_t> mem_dims = hdf5_info.extent;
-	  CHECK_HDF5( new_req->mem_space_id = H5Screate_simple(mem_dims.size(), mem_dims.data(), NULL) );
-	  //std::vector<hsize_t> mem_start(DIM, 0);
-	  //CHECK_HDF5( H5Sselect_hyperslab(new_req->mem_space_id, H5S_SELECT_SET, ms_start, NULL, count, NULL) );
-          CHECK_HDF5( new_req->file_space_id = H5Scopy(dset->dspace_id) );
-	  CHECK_HDF5( H5Sselect_hyperslab(new_req->file_space_id, H5S_SELECT_SET, hdf5_info.offset.data(), 0, hdf5_info.extent.data(), 0) );
+	  new_req->dataspace_id = dset->dspace_id;
+	  new_req->offset.swap(hdf5_info.offset);
+	  new_req->extent.swap(hdf5_info.extent);
 
 	  new_req->nbytes = hdf5_bytes;
 
@@ -494,22 +675,11 @@ namespace Realm {
               replicate_fill_data(hdf5_bytes);
 
             // we'll open datasets on the first touch in this transfer
-            // (TODO: pre-open at instance attach time, but in thread-safe way)
-            HDF5Dataset *dset;
-            {
-              DatasetMapKey key = { hdf5_info.filename, hdf5_info.dsetname };
-              DatasetMap::const_iterator it = datasets.find(key);
-              if(it != datasets.end()) {
-                dset = it->second;
-              } else {
-                dset = HDF5Dataset::open(hdf5_info.filename->c_str(),
-                                         hdf5_info.dsetname->c_str(),
-                                         (kind == XFER_HDF5_READ));
-                assert(dset != 0);
-                assert(hdf5_info.extent.size() == size_t(dset->ndims));
-                datasets[key] = dset;
-              }
-            }
+            HDF5Dataset *dset = find_dataset(hdf5_info);
+
+            // fills are small enough to just do here, but they still have
+            //  to be serialized with the I/O threads
+            AutoLock<> al(library_mutex);
 
             std::vector<hsize_t> mem_dims = hdf5_info.extent;
             hid_t mem_space_id, file_space_id;
@@ -527,6 +697,7 @@ namespace Realm {
 
             CHECK_HDF5( H5Sclose(mem_space_id) );
             CHECK_HDF5( H5Sclose(file_space_id) );
+            al.release();
 
             update_bytes_write(output_control.current_io_port,
                                out_port->local_bytes_total, hdf5_bytes);
@@ -563,15 +734,29 @@ namespace Realm {
 
       void HDF5XferDes::notify_request_write_done(Request* req)
       {
-        HDF5Request* hdf_req = (HDF5Request*) req;
-        //pthread_rwlock_wrlock(&hdf_metadata->hdf_memory->rwlock);
-        CHECK_HDF5( H5Sclose(hdf_req->mem_space_id) );
-        CHECK_HDF5( H5Sclose(hdf_req->file_space_id) );
-        //pthread_rwlock_unlock(&hdf_metadata->hdf_memory->rwlock);
-
 	default_notify_request_write_done(req);
       }
 
+      HDF5Dataset *HDF5XferDes::find_dataset(const AddressInfoHDF5& info)
+      {
+        DatasetMapKey key(info.filename, info.dsetname);
+        DatasetMap::const_iterator it = datasets.find(key);
+        if(it != datasets.end())
+          return it->second;
+
+        HDF5Dataset *dset;
+        {
+          AutoLock<> al(library_mutex);
+          dset = HDF5Dataset::open(info.filename->c_str(),
+                                   info.dsetname->c_str(),
+                                   (kind == XFER_HDF5_READ));
+        }
+        assert(dset != 0);
+        assert(info.extent.size() == size_t(dset->ndims));
+        datasets[key] = dset;
+        return dset;
+      }
+
       void HDF5XferDes::flush()
       {
         if (kind == XFER_HDF5_READ) {
@@ -586,6 +771,7 @@ namespace Realm {
           // }
         }
 
+	AutoLock<> al(library_mutex);
 	for(DatasetMap::const_iterator it = datasets.begin();
 	    it != datasets.end();
 	    ++it)
@@ -598,10 +784,12 @@ namespace Realm {
     //
     // class HDF5Channel
 
-      HDF5Channel::HDF5Channel(BackgroundWorkManager *bgwork)
+      HDF5Channel::HDF5Channel(BackgroundWorkManager *bgwork,
+			       HDF5IOWorker *_io_worker)
 	: SingleXDQChannel<HDF5Channel, HDF5XferDes>(bgwork,
 						     XFER_NONE /*FIXME*/,
 						     "hdf5 channel")
+	, io_worker(_io_worker)
       {
         unsigned bw = 10; // HACK - estimate 10 MB/s
         unsigned latency = 10000; // HACK - estimate 10 us
@@ -653,18 +841,10 @@ namespace Realm {
 	  // no serdez support
 	  assert(req->xd->input_ports[req->src_port_idx].serdez_op == 0);
 	  assert(req->xd->output_ports[req->dst_port_idx].serdez_op == 0);
-          //pthread_rwlock_rdlock(req->rwlock);
-          if (req->xd->kind == XFER_HDF5_READ)
-            CHECK_HDF5( H5Dread(req->dataset_id, req->datatype_id,
-				req->mem_space_id, req->file_space_id,
-				H5P_DEFAULT, req->mem_base) );
-	  else
-            CHECK_HDF5( H5Dwrite(req->dataset_id, req->datatype_id,
-				 req->mem_space_id, req->file_space_id,
-				 H5P_DEFAULT, req->mem_base) );
-          //pthread_rwlock_unlock(req->rwlock);
-          req->xd->notify_request_read_done(req);
-          req->xd->notify_request_write_done(req);
+          if(io_worker)
+            io_worker->enqueue_request(req);
+          else
+            req->execute();
         }
         return nr;
       }
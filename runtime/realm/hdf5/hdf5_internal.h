@@ -20,8 +20,11 @@
 
 #include "realm/transfer/lowlevel_dma.h"
 #include "realm/transfer/channel.h"
+#include "realm/mutex.h"
+#include "realm/threads.h"
 
 #include <hdf5.h>
+#include <deque>
 
 #define CHECK_HDF5(cmd) \
   do { \
@@ -37,6 +40,16 @@ namespace Realm {
 
   namespace HDF5 {
 
+    // the HDF5 library is not (in general) thread-safe, so all calls into
+    //  it are made while holding this lock
+    extern Mutex library_mutex;
+
+    // datasets are opened through a process-wide cache - open() returns a
+    //  shared handle and close() releases it, but the file and dataset
+    //  handles stay open (up to -hdf5:openfiles unused files, in LRU order)
+    //  so that later transfers don't pay to reopen them - -hdf5:openfiles
+    //  defaults to 0, so this reuse is opt-in
+    // both must be called while holding the library_mutex
     class HDF5Dataset {
     public:
       static HDF5Dataset *open(const char *filename,
@@ -45,6 +58,9 @@ namespace Realm {
       void flush();
       void close();
 
+      // closes the handles of an unused dataset - only for use by the cache
+      void destroy();
+
     protected:
       HDF5Dataset();
       ~HDF5Dataset();
@@ -55,6 +71,9 @@ namespace Realm {
       static const int MAX_DIM = 16;
       hsize_t dset_size[MAX_DIM];
       bool read_only;
+      // chunk sizes for chunked datasets (all zero otherwise)
+      hsize_t chunk_size[MAX_DIM];
+      int usage_count;
     };
 
     class HDF5Memory : public MemoryImpl {
@@ -90,11 +109,38 @@ namespace Realm {
     class HDF5Request : public Request {
     public:
       void *mem_base; // could be source or dest
-      hid_t dataset_id, datatype_id;
-      hid_t mem_space_id, file_space_id;
+      hid_t dataset_id, datatype_id, dataspace_id;
+      // hyperslab in the dataset - the memory side is contiguous
+      std::vector<hsize_t> offset, extent;
+
+      // performs the read or write and notifies the xd
+      void execute();
     };
     class HDF5Channel;
 
+    // HDF5 reads and writes block the calling thread, so they are performed
+    //  by dedicated threads instead of background workers
+    class HDF5IOWorker {
+    public:
+      HDF5IOWorker(void);
+      ~HDF5IOWorker(void);
+
+      void start_threads(CoreReservationSet& crs, int num_threads);
+      void shutdown_threads(void);
+
+      void enqueue_request(HDF5Request *req);
+
+      void thread_main(void);
+
+    protected:
+      Mutex mutex;
+      Mutex::CondVar condvar;
+      std::deque<HDF5Request *> pending;
+      bool shutdown_requested;
+      CoreReservation *core_rsrv;
+      std::vector<Thread *> worker_threads;
+    };
+
     class AddressInfoHDF5 : public TransferIterator::AddressInfoCustom {
     public:
       virtual int set_rect(const RegionInstanceImpl *inst,
@@ -135,9 +181,15 @@ namespace Realm {
 
       bool progress_xd(HDF5Channel *channel, TimeLimit work_until);
 
+    protected:
+      HDF5Dataset *find_dataset(const AddressInfoHDF5& info);
+
     private:
-      bool req_in_use;
-      HDF5Request hdf5_req;
+      // a few requests can be in flight on the I/O threads at once - bits
+      //  in the mask are set for requests that are available
+      static const int NUM_REQUESTS = 4;
+      atomic<unsigned> free_req_mask;
+      HDF5Request hdf5_reqs[NUM_REQUESTS];
       typedef std::pair<const std::string *, const std::string *> DatasetMapKey;
       typedef std::map<DatasetMapKey, HDF5Dataset *> DatasetMap;
       DatasetMap datasets;
@@ -147,7 +199,8 @@ namespace Realm {
     // single channel handles both HDF5 reads and writes
     class HDF5Channel : public SingleXDQChannel<HDF5Channel, HDF5XferDes> {
     public:
-      HDF5Channel(BackgroundWorkManager *bgwork);
+      // if 'io_worker' is null, requests are performed by the submitter
+      HDF5Channel(BackgroundWorkManager *bgwork, HDF5IOWorker *_io_worker);
       ~HDF5Channel();
 
       // handle HDF5 requests in order - no concurrency
@@ -164,6 +217,9 @@ namespace Realm {
                                        size_t fill_total);
 
       long submit(Request** requests, long nr);
+
+    protected:
+      HDF5IOWorker *io_worker;
     };
 
   }; // namespace HDF5
@@ -26,6 +26,7 @@
 #include "realm/inst_impl.h"
 
 #include <map>
+#include <list>
 
 namespace Realm {
 
@@ -37,19 +38,71 @@ namespace Realm {
     static HDF5Module *hdf5mod = 0;
 
     namespace Config {
+      // unused files kept open for reuse (-hdf5:openfiles) - the default of
+      //  0 closes a file as soon as its last dataset is closed, so handle
+      //  caching is opt-in
       size_t max_open_files = 0;
       bool force_read_write = false;
+      // threads that run HDF5 requests (-hdf5:iothreads) - every HDF5 call
+      //  holds library_mutex, so only one of them is ever in the library and
+      //  more than one thread adds no I/O parallelism
+      int io_threads = 1;
     };
-    
+
+    Mutex library_mutex;
+
+    // datasets are indexed by name and read-only-ness
+    typedef std::map<std::pair<std::string, bool>, HDF5Dataset *> HDF5DatasetCache;
+
     struct HDF5OpenFile {
       hid_t file_id;
       int usage_count;
+      // datasets stay open as long as the file does
+      HDF5DatasetCache datasets;
     };
 
     // files are indexed by filename and writeable-ness
     typedef std::map<std::pair<std::string, bool>, HDF5OpenFile> HDF5FileCache;
     HDF5FileCache file_cache;
 
+    // files with a zero usage count, least recently used at the front - at
+    //  most Config::max_open_files of these are kept open
+    std::list<HDF5FileCache::iterator> unused_files;
+
+    static void close_file(HDF5FileCache::iterator it)
+    {
+      for(HDF5DatasetCache::iterator it2 = it->second.datasets.begin();
+          it2 != it->second.datasets.end();
+          ++it2) {
+        if(it2->second->usage_count > 0)
+          log_hdf5.warning() << "nonzero usage count on dataset \"" << it2->first.first << "\" in file \"" << it->first.first << "\": " << it2->second->usage_count;
+        it2->second->destroy();
+      }
+      it->second.datasets.clear();
+
+      if(it->second.usage_count > 0)
+        log_hdf5.warning() << "nonzero usage count on file \"" << it->first.first << "\": " << it->second.usage_count;
+      log_hdf5.info() << "H5Fclose(" << it->second.file_id << ")";
+      CHECK_HDF5( H5Fclose(it->second.file_id) );
+      file_cache.erase(it);
+    }
+
+    // called when a file's usage count drops to zero - returns true if the
+    //  file itself was closed
+    static bool file_unused(HDF5FileCache::iterator it)
+    {
+      unused_files.push_back(it);
+      bool closed = false;
+      while(unused_files.size() > Config::max_open_files) {
+        HDF5FileCache::iterator victim = unused_files.front();
+        unused_files.pop_front();
+        if(victim == it)
+          closed = true;
+        close_file(victim);
+      }
+      return closed;
+    }
+
     
     ////////////////////////////////////////////////////////////////////////
     //
@@ -76,6 +129,14 @@ namespace Realm {
       std::pair<std::string, bool> key(filename, open_as_rw);
       HDF5FileCache::iterator it = file_cache.find(key);
       if(it == file_cache.end()) {
+        // HDF5 won't open a file in a second mode, so an unused copy held
+        //  open in the other mode has to be closed first
+        HDF5FileCache::iterator other = file_cache.find(std::make_pair(key.first, !open_as_rw));
+        if((other != file_cache.end()) && (other->second.usage_count == 0)) {
+          unused_files.remove(other);
+          close_file(other);
+        }
+
 	struct HDF5OpenFile f;
 	CHECK_HDF5( f.file_id = H5Fopen(filename,
 					(open_as_rw ? H5F_ACC_RDWR :
@@ -88,6 +149,21 @@ namespace Realm {
 	if(f.file_id < 0) return 0;
 	f.usage_count = 0;
 	it = file_cache.insert(std::make_pair(key, f)).first;
+      } else {
+        // take a previously-unused file off the LRU list
+        if(it->second.usage_count == 0)
+          unused_files.remove(it);
+      }
+
+      // reuse an already-open dataset if possible
+      std::pair<std::string, bool> dset_key(dsetname, read_only);
+      {
+        HDF5DatasetCache::iterator it2 = it->second.datasets.find(dset_key);
+        if(it2 != it->second.datasets.end()) {
+          it2->second->usage_count++;
+          it->second.usage_count++;
+          return it2->second;
+        }
       }
 
       // open dataset within file, following group path if any /'s are present
@@ -108,8 +184,11 @@ namespace Realm {
 	log_hdf5.info() << "H5Gopen2(" << loc_id << ", \"" << grpname << "\") = " << grp_id;
 	if(loc_id != it->second.file_id)
 	  CHECK_HDF5( H5Gclose(loc_id) );
-	if(grp_id < 0)
+	if(grp_id < 0) {
+	  if(it->second.usage_count == 0)
+	    file_unused(it);
 	  return 0;
+	}
 	loc_id = grp_id;
 	curpos = pos + 1;
       }
@@ -118,8 +197,11 @@ namespace Realm {
       log_hdf5.info() << "H5Dopen2(" << it->second.file_id << ", \"" << dsetname << "\") = " << dset_id;
       if(loc_id != it->second.file_id)
 	CHECK_HDF5( H5Gclose(loc_id) );
-      if(dset_id < 0)
+      if(dset_id < 0) {
+	if(it->second.usage_count == 0)
+	  file_unused(it);
 	return 0;
+      }
 
       // get and cache the datatype
       hid_t dtype_id;
@@ -135,6 +217,8 @@ namespace Realm {
 	CHECK_HDF5( H5Sclose(dspace_id) );
 	CHECK_HDF5( H5Tclose(dtype_id) );
 	CHECK_HDF5( H5Dclose(dset_id) );
+	if(it->second.usage_count == 0)
+	  file_unused(it);
 	return 0;
       }
 
@@ -148,6 +232,20 @@ namespace Realm {
       // since HDF5 supports growable datasets, we care about the maxdims
       CHECK_HDF5( H5Sget_simple_extent_dims(dspace_id, 0, dset->dset_size) );
 
+      // remember the chunking (if any) so that transfers can be chunk-aligned
+      for(int i = 0; i < MAX_DIM; i++)
+        dset->chunk_size[i] = 0;
+      {
+        hid_t dcpl_id;
+        CHECK_HDF5( dcpl_id = H5Dget_create_plist(dset_id) );
+        if(H5Pget_layout(dcpl_id) == H5D_CHUNKED)
+          CHECK_HDF5( H5Pget_chunk(dcpl_id, ndims, dset->chunk_size) );
+        CHECK_HDF5( H5Pclose(dcpl_id) );
+      }
+
+      dset->usage_count = 1;
+      it->second.datasets[dset_key] = dset;
+
       // increment the usage count on the file
       it->second.usage_count++;
       return dset;
@@ -165,23 +263,29 @@ namespace Realm {
       while((it != file_cache.end()) && (it->second.file_id != file_id)) ++it;
       assert(it != file_cache.end());
 
+      // the dataset handle stays open in the cache until the file is closed
+      assert(usage_count > 0);
+      usage_count--;
+
+      // decrement usage count of file and consider closing it
+      assert(it->second.usage_count > 0);
+      it->second.usage_count--;
+      bool closed = false;
+      if(it->second.usage_count == 0)
+        closed = file_unused(it);
+
+      // if we're not going to close it, but we did writes, a flush is good
+      if(!closed && !read_only)
+	CHECK_HDF5( H5Fflush(file_id, H5F_SCOPE_GLOBAL) );
+    }
+
+    void HDF5Dataset::destroy()
+    {
       log_hdf5.info() << "H5Dclose(" << dset_id << ")";
       CHECK_HDF5( H5Sclose(dspace_id) );
       CHECK_HDF5( H5Tclose(dtype_id) );
       CHECK_HDF5( H5Dclose(dset_id) );
 
-      // decrement usage count of file and consider closing it
-      it->second.usage_count--;
-      if((it->second.usage_count == 0) &&
-	 (file_cache.size() > Config::max_open_files)) {
-	log_hdf5.info() << "H5Fclose(" << it->second.file_id << ")";
-	CHECK_HDF5( H5Fclose(it->second.file_id) );
-	file_cache.erase(it);
-      } else {
-	// if we're not going to close it, but we did writes, a flush is good
-	CHECK_HDF5( H5Fflush(it->second.file_id, H5F_SCOPE_GLOBAL) );
-      }
-
       // done with this object now
       delete this;
     }
@@ -203,7 +307,8 @@ namespace Realm {
 
       cp.add_option_bool("-hdf5:showerrors", cfg_showerrors)
         .add_option_int("-hdf5:openfiles", Config::max_open_files)
-        .add_option_bool("-hdf5:forcerw", Config::force_read_write);
+        .add_option_bool("-hdf5:forcerw", Config::force_read_write)
+        .add_option_int("-hdf5:iothreads", Config::io_threads);
 
       bool ok = cp.parse_command_line(cmdline);
       if(!ok) {
@@ -225,6 +330,7 @@ namespace Realm {
       , version_rel(0)
       , threadsafe(false)
       , hdf5mem(0)
+      , io_worker(0)
     {
     }
       
@@ -294,6 +400,17 @@ namespace Realm {
     void HDF5Module::initialize(RuntimeImpl *runtime)
     {
       Module::initialize(runtime);
+
+      // with no I/O threads, reads and writes are done by background workers
+      //  (the threads have to be created before core reservations are satisfied)
+      if(Config::io_threads > 0) {
+        if(Config::io_threads > 1)
+          log_hdf5.warning() << "-hdf5:iothreads " << Config::io_threads
+                             << ": HDF5 calls are serialized, so only one I/O thread will be in the library at a time";
+        io_worker = new HDF5IOWorker;
+        io_worker->start_threads(runtime->core_reservation_set(),
+                                 Config::io_threads);
+      }
     }
 
     // create any memories provided by this module (default == do nothing)
@@ -320,7 +437,7 @@ namespace Realm {
     {
       Module::create_dma_channels(runtime);
 
-      runtime->add_dma_channel(new HDF5Channel(&runtime->bgwork));
+      runtime->add_dma_channel(new HDF5Channel(&runtime->bgwork, io_worker));
     }
 
     // create any code translators provided by the module (default == do nothing)
@@ -335,17 +452,17 @@ namespace Realm {
     {
       Module::cleanup();
 
-      // close any files left open in the cache
-      for(HDF5FileCache::iterator it = file_cache.begin();
-	  it != file_cache.end();
-	  ++it) {
-	if(it->second.usage_count > 0)
-	  log_hdf5.warning() << "nonzero usage count on file \"" << it->first.first << "\": " << it->second.usage_count;
-	log_hdf5.info() << "H5Fclose(" << it->second.file_id << ")";
-	CHECK_HDF5( H5Fclose(it->second.file_id) );
+      if(io_worker) {
+        io_worker->shutdown_threads();
+        delete io_worker;
+        io_worker = 0;
       }
-      file_cache.clear();
-	
+
+      // close any files left open in the cache
+      unused_files.clear();
+      while(!file_cache.empty())
+        close_file(file_cache.begin());
+
       herr_t err = H5close();
       if(err < 0)
 	log_hdf5.warning() << "unable to close HDF5 library - result = " << err;
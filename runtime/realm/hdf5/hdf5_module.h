@@ -23,6 +23,7 @@ namespace Realm {
   namespace HDF5 {
 
     class HDF5Memory;
+    class HDF5IOWorker;
 
     class HDF5ModuleConfig : public ModuleConfig {
       friend class HDF5Module;
@@ -78,6 +79,7 @@ namespace Realm {
       bool threadsafe;
 
       HDF5Memory *hdf5mem;
+      HDF5IOWorker *io_worker;
     };
 
   }; // namespace HDF5
@@ -188,6 +188,14 @@ namespace Realm {
     return n;
   }
 
+  // chains of at least this many split planes along the same dimension
+  //  (with no pieces tested in between) become a single multi-way split
+  static const size_t MIN_SPLITN_PLANES = 3;
+
+  // piece lists with at least this many pieces are checked for a regular
+  //  tiling that can use a direct-indexed grid lookup
+  static const size_t MIN_GRID_PIECES = 8;
+
   template <typename T>
   struct PieceSplitNode {
     std::vector<int> presplit_pieces;
@@ -322,6 +330,48 @@ namespace Realm {
       }
     }
 
+    // gathers the split planes and the subtrees for each interval of the
+    //  chain of same-dimension splits rooted at this node
+    void collect_intervals(std::vector<T>& planes,
+			   std::vector<PieceSplitNode<T> *>& intervals)
+    {
+      add_interval(low_child, planes, intervals);
+      planes.push_back(split_plane);
+      add_interval(high_child, planes, intervals);
+    }
+
+    void add_interval(PieceSplitNode<T> *child, std::vector<T>& planes,
+		      std::vector<PieceSplitNode<T> *>& intervals)
+    {
+      if(child->presplit_pieces.empty() &&
+	 (child->total_splits > 0) &&
+	 (child->split_dim == split_dim))
+	child->collect_intervals(planes, intervals);
+      else
+	intervals.push_back(child);
+    }
+
+    // bytes needed for the split instructions (not the pieces) of this tree
+    template <int N>
+    size_t split_bytes()
+    {
+      if(total_splits == 0)
+	return 0;
+
+      std::vector<T> planes;
+      std::vector<PieceSplitNode<T> *> intervals;
+      collect_intervals(planes, intervals);
+      if(planes.size() >= MIN_SPLITN_PLANES) {
+	size_t bytes = roundup(PieceLookup::SplitMulti<N,T>::bytes_needed(planes.size()), 16);
+	for(size_t i = 0; i < intervals.size(); i++)
+	  bytes += intervals[i]->template split_bytes<N>();
+	return bytes;
+      } else
+	return (roundup(sizeof(PieceLookup::SplitPlane<N,T>), 16) +
+		low_child->template split_bytes<N>() +
+		high_child->template split_bytes<N>());
+    }
+
     template <int N>
     char *generate_instructions(const std::vector<InstanceLayoutPiece<N,T> *>& pieces, char *next_inst, unsigned& usage_mask)
     {
@@ -340,7 +390,32 @@ namespace Realm {
 	next_inst += roundup(bytes, 16);
       }
 
-      if(total_splits > 0) {
+      std::vector<T> planes;
+      std::vector<PieceSplitNode<T> *> intervals;
+      if(total_splits > 0)
+	collect_intervals(planes, intervals);
+
+      if(planes.size() >= MIN_SPLITN_PLANES) {
+	assert(planes.size() <= 0xffff);
+	usage_mask |= PieceLookup::ALLOW_SPLITN;
+	size_t size = roundup(PieceLookup::SplitMulti<N,T>::bytes_needed(planes.size()), 16);
+	char *cur_inst = next_inst;
+	PieceLookup::SplitMulti<N,T> *sm =
+	  new(next_inst) PieceLookup::SplitMulti<N,T>(split_dim,
+						      planes.size());
+	next_inst += size;
+	for(size_t i = 0; i < planes.size(); i++)
+	  sm->planes()[i] = planes[i];
+
+	// each interval's subtree follows the one before it
+	for(size_t i = 0; i < intervals.size(); i++) {
+	  size_t delta_bytes = next_inst - cur_inst;
+	  assert((delta_bytes & 15) == 0);
+	  sm->deltas()[i] = delta_bytes >> 4;
+	  next_inst = intervals[i]->generate_instructions(pieces, next_inst,
+							  usage_mask);
+	}
+      } else if(total_splits > 0) {
 	usage_mask |= PieceLookup::ALLOW_SPLIT1;
 	size_t size = roundup(sizeof(PieceLookup::SplitPlane<N,T>), 16);
 	char *cur_inst = next_inst;
@@ -367,6 +442,111 @@ namespace Realm {
 
   };
 
+  // a piece list whose pieces exactly tile a grid with uniform cell sizes
+  //  (cells at the upper edge of each dimension may be smaller)
+  template <int N, typename T>
+  struct PieceGrid {
+    Point<N,T> origin, tile_size;
+    Point<N,unsigned> counts;
+    std::vector<int> cell_pieces;
+
+    bool compute(const std::vector<InstanceLayoutPiece<N,T> *>& pieces)
+    {
+      if(pieces.size() < MIN_GRID_PIECES)
+	return false;
+
+      // grid lines in each dimension are the distinct lower bounds of the
+      //  pieces, and must be evenly spaced
+      Point<N,T> top;
+      size_t num_cells = 1;
+      for(int d = 0; d < N; d++) {
+	std::vector<T> starts;
+	starts.reserve(pieces.size());
+	top[d] = pieces[0]->bounds.hi[d];
+	for(size_t i = 0; i < pieces.size(); i++) {
+	  starts.push_back(pieces[i]->bounds.lo[d]);
+	  top[d] = std::max(top[d], pieces[i]->bounds.hi[d]);
+	}
+	std::sort(starts.begin(), starts.end());
+	starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+
+	origin[d] = starts[0];
+	counts[d] = starts.size();
+	if(starts.size() > 1) {
+	  tile_size[d] = starts[1] - starts[0];
+	  for(size_t i = 2; i < starts.size(); i++)
+	    if((starts[i] - starts[i - 1]) != tile_size[d])
+	      return false;
+	  // the last cell can't be bigger than the others
+	  if((top[d] - starts.back()) >= tile_size[d])
+	    return false;
+	} else
+	  tile_size[d] = top[d] - origin[d] + 1;
+
+	num_cells *= starts.size();
+	if(num_cells > pieces.size())
+	  return false;
+      }
+      if(num_cells != pieces.size())
+	return false;
+
+      // every piece must be exactly one cell, and no cell can be used twice
+      cell_pieces.assign(num_cells, -1);
+      for(size_t i = 0; i < pieces.size(); i++) {
+	const Rect<N,T>& b = pieces[i]->bounds;
+	size_t idx = 0;
+	for(int d = N - 1; d >= 0; d--) {
+	  size_t c = size_t(b.lo[d] - origin[d]) / size_t(tile_size[d]);
+	  T exp_hi = ((c == (counts[d] - 1)) ?
+		        top[d] :
+		        (b.lo[d] + tile_size[d] - 1));
+	  if(b.hi[d] != exp_hi)
+	    return false;
+	  idx = (idx * counts[d]) + c;
+	}
+	if(cell_pieces[idx] != -1)
+	  return false;
+	cell_pieces[idx] = i;
+      }
+
+      return true;
+    }
+
+    // bytes needed for the grid instruction (not the pieces)
+    size_t grid_bytes() const
+    {
+      return roundup(PieceLookup::GridIndex<N,T>::bytes_needed(cell_pieces.size()), 16);
+    }
+
+    char *generate_instructions(const std::vector<InstanceLayoutPiece<N,T> *>& pieces, char *next_inst, unsigned& usage_mask)
+    {
+      usage_mask |= PieceLookup::ALLOW_GRID;
+      char *cur_inst = next_inst;
+      PieceLookup::GridIndex<N,T> *gi =
+	new(next_inst) PieceLookup::GridIndex<N,T>;
+      gi->origin = origin;
+      gi->tile_size = tile_size;
+      gi->counts = counts;
+      next_inst += grid_bytes();
+
+      // every piece is the end of the program for its cell
+      std::vector<unsigned> piece_deltas(pieces.size());
+      for(size_t i = 0; i < pieces.size(); i++) {
+	size_t delta_bytes = next_inst - cur_inst;
+	assert((delta_bytes & 15) == 0);
+	piece_deltas[i] = delta_bytes >> 4;
+	PieceLookup::Instruction *inst = pieces[i]->create_lookup_inst(next_inst, 0);
+	usage_mask |= (1U << inst->opcode());
+	next_inst += roundup(pieces[i]->lookup_inst_size(), 16);
+      }
+
+      for(size_t i = 0; i < cell_pieces.size(); i++)
+	gi->deltas()[i] = piece_deltas[cell_pieces[i]];
+
+      return next_inst;
+    }
+  };
+
   template <int N, typename T>
   void InstanceLayout<N,T>::compile_lookup_program(PieceLookup::CompiledProgram& p) const
   {
@@ -377,6 +557,7 @@ namespace Realm {
     // each piece list that's used will turn into a program
     std::map<int, size_t> piece_list_starts;
     std::map<int, PieceSplitNode<T> *> piece_list_plans;
+    std::map<int, PieceGrid<N,T> *> piece_list_grids;
     for(std::map<FieldID, FieldLayout>::const_iterator it = fields.begin();
 	it != fields.end();
 	++it) {
@@ -400,6 +581,16 @@ namespace Realm {
 	  total_bytes += roundup(bytes, 16);
 	}
 
+	// regular tilings get a direct-indexed lookup, everything else a
+	//  tree of splits
+	PieceGrid<N,T> *grid = new PieceGrid<N,T>;
+	if(grid->compute(pl.pieces)) {
+	  piece_list_grids[it->second.list_idx] = grid;
+	  total_bytes += grid->grid_bytes();
+	  continue;
+	}
+	delete grid;
+
 	std::vector<int> idxs(pl.pieces.size());
 	for(size_t i = 0; i < pl.pieces.size(); i++)
 	  idxs[i] = i;
@@ -407,8 +598,7 @@ namespace Realm {
 								   idxs);
 	piece_list_plans[it->second.list_idx] = plan;
 	//plan->print(pl.pieces, 2);
-	total_bytes += (plan->total_splits *
-			roundup(sizeof(PieceLookup::SplitPlane<N,T>), 16));
+	total_bytes += plan->template split_bytes<N>();
       }
     }
 
@@ -428,6 +618,10 @@ namespace Realm {
 
       if(pl.pieces.empty()) {
 	// all zeros is ok for now
+      } else if(piece_list_grids.count(it->first) > 0) {
+	PieceGrid<N,T> *grid = piece_list_grids[it->first];
+	grid->generate_instructions(pl.pieces, next_inst, usage_mask);
+	delete grid;
       } else {
 	PieceSplitNode<T> *plan = piece_list_plans[it->first];
 	plan->generate_instructions(pl.pieces, next_inst, usage_mask);
@@ -658,6 +852,16 @@ namespace Realm {
 	  // otherwise all points in the rect go the same way and we can do
 	  //  that now
 	  i = sp->next(subrect.lo);
+	} else if(i->opcode() == PieceLookup::Opcodes::OP_SPLITN) {
+	  const PieceLookup::SplitMulti<N,T> *sm = static_cast<const PieceLookup::SplitMulti<N,T> *>(i);
+	  if(sm->splits_rect(subrect))
+	    break;
+	  i = sm->next(subrect.lo);
+	} else if(i->opcode() == PieceLookup::Opcodes::OP_GRID) {
+	  const PieceLookup::GridIndex<N,T> *gi = static_cast<const PieceLookup::GridIndex<N,T> *>(i);
+	  if(gi->splits_rect(subrect))
+	    break;
+	  i = gi->next(subrect.lo);
 	} else
 	  break;
       }
@@ -422,9 +422,13 @@ namespace Realm {
 
     namespace Opcodes {
       static const Opcode OP_AFFINE_PIECE = 2;  // this is a AffinePiece<N,T>
+      static const Opcode OP_SPLITN = 5;  // this is a SplitMulti<N,T>
+      static const Opcode OP_GRID = 6;  // this is a GridIndex<N,T>
     }
 
     static const unsigned ALLOW_AFFINE_PIECE = 1U << Opcodes::OP_AFFINE_PIECE;
+    static const unsigned ALLOW_SPLITN = 1U << Opcodes::OP_SPLITN;
+    static const unsigned ALLOW_GRID = 1U << Opcodes::OP_GRID;
 
     template <int N, typename T>
     struct REALM_INTERNAL_API_EXTERNAL_LINKAGE AffinePiece : public Instruction {
@@ -465,6 +469,72 @@ namespace Realm {
       bool splits_rect(const Rect<N,T>& r) const;
     };
 
+    // a multi-way split along a single dimension - the instruction is
+    //  followed by 'num_planes' sorted split planes and then 'num_planes+1'
+    //  jump deltas, one for each interval between planes
+    template <int N, typename T>
+    struct REALM_INTERNAL_API_EXTERNAL_LINKAGE SplitMulti : public Instruction {
+      // data is: { count[15:0], dim[7:0], opcode[7:0] }
+      SplitMulti(int _split_dim, unsigned _num_planes);
+
+      // total size of the instruction, including the plane/delta tables
+      static size_t bytes_needed(unsigned _num_planes);
+
+      REALM_CUDA_HD
+      int split_dim() const;
+      REALM_CUDA_HD
+      unsigned num_planes() const;
+
+      T *planes();
+      REALM_CUDA_HD
+      const T *planes() const;
+      unsigned *deltas();
+      REALM_CUDA_HD
+      const unsigned *deltas() const;
+
+      // returns the number of split planes <= coord (i.e. the index of the
+      //  interval containing it), using a branchless binary search
+      REALM_CUDA_HD
+      unsigned find_interval(T coord) const;
+
+      REALM_CUDA_HD
+      const Instruction *next(const Point<N,T>& p) const;
+
+      REALM_CUDA_HD
+      bool splits_rect(const Rect<N,T>& r) const;
+    };
+
+    // a direct-indexed lookup for pieces that form a regular tiling - the
+    //  instruction is followed by one jump delta per grid cell (dimension 0
+    //  varies fastest)
+    template <int N, typename T>
+    struct REALM_INTERNAL_API_EXTERNAL_LINKAGE GridIndex : public Instruction {
+      // data is: { unused[23:0], opcode[7:0] }
+      GridIndex();
+
+      // total size of the instruction, including the delta table
+      static size_t bytes_needed(size_t _num_cells);
+
+      Point<N,T> origin;
+      Point<N,T> tile_size;
+      Point<N,unsigned> counts;
+
+      unsigned *deltas();
+      REALM_CUDA_HD
+      const unsigned *deltas() const;
+
+      // index of the grid cell containing 'p' - points outside the grid are
+      //  clamped to the nearest cell
+      REALM_CUDA_HD
+      size_t cell_index(const Point<N,T>& p) const;
+
+      REALM_CUDA_HD
+      const Instruction *next(const Point<N,T>& p) const;
+
+      REALM_CUDA_HD
+      bool splits_rect(const Rect<N,T>& r) const;
+    };
+
   }; // namespace PieceLookup
 
 
@@ -754,7 +824,8 @@ namespace Realm {
    * A multi-affine accessor handles instances with multiple pieces, but only
    * if all of them are affine. Multi-affine accessors may be accessed and
    * copied in CUDA device code, but must be initially constructed on the host.
-   * The random-access look-ups are O(log(N)) in the number of pieces.
+   * The random-access look-ups are O(log(N)) in the number of pieces, or
+   * O(1) for pieces that form a regular tiling.
    */
   template <typename FT, int N, typename T>
   class REALM_PUBLIC_API MultiAffineAccessor {
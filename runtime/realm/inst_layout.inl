@@ -763,6 +763,165 @@ namespace Realm {
     }
 
 
+    ////////////////////////////////////////////////////////////////////////
+    //
+    // class PieceLookup::SplitMulti<N,T>
+
+    template <int N, typename T>
+    SplitMulti<N,T>::SplitMulti(int _split_dim, unsigned _num_planes)
+      : Instruction(Opcodes::OP_SPLITN +
+		    (_split_dim << 8) +
+		    (_num_planes << 16))
+    {}
+
+    template <int N, typename T>
+    /*static*/ size_t SplitMulti<N,T>::bytes_needed(unsigned _num_planes)
+    {
+      size_t plane_bytes = ((_num_planes * sizeof(T)) + 3) & ~size_t(3);
+      return (sizeof(SplitMulti<N,T>) + plane_bytes +
+	      ((_num_planes + 1) * sizeof(unsigned)));
+    }
+
+    template <int N, typename T>
+    REALM_CUDA_HD
+    int SplitMulti<N,T>::split_dim() const
+    {
+      return (data >> 8) & 0xff;
+    }
+
+    template <int N, typename T>
+    REALM_CUDA_HD
+    unsigned SplitMulti<N,T>::num_planes() const
+    {
+      return (data >> 16);
+    }
+
+    template <int N, typename T>
+    T *SplitMulti<N,T>::planes()
+    {
+      return reinterpret_cast<T *>(reinterpret_cast<uintptr_t>(this) +
+				   sizeof(SplitMulti<N,T>));
+    }
+
+    template <int N, typename T>
+    REALM_CUDA_HD
+    const T *SplitMulti<N,T>::planes() const
+    {
+      return reinterpret_cast<const T *>(reinterpret_cast<uintptr_t>(this) +
+					 sizeof(SplitMulti<N,T>));
+    }
+
+    template <int N, typename T>
+    unsigned *SplitMulti<N,T>::deltas()
+    {
+      size_t plane_bytes = ((num_planes() * sizeof(T)) + 3) & ~size_t(3);
+      return reinterpret_cast<unsigned *>(reinterpret_cast<uintptr_t>(planes()) +
+					  plane_bytes);
+    }
+
+    template <int N, typename T>
+    REALM_CUDA_HD
+    const unsigned *SplitMulti<N,T>::deltas() const
+    {
+      size_t plane_bytes = ((num_planes() * sizeof(T)) + 3) & ~size_t(3);
+      return reinterpret_cast<const unsigned *>(reinterpret_cast<uintptr_t>(planes()) +
+						plane_bytes);
+    }
+
+    template <int N, typename T>
+    REALM_CUDA_HD
+    unsigned SplitMulti<N,T>::find_interval(T coord) const
+    {
+      // the loop trip count depends only on the number of planes, and the
+      //  selects below compile to conditional moves
+      const T *base = planes();
+      const T *first = base;
+      unsigned n = num_planes();
+      while(n > 1) {
+	unsigned half = n >> 1;
+	first = (first[half] <= coord) ? (first + half) : first;
+	n -= half;
+      }
+      return (first - base) + ((*first <= coord) ? 1 : 0);
+    }
+
+    template <int N, typename T>
+    REALM_CUDA_HD
+    const Instruction *SplitMulti<N,T>::next(const Point<N,T>& p) const
+    {
+      return this->jump(deltas()[find_interval(p[this->split_dim()])]);
+    }
+
+    template <int N, typename T>
+    REALM_CUDA_HD
+    bool SplitMulti<N,T>::splits_rect(const Rect<N,T>& r) const
+    {
+      int d = this->split_dim();
+      return (find_interval(r.lo[d]) != find_interval(r.hi[d]));
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////
+    //
+    // class PieceLookup::GridIndex<N,T>
+
+    template <int N, typename T>
+    GridIndex<N,T>::GridIndex()
+      : Instruction(Opcodes::OP_GRID)
+    {}
+
+    template <int N, typename T>
+    /*static*/ size_t GridIndex<N,T>::bytes_needed(size_t _num_cells)
+    {
+      return (sizeof(GridIndex<N,T>) + (_num_cells * sizeof(unsigned)));
+    }
+
+    template <int N, typename T>
+    unsigned *GridIndex<N,T>::deltas()
+    {
+      return reinterpret_cast<unsigned *>(reinterpret_cast<uintptr_t>(this) +
+					  sizeof(GridIndex<N,T>));
+    }
+
+    template <int N, typename T>
+    REALM_CUDA_HD
+    const unsigned *GridIndex<N,T>::deltas() const
+    {
+      return reinterpret_cast<const unsigned *>(reinterpret_cast<uintptr_t>(this) +
+						sizeof(GridIndex<N,T>));
+    }
+
+    template <int N, typename T>
+    REALM_CUDA_HD
+    size_t GridIndex<N,T>::cell_index(const Point<N,T>& p) const
+    {
+      size_t idx = 0;
+      for(int i = N - 1; i >= 0; i--) {
+	size_t c = ((p[i] < origin[i]) ?
+		      0 :
+		      (size_t(p[i] - origin[i]) / size_t(tile_size[i])));
+	if(c >= counts[i])
+	  c = counts[i] - 1;
+	idx = (idx * counts[i]) + c;
+      }
+      return idx;
+    }
+
+    template <int N, typename T>
+    REALM_CUDA_HD
+    const Instruction *GridIndex<N,T>::next(const Point<N,T>& p) const
+    {
+      return this->jump(deltas()[cell_index(p)]);
+    }
+
+    template <int N, typename T>
+    REALM_CUDA_HD
+    bool GridIndex<N,T>::splits_rect(const Rect<N,T>& r) const
+    {
+      return (cell_index(r.lo) != cell_index(r.hi));
+    }
+
+
   };
 
 
@@ -1590,7 +1749,9 @@ namespace Realm {
   {
     size_t field_offset = 0;
     unsigned allowed_mask = (PieceLookup::ALLOW_AFFINE_PIECE |
-			     PieceLookup::ALLOW_SPLIT1);
+			     PieceLookup::ALLOW_SPLIT1 |
+			     PieceLookup::ALLOW_SPLITN |
+			     PieceLookup::ALLOW_GRID);
     const PieceLookup::Instruction *start_inst =
       inst.get_lookup_program<N,T>(field_id, allowed_mask, field_offset);
     return (start_inst != 0);
@@ -1603,7 +1764,9 @@ namespace Realm {
   {
     size_t field_offset = 0;
     unsigned allowed_mask = (PieceLookup::ALLOW_AFFINE_PIECE |
-			     PieceLookup::ALLOW_SPLIT1);
+			     PieceLookup::ALLOW_SPLIT1 |
+			     PieceLookup::ALLOW_SPLITN |
+			     PieceLookup::ALLOW_GRID);
     const PieceLookup::Instruction *start_inst =
       inst.get_lookup_program<N,T>(field_id, subrect, allowed_mask,
 				   field_offset);
@@ -1625,7 +1788,9 @@ namespace Realm {
 					  size_t subfield_offset /*= 0*/)
   {
     unsigned allowed_mask = (PieceLookup::ALLOW_AFFINE_PIECE |
-			     PieceLookup::ALLOW_SPLIT1);
+			     PieceLookup::ALLOW_SPLIT1 |
+			     PieceLookup::ALLOW_SPLITN |
+			     PieceLookup::ALLOW_GRID);
     start_inst = inst.get_lookup_program<N,T>(field_id, allowed_mask,
 					      field_offset);
     assert(start_inst != 0);
@@ -1658,7 +1823,9 @@ namespace Realm {
 					  size_t subfield_offset /*= 0*/)
   {
     unsigned allowed_mask = (PieceLookup::ALLOW_AFFINE_PIECE |
-			     PieceLookup::ALLOW_SPLIT1);
+			     PieceLookup::ALLOW_SPLIT1 |
+			     PieceLookup::ALLOW_SPLITN |
+			     PieceLookup::ALLOW_GRID);
     start_inst = inst.get_lookup_program<N,T>(field_id, subrect, allowed_mask,
 					      field_offset);
     assert(start_inst != 0);
@@ -1711,9 +1878,13 @@ namespace Realm {
 	    return reinterpret_cast<FT *>(rawptr);
 	  } else
 	    i = ap->next();
-	} else {
-	  assert(i->opcode() == PieceLookup::Opcodes::OP_SPLIT1);
+	} else if(i->opcode() == PieceLookup::Opcodes::OP_SPLIT1) {
 	  i = static_cast<const PieceLookup::SplitPlane<N,T> *>(i)->next(p);
+	} else if(i->opcode() == PieceLookup::Opcodes::OP_SPLITN) {
+	  i = static_cast<const PieceLookup::SplitMulti<N,T> *>(i)->next(p);
+	} else {
+	  assert(i->opcode() == PieceLookup::Opcodes::OP_GRID);
+	  i = static_cast<const PieceLookup::GridIndex<N,T> *>(i)->next(p);
 	}
       }
     }
@@ -1747,13 +1918,25 @@ namespace Realm {
 	    return reinterpret_cast<FT *>(rawptr);
 	  } else
 	    i = ap->next();
-	} else {
-	  assert(i->opcode() == PieceLookup::Opcodes::OP_SPLIT1);
+	} else if(i->opcode() == PieceLookup::Opcodes::OP_SPLIT1) {
 	  const PieceLookup::SplitPlane<N,T> *sp =
 	    static_cast<const PieceLookup::SplitPlane<N,T> *>(i);
 	  if(sp->splits_rect(r))
 	    return 0; // failure
 	  i = sp->next(r.lo);
+	} else if(i->opcode() == PieceLookup::Opcodes::OP_SPLITN) {
+	  const PieceLookup::SplitMulti<N,T> *sm =
+	    static_cast<const PieceLookup::SplitMulti<N,T> *>(i);
+	  if(sm->splits_rect(r))
+	    return 0; // failure
+	  i = sm->next(r.lo);
+	} else {
+	  assert(i->opcode() == PieceLookup::Opcodes::OP_GRID);
+	  const PieceLookup::GridIndex<N,T> *gi =
+	    static_cast<const PieceLookup::GridIndex<N,T> *>(i);
+	  if(gi->splits_rect(r))
+	    return 0; // failure
+	  i = gi->next(r.lo);
 	}
       }
     }
@@ -1805,11 +1988,15 @@ namespace Realm {
 	    break;
 	  } else
 	    i = ap->next();
+	} else if(i->opcode() == PieceLookup::Opcodes::OP_SPLIT1) {
+	  i = static_cast<const PieceLookup::SplitPlane<N,T> *>(i)->next(p);
+	} else if(i->opcode() == PieceLookup::Opcodes::OP_SPLITN) {
+	  i = static_cast<const PieceLookup::SplitMulti<N,T> *>(i)->next(p);
 	} else {
 #ifndef __HIP_DEVICE_COMPILE__
-	  assert(i->opcode() == PieceLookup::Opcodes::OP_SPLIT1);
+	  assert(i->opcode() == PieceLookup::Opcodes::OP_GRID);
 #endif
-	  i = static_cast<const PieceLookup::SplitPlane<N,T> *>(i)->next(p);
+	  i = static_cast<const PieceLookup::GridIndex<N,T> *>(i)->next(p);
 	}
       }
     }
@@ -1842,13 +2029,25 @@ namespace Realm {
 	    break;
 	  } else
 	    i = ap->next();
-	} else {
-	  assert(i->opcode() == PieceLookup::Opcodes::OP_SPLIT1);
+	} else if(i->opcode() == PieceLookup::Opcodes::OP_SPLIT1) {
 	  const PieceLookup::SplitPlane<N,T> *sp =
 	    static_cast<const PieceLookup::SplitPlane<N,T> *>(i);
 	  if(sp->splits_rect(r))
 	    return 0; // failure
 	  i = sp->next(r.lo);
+	} else if(i->opcode() == PieceLookup::Opcodes::OP_SPLITN) {
+	  const PieceLookup::SplitMulti<N,T> *sm =
+	    static_cast<const PieceLookup::SplitMulti<N,T> *>(i);
+	  if(sm->splits_rect(r))
+	    return 0; // failure
+	  i = sm->next(r.lo);
+	} else {
+	  assert(i->opcode() == PieceLookup::Opcodes::OP_GRID);
+	  const PieceLookup::GridIndex<N,T> *gi =
+	    static_cast<const PieceLookup::GridIndex<N,T> *>(i);
+	  if(gi->splits_rect(r))
+	    return 0; // failure
+	  i = gi->next(r.lo);
 	}
       }
     }
@@ -21,6 +21,8 @@
 
 #include "realm/cmdline.h"
 #include "realm/timers.h"
+#include "realm/atomics.h"
+#include "realm/mutex.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -30,10 +32,16 @@
 
 #include <set>
 #include <map>
+#include <vector>
+#include <algorithm>
+#include <thread>
 
 #ifdef REALM_ON_WINDOWS
 #include <windows.h>
 #include <processthreadsapi.h>
+#include <io.h>
+#else
+#include <unistd.h>
 #endif
 
 namespace Realm {
@@ -138,6 +146,516 @@ namespace Realm {
     Mutex mutex;
   };
 
+  // a buffered file stream defers all formatting and file i/o to a
+  //  background thread - each thread that logs appends its messages to a
+  //  ring buffer of its own (one producer, one consumer, no locks), and the
+  //  flusher periodically drains all the rings, sorts what it found by
+  //  timestamp, and writes the formatted messages out in large chunks
+  //
+  // messages are only sorted within a single drain - one that is published
+  //  just after a drain starts can show up after messages from other
+  //  threads with later timestamps, but messages from any one thread are
+  //  always written in the order they were logged
+  class LoggerBufferedFileStream : public LoggerOutputStream {
+  public:
+    LoggerBufferedFileStream(FILE *_f, bool _close_file, bool _include_timestamp,
+                             size_t _ring_size);
+    virtual ~LoggerBufferedFileStream(void);
+
+    virtual void log_msg(Logger::LoggingLevel level, const char *name,
+                         const char *msgdata, size_t msglen);
+    virtual void flush();
+
+    // writes out whatever is in the rings if nobody else is draining them -
+    //  never blocks or allocates, so it is safe to call from a signal
+    //  handler, but messages from different threads are not interleaved
+    //  by timestamp
+    void flush_on_fault(void);
+
+    // called when a thread that logged to a buffered stream exits
+    static void release_local_ring(void);
+
+  protected:
+    struct RecordHeader {
+      long long timestamp;  // absolute, in nanoseconds
+      unsigned long thread;
+      int level;
+      unsigned name_len, msg_len;
+    };
+
+    struct ThreadRing {
+      ThreadRing *next;
+      // both are running byte counts - only the owning thread moves the
+      //  tail and only the flusher moves the head
+      atomic<size_t> head, tail;
+      size_t size;
+      char *data;
+      // set by whichever of the owning thread (on exit) and the stream (on
+      //  destruction) lets go of the ring first - the other one frees it
+      atomic<bool> released;
+    };
+
+    struct PendingRecord {
+      long long timestamp;
+      ThreadRing *ring;
+      size_t offset;
+      RecordHeader header;
+
+      bool operator<(const PendingRecord& rhs) const
+      { return (timestamp < rhs.timestamp); }
+    };
+
+    ThreadRing *get_local_ring(void);
+    static void free_ring(ThreadRing *ring);
+    void append(ThreadRing *ring, const void *data, size_t bytes, size_t& pos);
+    void extract(ThreadRing *ring, void *data, size_t bytes, size_t pos) const;
+    int format_prefix(char *prefix, size_t maxlen, const RecordHeader& header,
+                      const char *name) const;
+    void format_record(const PendingRecord& record);
+    void write_out(const void *data, size_t bytes);
+    void write_staged(void);
+    // must be called while holding the drain mutex
+    void drain_rings(void);
+    void reclaim_rings(void);
+    void wake_flusher(void);
+    void flusher_loop(void);
+
+    static const size_t STAGING_SIZE = 1 << 20;
+    static const long long FLUSH_INTERVAL_NS = 10000000;  // 10 ms
+
+    FILE *f;
+    int fd;
+    bool close_file, include_timestamp;
+    size_t ring_size;
+    atomic<ThreadRing *> rings;
+    Mutex drain_mutex;
+    std::vector<char> staging;
+    std::vector<PendingRecord> pending;
+    std::vector<std::pair<ThreadRing *, size_t> > drained;
+    KernelMutex wake_mutex;
+    KernelMutex::CondVar wake_cv;
+    bool shutdown_requested;
+    std::thread flusher;
+  };
+
+  namespace ThreadLocal {
+    static REALM_THREAD_LOCAL LoggerBufferedFileStream *ring_stream = 0;
+    static REALM_THREAD_LOCAL void *local_ring = 0;
+
+    // its destructor runs at thread exit and hands the thread's ring back
+    //  to the stream (REALM_THREAD_LOCAL variables don't get destructors)
+    struct RingReleaser {
+      ~RingReleaser(void) { LoggerBufferedFileStream::release_local_ring(); }
+    };
+    static thread_local RingReleaser ring_releaser;
+  };
+
+  // everything this stream writes goes straight to the file descriptor -
+  //  nothing is ever left in stdio's buffer, so the fault path can write
+  //  without worrying about interleaving with (or flushing) the FILE
+  LoggerBufferedFileStream::LoggerBufferedFileStream(FILE *_f, bool _close_file,
+                                                     bool _include_timestamp,
+                                                     size_t _ring_size)
+    : f(_f), close_file(_close_file), include_timestamp(_include_timestamp)
+    , ring_size(_ring_size), rings(0), wake_cv(wake_mutex)
+    , shutdown_requested(false)
+  {
+    fflush(f);
+#ifdef REALM_ON_WINDOWS
+    fd = _fileno(f);
+#else
+    fd = fileno(f);
+#endif
+    staging.reserve(STAGING_SIZE);
+    flusher = std::thread(&LoggerBufferedFileStream::flusher_loop, this);
+  }
+
+  LoggerBufferedFileStream::~LoggerBufferedFileStream(void)
+  {
+    {
+      AutoLock<KernelMutex> al(wake_mutex);
+      shutdown_requested = true;
+      wake_cv.signal();
+    }
+    flusher.join();
+    flush();
+    // rings whose threads are still alive are freed by those threads when
+    //  they exit, but nobody should be logging to a stream that is being
+    //  destroyed
+    ThreadRing *ring = rings.load();
+    while(ring != 0) {
+      ThreadRing *next = ring->next;
+      if(ring->released.exchange(true))
+        free_ring(ring);
+      ring = next;
+    }
+    if(close_file)
+      fclose(f);
+  }
+
+  LoggerBufferedFileStream::ThreadRing *LoggerBufferedFileStream::get_local_ring(void)
+  {
+    if(ThreadLocal::ring_stream == this)
+      return static_cast<ThreadRing *>(ThreadLocal::local_ring);
+    ThreadRing *ring = new ThreadRing;
+    ring->head.store(0);
+    ring->tail.store(0);
+    ring->size = ring_size;
+    ring->data = static_cast<char *>(malloc(ring_size));
+    assert(ring->data != 0);
+    ring->released.store(false);
+    // rings are pushed on the front of the list and only removed by the
+    //  flusher (while holding the drain mutex) once their thread has exited
+    ThreadRing *old_head = rings.load();
+    do {
+      ring->next = old_head;
+    } while(!rings.compare_exchange(old_head, ring));
+    ThreadLocal::ring_stream = this;
+    ThreadLocal::local_ring = ring;
+    // touching the releaser is what registers its destructor for this thread
+    (void)&ThreadLocal::ring_releaser;
+    return ring;
+  }
+
+  /*static*/ void LoggerBufferedFileStream::free_ring(ThreadRing *ring)
+  {
+    free(ring->data);
+    delete ring;
+  }
+
+  /*static*/ void LoggerBufferedFileStream::release_local_ring(void)
+  {
+    ThreadRing *ring = static_cast<ThreadRing *>(ThreadLocal::local_ring);
+    if(ring == 0)
+      return;
+    ThreadLocal::ring_stream = 0;
+    ThreadLocal::local_ring = 0;
+    // if the stream is already gone, it left the ring for us to free -
+    //  otherwise the flusher frees it once it has been drained
+    if(ring->released.exchange(true))
+      free_ring(ring);
+  }
+
+  void LoggerBufferedFileStream::append(ThreadRing *ring, const void *data,
+                                        size_t bytes, size_t& pos)
+  {
+    const size_t offset = pos % ring->size;
+    const size_t first = std::min(bytes, ring->size - offset);
+    memcpy(ring->data + offset, data, first);
+    if(first < bytes)
+      memcpy(ring->data, static_cast<const char *>(data) + first, bytes - first);
+    pos += bytes;
+  }
+
+  void LoggerBufferedFileStream::extract(ThreadRing *ring, void *data,
+                                         size_t bytes, size_t pos) const
+  {
+    const size_t offset = pos % ring->size;
+    const size_t first = std::min(bytes, ring->size - offset);
+    memcpy(data, ring->data + offset, first);
+    if(first < bytes)
+      memcpy(static_cast<char *>(data) + first, ring->data, bytes - first);
+  }
+
+  int LoggerBufferedFileStream::format_prefix(char *prefix, size_t maxlen,
+                                              const RecordHeader& header,
+                                              const char *name) const
+  {
+    int pfxlen;
+    if(include_timestamp) {
+      // match LoggerFileStream - messages from before we agreed on a common
+      //  time base show up as 0.0
+      double now = 0;
+      const long long zero = Clock::get_zero_time();
+      if((zero != 0) && (header.timestamp > zero))
+        now = (header.timestamp - zero) * 1e-9;
+      pfxlen = snprintf(prefix, maxlen, "[%d - %lx] %11.6f {%d}{%s}: ",
+                        Network::my_node_id, header.thread, now,
+                        header.level, name);
+    } else
+      pfxlen = snprintf(prefix, maxlen, "[%d - %lx] {%d}{%s}: ",
+                        Network::my_node_id, header.thread,
+                        header.level, name);
+    if(pfxlen >= int(maxlen))
+      pfxlen = maxlen - 1;
+    return pfxlen;
+  }
+
+  void LoggerBufferedFileStream::log_msg(Logger::LoggingLevel level, const char *name,
+                                         const char *msgdata, size_t msglen)
+  {
+    RecordHeader header;
+    header.timestamp = Clock::current_time_in_nanoseconds(true /*absolute*/);
+#ifdef REALM_ON_WINDOWS
+    header.thread = GetCurrentThreadId();
+#else
+    header.thread = (unsigned long)pthread_self();
+#endif
+    header.level = level;
+    header.name_len = strlen(name);
+    header.msg_len = msglen;
+    const size_t total = sizeof(header) + header.name_len + header.msg_len;
+
+    ThreadRing *ring = get_local_ring();
+    if(total > (ring->size / 2)) {
+      // too big to buffer sensibly - drain everything that came before it
+      //  and then write it out directly
+      AutoLock<> al(drain_mutex);
+      drain_rings();
+      char prefix[512];
+      int pfxlen = format_prefix(prefix, sizeof(prefix), header, name);
+      write_out(prefix, pfxlen);
+      write_out(msgdata, msglen);
+      write_out("\n", 1);
+      return;
+    }
+
+    // wait for space if the flusher has fallen behind - help it out rather
+    //  than spinning
+    size_t pos = ring->tail.load();
+    while((pos + total - ring->head.load_acquire()) > ring->size) {
+      AutoLock<> al(drain_mutex);
+      drain_rings();
+    }
+    append(ring, &header, sizeof(header), pos);
+    append(ring, name, header.name_len, pos);
+    append(ring, msgdata, header.msg_len, pos);
+    ring->tail.store_release(pos);
+
+    // critical messages go out right away in case we're about to die
+    if(level >= Logger::LEVEL_ERROR)
+      flush();
+    else if((pos - ring->head.load()) > (ring->size / 2))
+      wake_flusher();
+  }
+
+  void LoggerBufferedFileStream::format_record(const PendingRecord& record)
+  {
+    char name[256];
+    const size_t name_len = std::min<size_t>(record.header.name_len, sizeof(name) - 1);
+    extract(record.ring, name, name_len, record.offset + sizeof(RecordHeader));
+    name[name_len] = '\0';
+
+    char prefix[512];
+    int pfxlen = format_prefix(prefix, sizeof(prefix), record.header, name);
+
+    const size_t total = pfxlen + record.header.msg_len + 1;
+    if((staging.size() + total) > STAGING_SIZE)
+      write_staged();
+    const size_t start = staging.size();
+    staging.resize(start + total);
+    memcpy(&staging[start], prefix, pfxlen);
+    extract(record.ring, &staging[start + pfxlen], record.header.msg_len,
+            record.offset + sizeof(RecordHeader) + record.header.name_len);
+    staging[start + total - 1] = '\n';
+  }
+
+  void LoggerBufferedFileStream::write_out(const void *data, size_t bytes)
+  {
+    const char *p = static_cast<const char *>(data);
+    while(bytes > 0) {
+#ifdef REALM_ON_WINDOWS
+      int amt = _write(fd, p, unsigned(bytes));
+#else
+      ssize_t amt = write(fd, p, bytes);
+#endif
+      if(amt < 0) {
+        if(errno == EINTR)
+          continue;
+        // nowhere left to complain to
+        return;
+      }
+      p += amt;
+      bytes -= amt;
+    }
+  }
+
+  void LoggerBufferedFileStream::write_staged(void)
+  {
+    if(staging.empty())
+      return;
+    write_out(&staging[0], staging.size());
+    staging.clear();
+  }
+
+  void LoggerBufferedFileStream::drain_rings(void)
+  {
+    // take a snapshot of everything that has been published so far
+    drained.clear();
+    pending.clear();
+    for(ThreadRing *ring = rings.load_acquire(); ring != 0; ring = ring->next) {
+      size_t pos = ring->head.load();
+      const size_t end = ring->tail.load_acquire();
+      if(pos == end)
+        continue;
+      while(pos < end) {
+        PendingRecord record;
+        extract(ring, &record.header, sizeof(RecordHeader), pos);
+        record.timestamp = record.header.timestamp;
+        record.ring = ring;
+        record.offset = pos;
+        pending.push_back(record);
+        pos += (sizeof(RecordHeader) + record.header.name_len +
+                record.header.msg_len);
+      }
+      drained.push_back(std::make_pair(ring, end));
+    }
+    if(!pending.empty()) {
+      // each ring is already in order, so a stable sort keeps ties in the
+      //  order they were logged by each thread
+      std::stable_sort(pending.begin(), pending.end());
+      for(std::vector<PendingRecord>::const_iterator it = pending.begin();
+          it != pending.end(); it++)
+        format_record(*it);
+      write_staged();
+      // only now can we give the space back to the producers
+      for(std::vector<std::pair<ThreadRing *, size_t> >::const_iterator it =
+            drained.begin(); it != drained.end(); it++)
+        it->first->head.store_release(it->second);
+    }
+    reclaim_rings();
+  }
+
+  void LoggerBufferedFileStream::reclaim_rings(void)
+  {
+    // free the rings of threads that have exited and whose messages have all
+    //  been written - producers only ever push onto the front of the list,
+    //  so anything past the head can be unlinked without synchronization
+    ThreadRing *prev = 0;
+    ThreadRing *ring = rings.load_acquire();
+    while(ring != 0) {
+      ThreadRing *next = ring->next;
+      if(ring->released.load_acquire() &&
+         (ring->head.load() == ring->tail.load_acquire())) {
+        bool unlinked;
+        if(prev != 0) {
+          prev->next = next;
+          unlinked = true;
+        } else {
+          // a new ring may have been pushed in front of this one - if so,
+          //  leave it for the next drain
+          ThreadRing *expected = ring;
+          unlinked = rings.compare_exchange(expected, next);
+        }
+        if(unlinked) {
+          free_ring(ring);
+          ring = next;
+          continue;
+        }
+      }
+      prev = ring;
+      ring = next;
+    }
+  }
+
+  void LoggerBufferedFileStream::wake_flusher(void)
+  {
+    AutoLock<KernelMutex> al(wake_mutex);
+    wake_cv.signal();
+  }
+
+  void LoggerBufferedFileStream::flusher_loop(void)
+  {
+    while(true) {
+      {
+        AutoLock<KernelMutex> al(wake_mutex);
+        if(!shutdown_requested)
+          wake_cv.timedwait(FLUSH_INTERVAL_NS);
+        if(shutdown_requested)
+          break;
+      }
+      AutoLock<> al(drain_mutex);
+      drain_rings();
+    }
+  }
+
+  void LoggerBufferedFileStream::flush()
+  {
+    AutoLock<> al(drain_mutex);
+    drain_rings();
+  }
+
+  namespace {
+    // async-signal-safe formatting helpers for the fault path
+    char *append_chars(char *p, char *limit, const char *s, size_t len)
+    {
+      while((len-- > 0) && (p < limit))
+        *p++ = *s++;
+      return p;
+    }
+
+    char *append_uint(char *p, char *limit, unsigned long long v,
+                      unsigned base, int min_digits)
+    {
+      char digits[32];
+      int n = 0;
+      do {
+        digits[n++] = "0123456789abcdef"[v % base];
+        v /= base;
+      } while(v > 0);
+      while(n < min_digits)
+        digits[n++] = '0';
+      while((n > 0) && (p < limit))
+        *p++ = digits[--n];
+      return p;
+    }
+  };
+
+  void LoggerBufferedFileStream::flush_on_fault(void)
+  {
+    // if someone else is draining (perhaps the thread that faulted), don't
+    //  wait for them as we might never get the lock
+    if(!drain_mutex.trylock())
+      return;
+    // no sorting or staging here - every ring is written out in order
+    //  straight from its own buffer, with only stack storage for prefixes
+    const long long zero = Clock::get_zero_time();
+    for(ThreadRing *ring = rings.load_acquire(); ring != 0; ring = ring->next) {
+      size_t pos = ring->head.load();
+      const size_t end = ring->tail.load_acquire();
+      while(pos < end) {
+        RecordHeader header;
+        extract(ring, &header, sizeof(RecordHeader), pos);
+        char prefix[512];
+        char *limit = prefix + sizeof(prefix);
+        char *p = append_chars(prefix, limit, "[", 1);
+        p = append_uint(p, limit, Network::my_node_id, 10, 1);
+        p = append_chars(p, limit, " - ", 3);
+        p = append_uint(p, limit, header.thread, 16, 1);
+        p = append_chars(p, limit, "] ", 2);
+        if(include_timestamp) {
+          long long rel = (((zero != 0) && (header.timestamp > zero)) ?
+                             (header.timestamp - zero) : 0);
+          p = append_uint(p, limit, rel / 1000000000, 10, 1);
+          p = append_chars(p, limit, ".", 1);
+          p = append_uint(p, limit, (rel % 1000000000) / 1000, 10, 6);
+          p = append_chars(p, limit, " ", 1);
+        }
+        p = append_chars(p, limit, "{", 1);
+        p = append_uint(p, limit, header.level, 10, 1);
+        p = append_chars(p, limit, "}{", 2);
+        const size_t name_len = std::min<size_t>(header.name_len, 256);
+        if((p + name_len) < limit) {
+          extract(ring, p, name_len, pos + sizeof(RecordHeader));
+          p += name_len;
+        }
+        p = append_chars(p, limit, "}: ", 3);
+        write_out(prefix, p - prefix);
+        // the message may wrap around the end of the ring
+        const size_t msg_pos = pos + sizeof(RecordHeader) + header.name_len;
+        const size_t offset = msg_pos % ring->size;
+        const size_t first = std::min<size_t>(header.msg_len, ring->size - offset);
+        write_out(ring->data + offset, first);
+        if(first < header.msg_len)
+          write_out(ring->data, header.msg_len - first);
+        write_out("\n", 1);
+        pos = msg_pos + header.msg_len;
+      }
+      ring->head.store_release(end);
+    }
+    drain_mutex.unlock();
+  }
+
   class LoggerConfig {
   protected:
     LoggerConfig(void);
@@ -147,6 +665,7 @@ namespace Realm {
     static LoggerConfig *get_config(void);
 
     static void flush_all_streams(void);
+    static void flush_streams_on_fault(void);
 
     void read_command_line(std::vector<std::string>& cmdline);
     void set_default_output(LoggerOutputStream *s);
@@ -160,14 +679,17 @@ namespace Realm {
 
   protected:
     bool parse_level_argument(const std::string& s);
+    LoggerOutputStream *make_stream(FILE *f, bool close_file);
 
     bool cmdline_read;
     Logger::LoggingLevel default_level, stderr_level;
     bool include_timestamp;
+    size_t buffer_size;
     std::map<std::string, Logger::LoggingLevel> category_levels;
     std::string cats_enabled;
     std::set<Logger *> pending_configs;
     LoggerOutputStream *stream, *stderr_stream, *default_output;
+    LoggerBufferedFileStream *buffered_stream;
     std::map<std::string, LoggerOutputStream *> logger_output;
   };
 
@@ -176,9 +698,11 @@ namespace Realm {
     , default_level(Logger::LEVEL_PRINT)
     , stderr_level(Logger::LEVEL_ERROR)
     , include_timestamp(true)
+    , buffer_size(0)
     , stream(0)
     , stderr_stream(0)
     , default_output(0)
+    , buffered_stream(0)
   {}
 
   LoggerConfig::~LoggerConfig(void)
@@ -199,6 +723,13 @@ namespace Realm {
       cfg->stream->flush();
   }
 
+  /*static*/ void LoggerConfig::flush_streams_on_fault(void)
+  {
+    LoggerConfig *cfg = get_config();
+    if(cfg->buffered_stream)
+      cfg->buffered_stream->flush_on_fault();
+  }
+
   template <>
   int convert_integer_cmdline_argument<Logger::LoggingLevel>(const std::string &s,
                                                              Logger::LoggingLevel &target)
@@ -312,6 +843,7 @@ namespace Realm {
                   .add_option_method("-level", this, &LoggerConfig::parse_level_argument)
                   .add_option_int("-errlevel", stderr_level)
                   .add_option_int("-logtime", include_timestamp)
+                  .add_option_int_units("-logbuffer", buffer_size, 'k')
                   .parse_command_line(cmdline);
 
     if(!ok) {
@@ -325,9 +857,9 @@ namespace Realm {
 
     // lots of choices for log output
     if(Config::logname == "stdout") {
-      stream = new LoggerFileStream(stdout, false, include_timestamp);
+      stream = make_stream(stdout, false);
     } else if(Config::logname == "stderr") {
-      stream = new LoggerFileStream(stderr, false, include_timestamp);
+      stream = make_stream(stderr, false);
     } else {
       // we're going to open a file, but key off a + for appending and
       //  look for a % for node number insertion
@@ -371,7 +903,7 @@ namespace Realm {
       }
       // TODO: consider buffering in some cases?
       setbuf(f, 0); // disable output buffering
-      stream = new LoggerFileStream(f, true, include_timestamp);
+      stream = make_stream(f, true);
 
       // when logging to a file, also sent critical-enough messages to stderr
       if(stderr_level < Logger::LEVEL_NONE)
@@ -390,6 +922,16 @@ namespace Realm {
     }
   }
 
+  LoggerOutputStream *LoggerConfig::make_stream(FILE *f, bool close_file)
+  {
+    if(buffer_size == 0)
+      return new LoggerFileStream(f, close_file, include_timestamp);
+    buffered_stream = new LoggerBufferedFileStream(f, close_file,
+                                                   include_timestamp,
+                                                   buffer_size);
+    return buffered_stream;
+  }
+
   void LoggerConfig::set_default_output(LoggerOutputStream *s)
   {
     // must be called before command line is parsed
@@ -541,6 +1083,11 @@ namespace Realm {
     LoggerConfig::get_config()->read_command_line(cmdline);
   }
 
+  /*static*/ void Logger::flush_on_fault(void)
+  {
+    LoggerConfig::flush_streams_on_fault();
+  }
+
   /*static*/ void Logger::set_default_output(LoggerOutputStream *s)
   {
     LoggerConfig::get_config()->set_default_output(s);
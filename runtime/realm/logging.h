@@ -67,6 +67,9 @@ namespace Realm {
     };
     
     static void configure_from_cmdline(std::vector<std::string>& cmdline);
+    // writes out any messages still sitting in logging buffers - does not
+    //  block, so it may be called from a fault handler
+    static void flush_on_fault(void);
     static void set_default_output(LoggerOutputStream *s);
     static void set_logger_output(const std::string& name, LoggerOutputStream *s);
     
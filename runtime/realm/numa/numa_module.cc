@@ -124,13 +124,22 @@ namespace Realm {
       cp.add_option_int_units("-ll:nsize", cfg_numa_mem_size, 'm')
         .add_option_int_units("-ll:ncsize", cfg_numa_nocpu_mem_size, 'm')
         .add_option_int("-ll:ncpu", cfg_num_numa_cpus)
-        .add_option_bool("-numa:pin", cfg_pin_memory);
+        .add_option_bool("-numa:pin", cfg_pin_memory)
+        .add_option_string("-numa:hugepages", cfg_hugepages)
+        .add_option_int("-numa:prefault", cfg_prefault_threads);
 
       bool ok = cp.parse_command_line(cmdline);
       if(!ok) {
         log_numa.fatal() << "error reading NUMA command line parameters";
         assert(false);
       }
+
+      NumaHugePageMode mode;
+      if(!numasysif_parse_hugepage_mode(cfg_hugepages, mode)) {
+        log_numa.fatal() << "unknown -numa:hugepages mode '" << cfg_hugepages
+                         << "' - must be off, thp, or explicit";
+        assert(false);
+      }
     }
 
     ////////////////////////////////////////////////////////////////////////
@@ -251,14 +260,22 @@ namespace Realm {
 	  ++it) {
 	size_t mem_size = numa_mem_sizes[it->first];
 	assert(mem_size > 0);
+	NumaHugePageMode hugepages = NUMA_HUGEPAGES_OFF;
+	numasysif_parse_hugepage_mode(config->cfg_hugepages, hugepages);
 	void *base = numasysif_alloc_mem(it->first,
 					 mem_size,
-					 config->cfg_pin_memory);
+					 config->cfg_pin_memory,
+					 hugepages);
 	if(!base) {
 	  log_numa.fatal() << "allocation of " << mem_size << " bytes in NUMA node " << it->first << " failed!";
 	  assert(false);
 	}
 	it->second = base;
+
+	// fault the pages in now, from threads running in the same NUMA node
+	if(config->cfg_prefault_threads > 0)
+	  numasysif_prefault_mem(it->first, base, mem_size,
+				 config->cfg_prefault_threads);
       }
     }
 
@@ -40,6 +40,8 @@ namespace Realm {
       int cfg_num_numa_cpus = 0;
       bool cfg_pin_memory = false;
       size_t cfg_stack_size = 2 << 20;
+      std::string cfg_hugepages = "off";
+      int cfg_prefault_threads = 0;
 
       // resources
       bool resource_discovered = false;
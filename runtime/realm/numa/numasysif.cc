@@ -21,6 +21,8 @@
 #include "realm/numa/numasysif.h"
 
 #include "realm/logging.h"
+#include "realm/mutex.h"
+#include "realm/timers.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -28,6 +30,7 @@
 #include <errno.h>
 
 #include <vector>
+#include <thread>
 
 #ifdef REALM_ON_LINUX
 #include <alloca.h>
@@ -87,8 +90,93 @@ namespace Realm {
 	return true;
     return false;
   }
+
+  namespace {
+    // explicit huge page mappings have to be unmapped with their rounded-up
+    //  length, so remember what we actually mapped
+    Mutex hugetlb_mutex;
+    std::map<void *, size_t> hugetlb_lengths;
+  };
+
+  // returns the default huge page size from /proc/meminfo (2MB if unknown)
+  static size_t get_huge_page_size(void)
+  {
+    static size_t huge_page_size = 0;
+    if(huge_page_size != 0)
+      return huge_page_size;
+
+    size_t size = 2 << 20;
+    FILE *f = fopen("/proc/meminfo", "r");
+    if(f) {
+      char line[256];
+      while(fgets(line, 256, f)) {
+        long long kb;
+        if(sscanf(line, "Hugepagesize: %lld kB", &kb) == 1) {
+          size = kb << 10;
+          break;
+        }
+      }
+      fclose(f);
+    }
+    huge_page_size = size;
+    return size;
+  }
+
+  // fills in the cpus that belong to a NUMA node (and are in our affinity mask)
+  static bool get_node_cpus(int node, cpu_set_t& cpus)
+  {
+    cpu_set_t avail_cpus;
+    if(sched_getaffinity(0, sizeof(avail_cpus), &avail_cpus) != 0) {
+      log_numa.error() << "sched_getaffinity failed: " << strerror(errno);
+      return false;
+    }
+
+    char fname[80];
+    snprintf(fname, sizeof fname, "/sys/devices/system/node/node%d/cpulist", node);
+    FILE *f = fopen(fname, "r");
+    if(!f) {
+      log_numa.error() << "can't read '" << fname << "': " << strerror(errno);
+      return false;
+    }
+    char line[1024];
+    bool ok = (fgets(line, sizeof line, f) != 0);
+    fclose(f);
+    if(!ok)
+      return false;
+
+    // cpulist is a comma-separated list of ranges, e.g. "0-7,16-23"
+    CPU_ZERO(&cpus);
+    const char *p = line;
+    while(isdigit(*p)) {
+      char *endptr;
+      int lo = strtol(p, &endptr, 10);
+      int hi = lo;
+      if(*endptr == '-')
+        hi = strtol(endptr + 1, &endptr, 10);
+      for(int i = lo; (i <= hi) && (i < CPU_SETSIZE); i++)
+        if(CPU_ISSET(i, &avail_cpus))
+          CPU_SET(i, &cpus);
+      p = endptr;
+      if(*p == ',')
+        p++;
+    }
+    return (CPU_COUNT(&cpus) > 0);
+  }
 #endif
 
+  bool numasysif_parse_hugepage_mode(const std::string& s, NumaHugePageMode& mode)
+  {
+    if(s == "off")
+      mode = NUMA_HUGEPAGES_OFF;
+    else if(s == "thp")
+      mode = NUMA_HUGEPAGES_THP;
+    else if(s == "explicit")
+      mode = NUMA_HUGEPAGES_EXPLICIT;
+    else
+      return false;
+    return true;
+  }
+
   // is NUMA support available in the system?
   bool numasysif_numa_available(void)
   {
@@ -361,23 +449,76 @@ namespace Realm {
 #endif
   }
 
-  // allocate memory on a given NUMA node - pin if requested
-  void *numasysif_alloc_mem(int node, size_t bytes, bool pin)
+  // allocate memory on a given NUMA node (or with no placement if node < 0) -
+  //  pin if requested, and back with huge pages if requested
+  void *numasysif_alloc_mem(int node, size_t bytes, bool pin,
+                            NumaHugePageMode hugepages /*= NUMA_HUGEPAGES_OFF*/)
   {
 #ifdef REALM_ON_LINUX
-    // get memory from mmap
-    // TODO: hugetlbfs, if possible
-    void *base = mmap(0,
-		      bytes, 
-		      PROT_READ | PROT_WRITE,
-		      MAP_PRIVATE | MAP_ANONYMOUS,
-		      -1,
-		      0);
-    if(!base) return 0;
-
-    // use the bind call for the rest
-    if(numasysif_bind_mem(node, base, bytes, pin))
-      return base;
+    void *base = MAP_FAILED;
+    size_t mapped_bytes = bytes;
+
+    if(hugepages == NUMA_HUGEPAGES_EXPLICIT) {
+      // MAP_HUGETLB lengths must be a multiple of the huge page size
+      size_t hpsize = get_huge_page_size();
+      mapped_bytes = ((bytes + hpsize - 1) / hpsize) * hpsize;
+      base = mmap(0,
+                  mapped_bytes,
+                  PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                  -1,
+                  0);
+      if(base != MAP_FAILED) {
+        AutoLock<> al(hugetlb_mutex);
+        hugetlb_lengths[base] = mapped_bytes;
+      } else {
+        log_numa.warning() << "explicit huge page allocation of " << bytes
+                           << " bytes failed (" << strerror(errno)
+                           << ") - falling back to transparent huge pages";
+        hugepages = NUMA_HUGEPAGES_THP;
+        mapped_bytes = bytes;
+      }
+    }
+
+    if(base == MAP_FAILED) {
+      // transparent huge pages can only back huge-page-aligned ranges, so
+      //  over-allocate and trim the ends
+      size_t align = ((hugepages == NUMA_HUGEPAGES_THP) ?
+                        get_huge_page_size() : 0);
+      size_t pgsize = sysconf(_SC_PAGESIZE);
+      size_t padded = ((bytes + pgsize - 1) / pgsize) * pgsize;
+      char *raw = static_cast<char *>(mmap(0,
+                                           padded + align,
+                                           PROT_READ | PROT_WRITE,
+                                           MAP_PRIVATE | MAP_ANONYMOUS,
+                                           -1,
+                                           0));
+      if(raw == MAP_FAILED) return 0;
+
+      char *aligned = raw;
+      if(align > 0) {
+        aligned = reinterpret_cast<char *>((reinterpret_cast<uintptr_t>(raw) + align - 1) &
+                                           ~uintptr_t(align - 1));
+        if(aligned > raw)
+          munmap(raw, aligned - raw);
+        if((raw + padded + align) > (aligned + padded))
+          munmap(aligned + padded, (raw + padded + align) - (aligned + padded));
+
+        if(madvise(aligned, padded, MADV_HUGEPAGE) != 0)
+          log_numa.warning() << "madvise(MADV_HUGEPAGE) failed: " << strerror(errno);
+      }
+      base = aligned;
+    }
+
+    // use the bind call for placement and pinning
+    if(node >= 0) {
+      if(numasysif_bind_mem(node, base, mapped_bytes, pin))
+        return base;
+    } else {
+      if(!pin || (mlock(base, mapped_bytes) == 0))
+        return base;
+      log_numa.error() << "mlock failed for " << bytes << " bytes: " << strerror(errno);
+    }
 
     // if not, clean up and return failure
     numasysif_free_mem(node, base, bytes);
@@ -391,6 +532,14 @@ namespace Realm {
   bool numasysif_free_mem(int node, void *base, size_t bytes)
   {
 #ifdef REALM_ON_LINUX
+    {
+      AutoLock<> al(hugetlb_mutex);
+      std::map<void *, size_t>::iterator it = hugetlb_lengths.find(base);
+      if(it != hugetlb_lengths.end()) {
+        bytes = it->second;
+        hugetlb_lengths.erase(it);
+      }
+    }
     int ret = munmap(base, bytes);
     return(ret == 0);
 #else
@@ -438,4 +587,56 @@ namespace Realm {
 #endif
   }
 
+  // touch every page of already-allocated memory from threads restricted to
+  //  the given node's cpus - the memory's contents are zeroed
+  bool numasysif_prefault_mem(int node, void *base, size_t bytes, int num_threads)
+  {
+#ifdef REALM_ON_LINUX
+    if(bytes == 0)
+      return true;
+
+    cpu_set_t node_cpus;
+    bool restrict_cpus = false;
+    if(node >= 0) {
+      restrict_cpus = get_node_cpus(node, node_cpus);
+      if(!restrict_cpus)
+        log_numa.warning() << "no cpus found for node " << node
+                           << " - prefaulting without affinity";
+    }
+
+    size_t pgsize = sysconf(_SC_PAGESIZE);
+    size_t num_pages = (bytes + pgsize - 1) / pgsize;
+    if(num_threads < 1)
+      num_threads = 1;
+    if(size_t(num_threads) > num_pages)
+      num_threads = num_pages;
+
+    long long t_start = Clock::current_time_in_microseconds();
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for(int i = 0; i < num_threads; i++) {
+      size_t first = (num_pages * i) / num_threads;
+      size_t last = (num_pages * (i + 1)) / num_threads;
+      threads.emplace_back([=]() {
+        if(restrict_cpus)
+          sched_setaffinity(0, sizeof(node_cpus), &node_cpus);
+        volatile char *p = static_cast<char *>(base);
+        for(size_t pg = first; pg < last; pg++)
+          p[pg * pgsize] = 0;
+      });
+    }
+    for(std::thread& t : threads)
+      t.join();
+
+    long long t_end = Clock::current_time_in_microseconds();
+    log_numa.info() << "prefaulted " << bytes << " bytes on node " << node
+                    << " with " << num_threads << " threads in " << (t_end - t_start)
+                    << " us";
+    return true;
+#else
+    return false;
+#endif
+  }
+
 };
@@ -25,6 +25,7 @@
 
 #include <stdlib.h>
 #include <map>
+#include <string>
 
 namespace Realm {
 
@@ -53,8 +54,21 @@ namespace Realm {
   //  per hop
   int numasysif_get_distance(int node1, int node2);
 
-  // allocate memory on a given NUMA node - pin if requested
-  void *numasysif_alloc_mem(int node, size_t bytes, bool pin);
+  // page size backing for an allocation
+  enum NumaHugePageMode {
+    NUMA_HUGEPAGES_OFF,       // normal pages
+    NUMA_HUGEPAGES_THP,       // transparent huge pages, via madvise
+    NUMA_HUGEPAGES_EXPLICIT,  // preallocated hugetlbfs pages, via MAP_HUGETLB
+  };
+
+  // parses "off", "thp", or "explicit" - returns false for anything else
+  bool numasysif_parse_hugepage_mode(const std::string& s, NumaHugePageMode& mode);
+
+  // allocate memory on a given NUMA node (or with no placement if node < 0) -
+  //  pin if requested, and back with huge pages if requested (an explicit
+  //  request that cannot be satisfied falls back to transparent huge pages)
+  void *numasysif_alloc_mem(int node, size_t bytes, bool pin,
+                            NumaHugePageMode hugepages = NUMA_HUGEPAGES_OFF);
 
   // free memory allocated on a given NUMA node
   bool numasysif_free_mem(int node, void *base, size_t bytes);
@@ -63,6 +77,12 @@ namespace Realm {
   // may fail if the memory has already been touched
   bool numasysif_bind_mem(int node, void *base, size_t bytes, bool pin);
 
+  // touch every page of already-allocated memory using 'num_threads' threads
+  //  that are restricted to the cpus of the given node (unless node < 0), so
+  //  that page faults (and first-touch placement) happen now instead of in
+  //  the application's first kernels
+  bool numasysif_prefault_mem(int node, void *base, size_t bytes, int num_threads);
+
 };
 
 #endif
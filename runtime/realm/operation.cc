@@ -32,6 +32,7 @@ namespace Realm {
                        const ProfilingRequestSet &_requests)
     : finish_event(_finish_event)
     , finish_gen(_finish_gen)
+    , completion_notifier(0)
     , refcount(1)
     , state(ProfilingMeasurements::OperationStatus::WAITING)
     , requests(_requests)
@@ -49,7 +50,8 @@ namespace Realm {
         measurements.wants_measurement<ProfilingMeasurements::OperationEventWaits>();
     if(wants_timeline)
       timeline.record_create_time();
-    _finish_event->set_trigger_op(_finish_gen, this);
+    if(_finish_event)
+      _finish_event->set_trigger_op(_finish_gen, this);
   }
 
   Operation::~Operation(void)
@@ -295,14 +297,23 @@ namespace Realm {
 
   void Operation::trigger_finish_event(bool poisoned)
   {
-    if(finish_event) {
+    bool has_finish_event = (finish_event != 0);
+    if(has_finish_event) {
       // don't spend a long time here triggering events
       finish_event->trigger(finish_gen, Network::my_node_id, poisoned,
 			    TimeLimit::responsive());
+    } else if(completion_notifier) {
+      // the notifier may be freed by this call, so don't touch it again
+      completion_notifier->operation_completed(poisoned);
     }
-#ifndef REALM_USE_OPERATION_TABLE
+#ifdef REALM_USE_OPERATION_TABLE
+    // the finish event drops the creation reference when it triggers, but
+    //  an operation without one (e.g. a static subgraph task that reports
+    //  through a completion notifier) has nobody else to do it
+    if(!has_finish_event)
+      remove_reference();
+#else
     // no operation table to decrement the refcount, so do it ourselves
-    // SJT: should this always be done for operations without finish events?
     remove_reference();
 #endif
   }
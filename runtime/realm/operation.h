@@ -93,6 +93,22 @@ namespace Realm {
     //  the operation)
     void add_async_work_item(AsyncWorkItem *item);
 
+    // operations created without a finish event (e.g. tasks launched by a
+    //  precompiled subgraph) can instead be given a notifier that is told
+    //  directly when the operation completes
+    class CompletionNotifier {
+    public:
+      virtual ~CompletionNotifier(void) {}
+
+      virtual void operation_completed(bool poisoned) = 0;
+
+      // event reported as the finish event of the operation
+      virtual Event get_finish_event(void) const = 0;
+    };
+
+    // must be called before the operation is enqueued
+    void set_completion_notifier(CompletionNotifier *_notifier);
+
     // used to record event wait intervals, if desired
     ProfilingMeasurements::OperationEventWaits::WaitInterval *create_wait_interval(Event e);
 
@@ -114,6 +130,7 @@ namespace Realm {
 
     GenEventImpl *finish_event;
     EventImpl::gen_t finish_gen;
+    CompletionNotifier *completion_notifier;
     atomic<int> refcount;
   public:
     Event get_finish_event(void) const;
@@ -77,7 +77,18 @@ namespace Realm {
 
   inline Event Operation::get_finish_event(void) const
   {
-    return finish_event->make_event(finish_gen);
+    if(finish_event)
+      return finish_event->make_event(finish_gen);
+    else if(completion_notifier)
+      return completion_notifier->get_finish_event();
+    else
+      return Event::NO_EVENT;
+  }
+
+  inline void Operation::set_completion_notifier(CompletionNotifier *_notifier)
+  {
+    assert(finish_event == 0);
+    completion_notifier = _notifier;
   }
 
   // used to record event wait intervals, if desired
@@ -16,6 +16,8 @@
 // implementation of profiling stuff for Realm
 
 #include "realm/profiling.h"
+#include "realm/profiling_impl.h"
+#include "realm/runtime_impl.h"
 
 namespace Realm {
 
@@ -31,6 +33,7 @@ namespace Realm {
     : response_proc(_response_proc), response_task_id(_response_task_id)
     , priority(_priority)
     , report_if_empty(_report_if_empty)
+    , batchable(false)
   {}
 
   ProfilingRequest::ProfilingRequest(const ProfilingRequest& to_copy)
@@ -38,6 +41,7 @@ namespace Realm {
     , response_task_id(to_copy.response_task_id)
     , priority(to_copy.priority)
     , report_if_empty(to_copy.report_if_empty)
+    , batchable(to_copy.batchable)
     , user_data(to_copy.user_data)
     , requested_measurements(to_copy.requested_measurements)
   {
@@ -53,6 +57,7 @@ namespace Realm {
     response_task_id = rhs.response_task_id;
     priority = rhs.priority;
     report_if_empty = rhs.report_if_empty;
+    batchable = rhs.batchable;
     requested_measurements = rhs.requested_measurements;
     user_data = rhs.user_data;
     return *this;
@@ -244,9 +249,16 @@ namespace Realm {
     }
 
     assert((size_t)(data - payload) == bytes_needed);
-    
-    pr.response_proc.spawn(pr.response_task_id, payload, bytes_needed,
-			   Event::NO_EVENT, pr.priority);
+
+    // batchable responses go to the batcher, which copies the payload, unless
+    //  batching is disabled
+    if(!pr.batchable ||
+       !get_runtime()->profiling_batcher.add_response(pr.response_proc,
+						      pr.response_task_id,
+						      pr.priority,
+						      payload, bytes_needed))
+      pr.response_proc.spawn(pr.response_task_id, payload, bytes_needed,
+			     Event::NO_EVENT, pr.priority);
       
     free(payload);
   }
@@ -357,4 +369,49 @@ namespace Realm {
     return false;
   }
 
+
+  ////////////////////////////////////////////////////////////////////////
+  //
+  // class ProfilingResponseBatch
+  //
+
+  ProfilingResponseBatch::ProfilingResponseBatch(const void *_data,
+						 size_t _data_size)
+    : data(static_cast<const char *>(_data)), data_size(_data_size)
+  {
+    const int *idata = static_cast<const int *>(_data);
+
+    if(idata[0] == BATCH_MARKER) {
+      count = idata[1];
+      offsets = reinterpret_cast<const uint64_t *>(data + 2 * sizeof(int));
+      assert((2 * sizeof(int) + 2 * count * sizeof(uint64_t)) <= data_size);
+    } else {
+      // an ordinary response
+      count = 1;
+      offsets = 0;
+    }
+  }
+
+  ProfilingResponseBatch::~ProfilingResponseBatch(void)
+  {
+    // nothing to free - we didn't own the data
+  }
+
+  size_t ProfilingResponseBatch::size(void) const
+  {
+    return count;
+  }
+
+  const void *ProfilingResponseBatch::response_data(size_t index) const
+  {
+    assert(index < count);
+    return (offsets ? (data + offsets[index]) : data);
+  }
+
+  size_t ProfilingResponseBatch::response_size(size_t index) const
+  {
+    assert(index < count);
+    return (offsets ? offsets[count + index] : data_size);
+  }
+
 }; // namespace Realm
@@ -336,6 +336,12 @@ namespace Realm {
     ProfilingRequest &add_measurement(ProfilingMeasurementID measurement_id);
     ProfilingRequest &add_measurements(const std::set<ProfilingMeasurementID>& measurement_ids);
 
+    // allows the response to this request to be delivered together with
+    //  other responses headed to the same processor and task (only takes
+    //  effect when batching is enabled with -ll:prof_batch) - the response
+    //  task must then decode its arguments with a ProfilingResponseBatch
+    ProfilingRequest &allow_batching(bool _batchable = true);
+
     template <typename S> static ProfilingRequest *deserialize_new(S &s);
 
   protected:
@@ -347,6 +353,7 @@ namespace Realm {
     Processor::TaskFuncID response_task_id;
     int priority;
     bool report_if_empty;
+    bool batchable;
     ByteArray user_data;
     std::set<ProfilingMeasurementID> requested_measurements;
   };
@@ -447,6 +454,32 @@ namespace Realm {
     bool find_id(int id, int& offset, int& size) const;
   };
 
+  // a response task for requests that allow batching may receive many
+  //  responses in a single argument buffer - this splits them back up (a
+  //  buffer holding a single, unbatched response is a batch of one)
+  class REALM_PUBLIC_API ProfilingResponseBatch {
+  public:
+    ProfilingResponseBatch(const void *_data, size_t _data_size);
+    ~ProfilingResponseBatch(void);
+
+    // a batched buffer starts with this value where a single response would
+    //  have its (non-negative) measurement count
+    static const int BATCH_MARKER = -1;
+
+    size_t size(void) const;
+
+    // location of an individual response, suitable for constructing a
+    //  ProfilingResponse
+    const void *response_data(size_t index) const;
+    size_t response_size(size_t index) const;
+
+  protected:
+    const char *data;
+    size_t data_size;
+    size_t count;
+    const uint64_t *offsets;
+  };
+
 }; // namespace Realm
 
 #include "realm/profiling.inl"
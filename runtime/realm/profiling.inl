@@ -279,6 +279,12 @@ namespace Realm {
     return *this;
   }
 
+  inline ProfilingRequest &ProfilingRequest::allow_batching(bool _batchable /*= true*/)
+  {
+    batchable = _batchable;
+    return *this;
+  }
+
   template <typename S>
   bool serialize(S &s, const ProfilingRequest &pr)
   {
@@ -286,6 +292,7 @@ namespace Realm {
 	   (s << pr.response_task_id) &&
 	   (s << pr.priority) &&
 	   (s << pr.report_if_empty) &&
+	   (s << pr.batchable) &&
 	   (s << pr.user_data) &&
 	   (s << pr.requested_measurements));
   }
@@ -298,12 +305,15 @@ namespace Realm {
     Processor::TaskFuncID fid;
     int priority;
     bool report_if_empty;
+    bool batchable;
     if(!(s >> p)) return 0;
     if(!(s >> fid)) return 0;
     if(!(s >> priority)) return 0;
     if(!(s >> report_if_empty)) return 0;
+    if(!(s >> batchable)) return 0;
     ProfilingRequest *pr = new ProfilingRequest(p, fid,
 						priority, report_if_empty);
+    pr->batchable = batchable;
     if(!(s >> pr->user_data) ||
        !(s >> pr->requested_measurements)) {
       delete pr;
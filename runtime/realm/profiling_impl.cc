@@ -0,0 +1,259 @@
+/* Copyright 2024 Stanford University, NVIDIA Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// batched delivery of profiling responses
+
+#include "realm/profiling_impl.h"
+#include "realm/timers.h"
+
+#include <string.h>
+#include <algorithm>
+
+namespace Realm {
+
+  namespace Config {
+    int profiling_batch_count = 0;
+    size_t profiling_batch_bytes = 64 << 10;
+    long long profiling_batch_delay = 1000;
+  };
+
+
+  ////////////////////////////////////////////////////////////////////////
+  //
+  // class ProfilingResponseBatcher
+  //
+
+  bool ProfilingResponseBatcher::BatchKey::operator<(const BatchKey& rhs) const
+  {
+    if(proc != rhs.proc) return (proc < rhs.proc);
+    if(task_id != rhs.task_id) return (task_id < rhs.task_id);
+    return (priority < rhs.priority);
+  }
+
+  void ProfilingResponseBatcher::PendingBatch::swap(PendingBatch& other)
+  {
+    std::swap(first_time, other.first_time);
+    offsets.swap(other.offsets);
+    sizes.swap(other.sizes);
+    records.swap(other.records);
+  }
+
+  ProfilingResponseBatcher::ProfilingResponseBatcher(void)
+    : BackgroundWorkItem("profiling batcher")
+    , condvar(mutex)
+    , active(false)
+    , accepting(true)
+    , timer_exit(false)
+    , next_due(0)
+  {}
+
+  ProfilingResponseBatcher::~ProfilingResponseBatcher(void)
+  {
+    assert(!timer.joinable());
+  }
+
+  bool ProfilingResponseBatcher::batching_enabled(void) const
+  {
+    return (Config::profiling_batch_count > 1);
+  }
+
+  void ProfilingResponseBatcher::start(BackgroundWorkManager *manager)
+  {
+    add_to_manager(manager);
+    timer = std::thread(&ProfilingResponseBatcher::timer_loop, this);
+  }
+
+  void ProfilingResponseBatcher::shutdown(void)
+  {
+    {
+      AutoLock<KernelMutex> al(mutex);
+      accepting = false;
+    }
+    flush_all();
+    {
+      AutoLock<KernelMutex> al(mutex);
+      timer_exit = true;
+      condvar.broadcast();
+    }
+    if(timer.joinable())
+      timer.join();
+    // a do_work that was already queued still has to run (and will find
+    //  nothing to do) before the work item is really idle
+    AutoLock<KernelMutex> al(mutex);
+    while(active)
+      condvar.wait();
+  }
+
+  bool ProfilingResponseBatcher::add_response(Processor proc,
+					      Processor::TaskFuncID task_id,
+					      int priority,
+					      const void *data, size_t size)
+  {
+    if(!batching_enabled())
+      return false;
+    // a response that fills a batch by itself gains nothing from waiting
+    if(size >= Config::profiling_batch_bytes)
+      return false;
+
+    BatchKey key;
+    key.proc = proc;
+    key.task_id = task_id;
+    key.priority = priority;
+
+    PendingBatch to_send;
+    bool send = false;
+    {
+      AutoLock<KernelMutex> al(mutex);
+      if(!accepting)
+	return false;
+      PendingBatch& batch = batches[key];
+      if(batch.offsets.empty())
+	batch.first_time = Clock::current_time_in_microseconds();
+      size_t offset = batch.records.size();
+      batch.offsets.push_back(offset);
+      batch.sizes.push_back(size);
+      batch.records.resize(offset + ((size + 7) & ~size_t(7)));
+      memcpy(&batch.records[offset], data, size);
+
+      if((batch.offsets.size() >= size_t(Config::profiling_batch_count)) ||
+	 (batch.records.size() >= Config::profiling_batch_bytes)) {
+	to_send.swap(batch);
+	batches.erase(key);
+	send = true;
+      }
+
+      arm_timer();
+    }
+
+    if(send)
+      send_batch(key, to_send);
+    return true;
+  }
+
+  void ProfilingResponseBatcher::arm_timer(void)
+  {
+    // a running do_work re-arms the timer for whatever it leaves behind
+    if(active || batches.empty())
+      return;
+    long long oldest = batches.begin()->second.first_time;
+    for(std::map<BatchKey, PendingBatch>::const_iterator it = batches.begin();
+	it != batches.end();
+	++it)
+      oldest = std::min(oldest, it->second.first_time);
+    long long due = oldest + Config::profiling_batch_delay;
+    if((next_due == 0) || (due < next_due)) {
+      next_due = due;
+      condvar.broadcast();
+    }
+  }
+
+  void ProfilingResponseBatcher::timer_loop(void)
+  {
+    AutoLock<KernelMutex> al(mutex);
+    while(!timer_exit) {
+      if(next_due == 0) {
+	condvar.wait();
+	continue;
+      }
+      long long now = Clock::current_time_in_microseconds();
+      if(now < next_due) {
+	condvar.timedwait(1000 * (next_due - now));
+	continue;
+      }
+      next_due = 0;
+      if(!active) {
+	active = true;
+	// make_active may run do_work right here, so drop the lock first
+	mutex.unlock();
+	make_active();
+	mutex.lock();
+      }
+    }
+  }
+
+  void ProfilingResponseBatcher::flush_all(void)
+  {
+    std::map<BatchKey, PendingBatch> to_send;
+    {
+      AutoLock<KernelMutex> al(mutex);
+      to_send.swap(batches);
+      next_due = 0;
+    }
+    for(std::map<BatchKey, PendingBatch>::const_iterator it = to_send.begin();
+	it != to_send.end();
+	++it)
+      send_batch(it->first, it->second);
+  }
+
+  bool ProfilingResponseBatcher::do_work(TimeLimit work_until)
+  {
+    std::map<BatchKey, PendingBatch> to_send;
+    {
+      AutoLock<KernelMutex> al(mutex);
+      long long cutoff = (Clock::current_time_in_microseconds() -
+			  Config::profiling_batch_delay);
+      std::map<BatchKey, PendingBatch>::iterator it = batches.begin();
+      while(it != batches.end()) {
+	if(it->second.first_time <= cutoff) {
+	  to_send[it->first].swap(it->second);
+	  batches.erase(it++);
+	} else
+	  ++it;
+      }
+    }
+
+    for(std::map<BatchKey, PendingBatch>::const_iterator it = to_send.begin();
+	it != to_send.end();
+	++it)
+      send_batch(it->first, it->second);
+
+    // never requeue ourselves - anything that isn't due yet gets the timer
+    //  armed for it instead, so that an idle batcher doesn't spin
+    AutoLock<KernelMutex> al(mutex);
+    active = false;
+    arm_timer();
+    condvar.broadcast();
+    return false;
+  }
+
+  /*static*/ void ProfilingResponseBatcher::send_batch(const BatchKey& key,
+						       const PendingBatch& batch)
+  {
+    // layout: marker, count, then the offset and size of each record
+    //  (relative to the start of the buffer), then the records themselves
+    size_t count = batch.offsets.size();
+    size_t header_bytes = (2 * sizeof(int)) + (2 * count * sizeof(uint64_t));
+    size_t total_bytes = header_bytes + batch.records.size();
+
+    char *payload = (char *)malloc(total_bytes);
+    assert(payload != 0);
+
+    int *header = (int *)payload;
+    header[0] = ProfilingResponseBatch::BATCH_MARKER;
+    header[1] = count;
+    uint64_t *offsets = (uint64_t *)(payload + (2 * sizeof(int)));
+    for(size_t i = 0; i < count; i++) {
+      offsets[i] = header_bytes + batch.offsets[i];
+      offsets[count + i] = batch.sizes[i];
+    }
+    memcpy(payload + header_bytes, batch.records.data(), batch.records.size());
+
+    key.proc.spawn(key.task_id, payload, total_bytes,
+		   Event::NO_EVENT, key.priority);
+
+    free(payload);
+  }
+
+}; // namespace Realm
@@ -0,0 +1,107 @@
+/* Copyright 2024 Stanford University, NVIDIA Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// batched delivery of profiling responses
+
+#ifndef REALM_PROFILING_IMPL_H
+#define REALM_PROFILING_IMPL_H
+
+#include "realm/profiling.h"
+#include "realm/bgwork.h"
+#include "realm/mutex.h"
+
+#include <thread>
+
+namespace Realm {
+
+  namespace Config {
+    // maximum number of responses delivered by a single response task
+    //  (0 or 1 disables batching)
+    extern int profiling_batch_count;
+
+    // a batch is also sent once its records reach this many bytes
+    extern size_t profiling_batch_bytes;
+
+    // and no response waits in a batch for longer than this (in us)
+    extern long long profiling_batch_delay;
+  };
+
+  // collects responses for requests that allow batching and delivers them
+  //  to their response task in groups, flushing a group by count, by size,
+  //  or once its oldest response has waited long enough
+  class ProfilingResponseBatcher : public BackgroundWorkItem {
+  public:
+    ProfilingResponseBatcher(void);
+    virtual ~ProfilingResponseBatcher(void);
+
+    bool batching_enabled(void) const;
+
+    // registers with the background work manager and starts the timer
+    //  thread that wakes the batcher when the oldest batch is due
+    void start(BackgroundWorkManager *manager);
+
+    // stops accepting new responses, sends every pending batch and waits
+    //  for the batcher to go idle - after this it will never be activated
+    //  again, so it is safe to shut down the work item
+    void shutdown(void);
+
+    // returns false if the response was not accepted, in which case the
+    //  caller must deliver it on its own
+    bool add_response(Processor proc, Processor::TaskFuncID task_id,
+		      int priority, const void *data, size_t size);
+
+    // sends every pending batch immediately
+    void flush_all(void);
+
+    virtual bool do_work(TimeLimit work_until);
+
+  protected:
+    struct BatchKey {
+      Processor proc;
+      Processor::TaskFuncID task_id;
+      int priority;
+
+      bool operator<(const BatchKey& rhs) const;
+    };
+
+    struct PendingBatch {
+      long long first_time;
+      std::vector<uint64_t> offsets;  // of each record in 'records'
+      std::vector<uint64_t> sizes;    // of each record without padding
+      std::vector<char> records;      // each record is padded to 8 bytes
+
+      void swap(PendingBatch& other);
+    };
+
+    static void send_batch(const BatchKey& key, const PendingBatch& batch);
+
+    // must hold 'mutex' - makes sure the timer will fire by the time the
+    //  oldest pending batch is due (unless do_work is already going to)
+    void arm_timer(void);
+    void timer_loop(void);
+
+    KernelMutex mutex;
+    KernelMutex::CondVar condvar;
+    std::map<BatchKey, PendingBatch> batches;
+    bool active;           // do_work is queued or running
+    bool accepting;        // false once shutdown has started
+    bool timer_exit;
+    long long next_due;    // when the timer should wake us (0 = not armed)
+    std::thread timer;
+  };
+
+}; // namespace Realm
+
+#endif // ifdef REALM_PROFILING_IMPL_H
@@ -39,6 +39,12 @@
 #define REALM_USE_USER_THREADS
 #endif
 
+// if set, user threads switch with a hand-written register save/restore
+//  instead of swapcontext, which avoids a sigprocmask syscall per switch
+#if defined(REALM_USE_USER_THREADS) && (defined(REALM_ON_LINUX) || defined(REALM_ON_FREEBSD)) && (defined(__x86_64__) || defined(__aarch64__))
+#define REALM_USE_FAST_USWITCH
+#endif
+
 // if set, uses Linux's kernel-level io_submit interface, otherwise uses
 //  POSIX AIO for async file I/O
 #ifdef REALM_ON_LINUX
@@ -71,14 +77,12 @@
 #endif
 
 // ASAN has issues with thread local destructors, so disable this path for asan
-// Temporarily disable the caching allocator until it is debugged
-// TODO: reenable this
-#define REALM_USE_CACHING_ALLOCATOR 0
 #if !defined(REALM_USE_CACHING_ALLOCATOR) && !defined(ASAN_ENABLED)
   #define REALM_USE_CACHING_ALLOCATOR 1
-  #ifndef REALM_TASK_BLOCK_SIZE
-    #define REALM_TASK_BLOCK_SIZE (128ULL*1024ULL)
-  #endif
+#endif
+// number of Task objects carved out of each caching allocator block
+#if REALM_USE_CACHING_ALLOCATOR && !defined(REALM_TASK_BLOCK_SIZE)
+  #define REALM_TASK_BLOCK_SIZE 256
 #endif
 
 #if defined(REALM_USE_SHM)
@@ -112,6 +116,9 @@ namespace Realm {
     // if true, worker threads that might have used user-level thread switching
     //  fall back to kernel threading
     extern bool force_kernel_threads;
+    // if true, user thread switches use swapcontext, which saves and restores
+    //  the signal mask, even when a faster switch is available
+    extern bool preserve_uswitch_sigmask;
     // Unique identifier for the job assigned to this instance of the machine.  Useful
     // when dealing with named system resources while running parallel jobs on the same
     // machine
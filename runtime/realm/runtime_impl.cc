@@ -21,6 +21,7 @@
 #include "realm/mem_impl.h"
 #include "realm/inst_impl.h"
 #include "realm/transfer/ib_memory.h"
+#include "realm/numa/numasysif.h"
 
 #include "realm/activemsg.h"
 #include "realm/deppart/preimage.h"
@@ -30,6 +31,7 @@
 #include "realm/codedesc.h"
 
 #include "realm/utils.h"
+#include "realm/caching_allocator.h"
 
 // remote copy active messages from from lowlevel_dma.h for now
 #include "realm/transfer/lowlevel_dma.h"
@@ -184,6 +186,8 @@ namespace Realm {
       assert((signal == SIGINT) || (signal == SIGABRT) ||
              (signal == SIGSEGV) || (signal == SIGFPE) ||
              (signal == SIGBUS) || (signal == SIGILL));
+      // get out any log messages that are still sitting in buffers
+      Logger::flush_on_fault();
       int process_id = getpid();
       char hostname[128];
       gethostname(hostname, 127);
@@ -215,10 +219,11 @@ namespace Realm {
 	continue;
       GenEventImpl *e = events.lookup_entry(j, nodeid);
       AutoLock<> a2(e->mutex);
+      e->drain_current_waiters(e->generation.load() + 1);
 	
       // print anything with either local or remote waiters
       if(e->current_local_waiters.empty() &&
-	 e->future_local_waiters.empty() &&
+	 !e->has_future_waiters() &&
 	 e->remote_waiters.empty())
 	continue;
 
@@ -231,7 +236,7 @@ namespace Realm {
       os << "Event " << e->me <<": gen=" << gen
 	 << " subscr=" << e->gen_subscribed.load()
 	 << " local=" << clw_size //e->current_local_waiters.size()
-	 << "+" << e->future_local_waiters.size()
+	 << "+" << e->future_local_waiters.size() << " spilled"
 	 << " remote=" << e->remote_waiters.size() << "\n";
       for(EventWaiter *pos = e->current_local_waiters.head.next;
 	  pos;
@@ -240,6 +245,16 @@ namespace Realm {
 	pos/*(*it)*/->print(os);
 	os << "\n";
       }
+      for(EventImpl::gen_t g = gen + 2;
+	  g <= gen + 1 + GenEventImpl::FUTURE_WAITER_RING_SIZE;
+	  g++)
+	for(EventWaiter *pos = e->future_waiter_ring[g % GenEventImpl::FUTURE_WAITER_RING_SIZE].head.next;
+	    pos;
+	    pos = pos->ew_list_link.next) {
+	  os << "  [" << g << "] L:" << pos << " - ";
+	  pos->print(os);
+	  os << "\n";
+	}
       for(std::map<EventImpl::gen_t, EventWaiter::EventWaiterList>::const_iterator it = e->future_local_waiters.begin();
 	  it != e->future_local_waiters.end();
 	  it++) {
@@ -724,6 +739,33 @@ namespace Realm {
     }
 
 
+  // allocates memory with the requested huge page backing (faulting it in
+  //  with 'prefault_threads' threads, if non-zero) - returns null if huge pages
+  //  were not requested, in which case the caller allocates as usual
+  static void *alloc_hugepage_memory(const std::string& mode_name, size_t bytes,
+                                     int prefault_threads)
+  {
+    NumaHugePageMode mode = NUMA_HUGEPAGES_OFF;
+    numasysif_parse_hugepage_mode(mode_name, mode);
+    if(mode == NUMA_HUGEPAGES_OFF)
+      return nullptr;
+
+    // the core memories don't belong to any one NUMA node (they are created
+    //  with a "don't care" numa domain), so neither the allocation nor the
+    //  prefault threads are bound - per-node memories come from the numa
+    //  module, which places and prefaults them on their own node
+    const int no_numa_node = -1;
+    void *base = numasysif_alloc_mem(no_numa_node, bytes, false /*!pin*/, mode);
+    if(!base) {
+      log_runtime.fatal() << "huge page allocation of " << bytes << " bytes failed";
+      abort();
+    }
+    if(prefault_threads > 0)
+      numasysif_prefault_mem(no_numa_node, base, bytes, prefault_threads);
+    return base;
+  }
+
+
   ////////////////////////////////////////////////////////////////////////
   //
   // class CoreModule
@@ -733,6 +775,7 @@ namespace Realm {
     // if true, worker threads that might have used user-level thread switching
     //  fall back to kernel threading
     bool force_kernel_threads = false;
+    bool preserve_uswitch_sigmask = false;
     unsigned long long job_id = 0;
   };
 
@@ -890,7 +933,8 @@ static DWORD CountSetBits(ULONG_PTR bitMask)
       .add_option_bool("-ll:pin_util", pin_util_procs)
       .add_option_int("-ll:cpu_bgwork", cpu_bgwork_timeslice)
       .add_option_int("-ll:util_bgwork", util_bgwork_timeslice)
-      .add_option_int("-ll:ext_sysmem", use_ext_sysmem);
+      .add_option_int("-ll:ext_sysmem", use_ext_sysmem)
+      .add_option_string("-ll:csize_hugepages", sysmem_hugepages);
 
     // config for RuntimeImpl
     // low-level runtime parameters
@@ -907,6 +951,9 @@ static DWORD CountSetBits(ULONG_PTR bitMask)
     cp.add_option_int_units("-ll:rsize", reg_mem_size, 'm')
       .add_option_int_units("-ll:ib_rsize", reg_ib_mem_size, 'm')
       .add_option_int_units("-ll:dsize", disk_mem_size, 'm')
+      .add_option_string("-ll:rsize_hugepages", reg_mem_hugepages)
+      .add_option_string("-ll:ib_rsize_hugepages", reg_ib_mem_hugepages)
+      .add_option_int("-ll:hugepage_prefault", hugepage_prefault_threads)
       .add_option_int("-ll:dma", dma_worker_threads)
       .add_option_bool("-ll:pin_dma", pin_dma_threads)
       .add_option_int("-ll:dummy_rsrv_ok", dummy_reservation_ok)
@@ -941,6 +988,16 @@ static DWORD CountSetBits(ULONG_PTR bitMask)
       exit(1);
     }
 
+    {
+      NumaHugePageMode mode;
+      if(!numasysif_parse_hugepage_mode(sysmem_hugepages, mode) ||
+         !numasysif_parse_hugepage_mode(reg_mem_hugepages, mode) ||
+         !numasysif_parse_hugepage_mode(reg_ib_mem_hugepages, mode)) {
+        fprintf(stderr, "ERROR: huge page modes must be one of: off, thp, explicit\n");
+        exit(1);
+      }
+    }
+
 #ifndef EVENT_TRACING
     if(!event_trace_file.empty()) {
       fprintf(stderr, "WARNING: event tracing requested, but not enabled at compile time!\n");
@@ -963,6 +1020,7 @@ static DWORD CountSetBits(ULONG_PTR bitMask)
   CoreModule::CoreModule(void)
     : Module("core")
     , config(nullptr)
+    , sysmem_hugepage_base(nullptr)
   {}
 
   CoreModule::~CoreModule(void)
@@ -1002,9 +1060,24 @@ static DWORD CountSetBits(ULONG_PTR bitMask)
     MemoryImpl *sysmem;
     if(config->sysmem_size > 0) {
       Memory m = runtime->next_local_memory_id();
-      sysmem = new LocalCPUMemory(m, config->sysmem_size,
-                                  -1/*don't care numa domain*/,
-                                  Memory::SYSTEM_MEM);
+      sysmem_hugepage_base = alloc_hugepage_memory(config->sysmem_hugepages,
+                                                   config->sysmem_size,
+                                                   config->hugepage_prefault_threads);
+      if(sysmem_hugepage_base) {
+        // the memory hands this segment back from get_network_segment, so it
+        //  is registered along with the other memories' segments when the
+        //  networks attach
+        sysmem_segment.assign(NetworkSegmentInfo::HostMem, sysmem_hugepage_base,
+                              config->sysmem_size);
+        sysmem = new LocalCPUMemory(m, config->sysmem_size,
+                                    -1/*don't care numa domain*/,
+                                    Memory::SYSTEM_MEM,
+                                    sysmem_hugepage_base,
+                                    &sysmem_segment);
+      } else
+        sysmem = new LocalCPUMemory(m, config->sysmem_size,
+                                    -1/*don't care numa domain*/,
+                                    Memory::SYSTEM_MEM);
       runtime->add_memory(sysmem);
     } else
       sysmem = 0;
@@ -1093,7 +1166,10 @@ static DWORD CountSetBits(ULONG_PTR bitMask)
   //  after all memories/processors/etc. have been shut down and destroyed
   void CoreModule::cleanup(void)
   {
-    // nothing to clean up
+    if(sysmem_hugepage_base) {
+      numasysif_free_mem(-1, sysmem_hugepage_base, config->sysmem_size);
+      sysmem_hugepage_base = nullptr;
+    }
 
     Module::cleanup();
   }
@@ -1125,6 +1201,7 @@ static DWORD CountSetBits(ULONG_PTR bitMask)
 	sampling_profiler(true /*system default*/),
 	num_local_memories(0), num_local_ib_memories(0),
 	num_local_processors(0),
+	reg_ib_mem_hugepage_base(0), reg_mem_hugepage_base(0),
 	module_registrar(this),
         modules_created(false),
 	module_configs_created(false)
@@ -1784,11 +1861,17 @@ static DWORD CountSetBits(ULONG_PTR bitMask)
         CommandLineParser cp;
         cp.add_option_int("-realm:eventloopcheck", Config::event_loop_detection_limit);
         cp.add_option_bool("-ll:force_kthreads", Config::force_kernel_threads);
+        cp.add_option_bool("-ll:uswitch_sigmask", Config::preserve_uswitch_sigmask);
         cp.add_option_bool("-ll:frsrv_fallback", Config::use_fast_reservation_fallback);
         cp.add_option_int("-ll:machine_query_cache", Config::use_machine_query_cache);
         cp.add_option_int("-ll:defalloc", Config::deferred_instance_allocation);
         cp.add_option_int("-ll:amprofile", Config::profile_activemsg_handlers);
         cp.add_option_int("-ll:aminline", Config::max_inline_message_time);
+        cp.add_option_int("-ll:static_subgraphs", Config::static_subgraphs);
+        cp.add_option_int("-ll:partition_subgraphs", Config::partition_subgraphs);
+        cp.add_option_int("-ll:prof_batch", Config::profiling_batch_count);
+        cp.add_option_int_units("-ll:prof_batch_size", Config::profiling_batch_bytes, 'k');
+        cp.add_option_int("-ll:prof_batch_delay", Config::profiling_batch_delay);
         bool cmdline_ok = cp.parse_command_line(cmdline);
         if(!cmdline_ok) {
           fprintf(stderr, "ERROR: failure parsing command line options for Config\n");
@@ -1864,6 +1947,8 @@ static DWORD CountSetBits(ULONG_PTR bitMask)
 #endif
 
       event_triggerer.add_to_manager(&bgwork);
+      if(profiling_batcher.batching_enabled())
+        profiling_batcher.start(&bgwork);
 
       // initialize barrier timestamp
       BarrierImpl::barrier_adjustment_timestamp.store((((Barrier::timestamp_t)(Network::my_node_id)) << BarrierImpl::BARRIER_TIMESTAMP_NODEID_SHIFT) + 1);
@@ -1927,14 +2012,32 @@ static DWORD CountSetBits(ULONG_PTR bitMask)
       }
 
       // form requests for network-registered memory
+      // (memories that want huge pages are allocated here and handed to the
+      //  network to register instead)
       if(config->reg_ib_mem_size > 0) {
-	reg_ib_mem_segment.request(NetworkSegmentInfo::HostMem,
-				   config->reg_ib_mem_size, 64);
+	reg_ib_mem_hugepage_base = alloc_hugepage_memory(config->reg_ib_mem_hugepages,
+							 config->reg_ib_mem_size,
+							 config->hugepage_prefault_threads);
+	if(reg_ib_mem_hugepage_base)
+	  reg_ib_mem_segment.assign(NetworkSegmentInfo::HostMem,
+				    reg_ib_mem_hugepage_base,
+				    config->reg_ib_mem_size);
+	else
+	  reg_ib_mem_segment.request(NetworkSegmentInfo::HostMem,
+				     config->reg_ib_mem_size, 64);
 	network_segments.push_back(&reg_ib_mem_segment);
       }
       if(config->reg_mem_size > 0) {
-	reg_mem_segment.request(NetworkSegmentInfo::HostMem,
-				config->reg_mem_size, 64);
+	reg_mem_hugepage_base = alloc_hugepage_memory(config->reg_mem_hugepages,
+						      config->reg_mem_size,
+						      config->hugepage_prefault_threads);
+	if(reg_mem_hugepage_base)
+	  reg_mem_segment.assign(NetworkSegmentInfo::HostMem,
+				 reg_mem_hugepage_base,
+				 config->reg_mem_size);
+	else
+	  reg_mem_segment.request(NetworkSegmentInfo::HostMem,
+				  config->reg_mem_size, 64);
 	network_segments.push_back(&reg_mem_segment);
       }
 
@@ -2702,6 +2805,12 @@ static DWORD CountSetBits(ULONG_PTR bitMask)
       }
       log_runtime.info("shutdown request received - terminating");
 
+      // deliver any profiling responses still waiting in a batch before the
+      //  processors are flushed below - responses after this point are
+      //  delivered individually
+      if(profiling_batcher.batching_enabled())
+        profiling_batcher.shutdown();
+
       // we need a task to run on each processor to ensure anything that was
       //  running when the shutdown was initiated (e.g. the task that initiated
       //  the shutdown) has finished - in legacy mode this is the "shutdown"
@@ -2731,6 +2840,13 @@ static DWORD CountSetBits(ULONG_PTR bitMask)
         }
       }
 
+      log_runtime.info() << "caching allocator: block_allocs="
+                         << CachingAllocatorStats::get(CachingAllocatorStats::BLOCK_ALLOCS)
+                         << " block_reuses="
+                         << CachingAllocatorStats::get(CachingAllocatorStats::BLOCK_REUSES)
+                         << " oversize_allocs="
+                         << CachingAllocatorStats::get(CachingAllocatorStats::OVERSIZE_ALLOCS);
+
       // the operation tables on every rank should be clear of work
       optable.shutdown_check();
 
@@ -2799,8 +2915,22 @@ static DWORD CountSetBits(ULONG_PTR bitMask)
            it != network_modules.end(); it++)
         (*it)->detach(this, network_segments);
 
+      // and free any registered memory we allocated ourselves
+      if(reg_ib_mem_hugepage_base) {
+        numasysif_free_mem(-1, reg_ib_mem_hugepage_base, reg_ib_mem_segment.bytes);
+        reg_ib_mem_hugepage_base = 0;
+      }
+      if(reg_mem_hugepage_base) {
+        numasysif_free_mem(-1, reg_mem_hugepage_base, reg_mem_segment.bytes);
+        reg_mem_hugepage_base = 0;
+      }
+
 #ifdef DEBUG_REALM
       event_triggerer.shutdown_work_item();
+      // the batcher was shut down at the start of shutdown, which waited
+      //  for its last do_work and stopped anything from activating it
+      //  again (and if batching is off, it was never activated at all)
+      profiling_batcher.shutdown_work_item();
 #endif
       bgwork.stop_dedicated_workers();
 
@@ -3307,6 +3437,8 @@ static DWORD CountSetBits(ULONG_PTR bitMask)
       free(funcname);
 #endif
       ThreadLocal::error_signal_value = signal;
+      // get out any log messages that are still sitting in buffers
+      Logger::flush_on_fault();
       std::cerr << "Signal " << signal << " received by node " << Network::my_node_id
 #ifdef REALM_ON_WINDOWS
                 << ", process " << GetCurrentProcessId()
@@ -24,6 +24,7 @@
 #include "realm/network.h"
 #include "realm/operation.h"
 #include "realm/profiling.h"
+#include "realm/profiling_impl.h"
 
 #include "realm/dynamic_table.h"
 #include "realm/codedesc.h"
@@ -124,11 +125,17 @@ namespace Realm {
       bool pin_util_procs = false;
       long long cpu_bgwork_timeslice = 0, util_bgwork_timeslice = 0;
       bool use_ext_sysmem = true;
+      // page size backing for sysmem: "off", "thp", or "explicit"
+      std::string sysmem_hugepages = "off";
 
       // RuntimeImpl
       size_t reg_ib_mem_size = 0;
       size_t reg_mem_size = 0;
       size_t disk_mem_size = 0;
+      std::string reg_mem_hugepages = "off";
+      std::string reg_ib_mem_hugepages = "off";
+      // threads used to fault in huge-page-backed memories at startup
+      int hugepage_prefault_threads = 0;
       unsigned dma_worker_threads = 0;  // unused - warning on application use
 #ifdef EVENT_TRACING
       size_t event_trace_block_size = 1 << 20;
@@ -199,6 +206,10 @@ namespace Realm {
 
     protected:
       CoreModuleConfig *config;
+      // sysmem is allocated here (rather than by LocalCPUMemory) if it wants
+      //  huge pages
+      void *sysmem_hugepage_base;
+      NetworkSegment sysmem_segment;
     };
 
     template <typename K, typename V, typename LT = Mutex>
@@ -352,6 +363,7 @@ namespace Realm {
       BackgroundWorkManager bgwork;
       IncomingMessageManager *message_manager;
       EventTriggerNotifier event_triggerer;
+      ProfilingResponseBatcher profiling_batcher;
 
       OperationTable optable;
 
@@ -421,6 +433,10 @@ namespace Realm {
       ID::IDType num_local_memories, num_local_ib_memories, num_local_processors;
       NetworkSegment reg_ib_mem_segment;
       NetworkSegment reg_mem_segment;
+      // registered memories allocated here (rather than by the network) because
+      //  they want huge pages
+      void *reg_ib_mem_hugepage_base;
+      void *reg_mem_hugepage_base;
 
       ModuleRegistrar module_registrar;
       bool modules_created;
@@ -49,7 +49,11 @@ namespace Realm {
 				 const ProfilingRequestSet& prs,
 				 Event wait_on = Event::NO_EVENT);
 
-    // TODO: collective construction
+    // a task-only subgraph that uses processors on other nodes is split into
+    //  per-node fragments that are created on (and kept by) those nodes - the
+    //  returned event triggers once all fragments exist, and each
+    //  instantiation then sends a single message to each node
+    // TODO: collective construction by every rank
 
     void destroy(Event wait_on = Event::NO_EVENT) const;
 
@@ -17,11 +17,52 @@
 
 #include "realm/subgraph_impl.h"
 #include "realm/runtime_impl.h"
+#include "realm/proc_impl.h"
+#include "realm/tasks.h"
 
 namespace Realm {
 
   Logger log_subgraph("subgraph");
 
+  namespace Config {
+    bool static_subgraphs = true;
+    bool partition_subgraphs = true;
+  };
+
+  // sends an instantiation request to the node that owns 'subgraph'
+  static void send_instantiate_message(NodeID target_node, Subgraph subgraph,
+				       const void *args, size_t arglen,
+				       const ProfilingRequestSet& prs,
+				       span<const Event> preconditions,
+				       span<const Event> postconditions,
+				       Event wait_on, Event finish_event,
+				       int priority_adjust)
+  {
+    Serialization::ByteCountSerializer bcs;
+    {
+      bool ok = (bcs.append_bytes(args, arglen) &&
+		 (bcs << preconditions) &&
+		 (bcs << postconditions) &&
+		 (bcs << prs));
+      assert(ok);
+    }
+    size_t msglen = bcs.bytes_used();
+    ActiveMessage<SubgraphInstantiateMessage> amsg(target_node, msglen);
+    amsg->subgraph = subgraph;
+    amsg->wait_on = wait_on;
+    amsg->finish_event = finish_event;
+    amsg->arglen = arglen;
+    amsg->priority_adjust = priority_adjust;
+    {
+      amsg.add_payload(args, arglen);
+      bool ok = ((amsg << preconditions) &&
+		 (amsg << postconditions) &&
+		 (amsg << prs));
+      assert(ok);
+    }
+    amsg.commit();
+  }
+
 
   ////////////////////////////////////////////////////////////////////////
   //
@@ -46,8 +87,15 @@ namespace Realm {
     assert(prs.empty());
 
     if(impl->compile()) {
-      log_subgraph.info() << "created: subgraph=" << subgraph << " ops=" << impl->schedule.size();
-      return Event::NO_EVENT;
+      Event ready_event = Event::NO_EVENT;
+      impl->is_partitioned = (Config::partition_subgraphs &&
+			      impl->partition(ready_event));
+      impl->is_static = (!impl->is_partitioned &&
+			 Config::static_subgraphs && impl->compile_static());
+      log_subgraph.info() << "created: subgraph=" << subgraph << " ops=" << impl->schedule.size()
+			  << " static=" << impl->is_static
+			  << " fragments=" << impl->fragments.size();
+      return ready_event;
     } else {
       // fatal error for now - once we have profiling, return a poisoned event
       //  if there was a profiling request for OperationStatus
@@ -64,11 +112,7 @@ namespace Realm {
 
     if(owner == Network::my_node_id) {
       SubgraphImpl *subgraph = get_runtime()->get_subgraph_impl(*this);
-
-      if(wait_on.has_triggered())
-	subgraph->destroy();
-      else
-	subgraph->deferred_destroy.defer(subgraph, wait_on);
+      subgraph->request_destroy(wait_on);
     } else {
       ActiveMessage<SubgraphDestroyMessage> amsg(owner);
       amsg->subgraph = *this;
@@ -97,29 +141,10 @@ namespace Realm {
 			wait_on, finish_event,
 			priority_adjust);
     } else {
-      Serialization::ByteCountSerializer bcs;
-      {
-	bool ok = (bcs.append_bytes(args, arglen) &&
-		   (bcs << span<const Event>()) &&
-		   (bcs << span<const Event>()) &&
-		   (bcs << prs));
-	assert(ok);
-      }
-      size_t msglen = bcs.bytes_used();
-      ActiveMessage<SubgraphInstantiateMessage> amsg(target_node, msglen);
-      amsg->subgraph = *this;
-      amsg->wait_on = wait_on;
-      amsg->finish_event = finish_event;
-      amsg->arglen = arglen;
-      amsg->priority_adjust = priority_adjust;
-      {
-	amsg.add_payload(args, arglen);
-	bool ok = ((amsg << span<const Event>()) &&
-		   (amsg << span<const Event>()) &&
-		   (amsg << prs));
-	assert(ok);
-      }
-      amsg.commit();
+      send_instantiate_message(target_node, *this, args, arglen, prs,
+			       empty_span() /*preconditions*/,
+			       empty_span() /*postconditions*/,
+			       wait_on, finish_event, priority_adjust);
     }
     return finish_event;
   }
@@ -152,29 +177,9 @@ namespace Realm {
 			wait_on, finish_event,
 			priority_adjust);
     } else {
-      Serialization::ByteCountSerializer bcs;
-      {
-	bool ok = (bcs.append_bytes(args, arglen) &&
-		   (bcs << preconditions) &&
-		   (bcs << postconditions) &&
-		   (bcs << prs));
-	assert(ok);
-      }
-      size_t msglen = bcs.bytes_used();
-      ActiveMessage<SubgraphInstantiateMessage> amsg(target_node, msglen);
-      amsg->subgraph = *this;
-      amsg->wait_on = wait_on;
-      amsg->finish_event = finish_event;
-      amsg->arglen = arglen;
-      amsg->priority_adjust = priority_adjust;
-      {
-	amsg.add_payload(args, arglen);
-	bool ok = ((amsg << preconditions) &&
-		   (amsg << postconditions) &&
-		   (amsg << prs));
-	assert(ok);
-      }
-      amsg.commit();
+      send_instantiate_message(target_node, *this, args, arglen, prs,
+			       preconditions, postconditions,
+			       wait_on, finish_event, priority_adjust);
     }
     return finish_event;
   }
@@ -186,6 +191,14 @@ namespace Realm {
 
   SubgraphImpl::SubgraphImpl()
     : me(Subgraph::NO_SUBGRAPH)
+    , is_static(false)
+    , static_num_tasks(0)
+    , is_partitioned(false)
+    , num_ext_pre_edges(0)
+    , num_cross_edges(0)
+    , num_edges(0)
+    , pending_fragments(0)
+    , destroy_references(1)
   {}
 
   SubgraphImpl::~SubgraphImpl()
@@ -603,6 +616,66 @@ namespace Realm {
     return true;
   }
 
+
+  ////////////////////////////////////////////////////////////////////////
+  //
+  // class SubgraphImpl::DeferredInstantiation
+  //
+
+  class SubgraphImpl::DeferredInstantiation : public EventWaiter {
+  public:
+    DeferredInstantiation(SubgraphImpl *_subgraph,
+			  const void *_args, size_t _arglen,
+			  const ProfilingRequestSet& _prs,
+			  span<const Event> _preconditions,
+			  span<const Event> _postconditions,
+			  Event _start_event, Event _finish_event,
+			  int _priority_adjust)
+      : subgraph(_subgraph)
+      , args(_args, _arglen)
+      , prs(_prs)
+      , preconditions(_preconditions.data(),
+		      _preconditions.data() + _preconditions.size())
+      , postconditions(_postconditions.data(),
+		       _postconditions.data() + _postconditions.size())
+      , start_event(_start_event)
+      , finish_event(_finish_event)
+      , priority_adjust(_priority_adjust)
+    {}
+
+    virtual void event_triggered(bool poisoned, TimeLimit work_until)
+    {
+      assert(!poisoned);
+      subgraph->instantiate_partitioned(args.base(), args.size(), prs,
+					preconditions, postconditions,
+					start_event, finish_event,
+					priority_adjust);
+      // a destroy requested while we were waiting may be waiting on us
+      SubgraphImpl *to_release = subgraph;
+      delete this;
+      to_release->remove_destroy_reference();
+    }
+
+    virtual void print(std::ostream& os) const
+    {
+      os << "deferred subgraph instantiation: subgraph=" << subgraph->me
+	 << " finish=" << finish_event;
+    }
+
+    virtual Event get_finish_event(void) const
+    {
+      return finish_event;
+    }
+
+  protected:
+    SubgraphImpl *subgraph;
+    ByteArray args;
+    ProfilingRequestSet prs;
+    std::vector<Event> preconditions, postconditions;
+    Event start_event, finish_event;
+    int priority_adjust;
+  };
+
   void SubgraphImpl::instantiate(const void *args, size_t arglen,
 				 const ProfilingRequestSet& prs,
 				 span<const Event> preconditions,
@@ -610,6 +683,30 @@ namespace Realm {
 				 Event start_event, Event finish_event,
 				 int priority_adjust)
   {
+    if(is_partitioned) {
+      // the remote fragments might not all exist yet
+      if(fragments_ready.has_triggered()) {
+	instantiate_partitioned(args, arglen, prs,
+				preconditions, postconditions,
+				start_event, finish_event, priority_adjust);
+      } else {
+	DeferredInstantiation *deferred = new DeferredInstantiation(this, args, arglen, prs,
+								   preconditions,
+								   postconditions,
+								   start_event, finish_event,
+								   priority_adjust);
+	destroy_references.fetch_add(1);
+	EventImpl::add_waiter(fragments_ready, deferred);
+      }
+      return;
+    }
+
+    if(is_static) {
+      instantiate_static(args, arglen, preconditions, postconditions,
+			 start_event, finish_event, priority_adjust);
+      return;
+    }
+
     // we precomputed the number of intermediate events we need, so put them
     //  on the stack
     Event *intermediate_events = static_cast<Event *>(alloca(num_intermediate_events *
@@ -885,10 +982,849 @@ namespace Realm {
     }
   }
 
+  bool SubgraphImpl::compile_static(void)
+  {
+    if(schedule.empty())
+      return false;
+
+    // the schedule holds the tasks first and then any external
+    //  postconditions - every task must be on a processor owned by this
+    //  node, and every external postcondition must wait on tasks only
+    unsigned num_tasks = 0;
+    while((num_tasks < schedule.size()) &&
+	  (schedule[num_tasks].op_kind == SubgraphDefinition::OPKIND_TASK))
+      num_tasks++;
+    if(num_tasks == 0)
+      return false;
+    std::vector<ProcessorImpl *> procs(num_tasks, 0);
+    for(size_t i = 0; i < schedule.size(); i++) {
+      if(i < num_tasks) {
+	ID id(defn->tasks[schedule[i].op_index].proc);
+	if(!id.is_processor() ||
+	   (NodeID(id.proc_owner_node()) != Network::my_node_id))
+	  return false;
+	procs[i] = get_runtime()->get_processor_impl(id);
+      } else {
+	if((schedule[i].op_kind != SubgraphDefinition::OPKIND_EXT_POSTCOND) ||
+	   schedule[i].preconditions.empty())
+	  return false;
+	for(std::vector<std::pair<unsigned, int> >::const_iterator it = schedule[i].preconditions.begin();
+	    it != schedule[i].preconditions.end();
+	    ++it)
+	  if(it->second < 0)
+	    return false;
+      }
+    }
+
+    // each task has exactly one intermediate event, so event indices are
+    //  also schedule indices - external preconditions are negative indices
+    size_t num_ops = schedule.size();
+    unsigned num_ext_pre = 0;
+    static_counts.assign(num_ops, 0);
+    static_succ_offsets.assign(num_ops + 1, 0);
+    for(size_t i = 0; i < num_ops; i++) {
+      assert((i >= num_tasks) || (schedule[i].intermediate_event_base == i));
+      bool has_task_pred = false;
+      for(std::vector<std::pair<unsigned, int> >::const_iterator it = schedule[i].preconditions.begin();
+	  it != schedule[i].preconditions.end();
+	  ++it) {
+	assert(it->first == 0);
+	static_counts[i]++;
+	if(it->second >= 0) {
+	  static_succ_offsets[it->second + 1]++;
+	  has_task_pred = true;
+	} else
+	  num_ext_pre = std::max(num_ext_pre, unsigned(-it->second));
+      }
+      // tasks with no task predecessors also wait for the start event
+      if((i < num_tasks) && !has_task_pred)
+	static_counts[i]++;
+    }
+    for(size_t i = 0; i < num_ops; i++)
+      static_succ_offsets[i + 1] += static_succ_offsets[i];
+    static_successors.resize(static_succ_offsets[num_ops]);
+    static_ext_pre_offsets.assign(num_ext_pre + 1, 0);
+    for(size_t i = 0; i < num_tasks; i++)
+      for(std::vector<std::pair<unsigned, int> >::const_iterator it = schedule[i].preconditions.begin();
+	  it != schedule[i].preconditions.end();
+	  ++it)
+	if(it->second < 0)
+	  static_ext_pre_offsets[-it->second]++;
+    for(unsigned i = 0; i < num_ext_pre; i++)
+      static_ext_pre_offsets[i + 1] += static_ext_pre_offsets[i];
+    static_ext_pre_successors.resize(static_ext_pre_offsets[num_ext_pre]);
+
+    std::vector<unsigned> fill(static_succ_offsets.begin(),
+			       static_succ_offsets.end() - 1);
+    std::vector<unsigned> ext_fill(static_ext_pre_offsets.begin(),
+				   static_ext_pre_offsets.end() - 1);
+    static_roots.clear();
+    for(size_t i = 0; i < num_ops; i++) {
+      bool has_task_pred = false;
+      for(std::vector<std::pair<unsigned, int> >::const_iterator it = schedule[i].preconditions.begin();
+	  it != schedule[i].preconditions.end();
+	  ++it)
+	if(it->second >= 0) {
+	  static_successors[fill[it->second]++] = i;
+	  has_task_pred = true;
+	} else
+	  static_ext_pre_successors[ext_fill[-1 - it->second]++] = i;
+      if((i < num_tasks) && !has_task_pred)
+	static_roots.push_back(i);
+    }
+    static_num_tasks = num_tasks;
+    static_procs.swap(procs);
+    return true;
+  }
+
+
+  ////////////////////////////////////////////////////////////////////////
+  //
+  // class SubgraphImpl::StaticInstance
+  //
+
+  // a single allocation holds the instance, a completion notifier and a
+  //  dependence counter for every operation, a waiter for every external
+  //  precondition, the external postcondition events, and a copy of the
+  //  instantiation arguments (needed for interpolation of later tasks)
+  class SubgraphImpl::StaticInstance : public EventWaiter {
+  public:
+    class OpNotifier : public Operation::CompletionNotifier {
+    public:
+      virtual void operation_completed(bool poisoned);
+      virtual Event get_finish_event(void) const;
+
+      StaticInstance *instance;
+      unsigned op_index;
+    };
+
+    class PreconditionWaiter : public EventWaiter {
+    public:
+      virtual void event_triggered(bool poisoned, TimeLimit work_until);
+      virtual void print(std::ostream& os) const;
+      virtual Event get_finish_event(void) const;
+
+      StaticInstance *instance;
+      unsigned ext_index;
+    };
+
+    static StaticInstance *create(SubgraphImpl *_subgraph,
+				  const void *_args, size_t _arglen,
+				  span<const Event> _postconditions,
+				  Event _finish_event, int _priority_adjust);
+
+    // hooks up the external preconditions and the start event - the
+    //  instance may be freed by the time this returns
+    void start(span<const Event> preconditions, Event start_event);
+
+    virtual void event_triggered(bool poisoned, TimeLimit work_until);
+    virtual void print(std::ostream& os) const;
+    virtual Event get_finish_event(void) const;
+
+  protected:
+    StaticInstance(SubgraphImpl *_subgraph, Event _finish_event,
+		   int _priority_adjust, size_t _arglen);
+
+    void launch_operation(unsigned op_index);
+    bool release_successor(unsigned succ, bool poisoned);
+    void predecessor_done(const std::vector<unsigned>& succs,
+			  unsigned first, unsigned last, bool poisoned);
+    void operation_completed(unsigned op_index, bool poisoned);
+    void finish(void);
+
+    // set in a counter when any predecessor of that operation was poisoned
+    static const unsigned POISON_BIT = 1U << 31;
+
+    SubgraphImpl *subgraph;
+    Event finish_event;
+    int priority_adjust;
+    size_t arglen;
+    atomic<unsigned> remaining;
+    atomic<bool> any_poisoned;
+    OpNotifier *notifiers;
+    PreconditionWaiter *pre_waiters;
+    atomic<unsigned> *counters;
+    Event *post_events;
+    char *argdata;
+  };
+
+  SubgraphImpl::StaticInstance::StaticInstance(SubgraphImpl *_subgraph,
+					       Event _finish_event,
+					       int _priority_adjust,
+					       size_t _arglen)
+    : subgraph(_subgraph)
+    , finish_event(_finish_event)
+    , priority_adjust(_priority_adjust)
+    , arglen(_arglen)
+    , remaining(_subgraph->static_num_tasks)
+    , any_poisoned(false)
+  {}
+
+  static size_t align_offset(size_t offset, size_t alignment)
+  {
+    return ((offset + alignment - 1) & ~(alignment - 1));
+  }
+
+  /*static*/ SubgraphImpl::StaticInstance *SubgraphImpl::StaticInstance::create(SubgraphImpl *_subgraph,
+									     const void *_args,
+									     size_t _arglen,
+									     span<const Event> _postconditions,
+									     Event _finish_event,
+									     int _priority_adjust)
+  {
+    size_t num_tasks = _subgraph->static_num_tasks;
+    size_t num_ops = _subgraph->schedule.size();
+    size_t num_ext_pre = _subgraph->static_ext_pre_offsets.size() - 1;
+    size_t notifier_offset = align_offset(sizeof(StaticInstance),
+					  alignof(OpNotifier));
+    size_t waiter_offset = align_offset(notifier_offset + (num_tasks * sizeof(OpNotifier)),
+					alignof(PreconditionWaiter));
+    size_t counter_offset = align_offset(waiter_offset + (num_ext_pre * sizeof(PreconditionWaiter)),
+					 alignof(atomic<unsigned>));
+    size_t event_offset = align_offset(counter_offset + (num_ops * sizeof(atomic<unsigned>)),
+				       alignof(Event));
+    size_t arg_offset = event_offset + ((num_ops - num_tasks) * sizeof(Event));
+    char *base = static_cast<char *>(malloc(arg_offset + _arglen));
+    assert(base != 0);
+
+    StaticInstance *inst = ::new(base) StaticInstance(_subgraph, _finish_event,
+						    _priority_adjust, _arglen);
+    inst->notifiers = reinterpret_cast<OpNotifier *>(base + notifier_offset);
+    inst->pre_waiters = reinterpret_cast<PreconditionWaiter *>(base + waiter_offset);
+    inst->counters = reinterpret_cast<atomic<unsigned> *>(base + counter_offset);
+    inst->post_events = reinterpret_cast<Event *>(base + event_offset);
+    inst->argdata = base + arg_offset;
+    for(size_t i = 0; i < num_tasks; i++) {
+      OpNotifier *n = new(&inst->notifiers[i]) OpNotifier;
+      n->instance = inst;
+      n->op_index = i;
+    }
+    for(size_t i = 0; i < num_ext_pre; i++) {
+      PreconditionWaiter *w = ::new(&inst->pre_waiters[i]) PreconditionWaiter;
+      w->instance = inst;
+      w->ext_index = i;
+    }
+    for(size_t i = 0; i < num_ops; i++)
+      new(&inst->counters[i]) atomic<unsigned>(_subgraph->static_counts[i]);
+    // nobody to tell about postconditions the caller didn't ask for
+    for(size_t i = num_tasks; i < num_ops; i++) {
+      unsigned idx = _subgraph->schedule[i].op_index;
+      inst->post_events[i - num_tasks] = ((idx < _postconditions.size()) ?
+					    _postconditions[idx] :
+					    Event::NO_EVENT);
+    }
+    if(_arglen > 0)
+      memcpy(inst->argdata, _args, _arglen);
+    return inst;
+  }
+
+  void SubgraphImpl::StaticInstance::start(span<const Event> preconditions,
+					   Event start_event)
+  {
+    // every external precondition and the start event hold up at least one
+    //  task, so the instance stays alive until the last of them is handled
+    SubgraphImpl *sg = subgraph;
+    size_t num_ext_pre = sg->static_ext_pre_offsets.size() - 1;
+    for(size_t i = 0; i < num_ext_pre; i++) {
+      if(sg->static_ext_pre_offsets[i] == sg->static_ext_pre_offsets[i + 1])
+	continue;
+      Event e = ((i < preconditions.size()) ? preconditions[i] :
+		                               Event::NO_EVENT);
+      bool poisoned = false;
+      if(e.has_triggered_faultaware(poisoned))
+	predecessor_done(sg->static_ext_pre_successors,
+			 sg->static_ext_pre_offsets[i],
+			 sg->static_ext_pre_offsets[i + 1], poisoned);
+      else
+	EventImpl::add_waiter(e, &pre_waiters[i]);
+    }
+
+    bool poisoned = false;
+    if(start_event.has_triggered_faultaware(poisoned))
+      predecessor_done(sg->static_roots, 0, sg->static_roots.size(),
+		       poisoned);
+    else
+      EventImpl::add_waiter(start_event, this);
+  }
+
+  void SubgraphImpl::StaticInstance::launch_operation(unsigned op_index)
+  {
+    const SubgraphScheduleEntry& se = subgraph->schedule[op_index];
+    const SubgraphDefinition::TaskDesc& td = subgraph->defn->tasks[se.op_index];
+
+    // scratch buffer used for interpolations
+    const size_t SCRATCH_SIZE = 1024;
+    char interp_scratch[SCRATCH_SIZE];
+
+    size_t scratch_needed = 0;
+    if(has_interpolation(subgraph->defn->interpolations,
+			 se.first_interp, se.num_interps,
+			 SubgraphDefinition::Interpolation::TARGET_TASK_ARGS,
+			 se.op_index))
+      scratch_needed += td.args.size();
+
+    InterpolationScratchHelper ish(interp_scratch, scratch_needed);
+
+    const void *task_args = do_interpolation(subgraph->defn->interpolations,
+					     se.first_interp, se.num_interps,
+					     SubgraphDefinition::Interpolation::TARGET_TASK_ARGS,
+					     se.op_index,
+					     argdata, arglen,
+					     td.args.base(), td.args.size(),
+					     ish);
+
+    // no precondition and no finish event - the notifier tells us when it
+    //  is done
+    Task *task = new Task(td.proc, td.task_id, task_args, td.args.size(),
+			  td.prs, Event::NO_EVENT,
+			  0 /*no finish event*/, 0 /*finish_gen*/,
+			  td.priority + priority_adjust);
+    task->set_completion_notifier(&notifiers[op_index]);
+    subgraph->static_procs[op_index]->enqueue_task(task);
+  }
+
+  // drops one dependence of 'succ', launching it (or triggering it, for an
+  //  external postcondition) if that was the last one - returns true if it
+  //  is a task that must instead be skipped because a predecessor was
+  //  poisoned
+  bool SubgraphImpl::StaticInstance::release_successor(unsigned succ,
+						       bool poisoned)
+  {
+    if(poisoned)
+      counters[succ].fetch_or_acqrel(POISON_BIT);
+    unsigned prev = counters[succ].fetch_sub_acqrel(1);
+    if((prev & ~POISON_BIT) != 1)
+      return false;
+    unsigned num_tasks = subgraph->static_num_tasks;
+    if(succ >= num_tasks) {
+      Event e = post_events[succ - num_tasks];
+      if(e.exists())
+	GenEventImpl::trigger(e, (prev & POISON_BIT) != 0);
+      return false;
+    }
+    if((prev & POISON_BIT) != 0)
+      return true;
+    launch_operation(succ);
+    return false;
+  }
+
+  // an external precondition or the start event has triggered - unlike an
+  //  operation, it doesn't count toward completion, so the instance may be
+  //  freed as soon as its last successor is released
+  void SubgraphImpl::StaticInstance::predecessor_done(const std::vector<unsigned>& succs,
+						      unsigned first,
+						      unsigned last,
+						      bool poisoned)
+  {
+    std::vector<unsigned> skipped;
+    for(unsigned i = first; i < last; i++)
+      if(release_successor(succs[i], poisoned))
+	skipped.push_back(succs[i]);
+    for(std::vector<unsigned>::const_iterator it = skipped.begin();
+	it != skipped.end();
+	++it)
+      operation_completed(*it, true /*poisoned*/);
+  }
+
+  void SubgraphImpl::StaticInstance::operation_completed(unsigned op_index,
+							 bool poisoned)
+  {
+    // operations downstream of a poisoned operation are not run - they are
+    //  completed (as poisoned) from this worklist instead of by recursion
+    std::vector<unsigned> skipped;
+    while(true) {
+      if(poisoned)
+	any_poisoned.store(true);
+
+      for(unsigned i = subgraph->static_succ_offsets[op_index];
+	  i < subgraph->static_succ_offsets[op_index + 1];
+	  i++) {
+	unsigned succ = subgraph->static_successors[i];
+	if(release_successor(succ, poisoned))
+	  skipped.push_back(succ);
+      }
+
+      // the last operation to complete cleans up
+      if(remaining.fetch_sub_acqrel(1) == 1) {
+	assert(skipped.empty());
+	finish();
+	return;
+      }
+
+      if(skipped.empty())
+	return;
+      op_index = skipped.back();
+      skipped.pop_back();
+      poisoned = true;
+    }
+  }
+
+  void SubgraphImpl::StaticInstance::finish(void)
+  {
+    Event e = finish_event;
+    bool poisoned = any_poisoned.load_acquire();
+    SubgraphImpl *sg = subgraph;
+
+    size_t num_tasks = sg->static_num_tasks;
+    for(size_t i = 0; i < num_tasks; i++)
+      notifiers[i].~OpNotifier();
+    size_t num_ext_pre = sg->static_ext_pre_offsets.size() - 1;
+    for(size_t i = 0; i < num_ext_pre; i++)
+      pre_waiters[i].~PreconditionWaiter();
+    this->~StaticInstance();
+    free(this);
+
+    GenEventImpl::trigger(e, poisoned);
+    // a destroy requested while we were running may be waiting on us
+    sg->remove_destroy_reference();
+  }
+
+  void SubgraphImpl::StaticInstance::event_triggered(bool poisoned,
+						     TimeLimit work_until)
+  {
+    SubgraphImpl *sg = subgraph;
+    predecessor_done(sg->static_roots, 0, sg->static_roots.size(), poisoned);
+  }
+
+  void SubgraphImpl::StaticInstance::print(std::ostream& os) const
+  {
+    os << "static subgraph instance: subgraph=" << subgraph->me
+       << " finish=" << finish_event;
+  }
+
+  Event SubgraphImpl::StaticInstance::get_finish_event(void) const
+  {
+    return finish_event;
+  }
+
+  void SubgraphImpl::StaticInstance::OpNotifier::operation_completed(bool poisoned)
+  {
+    instance->operation_completed(op_index, poisoned);
+  }
+
+  Event SubgraphImpl::StaticInstance::OpNotifier::get_finish_event(void) const
+  {
+    return instance->finish_event;
+  }
+
+  void SubgraphImpl::StaticInstance::PreconditionWaiter::event_triggered(bool poisoned,
+									 TimeLimit work_until)
+  {
+    SubgraphImpl *sg = instance->subgraph;
+    instance->predecessor_done(sg->static_ext_pre_successors,
+			       sg->static_ext_pre_offsets[ext_index],
+			       sg->static_ext_pre_offsets[ext_index + 1],
+			       poisoned);
+  }
+
+  void SubgraphImpl::StaticInstance::PreconditionWaiter::print(std::ostream& os) const
+  {
+    os << "static subgraph precondition: subgraph=" << instance->subgraph->me
+       << " index=" << ext_index << " finish=" << instance->finish_event;
+  }
+
+  Event SubgraphImpl::StaticInstance::PreconditionWaiter::get_finish_event(void) const
+  {
+    return instance->finish_event;
+  }
+
+  void SubgraphImpl::instantiate_static(const void *args, size_t arglen,
+					span<const Event> preconditions,
+					span<const Event> postconditions,
+					Event start_event, Event finish_event,
+					int priority_adjust)
+  {
+    // the instance reads our static schedule until it finishes, so it holds
+    //  off any destroy until then
+    destroy_references.fetch_add(1);
+    StaticInstance *inst = StaticInstance::create(this, args, arglen,
+						  postconditions,
+						  finish_event,
+						  priority_adjust);
+    inst->start(preconditions, start_event);
+  }
+
+  // task descriptors hold byte arrays, so fragments are serialized by hand
+  //  rather than with the definition's serdez
+  template <typename S>
+  static bool serialize_fragment(S& s, const SubgraphDefinition& defn)
+  {
+    bool ok = (s << defn.tasks.size());
+    for(size_t i = 0; ok && (i < defn.tasks.size()); i++) {
+      const SubgraphDefinition::TaskDesc& td = defn.tasks[i];
+      ok = ((s << td.proc) &&
+	    (s << td.task_id) &&
+	    (s << td.args) &&
+	    (s << td.priority) &&
+	    (s << td.prs));
+    }
+    return (ok &&
+	    (s << defn.dependencies) &&
+	    (s << defn.interpolations) &&
+	    (s << int(defn.concurrency_mode)));
+  }
+
+  template <typename S>
+  static bool deserialize_fragment(S& s, SubgraphDefinition& defn)
+  {
+    size_t num_tasks;
+    bool ok = (s >> num_tasks);
+    if(ok)
+      defn.tasks.resize(num_tasks);
+    for(size_t i = 0; ok && (i < num_tasks); i++) {
+      SubgraphDefinition::TaskDesc& td = defn.tasks[i];
+      ok = ((s >> td.proc) &&
+	    (s >> td.task_id) &&
+	    (s >> td.args) &&
+	    (s >> td.priority) &&
+	    (s >> td.prs));
+    }
+    int mode;
+    ok = (ok &&
+	  (s >> defn.dependencies) &&
+	  (s >> defn.interpolations) &&
+	  (s >> mode));
+    if(ok)
+      defn.concurrency_mode = SubgraphDefinition::ConcurrencyMode(mode);
+    return ok;
+  }
+
+  // creates a subgraph owned by this node for one fragment of a partitioned
+  //  subgraph - takes ownership of 'defn'
+  static Subgraph create_fragment_subgraph(SubgraphDefinition *defn)
+  {
+    SubgraphImpl *impl = get_runtime()->local_subgraph_free_lists[Network::my_node_id]->alloc_entry();
+    impl->me.subgraph_creator_node() = Network::my_node_id;
+    impl->defn = defn;
+    // a fragment of an acyclic graph is acyclic
+    bool ok = impl->compile();
+    assert(ok);
+    impl->is_static = (Config::static_subgraphs && impl->compile_static());
+    log_subgraph.info() << "created fragment: subgraph=" << impl->me
+			<< " ops=" << impl->schedule.size()
+			<< " static=" << impl->is_static;
+    return impl->me.convert<Subgraph>();
+  }
+
+  bool SubgraphImpl::partition(Event& ready_event)
+  {
+    if(defn->tasks.empty() || !defn->copies.empty() ||
+       !defn->arrivals.empty() || !defn->instantiations.empty() ||
+       !defn->acquires.empty() || !defn->releases.empty())
+      return false;
+
+    // external pre/postconditions have to attach directly to tasks
+    unsigned num_ext_pre = 0, num_ext_post = 0;
+    for(std::vector<SubgraphDefinition::Dependency>::const_iterator it = defn->dependencies.begin();
+	it != defn->dependencies.end();
+	++it) {
+      if(it->src_op_kind == SubgraphDefinition::OPKIND_EXT_PRECOND) {
+	if(it->tgt_op_kind != SubgraphDefinition::OPKIND_TASK)
+	  return false;
+	num_ext_pre = std::max(num_ext_pre, it->src_op_index + 1);
+      } else if(it->src_op_kind != SubgraphDefinition::OPKIND_TASK)
+	return false;
+      if(it->tgt_op_kind == SubgraphDefinition::OPKIND_EXT_POSTCOND)
+	num_ext_post = std::max(num_ext_post, it->tgt_op_index + 1);
+      else if(it->tgt_op_kind != SubgraphDefinition::OPKIND_TASK)
+	return false;
+    }
+
+    // figure out which node runs each task
+    size_t num_tasks = defn->tasks.size();
+    std::vector<NodeID> task_nodes(num_tasks);
+    bool any_remote = false;
+    for(size_t i = 0; i < num_tasks; i++) {
+      ID id(defn->tasks[i].proc);
+      if(!id.is_processor())
+	return false;
+      task_nodes[i] = id.proc_owner_node();
+      if(task_nodes[i] != Network::my_node_id)
+	any_remote = true;
+    }
+    if(!any_remote)
+      return false;
+
+    // one fragment per node, with tasks numbered in their original order
+    std::map<NodeID, unsigned> node_fragments;
+    std::vector<SubgraphDefinition *> fragment_defns;
+    std::vector<unsigned> task_fragment(num_tasks), task_index(num_tasks);
+    for(size_t i = 0; i < num_tasks; i++) {
+      std::map<NodeID, unsigned>::const_iterator finder = node_fragments.find(task_nodes[i]);
+      unsigned f;
+      if(finder == node_fragments.end()) {
+	f = fragments.size();
+	node_fragments[task_nodes[i]] = f;
+	fragments.resize(f + 1);
+	fragments[f].node = task_nodes[i];
+	fragments[f].subgraph = Subgraph::NO_SUBGRAPH;
+	fragment_defns.push_back(new SubgraphDefinition);
+	fragment_defns[f]->concurrency_mode = defn->concurrency_mode;
+      } else
+	f = finder->second;
+      task_fragment[i] = f;
+      task_index[i] = fragment_defns[f]->tasks.size();
+      fragment_defns[f]->tasks.push_back(defn->tasks[i]);
+    }
+
+    // the subgraph's external preconditions are the first edges, followed
+    //  by the cross-node dependencies and then the contributions of each
+    //  fragment to the subgraph's external postconditions
+    num_ext_pre_edges = num_ext_pre;
+    num_cross_edges = 0;
+    for(std::vector<SubgraphDefinition::Dependency>::const_iterator it = defn->dependencies.begin();
+	it != defn->dependencies.end();
+	++it)
+      if((it->src_op_kind == SubgraphDefinition::OPKIND_TASK) &&
+	 (it->tgt_op_kind == SubgraphDefinition::OPKIND_TASK) &&
+	 (task_fragment[it->src_op_index] != task_fragment[it->tgt_op_index]))
+	num_cross_edges++;
+    unsigned next_cross = num_ext_pre_edges;
+    num_edges = num_ext_pre_edges + num_cross_edges;
+    ext_post_edges.assign(num_ext_post, std::vector<unsigned>());
+
+    // a fragment uses a single external pre/postcondition for each of the
+    //  subgraph's, no matter how many of its tasks attach to it
+    typedef std::map<std::pair<unsigned, unsigned>, unsigned> ExtMap;
+    ExtMap ext_pre_map, ext_post_map;
+    for(std::vector<SubgraphDefinition::Dependency>::const_iterator it = defn->dependencies.begin();
+	it != defn->dependencies.end();
+	++it) {
+      if(it->src_op_kind == SubgraphDefinition::OPKIND_EXT_PRECOND) {
+	unsigned f = task_fragment[it->tgt_op_index];
+	std::pair<ExtMap::iterator, bool> ins =
+	  ext_pre_map.insert(std::make_pair(std::make_pair(f, it->src_op_index),
+					    unsigned(fragments[f].in_edges.size())));
+	if(ins.second)
+	  fragments[f].in_edges.push_back(it->src_op_index);
+	SubgraphDefinition::Dependency dep;
+	dep.src_op_kind = SubgraphDefinition::OPKIND_EXT_PRECOND;
+	dep.src_op_index = ins.first->second;
+	dep.tgt_op_kind = SubgraphDefinition::OPKIND_TASK;
+	dep.tgt_op_index = task_index[it->tgt_op_index];
+	fragment_defns[f]->dependencies.push_back(dep);
+	continue;
+      }
+
+      if(it->tgt_op_kind == SubgraphDefinition::OPKIND_EXT_POSTCOND) {
+	unsigned f = task_fragment[it->src_op_index];
+	std::pair<ExtMap::iterator, bool> ins =
+	  ext_post_map.insert(std::make_pair(std::make_pair(f, it->tgt_op_index),
+					     unsigned(fragments[f].out_edges.size())));
+	if(ins.second) {
+	  unsigned edge = num_edges++;
+	  ext_post_edges[it->tgt_op_index].push_back(edge);
+	  fragments[f].out_edges.push_back(edge);
+	}
+	SubgraphDefinition::Dependency dep;
+	dep.src_op_kind = SubgraphDefinition::OPKIND_TASK;
+	dep.src_op_index = task_index[it->src_op_index];
+	dep.tgt_op_kind = SubgraphDefinition::OPKIND_EXT_POSTCOND;
+	dep.tgt_op_index = ins.first->second;
+	fragment_defns[f]->dependencies.push_back(dep);
+	continue;
+      }
+
+      unsigned src_f = task_fragment[it->src_op_index];
+      unsigned tgt_f = task_fragment[it->tgt_op_index];
+      SubgraphDefinition::Dependency dep;
+      dep.src_op_kind = SubgraphDefinition::OPKIND_TASK;
+      dep.src_op_index = task_index[it->src_op_index];
+      dep.tgt_op_kind = SubgraphDefinition::OPKIND_TASK;
+      dep.tgt_op_index = task_index[it->tgt_op_index];
+      if(src_f == tgt_f) {
+	fragment_defns[src_f]->dependencies.push_back(dep);
+	continue;
+      }
+      unsigned edge = next_cross++;
+      SubgraphDefinition::Dependency out_dep = dep;
+      out_dep.tgt_op_kind = SubgraphDefinition::OPKIND_EXT_POSTCOND;
+      out_dep.tgt_op_index = fragments[src_f].out_edges.size();
+      fragments[src_f].out_edges.push_back(edge);
+      fragment_defns[src_f]->dependencies.push_back(out_dep);
+      SubgraphDefinition::Dependency in_dep = dep;
+      in_dep.src_op_kind = SubgraphDefinition::OPKIND_EXT_PRECOND;
+      in_dep.src_op_index = fragments[tgt_f].in_edges.size();
+      fragments[tgt_f].in_edges.push_back(edge);
+      fragment_defns[tgt_f]->dependencies.push_back(in_dep);
+    }
+    assert(next_cross == (num_ext_pre_edges + num_cross_edges));
+
+    // interpolations can only target task arguments here
+    for(std::vector<SubgraphDefinition::Interpolation>::const_iterator it = defn->interpolations.begin();
+	it != defn->interpolations.end();
+	++it) {
+      SubgraphDefinition::Interpolation interp = *it;
+      interp.target_index = task_index[it->target_index];
+      fragment_defns[task_fragment[it->target_index]]->interpolations.push_back(interp);
+    }
+
+    // count the remote fragments before sending any requests so that the
+    //  responses can't race with us
+    unsigned num_remote = fragments.size() - (node_fragments.count(Network::my_node_id) ? 1 : 0);
+    pending_fragments.store(num_remote);
+    if(num_remote > 0)
+      fragments_ready = GenEventImpl::create_genevent()->current_event();
+    else
+      fragments_ready = Event::NO_EVENT;
+    ready_event = fragments_ready;
+
+    for(unsigned f = 0; f < fragments.size(); f++) {
+      if(fragments[f].node == Network::my_node_id) {
+	fragments[f].subgraph = create_fragment_subgraph(fragment_defns[f]);
+	continue;
+      }
+      Serialization::ByteCountSerializer bcs;
+      {
+	bool ok = serialize_fragment(bcs, *fragment_defns[f]);
+	assert(ok);
+      }
+      ActiveMessage<SubgraphCreateFragmentMessage> amsg(fragments[f].node,
+							bcs.bytes_used());
+      amsg->parent = me.convert<Subgraph>();
+      amsg->fragment_index = f;
+      {
+	bool ok = serialize_fragment(amsg, *fragment_defns[f]);
+	assert(ok);
+      }
+      amsg.commit();
+      delete fragment_defns[f];
+    }
+    return true;
+  }
+
+
+  void SubgraphImpl::instantiate_partitioned(const void *args, size_t arglen,
+					     const ProfilingRequestSet& prs,
+					     span<const Event> preconditions,
+					     span<const Event> postconditions,
+					     Event start_event, Event finish_event,
+					     int priority_adjust)
+  {
+    // the only events we need are for dependencies that cross nodes, for
+    //  each fragment's contribution to our external postconditions, and
+    //  for the finish event of each fragment
+    std::vector<Event> edge_events(num_edges);
+    for(unsigned i = 0; i < num_ext_pre_edges; i++)
+      edge_events[i] = ((i < preconditions.size()) ? preconditions[i] :
+			                             Event::NO_EVENT);
+    for(unsigned i = num_ext_pre_edges; i < num_edges; i++)
+      edge_events[i] = GenEventImpl::create_genevent()->current_event();
+
+    // an external postcondition triggers once every fragment that feeds it
+    //  is done with it - one that nothing feeds waits only for the start
+    //  event, as it would without partitioning
+    for(size_t i = 0; (i < postconditions.size()) && (i < ext_post_edges.size()); i++) {
+      Event post_event = postconditions[i];
+      const std::vector<unsigned>& edges = ext_post_edges[i];
+      if(edges.empty() && !start_event.exists()) {
+	GenEventImpl::trigger(post_event, false /*!poisoned*/);
+	continue;
+      }
+      GenEventImpl *post_impl = get_genevent_impl(post_event);
+      if(edges.empty()) {
+	post_impl->merger.prepare_merger(post_event, false /*!ignore_faults*/, 1);
+	post_impl->merger.add_precondition(start_event);
+      } else {
+	post_impl->merger.prepare_merger(post_event, false /*!ignore_faults*/,
+					 edges.size());
+	for(std::vector<unsigned>::const_iterator it = edges.begin();
+	    it != edges.end();
+	    ++it)
+	  post_impl->merger.add_precondition(edge_events[*it]);
+      }
+      post_impl->merger.arm_merger();
+    }
+
+    GenEventImpl *event_impl = get_genevent_impl(finish_event);
+    event_impl->merger.prepare_merger(finish_event, false /*!ignore_faults*/,
+				      fragments.size());
+
+    // the profiling requests go with exactly one fragment (this node's, if
+    //  it has one) so that the caller doesn't get a response per node
+    size_t prs_fragment = 0;
+    for(size_t f = 0; f < fragments.size(); f++)
+      if(fragments[f].node == Network::my_node_id) {
+	prs_fragment = f;
+	break;
+      }
+    const ProfilingRequestSet no_prs;
+
+    std::vector<Event> preconds, postconds;
+    for(size_t f = 0; f < fragments.size(); f++) {
+      const Fragment& frag = fragments[f];
+      const ProfilingRequestSet& fragment_prs = ((f == prs_fragment) ?
+						   prs : no_prs);
+      preconds.resize(frag.in_edges.size());
+      for(size_t i = 0; i < frag.in_edges.size(); i++)
+	preconds[i] = edge_events[frag.in_edges[i]];
+      postconds.resize(frag.out_edges.size());
+      for(size_t i = 0; i < frag.out_edges.size(); i++)
+	postconds[i] = edge_events[frag.out_edges[i]];
+
+      Event fragment_finish = GenEventImpl::create_genevent()->current_event();
+      if(frag.node == Network::my_node_id) {
+	SubgraphImpl *impl = get_runtime()->get_subgraph_impl(frag.subgraph);
+	impl->instantiate(args, arglen, fragment_prs, preconds, postconds,
+			  start_event, fragment_finish, priority_adjust);
+      } else
+	send_instantiate_message(frag.node, frag.subgraph, args, arglen,
+				 fragment_prs, preconds, postconds,
+				 start_event, fragment_finish, priority_adjust);
+      event_impl->merger.add_precondition(fragment_finish);
+    }
+
+    event_impl->merger.arm_merger();
+  }
+
+  void SubgraphImpl::request_destroy(Event wait_on)
+  {
+    // the fragments of a partitioned subgraph must all exist, and every
+    //  instantiation parked on them must be issued, before we tear them down
+    if(is_partitioned && !fragments_ready.has_triggered())
+      wait_on = Event::merge_events(wait_on, fragments_ready);
+
+    if(wait_on.has_triggered())
+      remove_destroy_reference();
+    else
+      deferred_destroy.defer(this, wait_on);
+  }
+
+  void SubgraphImpl::remove_destroy_reference(void)
+  {
+    if(destroy_references.fetch_sub_acqrel(1) == 1)
+      destroy();
+  }
+
   void SubgraphImpl::destroy(void)
   {
+    // only called once the fragments exist, all instantiations of them
+    //  have been issued and all static instances have finished (see
+    //  request_destroy)
+    for(std::vector<Fragment>::const_iterator it = fragments.begin();
+	it != fragments.end();
+	++it)
+      it->subgraph.destroy();
+    fragments.clear();
+    is_partitioned = false;
+    num_ext_pre_edges = 0;
+    num_cross_edges = 0;
+    num_edges = 0;
+    ext_post_edges.clear();
+    fragments_ready = Event::NO_EVENT;
+    destroy_references.store(1);
+
     delete defn;
     schedule.clear();
+    is_static = false;
+    static_counts.clear();
+    static_succ_offsets.clear();
+    static_successors.clear();
+    static_roots.clear();
+    static_procs.clear();
+    static_ext_pre_offsets.clear();
+    static_ext_pre_successors.clear();
+    static_num_tasks = 0;
 
     // TODO: when we create subgraphs on remote nodes, send a message to the
     //  creator node so they can add it to their free list
@@ -916,7 +1852,7 @@ namespace Realm {
 						      TimeLimit work_until)
   {
     assert(!poisoned);
-    subgraph->destroy();
+    subgraph->remove_destroy_reference();
   }
 
   void SubgraphImpl::DeferredDestroy::print(std::ostream& os) const
@@ -960,6 +1896,51 @@ namespace Realm {
   ActiveMessageHandlerReg<SubgraphInstantiateMessage> subgraph_instantiate_message_handler;
 
 
+  ////////////////////////////////////////////////////////////////////////
+  //
+  // class SubgraphCreateFragmentMessage
+
+  /*static*/ void SubgraphCreateFragmentMessage::handle_message(NodeID sender,
+							    const SubgraphCreateFragmentMessage &msg,
+							    const void *data, size_t datalen)
+  {
+    SubgraphDefinition *defn = new SubgraphDefinition;
+    Serialization::FixedBufferDeserializer fbd(data, datalen);
+    bool ok = deserialize_fragment(fbd, *defn);
+    assert(ok);
+
+    Subgraph fragment = create_fragment_subgraph(defn);
+    log_subgraph.info() << "created fragment: parent=" << msg.parent
+			<< " index=" << msg.fragment_index
+			<< " subgraph=" << fragment;
+
+    ActiveMessage<SubgraphFragmentCreatedMessage> amsg(sender);
+    amsg->parent = msg.parent;
+    amsg->fragment_index = msg.fragment_index;
+    amsg->fragment = fragment;
+    amsg.commit();
+  }
+
+  ActiveMessageHandlerReg<SubgraphCreateFragmentMessage> subgraph_create_fragment_message_handler;
+
+
+  ////////////////////////////////////////////////////////////////////////
+  //
+  // class SubgraphFragmentCreatedMessage
+
+  /*static*/ void SubgraphFragmentCreatedMessage::handle_message(NodeID sender,
+							     const SubgraphFragmentCreatedMessage &msg,
+							     const void *data, size_t datalen)
+  {
+    SubgraphImpl *parent = get_runtime()->get_subgraph_impl(msg.parent);
+    parent->fragments[msg.fragment_index].subgraph = msg.fragment;
+    if(parent->pending_fragments.fetch_sub_acqrel(1) == 1)
+      GenEventImpl::trigger(parent->fragments_ready, false /*!poisoned*/);
+  }
+
+  ActiveMessageHandlerReg<SubgraphFragmentCreatedMessage> subgraph_fragment_created_message_handler;
+
+
   ////////////////////////////////////////////////////////////////////////
   //
   // class SubgraphDestroyMessage
@@ -969,11 +1950,7 @@ namespace Realm {
 							 const void *data, size_t datalen)
   {
     SubgraphImpl *subgraph = get_runtime()->get_subgraph_impl(msg.subgraph);
-
-    if(msg.wait_on.has_triggered())
-      subgraph->destroy();
-    else
-      subgraph->deferred_destroy.defer(subgraph, msg.wait_on);
+    subgraph->request_destroy(msg.wait_on);
   }
 
   ActiveMessageHandlerReg<SubgraphDestroyMessage> subgraph_destroy_message_handler;
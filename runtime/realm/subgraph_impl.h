@@ -24,6 +24,18 @@
 
 namespace Realm {
 
+  class ProcessorImpl;
+
+  namespace Config {
+    // if true, subgraphs made up only of tasks on local processors are
+    //  executed from precomputed dependence counts instead of events
+    extern bool static_subgraphs;
+
+    // if true, task-only subgraphs that use processors on other nodes are
+    //  split into per-node fragments that are created on those nodes
+    extern bool partition_subgraphs;
+  };
+
   struct SubgraphScheduleEntry {
     SubgraphDefinition::OpKind op_kind;
     unsigned op_index;
@@ -49,6 +61,15 @@ namespace Realm {
     // compile/analyze the subgraph
     bool compile(void);
 
+    // checks whether the subgraph can use static execution and if so
+    //  computes the dependence counts and successor lists it needs
+    bool compile_static(void);
+
+    // splits the subgraph into one fragment per node if it is eligible and
+    //  uses remote processors - 'ready_event' is set to an event that
+    //  triggers once every remote fragment has been created
+    bool partition(Event& ready_event);
+
     void instantiate(const void *args, size_t arglen,
 		     const ProfilingRequestSet& prs,
 		     span<const Event> preconditions,
@@ -56,8 +77,36 @@ namespace Realm {
 		     Event start_event, Event finish_event,
 		     int priority_adjust);
 
+    // static execution: one allocation holds the dependence counters for
+    //  all operations, which are launched as their counters reach zero -
+    //  external preconditions and the start event count down their
+    //  successors just like tasks do
+    void instantiate_static(const void *args, size_t arglen,
+			    span<const Event> preconditions,
+			    span<const Event> postconditions,
+			    Event start_event, Event finish_event,
+			    int priority_adjust);
+
+    // partitioned execution: one instantiation message per node, with
+    //  events only for the dependencies that cross nodes (and for the
+    //  fragments' contributions to external postconditions)
+    void instantiate_partitioned(const void *args, size_t arglen,
+				 const ProfilingRequestSet& prs,
+				 span<const Event> preconditions,
+				 span<const Event> postconditions,
+				 Event start_event, Event finish_event,
+				 int priority_adjust);
+
+    // destroys the subgraph once wait_on has triggered, any partitioned
+    //  instantiations have been issued to the fragments and any static
+    //  instances have finished
+    void request_destroy(Event wait_on);
+    void remove_destroy_reference(void);
     void destroy(void);
 
+    class StaticInstance;
+    class DeferredInstantiation;
+
     class DeferredDestroy : public EventWaiter {
     public:
       void defer(SubgraphImpl *_subgraph, Event wait_on);
@@ -76,6 +125,43 @@ namespace Realm {
     std::vector<SubgraphScheduleEntry> schedule;
     size_t num_intermediate_events, num_final_events, max_preconditions;
 
+    // static execution data, indexed by schedule entry - the tasks come
+    //  first, followed by any external postconditions
+    bool is_static;
+    unsigned static_num_tasks;
+    std::vector<unsigned> static_counts;
+    std::vector<unsigned> static_succ_offsets;  // size is schedule.size() + 1
+    std::vector<unsigned> static_successors;
+    std::vector<unsigned> static_roots;  // tasks that wait on the start event
+    std::vector<ProcessorImpl *> static_procs;
+    // successors of each external precondition
+    std::vector<unsigned> static_ext_pre_offsets;
+    std::vector<unsigned> static_ext_pre_successors;
+
+    // partitioned execution data - each cross-node dependency is an edge
+    //  that is an external postcondition of its source fragment and an
+    //  external precondition of its target fragment, the subgraph's own
+    //  external preconditions are edges into the fragments that use them,
+    //  and each fragment's contribution to one of the subgraph's external
+    //  postconditions is an edge out of it
+    struct Fragment {
+      NodeID node;
+      Subgraph subgraph;
+      std::vector<unsigned> in_edges, out_edges;
+    };
+    bool is_partitioned;
+    std::vector<Fragment> fragments;
+    // edges are numbered external preconditions first, then cross-node
+    //  dependencies, then postcondition contributions
+    unsigned num_ext_pre_edges, num_cross_edges, num_edges;
+    std::vector<std::vector<unsigned> > ext_post_edges;
+    atomic<unsigned> pending_fragments;
+    Event fragments_ready;
+    // one reference for the destroy request plus one for each instantiation
+    //  still waiting for the fragments and each static instance still
+    //  running - the last one removed destroys
+    atomic<unsigned> destroy_references;
+
     DeferredDestroy deferred_destroy;
   };
 
@@ -91,6 +177,24 @@ namespace Realm {
 			       const void *data, size_t datalen);
   };
 
+  // asks a node to create (and keep) its fragment of a partitioned subgraph
+  struct SubgraphCreateFragmentMessage {
+    Subgraph parent;
+    unsigned fragment_index;
+
+    static void handle_message(NodeID sender, const SubgraphCreateFragmentMessage& msg,
+			       const void *data, size_t datalen);
+  };
+
+  struct SubgraphFragmentCreatedMessage {
+    Subgraph parent;
+    unsigned fragment_index;
+    Subgraph fragment;
+
+    static void handle_message(NodeID sender, const SubgraphFragmentCreatedMessage& msg,
+			       const void *data, size_t datalen);
+  };
+
   struct SubgraphDestroyMessage {
     Subgraph subgraph;
     Event wait_on;
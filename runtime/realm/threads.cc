@@ -88,6 +88,113 @@ inline void makecontext_wrap(ucontext_t *u, void (*fn)(), int args, ...) { makec
 #define makecontext makecontext_wrap
 #endif
 #endif
+
+#ifdef REALM_USE_FAST_USWITCH
+// swapcontext saves and restores the signal mask on every call, which costs
+//  a sigprocmask syscall - this switch saves only the callee-saved registers
+//  and floating point control state on the current stack, stores the stack
+//  pointer in '*save_sp', and then resumes whatever was saved at 'new_sp'
+extern "C" void realm_fast_uswitch(void **save_sp, void *new_sp);
+
+#if defined(__x86_64__)
+asm(".pushsection .text\n"
+    ".globl realm_fast_uswitch\n"
+    ".hidden realm_fast_uswitch\n"
+    ".type realm_fast_uswitch, @function\n"
+    ".p2align 4\n"
+    "realm_fast_uswitch:\n"
+    "  pushq %rbp\n"
+    "  pushq %rbx\n"
+    "  pushq %r12\n"
+    "  pushq %r13\n"
+    "  pushq %r14\n"
+    "  pushq %r15\n"
+    "  subq $16, %rsp\n"
+    "  stmxcsr 8(%rsp)\n"
+    "  fnstcw (%rsp)\n"
+    "  movq %rsp, (%rdi)\n"
+    "  movq %rsi, %rsp\n"
+    "  fldcw (%rsp)\n"
+    "  ldmxcsr 8(%rsp)\n"
+    "  addq $16, %rsp\n"
+    "  popq %r15\n"
+    "  popq %r14\n"
+    "  popq %r13\n"
+    "  popq %r12\n"
+    "  popq %rbx\n"
+    "  popq %rbp\n"
+    "  ret\n"
+    ".size realm_fast_uswitch, .-realm_fast_uswitch\n"
+    ".popsection\n");
+
+// builds the frame that the first switch into a new stack will pop:
+//  fpu control words, six zeroed registers, the entry point as the return
+//  address, and a null return address for the entry point itself
+static void *realm_fast_uswitch_init(void *stack_base, size_t stack_size,
+                                     void (*entry)(void))
+{
+  uintptr_t top = (reinterpret_cast<uintptr_t>(stack_base) + stack_size) & ~uintptr_t(15);
+  uint64_t *frame = reinterpret_cast<uint64_t *>(top) - 10;
+  memset(frame, 0, 10 * sizeof(uint64_t));
+  frame[0] = 0x037F;  // default x87 control word
+  frame[1] = 0x1F80;  // default MXCSR
+  frame[8] = reinterpret_cast<uint64_t>(entry);
+  return frame;
+}
+#elif defined(__aarch64__)
+asm(".pushsection .text\n"
+    ".globl realm_fast_uswitch\n"
+    ".hidden realm_fast_uswitch\n"
+    ".type realm_fast_uswitch, %function\n"
+    ".p2align 4\n"
+    "realm_fast_uswitch:\n"
+    "  sub sp, sp, #176\n"
+    "  stp x19, x20, [sp, #0]\n"
+    "  stp x21, x22, [sp, #16]\n"
+    "  stp x23, x24, [sp, #32]\n"
+    "  stp x25, x26, [sp, #48]\n"
+    "  stp x27, x28, [sp, #64]\n"
+    "  stp x29, x30, [sp, #80]\n"
+    "  stp d8, d9, [sp, #96]\n"
+    "  stp d10, d11, [sp, #112]\n"
+    "  stp d12, d13, [sp, #128]\n"
+    "  stp d14, d15, [sp, #144]\n"
+    "  mrs x9, fpcr\n"
+    "  str x9, [sp, #160]\n"
+    "  mov x9, sp\n"
+    "  str x9, [x0]\n"
+    "  mov sp, x1\n"
+    "  ldr x9, [sp, #160]\n"
+    "  msr fpcr, x9\n"
+    "  ldp d14, d15, [sp, #144]\n"
+    "  ldp d12, d13, [sp, #128]\n"
+    "  ldp d10, d11, [sp, #112]\n"
+    "  ldp d8, d9, [sp, #96]\n"
+    "  ldp x29, x30, [sp, #80]\n"
+    "  ldp x27, x28, [sp, #64]\n"
+    "  ldp x25, x26, [sp, #48]\n"
+    "  ldp x23, x24, [sp, #32]\n"
+    "  ldp x21, x22, [sp, #16]\n"
+    "  ldp x19, x20, [sp, #0]\n"
+    "  add sp, sp, #176\n"
+    "  ret\n"
+    ".size realm_fast_uswitch, .-realm_fast_uswitch\n"
+    ".popsection\n");
+
+// builds the frame that the first switch into a new stack will pop: zeroed
+//  registers (including the frame pointer and fpcr) with the entry point as
+//  the link register
+static void *realm_fast_uswitch_init(void *stack_base, size_t stack_size,
+                                     void (*entry)(void))
+{
+  uintptr_t top = (reinterpret_cast<uintptr_t>(stack_base) + stack_size) & ~uintptr_t(15);
+  uint64_t *frame = reinterpret_cast<uint64_t *>(top) - 22;
+  memset(frame, 0, 22 * sizeof(uint64_t));
+  frame[11] = reinterpret_cast<uint64_t>(entry);  // x30
+  return frame;
+}
+#endif
+#endif
 #endif
 
 #ifdef REALM_USE_HWLOC
@@ -1350,6 +1457,11 @@ namespace Realm {
 #if defined(REALM_ON_LINUX) || defined(REALM_ON_MACOS) || defined(REALM_ON_FREEBSD)
     pthread_t host_pthread;
     ucontext_t ctx;
+#ifdef REALM_USE_FAST_USWITCH
+    // saved stack pointer when using realm_fast_uswitch instead of 'ctx'
+    void *fast_sp;
+    bool fast_switch;
+#endif
 #ifdef REALM_ON_MACOS
     // valgrind says Darwin's getcontext is writing past the end of ctx?
     int padding[512];
@@ -1370,6 +1482,9 @@ namespace Realm {
     , magic(MAGIC_VALUE)
 #if defined(REALM_ON_LINUX) || defined(REALM_ON_MACOS) || defined(REALM_ON_FREEBSD)
     , stack_base(0)
+#endif
+#ifdef REALM_USE_FAST_USWITCH
+    , fast_sp(0), fast_switch(false)
 #endif
     , stack_size(0), ok_to_delete(false)
     , running(false)
@@ -1394,6 +1509,9 @@ namespace Realm {
 #if defined(REALM_ON_LINUX) || defined(REALM_ON_MACOS) || defined(REALM_ON_FREEBSD)
     REALM_THREAD_LOCAL ucontext_t *host_context = 0;
 #endif
+#ifdef REALM_USE_FAST_USWITCH
+    REALM_THREAD_LOCAL void **host_fast_sp = 0;
+#endif
 #ifdef REALM_ON_WINDOWS
     REALM_THREAD_LOCAL LPVOID host_context = 0;
 #endif
@@ -1469,16 +1587,25 @@ namespace Realm {
     stack_base = malloc(stack_size);
     assert(stack_base != 0);
 
-    CHECK_LIBC( getcontext(&ctx) );
+#ifdef REALM_USE_FAST_USWITCH
+    fast_switch = !Config::preserve_uswitch_sigmask;
+    if(fast_switch) {
+      // as with makecontext, the entry point fishes our UserThread * out of TLS
+      fast_sp = realm_fast_uswitch_init(stack_base, stack_size, uthread_entry);
+    } else
+#endif
+    {
+      CHECK_LIBC( getcontext(&ctx) );
 
-    ctx.uc_link = 0; // we don't expect it to ever fall through
-    ctx.uc_stack.ss_sp = stack_base;
-    ctx.uc_stack.ss_size = stack_size;
-    ctx.uc_stack.ss_flags = 0;
+      ctx.uc_link = 0; // we don't expect it to ever fall through
+      ctx.uc_stack.ss_sp = stack_base;
+      ctx.uc_stack.ss_size = stack_size;
+      ctx.uc_stack.ss_flags = 0;
 
-    // grr...  entry point takes int's, which might not hold a void *
-    // we'll just fish our UserThread * out of TLS
-    makecontext(&ctx, uthread_entry, 0);
+      // grr...  entry point takes int's, which might not hold a void *
+      // we'll just fish our UserThread * out of TLS
+      makecontext(&ctx, uthread_entry, 0);
+    }
 #endif
 #ifdef REALM_ON_WINDOWS
     fiber = CreateFiberEx(stack_size, stack_size,
@@ -1531,12 +1658,31 @@ namespace Realm {
       ThreadLocal::current_thread = switch_to;
 
 #if defined(REALM_ON_LINUX) || defined(REALM_ON_MACOS) || defined(REALM_ON_FREEBSD)
-      // this holds the host's state
-      ucontext_t host_ctx;
+#ifdef REALM_USE_FAST_USWITCH
+      if(switch_to->fast_switch) {
+        // this holds the host's stack pointer
+        void *host_sp = 0;
+
+        ThreadLocal::host_fast_sp = &host_sp;
 
-      ThreadLocal::host_context = &host_ctx;
+        realm_fast_uswitch(&host_sp, switch_to->fast_sp);
 
-      CHECK_LIBC( swapcontext(&host_ctx, &switch_to->ctx) );
+        assert(ThreadLocal::current_user_thread == 0);
+        assert(ThreadLocal::host_fast_sp == &host_sp);
+        ThreadLocal::host_fast_sp = 0;
+      } else
+#endif
+      {
+        // this holds the host's state
+        ucontext_t host_ctx;
+
+        ThreadLocal::host_context = &host_ctx;
+
+        CHECK_LIBC( swapcontext(&host_ctx, &switch_to->ctx) );
+
+        assert(ThreadLocal::current_user_thread == 0);
+        assert(ThreadLocal::host_context == &host_ctx);
+      }
 #endif
 #ifdef REALM_ON_WINDOWS
       LPVOID host_ctx = ConvertThreadToFiberEx(0, 0);
@@ -1544,11 +1690,8 @@ namespace Realm {
       ThreadLocal::host_context = host_ctx;
 
       SwitchToFiber(switch_to->fiber);
-#endif
 
       assert(ThreadLocal::current_user_thread == 0);
-#if defined(REALM_ON_LINUX) || defined(REALM_ON_MACOS) || defined(REALM_ON_FREEBSD)
-      assert(ThreadLocal::host_context == &host_ctx);
 #endif
 #ifdef REALM_ON_WINDOWS
       assert(ThreadLocal::host_context == host_ctx);
@@ -1574,7 +1717,12 @@ namespace Realm {
 
 	// a switch between two user contexts - nice and simple
 #if defined(REALM_ON_LINUX) || defined(REALM_ON_MACOS) || defined(REALM_ON_FREEBSD)
-	CHECK_LIBC( swapcontext(&switch_from->ctx, &switch_to->ctx) );
+#ifdef REALM_USE_FAST_USWITCH
+	if(switch_from->fast_switch)
+	  realm_fast_uswitch(&switch_from->fast_sp, switch_to->fast_sp);
+	else
+#endif
+	  CHECK_LIBC( swapcontext(&switch_from->ctx, &switch_to->ctx) );
 	switch_from->host_pthread = pthread_self();
 #endif
 #ifdef REALM_ON_WINDOWS
@@ -1585,15 +1733,25 @@ namespace Realm {
 	switch_from->running = true;
       } else {
 	// a return of control to the host thread
-	assert(ThreadLocal::host_context != 0);
-
 	ThreadLocal::current_thread = ThreadLocal::current_host_thread;
 	ThreadLocal::current_host_thread = 0;
 
 #if defined(REALM_ON_LINUX) || defined(REALM_ON_MACOS) || defined(REALM_ON_FREEBSD)
-	CHECK_LIBC( swapcontext(&switch_from->ctx, ThreadLocal::host_context) );
+#ifdef REALM_USE_FAST_USWITCH
+	if(switch_from->fast_switch) {
+	  assert(ThreadLocal::host_fast_sp != 0);
+	  realm_fast_uswitch(&switch_from->fast_sp, *ThreadLocal::host_fast_sp);
+	} else
+#endif
+	{
+	  assert(ThreadLocal::host_context != 0);
+	  CHECK_LIBC( swapcontext(&switch_from->ctx, ThreadLocal::host_context) );
+	}
 	switch_from->host_pthread = pthread_self();
 #endif
+#ifdef REALM_ON_WINDOWS
+	assert(ThreadLocal::host_context != 0);
+#endif
 #ifdef REALM_ON_WINDOWS
   SwitchToFiber(ThreadLocal::host_context);
 #endif
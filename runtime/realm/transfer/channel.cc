@@ -26,6 +26,7 @@
 #include "realm/transfer/lowlevel_dma.h"
 #include "realm/transfer/ib_memory.h"
 #include "realm/utils.h"
+#include "realm/caching_allocator.h"
 
 #include <algorithm>
 
@@ -989,6 +990,24 @@ namespace Realm {
           free(fill_data);
       };
 
+      /*static*/ void *XferDes::operator new(size_t size)
+      {
+#if REALM_USE_CACHING_ALLOCATOR
+        return SizeClassCachingAllocator::alloc_obj(size);
+#else
+        return ::operator new(size);
+#endif
+      }
+
+      /*static*/ void XferDes::operator delete(void *ptr, size_t size)
+      {
+#if REALM_USE_CACHING_ALLOCATOR
+        SizeClassCachingAllocator::free_obj(ptr, size);
+#else
+        ::operator delete(ptr);
+#endif
+      }
+
       Event XferDes::request_metadata()
       {
 	std::vector<Event> preconditions;
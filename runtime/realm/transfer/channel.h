@@ -368,6 +368,11 @@ namespace Realm {
 	      int _priority,
               const void *_fill_data, size_t fill_size);
 
+      // transfer descriptors are created and destroyed by many threads, so
+      //  they come from thread-local caching allocator blocks
+      static void *operator new(size_t size);
+      static void operator delete(void *ptr, size_t size);
+
       // transfer descriptors are reference counted rather than explcitly
       //  deleted
       void add_reference(void);
@@ -838,6 +838,15 @@ ifeq ($(strip $(USE_ZLIB)),1)
   SLIB_LEGION_DEPS += -l$(ZLIB_LIBNAME)
 endif
 
+# liblz4 (optional compression of large Legion messages)
+USE_LZ4 ?= 0
+LZ4_LIBNAME ?= lz4
+ifeq ($(strip $(USE_LZ4)),1)
+  LEGION_CC_FLAGS += -DLEGION_USE_LZ4
+  LEGION_LD_FLAGS += -l$(LZ4_LIBNAME)
+  SLIB_LEGION_DEPS += -l$(LZ4_LIBNAME)
+endif
+
 # capture backtrace using unwind
 REALM_BACKTRACE_USE_UNWIND ?= 1
 ifeq ($(strip $(REALM_BACKTRACE_USE_UNWIND)),1)
@@ -923,6 +932,17 @@ ifneq ($(strip ${MAX_FIELDS}),)
 LEGION_CC_FLAGS	+= -DLEGION_MAX_FIELDS=$(MAX_FIELDS)
 endif
 
+# Optionally use sparse field masks (experimental, still bounded by MAX_FIELDS)
+ifeq ($(strip ${SPARSE_FIELD_MASKS}),1)
+LEGION_CC_FLAGS += -DLEGION_SPARSE_FIELD_MASKS
+endif
+
+# Optionally pick the field mask vector instructions at runtime (useful for
+# portable builds that still want AVX2/AVX-512 on machines that have them)
+ifeq ($(strip ${DISPATCH_FIELD_MASKS}),1)
+LEGION_CC_FLAGS += -DLEGION_DISPATCH_FIELD_MASKS
+endif
+
 # Optionally make all Legion warnings fatal
 ifeq ($(strip ${LEGION_WARNINGS_FATAL}),1)
 LEGION_CC_FLAGS += -DLEGION_WARNINGS_FATAL
@@ -1108,6 +1128,7 @@ REALM_SRC 	+= $(LG_RT_DIR)/realm/activemsg.cc \
 REALM_SRC 	+= $(LG_RT_DIR)/realm/logging.cc \
 	           $(LG_RT_DIR)/realm/cmdline.cc \
 		   $(LG_RT_DIR)/realm/profiling.cc \
+		   $(LG_RT_DIR)/realm/profiling_impl.cc \
 	           $(LG_RT_DIR)/realm/codedesc.cc \
 		   $(LG_RT_DIR)/realm/timers.cc \
 		   $(LG_RT_DIR)/realm/utils.cc
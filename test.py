@@ -99,6 +99,7 @@ legion_cxx_tests = [
     ['test/ctrl_repl_safety/ctrl_repl_safety', [':0:1', '-ll:cpu', '4', '-lg:safe_ctrlrepl', '1']],
     ['test/ctrl_repl_safety/ctrl_repl_safety', [':1:0', '-ll:cpu', '4']],
     ['test/ctrl_repl_safety/ctrl_repl_safety', [':1:1', '-ll:cpu', '4', '-lg:safe_ctrlrepl', '1']],
+    ['test/shard_collectives/shard_collectives', ['-ll:cpu', '3']],
     ['test/mapper/mapper', []],
 
     # Tutorial/realm
@@ -159,6 +160,8 @@ legion_network_cxx_tests = [
     ['examples/mpi_with_ctrl_repl/mpi_with_ctrl_repl', []],
     # Tests
     ['test/bug954/bug954', ['-ll:rsize', '1024']],
+    ['test/shard_collectives/shard_collectives', ['-ll:cpu', '3']],
+    ['test/shard_collectives/shard_collectives', ['-ll:cpu', '3', '-lg:flat_collectives']],
 ]
 
 legion_openmp_cxx_tests = [
@@ -0,0 +1,158 @@
+/* Copyright 2024 Stanford University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures the logical dependence analysis throughput of a context that
+// launches index tasks over several independent region trees, like the
+// components of a multi-physics application. Each iteration launches one
+// index task over a partition of every tree so consecutive operations
+// never share a region tree. Run with and without -lg:parallel_analysis
+// (and with several -ll:util processors) to compare the two modes.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "legion.h"
+
+using namespace Legion;
+
+enum TaskIDs
+{
+  TOP_LEVEL_TASK_ID,
+  TOUCH_TASK_ID,
+};
+
+enum FieldIDs
+{
+  FID_X = 100,
+};
+
+void touch_task(const Task *task,
+                const std::vector<PhysicalRegion> &regions,
+                Context ctx, Runtime *runtime)
+{
+  // Nothing to do, we only care about the runtime overhead
+}
+
+static double run_experiment(Context ctx, Runtime *runtime,
+                             unsigned num_trees, unsigned num_iterations,
+                             unsigned num_warmup, IndexSpace is,
+                             IndexSpace colors, FieldSpace fs)
+{
+  std::vector<LogicalRegion> regions(num_trees);
+  std::vector<LogicalPartition> partitions(num_trees);
+  for (unsigned idx = 0; idx < num_trees; idx++)
+  {
+    regions[idx] = runtime->create_logical_region(ctx, is, fs);
+    const IndexPartition ip = runtime->create_equal_partition(ctx, is, colors);
+    partitions[idx] = runtime->get_logical_partition(regions[idx], ip);
+  }
+  double start = 0.0;
+  for (unsigned iter = 0; iter < (num_warmup + num_iterations); iter++)
+  {
+    if (iter == num_warmup)
+    {
+      runtime->issue_execution_fence(ctx).get_void_result();
+      start = Realm::Clock::current_time_in_microseconds();
+    }
+    for (unsigned idx = 0; idx < num_trees; idx++)
+    {
+      IndexTaskLauncher launcher(TOUCH_TASK_ID, colors, TaskArgument(),
+                                 ArgumentMap());
+      launcher.add_region_requirement(
+          RegionRequirement(partitions[idx], 0/*identity projection*/,
+                            LEGION_READ_WRITE, LEGION_EXCLUSIVE,
+                            regions[idx]));
+      launcher.add_field(0/*index*/, FID_X);
+      runtime->execute_index_space(ctx, launcher);
+    }
+  }
+  runtime->issue_execution_fence(ctx).get_void_result();
+  const double stop = Realm::Clock::current_time_in_microseconds();
+  for (unsigned idx = 0; idx < num_trees; idx++)
+  {
+    runtime->destroy_index_partition(ctx, partitions[idx].get_index_partition());
+    runtime->destroy_logical_region(ctx, regions[idx]);
+  }
+  return (stop - start) / num_iterations;
+}
+
+void top_level_task(const Task *task,
+                    const std::vector<PhysicalRegion> &regions,
+                    Context ctx, Runtime *runtime)
+{
+  unsigned max_trees = 64;
+  unsigned num_pieces = 16;
+  unsigned num_iterations = 100;
+  unsigned num_warmup = 5;
+  const InputArgs &args = Runtime::get_input_args();
+  for (int i = 1; i < args.argc; i++)
+  {
+    if (!strcmp(args.argv[i], "-n"))
+      max_trees = atoi(args.argv[++i]);
+    else if (!strcmp(args.argv[i], "-p"))
+      num_pieces = atoi(args.argv[++i]);
+    else if (!strcmp(args.argv[i], "-i"))
+      num_iterations = atoi(args.argv[++i]);
+    else if (!strcmp(args.argv[i], "-w"))
+      num_warmup = atoi(args.argv[++i]);
+  }
+  if ((max_trees == 0) || (num_pieces == 0) || (num_iterations == 0))
+  {
+    fprintf(stderr, "Need at least one tree, piece, and iteration\n");
+    exit(1);
+  }
+
+  const IndexSpace is = runtime->create_index_space(ctx,
+      Rect<1>(0, 1024 * num_pieces - 1));
+  const IndexSpace colors = runtime->create_index_space(ctx,
+      Rect<1>(0, num_pieces - 1));
+  const FieldSpace fs = runtime->create_field_space(ctx);
+  {
+    FieldAllocator allocator = runtime->create_field_allocator(ctx, fs);
+    allocator.allocate_field(sizeof(double), FID_X);
+  }
+
+  printf("%10s %20s %20s\n", "trees", "us per iteration", "us per launch");
+  for (unsigned num_trees = 1; num_trees <= max_trees; num_trees *= 2)
+  {
+    const double per_iteration = run_experiment(ctx, runtime, num_trees,
+        num_iterations, num_warmup, is, colors, fs);
+    printf("%10u %20.2f %20.3f\n", num_trees, per_iteration,
+           per_iteration / num_trees);
+  }
+
+  runtime->destroy_field_space(ctx, fs);
+  runtime->destroy_index_space(ctx, colors);
+  runtime->destroy_index_space(ctx, is);
+}
+
+int main(int argc, char **argv)
+{
+  Runtime::set_top_level_task_id(TOP_LEVEL_TASK_ID);
+  {
+    TaskVariantRegistrar registrar(TOP_LEVEL_TASK_ID, "top_level");
+    registrar.add_constraint(ProcessorConstraint(Processor::LOC_PROC));
+    Runtime::preregister_task_variant<top_level_task>(registrar, "top_level");
+  }
+  {
+    TaskVariantRegistrar registrar(TOUCH_TASK_ID, "touch");
+    registrar.add_constraint(ProcessorConstraint(Processor::LOC_PROC));
+    registrar.set_leaf();
+    Runtime::preregister_task_variant<touch_task>(registrar, "touch");
+  }
+  return Runtime::start(argc, argv);
+}
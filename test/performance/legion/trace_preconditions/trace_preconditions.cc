@@ -0,0 +1,150 @@
+/* Copyright 2024 Stanford University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Measures the per-replay overhead of a physical trace as a function of
+// the number of regions named by the trace. Each iteration replays the
+// trace and then touches a single region outside of the trace so that
+// every replay is non-recurrent and must test the template preconditions.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "legion.h"
+
+using namespace Legion;
+
+enum TaskIDs
+{
+  TOP_LEVEL_TASK_ID,
+  TOUCH_TASK_ID,
+};
+
+enum FieldIDs
+{
+  FID_X = 100,
+};
+
+void touch_task(const Task *task,
+                const std::vector<PhysicalRegion> &regions,
+                Context ctx, Runtime *runtime)
+{
+  // Nothing to do, we only care about the runtime overhead
+}
+
+static double run_experiment(Context ctx, Runtime *runtime,
+                             unsigned num_regions, unsigned num_iterations,
+                             unsigned num_warmup, IndexSpace is,
+                             FieldSpace fs)
+{
+  std::vector<LogicalRegion> regions(num_regions);
+  for (unsigned idx = 0; idx < num_regions; idx++)
+    regions[idx] = runtime->create_logical_region(ctx, is, fs);
+  const TraceID tid = num_regions;
+  double start = 0.0;
+  for (unsigned iter = 0; iter < (num_warmup + num_iterations); iter++)
+  {
+    if (iter == num_warmup)
+    {
+      runtime->issue_execution_fence(ctx).get_void_result();
+      start = Realm::Clock::current_time_in_microseconds();
+    }
+    runtime->begin_trace(ctx, tid);
+    for (unsigned idx = 0; idx < num_regions; idx++)
+    {
+      TaskLauncher launcher(TOUCH_TASK_ID, TaskArgument());
+      launcher.add_region_requirement(
+          RegionRequirement(regions[idx], LEGION_READ_WRITE,
+                            LEGION_EXCLUSIVE, regions[idx]));
+      launcher.add_field(0/*index*/, FID_X);
+      runtime->execute_task(ctx, launcher);
+    }
+    runtime->end_trace(ctx, tid);
+    // Touch one region outside the trace so the next replay is not
+    // recurrent and has to check the preconditions of the template
+    TaskLauncher launcher(TOUCH_TASK_ID, TaskArgument());
+    launcher.add_region_requirement(
+        RegionRequirement(regions[0], LEGION_READ_ONLY,
+                          LEGION_EXCLUSIVE, regions[0]));
+    launcher.add_field(0/*index*/, FID_X);
+    runtime->execute_task(ctx, launcher);
+  }
+  runtime->issue_execution_fence(ctx).get_void_result();
+  const double stop = Realm::Clock::current_time_in_microseconds();
+  for (unsigned idx = 0; idx < num_regions; idx++)
+    runtime->destroy_logical_region(ctx, regions[idx]);
+  return (stop - start) / num_iterations;
+}
+
+void top_level_task(const Task *task,
+                    const std::vector<PhysicalRegion> &regions,
+                    Context ctx, Runtime *runtime)
+{
+  unsigned max_regions = 256;
+  unsigned num_iterations = 100;
+  unsigned num_warmup = 5;
+  const InputArgs &args = Runtime::get_input_args();
+  for (int i = 1; i < args.argc; i++)
+  {
+    if (!strcmp(args.argv[i], "-r"))
+      max_regions = atoi(args.argv[++i]);
+    else if (!strcmp(args.argv[i], "-i"))
+      num_iterations = atoi(args.argv[++i]);
+    else if (!strcmp(args.argv[i], "-w"))
+      num_warmup = atoi(args.argv[++i]);
+  }
+  if ((max_regions == 0) || (num_iterations == 0))
+  {
+    fprintf(stderr, "Need at least one region and one iteration\n");
+    exit(1);
+  }
+
+  const IndexSpace is = runtime->create_index_space(ctx, Rect<1>(0, 1023));
+  const FieldSpace fs = runtime->create_field_space(ctx);
+  {
+    FieldAllocator allocator = runtime->create_field_allocator(ctx, fs);
+    allocator.allocate_field(sizeof(double), FID_X);
+  }
+
+  printf("%10s %20s %20s\n", "regions", "us per iteration", "us per region");
+  for (unsigned num_regions = 1; num_regions <= max_regions; num_regions *= 2)
+  {
+    const double per_iteration = run_experiment(ctx, runtime, num_regions,
+        num_iterations, num_warmup, is, fs);
+    printf("%10u %20.2f %20.3f\n", num_regions, per_iteration,
+           per_iteration / num_regions);
+  }
+
+  runtime->destroy_field_space(ctx, fs);
+  runtime->destroy_index_space(ctx, is);
+}
+
+int main(int argc, char **argv)
+{
+  Runtime::set_top_level_task_id(TOP_LEVEL_TASK_ID);
+  {
+    TaskVariantRegistrar registrar(TOP_LEVEL_TASK_ID, "top_level");
+    registrar.add_constraint(ProcessorConstraint(Processor::LOC_PROC));
+    Runtime::preregister_task_variant<top_level_task>(registrar, "top_level");
+  }
+  {
+    TaskVariantRegistrar registrar(TOUCH_TASK_ID, "touch");
+    registrar.add_constraint(ProcessorConstraint(Processor::LOC_PROC));
+    registrar.set_leaf();
+    Runtime::preregister_task_variant<touch_task>(registrar, "touch");
+  }
+  return Runtime::start(argc, argv);
+}
@@ -278,8 +278,9 @@ void top_level_task(const void *args, size_t arglen,
 
 	double elapsed = t_end - t_start;
 	double ns_per_switch = 1e9 * elapsed / num_iterations / num_children;
-	printf("switch: proc " IDFMT " (kind=%d) finished: elapsed=%5.2fs time/switch=%6.0fns\n",
-               pp.id, k, elapsed, ns_per_switch);
+	double switches_per_sec = (double(num_iterations) * num_children) / elapsed;
+	printf("switch: proc " IDFMT " (kind=%d) finished: elapsed=%5.2fs time/switch=%6.0fns switches/sec=%.3g\n",
+               pp.id, k, elapsed, ns_per_switch, switches_per_sec);
       }
 
       // now the sleep (i.e. kernel-level switching, if possible) test
@@ -8,6 +8,7 @@
 #include <cstring>
 #include <csignal>
 #include <cmath>
+#include <algorithm>
 
 #include <time.h>
 
@@ -28,6 +29,8 @@ namespace TestConfig {
   unsigned log2_size = 4;
   int random_tests = 20;
   int random_seed = 12345;
+  int bench_pieces = 256;
+  int bench_lookups = 1000000;
 };
 
 template <int N, typename T>
@@ -47,34 +50,15 @@ void ptr_write_task_cpu(const void *args, size_t arglen,
   }
 }
 
+// chops 'bounds' up into 'num_pieces' pieces with random split points
 template <int N, typename T>
-bool test_case(Processor curr_proc, Processor write_proc,
-	       IndexSpace<N,T> space, int num_pieces, int seed, int test_id)
+std::vector<Rect<N,T> > random_pieces(Rect<N,T> bounds, int num_pieces,
+				      int seed, int test_id)
 {
-  // choose memories for instances
-  Memory m_check = Machine::MemoryQuery(Machine::get_machine()).best_affinity_to(curr_proc).first();
-  Memory m_write = Machine::MemoryQuery(Machine::get_machine()).best_affinity_to(write_proc).first();
-  assert(m_check.exists() && m_write.exists());
-
-  // check instance is simple
-  RegionInstance inst_check;
-  {
-    std::map<FieldID, size_t> field_sizes;
-    field_sizes[FID_ADDR] = sizeof(void *);
-    int dim_order[N];
-    for(int i = 0; i < N; i++) dim_order[i] = i;
-    InstanceLayoutGeneric *ilg = InstanceLayoutGeneric::choose_instance_layout<N,T>(space,
-										    InstanceLayoutConstraints(field_sizes, 0 /*SOA*/),
-										    dim_order);
-    RegionInstance::create_instance(inst_check, m_check, ilg,
-				    ProfilingRequestSet()).wait();
-  }
-
-  // write instance is chopped up into pieces and reordered
   int seq_no = 0;
   std::vector<Rect<N,T> > pieces;
   pieces.reserve(num_pieces);
-  pieces.push_back(space.bounds);
+  pieces.push_back(bounds);
   for(int i = 1; i < num_pieces; i++) {
     int to_split, split_dim, split_idx;
     do {
@@ -94,21 +78,79 @@ bool test_case(Processor curr_proc, Processor write_proc,
     pieces[to_split].lo[split_dim] = split_idx + 1;
     pieces.push_back(r);
   }
+  return pieces;
+}
 
-  RegionInstance inst_write;
+// chops 'bounds' up into a regular grid of tiles - tiles at the upper edge
+//  are smaller if the extent isn't a multiple of the tile size, and the
+//  list is reversed so that pieces aren't laid out in grid order
+template <int N, typename T>
+std::vector<Rect<N,T> > grid_pieces(Rect<N,T> bounds, const T tile_size[N])
+{
+  std::vector<Rect<N,T> > pieces;
+  Rect<N,T> tiles;
+  for(int i = 0; i < N; i++) {
+    tiles.lo[i] = 0;
+    tiles.hi[i] = (bounds.hi[i] - bounds.lo[i]) / tile_size[i];
+  }
+  for(PointInRectIterator<N,T> pit(tiles); pit.valid; pit.step()) {
+    Rect<N,T> r;
+    for(int i = 0; i < N; i++) {
+      r.lo[i] = bounds.lo[i] + pit.p[i] * tile_size[i];
+      r.hi[i] = std::min<T>(r.lo[i] + tile_size[i] - 1, bounds.hi[i]);
+    }
+    pieces.push_back(r);
+  }
+  std::reverse(pieces.begin(), pieces.end());
+  return pieces;
+}
+
+template <int N, typename T>
+RegionInstance create_piece_instance(Memory m, IndexSpace<N,T> space,
+				     const std::vector<Rect<N,T> >& pieces)
+{
+  RegionInstance inst;
+  std::map<FieldID, size_t> field_sizes;
+  field_sizes[FID_ADDR] = sizeof(void *);
+  int dim_order[N];
+  for(int i = 0; i < N; i++) dim_order[i] = i;
+  InstanceLayoutGeneric *ilg = InstanceLayoutGeneric::choose_instance_layout<N,T>(space,
+										  pieces,
+										  InstanceLayoutConstraints(field_sizes, 0 /*SOA*/),
+										  dim_order);
+  RegionInstance::create_instance(inst, m, ilg,
+				  ProfilingRequestSet()).wait();
+  return inst;
+}
+
+template <int N, typename T>
+bool test_case(Processor curr_proc, Processor write_proc,
+	       IndexSpace<N,T> space, const std::vector<Rect<N,T> >& pieces)
+{
+  int num_pieces = pieces.size();
+
+  // choose memories for instances
+  Memory m_check = Machine::MemoryQuery(Machine::get_machine()).best_affinity_to(curr_proc).first();
+  Memory m_write = Machine::MemoryQuery(Machine::get_machine()).best_affinity_to(write_proc).first();
+  assert(m_check.exists() && m_write.exists());
+
+  // check instance is simple
+  RegionInstance inst_check;
   {
     std::map<FieldID, size_t> field_sizes;
     field_sizes[FID_ADDR] = sizeof(void *);
     int dim_order[N];
     for(int i = 0; i < N; i++) dim_order[i] = i;
     InstanceLayoutGeneric *ilg = InstanceLayoutGeneric::choose_instance_layout<N,T>(space,
-										    pieces,
 										    InstanceLayoutConstraints(field_sizes, 0 /*SOA*/),
 										    dim_order);
-    RegionInstance::create_instance(inst_write, m_write, ilg,
+    RegionInstance::create_instance(inst_check, m_check, ilg,
 				    ProfilingRequestSet()).wait();
   }
 
+  // write instance is chopped up into pieces and reordered
+  RegionInstance inst_write = create_piece_instance(m_write, space, pieces);
+
   // zero out write instance
   Event e;
   {
@@ -174,6 +216,44 @@ bool test_case(Processor curr_proc, Processor write_proc,
   return (errors == 0);
 }
 
+// measures the rate of random point lookups through a MultiAffineAccessor
+//  for an instance made of the given pieces
+template <int N, typename T>
+void bench_case(Processor curr_proc, IndexSpace<N,T> space,
+		const std::vector<Rect<N,T> >& pieces, const char *desc)
+{
+  Memory m = Machine::MemoryQuery(Machine::get_machine()).best_affinity_to(curr_proc).first();
+  assert(m.exists());
+  RegionInstance inst = create_piece_instance(m, space, pieces);
+
+  // precompute the points so that we time only the lookups
+  int num_points = 4096;
+  std::vector<Point<N,T> > points(num_points);
+  for(int i = 0; i < num_points; i++)
+    for(int j = 0; j < N; j++)
+      points[i][j] = (space.bounds.lo[j] +
+		      PRNG::rand_int(TestConfig::random_seed, pieces.size(),
+				     i * N + j,
+				     space.bounds.hi[j] - space.bounds.lo[j] + 1));
+
+  // the const accessor never caches the last piece, so every access is a
+  //  full lookup
+  const MultiAffineAccessor<void *,N,T> acc(inst, FID_ADDR);
+  uintptr_t sum = 0;
+  long long t_start = Clock::current_time_in_nanoseconds();
+  for(int i = 0; i < TestConfig::bench_lookups; i++)
+    sum += reinterpret_cast<uintptr_t>(acc.ptr(points[i & (num_points - 1)]));
+  long long t_end = Clock::current_time_in_nanoseconds();
+
+  double ns = double(t_end - t_start) / TestConfig::bench_lookups;
+  log_app.print() << "lookup bench: " << desc << ": N=" << N
+		  << " pieces=" << pieces.size()
+		  << " ns/lookup=" << ns
+		  << " (" << std::hex << sum << std::dec << ")";
+
+  inst.destroy();
+}
+
 void top_level_task(const void *args, size_t arglen, 
 		    const void *userdata, size_t userlen, Processor p)
 {
@@ -197,7 +277,11 @@ void top_level_task(const void *args, size_t arglen,
     bounds.lo[0] = 0;
     bounds.hi[0] = (1 << TestConfig::log2_size) - 1;
     if(!test_case(p, proc_write, IndexSpace<1>(bounds),
-		  8, TestConfig::random_seed, test_id))
+		  random_pieces(bounds, 8, TestConfig::random_seed, test_id)))
+      errors++;
+    int tile_size[1] = { 2 };
+    if(!test_case(p, proc_write, IndexSpace<1>(bounds),
+		  grid_pieces(bounds, tile_size)))
       errors++;
   }
 
@@ -210,8 +294,38 @@ void top_level_task(const void *args, size_t arglen,
     bounds.lo[1] = 0;
     bounds.hi[1] = (1 << ly2) - 1;
     if(!test_case(p, proc_write, IndexSpace<2>(bounds),
-		  8, TestConfig::random_seed, test_id))
+		  random_pieces(bounds, 8, TestConfig::random_seed, test_id)))
       errors++;
+    int tile_size[2] = { 1, 3 };
+    if(!test_case(p, proc_write, IndexSpace<2>(bounds),
+		  grid_pieces(bounds, tile_size)))
+      errors++;
+  }
+
+  if(TestConfig::bench_lookups > 0) {
+    // regular 1-D tiling uses a grid lookup
+    Rect<1> bounds1;
+    bounds1.lo[0] = 0;
+    bounds1.hi[0] = (TestConfig::bench_pieces * 64) - 1;
+    int tile_size1[1] = { 64 };
+    bench_case(p, IndexSpace<1>(bounds1),
+	       grid_pieces(bounds1, tile_size1), "regular");
+
+    // an irregular tiling uses split planes
+    bench_case(p, IndexSpace<1>(bounds1),
+	       random_pieces(bounds1, TestConfig::bench_pieces,
+			     TestConfig::random_seed, test_id),
+	       "irregular");
+
+    // and a 2-D tiling that is regular in both dimensions
+    Rect<2> bounds2;
+    bounds2.lo[0] = 0;
+    bounds2.hi[0] = (TestConfig::bench_pieces * 4) - 1;
+    bounds2.lo[1] = 0;
+    bounds2.hi[1] = 255;
+    int tile_size2[2] = { 64, 16 };
+    bench_case(p, IndexSpace<2>(bounds2),
+	       grid_pieces(bounds2, tile_size2), "regular");
   }
 
   // HACK: there's a shutdown race condition related to instance destruction
@@ -234,7 +348,9 @@ int main(int argc, char **argv)
   CommandLineParser cp;
   cp.add_option_int_units("-size", TestConfig::log2_size)
     .add_option_int("-dims", TestConfig::dim_mask)
-    .add_option_int("-seed", TestConfig::random_seed);
+    .add_option_int("-seed", TestConfig::random_seed)
+    .add_option_int("-bench_pieces", TestConfig::bench_pieces)
+    .add_option_int("-bench_lookups", TestConfig::bench_lookups);
   bool ok = cp.parse_command_line(argc, const_cast<const char **>(argv));
   assert(ok);
 
@@ -6,6 +6,7 @@
 #include <cstring>
 #include <csignal>
 #include <cmath>
+#include <atomic>
 
 #include <time.h>
 
@@ -21,6 +22,9 @@ enum {
   WRITER_TASK,
   READER_TASK,
   CLEANUP_TASK,
+  COUNTER_TASK,
+  CHAIN_TASK,
+  REPORT_TASK,
 };
 
 enum {
@@ -89,6 +93,66 @@ void reader_task(const void *args, size_t arglen,
     }
 }
 
+// used by the tasks-only subgraph, which can be executed statically
+struct CounterTaskArgs {
+  int increment;
+};
+
+struct CounterSubgraphArgs {
+  int increment;
+};
+
+std::atomic<int> counter_total(0);
+
+void counter_task(const void *args, size_t arglen,
+		  const void *userdata, size_t userlen, Processor p)
+{
+  const CounterTaskArgs& cargs = *static_cast<const CounterTaskArgs *>(args);
+  counter_total.fetch_add(cargs.increment);
+}
+
+size_t num_static_instances = 1000;
+size_t static_width = 8;
+
+// used by the chain subgraph, which visits every cpu in the machine in turn -
+//  each processor remembers the last step it ran so that the tasks can check
+//  that cross-node dependencies were honored
+static const int MAX_CHAIN_PROCS = 64;
+std::atomic<int> chain_last_step[MAX_CHAIN_PROCS];
+
+struct ChainTaskArgs {
+  int slot;
+  int step;
+  int prev_step;  // the step this processor ran before this one
+};
+
+void chain_task(const void *args, size_t arglen,
+		const void *userdata, size_t userlen, Processor p)
+{
+  const ChainTaskArgs& cargs = *static_cast<const ChainTaskArgs *>(args);
+  int last = chain_last_step[cargs.slot].exchange(cargs.step);
+  // the very first step on each processor has nothing before it
+  if((last != cargs.prev_step) && (last != -1)) {
+    log_app.error() << "chain out of order: proc=" << p << " step=" << cargs.step
+		    << " last=" << last << " expected=" << cargs.prev_step;
+    return;
+  }
+  counter_total.fetch_add(1);
+}
+
+struct ReportTaskArgs {
+  Barrier b;
+};
+
+// contributes this node's counter total to a barrier reduction
+void report_task(const void *args, size_t arglen,
+		 const void *userdata, size_t userlen, Processor p)
+{
+  const ReportTaskArgs& rargs = *static_cast<const ReportTaskArgs *>(args);
+  int total = counter_total.load();
+  rargs.b.arrive(1, Event::NO_EVENT, &total, sizeof(total));
+}
+
 struct CleanupTaskArgs {
   Event precond;
   Subgraph subgraph, subgraph_inner;
@@ -149,6 +213,301 @@ static size_t compute_offset(U T::*field_ptr)
 #define OFFSETOF(type, field) \
   compute_offset<type>(&type::field)
 
+// a fork-join graph of (width + 2) counter tasks on a single processor -
+//  the middle tasks get an interpolated increment
+static bool test_static_subgraph(Processor p)
+{
+  size_t num_tasks = static_width + 2;
+  SubgraphDefinition sd;
+  sd.tasks.resize(num_tasks);
+  CounterTaskArgs c_args;
+  c_args.increment = 1;
+  for(size_t i = 0; i < num_tasks; i++) {
+    sd.tasks[i].proc = p;
+    sd.tasks[i].task_id = COUNTER_TASK;
+    sd.tasks[i].args.set(&c_args, sizeof(c_args));
+  }
+  sd.dependencies.resize(2 * static_width);
+  sd.interpolations.resize(static_width);
+  for(size_t i = 0; i < static_width; i++) {
+    sd.dependencies[2 * i].src_op_kind = SubgraphDefinition::OPKIND_TASK;
+    sd.dependencies[2 * i].src_op_index = 0;
+    sd.dependencies[2 * i].tgt_op_kind = SubgraphDefinition::OPKIND_TASK;
+    sd.dependencies[2 * i].tgt_op_index = i + 1;
+    sd.dependencies[2 * i + 1].src_op_kind = SubgraphDefinition::OPKIND_TASK;
+    sd.dependencies[2 * i + 1].src_op_index = i + 1;
+    sd.dependencies[2 * i + 1].tgt_op_kind = SubgraphDefinition::OPKIND_TASK;
+    sd.dependencies[2 * i + 1].tgt_op_index = num_tasks - 1;
+
+    sd.interpolations[i].offset = OFFSETOF(CounterSubgraphArgs, increment);
+    sd.interpolations[i].bytes = sizeof(int);
+    sd.interpolations[i].target_kind = SubgraphDefinition::Interpolation::TARGET_TASK_ARGS;
+    sd.interpolations[i].target_index = i + 1;
+    sd.interpolations[i].target_offset = OFFSETOF(CounterTaskArgs, increment);
+    sd.interpolations[i].redop_id = 0;
+  }
+
+  Subgraph sg;
+  Subgraph::create_subgraph(sg, sd, ProfilingRequestSet()).wait();
+
+  // same graph issued directly, for comparison
+  counter_total.store(0);
+  long long t1 = Clock::current_time_in_nanoseconds();
+  Event e = Event::NO_EVENT;
+  for(size_t n = 0; n < num_static_instances; n++) {
+    CounterTaskArgs args;
+    args.increment = 1;
+    Event root = p.spawn(COUNTER_TASK, &args, sizeof(args), e);
+    std::vector<Event> middle(static_width);
+    args.increment = 2;
+    for(size_t i = 0; i < static_width; i++)
+      middle[i] = p.spawn(COUNTER_TASK, &args, sizeof(args), root);
+    args.increment = 1;
+    e = p.spawn(COUNTER_TASK, &args, sizeof(args),
+		Event::merge_events(middle));
+  }
+  e.wait();
+  long long t2 = Clock::current_time_in_nanoseconds();
+  int direct_total = counter_total.load();
+
+  counter_total.store(0);
+  e = Event::NO_EVENT;
+  for(size_t n = 0; n < num_static_instances; n++) {
+    CounterSubgraphArgs sg_args;
+    sg_args.increment = 2;
+    e = sg.instantiate(&sg_args, sizeof(sg_args), ProfilingRequestSet(), e);
+  }
+  e.wait();
+  long long t3 = Clock::current_time_in_nanoseconds();
+  int subgraph_total = counter_total.load();
+
+  sg.destroy();
+
+  log_app.print() << "fork-join: instances=" << num_static_instances
+		  << " tasks=" << num_tasks
+		  << " direct=" << (1e-3 * (t2 - t1) / num_static_instances) << " us"
+		  << " subgraph=" << (1e-3 * (t3 - t2) / num_static_instances) << " us";
+
+  int expected = num_static_instances * (2 + 2 * static_width);
+  if((direct_total != expected) || (subgraph_total != expected)) {
+    log_app.error() << "counter mismatch: exp=" << expected
+		    << " direct=" << direct_total
+		    << " subgraph=" << subgraph_total;
+    return false;
+  }
+  return true;
+}
+
+#ifndef _MSC_VER
+// peak resident set size of this process, in kilobytes
+static long peak_rss_kb(void)
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+}
+#endif
+
+// static subgraph tasks have no finish event, so make sure replaying one
+//  over and over does not keep accumulating completed task objects
+static bool test_static_subgraph_reuse(Processor p)
+{
+#ifdef _MSC_VER
+  return true;
+#else
+  size_t num_tasks = static_width + 2;
+  SubgraphDefinition sd;
+  sd.tasks.resize(num_tasks);
+  CounterTaskArgs c_args;
+  c_args.increment = 1;
+  for(size_t i = 0; i < num_tasks; i++) {
+    sd.tasks[i].proc = p;
+    sd.tasks[i].task_id = COUNTER_TASK;
+    sd.tasks[i].args.set(&c_args, sizeof(c_args));
+  }
+  sd.dependencies.resize(num_tasks - 1);
+  for(size_t i = 0; i < (num_tasks - 1); i++) {
+    sd.dependencies[i].src_op_kind = SubgraphDefinition::OPKIND_TASK;
+    sd.dependencies[i].src_op_index = i;
+    sd.dependencies[i].tgt_op_kind = SubgraphDefinition::OPKIND_TASK;
+    sd.dependencies[i].tgt_op_index = i + 1;
+  }
+
+  Subgraph sg;
+  Subgraph::create_subgraph(sg, sd, ProfilingRequestSet()).wait();
+
+  // a first batch of replays to get the runtime's pools and caches up to
+  //  their steady state size, then many more that should not grow anything
+  counter_total.store(0);
+  size_t warmup = num_static_instances;
+  size_t replays = 10 * num_static_instances;
+  Event e = Event::NO_EVENT;
+  for(size_t n = 0; n < warmup; n++)
+    e = sg.instantiate(0, 0, ProfilingRequestSet(), e);
+  e.wait();
+  long rss_before = peak_rss_kb();
+  for(size_t n = 0; n < replays; n++) {
+    e = sg.instantiate(0, 0, ProfilingRequestSet(), e);
+    // wait every so often so that completed replays can be cleaned up
+    //  before the peak is measured again
+    if((n % 100) == 99)
+      e.wait();
+  }
+  e.wait();
+  long rss_after = peak_rss_kb();
+  sg.destroy();
+
+  // a task object is a few hundred bytes, so leaking every task of every
+  //  replay would grow the peak by well over a kilobyte per replay
+  long growth_kb = rss_after - rss_before;
+  long limit_kb = 4096 + long(replays / 16);
+  log_app.print() << "static reuse: replays=" << replays
+		  << " tasks=" << num_tasks
+		  << " peak rss growth=" << growth_kb << " KB (limit "
+		  << limit_kb << " KB)";
+
+  int expected = (warmup + replays) * num_tasks;
+  if(counter_total.load() != expected) {
+    log_app.error() << "counter mismatch: exp=" << expected
+		    << " act=" << counter_total.load();
+    return false;
+  }
+  if(growth_kb > limit_kb) {
+    log_app.error() << "static subgraph replays grew peak rss by "
+		    << growth_kb << " KB";
+    return false;
+  }
+  return true;
+#endif
+}
+
+// a chain of tasks that visits every cpu in the machine over and over - with
+//  more than one rank, the subgraph is split into per-node fragments whose
+//  cross-node dependencies become external pre/postconditions of each
+//  fragment, and the chain itself starts and ends with an external
+//  precondition and postcondition of the whole subgraph
+static bool test_chain_subgraph(void)
+{
+  std::vector<Processor> procs;
+  std::map<AddressSpace, Processor> node_procs;
+  Machine::ProcessorQuery pq(Machine::get_machine());
+  pq.only_kind(Processor::LOC_PROC);
+  for(Machine::ProcessorQuery::iterator it = pq.begin(); it != pq.end(); ++it) {
+    if(procs.size() < size_t(MAX_CHAIN_PROCS))
+      procs.push_back(*it);
+    if(node_procs.count(it->address_space()) == 0)
+      node_procs[it->address_space()] = *it;
+  }
+  int num_procs = procs.size();
+  int rounds = 4;
+  int num_tasks = rounds * num_procs;
+
+  SubgraphDefinition sd;
+  sd.tasks.resize(num_tasks);
+  for(int i = 0; i < num_tasks; i++) {
+    ChainTaskArgs c_args;
+    c_args.slot = i % num_procs;
+    c_args.step = i;
+    c_args.prev_step = ((i >= num_procs) ? (i - num_procs) :
+			                   (i + num_tasks - num_procs));
+    sd.tasks[i].proc = procs[i % num_procs];
+    sd.tasks[i].task_id = CHAIN_TASK;
+    sd.tasks[i].args.set(&c_args, sizeof(c_args));
+  }
+  sd.dependencies.resize(num_tasks + 1);
+  sd.dependencies[0].src_op_kind = SubgraphDefinition::OPKIND_EXT_PRECOND;
+  sd.dependencies[0].src_op_index = 0;
+  sd.dependencies[0].tgt_op_kind = SubgraphDefinition::OPKIND_TASK;
+  sd.dependencies[0].tgt_op_index = 0;
+  for(int i = 1; i < num_tasks; i++) {
+    sd.dependencies[i].src_op_kind = SubgraphDefinition::OPKIND_TASK;
+    sd.dependencies[i].src_op_index = i - 1;
+    sd.dependencies[i].tgt_op_kind = SubgraphDefinition::OPKIND_TASK;
+    sd.dependencies[i].tgt_op_index = i;
+  }
+  sd.dependencies[num_tasks].src_op_kind = SubgraphDefinition::OPKIND_TASK;
+  sd.dependencies[num_tasks].src_op_index = num_tasks - 1;
+  sd.dependencies[num_tasks].tgt_op_kind = SubgraphDefinition::OPKIND_EXT_POSTCOND;
+  sd.dependencies[num_tasks].tgt_op_index = 0;
+
+  Subgraph sg;
+  Subgraph::create_subgraph(sg, sd, ProfilingRequestSet()).wait();
+
+  counter_total.store(0);
+  size_t instances = num_static_instances / 10;
+  Event e = Event::NO_EVENT;
+  bool ok = true;
+  for(size_t n = 0; n < instances; n++) {
+    UserEvent start = UserEvent::create_user_event();
+    std::vector<Event> preconds(1, start);
+    std::vector<Event> postconds(1);
+    Event finish = sg.instantiate(0, 0, ProfilingRequestSet(),
+				  preconds, postconds, e);
+    // nothing may run until the external precondition triggers
+    if((n == 0) && (postconds[0].has_triggered() || finish.has_triggered())) {
+      log_app.error() << "chain subgraph ran before its precondition";
+      ok = false;
+    }
+    start.trigger();
+    postconds[0].wait();
+    e = finish;
+  }
+  e.wait();
+  sg.destroy();
+
+  // run one more copy that is instantiated and destroyed before it is even
+  //  ready - with more than one rank the instantiation has to wait for the
+  //  remote fragments to be created and the destroy has to wait for both
+  {
+    Subgraph sg_early;
+    Event ready = Subgraph::create_subgraph(sg_early, sd, ProfilingRequestSet());
+    UserEvent start = UserEvent::create_user_event();
+    std::vector<Event> preconds(1, start);
+    std::vector<Event> postconds(1);
+    Event finish = sg_early.instantiate(0, 0, ProfilingRequestSet(),
+					preconds, postconds);
+    sg_early.destroy();
+    start.trigger();
+    finish.wait();
+    ready.wait();
+    instances++;
+  }
+
+  // add up the chain steps that ran (in order) on every node
+  Barrier b = Barrier::create_barrier(node_procs.size(), REDOP_INT_ADD,
+				      &ReductionOpIntAdd::identity,
+				      sizeof(ReductionOpIntAdd::RHS));
+  for(std::map<AddressSpace, Processor>::const_iterator it = node_procs.begin();
+      it != node_procs.end();
+      ++it) {
+    ReportTaskArgs r_args;
+    r_args.b = b;
+    it->second.spawn(REPORT_TASK, &r_args, sizeof(r_args));
+  }
+  b.wait();
+  int total = 0;
+  {
+    bool ok = b.get_result(&total, sizeof(total));
+    assert(ok);
+  }
+  b.destroy_barrier();
+
+  log_app.print() << "chain: nodes=" << node_procs.size()
+		  << " procs=" << num_procs << " tasks=" << num_tasks
+		  << " instances=" << instances;
+
+  int expected = instances * num_tasks;
+  if(total != expected) {
+    log_app.error() << "chain mismatch: exp=" << expected << " act=" << total;
+    ok = false;
+  }
+  return ok;
+}
+
 void top_level_task(const void *args, size_t arglen, 
 		    const void *userdata, size_t userlen, Processor p)
 {
@@ -388,6 +747,15 @@ void top_level_task(const void *args, size_t arglen,
     ok = false;
   }
 
+  if(!test_static_subgraph(p))
+    ok = false;
+
+  if(!test_static_subgraph_reuse(p))
+    ok = false;
+
+  if(!test_chain_subgraph())
+    ok = false;
+
   Runtime::get_runtime().shutdown(Event::NO_EVENT,
 				  ok ? 0 : 1);
 }
@@ -398,20 +766,27 @@ int main(int argc, char **argv)
 
   rt.init(&argc, &argv);
 
-#if 0
   for(int i = 1; i < argc; i++) {
-    if(!strcmp(argv[i], "-b")) {
-      buffer_size = strtoll(argv[++i], 0, 10);
+    if(!strcmp(argv[i], "-n")) {
+      num_static_instances = strtoll(argv[++i], 0, 10);
+      continue;
+    }
+    if(!strcmp(argv[i], "-w")) {
+      static_width = strtoll(argv[++i], 0, 10);
       continue;
     }
-
   }
-#endif
 
   rt.register_task(TOP_LEVEL_TASK, top_level_task);
   rt.register_task(WRITER_TASK, writer_task);
   rt.register_task(READER_TASK, reader_task);
   rt.register_task(CLEANUP_TASK, cleanup_task);
+  rt.register_task(COUNTER_TASK, counter_task);
+  rt.register_task(CHAIN_TASK, chain_task);
+  rt.register_task(REPORT_TASK, report_task);
+
+  for(int i = 0; i < MAX_CHAIN_PROCS; i++)
+    chain_last_step[i].store(-1);
 
   rt.register_reduction<ReductionOpIntAdd>(REDOP_INT_ADD);
 
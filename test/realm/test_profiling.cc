@@ -21,6 +21,7 @@ enum {
   TOP_LEVEL_TASK = Processor::TASK_ID_FIRST_AVAILABLE+0,
   CHILD_TASK     = Processor::TASK_ID_FIRST_AVAILABLE+1,
   RESPONSE_TASK,
+  BATCH_RESPONSE_TASK,
 };
 
 // we're going to use alarm() as a watchdog to detect hangs
@@ -247,6 +248,38 @@ void response_task(const void *args, size_t arglen,
   response_counter.arrive();
 }
 
+Barrier batch_response_counter;
+int batch_responses_remaining = 0;
+
+// responses for requests that allow batching may arrive several at a time
+void batch_response_task(const void *args, size_t arglen,
+			 const void *userdata, size_t userlen, Processor p)
+{
+  Realm::ProfilingResponseBatch batch(args, arglen);
+  log_app.print() << "batched profiling response task on processor " << p
+		  << ": " << batch.size() << " responses";
+  for(size_t i = 0; i < batch.size(); i++) {
+    Realm::ProfilingResponse pr(batch.response_data(i),
+				batch.response_size(i));
+    OperationTimeline timeline;
+    if(!pr.get_measurement<OperationTimeline>(timeline) ||
+       !timeline.is_valid()) {
+      printf("HELP!  Batched response without a valid timeline!\n");
+      exit(1);
+    }
+    if((pr.user_data_size() != sizeof(int)) ||
+       (*(const int *)(pr.user_data()) != 42)) {
+      printf("HELP!  Batched response has bad user data!\n");
+      exit(1);
+    }
+    if(__sync_sub_and_fetch(&batch_responses_remaining, 1) < 0) {
+      printf("HELP!  Too many batched responses received!\n");
+      exit(1);
+    }
+    batch_response_counter.arrive();
+  }
+}
+
 void top_level_task(const void *args, size_t arglen, 
 		    const void *userdata, size_t userlen, Processor p)
 {
@@ -454,6 +487,24 @@ void top_level_task(const void *args, size_t arglen,
   printf("waiting for profiling responses...\n");
   response_counter.wait();
   printf("all profiling responses received\n");
+
+  // batchable responses (grouped when run with -ll:prof_batch)
+  {
+    const int num_tasks = 18;
+    batch_responses_remaining = num_tasks;
+    batch_response_counter = Barrier::create_barrier(num_tasks);
+    ProfilingRequestSet prs;
+    int tag = 42;
+    prs.add_request(profile_cpu, BATCH_RESPONSE_TASK, &tag, sizeof(tag))
+      .add_measurement<OperationTimeline>()
+      .allow_batching();
+    ChildTaskArgs cargs;
+    cargs.sleep_useconds = 0;
+    for(int i = 0; i < num_tasks; i++)
+      task_proc.spawn(CHILD_TASK, &cargs, sizeof(cargs), prs);
+    batch_response_counter.wait();
+    printf("all batched profiling responses received\n");
+  }
 }
 
 int main(int argc, char **argv)
@@ -472,6 +523,7 @@ int main(int argc, char **argv)
   rt.register_task(TOP_LEVEL_TASK, top_level_task);
   rt.register_task(CHILD_TASK, child_task);
   rt.register_task(RESPONSE_TASK, response_task);
+  rt.register_task(BATCH_RESPONSE_TASK, batch_response_task);
 
 #ifndef _MSC_VER
   signal(SIGALRM, sigalrm_handler);
@@ -0,0 +1,125 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+#include "realm/caching_allocator.h"
+
+#include <gtest/gtest.h>
+
+using namespace Realm;
+
+template <int TAG>
+struct TestObject {
+  uint64_t payload[8];
+};
+
+TEST(CachingAllocatorTest, AllocReturnsDistinctObjects)
+{
+  typedef CachingAllocator<TestObject<0>, 16> Alloc;
+  std::set<void *> seen;
+  std::vector<void *> objs;
+  for(int i = 0; i < 40; i++) {
+    void *p = Alloc::alloc_obj();
+    ASSERT_NE(p, nullptr);
+    EXPECT_TRUE(seen.insert(p).second);
+    objs.push_back(p);
+  }
+  for(void *p : objs)
+    Alloc::free_obj(p);
+}
+
+TEST(CachingAllocatorTest, EmptiedBlocksAreReused)
+{
+  typedef CachingAllocator<TestObject<1>, 16> Alloc;
+  std::vector<void *> objs;
+  // fill several blocks, free everything, and then do it again - the second
+  //  round should not need any new blocks
+  for(int i = 0; i < 64; i++)
+    objs.push_back(Alloc::alloc_obj());
+  for(void *p : objs)
+    Alloc::free_obj(p);
+  objs.clear();
+
+  size_t allocs_before = CachingAllocatorStats::get(CachingAllocatorStats::BLOCK_ALLOCS);
+  for(int i = 0; i < 48; i++)
+    objs.push_back(Alloc::alloc_obj());
+  for(void *p : objs)
+    Alloc::free_obj(p);
+  EXPECT_EQ(CachingAllocatorStats::get(CachingAllocatorStats::BLOCK_ALLOCS),
+            allocs_before);
+}
+
+TEST(CachingAllocatorTest, RemoteFreesFromOtherThreads)
+{
+  typedef CachingAllocator<TestObject<2>, 16> Alloc;
+  const int num_threads = 4;
+  const int per_thread = 100;
+  std::vector<void *> objs;
+  for(int i = 0; i < num_threads * per_thread; i++)
+    objs.push_back(Alloc::alloc_obj());
+
+  std::vector<std::thread> threads;
+  for(int t = 0; t < num_threads; t++)
+    threads.emplace_back([&objs, t]() {
+      for(int i = 0; i < per_thread; i++)
+        Alloc::free_obj(objs[t * per_thread + i]);
+    });
+  for(std::thread &t : threads)
+    t.join();
+
+  // every full block was returned, so reallocating the same count from this
+  //  thread needs no new blocks
+  size_t allocs_before = CachingAllocatorStats::get(CachingAllocatorStats::BLOCK_ALLOCS);
+  objs.clear();
+  for(int i = 0; i < (num_threads * per_thread) - 16; i++)
+    objs.push_back(Alloc::alloc_obj());
+  EXPECT_EQ(CachingAllocatorStats::get(CachingAllocatorStats::BLOCK_ALLOCS),
+            allocs_before);
+  for(void *p : objs)
+    Alloc::free_obj(p);
+}
+
+TEST(CachingAllocatorTest, PartialBlockReclaimedAfterThreadExit)
+{
+  typedef CachingAllocator<TestObject<3>, 16> Alloc;
+  // a thread exits holding a partially-used block - once its objects are
+  //  freed, the block must go back on the free list
+  std::vector<void *> objs;
+  std::thread t([&objs]() {
+    for(int i = 0; i < 5; i++)
+      objs.push_back(Alloc::alloc_obj());
+  });
+  t.join();
+  size_t reuses_before = CachingAllocatorStats::get(CachingAllocatorStats::BLOCK_REUSES);
+  for(void *p : objs)
+    Alloc::free_obj(p);
+
+  void *p = Alloc::alloc_obj();
+  EXPECT_EQ(CachingAllocatorStats::get(CachingAllocatorStats::BLOCK_REUSES),
+            reuses_before + 1);
+  Alloc::free_obj(p);
+}
+
+TEST(SizeClassCachingAllocatorTest, SizesRoundTrip)
+{
+  std::vector<size_t> sizes{1, 64, 65, 200, 1000, 2048};
+  for(size_t s : sizes) {
+    void *p = SizeClassCachingAllocator::alloc_obj(s);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % alignof(std::max_align_t), 0);
+    memset(p, 0xff, s);
+    SizeClassCachingAllocator::free_obj(p, s);
+  }
+}
+
+TEST(SizeClassCachingAllocatorTest, OversizeUsesSystemAllocator)
+{
+  size_t before = CachingAllocatorStats::get(CachingAllocatorStats::OVERSIZE_ALLOCS);
+  void *p = SizeClassCachingAllocator::alloc_obj(SizeClassCachingAllocator::MAX_SIZE + 1);
+  ASSERT_NE(p, nullptr);
+  EXPECT_EQ(CachingAllocatorStats::get(CachingAllocatorStats::OVERSIZE_ALLOCS),
+            before + 1);
+  SizeClassCachingAllocator::free_obj(p, SizeClassCachingAllocator::MAX_SIZE + 1);
+}
@@ -0,0 +1,219 @@
+/* Copyright 2024 NVIDIA Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks the results of the all-gather collectives between the shards of
+// a control replicated task when there are several shards per address
+// space. Shards on the same address space go through the leader for that
+// space and leaders that do not fit in the butterfly (e.g. the third
+// address space of a run with three ranks) combine the values of their
+// address space before forwarding them, so run this with a number of
+// ranks that is not a power of two to cover that case as well, e.g.
+//   mpirun -n 3 shard_collectives -ll:cpu 3
+// Running with -lg:flat_collectives must give the same results.
+
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <vector>
+
+#include "legion.h"
+#include "default_mapper.h"
+
+using namespace Legion;
+using namespace Legion::Mapping;
+
+enum TaskIds
+{
+  TOP_TASK_ID,
+  POINT_TASK_ID,
+};
+
+static const int NUM_ITERATIONS = 8;
+static const int NUM_COMMON_ELEMENTS = 16;
+
+class ShardMapper : public DefaultMapper
+{
+public:
+  ShardMapper(Machine, Runtime *, Processor);
+
+  virtual void select_task_options(const MapperContext ctx,
+                                   const Task &task,
+                                   TaskOptions &output) override;
+
+  virtual void replicate_task(MapperContext ctx,
+                              const Task& task,
+                              const ReplicateTaskInput& input,
+                                    ReplicateTaskOutput& output) override;
+protected:
+  std::vector<Processor> all_cpus;
+};
+
+ShardMapper::ShardMapper(Machine m, Runtime *rt, Processor p)
+    : DefaultMapper(rt->get_mapper_runtime(), m, p)
+{
+  Machine::ProcessorQuery proc_it(machine);
+  proc_it.only_kind(Processor::LOC_PROC);
+  for (auto it = proc_it.begin(); it != proc_it.end(); it++)
+    all_cpus.push_back(*it);
+}
+
+void ShardMapper::select_task_options(const MapperContext ctx,
+                                      const Task &task, TaskOptions &output)
+{
+  DefaultMapper::select_task_options(ctx, task, output);
+  output.replicate = (task.task_id == TOP_TASK_ID);
+}
+
+void ShardMapper::replicate_task(MapperContext ctx,
+                                 const Task& task,
+                                 const ReplicateTaskInput& input,
+                                       ReplicateTaskOutput& output)
+{
+  const Processor::Kind target_kind = task.target_proc.kind();
+  const VariantInfo chosen = default_find_preferred_variant(
+      task, ctx, true /*needs tight bound*/, true /*cache*/, target_kind);
+  assert(chosen.is_replicable);
+  output.chosen_variant = chosen.variant;
+  // One shard on every CPU so each address space hosts several shards
+  output.target_processors = all_cpus;
+}
+
+void mapper_registration(Machine machine, Runtime *rt,
+                         const std::set<Processor> &local_procs)
+{
+  for (std::set<Processor>::const_iterator it = local_procs.begin();
+       it != local_procs.end(); it++)
+    rt->replace_default_mapper(new ShardMapper(machine, rt, *it), *it);
+}
+
+int point_task(const Task *task, const std::vector<PhysicalRegion> &regions,
+               Context ctx, Runtime *rt)
+{
+  const int iteration = *reinterpret_cast<const int*>(task->args);
+  return task->index_point[0] + iteration;
+}
+
+void top_task(const Task *task, const std::vector<PhysicalRegion> &regions,
+              Context ctx, Runtime *rt)
+{
+  const int num_shards = rt->get_num_shards(ctx, true);
+  const int shard = rt->get_shard_id(ctx, true);
+  if (shard == 0)
+  {
+    Machine::ProcessorQuery proc_it(Machine::get_machine());
+    proc_it.only_kind(Processor::LOC_PROC);
+    std::set<AddressSpace> spaces;
+    for (auto it = proc_it.begin(); it != proc_it.end(); it++)
+      spaces.insert(it->address_space());
+    printf("Running %d shards on %zu address spaces\n",
+            num_shards, spaces.size());
+  }
+  // Use a point count that is not a multiple of the shard count
+  const int num_points = 3 * num_shards + 1;
+  const Rect<1> bounds(0, num_points - 1);
+  const IndexSpace launch_space = rt->create_index_space(ctx, bounds);
+  int errors = 0;
+  for (int iteration = 0; iteration < NUM_ITERATIONS; iteration++)
+  {
+    const int expected =
+      num_points * (num_points - 1) / 2 + num_points * iteration;
+    // Unordered reductions of index launches and future maps
+    // go through a future all-reduce between the shards
+    IndexTaskLauncher launcher(POINT_TASK_ID, launch_space,
+        TaskArgument(&iteration, sizeof(iteration)), ArgumentMap());
+    const Future reduced =
+      rt->execute_index_space(ctx, launcher, LEGION_REDOP_SUM_INT32,
+                             false/*ordered*/);
+    const FutureMap future_map = rt->execute_index_space(ctx, launcher);
+    const Future map_reduced =
+      rt->reduce_future_map(ctx, future_map, LEGION_REDOP_SUM_INT32,
+                            false/*ordered*/);
+    // Consensus matches gather the element counts from every shard
+    std::vector<int> input;
+    for (int idx = 0; idx < NUM_COMMON_ELEMENTS; idx++)
+      input.push_back(idx * num_shards + iteration);
+    input.push_back(-1 - shard);
+    std::vector<int> output(input.size(), 0);
+    const Future matched = rt->consensus_match(ctx, input.data(),
+        output.data(), input.size(), sizeof(int));
+
+    const int reduced_value = reduced.get_result<int>();
+    if (reduced_value != expected)
+    {
+      printf("Shard %d iteration %d: index reduction %d, expected %d\n",
+              shard, iteration, reduced_value, expected);
+      errors++;
+    }
+    const int map_reduced_value = map_reduced.get_result<int>();
+    if (map_reduced_value != expected)
+    {
+      printf("Shard %d iteration %d: future map reduction %d, expected %d\n",
+              shard, iteration, map_reduced_value, expected);
+      errors++;
+    }
+    const size_t num_matched = matched.get_result<size_t>();
+    // A single shard matches its own element as well
+    const size_t expected_matched =
+      NUM_COMMON_ELEMENTS + ((num_shards == 1) ? 1 : 0);
+    if (num_matched != expected_matched)
+    {
+      printf("Shard %d iteration %d: matched %zu elements, expected %zu\n",
+              shard, iteration, num_matched, expected_matched);
+      errors++;
+    }
+    else
+    {
+      std::set<int> matched_elements(output.begin(),
+                                     output.begin() + num_matched);
+      for (int idx = 0; idx < NUM_COMMON_ELEMENTS; idx++)
+      {
+        if (matched_elements.count(idx * num_shards + iteration) > 0)
+          continue;
+        printf("Shard %d iteration %d: element %d was not matched\n",
+                shard, iteration, idx * num_shards + iteration);
+        errors++;
+      }
+    }
+  }
+  rt->destroy_index_space(ctx, launch_space);
+  if (errors > 0)
+  {
+    printf("Shard %d: FAILED with %d errors\n", shard, errors);
+    abort();
+  }
+  if (shard == 0)
+    printf("Shard collectives: PASSED\n");
+}
+
+int main(int argc, char **argv)
+{
+  Runtime::set_top_level_task_id(TOP_TASK_ID);
+
+  {
+    TaskVariantRegistrar registrar(TOP_TASK_ID, "top");
+    registrar.add_constraint(ProcessorConstraint(Processor::LOC_PROC));
+    registrar.set_replicable(true);
+    Runtime::preregister_task_variant<top_task>(registrar, "top");
+  }
+  {
+    TaskVariantRegistrar registrar(POINT_TASK_ID, "point");
+    registrar.add_constraint(ProcessorConstraint(Processor::LOC_PROC));
+    registrar.set_leaf(true);
+    Runtime::preregister_task_variant<int, point_task>(registrar, "point");
+  }
+
+  Runtime::add_registration_callback(mapper_registration);
+  return Runtime::start(argc, argv);
+}
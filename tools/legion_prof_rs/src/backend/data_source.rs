@@ -110,6 +110,10 @@ pub struct Fields {
     previous_executing: FieldID,
     scheduling_overhead: FieldID,
     message_latency: FieldID,
+    trace_id: FieldID,
+    replay_critical_path: FieldID,
+    replay_chunks: FieldID,
+    replay_steals: FieldID,
 }
 
 #[derive(Debug)]
@@ -163,6 +167,10 @@ impl StateDataSource {
             previous_executing: field_schema.insert("Previous Executing".to_owned(), true),
             scheduling_overhead: field_schema.insert("Scheduling Overhead".to_owned(), false),
             message_latency: field_schema.insert("Message Latency".to_owned(), false),
+            trace_id: field_schema.insert("Trace ID".to_owned(), true),
+            replay_critical_path: field_schema.insert("Replay Critical Path".to_owned(), false),
+            replay_chunks: field_schema.insert("Replay Chunks".to_owned(), false),
+            replay_steals: field_schema.insert("Replay Steals".to_owned(), false),
         };
 
         let mut entry_map = BTreeMap::<EntryID, EntryKind>::new();
@@ -1611,6 +1619,28 @@ impl StateDataSource {
                     None,
                 ));
             }
+            if let Some(replay) = self.state.trace_replays.get(&entry.base.prof_uid) {
+                fields.push((
+                    self.fields.trace_id,
+                    Field::U64(replay.trace_id.into()),
+                    None,
+                ));
+                fields.push((
+                    self.fields.replay_critical_path,
+                    Field::String(format!("{} us", replay.critical_path)),
+                    None,
+                ));
+                fields.push((
+                    self.fields.replay_chunks,
+                    Field::U64(replay.chunks.into()),
+                    None,
+                ));
+                fields.push((
+                    self.fields.replay_steals,
+                    Field::U64(replay.steals.into()),
+                    None,
+                ));
+            }
             if let Some(creator) = entry.creator() {
                 // Check to see if these are function calls or tasks
                 match entry.kind {
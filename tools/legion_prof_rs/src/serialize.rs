@@ -141,6 +141,7 @@ pub enum Record {
     MapperCallInfo { mapper_id: MapperID, mapper_proc: ProcID, kind: MapperCallKindID, op_id: OpID, start: Timestamp, stop: Timestamp, proc_id: ProcID, fevent: EventID },
     RuntimeCallInfo { kind: RuntimeCallKindID, start: Timestamp, stop: Timestamp, proc_id: ProcID, fevent: EventID },
     ApplicationCallInfo { provenance: ProvenanceID, start: Timestamp, stop: Timestamp, proc_id: ProcID, fevent: EventID },
+    TraceReplayInfo { kind: RuntimeCallKindID, trace_id: u32, start: Timestamp, stop: Timestamp, critical_path: Timestamp, chunks: u32, steals: u32, proc_id: ProcID, fevent: EventID },
     ProfTaskInfo { proc_id: ProcID, op_id: OpID, start: Timestamp, stop: Timestamp, creator: EventID, fevent: EventID, completion: bool },
     CalibrationErr { calibration_err: i64 },
     BacktraceDesc { backtrace_id: BacktraceID , backtrace: String },
@@ -1142,6 +1143,31 @@ fn parse_application_call_info(input: &[u8], _max_dim: i32) -> IResult<&[u8], Re
         },
     ))
 }
+fn parse_trace_replay_info(input: &[u8], _max_dim: i32) -> IResult<&[u8], Record> {
+    let (input, kind) = parse_runtime_call_kind_id(input)?;
+    let (input, trace_id) = le_u32(input)?;
+    let (input, start) = parse_timestamp(input)?;
+    let (input, stop) = parse_timestamp(input)?;
+    let (input, critical_path) = parse_timestamp(input)?;
+    let (input, chunks) = le_u32(input)?;
+    let (input, steals) = le_u32(input)?;
+    let (input, proc_id) = parse_proc_id(input)?;
+    let (input, fevent) = parse_event_id(input)?;
+    Ok((
+        input,
+        Record::TraceReplayInfo {
+            kind,
+            trace_id,
+            start,
+            stop,
+            critical_path,
+            chunks,
+            steals,
+            proc_id,
+            fevent,
+        },
+    ))
+}
 fn parse_proftask_info(input: &[u8], _max_dim: i32) -> IResult<&[u8], Record> {
     let (input, proc_id) = parse_proc_id(input)?;
     let (input, op_id) = parse_op_id(input)?;
@@ -1457,6 +1483,7 @@ fn parse<'a>(
     parsers.insert(ids["MapperCallInfo"], parse_mapper_call_info);
     parsers.insert(ids["RuntimeCallInfo"], parse_runtime_call_info);
     parsers.insert(ids["ApplicationCallInfo"], parse_application_call_info);
+    parsers.insert(ids["TraceReplayInfo"], parse_trace_replay_info);
     parsers.insert(ids["ProfTaskInfo"], parse_proftask_info);
     parsers.insert(ids["BacktraceDesc"], parse_backtrace_desc);
     parsers.insert(ids["EventWaitInfo"], parse_event_wait_info);
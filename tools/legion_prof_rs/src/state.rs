@@ -2364,6 +2364,14 @@ impl RuntimeCallKind {
     }
 }
 
+#[derive(Debug, Copy, Clone)]
+pub struct TraceReplay {
+    pub trace_id: u32,
+    pub critical_path: Timestamp,
+    pub chunks: u32,
+    pub steals: u32,
+}
+
 #[derive(Debug, Copy, Clone, PartialEq, Eq, PartialOrd, Ord, Serialize)]
 pub struct ProvenanceID(pub NonZeroU64);
 
@@ -3303,6 +3311,7 @@ pub struct State {
     pub mappers: BTreeMap<(MapperID, ProcID), Mapper>,
     pub mapper_call_kinds: BTreeMap<MapperCallKindID, MapperCallKind>,
     pub runtime_call_kinds: BTreeMap<RuntimeCallKindID, RuntimeCallKind>,
+    pub trace_replays: BTreeMap<ProfUID, TraceReplay>,
     pub insts: BTreeMap<ProfUID, MemID>,
     pub index_spaces: BTreeMap<ISpaceID, ISpace>,
     pub index_partitions: BTreeMap<IPartID, IPart>,
@@ -5058,6 +5067,36 @@ fn process_record(
             state.create_application_call(*provenance, *proc_id, time_range, *fevent);
             state.update_last_time(*stop);
         }
+        Record::TraceReplayInfo {
+            kind,
+            trace_id,
+            start,
+            stop,
+            critical_path,
+            chunks,
+            steals,
+            proc_id,
+            fevent,
+        } => {
+            // Replays are never filtered by the call threshold so that the
+            // critical path statistics are always available
+            assert!(state.runtime_call_kinds.contains_key(kind));
+            let time_range = TimeRange::new_call(*start, *stop);
+            let prof_uid = state
+                .create_runtime_call(*kind, *proc_id, time_range, *fevent)
+                .base
+                .prof_uid;
+            state.trace_replays.insert(
+                prof_uid,
+                TraceReplay {
+                    trace_id: *trace_id,
+                    critical_path: *critical_path,
+                    chunks: *chunks,
+                    steals: *steals,
+                },
+            );
+            state.update_last_time(*stop);
+        }
         Record::ProfTaskInfo {
             proc_id,
             op_id,
@@ -0,0 +1,51 @@
+/* Copyright 2024 Stanford University, NVIDIA Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Converts binary Legion Spy logs (-lg:spy_logfile) back into the text
+// format that legion_spy.py consumes.
+//
+//   c++ -O2 -std=c++17 -o legion_spy_convert legion_spy_convert.cc
+//   legion_spy_convert spy_0.bin [spy_1.bin ...] > spy.log
+
+#include <cstdio>
+#include <string>
+
+#include "legion_spy_reader.h"
+
+int main(int argc, char **argv)
+{
+  if (argc < 2)
+  {
+    fprintf(stderr, "Usage: %s <binary spy log> ...\n", argv[0]);
+    return 1;
+  }
+  int result = 0;
+  for (int i = 1; i < argc; i++)
+  {
+    LegionSpyReader::BinarySpyReader reader;
+    if (!reader.open(argv[i]))
+    {
+      fprintf(stderr, "ERROR: %s is not a binary Legion Spy log\n", argv[i]);
+      result = 1;
+      continue;
+    }
+    std::string text;
+    while (reader.next(text))
+      printf("[%u - 0] {2}{legion_spy}: %s\n", reader.get_node(), text.c_str());
+    if (ferror(stdout))
+      result = 1;
+  }
+  return result;
+}
@@ -0,0 +1,292 @@
+/* Copyright 2024 Stanford University, NVIDIA Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LEGION_SPY_READER_H__
+#define __LEGION_SPY_READER_H__
+
+// Header-only reader for the binary Legion Spy logs that are written
+// when running with -lg:spy -lg:spy_logfile <file>. See BinarySpyStream
+// in runtime/legion/legion_spy.h for a description of the encoding.
+// Records are returned as the same text that the runtime would have
+// printed with the regular Legion Spy logger.
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace LegionSpyReader {
+
+  class BinarySpyReader {
+  public:
+    enum ArgumentKind {
+      SIGNED_ARGUMENT,
+      UNSIGNED_ARGUMENT,
+      DOUBLE_ARGUMENT,
+      STRING_ARGUMENT,
+    };
+    struct Conversion {
+      // Literal text that precedes the conversion
+      std::string prefix;
+      // The conversion spec with any length modifiers removed
+      std::string spec;
+      ArgumentKind kind;
+      char conversion;
+    };
+    struct Format {
+      std::vector<Conversion> conversions;
+      std::string suffix;
+    };
+  public:
+    BinarySpyReader(void) : file(NULL), node(0) { }
+    BinarySpyReader(const BinarySpyReader &rhs) = delete;
+    ~BinarySpyReader(void) { if (file != NULL) fclose(file); }
+  public:
+    BinarySpyReader& operator=(const BinarySpyReader &rhs) = delete;
+  public:
+    // Returns false if the file cannot be opened or is not a binary spy log
+    bool open(const char *filename)
+    {
+      file = fopen(filename, "rb");
+      if (file == NULL)
+        return false;
+      char preamble[128];
+      if (fgets(preamble, sizeof(preamble), file) == NULL)
+        return false;
+      unsigned major = 0, minor = 0;
+      if (sscanf(preamble, "FileType: BinaryLegionSpy v: %u.%u node: %u",
+                 &major, &minor, &node) != 3)
+        return false;
+      return (major == 1);
+    }
+    unsigned get_node(void) const { return node; }
+    // Decode the next record into text, returns false at the end of the
+    // file or if the file is truncated or malformed
+    bool next(std::string &text)
+    {
+      uint64_t tag;
+      while (read_varint(tag))
+      {
+        if (tag == 0)
+        {
+          if (!read_definition())
+            return false;
+          continue;
+        }
+        std::unordered_map<uint64_t,Format>::const_iterator finder =
+          formats.find(tag);
+        if (finder == formats.end())
+          return false;
+        return decode_record(finder->second, text);
+      }
+      return false;
+    }
+  public:
+    static void parse_format(const std::string &fmt, Format &format)
+    {
+      std::string literal;
+      for (size_t idx = 0; idx < fmt.size(); idx++)
+      {
+        if (fmt[idx] != '%')
+        {
+          literal.push_back(fmt[idx]);
+          continue;
+        }
+        if ((idx + 1) < fmt.size() && (fmt[idx+1] == '%'))
+        {
+          literal.push_back('%');
+          idx++;
+          continue;
+        }
+        Conversion conversion;
+        conversion.prefix.swap(literal);
+        conversion.spec.push_back('%');
+        idx++;
+        // Keep flags, width, and precision but drop length modifiers
+        // since the reader always formats with the widest types
+        while ((idx < fmt.size()) &&
+               (strchr("-+ #0123456789.hlLqjzt", fmt[idx]) != NULL))
+        {
+          if (strchr("hlLqjzt", fmt[idx]) == NULL)
+            conversion.spec.push_back(fmt[idx]);
+          idx++;
+        }
+        if (idx == fmt.size())
+          break;
+        conversion.conversion = fmt[idx];
+        switch (fmt[idx])
+        {
+          case 'd':
+          case 'i':
+            {
+              conversion.kind = SIGNED_ARGUMENT;
+              conversion.spec.append("ll");
+              break;
+            }
+          case 'u':
+          case 'x':
+          case 'X':
+          case 'o':
+            {
+              conversion.kind = UNSIGNED_ARGUMENT;
+              conversion.spec.append("ll");
+              break;
+            }
+          case 'c':
+          case 'p':
+            {
+              conversion.kind = UNSIGNED_ARGUMENT;
+              break;
+            }
+          case 'f':
+          case 'F':
+          case 'e':
+          case 'E':
+          case 'g':
+          case 'G':
+            {
+              conversion.kind = DOUBLE_ARGUMENT;
+              break;
+            }
+          default:
+            {
+              conversion.kind = STRING_ARGUMENT;
+              break;
+            }
+        }
+        conversion.spec.push_back(fmt[idx]);
+        format.conversions.push_back(conversion);
+      }
+      format.suffix.swap(literal);
+    }
+  protected:
+    bool read_varint(uint64_t &value)
+    {
+      value = 0;
+      for (unsigned shift = 0; shift < 64; shift += 7)
+      {
+        const int c = fgetc(file);
+        if (c == EOF)
+          return false;
+        value |= uint64_t(c & 0x7f) << shift;
+        if ((c & 0x80) == 0)
+          return true;
+      }
+      return false;
+    }
+    bool read_string(std::string &str)
+    {
+      uint64_t length;
+      if (!read_varint(length))
+        return false;
+      str.resize(length);
+      if (length == 0)
+        return true;
+      return (fread(&str[0], 1, length, file) == length);
+    }
+    bool read_definition(void)
+    {
+      uint64_t id;
+      if (!read_varint(id))
+        return false;
+      std::string fmt;
+      if (!read_string(fmt))
+        return false;
+      Format &format = formats[id];
+      format.conversions.clear();
+      parse_format(fmt, format);
+      return true;
+    }
+    bool decode_record(const Format &format, std::string &text)
+    {
+      text.clear();
+      char buffer[64];
+      for (std::vector<Conversion>::const_iterator it =
+            format.conversions.begin(); it != format.conversions.end(); it++)
+      {
+        text.append(it->prefix);
+        switch (it->kind)
+        {
+          case SIGNED_ARGUMENT:
+            {
+              uint64_t value;
+              if (!read_varint(value))
+                return false;
+              const long long decoded = (long long)((value >> 1) ^
+                  (~(value & 1) + 1));
+              snprintf(buffer, sizeof(buffer), it->spec.c_str(), decoded);
+              text.append(buffer);
+              break;
+            }
+          case UNSIGNED_ARGUMENT:
+            {
+              uint64_t value;
+              if (!read_varint(value))
+                return false;
+              if (it->conversion == 'c')
+                snprintf(buffer, sizeof(buffer), it->spec.c_str(), int(value));
+              else if (it->conversion == 'p')
+                snprintf(buffer, sizeof(buffer), it->spec.c_str(),
+                         (void*)uintptr_t(value));
+              else
+                snprintf(buffer, sizeof(buffer), it->spec.c_str(),
+                         (unsigned long long)value);
+              text.append(buffer);
+              break;
+            }
+          case DOUBLE_ARGUMENT:
+            {
+              double value;
+              if (fread(&value, sizeof(value), 1, file) != 1)
+                return false;
+              snprintf(buffer, sizeof(buffer), it->spec.c_str(), value);
+              text.append(buffer);
+              break;
+            }
+          case STRING_ARGUMENT:
+            {
+              std::string value;
+              if (!read_string(value))
+                return false;
+              if (it->spec == "%s")
+                text.append(value);
+              else
+              {
+                // Width or precision on a string, size it properly
+                const int length =
+                  snprintf(NULL, 0, it->spec.c_str(), value.c_str());
+                std::vector<char> formatted(length + 1);
+                snprintf(formatted.data(), formatted.size(),
+                         it->spec.c_str(), value.c_str());
+                text.append(formatted.data(), length);
+              }
+              break;
+            }
+        }
+      }
+      text.append(format.suffix);
+      return true;
+    }
+  protected:
+    FILE *file;
+    unsigned node;
+    std::unordered_map<uint64_t,Format> formats;
+  };
+
+}; // namespace LegionSpyReader
+
+#endif // __LEGION_SPY_READER_H__
@@ -1132,6 +1132,8 @@ void test_operation_64(const int num_iterations)
     BitMask<uint64_t,MAX,6,0x3F> >(num_iterations, "BitMask");
   test_mask_operation<MAX,SCALE,OP,
     TLBitMask<uint64_t,MAX,6,0x3F> >(num_iterations, "TLBitMask");
+  test_mask_operation<MAX,SCALE,OP,DispatchTLBitMask<MAX> >(
+      num_iterations, "DispatchTLBitMask");
 
   test_mask_operation<MAX,SCALE,OP,
     CompoundBitMask<BitMask<uint64_t,MAX,6,0x3F> > >(
@@ -1173,6 +1175,8 @@ void test_operation_128(const int num_iterations)
   test_mask_operation<MAX,SCALE,OP,SSEBitMask<MAX> >(num_iterations, "SSEBitMask");
   test_mask_operation<MAX,SCALE,OP,SSETLBitMask<MAX> >(num_iterations, "SSETLBitMask");
 #endif
+  test_mask_operation<MAX,SCALE,OP,DispatchTLBitMask<MAX> >(
+      num_iterations, "DispatchTLBitMask");
   test_mask_operation<MAX,SCALE,OP,
     CompoundBitMask<BitMask<uint64_t,MAX,6,0x3F> > >(
         num_iterations, "CompoundBitMask<BitMask<2> >");
@@ -1228,6 +1232,25 @@ void test_operation_128(const int num_iterations)
 #endif
 }
 
+#ifdef __AVX512F__
+// AVX512 masks only exist for multiples of 512 bits
+template<int MAX, int SCALE, OpKind OP, bool SUPPORTED>
+struct AVX512Operation {
+  static void test(const int num_iterations) { }
+};
+
+template<int MAX, int SCALE, OpKind OP>
+struct AVX512Operation<MAX,SCALE,OP,true> {
+  static void test(const int num_iterations)
+  {
+    test_mask_operation<MAX,SCALE,OP,AVX512BitMask<MAX> >(
+        num_iterations, "AVX512BitMask");
+    test_mask_operation<MAX,SCALE,OP,AVX512TLBitMask<MAX> >(
+        num_iterations, "AVX512TLBitMask");
+  }
+};
+#endif
+
 template<int MAX, int SCALE, OpKind OP>
 void test_operation(const int num_iterations)
 {
@@ -1244,6 +1267,11 @@ void test_operation(const int num_iterations)
   test_mask_operation<MAX,SCALE,OP,AVXBitMask<MAX> >(num_iterations, "AVXBitMask");
   test_mask_operation<MAX,SCALE,OP,AVXTLBitMask<MAX> >(num_iterations, "AVXTLBitMask");
 #endif
+#ifdef __AVX512F__
+  AVX512Operation<MAX,SCALE,OP,(MAX % 512) == 0>::test(num_iterations);
+#endif
+  test_mask_operation<MAX,SCALE,OP,DispatchTLBitMask<MAX> >(
+      num_iterations, "DispatchTLBitMask");
   test_mask_operation<MAX,SCALE,OP,
     CompoundBitMask<BitMask<uint64_t,MAX,6,0x3F> > >(
         num_iterations, "CompoundBitMask<BitMask<2> >");
@@ -1392,6 +1420,54 @@ void test_perf(const int num_iterations)
   test_operation<MAX,SCALE,SRA_OP>(num_iterations);
 }
 
+void test_kernel_throughput(const int num_iterations)
+{
+  // Run every kernel table this machine supports over the same arrays so
+  // the instruction set versions can be compared directly
+  const unsigned words = 1 << 16;
+  uint64_t *lhs = (uint64_t*)malloc(words * sizeof(uint64_t));
+  uint64_t *rhs = (uint64_t*)malloc(words * sizeof(uint64_t));
+  uint64_t *dst = (uint64_t*)malloc(words * sizeof(uint64_t));
+  for (unsigned idx = 0; idx < words; idx++)
+  {
+    lhs[idx] = ((uint64_t)lrand48() << 32) | lrand48();
+    rhs[idx] = ((uint64_t)lrand48() << 32) | lrand48();
+  }
+  const int reps = (num_iterations > 64) ? (num_iterations / 64) : 1;
+  // bytes touched per call: two inputs and one output
+  const double bytes = 3.0 * words * sizeof(uint64_t) * reps;
+  printf("\nBit Kernel Throughput (%d words x %d reps)\n", words, reps);
+  for (int isa = 0; isa < BitMaskHelp::NUM_BIT_KERNEL_ISAS; isa++)
+  {
+    const BitMaskHelp::BitKernels *kernels = BitMaskHelp::find_bit_kernels(
+        (BitMaskHelp::BitKernelISA)isa);
+    if (kernels == NULL)
+      continue;
+    uint64_t sink = 0;
+    unsigned long long start = current_time_in_nanoseconds();
+    for (int r = 0; r < reps; r++)
+      sink |= kernels->bit_or(dst, lhs, rhs, words);
+    unsigned long long stop = current_time_in_nanoseconds();
+    const double or_gbs = bytes / (stop - start);
+    start = current_time_in_nanoseconds();
+    for (int r = 0; r < reps; r++)
+      sink |= kernels->bit_andnot(dst, lhs, rhs, words);
+    stop = current_time_in_nanoseconds();
+    const double andnot_gbs = bytes / (stop - start);
+    start = current_time_in_nanoseconds();
+    for (int r = 0; r < reps; r++)
+      sink += kernels->pop_count(lhs, words);
+    stop = current_time_in_nanoseconds();
+    const double pop_gbs = (bytes / 3.0) / (stop - start);
+    printf("    Kernels %s: or %.2f GB/s, andnot %.2f GB/s, "
+           "popcount %.2f GB/s (%llx)\n", kernels->name, or_gbs,
+           andnot_gbs, pop_gbs, (unsigned long long)(sink & 0xF));
+  }
+  free(lhs);
+  free(rhs);
+  free(dst);
+}
+
 int main(int argc, const char **argv)
 {
   int num_iterations = 1024;
@@ -1463,6 +1539,33 @@ int main(int argc, const char **argv)
   test_mask<AVXTLBitMask<2048> >(num_iterations,"AVXTLBitMask<2048>");
 #endif
 
+#ifdef __AVX512F__
+  printf("\nAVX512BitMask Tests\n");
+  test_mask<AVX512BitMask<512> >(num_iterations,"AVX512BitMask<512>");
+  test_mask<AVX512BitMask<1024> >(num_iterations,"AVX512BitMask<1024>");
+  test_mask<AVX512BitMask<1536> >(num_iterations,"AVX512BitMask<1536>");
+  test_mask<AVX512BitMask<2048> >(num_iterations,"AVX512BitMask<2048>");
+
+  printf("\nAVX512TLBitMask Tests\n");
+  test_mask<AVX512TLBitMask<512> >(num_iterations,"AVX512TLBitMask<512>");
+  test_mask<AVX512TLBitMask<1024> >(num_iterations,"AVX512TLBitMask<1024>");
+  test_mask<AVX512TLBitMask<1536> >(num_iterations,"AVX512TLBitMask<1536>");
+  test_mask<AVX512TLBitMask<2048> >(num_iterations,"AVX512TLBitMask<2048>");
+#endif
+
+  printf("\nDispatchTLBitMask Tests (kernels: %s)\n",
+      BitMaskHelp::bit_kernels().name);
+  test_mask<DispatchTLBitMask<64> >(num_iterations,"DispatchTLBitMask<64>");
+  test_mask<DispatchTLBitMask<128> >(num_iterations,"DispatchTLBitMask<128>");
+  test_mask<DispatchTLBitMask<192> >(num_iterations,"DispatchTLBitMask<192>");
+  test_mask<DispatchTLBitMask<256> >(num_iterations,"DispatchTLBitMask<256>");
+  test_mask<DispatchTLBitMask<384> >(num_iterations,"DispatchTLBitMask<384>");
+  test_mask<DispatchTLBitMask<512> >(num_iterations,"DispatchTLBitMask<512>");
+  test_mask<DispatchTLBitMask<768> >(num_iterations,"DispatchTLBitMask<768>");
+  test_mask<DispatchTLBitMask<1024> >(num_iterations,"DispatchTLBitMask<1024>");
+  test_mask<DispatchTLBitMask<1536> >(num_iterations,"DispatchTLBitMask<1536>");
+  test_mask<DispatchTLBitMask<2048> >(num_iterations,"DispatchTLBitMask<2048>");
+
   printf("\nCompoundBitMask Tests\n");
   test_mask<CompoundBitMask<BitMask<uint64_t,64,6,0x3F> > >(
                               num_iterations,"CompoundBitMask<64,2>");
@@ -1596,5 +1699,7 @@ int main(int argc, const char **argv)
 #endif
   test_perf<2048,1>(num_iterations);
 
+  test_kernel_throughput(num_iterations);
+
   return 0;
 }